@@ -2,9 +2,27 @@
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include <limits.h>
+#include <unistd.h>
 #include "activity_helper.h"
 #include "activities_container.h"
 #include "activities_container_helper.h"
+#include "activities_container_burndown.h"
+#include "activities_container_risk.h"
+#include "activities_container_render_cache.h"
+#include "activities_container_sorted_view.h"
+#include "activities_container_loader.h"
+#include "activities_container_snapshot.h"
+#include "activities_container_archive.h"
+#include "activities_container_export.h"
+#include "activities_container_import.h"
+#include "activities_container_store.h"
+#include "activities_container_shards.h"
+#include "activities_container_mapped.h"
+#include "activities_container_checksum.h"
+#include "activities_container_journal.h"
+#include "activities_container_writer.h"
+#include "activities_container_support_vector.h"
 
 
 /*
@@ -14,6 +32,18 @@
 * struct containerItem {
 *     TreeNode avlTree;
 *     int nextId;
+*     unsigned long version;
+*     RenderCache renderCache;
+*     RiskColumns riskColumns;
+*     int areRiskColumnsValid;
+*     unsigned long riskColumnsVersion;
+*     SortedView sortedViews[ACTIVITY_SORT_CRITERIA_COUNT];
+*     ActivityJournal journal;
+*     int journaledActivityId;
+*     ActivityStore store;
+*     ActivityShards shards;
+*     ActivityMap map;
+*     int isTreePending;
 * };
 * 
 * Semantic Specification:
@@ -24,6 +54,24 @@
 * Fields:
 * - avlTree: Pointer to the root node of the AVL tree containing all activities
 * - nextId: The next unique ID to assign to a new activity when inserted
+* - version: Modification counter, incremented by every insert, remove and activity field update
+* - renderCache: Pre-formatted list, progress and report renderings, reused while 'version' doesn't change
+* - riskColumns: Packed numeric columns for the "rischio" view, reloaded from the tree only when 'version' changes
+* - areRiskColumnsValid: 1 if 'riskColumns' have been loaded at 'riskColumnsVersion', 0 otherwise
+* - riskColumnsVersion: Value of 'version' when 'riskColumns' were loaded
+* - sortedViews: For each sorting criterion, the activities kept in that order (NULL until the first
+*   sorted listing by that criterion); every view is updated by inserts, removals and field updates
+* - journal: Journal where inserts, removals and field updates are recorded (NULL: modifications not journaled)
+* - journaledActivityId: Id of the activity being updated, taken before the change (the update of the id changes it)
+* - store: Slotted store file the activities were last saved to or read from, updated in place by the next
+*   slotted save to the same file (NULL: no slotted store)
+* - shards: Sharded directory the activities were last saved to or read from, of which the next save to the
+*   same directory writes only the modified shards (NULL: no sharded directory)
+* - map: Mapped store the activities were last saved to or read from, updated by the next save to the same
+*   file with the modified activities only (NULL: no mapped store); the dirty bit of the activities follows
+*   one of 'store', 'shards' and 'map', so only one of them is set
+* - isTreePending: 1 while the activities are only in 'map', as read by 'readActivitiesFromMapFile()': 'avlTree'
+*   is NULL and is built from the mapped store by the first operation that needs it (see 'getRootNode()')
 * 
 * Abstraction Benefits:
 * - Data Structure Independence: The application code doesn't need to know about AVL tree
@@ -44,15 +92,173 @@
 * - The nextId is automatically incremented when activities are inserted
 * - Activities are stored in the AVL tree ordered by their unique ID values
 * - The container ensures efficient O(log n) operations while hiding complexity from users
+* - The container registers itself as change observer of every inserted activity, so 'version'
+*   also changes when an activity is modified through its setters
 * - This abstraction follows the principle of information hiding and modular design
 */
 struct containerItem {
 	TreeNode avlTree; // Pointer to the root node of the AVL tree
 	int nextId; // Next available unique ID for new activities
+	unsigned long version; // Modification counter (insert, remove, field update)
+	RenderCache renderCache; // Cached renderings (can be NULL: no caching)
+	RiskColumns riskColumns; // Packed columns of the "rischio" view (can be NULL: view not available)
+	int areRiskColumnsValid; // 1 if riskColumns are loaded at riskColumnsVersion
+	unsigned long riskColumnsVersion; // Container version of the loaded riskColumns
+	SortedView sortedViews[ACTIVITY_SORT_CRITERIA_COUNT]; // Sorted views by criterion (NULL: not built)
+	ActivityJournal journal; // Journal of the modifications (NULL: not journaled)
+	int journaledActivityId; // Id of the activity being updated, before the change
+	ActivityStore store; // Slotted store of the last save or read (NULL: none)
+	ActivityShards shards; // Sharded directory of the last save or read (NULL: none)
+	ActivityMap map; // Mapped store of the last save or read (NULL: none)
+	int isTreePending; // 1 while the activities are only in map (tree not built yet)
 };
 
 
 
+/*
+ * addActivityToSortedViews
+ * 
+ * Syntactic Specification:
+ * void addActivityToSortedViews(ActivitiesContainer container, Activity activity);
+ * 
+ * Semantic Specification:
+ * Adds the activity to all the sorted views of the container. A view that can't take the
+ * activity (memory allocation) is deleted: it will be built again at the next request.
+ * 
+ * Preconditions:
+ * - 'container != NULL'
+ * - The activity is in the container and not in its views
+ * 
+ * Postconditions:
+ * - Every existing view holds the activity
+ * 
+ * Side Effects:
+ * - Modifies (or deletes) the sorted views
+ */
+void addActivityToSortedViews(ActivitiesContainer container, Activity activity) {
+	for (int sortBy=0; sortBy<ACTIVITY_SORT_CRITERIA_COUNT; sortBy++) {
+		if (container->sortedViews[sortBy] != NULL && addActivityToSortedView(container->sortedViews[sortBy], activity) != 0) {
+			deleteSortedView( &(container->sortedViews[sortBy]) );
+		}
+	}
+}
+
+/*
+ * removeActivityFromSortedViews
+ * 
+ * Syntactic Specification:
+ * void removeActivityFromSortedViews(ActivitiesContainer container, Activity activity);
+ * 
+ * Semantic Specification:
+ * Removes the activity from all the sorted views of the container.
+ * 
+ * Preconditions:
+ * - 'container != NULL'
+ * - The fields of the activity have not changed since it was added to the views
+ * 
+ * Postconditions:
+ * - No view holds the activity
+ * 
+ * Side Effects:
+ * - Modifies the sorted views
+ */
+void removeActivityFromSortedViews(ActivitiesContainer container, Activity activity) {
+	for (int sortBy=0; sortBy<ACTIVITY_SORT_CRITERIA_COUNT; sortBy++) {
+		removeActivityFromSortedView(container->sortedViews[sortBy], activity);
+	}
+}
+
+/*
+ * onContainedActivityChange
+ * 
+ * Syntactic Specification:
+ * void onContainedActivityChange(Activity a, int field, int phase, void* context);
+ * 
+ * Semantic Specification:
+ * Change observer registered on every activity inserted in a container: a field update
+ * is a modification of the container. Before the change the activity is taken out of the
+ * sorted views (it's found by its old values), after the change it's added back in its new position
+ * and the new value is recorded in the journal of the container.
+ * 
+ * Preconditions:
+ * - 'context' must be the container that holds 'a'
+ * 
+ * Postconditions:
+ * - After the change, the container's version is incremented and the sorted views are up to date
+ * 
+ * Side Effects:
+ * - Modifies the container's version and sorted views
+ * - Writing to the journal file (if the container has a journal)
+ */
+void onContainedActivityChange(Activity a, int field, int phase, void* context) {
+	ActivitiesContainer container = (ActivitiesContainer)context;
+	if (container == NULL) return;
+	
+	if (phase == ACTIVITY_CHANGE_BEFORE) {
+		removeActivityFromSortedViews(container, a);
+		container->journaledActivityId = getActivityId(a);
+		return;
+	}
+	
+	container->version++;
+	addActivityToSortedViews(container, a);
+	if (container->journal != NULL) {
+		appendUpdateToActivityJournal(container->journal, container->journaledActivityId, a, field);
+	}
+}
+
+/*
+ * buildPendingTree
+ * 
+ * Syntactic Specification:
+ * void buildPendingTree(ActivitiesContainer container);
+ * 
+ * Semantic Specification:
+ * Builds the tree of a container read from a mapped store, whose activities are still only in the store
+ * (see 'readActivitiesFromMapFile()'): its nodes are visited in id order (see 'readActivityMap()') and
+ * the tree is built at once in O(n). The activities are the same, so 'version' doesn't change and the
+ * renderings made from the store stay valid. If the store is not valid or memory allocation fails, the
+ * container is left empty and no longer bound to the store.
+ * 
+ * Preconditions:
+ * - None
+ * 
+ * Postconditions:
+ * - If 'container == NULL' or its tree is not pending, no action
+ * - Otherwise, the activities of the store are in the tree (owned by the container)
+ * 
+ * Side Effects:
+ * - Allocates memory for the tree and the activities
+ * - Output to stdout (error messages)
+ */
+void buildPendingTree(ActivitiesContainer container) {
+	if (container == NULL || !container->isTreePending) return;
+	container->isTreePending = 0;
+	
+	Activity* activities = NULL;
+	int count = 0;
+	TreeNode root = NULL;
+	if (readActivityMap(container->map, &activities, &count) == 0) {
+		root = buildTreeFromSortedActivities(activities, count);
+	}
+	if (root == NULL) {
+		for (int i = 0; i < count; i++) deleteActivity(activities[i]);
+		free(activities);
+		printf("Il file %s non è un archivio mappato valido o la memoria è insufficiente: le attività non sono state lette.\n", getActivityMapFilename(container->map));
+		deleteActivityMap( &(container->map) );
+		container->nextId = 1;
+		container->version++;
+		return;
+	}
+	
+	container->avlTree = root;
+	for (int i = 0; i < count; i++) {
+		setActivityChangeObserver(activities[i], onContainedActivityChange, container);
+	}
+	free(activities);
+}
+
+
 /*
  * getRootNode
  * 
@@ -60,7 +266,8 @@ struct containerItem {
  * TreeNode getRootNode(ActivitiesContainer container);
  * 
  * Semantic Specification:
- * Returns the root node of the AVL tree contained within the given activities container.
+ * Returns the root node of the AVL tree contained within the given activities container. The tree of a
+ * container read from a mapped store is built here, the first time (see 'buildPendingTree()').
  * 
  * Preconditions:
  * - None
@@ -70,14 +277,16 @@ struct containerItem {
  * - Otherwise, returns 'container->avlTree'
  * 
  * Side Effects:
- * - None
+ * - May build the tree of the container (see 'buildPendingTree()')
  */
 TreeNode getRootNode(ActivitiesContainer container) {
 	if(container == NULL) return NULL;
 	
+	buildPendingTree(container);
 	return container->avlTree;
 }
 
+
 /*
  * getNextId
  * 
@@ -104,6 +313,32 @@ int getNextId(ActivitiesContainer container) {
 }
 
 
+/*
+ * hasActivityContainerTree
+ * 
+ * Syntactic Specification:
+ * int hasActivityContainerTree(ActivitiesContainer container);
+ * 
+ * Semantic Specification:
+ * Tells whether the activities of the container are in its tree, or still only in the mapped store it
+ * has been read from (see 'readActivitiesFromMapFile()'). The tree is not built by this call.
+ * 
+ * Preconditions:
+ * - None
+ * 
+ * Postconditions:
+ * - Returns 0 if 'container == NULL' or its activities are still only in its mapped store, 1 otherwise
+ * 
+ * Side Effects:
+ * - None
+ */
+int hasActivityContainerTree(ActivitiesContainer container) {
+	if (container == NULL) return 0;
+	
+	return container->isTreePending ? 0 : 1;
+}
+
+
 /*
  * getActivityWithId
  * 
@@ -153,16 +388,20 @@ Activity getActivityWithId(ActivitiesContainer container, int activityId) {
  * - If 'container == NULL', creates a new container
  * - If the activity ID is 0, generates a new unique ID
  * - Inserts the activity into the container
- * - Updates the container's 'nextId'
+ * - Updates the container's 'nextId' and 'version'
+ * - An activity whose id is already in the container is not inserted (and not observed by the container)
+ * - The inserted activity has the container as change observer and is added to its sorted views
  * 
  * Side Effects:
  * - May allocate memory for the container
  * - Modifies the activity ID if it was 0
  * - Modifies the AVL tree structure
+ * - Writing to the journal file (if the container has a journal)
  */
 void insertActivity(ActivitiesContainer container, Activity activity) {
 	if (!activity || !container) return; // No action
 	
+	buildPendingTree(container);
 	int currentActivityId = getActivityId(activity);
 	
 	// if tree is empty
@@ -175,6 +414,15 @@ void insertActivity(ActivitiesContainer container, Activity activity) {
 	
 	container->avlTree = insertNode(container->avlTree, activity);
 	container->nextId = getActivityId(activity) + 1;
+	container->version++;
+	
+	// The tree ignores an activity whose id is already taken: it must not enter the views either, nor report
+	// its changes, which would be taken for the ones of the contained activity with its id
+	if (getActivityWithId(container, getActivityId(activity)) == activity) {
+		setActivityChangeObserver(activity, onContainedActivityChange, container);
+		addActivityToSortedViews(container, activity);
+		if (container->journal != NULL) appendInsertToActivityJournal(container->journal, activity);
+	}
 }
 
 
@@ -196,17 +444,27 @@ void insertActivity(ActivitiesContainer container, Activity activity) {
  * 
  * Postconditions:
  * - If 'container == NULL' or 'container->avlTree == NULL', no action
- * - Otherwise, removes the activity with the specified ID
+ * - Otherwise, removes the activity with the specified ID (also from the sorted views) and updates the container's 'version'
  * 
  * Side Effects:
  * - Modifies the container's AVL tree structure
  * - Updates the container's pointer 'avlTree' to point to the new root of the AVL tree structure
  * - Effects from calls to 'deleteNode()': deallocate memory.
+ * - Writing to the journal file (if the container has a journal and the activity exists)
+ * - Records the slots of the activity in the slotted store of the container (if any)
  */
 void removeActivity(ActivitiesContainer container, int activityId) {
-	if (!container || !container->avlTree) return; //No action
+	if (!container || !getRootNode(container)) return; //No action
+	
+	Activity activity = getActivityWithId(container, activityId);
+	if (activity != NULL) {
+		removeActivityFromSortedViews(container, activity);
+		if (container->journal != NULL) appendRemoveToActivityJournal(container->journal, activityId);
+		freeActivityStoreRecord(container->store, activity); // its record becomes a tombstone at the next slotted save
+	}
 	
 	container->avlTree = deleteNode(container->avlTree, activityId);
+	container->version++;
 }
 
 
@@ -236,6 +494,20 @@ ActivitiesContainer newActivityContainer(void) {
 	if (tree != NULL) {
 		tree->avlTree = NULL;
 		tree->nextId = 1;
+		tree->version = 0;
+		tree->renderCache = newRenderCache(); // if NULL, renderings are not cached
+		tree->riskColumns = newRiskColumns();
+		tree->areRiskColumnsValid = 0;
+		tree->riskColumnsVersion = 0;
+		for (int sortBy=0; sortBy<ACTIVITY_SORT_CRITERIA_COUNT; sortBy++) {
+			tree->sortedViews[sortBy] = NULL; // built at the first request
+		}
+		tree->journal = NULL; // attached by 'openActivitiesJournal()'
+		tree->journaledActivityId = 0;
+		tree->store = NULL; // bound by the slotted saves and reads
+		tree->shards = NULL; // bound by the sharded saves and reads
+		tree->map = NULL; // bound by the mapped saves and reads
+		tree->isTreePending = 0; // set by the mapped reads until the tree is built
 	}
 	
 	return tree;
@@ -263,11 +535,22 @@ ActivitiesContainer newActivityContainer(void) {
  * - Otherwise, deallocates the entire container and its activities
  * 
  * Side Effects:
- * - Deallocates all container memory
+ * - Deallocates all container memory (cached renderings included)
+ * - Closes the journal file (if the container has a journal)
  */
 void deleteActivityContainer(ActivitiesContainer container) {
 	if (container == NULL) return;
 	
+	deleteRenderCache( &(container->renderCache) );
+	deleteRiskColumns( &(container->riskColumns) );
+	for (int sortBy=0; sortBy<ACTIVITY_SORT_CRITERIA_COUNT; sortBy++) {
+		deleteSortedView( &(container->sortedViews[sortBy]) );
+	}
+	closeActivityJournal( &(container->journal) );
+	deleteActivitiesStore( &(container->store) );
+	deleteActivityShards( &(container->shards) );
+	deleteActivityMap( &(container->map) );
+	
 	if (container->avlTree == NULL) {
 		free(container);
 		return;
@@ -309,260 +592,2236 @@ int saveActivitiesToFile(const char* filename, ActivitiesContainer container) {
 
 
 /*
- * printActivityWithId
+ * saveActivitiesToBinaryFile
  * 
  * Syntactic Specification:
- * void printActivityWithId(ActivitiesContainer container, int activityId);
+ * int saveActivitiesToBinaryFile(const char* filename, ActivitiesContainer container);
  * 
  * Semantic Specification:
- * Prints the details of the activity with the specified ID.
+ * Saves all activities from the container to a file in the binary snapshot format (see
+ * 'writeActivitiesSnapshot()'): a header and fixed width columns, read back by
+ * 'readActivitiesFromBinaryFile()' with a few large reads. The text format remains the
+ * interchange format, the binary one is the fast path for large archives.
+ * As for the text format, the file is replaced only when the new one is completely written
+ * (see 'commitActivityWriter()'), and a checksum file is written next to it.
  * 
  * Preconditions:
- * - 'container' can be 'NULL'
- * - 'activityId' must be a valid ID
+ * - None
  * 
  * Postconditions:
- * - If the activity is found, its details are printed
- * - Otherwise, no action
+ * - If 'container == NULL' or 'filename == NULL', returns 1 (error)
+ * - If unable to open or write the file, returns 1 (error): the file keeps its previous content
+ * - Otherwise, saves all activities and returns 0 (success)
  * 
  * Side Effects:
- * - Output to stdout via 'printActivityDetailWithMenu()'
+ * - File opening and writing
+ * - Output to stdout (informational messages)
  */
-void printActivityWithId(ActivitiesContainer container, int activityId) {
-	TreeNode root = getRootNode(container);
-	if(root == NULL) return;
-
-	TreeNode activityNode = search(root, activityId);
-	if (activityNode != NULL) {
-		printActivityDetailWithMenu( getActivityFromNode(activityNode) );
+int saveActivitiesToBinaryFile(const char* filename, ActivitiesContainer container) {
+	if (container == NULL || filename == NULL) return 1;
+	
+	ActivityWriter writer = newActivityWriter(filename);
+	if (writer == NULL) {
+		printf("Errore nell'apertura del file %s per la scrittura.\n", filename);
+		return 1;
 	}
+	enableActivityWriterChecksums(writer);
+	
+	int writeResult = writeActivitiesSnapshot(writer, getRootNode(container));
+	if (writeResult != 0) discardActivityWriter(&writer);
+	else writeResult = commitActivityWriter(&writer);
+	
+	if (writeResult != 0) {
+		printf("Errore nella scrittura del file %s.\n", filename);
+		return 1;
+	}
+	
+	printf("Attività salvate con successo nel file %s\n", filename);
+	return 0;
 }
 
 
 /*
- * printActivities
+ * saveActivitiesToArchiveFile
  * 
  * Syntactic Specification:
- * void printActivities(ActivitiesContainer container);
+ * int saveActivitiesToArchiveFile(const char* filename, ActivitiesContainer container);
  * 
  * Semantic Specification:
- * Prints all activities (list format, one per line) from the container in ascending order of ID.
+ * Saves all activities from the container to a file in the compact archive format (see
+ * 'writeActivitiesArchive()'): ids and dates as varint differences, courses through a dictionary.
+ * It's the smallest format, for the archives that are kept and rarely read: a smaller file is read
+ * from the disk faster and takes less page cache. Read back by 'readActivitiesFromArchiveFile()'.
+ * As for the other formats, the file is replaced only when the new one is completely written
+ * (see 'commitActivityWriter()'), and a checksum file is written next to it.
  * 
  * Preconditions:
  * - None
  * 
  * Postconditions:
- * - If 'container != NULL', prints all activities with headers (see 'printAllActivities')
+ * - If 'container == NULL' or 'filename == NULL', returns 1 (error)
+ * - If unable to open or write the file, returns 1 (error): the file keeps its previous content
+ * - Otherwise, saves all activities and returns 0 (success)
  * 
  * Side Effects:
- * - Output to stdout
+ * - File opening and writing
+ * - Output to stdout (informational messages)
  */
-void printActivities(ActivitiesContainer container) {
-	if (container != NULL) {
-		TreeNode root = getRootNode(container);
-		printAllActivities(root);
+int saveActivitiesToArchiveFile(const char* filename, ActivitiesContainer container) {
+	if (container == NULL || filename == NULL) return 1;
+	
+	ActivityWriter writer = newActivityWriter(filename);
+	if (writer == NULL) {
+		printf("Errore nell'apertura del file %s per la scrittura.\n", filename);
+		return 1;
 	}
+	enableActivityWriterChecksums(writer);
+	
+	int writeResult = writeActivitiesArchive(writer, getRootNode(container));
+	if (writeResult != 0) discardActivityWriter(&writer);
+	else writeResult = commitActivityWriter(&writer);
+	
+	if (writeResult != 0) {
+		printf("Errore nella scrittura del file %s.\n", filename);
+		return 1;
+	}
+	
+	printf("Attività salvate con successo nel file %s\n", filename);
+	return 0;
 }
 
 
 /*
- * printActivitiesToFile
+ * saveActivitiesToStoreFile
  * 
  * Syntactic Specification:
- * void printActivitiesToFile(ActivitiesContainer container, FILE* file);
+ * int saveActivitiesToStoreFile(const char* filename, ActivitiesContainer container);
  * 
  * Semantic Specification:
- * Prints all container activities to file (list format, one per line).
+ * Saves all activities from the container to a file in the slotted store format (see 'writeActivitiesStore()'),
+ * the format for large files saved often: if the container has read or last saved the same store file, only
+ * the records of the activities modified, inserted or removed since then are written (see
+ * 'updateActivitiesStore()'), so a save after a few modifications writes a few slots instead of the whole file.
+ * Otherwise (first save, other file, file changed by someone else, too many tombstones) the file is written
+ * again completely, compacted, and bound to the container. Read back by 'readActivitiesFromStoreFile()'.
+ * The sharded directory and the mapped store of the container (if any) are released (see
+ * 'saveActivitiesToShardsDirectory()').
  * 
  * Preconditions:
- * - 'file' must be opened for writing
+ * - None
  * 
  * Postconditions:
- * - If both parameters are valid, prints all activities to file
+ * - If 'container == NULL' or 'filename == NULL', returns 1 (error)
+ * - If unable to write the file, returns 1 (error): the next save writes the file again completely
+ * - Otherwise, saves all activities and returns 0 (success)
  * 
  * Side Effects:
- * - Writing to file
+ * - File opening and writing
+ * - Modifies the slotted store, the sharded directory and the mapped store of the container
+ * - Output to stdout (informational messages)
  */
-void printActivitiesToFile(ActivitiesContainer container, FILE* file) {
-	if (container != NULL && file != NULL) {
-		TreeNode root = getRootNode(container);
-		printAllActivitiesToFile(root, file);
+int saveActivitiesToStoreFile(const char* filename, ActivitiesContainer container) {
+	if (container == NULL || filename == NULL) return 1;
+	
+	deleteActivityShards( &(container->shards) ); // the dirty activities are cleared by the store
+	deleteActivityMap( &(container->map) );
+	const char* storeFilename = getActivitiesStoreFilename(container->store);
+	int writtenCount = 0;
+	if (storeFilename != NULL && strcmp(storeFilename, filename) == 0 &&
+		 updateActivitiesStore(container->store, getRootNode(container), &writtenCount) == 0) {
+		printf("Attività salvate con successo nel file %s (%d attività riscritte)\n", filename, writtenCount);
+		return 0;
+	}
+	
+	deleteActivitiesStore( &(container->store) );
+	container->store = writeActivitiesStore(filename, getRootNode(container));
+	if (container->store == NULL) {
+		printf("Errore nella scrittura del file %s.\n", filename);
+		return 1;
 	}
+	
+	printf("Attività salvate con successo nel file %s\n", filename);
+	return 0;
 }
 
 
 /*
- * printActivitiesProgress
+ * saveActivitiesToShardsDirectory
  * 
  * Syntactic Specification:
- * void printActivitiesProgress(ActivitiesContainer container);
+ * int saveActivitiesToShardsDirectory(const char* directory, ActivitiesContainer container);
  * 
  * Semantic Specification:
- * Prints the progress of all container activities (progress list format, one per line) with headers.
+ * Saves all activities from the container to a sharded directory (see 'writeActivityShards()'): a binary
+ * snapshot per range of ACTIVITY_SHARD_ID_RANGE ids and a small manifest. If the container has read or last
+ * saved the same directory, only the shards with an activity modified, inserted or removed since then are
+ * written, so the cost of a save follows the modifications and not the size of the container. Otherwise
+ * every shard is written and the directory is bound to the container. Read back by
+ * 'readActivitiesFromShardsDirectory()'. The dirty activities are tracked for one file at a time: the
+ * slotted store and the mapped store of the container (if any) are released and the next save to them
+ * writes them again completely.
  * 
  * Preconditions:
  * - None
  * 
  * Postconditions:
- * - If 'container != NULL', prints progress of all activities
+ * - If 'container == NULL' or 'directory == NULL', returns 1 (error)
+ * - If unable to write the directory, returns 1 (error): the next save writes every shard
+ * - Otherwise, saves all activities and returns 0 (success)
  * 
  * Side Effects:
- * - Output to stdout
+ * - Creation of the directory, writing and removal of files
+ * - Modifies the sharded directory, the slotted store and the mapped store of the container
+ * - Output to stdout (informational messages)
  */
-void printActivitiesProgress(ActivitiesContainer container) {
-	if (container != NULL) {
-		TreeNode root = getRootNode(container);
-		printTreeActivitiesProgress(root);
+int saveActivitiesToShardsDirectory(const char* directory, ActivitiesContainer container) {
+	if (container == NULL || directory == NULL) return 1;
+	
+	deleteActivitiesStore( &(container->store) ); // the dirty activities are cleared by the shards
+	deleteActivityMap( &(container->map) );
+	const char* shardsDirectory = getActivityShardsDirectory(container->shards);
+	if (shardsDirectory == NULL || strcmp(shardsDirectory, directory) != 0) {
+		deleteActivityShards( &(container->shards) );
+		container->shards = newActivityShards(directory);
+	}
+	
+	int count = countTreeActivities(getRootNode(container));
+	Activity* activities = malloc((count > 0 ? count : 1) * sizeof(Activity));
+	int writtenCount = 0;
+	int writeResult = 1;
+	if (activities != NULL && container->shards != NULL) {
+		int collectedCount = 0;
+		collectTreeActivities(container->avlTree, activities, &collectedCount);
+		writeResult = writeActivityShards(container->shards, activities, count, &writtenCount);
+	}
+	free(activities);
+	
+	if (writeResult != 0) {
+		deleteActivityShards( &(container->shards) );
+		printf("Errore nella scrittura della cartella %s.\n", directory);
+		return 1;
 	}
+	
+	printf("Attività salvate con successo nella cartella %s (%d file riscritti)\n", directory, writtenCount);
+	return 0;
 }
 
 
 /*
- * printActivitiesProgressToFile
+ * saveActivitiesToMapFile
  * 
  * Syntactic Specification:
- * void printActivitiesProgressToFile(ActivitiesContainer container, FILE* file);
+ * int saveActivitiesToMapFile(const char* filename, ActivitiesContainer container);
  * 
  * Semantic Specification:
- * Prints the progress of all container activities to file (progress list format, one per line).
+ * Saves all activities from the container to a mapped store (see 'writeActivityMap()'), the format for
+ * files opened by many short runs: it's used in place through a memory mapping, so opening it doesn't
+ * depend on its size (see 'openActivityMap()'). If the container has read or last saved the same file,
+ * only the activities modified, inserted or removed since then are written, appended as new nodes of its
+ * tree (see 'updateActivityMap()'). Otherwise (first save, other file, file changed by someone else, too
+ * many unreachable bytes) the file is written again completely, compacted, and bound to the container.
+ * Read back by 'readActivitiesFromMapFile()'. The slotted store and the sharded directory of the container
+ * (if any) are released.
  * 
  * Preconditions:
- * - 'file' must be opened for writing
+ * - None
  * 
  * Postconditions:
- * - If both parameters are valid, prints progress with header
+ * - If 'container == NULL' or 'filename == NULL', returns 1 (error)
+ * - If unable to write the file, returns 1 (error): the next save writes the file again completely
+ * - Otherwise, saves all activities and returns 0 (success)
  * 
  * Side Effects:
- * - Writing to file
+ * - File opening, writing and memory mapping
+ * - Modifies the mapped store, the slotted store and the sharded directory of the container
+ * - Output to stdout (informational messages)
  */
-void printActivitiesProgressToFile(ActivitiesContainer container, FILE* file) {
-	if (container != NULL && file != NULL) {	
-		TreeNode root = getRootNode(container);
-		printTreeActivitiesProgressToFile(root, file);
+int saveActivitiesToMapFile(const char* filename, ActivitiesContainer container) {
+	if (container == NULL || filename == NULL) return 1;
+	
+	deleteActivitiesStore( &(container->store) ); // the dirty activities are cleared by the mapped store
+	deleteActivityShards( &(container->shards) );
+	int count = countTreeActivities(getRootNode(container));
+	Activity* activities = malloc((count > 0 ? count : 1) * sizeof(Activity));
+	if (activities == NULL) {
+		printf("Errore nella scrittura del file %s.\n", filename);
+		return 1;
+	}
+	int collectedCount = 0;
+	collectTreeActivities(container->avlTree, activities, &collectedCount);
+	
+	const char* mapFilename = getActivityMapFilename(container->map);
+	int writtenCount = 0;
+	if (mapFilename != NULL && strcmp(mapFilename, filename) == 0 &&
+		 updateActivityMap(container->map, activities, count, &writtenCount) == 0) {
+		free(activities);
+		printf("Attività salvate con successo nel file %s (%d attività riscritte)\n", filename, writtenCount);
+		return 0;
+	}
+	
+	deleteActivityMap( &(container->map) );
+	container->map = writeActivityMap(filename, activities, count);
+	free(activities);
+	if (container->map == NULL) {
+		printf("Errore nella scrittura del file %s.\n", filename);
+		return 1;
 	}
+	
+	printf("Attività salvate con successo nel file %s\n", filename);
+	return 0;
 }
 
 
 /*
- * printActivitiesReport
+ * exportMappedActivityCsv
  * 
  * Syntactic Specification:
- * void printActivitiesReport(ActivitiesContainer container);
+ * void exportMappedActivityCsv(Activity a, void* context);
  * 
  * Semantic Specification:
- * Generates and prints a detailed report of activities categorized by status and period.
+ * Visitor of 'writeActivityMapExport()': writes the CSV line of an activity with the writer in 'context'.
  * 
  * Preconditions:
- * - None
+ * - 'a != NULL', 'context' is an ActivityWriter
  * 
  * Postconditions:
- * - If 'container' is valid, prints a complete report with categorized activities
- * - Interacts with user to define the report period
+ * - The line follows the previous data
  * 
  * Side Effects:
- * - Allocates and deallocates temporary support lists
- * - User interaction (input/output)
- * - Output to stdout
- * - Calls to time management functions
+ * - Writing to file
  */
-void printActivitiesReport(ActivitiesContainer container) {
-	if (container == NULL) return;
-	TreeNode root = getRootNode(container);
-	
-	printTreeActivitiesReport(root);
+void exportMappedActivityCsv(Activity a, void* context) {
+	writeActivityCsvRecord((ActivityWriter)context, a);
 }
 
 
 /*
- * printActivitiesReportToFile
+ * exportMappedActivityJsonl
  * 
  * Syntactic Specification:
- * void printActivitiesReportToFile(ActivitiesContainer container, time_t beginDate, FILE* file);
+ * void exportMappedActivityJsonl(Activity a, void* context);
  * 
  * Semantic Specification:
- * Prints an activity report to file for a specified period.
+ * Visitor of 'writeActivityMapExport()': writes the JSON Lines line of an activity with the writer in 'context'.
  * 
  * Preconditions:
- * - 'file' must be opened for writing
- * - 'beginDate >= 0'
+ * - 'a != NULL', 'context' is an ActivityWriter
  * 
  * Postconditions:
- * - If all parameters are valid, prints the report to file
+ * - The line follows the previous data
  * 
  * Side Effects:
- * - Allocates and deallocates temporary support lists
  * - Writing to file
  */
-void printActivitiesReportToFile(ActivitiesContainer container, time_t beginDate, FILE* file) {
-	if (container == NULL) return;
-	TreeNode root = getRootNode(container);
-	
-	printTreeActivitiesReportToFile(root, beginDate, file);
+void exportMappedActivityJsonl(Activity a, void* context) {
+	writeActivityJsonlRecord((ActivityWriter)context, a);
 }
 
 
+/*
+ * writeActivityMapExport
+ * 
+ * Syntactic Specification:
+ * int writeActivityMapExport(ActivityWriter writer, ActivityMap map, int asJsonl);
+ * 
+ * Semantic Specification:
+ * Writes with the writer the CSV export (header included) or, if 'asJsonl' is not 0, the JSON Lines export
+ * of all activities of a mapped store, in id order, visiting its tree one activity at a time
+ * (see 'visitActivityMap()').
+ * 
+ * Preconditions:
+ * - 'writer != NULL', 'map != NULL'
+ * 
+ * Postconditions:
+ * - Returns 0 if every activity has been written, 1 if the tree of the store is not valid
+ * 
+ * Side Effects:
+ * - Writing to file
+ */
+int writeActivityMapExport(ActivityWriter writer, ActivityMap map, int asJsonl) {
+	if (!asJsonl) writeBytesToActivityWriter(writer, ACTIVITY_EXPORT_CSV_HEADER, strlen(ACTIVITY_EXPORT_CSV_HEADER));
+	return visitActivityMap(map, asJsonl ? exportMappedActivityJsonl : exportMappedActivityCsv, writer);
+}
 
 
 /*
- * readActivitiesFromFile
+ * exportActivitiesToCsv
  * 
  * Syntactic Specification:
- * ActivitiesContainer readActivitiesFromFile(const char* filename, int* count);
+ * int exportActivitiesToCsv(const char* filename, ActivitiesContainer container);
  * 
  * Semantic Specification:
- * Reads activities from a file and inserts them into a new container.
+ * Exports all activities from the container, in id order, to a CSV file (see 'writeActivitiesCsv()'):
+ * unlike the listings, every field is complete and the strings are escaped, so the file can be read
+ * back by any CSV reader with no loss.
+ * The export is written through a buffered writer (see 'newActivityWriter()'), record after record in
+ * its buffer, so it doesn't take more memory with more activities, and replaces the file only when complete.
+ * The activities of a container still only in its mapped store are exported from the store, without
+ * building the tree (see 'readActivitiesFromMapFile()').
  * 
  * Preconditions:
- * - 'count != NULL'
+ * - None
  * 
  * Postconditions:
- * - Creates a new container
- * - If the file doesn't exist, returns an empty container and '*count = 0'
- * - Otherwise, reads all activities from the file and updates '*count' (number of activities read)
+ * - If 'container == NULL' or 'filename == NULL', returns 1 (error)
+ * - If unable to open or write the file, returns 1 (error): the file keeps its previous content
+ * - Otherwise, exports all activities and returns 0 (success)
  * 
  * Side Effects:
- * - Allocates memory for the container and activities
- * - Modifies '*count' (number of activities read)
- * - File opening and reading
+ * - File opening and writing
  * - Output to stdout (informational messages)
  */
-ActivitiesContainer readActivitiesFromFile(const char* filename, int* count) {
-	ActivitiesContainer newContainer = newActivityContainer();
-	if(newContainer == NULL) return NULL;
+int exportActivitiesToCsv(const char* filename, ActivitiesContainer container) {
+	if (container == NULL || filename == NULL) return 1;
 	
-	if (filename == NULL) {
-		printf("Il nome di file fornito è NULL. Verrà creato un contenitore vuoto per le attività.\n");
-		*count = 0;
-		return newContainer;
-	} 
+	ActivityWriter writer = newActivityWriter(filename);
+	if (writer == NULL) {
+		printf("Errore nell'apertura del file %s per la scrittura.\n", filename);
+		return 1;
+	}
+	
+	if (container->isTreePending) {
+		// The activities are still only in the mapped store: they are exported from it, without building the tree
+		if (writeActivityMapExport(writer, container->map, 0) != 0) {
+			discardActivityWriter(&writer);
+			printf("Il file %s non è un archivio mappato valido.\n", getActivityMapFilename(container->map));
+			return 1;
+		}
+	} else {
+		writeActivitiesCsv(writer, getRootNode(container));
+	}
+	if (commitActivityWriter(&writer) != 0) {
+		printf("Errore nella scrittura del file %s.\n", filename);
+		return 1;
+	}
+	
+	printf("Attività esportate con successo nel file %s\n", filename);
+	return 0;
+}
+
+
+/*
+ * exportActivitiesToJsonl
+ * 
+ * Syntactic Specification:
+ * int exportActivitiesToJsonl(const char* filename, ActivitiesContainer container);
+ * 
+ * Semantic Specification:
+ * Exports all activities from the container, in id order, to a JSON Lines file, one object per activity
+ * (see 'writeActivitiesJsonl()'), with every field complete and escaped.
+ * The export is written through a buffered writer (see 'newActivityWriter()'), record after record in
+ * its buffer, so it doesn't take more memory with more activities, and replaces the file only when complete.
+ * The activities of a container still only in its mapped store are exported from the store, without
+ * building the tree (see 'readActivitiesFromMapFile()').
+ * 
+ * Preconditions:
+ * - None
+ * 
+ * Postconditions:
+ * - If 'container == NULL' or 'filename == NULL', returns 1 (error)
+ * - If unable to open or write the file, returns 1 (error): the file keeps its previous content
+ * - Otherwise, exports all activities and returns 0 (success)
+ * 
+ * Side Effects:
+ * - File opening and writing
+ * - Output to stdout (informational messages)
+ */
+int exportActivitiesToJsonl(const char* filename, ActivitiesContainer container) {
+	if (container == NULL || filename == NULL) return 1;
+	
+	ActivityWriter writer = newActivityWriter(filename);
+	if (writer == NULL) {
+		printf("Errore nell'apertura del file %s per la scrittura.\n", filename);
+		return 1;
+	}
+	
+	if (container->isTreePending) {
+		// The activities are still only in the mapped store: they are exported from it, without building the tree
+		if (writeActivityMapExport(writer, container->map, 1) != 0) {
+			discardActivityWriter(&writer);
+			printf("Il file %s non è un archivio mappato valido.\n", getActivityMapFilename(container->map));
+			return 1;
+		}
+	} else {
+		writeActivitiesJsonl(writer, getRootNode(container));
+	}
+	if (commitActivityWriter(&writer) != 0) {
+		printf("Errore nella scrittura del file %s.\n", filename);
+		return 1;
+	}
+	
+	printf("Attività esportate con successo nel file %s\n", filename);
+	return 0;
+}
+
+
+/*
+ * exportActivitiesFromMapFile
+ * 
+ * Syntactic Specification:
+ * int exportActivitiesFromMapFile(const char* mapFilename, const char* filename, int asJsonl);
+ * 
+ * Semantic Specification:
+ * Exports all activities of a mapped store (see 'saveActivitiesToMapFile()'), in id order, to a CSV file
+ * (see 'exportActivitiesToCsv()') or, if 'asJsonl' is not 0, to a JSON Lines file (see
+ * 'exportActivitiesToJsonl()'), without reading them into a container: the store is mapped and its tree
+ * visited, one activity at a time (see 'visitActivityMap()'), so a script exporting a large store neither
+ * parses it nor builds a tree. If the journal of the store holds modifications not yet saved to it, the
+ * store is read into a container and the journal replayed before exporting (see 'exportActivitiesWithJournal()').
+ * 
+ * Preconditions:
+ * - None
+ * 
+ * Postconditions:
+ * - If 'mapFilename == NULL' or 'filename == NULL', returns 1 (error)
+ * - If the mapped store can't be opened or is not valid, or the file can't be written, returns 1 (error):
+ *   the file keeps its previous content
+ * - Otherwise, exports all activities and returns 0 (success)
+ * 
+ * Side Effects:
+ * - File opening, reading (through a memory mapping) and writing
+ * - Output to stdout (informational messages)
+ */
+int exportActivitiesFromMapFile(const char* mapFilename, const char* filename, int asJsonl) {
+	if (mapFilename == NULL || filename == NULL) return 1;
+	
+	// The mapped tree doesn't hold the modifications recorded after the last save: read and replay them
+	if (hasActivityJournalRecords(mapFilename)) {
+		int count = 0;
+		ActivitiesContainer container = readActivitiesFromMapFile(mapFilename, &count);
+		if (container == NULL) return 1;
+		int result = exportActivitiesWithJournal(mapFilename, container, filename, asJsonl);
+		deleteActivityContainer(container);
+		return result;
+	}
+	
+	ActivityMap map = openActivityMap(mapFilename);
+	if (map == NULL) {
+		printf("Il file %s non è un archivio mappato valido.\n", mapFilename);
+		return 1;
+	}
+	
+	ActivityWriter writer = newActivityWriter(filename);
+	if (writer == NULL) {
+		deleteActivityMap(&map);
+		printf("Errore nell'apertura del file %s per la scrittura.\n", filename);
+		return 1;
+	}
+	
+	int visitResult = writeActivityMapExport(writer, map, asJsonl);
+	deleteActivityMap(&map);
+	if (visitResult != 0) {
+		discardActivityWriter(&writer);
+		printf("Il file %s non è un archivio mappato valido.\n", mapFilename);
+		return 1;
+	}
+	if (commitActivityWriter(&writer) != 0) {
+		printf("Errore nella scrittura del file %s.\n", filename);
+		return 1;
+	}
+	
+	printf("Attività esportate con successo nel file %s\n", filename);
+	return 0;
+}
+
+
+/*
+ * exportActivitiesWithJournal
+ * 
+ * Syntactic Specification:
+ * int exportActivitiesWithJournal(const char* baseFilename, ActivitiesContainer container, const char* filename, int asJsonl);
+ * 
+ * Semantic Specification:
+ * Exports all activities of a container just loaded from 'baseFilename' to a CSV file (see
+ * 'exportActivitiesToCsv()') or, if 'asJsonl' is not 0, to a JSON Lines file (see 'exportActivitiesToJsonl()'),
+ * after replaying the modifications recorded in the journal of the base file (see 'replayActivityJournal()'),
+ * so the export holds the same activities the program would show. The journal is only read: no journal is
+ * attached to the container.
+ * 
+ * Preconditions:
+ * - The container has just been loaded from 'baseFilename' (if a journal is already attached, its
+ *   modifications are already in the container and nothing is replayed)
+ * 
+ * Postconditions:
+ * - If 'baseFilename == NULL', 'container == NULL' or 'filename == NULL', returns 1 (error)
+ * - If the journal can't be replayed or the file can't be written, returns 1 (error)
+ * - Otherwise, exports all activities and returns 0 (success)
+ * 
+ * Side Effects:
+ * - Modifies the container (replayed modifications)
+ * - File opening, reading and writing
+ * - Output to stdout (informational messages)
+ */
+int exportActivitiesWithJournal(const char* baseFilename, ActivitiesContainer container, const char* filename, int asJsonl) {
+	if (baseFilename == NULL || container == NULL || filename == NULL) return 1;
+	
+	if (container->journal == NULL) {
+		int replayed = 0;
+		if (replayActivityJournal(baseFilename, container, &replayed) != 0) {
+			printf("Errore nella lettura del registro delle modifiche di %s.\n", baseFilename);
+			return 1;
+		}
+		if (replayed > 0) {
+			printf("Applicate %d modifiche dal registro delle modifiche di %s.\n", replayed, baseFilename);
+		}
+	}
+	
+	return asJsonl ? exportActivitiesToJsonl(filename, container) : exportActivitiesToCsv(filename, container);
+}
+
+
+/*
+ * openActivitiesJournal
+ * 
+ * Syntactic Specification:
+ * int openActivitiesJournal(ActivitiesContainer container, const char* baseFilename);
+ * 
+ * Semantic Specification:
+ * Attaches to the container the journal of the base file it has been loaded from: first the
+ * modifications recorded after the last save of the base file are replayed (see 'replayActivityJournal()'),
+ * then every insert, removal and field update is appended to the journal when it happens. Recording a
+ * modification costs one small write, whatever the number of activities, instead of saving the whole file.
+ * 
+ * Preconditions:
+ * - The container has just been loaded from 'baseFilename'
+ * 
+ * Postconditions:
+ * - If 'container == NULL' or 'baseFilename == NULL', returns 1 (error)
+ * - If the journal can't be replayed or opened, returns 1 (error): the modifications are not journaled
+ * - Otherwise, returns 0 (success)
+ * 
+ * Side Effects:
+ * - Modifies the container (replayed modifications)
+ * - File opening, reading and writing
+ * - Output to stdout (informational messages)
+ */
+int openActivitiesJournal(ActivitiesContainer container, const char* baseFilename) {
+	if (container == NULL || baseFilename == NULL) return 1;
+	
+	closeActivityJournal( &(container->journal) );
+	
+	int replayed = 0;
+	if (replayActivityJournal(baseFilename, container, &replayed) != 0) {
+		printf("Errore nella lettura del registro delle modifiche di %s.\n", baseFilename);
+		return 1;
+	}
+	if (replayed > 0) {
+		printf("Applicate %d modifiche dal registro delle modifiche di %s.\n", replayed, baseFilename);
+	}
+	
+	container->journal = openActivityJournal(baseFilename);
+	if (container->journal == NULL) {
+		printf("Impossibile aprire il registro delle modifiche di %s: le modifiche non saranno registrate.\n", baseFilename);
+		return 1;
+	}
+	
+	return 0;
+}
+
+
+/*
+ * saveActivitiesAndCompactJournal
+ * 
+ * Syntactic Specification:
+ * int saveActivitiesAndCompactJournal(const char* filename, ActivitiesContainer container, int format);
+ * 
+ * Semantic Specification:
+ * Saves all activities from the container to a file in the given format: ACTIVITIES_FORMAT_BINARY (see
+ * 'saveActivitiesToBinaryFile()'), ACTIVITIES_FORMAT_ARCHIVE (see 'saveActivitiesToArchiveFile()'),
+ * ACTIVITIES_FORMAT_STORE (see 'saveActivitiesToStoreFile()'), ACTIVITIES_FORMAT_SHARDS (see
+ * 'saveActivitiesToShardsDirectory()', 'filename' is the directory), ACTIVITIES_FORMAT_MAPPED (see
+ * 'saveActivitiesToMapFile()') or ACTIVITIES_FORMAT_TEXT, the default
+ * (see 'saveActivitiesToFile()').
+ * If the file is the base file of the journal of the container, the journal is compacted: its records
+ * are now in the base file, so it's truncated. The base file is written completely before the journal is
+ * truncated: if the program stops in between, replaying the journal on the new base file has no effect.
+ * 
+ * Preconditions:
+ * - None
+ * 
+ * Postconditions:
+ * - If 'container == NULL' or 'filename == NULL', returns 1 (error)
+ * - If unable to write the file or to truncate the journal, returns 1 (error)
+ * - Otherwise, saves all activities and returns 0 (success)
+ * 
+ * Side Effects:
+ * - File opening and writing, truncation of the journal file
+ * - Output to stdout (informational messages)
+ */
+int saveActivitiesAndCompactJournal(const char* filename, ActivitiesContainer container, int format) {
+	if (container == NULL || filename == NULL) return 1;
+	
+	int saveResult = 0;
+	switch (format) {
+		case ACTIVITIES_FORMAT_BINARY:	saveResult = saveActivitiesToBinaryFile(filename, container);
+												break;
+		case ACTIVITIES_FORMAT_ARCHIVE:	saveResult = saveActivitiesToArchiveFile(filename, container);
+												break;
+		case ACTIVITIES_FORMAT_STORE:	saveResult = saveActivitiesToStoreFile(filename, container);
+												break;
+		case ACTIVITIES_FORMAT_SHARDS:	saveResult = saveActivitiesToShardsDirectory(filename, container);
+												break;
+		case ACTIVITIES_FORMAT_MAPPED:	saveResult = saveActivitiesToMapFile(filename, container);
+												break;
+		default:	saveResult = saveActivitiesToFile(filename, container);
+					break;
+	}
+	if (saveResult != 0) return 1;
+	
+	const char* baseFilename = getActivityJournalBaseFilename(container->journal);
+	if (baseFilename == NULL || strcmp(baseFilename, filename) != 0) return 0;
+	
+	if (truncateActivityJournal(container->journal) != 0) {
+		printf("Errore nella compattazione del registro delle modifiche di %s.\n", filename);
+		return 1;
+	}
+	
+	return 0;
+}
+
+
+/*
+ * verifyActivitiesFile
+ * 
+ * Syntactic Specification:
+ * int verifyActivitiesFile(const char* filename, int format);
+ * 
+ * Semantic Specification:
+ * Checks the integrity of a saved file of activities without reading them into a container: every
+ * block of the file must have the CRC32C recorded in its checksum file when it was saved (see
+ * 'verifyActivityChecksums()'). For ACTIVITIES_FORMAT_SHARDS 'filename' is the directory, whose
+ * manifest and shards are all checked (see 'verifyActivityShards()'). The damaged blocks are
+ * reported with their bytes.
+ * 
+ * Preconditions:
+ * - None
+ * 
+ * Postconditions:
+ * - Returns 0 if the file is intact
+ * - Returns 1 if it's damaged, can't be read or has no valid checksum file (e.g. an export, or a file
+ *   saved by a previous version), or if 'filename == NULL'
+ * 
+ * Side Effects:
+ * - File reading
+ * - Output to stdout (informational messages)
+ */
+int verifyActivitiesFile(const char* filename, int format) {
+	if (filename == NULL) return 1;
+	
+	if (format == ACTIVITIES_FORMAT_SHARDS) return verifyActivityShards(filename);
+	return verifyActivityChecksums(filename);
+}
+
+
+/*
+ * printActivityWithId
+ * 
+ * Syntactic Specification:
+ * void printActivityWithId(ActivitiesContainer container, int activityId);
+ * 
+ * Semantic Specification:
+ * Prints the details of the activity with the specified ID.
+ * 
+ * Preconditions:
+ * - 'container' can be 'NULL'
+ * - 'activityId' must be a valid ID
+ * 
+ * Postconditions:
+ * - If the activity is found, its details are printed
+ * - Otherwise, no action
+ * 
+ * Side Effects:
+ * - Output to stdout via 'printActivityDetailWithMenu()'
+ */
+void printActivityWithId(ActivitiesContainer container, int activityId) {
+	TreeNode root = getRootNode(container);
+	if(root == NULL) return;
+
+	TreeNode activityNode = search(root, activityId);
+	if (activityNode != NULL) {
+		printActivityDetailWithMenu( getActivityFromNode(activityNode) );
+	}
+}
+
+
+/*
+ * printMappedActivityForList
+ * 
+ * Syntactic Specification:
+ * void printMappedActivityForList(Activity a, void* context);
+ * 
+ * Semantic Specification:
+ * Visitor of 'renderMappedActivities()': writes the list line of an activity to the stream in 'context'.
+ * 
+ * Preconditions:
+ * - 'a != NULL', 'context' is a FILE* opened for writing
+ * 
+ * Postconditions:
+ * - The line follows the previous output
+ * 
+ * Side Effects:
+ * - Writing to stream
+ */
+void printMappedActivityForList(Activity a, void* context) {
+	printActivityForListToFile(a, (FILE*)context);
+}
+
+
+/*
+ * printMappedActivityProgress
+ * 
+ * Syntactic Specification:
+ * void printMappedActivityProgress(Activity a, void* context);
+ * 
+ * Semantic Specification:
+ * Visitor of 'renderMappedActivities()': writes the progress line of an activity to the stream in 'context'.
+ * 
+ * Preconditions:
+ * - 'a != NULL', 'context' is a FILE* opened for writing
+ * 
+ * Postconditions:
+ * - The line follows the previous output (nothing for a completed activity)
+ * 
+ * Side Effects:
+ * - Writing to stream
+ */
+void printMappedActivityProgress(Activity a, void* context) {
+	printActivityProgressForListToFile(a, (FILE*)context);
+}
+
+
+/*
+ * renderMappedActivities
+ * 
+ * Syntactic Specification:
+ * int renderMappedActivities(ActivityMap map, int kind, FILE* stream);
+ * 
+ * Semantic Specification:
+ * Writes to 'stream' the list (RENDER_KIND_LIST, see 'renderAllActivities()') or the progress list
+ * (RENDER_KIND_PROGRESS, see 'renderTreeActivitiesProgress()') of the activities of a mapped store, with
+ * headers, visiting its tree one activity at a time (see 'visitActivityMap()') instead of building a tree.
+ * 
+ * Preconditions:
+ * - 'map != NULL', 'stream' must be opened for writing
+ * - 'kind' must be RENDER_KIND_LIST or RENDER_KIND_PROGRESS
+ * 
+ * Postconditions:
+ * - Returns 0 if every activity has been written, 1 if the tree of the store is not valid
+ * 
+ * Side Effects:
+ * - Writing to stream
+ */
+int renderMappedActivities(ActivityMap map, int kind, FILE* stream) {
+	if (kind == RENDER_KIND_PROGRESS) {
+		renderActivitiesProgressHeader(stream);
+		return visitActivityMap(map, printMappedActivityProgress, stream);
+	}
+	
+	renderAllActivitiesHeader(stream);
+	return visitActivityMap(map, printMappedActivityForList, stream);
+}
+
+
+/*
+ * printRenderingWithCache
+ * 
+ * Syntactic Specification:
+ * void printRenderingWithCache(ActivitiesContainer container, int kind, time_t beginDate, time_t nowDate);
+ * 
+ * Semantic Specification:
+ * Prints to stdout the rendering of the given kind (list, progress or report). If the container
+ * has not been modified since the same rendering was made (and, for the report, the dates don't
+ * move any activity to another category), the cached bytes are printed without traversing the
+ * tree or formatting again. Otherwise the rendering is made, printed and cached. The list and the
+ * progress of a container whose activities are still only in its mapped store are made from the store
+ * (see 'renderMappedActivities()'), without building the tree.
+ * 
+ * Preconditions:
+ * - 'container != NULL' and the container is not empty
+ * - 'kind' must be one of RENDER_KIND_*
+ * - 'beginDate' and 'nowDate' are used only for RENDER_KIND_REPORT
+ * 
+ * Postconditions:
+ * - The rendering has been printed and it's in the cache
+ * 
+ * Side Effects:
+ * - Output to stdout
+ * - Allocates memory for the cached rendering (and deallocates the previous one)
+ */
+void printRenderingWithCache(ActivitiesContainer container, int kind, time_t beginDate, time_t nowDate) {
+	if (printCachedRendering(container->renderCache, kind, container->version, beginDate, nowDate, stdout) == 1) return;
+	
+	// The report keeps all the activities at once: only it needs the tree
+	int isFromMap = container->isTreePending && kind != RENDER_KIND_REPORT;
+	TreeNode root = isFromMap ? NULL : getRootNode(container);
+	
+	char* buffer = NULL;
+	size_t size = 0;
+	FILE* stream = (container->renderCache != NULL) ? open_memstream(&buffer, &size) : NULL;
+	FILE* out = (stream != NULL) ? stream : stdout; // without a memory stream, print directly
+	
+	RenderValidity validity;
+	setRenderValidityToAlways(&validity);
+	int isComplete = 1;
+	
+	switch (kind) {
+		case RENDER_KIND_LIST:
+		case RENDER_KIND_PROGRESS: if (isFromMap) isComplete = (renderMappedActivities(container->map, kind, out) == 0);
+				else if (kind == RENDER_KIND_LIST) renderAllActivities(root, out);
+				else renderTreeActivitiesProgress(root, out);
+				break;
+				
+		case RENDER_KIND_REPORT: renderTreeActivitiesReport(root, beginDate, nowDate, out);
+				computeTreeActivitiesReportValidity(root, beginDate, nowDate, &validity);
+				break;
+				
+		default: break;
+	}
+	
+	if (stream != NULL) {
+		fclose(stream);
+		fwrite(buffer, 1, size, stdout);
+		if (isComplete) storeRendering(container->renderCache, kind, container->version, validity, buffer, size);
+	}
+}
+
+
+/*
+ * printActivities
+ * 
+ * Syntactic Specification:
+ * void printActivities(ActivitiesContainer container);
+ * 
+ * Semantic Specification:
+ * Prints all activities (list format, one per line) from the container in ascending order of ID.
+ * 
+ * Preconditions:
+ * - None
+ * 
+ * Postconditions:
+ * - If 'container != NULL', prints all activities with headers (see 'printAllActivities')
+ * 
+ * Side Effects:
+ * - Output to stdout
+ * - The rendering is cached until the container is modified
+ */
+void printActivities(ActivitiesContainer container) {
+	if (container != NULL && (container->isTreePending || getRootNode(container) != NULL)) {
+		printRenderingWithCache(container, RENDER_KIND_LIST, 0, 0);
+	}
+}
+
+
+/*
+ * printActivitiesToFile
+ * 
+ * Syntactic Specification:
+ * void printActivitiesToFile(ActivitiesContainer container, FILE* file);
+ * 
+ * Semantic Specification:
+ * Prints all container activities to file (list format, one per line).
+ * 
+ * Preconditions:
+ * - 'file' must be opened for writing
+ * 
+ * Postconditions:
+ * - If both parameters are valid, prints all activities to file
+ * 
+ * Side Effects:
+ * - Writing to file
+ */
+void printActivitiesToFile(ActivitiesContainer container, FILE* file) {
+	if (container != NULL && file != NULL && container->isTreePending) {
+		visitActivityMap(container->map, printMappedActivityForList, file); // from the mapped store, without building the tree
+	} else if (container != NULL && file != NULL) {
+		TreeNode root = getRootNode(container);
+		printAllActivitiesToFile(root, file);
+	}
+}
+
+
+/*
+ * getSortedViewOfContainer
+ * 
+ * Syntactic Specification:
+ * SortedView getSortedViewOfContainer(ActivitiesContainer container, int sortBy);
+ * 
+ * Semantic Specification:
+ * Returns the sorted view of the container for the criterion, building it from the tree the first time.
+ * 
+ * Preconditions:
+ * - 'container != NULL'
+ * - 'sortBy' should be a valid criterion (0-12); other values mean 0 (ID)
+ * 
+ * Postconditions:
+ * - Returns the view (up to date), or NULL if it can't be built (memory allocation)
+ * 
+ * Side Effects:
+ * - May allocate the view (kept until the container is deleted)
+ */
+SortedView getSortedViewOfContainer(ActivitiesContainer container, int sortBy) {
+	if (sortBy < 0 || sortBy >= ACTIVITY_SORT_CRITERIA_COUNT) sortBy = 0;
+	
+	if (container->sortedViews[sortBy] == NULL) {
+		SortedView view = newSortedView(sortBy);
+		if (loadSortedViewFromTree(view, getRootNode(container)) != 0) {
+			deleteSortedView(&view);
+		}
+		container->sortedViews[sortBy] = view;
+	}
+	
+	return container->sortedViews[sortBy];
+}
+
+
+/*
+ * printActivitiesSorted
+ * 
+ * Syntactic Specification:
+ * void printActivitiesSorted(ActivitiesContainer container, int sortBy);
+ * 
+ * Semantic Specification:
+ * Prints all activities (list format, one per line, with headers) from the container ordered by the
+ * criterion 'sortBy' of 'compareActivityBy()' and then by ID. The order is read from the sorted view
+ * of the criterion, built at the first request and then kept up to date by inserts, removals and
+ * activity field updates: printing again costs no sorting.
+ * 
+ * Preconditions:
+ * - 'sortBy' should be a valid criterion (0-12); other values mean 0 (ID)
+ * 
+ * Postconditions:
+ * - If 'container != NULL' and not empty, prints all activities with headers
+ * - If the view can't be built (memory allocation), prints an error message
+ * 
+ * Side Effects:
+ * - Output to stdout
+ * - May allocate the sorted view of the criterion (kept until the container is deleted)
+ */
+void printActivitiesSorted(ActivitiesContainer container, int sortBy) {
+	if (container == NULL || getRootNode(container) == NULL) return;
+	
+	SortedView view = getSortedViewOfContainer(container, sortBy);
+	if (view == NULL) {
+		printf("Errore: memoria insufficiente per ordinare le attività.\n");
+		return;
+	}
+	
+	printf("\n=============================\n");
+	printf("====== Tutte le attività =====\n");
+	printf("==============================\n");
+	printf("[NOTA: titolo, descrizione e corso potrebbero essere abbreviati. Vai al dettaglio attività per vedere le info complete]\n");
+	printf("[Le attività sono ordinate per %s (a parità, per id)]\n", sortCriterionToText(sortBy));
+	printf("\n====================================================================================================\n");
+	printf("[id] Titolo | Descrizione | Corso | Priorità | Data scadenza o data completamento\n");
+	printf("====================================================================================================\n\n");
+	
+	printSortedViewToFile(view, NULL);
+}
+
+
+/*
+ * printActivitiesSortedToFile
+ * 
+ * Syntactic Specification:
+ * int printActivitiesSortedToFile(ActivitiesContainer container, int sortBy, FILE* file);
+ * 
+ * Semantic Specification:
+ * Prints all container activities to file (list format, one per line) ordered by the criterion
+ * 'sortBy' of 'compareActivityBy()' and then by ID, reading the order from the sorted view of the
+ * criterion (see 'printActivitiesSorted()').
+ * 
+ * Preconditions:
+ * - 'file' must be opened for writing
+ * - 'sortBy' should be a valid criterion (0-12); other values mean 0 (ID)
+ * 
+ * Postconditions:
+ * - Returns 0 if the activities have been printed
+ * - Returns 1 if 'container == NULL', 'file == NULL' or the view can't be built (nothing is printed)
+ * 
+ * Side Effects:
+ * - Writing to file
+ * - May allocate the sorted view of the criterion (kept until the container is deleted)
+ */
+int printActivitiesSortedToFile(ActivitiesContainer container, int sortBy, FILE* file) {
+	if (container == NULL || file == NULL) return 1;
+	
+	SortedView view = getSortedViewOfContainer(container, sortBy);
+	if (view == NULL) return 1;
+	
+	printSortedViewToFile(view, file);
+	return 0;
+}
+
+
+/*
+ * printActivitiesProgress
+ * 
+ * Syntactic Specification:
+ * void printActivitiesProgress(ActivitiesContainer container);
+ * 
+ * Semantic Specification:
+ * Prints the progress of all container activities (progress list format, one per line) with headers.
+ * 
+ * Preconditions:
+ * - None
+ * 
+ * Postconditions:
+ * - If 'container != NULL', prints progress of all activities
+ * 
+ * Side Effects:
+ * - Output to stdout
+ * - The rendering is cached until the container is modified
+ */
+void printActivitiesProgress(ActivitiesContainer container) {
+	if (container != NULL && (container->isTreePending || getRootNode(container) != NULL)) {
+		printRenderingWithCache(container, RENDER_KIND_PROGRESS, 0, 0);
+	}
+}
+
+
+/*
+ * printActivitiesProgressToFile
+ * 
+ * Syntactic Specification:
+ * void printActivitiesProgressToFile(ActivitiesContainer container, FILE* file);
+ * 
+ * Semantic Specification:
+ * Prints the progress of all container activities to file (progress list format, one per line).
+ * 
+ * Preconditions:
+ * - 'file' must be opened for writing
+ * 
+ * Postconditions:
+ * - If both parameters are valid, prints progress with header
+ * 
+ * Side Effects:
+ * - Writing to file
+ */
+void printActivitiesProgressToFile(ActivitiesContainer container, FILE* file) {
+	if (container != NULL && file != NULL && container->isTreePending) {
+		printActivitiesProgressHeaderToFile(file);
+		visitActivityMap(container->map, printMappedActivityProgress, file); // from the mapped store, without building the tree
+	} else if (container != NULL && file != NULL) {	
+		TreeNode root = getRootNode(container);
+		printTreeActivitiesProgressToFile(root, file);
+	}
+}
+
+
+/*
+ * printActivitiesReport
+ * 
+ * Syntactic Specification:
+ * void printActivitiesReport(ActivitiesContainer container);
+ * 
+ * Semantic Specification:
+ * Generates and prints a detailed report of activities categorized by status and period.
+ * 
+ * Preconditions:
+ * - None
+ * 
+ * Postconditions:
+ * - If 'container' is valid, prints a complete report with categorized activities
+ * - Interacts with user to define the report period
+ * 
+ * Side Effects:
+ * - Allocates and deallocates temporary support vectors
+ * - User interaction (input/output)
+ * - Output to stdout
+ * - Calls to time management functions
+ * - The rendering is cached until the container is modified or the dates move an activity to another category
+ */
+void printActivitiesReport(ActivitiesContainer container) {
+	if (container == NULL || getRootNode(container) == NULL) return;
+	
+	time_t beginDate = getReportBeginDateFromUser();
+	printRenderingWithCache(container, RENDER_KIND_REPORT, beginDate, time(NULL) );
+}
+
+
+/*
+ * printActivitiesReportToFile
+ * 
+ * Syntactic Specification:
+ * void printActivitiesReportToFile(ActivitiesContainer container, time_t beginDate, FILE* file);
+ * 
+ * Semantic Specification:
+ * Prints an activity report to file for a specified period.
+ * 
+ * Preconditions:
+ * - 'file' must be opened for writing
+ * - 'beginDate >= 0'
+ * 
+ * Postconditions:
+ * - If all parameters are valid, prints the report to file
+ * 
+ * Side Effects:
+ * - Allocates and deallocates temporary support vectors
+ * - Writing to file
+ */
+void printActivitiesReportToFile(ActivitiesContainer container, time_t beginDate, FILE* file) {
+	if (container == NULL) return;
+	TreeNode root = getRootNode(container);
+	
+	printTreeActivitiesReportToFile(root, beginDate, file);
+}
+
+
+/*
+ * printActivitiesBurndownToFile
+ * 
+ * Syntactic Specification:
+ * int printActivitiesBurndownToFile(ActivitiesContainer container, time_t fromDate, time_t toDate, FILE* file);
+ * 
+ * Semantic Specification:
+ * Writes to file the burndown time series (CSV, one row per calendar day from 'fromDate' to 'toDate')
+ * with completed activities, open activities and remaining minutes.
+ * 
+ * Preconditions:
+ * - 'file' must be opened for writing
+ * - 'fromDate <= toDate'
+ * 
+ * Postconditions:
+ * - If 'container == NULL' or the parameters are not valid, returns 1 (error)
+ * - Otherwise writes the time series and returns 0 (success)
+ * 
+ * Side Effects:
+ * - Allocates and deallocates temporary arrays
+ * - Writing to file
+ */
+int printActivitiesBurndownToFile(ActivitiesContainer container, time_t fromDate, time_t toDate, FILE* file) {
+	if (container == NULL) return 1;
+	TreeNode root = getRootNode(container);
+	
+	return printTreeActivitiesBurndownToFile(root, fromDate, toDate, file);
+}
+
+
+/*
+ * saveActivitiesBurndownToFile
+ * 
+ * Syntactic Specification:
+ * int saveActivitiesBurndownToFile(const char* filename, ActivitiesContainer container, time_t fromDate, time_t toDate);
+ * 
+ * Semantic Specification:
+ * Saves the burndown time series (CSV) of the activities to a file.
+ * 
+ * Preconditions:
+ * - 'fromDate <= toDate'
+ * 
+ * Postconditions:
+ * - If 'container == NULL' or 'filename == NULL', returns 1 (error)
+ * - If unable to open the file, returns 1 (error)
+ * - Otherwise, saves the time series and returns 0 (success)
+ * 
+ * Side Effects:
+ * - File opening and writing
+ * - Output to stdout (informational messages)
+ */
+int saveActivitiesBurndownToFile(const char* filename, ActivitiesContainer container, time_t fromDate, time_t toDate) {
+	if (container == NULL || filename == NULL) return 1;
+	
+	TreeNode root = getRootNode(container);
+	return saveActivitiesBurndownFromTreeToFile(filename, root, fromDate, toDate);
+}
+
+
+/*
+ * printActivitiesRiskToFile
+ * 
+ * Syntactic Specification:
+ * int printActivitiesRiskToFile(ActivitiesContainer container, time_t nowDate, unsigned int dailyCapacity, FILE* file);
+ * 
+ * Semantic Specification:
+ * Prints to file the "rischio" view: the activities whose remaining minutes (totalTime - usedTime)
+ * exceed the working minutes left before their expiry date, given 'dailyCapacity' working minutes
+ * per day. Activities are sorted by slack (working minutes left - remaining minutes), most critical first.
+ * 
+ * Preconditions:
+ * - 'file' must be opened for writing
+ * - 'dailyCapacity' in minutes (0-1440)
+ * 
+ * Postconditions:
+ * - If 'container == NULL' or 'file == NULL', returns 0 and prints nothing
+ * - Otherwise prints the view and returns the number of activities at risk
+ * 
+ * Side Effects:
+ * - Writing to file
+ * - Reloads the packed columns from the tree if the container has been modified since the last view
+ */
+int printActivitiesRiskToFile(ActivitiesContainer container, time_t nowDate, unsigned int dailyCapacity, FILE* file) {
+	if (container == NULL || file == NULL || container->riskColumns == NULL) return 0;
+	
+	if (container->areRiskColumnsValid == 0 || container->riskColumnsVersion != container->version) {
+		container->areRiskColumnsValid = (loadRiskColumnsFromTree(container->riskColumns, getRootNode(container)) == 0) ? 1 : 0;
+		container->riskColumnsVersion = container->version;
+	}
+	
+	int atRiskCount = computeAtRiskActivities(container->riskColumns, nowDate, dailyCapacity);
+	
+	fprintf(file, "\n=== Attività A RISCHIO (capacità giornaliera: %u min, ordinate per margine):\n", dailyCapacity);
+	if (atRiskCount == 0) {
+		fprintf(file, "Nessuna attività a rischio.\n");
+	}
+	
+	for (int i=0; i<atRiskCount; i++) {
+		TreeNode node = search(container->avlTree, getAtRiskActivityId(container->riskColumns, i) );
+		if (node == NULL) continue;
+		
+		fprintf(file, "MARGINE: %.1f min | ", getAtRiskActivitySlack(container->riskColumns, i) );
+		printActivityProgressForListToFile(getActivityFromNode(node), file);
+	}
+	
+	return atRiskCount;
+}
+
+
+/*
+ * printActivitiesRisk
+ * 
+ * Syntactic Specification:
+ * void printActivitiesRisk(ActivitiesContainer container, unsigned int dailyCapacity);
+ * 
+ * Semantic Specification:
+ * Prints to stdout the "rischio" view at the current date (see 'printActivitiesRiskToFile()').
+ * 
+ * Preconditions:
+ * - 'dailyCapacity' in minutes (0-1440)
+ * 
+ * Postconditions:
+ * - If 'container == NULL', no action
+ * - Otherwise the activities at risk are printed
+ * 
+ * Side Effects:
+ * - Output to stdout
+ */
+void printActivitiesRisk(ActivitiesContainer container, unsigned int dailyCapacity) {
+	if (container == NULL) return;
+	
+	printActivitiesRiskToFile(container, time(NULL), dailyCapacity, stdout);
+}
+
+
+
+/*
+ * addInOrderActivitiesToBitmap
+ *
+ * Syntactic Specification:
+ * int addInOrderActivitiesToBitmap(TreeNode root, ActivityBitmap bitmap, ActivityFilter filter, void* context);
+ *
+ * Semantic Specification:
+ * Visits the tree in order (increasing ids, so the set is only appended to) and adds to the set the
+ * ids of the activities selected by the filter (all of them if 'filter' is NULL).
+ *
+ * Preconditions:
+ * - 'bitmap != NULL'
+ *
+ * Postconditions:
+ * - Returns 0 on success, 1 if memory allocation fails (the set is partially filled)
+ *
+ * Side Effects:
+ * - Modifies the set
+ */
+int addInOrderActivitiesToBitmap(TreeNode root, ActivityBitmap bitmap, ActivityFilter filter, void* context) {
+	if (root == NULL) return 0;
+
+	if (addInOrderActivitiesToBitmap(getLeftNode(root), bitmap, filter, context) != 0) return 1;
+
+	Activity activity = getActivityFromNode(root);
+	if (filter == NULL || filter(activity, context)) {
+		if (addIdToActivityBitmap(bitmap, getActivityId(activity)) != 0) return 1;
+	}
+
+	return addInOrderActivitiesToBitmap(getRightNode(root), bitmap, filter, context);
+}
+
+
+/*
+ * getActivitiesBitmapWhere
+ *
+ * Syntactic Specification:
+ * ActivityBitmap getActivitiesBitmapWhere(ActivitiesContainer container, ActivityFilter filter, void* context);
+ *
+ * Semantic Specification:
+ * Returns the set of the ids of the activities for which 'filter(activity, context)' is non-zero
+ * (all the activities if 'filter' is NULL). The result sets of several filters can then be combined
+ * with 'andActivityBitmaps()', 'orActivityBitmaps()' and 'andNotActivityBitmaps()' and visited with
+ * 'getNextActivityInBitmap()'.
+ *
+ * Preconditions:
+ * - 'container != NULL'
+ *
+ * Postconditions:
+ * - Returns the new set (to be deallocated with 'deleteActivityBitmap()')
+ * - Returns 'NULL' if 'container == NULL' or memory allocation fails
+ *
+ * Side Effects:
+ * - Allocates memory
+ */
+ActivityBitmap getActivitiesBitmapWhere(ActivitiesContainer container, ActivityFilter filter, void* context) {
+	if (container == NULL) return NULL;
+
+	ActivityBitmap bitmap = newActivityBitmap();
+	if (bitmap == NULL) return NULL;
+
+	if (addInOrderActivitiesToBitmap(getRootNode(container), bitmap, filter, context) != 0) {
+		deleteActivityBitmap(&bitmap);
+	}
+
+	return bitmap;
+}
+
+
+/*
+ * getNextActivityInBitmap
+ *
+ * Syntactic Specification:
+ * Activity getNextActivityInBitmap(ActivitiesContainer container, ActivityBitmap bitmap, int* cursor);
+ *
+ * Semantic Specification:
+ * Iterates over the activities of the container whose ids are in the set, in increasing id order.
+ * '*cursor' must be 0 before the first call; each call returns the next activity and advances it.
+ * Ids of activities no longer in the container are skipped.
+ *
+ * Preconditions:
+ * - 'cursor != NULL'
+ *
+ * Postconditions:
+ * - Returns the next activity, or NULL when there are no more activities (or a parameter is NULL)
+ *
+ * Side Effects:
+ * - Modifies '*cursor'
+ */
+Activity getNextActivityInBitmap(ActivitiesContainer container, ActivityBitmap bitmap, int* cursor) {
+	if (container == NULL || bitmap == NULL || cursor == NULL) return NULL;
+
+	int activityId = getNextIdInActivityBitmap(bitmap, *cursor);
+	while (activityId >= 0) {
+		*cursor = activityId + 1;
+		Activity activity = getActivityWithId(container, activityId);
+		if (activity != NULL) return activity;
+
+		activityId = getNextIdInActivityBitmap(bitmap, *cursor);
+	}
+
+	return NULL;
+}
+
+
+/*
+ * printActivitiesInBitmapToFile
+ *
+ * Syntactic Specification:
+ * void printActivitiesInBitmapToFile(ActivitiesContainer container, ActivityBitmap bitmap, FILE* file);
+ *
+ * Semantic Specification:
+ * Prints the activities of the container whose ids are in the set (list format, one per line, in
+ * increasing id order) to file (to screen if 'file' is NULL).
+ *
+ * Preconditions:
+ * - 'file' can be NULL (screen) or a file opened for writing
+ *
+ * Postconditions:
+ * - If 'container' or 'bitmap' are NULL, nothing is printed
+ *
+ * Side Effects:
+ * - Output to stdout or writing to file
+ */
+void printActivitiesInBitmapToFile(ActivitiesContainer container, ActivityBitmap bitmap, FILE* file) {
+	int cursor = 0;
+	Activity activity = getNextActivityInBitmap(container, bitmap, &cursor);
+	while (activity != NULL) {
+		printActivityForListToScreenOrFile(activity, file);
+		activity = getNextActivityInBitmap(container, bitmap, &cursor);
+	}
+}
+
+
+
+
+/*
+ * sortActivitiesById
+ * 
+ * Syntactic Specification:
+ * Activity* sortActivitiesById(Activity* activities, int count, int* sortedCount);
+ * 
+ * Semantic Specification:
+ * Returns the activities of the array sorted by id, each id once: the sort is stable (see
+ * 'sortSupportVectorParallel()'), so of the activities with the same id the one kept is the first of
+ * the array, the one 'insertActivity()' would keep; the others are deallocated.
+ * 
+ * Preconditions:
+ * - 'activities' has 'count' activities (not NULL), 'count > 0', 'sortedCount != NULL'
+ * 
+ * Postconditions:
+ * - Returns a new array with '*sortedCount' activities (the caller deallocates it)
+ * - Returns NULL if memory allocation fails: no activity is deallocated
+ * 
+ * Side Effects:
+ * - Allocates memory, deallocates the duplicated activities
+ * - May create and join threads
+ */
+Activity* sortActivitiesById(Activity* activities, int count, int* sortedCount) {
+	ActivitiesContainerSupportVector vector = newSupportVector();
+	Activity* sorted = malloc(count * sizeof(Activity));
+	for (int i = 0; i < count && vector != NULL; i++) {
+		addActivityToSupportVector(vector, activities[i]);
+	}
+	
+	if (vector == NULL || sorted == NULL || getSupportVectorSize(vector) != count) {
+		deleteSupportVector(&vector);
+		free(sorted);
+		return NULL;
+	}
+	
+	sortSupportVectorParallel(vector, 0, 0); // by id, one thread per processor
+	
+	*sortedCount = 0;
+	for (int i = 0; i < count; i++) {
+		Activity activity = getActivityFromSupportVector(vector, i);
+		if (*sortedCount > 0 && getActivityId(activity) == getActivityId(sorted[*sortedCount - 1])) {
+			deleteActivity(activity);
+		} else {
+			sorted[(*sortedCount)++] = activity;
+		}
+	}
+	
+	deleteSupportVector(&vector);
+	return sorted;
+}
+
+
+/*
+ * insertSortedActivities
+ * 
+ * Syntactic Specification:
+ * void insertSortedActivities(ActivitiesContainer container, Activity* activities, int count);
+ * 
+ * Semantic Specification:
+ * Inserts an array of activities (in file order) into the container with the result of 'insertActivity()'
+ * called on each of them in order. If the container is empty and no id is 0 (which 'insertActivity()'
+ * would replace with an id depending on the order), the tree is built at once in O(n) by
+ * 'buildTreeFromSortedActivities()': if the ids are not strictly increasing, the activities are first
+ * sorted by id with a stable parallel sort and, of the activities with the same id, only the first one
+ * is kept (as the tree does), the others are deallocated. Otherwise (or if that fails) the activities
+ * are inserted one by one.
+ * 
+ * Preconditions:
+ * - 'container != NULL', 'activities' has 'count' activities (not NULL)
+ * 
+ * Postconditions:
+ * - The activities are in the container (owned by it), the duplicated ones are deallocated
+ * - 'nextId' follows the id of the last activity of the array, as after the insertions one by one
+ * 
+ * Side Effects:
+ * - Modifies the container
+ * - May create and join threads (parallel sort)
+ */
+void insertSortedActivities(ActivitiesContainer container, Activity* activities, int count) {
+	int isSorted = 1;
+	int hasZeroId = 0;
+	int lastId = (count > 0) ? getActivityId(activities[count-1]) : 0; // before the duplicates are deallocated
+	for (int i = 0; i < count; i++) {
+		int activityId = getActivityId(activities[i]);
+		if (activityId == 0) hasZeroId = 1;
+		if (i > 0 && activityId <= getActivityId(activities[i-1])) isSorted = 0;
+	}
+	
+	Activity* sorted = (container->avlTree == NULL && !hasZeroId && count > 0) ? activities : NULL;
+	int sortedCount = count;
+	if (sorted != NULL && !isSorted) {
+		sorted = sortActivitiesById(activities, count, &sortedCount);
+	}
+	
+	if (sorted == NULL) {
+		for (int i = 0; i < count; i++) {
+			insertActivity(container, activities[i]);
+		}
+		return;
+	}
+	
+	TreeNode root = buildTreeFromSortedActivities(sorted, sortedCount);
+	if (root == NULL) {
+		for (int i = 0; i < sortedCount; i++) {
+			insertActivity(container, sorted[i]);
+		}
+	} else {
+		container->avlTree = root;
+		container->version += count;
+		for (int i = 0; i < sortedCount; i++) {
+			setActivityChangeObserver(sorted[i], onContainedActivityChange, container);
+			addActivityToSortedViews(container, sorted[i]);
+			if (container->journal != NULL) appendInsertToActivityJournal(container->journal, sorted[i]);
+		}
+	}
+	container->nextId = lastId + 1;
+	
+	if (sorted != activities) free(sorted);
+}
+
+
+/*
+ * readActivitiesFromTextFile
+ * 
+ * Syntactic Specification:
+ * ActivitiesContainer readActivitiesFromTextFile(const char* filename, int lazyDescr, int threadCount, size_t minChunkSize, int* count);
+ * 
+ * Semantic Specification:
+ * Reads activities from a file in the text format and inserts them into a new container: implementation of
+ * 'readActivitiesFromFile()' ('lazyDescr == 0'), 'readActivitiesFromFileWithLazyDescr()' ('lazyDescr == 1')
+ * and 'readActivitiesFromFileInParallel()'. 'lazyDescr' only applies to the mapped readings: a file that can't
+ * be mapped is read with its descriptions. 'threadCount' and 'minChunkSize' are passed to
+ * 'readActivitiesFromMappedFileInParallel()' (0: the defaults).
+ * 
+ * Preconditions:
+ * - 'count != NULL'
+ * 
+ * Postconditions:
+ * - The same of 'readActivitiesFromFile()'
+ * 
+ * Side Effects:
+ * - The same of 'readActivitiesFromFile()'
+ * - With 'lazyDescr', the file may stay open (see 'readActivitiesFromMappedFile()')
+ */
+ActivitiesContainer readActivitiesFromTextFile(const char* filename, int lazyDescr, int threadCount, size_t minChunkSize, int* count) {
+	ActivitiesContainer newContainer = newActivityContainer();
+	if(newContainer == NULL) return NULL;
+	
+	if (filename == NULL) {
+		printf("Il nome di file fornito è NULL. Verrà creato un contenitore vuoto per le attività.\n");
+		*count = 0;
+		return newContainer;
+	} 
+	
+	int reachedEnd = 0;
+	Activity* activities = NULL;
+	if (readActivitiesFromMappedFileInParallel(filename, lazyDescr, threadCount, minChunkSize, &activities, count, &reachedEnd) == 0) {
+		insertSortedActivities(newContainer, activities, *count);
+		free(activities);
+		if (reachedEnd) printf("Lette %d attività dal file %s.\n", *count, filename);
+		return newContainer;
+	}
+	
+	if (readActivitiesFromMappedFile(filename, lazyDescr, &activities, count, &reachedEnd) == 0) {
+		insertSortedActivities(newContainer, activities, *count);
+		free(activities);
+		if (reachedEnd) printf("Lette %d attività dal file %s.\n", *count, filename);
+		return newContainer;
+	}
+	
+	FILE* file = fopen(filename, "r");
+	if (file == NULL) {
+		printf("Il file %s non esiste. Verrà creato un contenitore vuoto per le attività.\n", filename);
+		*count = 0;
+		return newContainer;
+	}
+	
+	*count = 0;
+	
+	while (!feof(file)) {  
+		Activity currentActivity = readActivityFromFile(file);
+		if (currentActivity == NULL) {
+			fclose(file);
+			return newContainer;
+		}
+		
+		insertActivity(newContainer, currentActivity);
+		*count += 1;
+	}
+	  
+	fclose(file);
+	printf("Lette %d attività dal file %s.\n", *count, filename);
+	return newContainer;
+}
+
+
+/*
+ * readActivitiesFromFile
+ * 
+ * Syntactic Specification:
+ * ActivitiesContainer readActivitiesFromFile(const char* filename, int* count);
+ * 
+ * Semantic Specification:
+ * Reads activities from a file and inserts them into a new container.
+ * A regular file is read through a memory mapping (see 'readActivitiesFromMappedFile()'), otherwise
+ * record by record with 'readActivityFromFile()': the result is the same. A large file is parsed on
+ * several threads (see 'readActivitiesFromMappedFileInParallel()') and the tree is built at once
+ * (see 'insertSortedActivities()'), again with the same result.
+ * 
+ * Preconditions:
+ * - 'count != NULL'
+ * 
+ * Postconditions:
+ * - Creates a new container
+ * - If the file doesn't exist, returns an empty container and '*count = 0'
+ * - Otherwise, reads all activities from the file and updates '*count' (number of activities read)
+ * 
+ * Side Effects:
+ * - Allocates memory for the container and activities
+ * - Modifies '*count' (number of activities read)
+ * - File opening and reading
+ * - Output to stdout (informational messages)
+ * - May create and join threads
+ */
+ActivitiesContainer readActivitiesFromFile(const char* filename, int* count) {
+	return readActivitiesFromTextFile(filename, 0, 0, 0, count);
+}
+
+
+/*
+ * readActivitiesFromFileWithLazyDescr
+ * 
+ * Syntactic Specification:
+ * ActivitiesContainer readActivitiesFromFileWithLazyDescr(const char* filename, int* count);
+ * 
+ * Semantic Specification:
+ * Reads activities from a file as 'readActivitiesFromFile()', but leaves the descriptions in the file:
+ * every activity keeps only the position and the length of its description, read from the file
+ * (with 'pread()') the first time it's needed (see 'setActivityLazyDescr()'). The descriptions that are
+ * never shown, searched or sorted don't take memory. The file stays open until the last description is
+ * read (or its activity deleted), so a save that replaces it doesn't change the descriptions still to read.
+ * A file that can't be mapped (e.g. not a regular file) is read with its descriptions.
+ * 
+ * Preconditions:
+ * - 'count != NULL'
+ * 
+ * Postconditions:
+ * - Creates a new container
+ * - If the file doesn't exist, returns an empty container and '*count = 0'
+ * - Otherwise, reads all activities from the file and updates '*count' (number of activities read)
+ * 
+ * Side Effects:
+ * - Allocates memory for the container and activities
+ * - Modifies '*count' (number of activities read)
+ * - File opening and reading
+ * - Output to stdout (informational messages)
+ * - May create and join threads
+ * - The file may stay open while some descriptions are not read
+ */
+ActivitiesContainer readActivitiesFromFileWithLazyDescr(const char* filename, int* count) {
+	return readActivitiesFromTextFile(filename, 1, 0, 0, count);
+}
+
+
+/*
+ * readActivitiesFromFileInParallel
+ * 
+ * Syntactic Specification:
+ * ActivitiesContainer readActivitiesFromFileInParallel(const char* filename, int threadCount, size_t minChunkSize, int* count);
+ * 
+ * Semantic Specification:
+ * Reads activities from a file as 'readActivitiesFromFile()', choosing how the file is parsed in parallel
+ * (see 'readActivitiesFromMappedFileInParallel()'): on 'threadCount' threads (one per online processor if
+ * it's 0), each one reading at least 'minChunkSize' bytes (PARALLEL_LOAD_MIN_CHUNK_SIZE if it's 0). With
+ * less than 2 threads the file is read sequentially. The result doesn't depend on the choice.
+ * 
+ * Preconditions:
+ * - 'count != NULL'
+ * 
+ * Postconditions:
+ * - The same of 'readActivitiesFromFile()'
+ * 
+ * Side Effects:
+ * - The same of 'readActivitiesFromFile()'
+ */
+ActivitiesContainer readActivitiesFromFileInParallel(const char* filename, int threadCount, size_t minChunkSize, int* count) {
+	return readActivitiesFromTextFile(filename, 0, threadCount, minChunkSize, count);
+}
+
+
+/*
+ * readActivitiesFromBinaryFile
+ * 
+ * Syntactic Specification:
+ * ActivitiesContainer readActivitiesFromBinaryFile(const char* filename, int* count);
+ * 
+ * Semantic Specification:
+ * Reads activities from a file in the binary snapshot format (see 'saveActivitiesToBinaryFile()')
+ * and inserts them into a new container. Since a snapshot has the activities in id order, the
+ * tree is built at once in O(n) instead of inserting the activities one by one.
+ * 
+ * Preconditions:
+ * - 'count != NULL'
+ * 
+ * Postconditions:
+ * - Creates a new container
+ * - If the file doesn't exist or is not a valid snapshot, returns an empty container and '*count = 0'
+ * - Otherwise, reads all activities from the file and updates '*count' (number of activities read)
+ * 
+ * Side Effects:
+ * - Allocates memory for the container and activities
+ * - Modifies '*count' (number of activities read)
+ * - File opening and reading
+ * - Output to stdout (informational messages)
+ */
+ActivitiesContainer readActivitiesFromBinaryFile(const char* filename, int* count) {
+	ActivitiesContainer newContainer = newActivityContainer();
+	if(newContainer == NULL) return NULL;
 	
-	FILE* file = fopen(filename, "r");
+	*count = 0;
+	if (filename == NULL) {
+		printf("Il nome di file fornito è NULL. Verrà creato un contenitore vuoto per le attività.\n");
+		return newContainer;
+	} 
+	
+	FILE* file = fopen(filename, "rb");
 	if (file == NULL) {
 		printf("Il file %s non esiste. Verrà creato un contenitore vuoto per le attività.\n", filename);
-		*count = 0;
 		return newContainer;
 	}
 	
+	Activity* activities = NULL;
+	int readResult = readActivitiesSnapshot(file, &activities, count);
+	fclose(file);
+	if (readResult != 0) {
+		printf("Il file %s non è un archivio binario valido. Verrà creato un contenitore vuoto per le attività.\n", filename);
+		return newContainer;
+	}
+	
+	insertSortedActivities(newContainer, activities, *count);
+	free(activities);
+	
+	printf("Lette %d attività dal file %s.\n", *count, filename);
+	return newContainer;
+}
+
+
+/*
+ * readActivitiesFromArchiveFile
+ * 
+ * Syntactic Specification:
+ * ActivitiesContainer readActivitiesFromArchiveFile(const char* filename, int* count);
+ * 
+ * Semantic Specification:
+ * Reads activities from a file in the compact archive format (see 'saveActivitiesToArchiveFile()')
+ * and inserts them into a new container. As for a binary snapshot, the activities are in id order
+ * and the tree is built at once.
+ * 
+ * Preconditions:
+ * - 'count != NULL'
+ * 
+ * Postconditions:
+ * - Creates a new container
+ * - If the file doesn't exist or is not a valid archive, returns an empty container and '*count = 0'
+ * - Otherwise, reads all activities from the file and updates '*count' (number of activities read)
+ * 
+ * Side Effects:
+ * - Allocates memory for the container and activities
+ * - Modifies '*count' (number of activities read)
+ * - File opening and reading
+ * - Output to stdout (informational messages)
+ */
+ActivitiesContainer readActivitiesFromArchiveFile(const char* filename, int* count) {
+	ActivitiesContainer newContainer = newActivityContainer();
+	if(newContainer == NULL) return NULL;
+	
 	*count = 0;
+	if (filename == NULL) {
+		printf("Il nome di file fornito è NULL. Verrà creato un contenitore vuoto per le attività.\n");
+		return newContainer;
+	} 
 	
-	while (!feof(file)) {  
-		Activity currentActivity = readActivityFromFile(file);
-		if (currentActivity == NULL) {
-			fclose(file);
-			return newContainer;
-		}
-		
-		insertActivity(newContainer, currentActivity);
-		*count += 1;
+	FILE* file = fopen(filename, "rb");
+	if (file == NULL) {
+		printf("Il file %s non esiste. Verrà creato un contenitore vuoto per le attività.\n", filename);
+		return newContainer;
 	}
-	  
+	
+	Activity* activities = NULL;
+	int readResult = readActivitiesArchive(file, &activities, count);
 	fclose(file);
+	if (readResult != 0) {
+		printf("Il file %s non è un archivio compatto valido. Verrà creato un contenitore vuoto per le attività.\n", filename);
+		return newContainer;
+	}
+	
+	insertSortedActivities(newContainer, activities, *count);
+	free(activities);
+	
+	printf("Lette %d attività dal file %s.\n", *count, filename);
+	return newContainer;
+}
+
+
+/*
+ * readActivitiesFromStoreFile
+ * 
+ * Syntactic Specification:
+ * ActivitiesContainer readActivitiesFromStoreFile(const char* filename, int* count);
+ * 
+ * Semantic Specification:
+ * Reads activities from a file in the slotted store format (see 'saveActivitiesToStoreFile()') and inserts
+ * them into a new container, bound to the file: the next slotted save to the same file only writes the
+ * activities modified, inserted or removed in the meantime. The records are in id order until the first
+ * update appends some, then they are sorted as those of a text file; 'nextId' follows the highest id.
+ * 
+ * Preconditions:
+ * - 'count != NULL'
+ * 
+ * Postconditions:
+ * - Creates a new container
+ * - If the file doesn't exist or is not a valid store, returns an empty container and '*count = 0'
+ * - Otherwise, reads all activities from the file and updates '*count' (number of activities read)
+ * 
+ * Side Effects:
+ * - Allocates memory for the container and activities
+ * - Modifies '*count' (number of activities read)
+ * - File opening and reading
+ * - Output to stdout (informational messages)
+ */
+ActivitiesContainer readActivitiesFromStoreFile(const char* filename, int* count) {
+	ActivitiesContainer newContainer = newActivityContainer();
+	if(newContainer == NULL) return NULL;
+	
+	*count = 0;
+	if (filename == NULL) {
+		printf("Il nome di file fornito è NULL. Verrà creato un contenitore vuoto per le attività.\n");
+		return newContainer;
+	} 
+	
+	if (access(filename, F_OK) != 0) {
+		printf("Il file %s non esiste. Verrà creato un contenitore vuoto per le attività.\n", filename);
+		return newContainer;
+	}
+	
+	Activity* activities = NULL;
+	ActivityStore store = readActivitiesStore(filename, &activities, count);
+	if (store == NULL) {
+		printf("Il file %s non è un archivio a slot valido. Verrà creato un contenitore vuoto per le attività.\n", filename);
+		return newContainer;
+	}
+	
+	insertSortedActivities(newContainer, activities, *count);
+	free(activities);
+	newContainer->store = store;
+	
+	// after an update the last record is not the highest id
+	TreeNode node = newContainer->avlTree;
+	while (node != NULL && getRightNode(node) != NULL) node = getRightNode(node);
+	if (node != NULL) newContainer->nextId = getActivityId(getActivityFromNode(node)) + 1;
+	
+	printf("Lette %d attività dal file %s.\n", *count, filename);
+	return newContainer;
+}
+
+
+/*
+ * readActivitiesFromShardsDirectory
+ * 
+ * Syntactic Specification:
+ * ActivitiesContainer readActivitiesFromShardsDirectory(const char* directory, int* count);
+ * 
+ * Semantic Specification:
+ * Reads activities from a sharded directory (see 'saveActivitiesToShardsDirectory()'), its shards on
+ * several threads (see 'readActivityShards()'), and inserts them into a new container, bound to the
+ * directory: the next save to the same directory only writes the shards modified in the meantime. The
+ * shards cover increasing ranges of ids, so their activities are joined in id order and the tree is built at once.
+ * 
+ * Preconditions:
+ * - 'count != NULL'
+ * 
+ * Postconditions:
+ * - Creates a new container
+ * - If the directory doesn't exist or is not a valid sharded directory, returns an empty container and '*count = 0'
+ * - Otherwise, reads all activities from the directory and updates '*count' (number of activities read)
+ * 
+ * Side Effects:
+ * - Allocates memory for the container and activities
+ * - Modifies '*count' (number of activities read)
+ * - File opening and reading, creation and join of threads
+ * - Output to stdout (informational messages)
+ */
+ActivitiesContainer readActivitiesFromShardsDirectory(const char* directory, int* count) {
+	ActivitiesContainer newContainer = newActivityContainer();
+	if(newContainer == NULL) return NULL;
+	
+	*count = 0;
+	if (directory == NULL) {
+		printf("Il nome di file fornito è NULL. Verrà creato un contenitore vuoto per le attività.\n");
+		return newContainer;
+	} 
+	
+	if (access(directory, F_OK) != 0) {
+		printf("La cartella %s non esiste. Verrà creato un contenitore vuoto per le attività.\n", directory);
+		return newContainer;
+	}
+	
+	Activity* activities = NULL;
+	ActivityShards shards = readActivityShards(directory, &activities, count);
+	if (shards == NULL) {
+		printf("La cartella %s non è un archivio a blocchi valido. Verrà creato un contenitore vuoto per le attività.\n", directory);
+		return newContainer;
+	}
+	
+	insertSortedActivities(newContainer, activities, *count);
+	free(activities);
+	newContainer->shards = shards;
+	
+	printf("Lette %d attività dalla cartella %s.\n", *count, directory);
+	return newContainer;
+}
+
+
+/*
+ * readActivitiesFromMapFile
+ * 
+ * Syntactic Specification:
+ * ActivitiesContainer readActivitiesFromMapFile(const char* filename, int* count);
+ * 
+ * Semantic Specification:
+ * Opens a mapped store (see 'saveActivitiesToMapFile()') as a new container, bound to the file: the next
+ * save to the same file only writes the activities modified, inserted or removed in the meantime. The file
+ * is mapped and its header checked, nothing else: no activity is created and no tree is built, so opening
+ * doesn't depend on the number of activities; 'nextId' follows the highest id, read from the right edge
+ * of the mapped tree. The listings by id, the progress list and the exports are made from the mapped nodes;
+ * the first operation that needs the activities in memory (lookup, modification, sorted listing, report...)
+ * builds the tree of the container at once (see 'buildPendingTree()').
+ * 
+ * Preconditions:
+ * - 'count != NULL'
+ * 
+ * Postconditions:
+ * - Creates a new container
+ * - If the file doesn't exist or its header is not valid, returns an empty container and '*count = 0'
+ * - Otherwise, returns the container with the activities of the file and sets '*count' (number of activities)
+ * 
+ * Side Effects:
+ * - Allocates memory for the container
+ * - Modifies '*count' (number of activities)
+ * - File opening and memory mapping
+ * - Output to stdout (informational messages)
+ */
+ActivitiesContainer readActivitiesFromMapFile(const char* filename, int* count) {
+	ActivitiesContainer newContainer = newActivityContainer();
+	if(newContainer == NULL) return NULL;
+	
+	*count = 0;
+	if (filename == NULL) {
+		printf("Il nome di file fornito è NULL. Verrà creato un contenitore vuoto per le attività.\n");
+		return newContainer;
+	} 
+	
+	if (access(filename, F_OK) != 0) {
+		printf("Il file %s non esiste. Verrà creato un contenitore vuoto per le attività.\n", filename);
+		return newContainer;
+	}
+	
+	ActivityMap map = openActivityMap(filename);
+	if (map == NULL) {
+		printf("Il file %s non è un archivio mappato valido. Verrà creato un contenitore vuoto per le attività.\n", filename);
+		return newContainer;
+	}
+	
+	*count = getActivityMapCount(map);
+	newContainer->map = map;
+	newContainer->nextId = getActivityMapMaxId(map) + 1;
+	newContainer->isTreePending = (*count > 0) ? 1 : 0; // the tree is built by the first operation that needs it
+	
 	printf("Lette %d attività dal file %s.\n", *count, filename);
 	return newContainer;
 }
 
 
 
+/*
+ * insertImportedActivities
+ * 
+ * Syntactic Specification:
+ * int insertImportedActivities(ActivitiesContainer container, Activity* activities, int count, int* skippedCount);
+ * 
+ * Semantic Specification:
+ * Inserts the imported activities (in file order) into the container. The activities with an id are
+ * sorted by id with the stable parallel sort: of the activities with the same id only the first one is
+ * kept, and an activity whose id is already in the container is skipped (the contained one is kept).
+ * The activities without an id (0) then take, in file order, the ids from 'nextId' on, or from the
+ * highest id of the container and of the file plus one if higher, so they can't take a used id.
+ * Instead of an 'insertActivity()' per row (a descent with rotations, and 'nextId' following the last
+ * insertion), the sorted activities are merged with the contained ones (read by an in order visit)
+ * and the tree is built again at once by 'buildTreeFromSortedActivities()' in O(n + m): the old nodes
+ * are deallocated, the activities are moved. If memory allocation fails, the activities are inserted
+ * one by one with 'insertActivity()', and the ones it ignores (id already taken) are skipped.
+ * 
+ * Preconditions:
+ * - 'container != NULL', 'activities' has 'count' activities (not NULL), 'skippedCount != NULL'
+ * 
+ * Postconditions:
+ * - Returns the number of activities inserted (owned by the container), '*skippedCount' is the number
+ *   of the ones skipped (deallocated)
+ * - 'nextId' follows the highest id of the container
+ * 
+ * Side Effects:
+ * - Modifies the container
+ * - Writing to the journal file (if the container has a journal)
+ * - May create and join threads (parallel sort)
+ */
+int insertImportedActivities(ActivitiesContainer container, Activity* activities, int count, int* skippedCount) {
+	*skippedCount = 0;
+	if (count <= 0) return 0;
+	buildPendingTree(container);
+	
+	// the activities with an id first, then the ones without, both in file order
+	Activity* imported = malloc(count * sizeof(Activity));
+	int withIdCount = 0;
+	int withoutIdCount = 0;
+	for (int i = 0; i < count && imported != NULL; i++) {
+		if (getActivityId(activities[i]) != 0) imported[withIdCount++] = activities[i];
+	}
+	for (int i = 0; i < count && imported != NULL; i++) {
+		if (getActivityId(activities[i]) == 0) imported[withIdCount + withoutIdCount++] = activities[i];
+	}
+	
+	Activity* sorted = (imported != NULL && withIdCount > 0) ? sortActivitiesById(imported, withIdCount, &withIdCount) : NULL;
+	if (imported == NULL || (sorted == NULL && withIdCount > 0)) {
+		// one by one, with the same ids: the activities with an id first, then the ones without from the highest id on
+		int previousNextId = (container->avlTree != NULL) ? container->nextId : 1;
+		for (int i = 0; i < count; i++) {
+			if (getActivityId(activities[i]) != 0) insertActivity(container, activities[i]);
+		}
+		int maxId = 0;
+		for (TreeNode node = container->avlTree; node != NULL; node = getRightNode(node)) {
+			maxId = getActivityId(getActivityFromNode(node));
+		}
+		if (maxId < INT_MAX) {
+			container->nextId = (previousNextId > maxId) ? previousNextId : maxId + 1;
+			for (int i = 0; i < count; i++) {
+				if (getActivityId(activities[i]) == 0 && container->nextId < INT_MAX) insertActivity(container, activities[i]);
+			}
+		}
+		
+		// the tree ignores an activity whose id is already taken: it's skipped, as the ones left without an id
+		int insertedCount = 0;
+		for (int i = 0; i < count; i++) {
+			int activityId = getActivityId(activities[i]);
+			if (activityId != 0 && getActivityWithId(container, activityId) == activities[i]) insertedCount++;
+			else deleteActivity(activities[i]);
+		}
+		*skippedCount = count - insertedCount;
+		free(imported);
+		return insertedCount;
+	}
+	
+	// of the sorted activities with an id, the ones whose id is already taken are skipped
+	int importedCount = 0;
+	for (int i = 0; i < withIdCount; i++) {
+		if (search(container->avlTree, getActivityId(sorted[i])) != NULL) deleteActivity(sorted[i]);
+		else imported[importedCount++] = sorted[i];
+	}
+	free(sorted);
+	memmove(imported + importedCount, imported + count - withoutIdCount, withoutIdCount * sizeof(Activity));
+	withIdCount = importedCount;
+	
+	int maxId = (withIdCount > 0) ? getActivityId(imported[withIdCount - 1]) : 0;
+	for (TreeNode node = container->avlTree; node != NULL; node = getRightNode(node)) {
+		if (getActivityId(getActivityFromNode(node)) > maxId) maxId = getActivityId(getActivityFromNode(node));
+	}
+	long long nextId = (container->avlTree != NULL && container->nextId > maxId) ? container->nextId : (long long)maxId + 1;
+	for (int i = 0; i < withoutIdCount; i++) {
+		if (nextId > INT_MAX) {
+			deleteActivity(imported[withIdCount + i]); // no id left
+			continue;
+		}
+		setActivityId(imported[withIdCount + i], (int)nextId++);
+		imported[importedCount++] = imported[withIdCount + i];
+	}
+	*skippedCount = count - importedCount;
+	
+	// the contained activities are read in the tail of the array, then merged with the imported ones from its head:
+	// the merge never writes past the contained activity it reads
+	int existingCount = countTreeActivities(container->avlTree);
+	Activity* merged = malloc((existingCount + importedCount) * sizeof(Activity));
+	TreeNode root = NULL;
+	if (merged != NULL) {
+		Activity* existing = merged + importedCount;
+		int mergedCount = 0;
+		collectTreeActivities(container->avlTree, existing, &mergedCount);
+		
+		int e = 0;
+		int n = 0;
+		mergedCount = 0;
+		while (e < existingCount || n < importedCount) {
+			if (n == importedCount || (e < existingCount && getActivityId(existing[e]) < getActivityId(imported[n]))) {
+				merged[mergedCount++] = existing[e++];
+			} else {
+				merged[mergedCount++] = imported[n++];
+			}
+		}
+		root = buildTreeFromSortedActivities(merged, mergedCount);
+	}
+	
+	if (root == NULL) {
+		for (int i = 0; i < importedCount; i++) insertActivity(container, imported[i]);
+	} else {
+		freeSubtreeNodes(container->avlTree);
+		container->avlTree = root;
+		container->version += importedCount;
+		for (int i = 0; i < importedCount; i++) {
+			setActivityChangeObserver(imported[i], onContainedActivityChange, container);
+			addActivityToSortedViews(container, imported[i]);
+			if (container->journal != NULL) appendInsertToActivityJournal(container->journal, imported[i]);
+		}
+	}
+	if (importedCount > 0) container->nextId = (int)nextId;
+	
+	free(merged);
+	free(imported);
+	return importedCount;
+}
+
+
+/*
+ * importActivitiesFromFile
+ * 
+ * Syntactic Specification:
+ * int importActivitiesFromFile(ActivitiesContainer container, const char* filename, int format,
+ *                              ActivityImportMapping mapping, int* count);
+ * 
+ * Semantic Specification:
+ * Imports into the container the activities of a CSV (ACTIVITY_IMPORT_CSV) or JSON Lines
+ * (ACTIVITY_IMPORT_JSONL) file, e.g. an export or a spreadsheet. The file is read record after record
+ * and every row is validated (see 'readImportedActivities()'); the columns are found through the mapping,
+ * by default the names of the export. The rows with an id keep it (unless it's already in the container),
+ * the rows without one take a new id from 'nextId' on. The valid activities are inserted all together
+ * with a single rebuild of the tree (see 'insertImportedActivities()').
+ * 
+ * Preconditions:
+ * - 'count != NULL'
+ * 
+ * Postconditions:
+ * - If 'container', 'filename' or 'mapping' is NULL, or the file can't be read, returns 1 (error) and
+ *   the container is unchanged
+ * - Otherwise, inserts the valid activities, sets '*count' to their number and returns 0 (success)
+ * 
+ * Side Effects:
+ * - Modifies the container
+ * - File opening and reading
+ * - Writing to the journal file (if the container has a journal)
+ * - Output to stdout (rejected rows and summary)
+ */
+int importActivitiesFromFile(ActivitiesContainer container, const char* filename, int format,
+                             ActivityImportMapping mapping, int* count) {
+	*count = 0;
+	if (container == NULL || filename == NULL || mapping == NULL) return 1;
+	
+	Activity* activities = NULL;
+	int readCount = 0;
+	int rejectedCount = 0;
+	if (readImportedActivities(filename, format, mapping, time(NULL), &activities, &readCount, &rejectedCount) != 0) {
+		printf("Errore nell'importazione delle attività dal file %s.\n", filename);
+		return 1;
+	}
+	
+	int skippedCount = 0;
+	*count = insertImportedActivities(container, activities, readCount, &skippedCount);
+	free(activities);
+	
+	printf("Importate %d attività dal file %s.\n", *count, filename);
+	if (rejectedCount > 0) printf("Righe scartate perché non valide: %d.\n", rejectedCount);
+	if (skippedCount > 0) printf("Attività ignorate perché con un id già presente: %d.\n", skippedCount);
+	return 0;
+}
+
+
+
 /*
  * addNewActivityToContainer
  * 
@@ -3,12 +3,27 @@
 
 #include "activity.h"
 #include "activities_container_avl.h"
+#include "activities_container_bitmap.h"
+#include "activities_container_import.h"
 
 /* Declare an opaque type for the activities container.
  * Used in the program (main) to masks the underlying structure (tree). 
  */
 typedef struct containerItem* ActivitiesContainer;
 
+#define DEFAULT_DAILY_CAPACITY 240 // Default working minutes per day for the "rischio" view
+
+// Formats of the files of activities (see 'saveActivitiesAndCompactJournal()')
+#define ACTIVITIES_FORMAT_TEXT 0 // Text, 10 lines per activity (see 'saveActivitiesToFile()')
+#define ACTIVITIES_FORMAT_BINARY 1 // Binary snapshot (see 'saveActivitiesToBinaryFile()')
+#define ACTIVITIES_FORMAT_ARCHIVE 2 // Compact archive (see 'saveActivitiesToArchiveFile()')
+#define ACTIVITIES_FORMAT_STORE 3 // Slotted store, updated in place (see 'saveActivitiesToStoreFile()')
+#define ACTIVITIES_FORMAT_SHARDS 4 // Directory of shards by id range (see 'saveActivitiesToShardsDirectory()')
+#define ACTIVITIES_FORMAT_MAPPED 5 // Mapped store, used in place (see 'saveActivitiesToMapFile()')
+
+// Condition on an activity used to build a result set (returns non-zero if the activity is selected)
+typedef int (*ActivityFilter)(Activity a, void* context);
+
 
 
 
@@ -33,6 +48,27 @@ typedef struct containerItem* ActivitiesContainer;
  */
 int getNextId(ActivitiesContainer container);
 
+/*
+ * hasActivityContainerTree
+ * 
+ * Syntactic Specification:
+ * int hasActivityContainerTree(ActivitiesContainer container);
+ * 
+ * Semantic Specification:
+ * Tells whether the activities of the container are in its tree, or still only in the mapped store it
+ * has been read from (see 'readActivitiesFromMapFile()'). The tree is not built by this call.
+ * 
+ * Preconditions:
+ * - None
+ * 
+ * Postconditions:
+ * - Returns 0 if 'container == NULL' or its activities are still only in its mapped store, 1 otherwise
+ * 
+ * Side Effects:
+ * - None
+ */
+int hasActivityContainerTree(ActivitiesContainer container);
+
 /*
  * newActivityContainer
  * 
@@ -91,12 +127,15 @@ Activity getActivityWithId(ActivitiesContainer container, int activityId);
  * - If 'container == NULL', creates a new container
  * - If the activity ID is 0, generates a new unique ID
  * - Inserts the activity into the container
- * - Updates the container's 'nextId'
+ * - Updates the container's 'nextId' and 'version'
+ * - An activity whose id is already in the container is not inserted (and not observed by the container)
+ * - The inserted activity has the container as change observer and is added to its sorted views
  * 
  * Side Effects:
  * - May allocate memory for the container
  * - Modifies the activity ID if it was 0
  * - Modifies the AVL tree structure
+ * - Writing to the journal file (if the container has a journal)
  */
 void insertActivity(ActivitiesContainer container, Activity activity);
 
@@ -115,7 +154,7 @@ void insertActivity(ActivitiesContainer container, Activity activity);
  * 
  * Postconditions:
  * - If 'container == NULL' or 'container->avlTree == NULL', no action
- * - Otherwise, removes the activity with the specified ID
+ * - Otherwise, removes the activity with the specified ID and updates the container's 'version'
  * 
  * Side Effects:
  * - Modifies the container's AVL tree structure
@@ -141,7 +180,7 @@ void removeActivity(ActivitiesContainer container, int activityId);
  * - Otherwise, deallocates the entire container and its activities
  * 
  * Side Effects:
- * - Deallocates all container memory
+ * - Deallocates all container memory (cached renderings included)
  */
 void deleteActivityContainer(ActivitiesContainer container);
 
@@ -169,6 +208,362 @@ void deleteActivityContainer(ActivitiesContainer container);
 int saveActivitiesToFile(const char* filename, ActivitiesContainer container);
 
 
+/*
+ * saveActivitiesToBinaryFile
+ * 
+ * Syntactic Specification:
+ * int saveActivitiesToBinaryFile(const char* filename, ActivitiesContainer container);
+ * 
+ * Semantic Specification:
+ * Saves all activities from the container to a file in the binary snapshot format (see
+ * 'writeActivitiesSnapshot()'): a header and fixed width columns, read back by
+ * 'readActivitiesFromBinaryFile()' with a few large reads. The text format remains the
+ * interchange format, the binary one is the fast path for large archives.
+ * As for the text format, the file is replaced only when the new one is completely written
+ * (see 'commitActivityWriter()'), and a checksum file is written next to it.
+ * 
+ * Preconditions:
+ * - None
+ * 
+ * Postconditions:
+ * - If 'container == NULL' or 'filename == NULL', returns 1 (error)
+ * - If unable to open or write the file, returns 1 (error): the file keeps its previous content
+ * - Otherwise, saves all activities and returns 0 (success)
+ * 
+ * Side Effects:
+ * - File opening and writing
+ * - Output to stdout (informational messages)
+ */
+int saveActivitiesToBinaryFile(const char* filename, ActivitiesContainer container);
+
+
+/*
+ * saveActivitiesToArchiveFile
+ * 
+ * Syntactic Specification:
+ * int saveActivitiesToArchiveFile(const char* filename, ActivitiesContainer container);
+ * 
+ * Semantic Specification:
+ * Saves all activities from the container to a file in the compact archive format (see
+ * 'writeActivitiesArchive()'): ids and dates as varint differences, courses through a dictionary.
+ * It's the smallest format, for the archives that are kept and rarely read: a smaller file is read
+ * from the disk faster and takes less page cache. Read back by 'readActivitiesFromArchiveFile()'.
+ * As for the other formats, the file is replaced only when the new one is completely written
+ * (see 'commitActivityWriter()'), and a checksum file is written next to it.
+ * 
+ * Preconditions:
+ * - None
+ * 
+ * Postconditions:
+ * - If 'container == NULL' or 'filename == NULL', returns 1 (error)
+ * - If unable to open or write the file, returns 1 (error): the file keeps its previous content
+ * - Otherwise, saves all activities and returns 0 (success)
+ * 
+ * Side Effects:
+ * - File opening and writing
+ * - Output to stdout (informational messages)
+ */
+int saveActivitiesToArchiveFile(const char* filename, ActivitiesContainer container);
+
+/*
+ * saveActivitiesToStoreFile
+ * 
+ * Syntactic Specification:
+ * int saveActivitiesToStoreFile(const char* filename, ActivitiesContainer container);
+ * 
+ * Semantic Specification:
+ * Saves all activities from the container to a file in the slotted store format (see 'writeActivitiesStore()'),
+ * the format for large files saved often: if the container has read or last saved the same store file, only
+ * the records of the activities modified, inserted or removed since then are written (see
+ * 'updateActivitiesStore()'), so a save after a few modifications writes a few slots instead of the whole file.
+ * Otherwise (first save, other file, file changed by someone else, too many tombstones) the file is written
+ * again completely, compacted, and bound to the container. Read back by 'readActivitiesFromStoreFile()'.
+ * The sharded directory and the mapped store of the container (if any) are released (see
+ * 'saveActivitiesToShardsDirectory()').
+ * 
+ * Preconditions:
+ * - None
+ * 
+ * Postconditions:
+ * - If 'container == NULL' or 'filename == NULL', returns 1 (error)
+ * - If unable to write the file, returns 1 (error): the next save writes the file again completely
+ * - Otherwise, saves all activities and returns 0 (success)
+ * 
+ * Side Effects:
+ * - File opening and writing
+ * - Modifies the slotted store, the sharded directory and the mapped store of the container
+ * - Output to stdout (informational messages)
+ */
+int saveActivitiesToStoreFile(const char* filename, ActivitiesContainer container);
+
+/*
+ * saveActivitiesToShardsDirectory
+ * 
+ * Syntactic Specification:
+ * int saveActivitiesToShardsDirectory(const char* directory, ActivitiesContainer container);
+ * 
+ * Semantic Specification:
+ * Saves all activities from the container to a sharded directory (see 'writeActivityShards()'): a binary
+ * snapshot per range of ACTIVITY_SHARD_ID_RANGE ids and a small manifest. If the container has read or last
+ * saved the same directory, only the shards with an activity modified, inserted or removed since then are
+ * written, so the cost of a save follows the modifications and not the size of the container. Otherwise
+ * every shard is written and the directory is bound to the container. Read back by
+ * 'readActivitiesFromShardsDirectory()'. The dirty activities are tracked for one file at a time: the
+ * slotted store and the mapped store of the container (if any) are released and the next save to them
+ * writes them again completely.
+ * 
+ * Preconditions:
+ * - None
+ * 
+ * Postconditions:
+ * - If 'container == NULL' or 'directory == NULL', returns 1 (error)
+ * - If unable to write the directory, returns 1 (error): the next save writes every shard
+ * - Otherwise, saves all activities and returns 0 (success)
+ * 
+ * Side Effects:
+ * - Creation of the directory, writing and removal of files
+ * - Modifies the sharded directory, the slotted store and the mapped store of the container
+ * - Output to stdout (informational messages)
+ */
+int saveActivitiesToShardsDirectory(const char* directory, ActivitiesContainer container);
+
+/*
+ * saveActivitiesToMapFile
+ * 
+ * Syntactic Specification:
+ * int saveActivitiesToMapFile(const char* filename, ActivitiesContainer container);
+ * 
+ * Semantic Specification:
+ * Saves all activities from the container to a mapped store (see 'writeActivityMap()'), the format for
+ * files opened by many short runs: it's used in place through a memory mapping, so opening it doesn't
+ * depend on its size (see 'openActivityMap()'). If the container has read or last saved the same file,
+ * only the activities modified, inserted or removed since then are written, appended as new nodes of its
+ * tree (see 'updateActivityMap()'). Otherwise (first save, other file, file changed by someone else, too
+ * many unreachable bytes) the file is written again completely, compacted, and bound to the container.
+ * Read back by 'readActivitiesFromMapFile()'. The slotted store and the sharded directory of the container
+ * (if any) are released.
+ * 
+ * Preconditions:
+ * - None
+ * 
+ * Postconditions:
+ * - If 'container == NULL' or 'filename == NULL', returns 1 (error)
+ * - If unable to write the file, returns 1 (error): the next save writes the file again completely
+ * - Otherwise, saves all activities and returns 0 (success)
+ * 
+ * Side Effects:
+ * - File opening, writing and memory mapping
+ * - Modifies the mapped store, the slotted store and the sharded directory of the container
+ * - Output to stdout (informational messages)
+ */
+int saveActivitiesToMapFile(const char* filename, ActivitiesContainer container);
+
+
+/*
+ * exportActivitiesToCsv
+ * 
+ * Syntactic Specification:
+ * int exportActivitiesToCsv(const char* filename, ActivitiesContainer container);
+ * 
+ * Semantic Specification:
+ * Exports all activities from the container, in id order, to a CSV file (see 'writeActivitiesCsv()'):
+ * unlike the listings, every field is complete and the strings are escaped, so the file can be read
+ * back by any CSV reader with no loss.
+ * The export is written through a buffered writer (see 'newActivityWriter()'), record after record in
+ * its buffer, so it doesn't take more memory with more activities, and replaces the file only when complete.
+ * The activities of a container still only in its mapped store are exported from the store, without
+ * building the tree (see 'readActivitiesFromMapFile()').
+ * 
+ * Preconditions:
+ * - None
+ * 
+ * Postconditions:
+ * - If 'container == NULL' or 'filename == NULL', returns 1 (error)
+ * - If unable to open or write the file, returns 1 (error): the file keeps its previous content
+ * - Otherwise, exports all activities and returns 0 (success)
+ * 
+ * Side Effects:
+ * - File opening and writing
+ * - Output to stdout (informational messages)
+ */
+int exportActivitiesToCsv(const char* filename, ActivitiesContainer container);
+
+
+/*
+ * exportActivitiesToJsonl
+ * 
+ * Syntactic Specification:
+ * int exportActivitiesToJsonl(const char* filename, ActivitiesContainer container);
+ * 
+ * Semantic Specification:
+ * Exports all activities from the container, in id order, to a JSON Lines file, one object per activity
+ * (see 'writeActivitiesJsonl()'), with every field complete and escaped.
+ * The export is written through a buffered writer (see 'newActivityWriter()'), record after record in
+ * its buffer, so it doesn't take more memory with more activities, and replaces the file only when complete.
+ * The activities of a container still only in its mapped store are exported from the store, without
+ * building the tree (see 'readActivitiesFromMapFile()').
+ * 
+ * Preconditions:
+ * - None
+ * 
+ * Postconditions:
+ * - If 'container == NULL' or 'filename == NULL', returns 1 (error)
+ * - If unable to open or write the file, returns 1 (error): the file keeps its previous content
+ * - Otherwise, exports all activities and returns 0 (success)
+ * 
+ * Side Effects:
+ * - File opening and writing
+ * - Output to stdout (informational messages)
+ */
+int exportActivitiesToJsonl(const char* filename, ActivitiesContainer container);
+
+/*
+ * exportActivitiesFromMapFile
+ * 
+ * Syntactic Specification:
+ * int exportActivitiesFromMapFile(const char* mapFilename, const char* filename, int asJsonl);
+ * 
+ * Semantic Specification:
+ * Exports all activities of a mapped store (see 'saveActivitiesToMapFile()'), in id order, to a CSV file
+ * (see 'exportActivitiesToCsv()') or, if 'asJsonl' is not 0, to a JSON Lines file (see
+ * 'exportActivitiesToJsonl()'), without reading them into a container: the store is mapped and its tree
+ * visited, one activity at a time (see 'visitActivityMap()'), so a script exporting a large store neither
+ * parses it nor builds a tree. If the journal of the store holds modifications not yet saved to it, the
+ * store is read into a container and the journal replayed before exporting (see 'exportActivitiesWithJournal()').
+ * 
+ * Preconditions:
+ * - None
+ * 
+ * Postconditions:
+ * - If 'mapFilename == NULL' or 'filename == NULL', returns 1 (error)
+ * - If the mapped store can't be opened or is not valid, or the file can't be written, returns 1 (error):
+ *   the file keeps its previous content
+ * - Otherwise, exports all activities and returns 0 (success)
+ * 
+ * Side Effects:
+ * - File opening, reading (through a memory mapping) and writing
+ * - Output to stdout (informational messages)
+ */
+int exportActivitiesFromMapFile(const char* mapFilename, const char* filename, int asJsonl);
+
+/*
+ * exportActivitiesWithJournal
+ * 
+ * Syntactic Specification:
+ * int exportActivitiesWithJournal(const char* baseFilename, ActivitiesContainer container, const char* filename, int asJsonl);
+ * 
+ * Semantic Specification:
+ * Exports all activities of a container just loaded from 'baseFilename' to a CSV file (see
+ * 'exportActivitiesToCsv()') or, if 'asJsonl' is not 0, to a JSON Lines file (see 'exportActivitiesToJsonl()'),
+ * after replaying the modifications recorded in the journal of the base file (see 'replayActivityJournal()'),
+ * so the export holds the same activities the program would show. The journal is only read: no journal is
+ * attached to the container.
+ * 
+ * Preconditions:
+ * - The container has just been loaded from 'baseFilename' (if a journal is already attached, its
+ *   modifications are already in the container and nothing is replayed)
+ * 
+ * Postconditions:
+ * - If 'baseFilename == NULL', 'container == NULL' or 'filename == NULL', returns 1 (error)
+ * - If the journal can't be replayed or the file can't be written, returns 1 (error)
+ * - Otherwise, exports all activities and returns 0 (success)
+ * 
+ * Side Effects:
+ * - Modifies the container (replayed modifications)
+ * - File opening, reading and writing
+ * - Output to stdout (informational messages)
+ */
+int exportActivitiesWithJournal(const char* baseFilename, ActivitiesContainer container, const char* filename, int asJsonl);
+
+
+/*
+ * openActivitiesJournal
+ * 
+ * Syntactic Specification:
+ * int openActivitiesJournal(ActivitiesContainer container, const char* baseFilename);
+ * 
+ * Semantic Specification:
+ * Attaches to the container the journal of the base file it has been loaded from: first the
+ * modifications recorded after the last save of the base file are replayed (see 'replayActivityJournal()'),
+ * then every insert, removal and field update is appended to the journal when it happens. Recording a
+ * modification costs one small write, whatever the number of activities, instead of saving the whole file.
+ * 
+ * Preconditions:
+ * - The container has just been loaded from 'baseFilename'
+ * 
+ * Postconditions:
+ * - If 'container == NULL' or 'baseFilename == NULL', returns 1 (error)
+ * - If the journal can't be replayed or opened, returns 1 (error): the modifications are not journaled
+ * - Otherwise, returns 0 (success)
+ * 
+ * Side Effects:
+ * - Modifies the container (replayed modifications)
+ * - File opening, reading and writing
+ * - Output to stdout (informational messages)
+ */
+int openActivitiesJournal(ActivitiesContainer container, const char* baseFilename);
+
+
+/*
+ * saveActivitiesAndCompactJournal
+ * 
+ * Syntactic Specification:
+ * int saveActivitiesAndCompactJournal(const char* filename, ActivitiesContainer container, int format);
+ * 
+ * Semantic Specification:
+ * Saves all activities from the container to a file in the given format: ACTIVITIES_FORMAT_BINARY (see
+ * 'saveActivitiesToBinaryFile()'), ACTIVITIES_FORMAT_ARCHIVE (see 'saveActivitiesToArchiveFile()'),
+ * ACTIVITIES_FORMAT_STORE (see 'saveActivitiesToStoreFile()'), ACTIVITIES_FORMAT_SHARDS (see
+ * 'saveActivitiesToShardsDirectory()', 'filename' is the directory), ACTIVITIES_FORMAT_MAPPED (see
+ * 'saveActivitiesToMapFile()') or ACTIVITIES_FORMAT_TEXT, the default
+ * (see 'saveActivitiesToFile()').
+ * If the file is the base file of the journal of the container, the journal is compacted: its records
+ * are now in the base file, so it's truncated. The base file is written completely before the journal is
+ * truncated: if the program stops in between, replaying the journal on the new base file has no effect.
+ * 
+ * Preconditions:
+ * - None
+ * 
+ * Postconditions:
+ * - If 'container == NULL' or 'filename == NULL', returns 1 (error)
+ * - If unable to write the file or to truncate the journal, returns 1 (error)
+ * - Otherwise, saves all activities and returns 0 (success)
+ * 
+ * Side Effects:
+ * - File opening and writing, truncation of the journal file
+ * - Output to stdout (informational messages)
+ */
+int saveActivitiesAndCompactJournal(const char* filename, ActivitiesContainer container, int format);
+
+
+/*
+ * verifyActivitiesFile
+ * 
+ * Syntactic Specification:
+ * int verifyActivitiesFile(const char* filename, int format);
+ * 
+ * Semantic Specification:
+ * Checks the integrity of a saved file of activities without reading them into a container: every
+ * block of the file must have the CRC32C recorded in its checksum file when it was saved (see
+ * 'verifyActivityChecksums()'). For ACTIVITIES_FORMAT_SHARDS 'filename' is the directory, whose
+ * manifest and shards are all checked (see 'verifyActivityShards()'). The damaged blocks are
+ * reported with their bytes.
+ * 
+ * Preconditions:
+ * - None
+ * 
+ * Postconditions:
+ * - Returns 0 if the file is intact
+ * - Returns 1 if it's damaged, can't be read or has no valid checksum file (e.g. an export, or a file
+ *   saved by a previous version), or if 'filename == NULL'
+ * 
+ * Side Effects:
+ * - File reading
+ * - Output to stdout (informational messages)
+ */
+int verifyActivitiesFile(const char* filename, int format);
+
+
 /*
  * printActivityWithId
  * 
@@ -209,6 +604,7 @@ void printActivityWithId(ActivitiesContainer container, int activityId);
  * 
  * Side Effects:
  * - Output to stdout
+ * - The rendering is cached until the container is modified
  */
 void printActivities(ActivitiesContainer container);
 
@@ -234,6 +630,58 @@ void printActivities(ActivitiesContainer container);
 void printActivitiesToFile(ActivitiesContainer container, FILE* file);
 
 
+/*
+ * printActivitiesSorted
+ * 
+ * Syntactic Specification:
+ * void printActivitiesSorted(ActivitiesContainer container, int sortBy);
+ * 
+ * Semantic Specification:
+ * Prints all activities (list format, one per line, with headers) from the container ordered by the
+ * criterion 'sortBy' of 'compareActivityBy()' and then by ID. The order is read from the sorted view
+ * of the criterion, built at the first request and then kept up to date by inserts, removals and
+ * activity field updates: printing again costs no sorting.
+ * 
+ * Preconditions:
+ * - 'sortBy' should be a valid criterion (0-12); other values mean 0 (ID)
+ * 
+ * Postconditions:
+ * - If 'container != NULL' and not empty, prints all activities with headers
+ * - If the view can't be built (memory allocation), prints an error message
+ * 
+ * Side Effects:
+ * - Output to stdout
+ * - May allocate the sorted view of the criterion (kept until the container is deleted)
+ */
+void printActivitiesSorted(ActivitiesContainer container, int sortBy);
+
+
+/*
+ * printActivitiesSortedToFile
+ * 
+ * Syntactic Specification:
+ * int printActivitiesSortedToFile(ActivitiesContainer container, int sortBy, FILE* file);
+ * 
+ * Semantic Specification:
+ * Prints all container activities to file (list format, one per line) ordered by the criterion
+ * 'sortBy' of 'compareActivityBy()' and then by ID, reading the order from the sorted view of the
+ * criterion (see 'printActivitiesSorted()').
+ * 
+ * Preconditions:
+ * - 'file' must be opened for writing
+ * - 'sortBy' should be a valid criterion (0-12); other values mean 0 (ID)
+ * 
+ * Postconditions:
+ * - Returns 0 if the activities have been printed
+ * - Returns 1 if 'container == NULL', 'file == NULL' or the view can't be built (nothing is printed)
+ * 
+ * Side Effects:
+ * - Writing to file
+ * - May allocate the sorted view of the criterion (kept until the container is deleted)
+ */
+int printActivitiesSortedToFile(ActivitiesContainer container, int sortBy, FILE* file);
+
+
 /*
  * printActivitiesProgress
  * 
@@ -251,6 +699,7 @@ void printActivitiesToFile(ActivitiesContainer container, FILE* file);
  * 
  * Side Effects:
  * - Output to stdout
+ * - The rendering is cached until the container is modified
  */
 void printActivitiesProgress(ActivitiesContainer container);
 
@@ -293,10 +742,11 @@ void printActivitiesProgressToFile(ActivitiesContainer container, FILE* file);
  * - Interacts with user to define the report period
  * 
  * Side Effects:
- * - Allocates and deallocates temporary support lists
+ * - Allocates and deallocates temporary support vectors
  * - User interaction (input/output)
  * - Output to stdout
  * - Calls to time management functions
+ * - The rendering is cached until the container is modified or the dates move an activity to another category
  */
 void printActivitiesReport(ActivitiesContainer container);
 
@@ -318,12 +768,179 @@ void printActivitiesReport(ActivitiesContainer container);
  * - If all parameters are valid, prints the report to file
  * 
  * Side Effects:
- * - Allocates and deallocates temporary support lists
+ * - Allocates and deallocates temporary support vectors
  * - Writing to file
  */
 void printActivitiesReportToFile(ActivitiesContainer container, time_t beginDate, FILE* file);
 
 
+/*
+ * printActivitiesBurndownToFile
+ * 
+ * Syntactic Specification:
+ * int printActivitiesBurndownToFile(ActivitiesContainer container, time_t fromDate, time_t toDate, FILE* file);
+ * 
+ * Semantic Specification:
+ * Writes to file the burndown time series (CSV, one row per calendar day from 'fromDate' to 'toDate')
+ * with completed activities, open activities and remaining minutes.
+ * 
+ * Preconditions:
+ * - 'file' must be opened for writing
+ * - 'fromDate <= toDate'
+ * 
+ * Postconditions:
+ * - If 'container == NULL' or the parameters are not valid, returns 1 (error)
+ * - Otherwise writes the time series and returns 0 (success)
+ * 
+ * Side Effects:
+ * - Allocates and deallocates temporary arrays
+ * - Writing to file
+ */
+int printActivitiesBurndownToFile(ActivitiesContainer container, time_t fromDate, time_t toDate, FILE* file);
+
+
+/*
+ * saveActivitiesBurndownToFile
+ * 
+ * Syntactic Specification:
+ * int saveActivitiesBurndownToFile(const char* filename, ActivitiesContainer container, time_t fromDate, time_t toDate);
+ * 
+ * Semantic Specification:
+ * Saves the burndown time series (CSV) of the activities to a file.
+ * 
+ * Preconditions:
+ * - 'fromDate <= toDate'
+ * 
+ * Postconditions:
+ * - If 'container == NULL' or 'filename == NULL', returns 1 (error)
+ * - If unable to open the file, returns 1 (error)
+ * - Otherwise, saves the time series and returns 0 (success)
+ * 
+ * Side Effects:
+ * - File opening and writing
+ * - Output to stdout (informational messages)
+ */
+int saveActivitiesBurndownToFile(const char* filename, ActivitiesContainer container, time_t fromDate, time_t toDate);
+
+
+/*
+ * printActivitiesRiskToFile
+ * 
+ * Syntactic Specification:
+ * int printActivitiesRiskToFile(ActivitiesContainer container, time_t nowDate, unsigned int dailyCapacity, FILE* file);
+ * 
+ * Semantic Specification:
+ * Prints to file the "rischio" view: the activities whose remaining minutes (totalTime - usedTime)
+ * exceed the working minutes left before their expiry date, given 'dailyCapacity' working minutes
+ * per day. Activities are sorted by slack (working minutes left - remaining minutes), most critical first.
+ * 
+ * Preconditions:
+ * - 'file' must be opened for writing
+ * - 'dailyCapacity' in minutes (0-1440)
+ * 
+ * Postconditions:
+ * - If 'container == NULL' or 'file == NULL', returns 0 and prints nothing
+ * - Otherwise prints the view and returns the number of activities at risk
+ * 
+ * Side Effects:
+ * - Writing to file
+ * - Reloads the packed columns from the tree if the container has been modified since the last view
+ */
+int printActivitiesRiskToFile(ActivitiesContainer container, time_t nowDate, unsigned int dailyCapacity, FILE* file);
+
+
+/*
+ * printActivitiesRisk
+ * 
+ * Syntactic Specification:
+ * void printActivitiesRisk(ActivitiesContainer container, unsigned int dailyCapacity);
+ * 
+ * Semantic Specification:
+ * Prints to stdout the "rischio" view at the current date (see 'printActivitiesRiskToFile()').
+ * 
+ * Preconditions:
+ * - 'dailyCapacity' in minutes (0-1440)
+ * 
+ * Postconditions:
+ * - If 'container == NULL', no action
+ * - Otherwise the activities at risk are printed
+ * 
+ * Side Effects:
+ * - Output to stdout
+ */
+void printActivitiesRisk(ActivitiesContainer container, unsigned int dailyCapacity);
+
+
+/*
+ * getActivitiesBitmapWhere
+ *
+ * Syntactic Specification:
+ * ActivityBitmap getActivitiesBitmapWhere(ActivitiesContainer container, ActivityFilter filter, void* context);
+ *
+ * Semantic Specification:
+ * Returns the set of the ids of the activities for which 'filter(activity, context)' is non-zero
+ * (all the activities if 'filter' is NULL). The result sets of several filters can then be combined
+ * with 'andActivityBitmaps()', 'orActivityBitmaps()' and 'andNotActivityBitmaps()' and visited with
+ * 'getNextActivityInBitmap()'.
+ *
+ * Preconditions:
+ * - 'container != NULL'
+ *
+ * Postconditions:
+ * - Returns the new set (to be deallocated with 'deleteActivityBitmap()')
+ * - Returns 'NULL' if 'container == NULL' or memory allocation fails
+ *
+ * Side Effects:
+ * - Allocates memory
+ */
+ActivityBitmap getActivitiesBitmapWhere(ActivitiesContainer container, ActivityFilter filter, void* context);
+
+
+/*
+ * getNextActivityInBitmap
+ *
+ * Syntactic Specification:
+ * Activity getNextActivityInBitmap(ActivitiesContainer container, ActivityBitmap bitmap, int* cursor);
+ *
+ * Semantic Specification:
+ * Iterates over the activities of the container whose ids are in the set, in increasing id order.
+ * '*cursor' must be 0 before the first call; each call returns the next activity and advances it.
+ * Ids of activities no longer in the container are skipped.
+ *
+ * Preconditions:
+ * - 'cursor != NULL'
+ *
+ * Postconditions:
+ * - Returns the next activity, or NULL when there are no more activities (or a parameter is NULL)
+ *
+ * Side Effects:
+ * - Modifies '*cursor'
+ */
+Activity getNextActivityInBitmap(ActivitiesContainer container, ActivityBitmap bitmap, int* cursor);
+
+
+/*
+ * printActivitiesInBitmapToFile
+ *
+ * Syntactic Specification:
+ * void printActivitiesInBitmapToFile(ActivitiesContainer container, ActivityBitmap bitmap, FILE* file);
+ *
+ * Semantic Specification:
+ * Prints the activities of the container whose ids are in the set (list format, one per line, in
+ * increasing id order) to file (to screen if 'file' is NULL).
+ *
+ * Preconditions:
+ * - 'file' can be NULL (screen) or a file opened for writing
+ *
+ * Postconditions:
+ * - If 'container' or 'bitmap' are NULL, nothing is printed
+ *
+ * Side Effects:
+ * - Output to stdout or writing to file
+ */
+void printActivitiesInBitmapToFile(ActivitiesContainer container, ActivityBitmap bitmap, FILE* file);
+
+
 
 /*
  * readActivitiesFromFile
@@ -333,6 +950,10 @@ void printActivitiesReportToFile(ActivitiesContainer container, time_t beginDate
  * 
  * Semantic Specification:
  * Reads activities from a file and inserts them into a new container.
+ * A regular file is read through a memory mapping (see 'readActivitiesFromMappedFile()'), otherwise
+ * record by record with 'readActivityFromFile()': the result is the same. A large file is parsed on
+ * several threads (see 'readActivitiesFromMappedFileInParallel()') and the tree is built at once
+ * (see 'insertSortedActivities()'), again with the same result.
  * 
  * Preconditions:
  * - 'count != NULL'
@@ -347,9 +968,242 @@ void printActivitiesReportToFile(ActivitiesContainer container, time_t beginDate
  * - Modifies '*count' (number of activities read)
  * - File opening and reading
  * - Output to stdout (informational messages)
+ * - May create and join threads
  */
 ActivitiesContainer readActivitiesFromFile(const char* filename, int* count);
 
+/*
+ * readActivitiesFromFileWithLazyDescr
+ * 
+ * Syntactic Specification:
+ * ActivitiesContainer readActivitiesFromFileWithLazyDescr(const char* filename, int* count);
+ * 
+ * Semantic Specification:
+ * Reads activities from a file as 'readActivitiesFromFile()', but leaves the descriptions in the file:
+ * every activity keeps only the position and the length of its description, read from the file
+ * (with 'pread()') the first time it's needed (see 'setActivityLazyDescr()'). The descriptions that are
+ * never shown, searched or sorted don't take memory. The file stays open until the last description is
+ * read (or its activity deleted), so a save that replaces it doesn't change the descriptions still to read.
+ * A file that can't be mapped (e.g. not a regular file) is read with its descriptions.
+ * 
+ * Preconditions:
+ * - 'count != NULL'
+ * 
+ * Postconditions:
+ * - Creates a new container
+ * - If the file doesn't exist, returns an empty container and '*count = 0'
+ * - Otherwise, reads all activities from the file and updates '*count' (number of activities read)
+ * 
+ * Side Effects:
+ * - Allocates memory for the container and activities
+ * - Modifies '*count' (number of activities read)
+ * - File opening and reading
+ * - Output to stdout (informational messages)
+ * - May create and join threads
+ * - The file may stay open while some descriptions are not read
+ */
+ActivitiesContainer readActivitiesFromFileWithLazyDescr(const char* filename, int* count);
+
+
+/*
+ * readActivitiesFromFileInParallel
+ * 
+ * Syntactic Specification:
+ * ActivitiesContainer readActivitiesFromFileInParallel(const char* filename, int threadCount, size_t minChunkSize, int* count);
+ * 
+ * Semantic Specification:
+ * Reads activities from a file as 'readActivitiesFromFile()', choosing how the file is parsed in parallel
+ * (see 'readActivitiesFromMappedFileInParallel()'): on 'threadCount' threads (one per online processor if
+ * it's 0), each one reading at least 'minChunkSize' bytes (PARALLEL_LOAD_MIN_CHUNK_SIZE if it's 0). With
+ * less than 2 threads the file is read sequentially. The result doesn't depend on the choice.
+ * 
+ * Preconditions:
+ * - 'count != NULL'
+ * 
+ * Postconditions:
+ * - The same of 'readActivitiesFromFile()'
+ * 
+ * Side Effects:
+ * - The same of 'readActivitiesFromFile()'
+ */
+ActivitiesContainer readActivitiesFromFileInParallel(const char* filename, int threadCount, size_t minChunkSize, int* count);
+
+
+/*
+ * readActivitiesFromBinaryFile
+ * 
+ * Syntactic Specification:
+ * ActivitiesContainer readActivitiesFromBinaryFile(const char* filename, int* count);
+ * 
+ * Semantic Specification:
+ * Reads activities from a file in the binary snapshot format (see 'saveActivitiesToBinaryFile()')
+ * and inserts them into a new container. Since a snapshot has the activities in id order, the
+ * tree is built at once in O(n) instead of inserting the activities one by one.
+ * 
+ * Preconditions:
+ * - 'count != NULL'
+ * 
+ * Postconditions:
+ * - Creates a new container
+ * - If the file doesn't exist or is not a valid snapshot, returns an empty container and '*count = 0'
+ * - Otherwise, reads all activities from the file and updates '*count' (number of activities read)
+ * 
+ * Side Effects:
+ * - Allocates memory for the container and activities
+ * - Modifies '*count' (number of activities read)
+ * - File opening and reading
+ * - Output to stdout (informational messages)
+ */
+ActivitiesContainer readActivitiesFromBinaryFile(const char* filename, int* count);
+
+
+/*
+ * readActivitiesFromArchiveFile
+ * 
+ * Syntactic Specification:
+ * ActivitiesContainer readActivitiesFromArchiveFile(const char* filename, int* count);
+ * 
+ * Semantic Specification:
+ * Reads activities from a file in the compact archive format (see 'saveActivitiesToArchiveFile()')
+ * and inserts them into a new container. As for a binary snapshot, the activities are in id order
+ * and the tree is built at once.
+ * 
+ * Preconditions:
+ * - 'count != NULL'
+ * 
+ * Postconditions:
+ * - Creates a new container
+ * - If the file doesn't exist or is not a valid archive, returns an empty container and '*count = 0'
+ * - Otherwise, reads all activities from the file and updates '*count' (number of activities read)
+ * 
+ * Side Effects:
+ * - Allocates memory for the container and activities
+ * - Modifies '*count' (number of activities read)
+ * - File opening and reading
+ * - Output to stdout (informational messages)
+ */
+ActivitiesContainer readActivitiesFromArchiveFile(const char* filename, int* count);
+
+/*
+ * readActivitiesFromStoreFile
+ * 
+ * Syntactic Specification:
+ * ActivitiesContainer readActivitiesFromStoreFile(const char* filename, int* count);
+ * 
+ * Semantic Specification:
+ * Reads activities from a file in the slotted store format (see 'saveActivitiesToStoreFile()') and inserts
+ * them into a new container, bound to the file: the next slotted save to the same file only writes the
+ * activities modified, inserted or removed in the meantime. The records are in id order until the first
+ * update appends some, then they are sorted as those of a text file; 'nextId' follows the highest id.
+ * 
+ * Preconditions:
+ * - 'count != NULL'
+ * 
+ * Postconditions:
+ * - Creates a new container
+ * - If the file doesn't exist or is not a valid store, returns an empty container and '*count = 0'
+ * - Otherwise, reads all activities from the file and updates '*count' (number of activities read)
+ * 
+ * Side Effects:
+ * - Allocates memory for the container and activities
+ * - Modifies '*count' (number of activities read)
+ * - File opening and reading
+ * - Output to stdout (informational messages)
+ */
+ActivitiesContainer readActivitiesFromStoreFile(const char* filename, int* count);
+
+/*
+ * readActivitiesFromShardsDirectory
+ * 
+ * Syntactic Specification:
+ * ActivitiesContainer readActivitiesFromShardsDirectory(const char* directory, int* count);
+ * 
+ * Semantic Specification:
+ * Reads activities from a sharded directory (see 'saveActivitiesToShardsDirectory()'), its shards on
+ * several threads (see 'readActivityShards()'), and inserts them into a new container, bound to the
+ * directory: the next save to the same directory only writes the shards modified in the meantime. The
+ * shards cover increasing ranges of ids, so their activities are joined in id order and the tree is built at once.
+ * 
+ * Preconditions:
+ * - 'count != NULL'
+ * 
+ * Postconditions:
+ * - Creates a new container
+ * - If the directory doesn't exist or is not a valid sharded directory, returns an empty container and '*count = 0'
+ * - Otherwise, reads all activities from the directory and updates '*count' (number of activities read)
+ * 
+ * Side Effects:
+ * - Allocates memory for the container and activities
+ * - Modifies '*count' (number of activities read)
+ * - File opening and reading, creation and join of threads
+ * - Output to stdout (informational messages)
+ */
+ActivitiesContainer readActivitiesFromShardsDirectory(const char* directory, int* count);
+
+/*
+ * readActivitiesFromMapFile
+ * 
+ * Syntactic Specification:
+ * ActivitiesContainer readActivitiesFromMapFile(const char* filename, int* count);
+ * 
+ * Semantic Specification:
+ * Opens a mapped store (see 'saveActivitiesToMapFile()') as a new container, bound to the file: the next
+ * save to the same file only writes the activities modified, inserted or removed in the meantime. The file
+ * is mapped and its header checked, nothing else: no activity is created and no tree is built, so opening
+ * doesn't depend on the number of activities; 'nextId' follows the highest id, read from the right edge
+ * of the mapped tree. The listings by id, the progress list and the exports are made from the mapped nodes;
+ * the first operation that needs the activities in memory (lookup, modification, sorted listing, report...)
+ * builds the tree of the container at once (see 'buildPendingTree()').
+ * 
+ * Preconditions:
+ * - 'count != NULL'
+ * 
+ * Postconditions:
+ * - Creates a new container
+ * - If the file doesn't exist or its header is not valid, returns an empty container and '*count = 0'
+ * - Otherwise, returns the container with the activities of the file and sets '*count' (number of activities)
+ * 
+ * Side Effects:
+ * - Allocates memory for the container
+ * - Modifies '*count' (number of activities)
+ * - File opening and memory mapping
+ * - Output to stdout (informational messages)
+ */
+ActivitiesContainer readActivitiesFromMapFile(const char* filename, int* count);
+
+
+/*
+ * importActivitiesFromFile
+ * 
+ * Syntactic Specification:
+ * int importActivitiesFromFile(ActivitiesContainer container, const char* filename, int format,
+ *                              ActivityImportMapping mapping, int* count);
+ * 
+ * Semantic Specification:
+ * Imports into the container the activities of a CSV (ACTIVITY_IMPORT_CSV) or JSON Lines
+ * (ACTIVITY_IMPORT_JSONL) file, e.g. an export or a spreadsheet. The file is read record after record
+ * and every row is validated (see 'readImportedActivities()'); the columns are found through the mapping,
+ * by default the names of the export. The rows with an id keep it (unless it's already in the container),
+ * the rows without one take a new id from 'nextId' on. The valid activities are inserted all together
+ * with a single rebuild of the tree (see 'insertImportedActivities()').
+ * 
+ * Preconditions:
+ * - 'count != NULL'
+ * 
+ * Postconditions:
+ * - If 'container', 'filename' or 'mapping' is NULL, or the file can't be read, returns 1 (error) and
+ *   the container is unchanged
+ * - Otherwise, inserts the valid activities, sets '*count' to their number and returns 0 (success)
+ * 
+ * Side Effects:
+ * - Modifies the container
+ * - File opening and reading
+ * - Writing to the journal file (if the container has a journal)
+ * - Output to stdout (rejected rows and summary)
+ */
+int importActivitiesFromFile(ActivitiesContainer container, const char* filename, int format,
+                             ActivityImportMapping mapping, int* count);
+
 
 /*
  * addNewActivityToContainer
@@ -0,0 +1,734 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <sys/stat.h>
+#include "activity.h"
+#include "activities_container_archive.h"
+#include "activities_container_writer.h"
+
+// Maximum number of bytes of a varint (64 bit values, 7 bits per byte)
+#define ACTIVITY_ARCHIVE_VARINT_MAX_SIZE 10
+
+
+/*
+ * "struct archiveCourseDictionary" Documentation
+ *
+ * Syntactic Specification:
+ * typedef struct archiveCourseDictionary {
+ *     char** courses;
+ *     size_t count;
+ *     size_t* slots;
+ *     size_t slotCount;
+ * } ArchiveCourseDictionary;
+ *
+ * Semantic Specification:
+ * Distinct courses of the activities written to an archive, in order of first use, with a hash table
+ * (open addressing, linear probing) to find the position of a course.
+ *
+ * Fields:
+ * - courses: The courses (not copied: they belong to the activities)
+ * - count: Number of courses
+ * - slots: Hash table, position of a course plus one in every used slot (0: free slot)
+ * - slotCount: Number of slots (a power of 2, more than twice the maximum number of courses)
+ */
+typedef struct archiveCourseDictionary {
+	char** courses;
+	size_t count;
+	size_t* slots;
+	size_t slotCount;
+} ArchiveCourseDictionary;
+
+
+/*
+ * "struct archiveEncoder" Documentation
+ *
+ * Syntactic Specification:
+ * typedef struct archiveEncoder {
+ *     ActivityWriter writer;
+ *     ArchiveCourseDictionary dictionary;
+ *     uint64_t count;
+ *     int64_t previousId;
+ *     int64_t previousInsertDate;
+ *     int64_t previousExpiryDate;
+ *     int64_t previousCompletionDate;
+ * } ArchiveEncoder;
+ *
+ * Semantic Specification:
+ * State of the writing of an archive while the tree is visited.
+ *
+ * Fields:
+ * - writer: The writer of the file
+ * - dictionary: The course dictionary
+ * - count: Number of activities visited
+ * - previousId, previousInsertDate, previousExpiryDate, previousCompletionDate: Fields of the previous
+ *   record, the base of the differences of the next one (0 before the first record)
+ */
+typedef struct archiveEncoder {
+	ActivityWriter writer;
+	ArchiveCourseDictionary dictionary;
+	uint64_t count;
+	int64_t previousId;
+	int64_t previousInsertDate;
+	int64_t previousExpiryDate;
+	int64_t previousCompletionDate;
+} ArchiveEncoder;
+
+
+/*
+ * "struct archiveCursor" Documentation
+ *
+ * Syntactic Specification:
+ * typedef struct archiveCursor {
+ *     const unsigned char* data;
+ *     size_t size;
+ *     size_t offset;
+ *     int failed;
+ * } ArchiveCursor;
+ *
+ * Semantic Specification:
+ * Cursor over an archive read in memory.
+ *
+ * Fields:
+ * - data: The bytes of the archive
+ * - size: Number of bytes
+ * - offset: Position of the next value
+ * - failed: 1 if a value has been found truncated or invalid (then every read returns 0)
+ */
+typedef struct archiveCursor {
+	const unsigned char* data;
+	size_t size;
+	size_t offset;
+	int failed;
+} ArchiveCursor;
+
+
+
+/*
+ * encodeArchiveZigZag / decodeArchiveZigZag
+ *
+ * Syntactic Specification:
+ * uint64_t encodeArchiveZigZag(int64_t value);
+ * int64_t decodeArchiveZigZag(uint64_t value);
+ *
+ * Semantic Specification:
+ * Map signed values to unsigned ones alternating the signs (0, -1, 1, -2, 2, ... become 0, 1, 2, 3, 4, ...),
+ * so that a value near 0 of any sign takes few bytes as a varint, and back.
+ *
+ * Preconditions:
+ * - None
+ *
+ * Postconditions:
+ * - 'decodeArchiveZigZag(encodeArchiveZigZag(v)) == v' for every value
+ *
+ * Side Effects:
+ * - None
+ */
+uint64_t encodeArchiveZigZag(int64_t value) {
+	return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+int64_t decodeArchiveZigZag(uint64_t value) {
+	return (int64_t)((value >> 1) ^ (~(value & 1) + 1));
+}
+
+/*
+ * writeArchiveVarint
+ *
+ * Syntactic Specification:
+ * void writeArchiveVarint(ActivityWriter writer, uint64_t value);
+ *
+ * Semantic Specification:
+ * Writes a value as a varint: 7 bits per byte, least significant first, the high bit set on all the
+ * bytes but the last one.
+ *
+ * Preconditions:
+ * - 'writer != NULL'
+ *
+ * Postconditions:
+ * - The 1-10 bytes of the value follow the previous data
+ *
+ * Side Effects:
+ * - Writing to file
+ */
+void writeArchiveVarint(ActivityWriter writer, uint64_t value) {
+	unsigned char bytes[ACTIVITY_ARCHIVE_VARINT_MAX_SIZE];
+	size_t size = 0;
+	while (value >= 0x80) {
+		bytes[size++] = (unsigned char)(value | 0x80);
+		value >>= 7;
+	}
+	bytes[size++] = (unsigned char)value;
+
+	writeBytesToActivityWriter(writer, bytes, size);
+}
+
+/*
+ * writeArchiveString
+ *
+ * Syntactic Specification:
+ * void writeArchiveString(ActivityWriter writer, const char* str);
+ *
+ * Semantic Specification:
+ * Writes a string as its length plus one (a varint) followed by its bytes, or a single 0 if it's NULL.
+ *
+ * Preconditions:
+ * - 'writer != NULL'
+ *
+ * Postconditions:
+ * - The string follows the previous data
+ *
+ * Side Effects:
+ * - Writing to file
+ */
+void writeArchiveString(ActivityWriter writer, const char* str) {
+	if (str == NULL) {
+		writeArchiveVarint(writer, 0);
+		return;
+	}
+
+	size_t length = strlen(str);
+	writeArchiveVarint(writer, (uint64_t)length + 1);
+	writeBytesToActivityWriter(writer, str, length);
+}
+
+/*
+ * hashArchiveCourse
+ *
+ * Syntactic Specification:
+ * size_t hashArchiveCourse(const char* course);
+ *
+ * Semantic Specification:
+ * Computes the FNV-1a hash of a course, to find it in the course dictionary.
+ *
+ * Preconditions:
+ * - 'course != NULL'
+ *
+ * Postconditions:
+ * - Returns the hash
+ *
+ * Side Effects:
+ * - None
+ */
+size_t hashArchiveCourse(const char* course) {
+	uint64_t hash = 14695981039346656037ull;
+	for (const unsigned char* c = (const unsigned char*)course; *c != '\0'; c++) {
+		hash ^= *c;
+		hash *= 1099511628211ull;
+	}
+
+	return (size_t)hash;
+}
+
+/*
+ * addCourseToArchiveDictionary
+ *
+ * Syntactic Specification:
+ * size_t addCourseToArchiveDictionary(ArchiveCourseDictionary* dictionary, char* course);
+ *
+ * Semantic Specification:
+ * Finds the course in the dictionary and, if it's not there, adds it at the end.
+ *
+ * Preconditions:
+ * - 'dictionary' has room for one more course, 'course != NULL'
+ *
+ * Postconditions:
+ * - Returns the position of the course in the dictionary
+ *
+ * Side Effects:
+ * - May modify the dictionary
+ */
+size_t addCourseToArchiveDictionary(ArchiveCourseDictionary* dictionary, char* course) {
+	size_t mask = dictionary->slotCount - 1;
+	size_t slot = hashArchiveCourse(course) & mask;
+	while (dictionary->slots[slot] != 0) {
+		size_t position = dictionary->slots[slot] - 1;
+		if (strcmp(dictionary->courses[position], course) == 0) return position;
+		slot = (slot + 1) & mask;
+	}
+
+	dictionary->courses[dictionary->count] = course;
+	dictionary->slots[slot] = ++dictionary->count;
+	return dictionary->count - 1;
+}
+
+/*
+ * collectArchiveCourses
+ *
+ * Syntactic Specification:
+ * void collectArchiveCourses(ArchiveEncoder* encoder, TreeNode root);
+ *
+ * Semantic Specification:
+ * Visits the tree in order: counts the activities and adds their courses to the dictionary (first pass
+ * of the writing, the dictionary precedes the records).
+ *
+ * Preconditions:
+ * - 'encoder != NULL', its dictionary has room for a course per activity
+ *
+ * Postconditions:
+ * - 'count' is increased by the number of activities and the dictionary has all their courses
+ *
+ * Side Effects:
+ * - Modifies the encoder
+ */
+void collectArchiveCourses(ArchiveEncoder* encoder, TreeNode root) {
+	if (root == NULL) return;
+
+	collectArchiveCourses(encoder, getLeftNode(root));
+	char* course = getActivityCourse(getActivityFromNode(root));
+	if (course != NULL) addCourseToArchiveDictionary(&encoder->dictionary, course);
+	encoder->count++;
+	collectArchiveCourses(encoder, getRightNode(root));
+}
+
+/*
+ * writeArchiveRecords
+ *
+ * Syntactic Specification:
+ * void writeArchiveRecords(ArchiveEncoder* encoder, TreeNode root);
+ *
+ * Semantic Specification:
+ * Visits the tree in order and writes the record of every activity (second pass of the writing),
+ * see 'writeActivitiesArchive()'.
+ *
+ * Preconditions:
+ * - 'encoder != NULL', its dictionary has all the courses of the tree
+ *
+ * Postconditions:
+ * - The records follow the previous data, the fields of the last one are in the encoder
+ *
+ * Side Effects:
+ * - Writing to file
+ * - Modifies the encoder
+ */
+void writeArchiveRecords(ArchiveEncoder* encoder, TreeNode root) {
+	if (root == NULL) return;
+
+	writeArchiveRecords(encoder, getLeftNode(root));
+
+	Activity a = getActivityFromNode(root);
+	int64_t id = getActivityId(a);
+	int64_t insertDate = (int64_t)getActivityInsertDate(a);
+	int64_t expiryDate = (int64_t)getActivityExpiryDate(a);
+	int64_t completionDate = (int64_t)getActivityCompletionDate(a);
+
+	ActivityWriter writer = encoder->writer;
+	// the differences are computed on unsigned values: they wrap around instead of overflowing
+	writeArchiveVarint(writer, encodeArchiveZigZag((int64_t)((uint64_t)id - (uint64_t)encoder->previousId)));
+	writeArchiveVarint(writer, encodeArchiveZigZag((int64_t)((uint64_t)insertDate - (uint64_t)encoder->previousInsertDate)));
+	writeArchiveVarint(writer, encodeArchiveZigZag((int64_t)((uint64_t)expiryDate - (uint64_t)encoder->previousExpiryDate)));
+	writeArchiveVarint(writer, encodeArchiveZigZag((int64_t)((uint64_t)completionDate - (uint64_t)encoder->previousCompletionDate)));
+	writeArchiveVarint(writer, getActivityTotalTime(a));
+	writeArchiveVarint(writer, getActivityUsedTime(a));
+	writeArchiveVarint(writer, getActivityPriority(a));
+
+	char* course = getActivityCourse(a);
+	writeArchiveVarint(writer, (course != NULL) ? addCourseToArchiveDictionary(&encoder->dictionary, course) + 1 : 0);
+	writeArchiveString(writer, getActivityName(a));
+	writeArchiveString(writer, getActivityDescr(a));
+	if (!isActivityDescrLoaded(a)) failActivityWriter(writer);
+
+	encoder->previousId = id;
+	encoder->previousInsertDate = insertDate;
+	encoder->previousExpiryDate = expiryDate;
+	encoder->previousCompletionDate = completionDate;
+
+	writeArchiveRecords(encoder, getRightNode(root));
+}
+
+/*
+ * countArchiveTreeNodes
+ *
+ * Syntactic Specification:
+ * size_t countArchiveTreeNodes(TreeNode root);
+ *
+ * Semantic Specification:
+ * Counts the nodes of the tree.
+ *
+ * Preconditions:
+ * - None
+ *
+ * Postconditions:
+ * - Returns the number of nodes (0 if 'root == NULL')
+ *
+ * Side Effects:
+ * - None
+ */
+size_t countArchiveTreeNodes(TreeNode root) {
+	if (root == NULL) return 0;
+
+	return 1 + countArchiveTreeNodes(getLeftNode(root)) + countArchiveTreeNodes(getRightNode(root));
+}
+
+/*
+ * writeActivitiesArchive
+ *
+ * Syntactic Specification:
+ * int writeActivitiesArchive(ActivityWriter writer, TreeNode root);
+ *
+ * Semantic Specification:
+ * Writes the activities of the tree (in id order) with a writer in the compact archive format, meant for
+ * files that are kept and rarely read (e.g. the activities of past semesters). Every integer is a varint
+ * (7 bits per byte, least significant first, the high bit set on all the bytes but the last one), so the
+ * format doesn't depend on the byte order and small values take one byte:
+ * - a header: magic (8 bytes), then version, number of activities and number of courses
+ * - the course dictionary: every distinct course once (length and bytes), in order of first use
+ * - one record per activity: the id and the three dates as differences from the previous record (zigzag
+ *   encoded: a small negative difference is a small number too), total time, used time and priority,
+ *   the course as its position in the dictionary plus one, then name and description (length plus one
+ *   and bytes); a NULL string or course is a single 0
+ * Ids are increasing and the dates of near activities are close, so most of these fields take 1-3 bytes
+ * instead of 4-8, and a course repeated by many activities is stored once.
+ *
+ * Preconditions:
+ * - 'writer' created by 'newActivityWriter()' (the file is replaced by 'commitActivityWriter()')
+ *
+ * Postconditions:
+ * - Returns 0 if the archive has been passed to the writer (a failed write is reported by 'commitActivityWriter()')
+ * - Returns 1 if 'writer == NULL' or memory allocation fails
+ *
+ * Side Effects:
+ * - Writing to file
+ * - Allocates and deallocates the course dictionary
+ */
+int writeActivitiesArchive(ActivityWriter writer, TreeNode root) {
+	if (writer == NULL) return 1;
+
+	size_t nodeCount = countArchiveTreeNodes(root);
+	size_t slotCount = 16;
+	while (slotCount <= 2 * nodeCount) slotCount *= 2;
+
+	ArchiveEncoder encoder;
+	memset(&encoder, 0, sizeof(encoder));
+	encoder.writer = writer;
+	encoder.dictionary.courses = malloc((nodeCount > 0 ? nodeCount : 1) * sizeof(char*));
+	encoder.dictionary.slots = calloc(slotCount, sizeof(size_t));
+	encoder.dictionary.slotCount = slotCount;
+	if (encoder.dictionary.courses == NULL || encoder.dictionary.slots == NULL) {
+		free(encoder.dictionary.courses);
+		free(encoder.dictionary.slots);
+		return 1;
+	}
+
+	collectArchiveCourses(&encoder, root);
+
+	char magic[8] = { 0 };
+	memcpy(magic, ACTIVITY_ARCHIVE_MAGIC, sizeof(ACTIVITY_ARCHIVE_MAGIC));
+	writeBytesToActivityWriter(writer, magic, sizeof(magic));
+	writeArchiveVarint(writer, ACTIVITY_ARCHIVE_VERSION);
+	writeArchiveVarint(writer, encoder.count);
+	writeArchiveVarint(writer, encoder.dictionary.count);
+	for (size_t i = 0; i < encoder.dictionary.count; i++) {
+		size_t length = strlen(encoder.dictionary.courses[i]);
+		writeArchiveVarint(writer, length);
+		writeBytesToActivityWriter(writer, encoder.dictionary.courses[i], length);
+	}
+
+	writeArchiveRecords(&encoder, root);
+
+	free(encoder.dictionary.courses);
+	free(encoder.dictionary.slots);
+	return 0;
+}
+
+/*
+ * readArchiveVarint
+ *
+ * Syntactic Specification:
+ * uint64_t readArchiveVarint(ArchiveCursor* cursor);
+ *
+ * Semantic Specification:
+ * Reads the next varint (see 'writeArchiveVarint()').
+ *
+ * Preconditions:
+ * - 'cursor != NULL'
+ *
+ * Postconditions:
+ * - Returns the value and advances the cursor
+ * - Returns 0 and sets 'failed' if the varint is truncated, longer than 10 bytes or beyond 64 bits
+ *
+ * Side Effects:
+ * - Modifies the cursor
+ */
+uint64_t readArchiveVarint(ArchiveCursor* cursor) {
+	if (cursor->failed) return 0;
+
+	uint64_t value = 0;
+	for (int i = 0; i < ACTIVITY_ARCHIVE_VARINT_MAX_SIZE && cursor->offset < cursor->size; i++) {
+		unsigned char byte = cursor->data[cursor->offset++];
+		// the tenth byte can only hold the highest bit
+		if (i == ACTIVITY_ARCHIVE_VARINT_MAX_SIZE - 1 && byte > 1) break;
+
+		value |= (uint64_t)(byte & 0x7f) << (7 * i);
+		if ((byte & 0x80) == 0) return value;
+	}
+
+	cursor->failed = 1;
+	return 0;
+}
+
+/*
+ * readArchiveBoundedVarint
+ *
+ * Syntactic Specification:
+ * uint64_t readArchiveBoundedVarint(ArchiveCursor* cursor, uint64_t maximum);
+ *
+ * Semantic Specification:
+ * Reads the next varint, that must not be greater than 'maximum'.
+ *
+ * Preconditions:
+ * - 'cursor != NULL'
+ *
+ * Postconditions:
+ * - Returns the value and advances the cursor
+ * - Returns 0 and sets 'failed' if the varint is invalid or greater than 'maximum'
+ *
+ * Side Effects:
+ * - Modifies the cursor
+ */
+uint64_t readArchiveBoundedVarint(ArchiveCursor* cursor, uint64_t maximum) {
+	uint64_t value = readArchiveVarint(cursor);
+	if (value > maximum) {
+		cursor->failed = 1;
+		return 0;
+	}
+
+	return value;
+}
+
+/*
+ * readArchiveBytes
+ *
+ * Syntactic Specification:
+ * const unsigned char* readArchiveBytes(ArchiveCursor* cursor, size_t size);
+ *
+ * Semantic Specification:
+ * Skips the next 'size' bytes and returns where they are.
+ *
+ * Preconditions:
+ * - 'cursor != NULL'
+ *
+ * Postconditions:
+ * - Returns the bytes (in the data of the cursor) and advances the cursor
+ * - Returns NULL and sets 'failed' if less than 'size' bytes are left
+ *
+ * Side Effects:
+ * - Modifies the cursor
+ */
+const unsigned char* readArchiveBytes(ArchiveCursor* cursor, size_t size) {
+	if (cursor->failed || cursor->size - cursor->offset < size) {
+		cursor->failed = 1;
+		return NULL;
+	}
+
+	const unsigned char* bytes = cursor->data + cursor->offset;
+	cursor->offset += size;
+	return bytes;
+}
+
+/*
+ * readArchiveString
+ *
+ * Syntactic Specification:
+ * char* readArchiveString(ArchiveCursor* cursor, char** buffer, size_t* bufferSize);
+ *
+ * Semantic Specification:
+ * Reads the next string (see 'writeArchiveString()') into a buffer, enlarged if needed, and terminates it.
+ *
+ * Preconditions:
+ * - 'cursor', 'buffer' and 'bufferSize' not NULL ('*buffer' can be NULL with '*bufferSize == 0')
+ *
+ * Postconditions:
+ * - Returns the string in '*buffer', or NULL if it's a NULL string
+ * - Returns NULL and sets 'failed' if the string is truncated or memory allocation fails
+ *
+ * Side Effects:
+ * - Modifies the cursor
+ * - May reallocate the buffer
+ */
+char* readArchiveString(ArchiveCursor* cursor, char** buffer, size_t* bufferSize) {
+	uint64_t lengthPlusOne = readArchiveBoundedVarint(cursor, cursor->size);
+	if (lengthPlusOne == 0) return NULL;
+
+	size_t length = (size_t)(lengthPlusOne - 1);
+	const unsigned char* bytes = readArchiveBytes(cursor, length);
+	if (bytes == NULL) return NULL;
+
+	if (*bufferSize < length + 1) {
+		char* newBuffer = realloc(*buffer, length + 1);
+		if (newBuffer == NULL) {
+			cursor->failed = 1;
+			return NULL;
+		}
+		*buffer = newBuffer;
+		*bufferSize = length + 1;
+	}
+
+	memcpy(*buffer, bytes, length);
+	(*buffer)[length] = '\0';
+	return *buffer;
+}
+
+/*
+ * readArchiveCourses
+ *
+ * Syntactic Specification:
+ * char** readArchiveCourses(ArchiveCursor* cursor, size_t courseCount);
+ *
+ * Semantic Specification:
+ * Reads the course dictionary: every course is copied into a new string.
+ *
+ * Preconditions:
+ * - 'cursor != NULL'
+ *
+ * Postconditions:
+ * - Returns a new array with the 'courseCount' courses (the caller deallocates the array and the strings)
+ * - Returns NULL and sets 'failed' if the dictionary is invalid or memory allocation fails
+ *
+ * Side Effects:
+ * - Modifies the cursor
+ * - Allocates memory
+ */
+char** readArchiveCourses(ArchiveCursor* cursor, size_t courseCount) {
+	char** courses = calloc(courseCount > 0 ? courseCount : 1, sizeof(char*));
+	if (courses == NULL) {
+		cursor->failed = 1;
+		return NULL;
+	}
+
+	for (size_t i = 0; i < courseCount && !cursor->failed; i++) {
+		size_t length = (size_t)readArchiveBoundedVarint(cursor, cursor->size);
+		const unsigned char* bytes = readArchiveBytes(cursor, length);
+		courses[i] = (bytes != NULL) ? malloc(length + 1) : NULL;
+		if (courses[i] == NULL) {
+			cursor->failed = 1;
+			break;
+		}
+		memcpy(courses[i], bytes, length);
+		courses[i][length] = '\0';
+	}
+
+	if (cursor->failed) {
+		for (size_t i = 0; i < courseCount; i++) {
+			free(courses[i]);
+		}
+		free(courses);
+		return NULL;
+	}
+
+	return courses;
+}
+
+/*
+ * readActivitiesArchive
+ *
+ * Syntactic Specification:
+ * int readActivitiesArchive(FILE* file, Activity** activities, int* count);
+ *
+ * Semantic Specification:
+ * Reads a compact archive (see 'writeActivitiesArchive()') with a single read of the whole file and
+ * decodes its activities. Every value is checked while decoding (truncated or too long varints, values
+ * out of range, course positions outside the dictionary, bytes left after the last record).
+ *
+ * Preconditions:
+ * - 'file' opened for reading in binary mode, at the beginning of the archive
+ * - 'activities != NULL', 'count != NULL'
+ *
+ * Postconditions:
+ * - Returns 0 if the archive is valid: '*activities' is a new array with the '*count' activities in
+ *   file order (the caller deallocates the array and owns the activities)
+ * - Returns 1 if the file is not a valid archive (of this version) or memory allocation fails:
+ *   '*activities' is NULL and '*count' is 0
+ *
+ * Side Effects:
+ * - Reading from file
+ * - Allocates memory
+ */
+int readActivitiesArchive(FILE* file, Activity** activities, int* count) {
+	if (activities == NULL || count == NULL) return 1;
+	*activities = NULL;
+	*count = 0;
+	if (file == NULL) return 1;
+
+	struct stat fileInfo;
+	char magic[8];
+	if (fstat(fileno(file), &fileInfo) != 0 || (uint64_t)fileInfo.st_size > SIZE_MAX ||
+		 fread(magic, sizeof(magic), 1, file) != 1 ||
+		 memcmp(magic, ACTIVITY_ARCHIVE_MAGIC, sizeof(ACTIVITY_ARCHIVE_MAGIC)) != 0) {
+		return 1;
+	}
+
+	size_t size = (fileInfo.st_size > (off_t)sizeof(magic)) ? (size_t)fileInfo.st_size - sizeof(magic) : 0;
+	unsigned char* data = malloc(size > 0 ? size : 1);
+	if (data == NULL || fread(data, 1, size, file) != size) {
+		free(data);
+		return 1;
+	}
+
+	ArchiveCursor cursor = { data, size, 0, 0 };
+	uint64_t version = readArchiveVarint(&cursor);
+	// every record takes at least 10 bytes: a larger count is not in the file
+	size_t n = (size_t)readArchiveBoundedVarint(&cursor, (size / 10 < INT_MAX) ? size / 10 : INT_MAX);
+	size_t courseCount = (size_t)readArchiveBoundedVarint(&cursor, size);
+	if (version != ACTIVITY_ARCHIVE_VERSION) cursor.failed = 1;
+
+	char** courses = cursor.failed ? NULL : readArchiveCourses(&cursor, courseCount);
+	Activity* result = cursor.failed ? NULL : malloc((n > 0 ? n : 1) * sizeof(Activity));
+	if (result == NULL) cursor.failed = 1;
+
+	char* name = NULL;
+	size_t nameSize = 0;
+	char* descr = NULL;
+	size_t descrSize = 0;
+	int64_t id = 0;
+	int64_t dates[3] = { 0, 0, 0 };
+	size_t created = 0;
+	for (; created < n && !cursor.failed; created++) {
+		id = (int64_t)((uint64_t)id + (uint64_t)decodeArchiveZigZag(readArchiveVarint(&cursor)));
+		for (int d = 0; d < 3; d++) {
+			dates[d] = (int64_t)((uint64_t)dates[d] + (uint64_t)decodeArchiveZigZag(readArchiveVarint(&cursor)));
+		}
+		unsigned int totalTime = (unsigned int)readArchiveBoundedVarint(&cursor, UINT_MAX);
+		unsigned int usedTime = (unsigned int)readArchiveBoundedVarint(&cursor, UINT_MAX);
+		short unsigned int priority = (short unsigned int)readArchiveBoundedVarint(&cursor, USHRT_MAX);
+		size_t course = (size_t)readArchiveBoundedVarint(&cursor, courseCount);
+		char* activityName = readArchiveString(&cursor, &name, &nameSize);
+		char* activityDescr = readArchiveString(&cursor, &descr, &descrSize);
+		if (id < INT_MIN || id > INT_MAX) cursor.failed = 1;
+		if (cursor.failed) break;
+
+		result[created] = newActivity((int)id, activityName, activityDescr, (course > 0) ? courses[course - 1] : NULL,
+												(time_t)dates[0], (time_t)dates[1], (time_t)dates[2], totalTime, usedTime, priority);
+		if (result[created] == NULL) {
+			cursor.failed = 1;
+			break;
+		}
+	}
+
+	// the archive must end with its last record
+	int error = cursor.failed || cursor.offset != cursor.size;
+	if (error && result != NULL) {
+		for (size_t i = 0; i < created; i++) {
+			deleteActivity(result[i]);
+		}
+		free(result);
+		result = NULL;
+	}
+
+	if (courses != NULL) {
+		for (size_t i = 0; i < courseCount; i++) {
+			free(courses[i]);
+		}
+		free(courses);
+	}
+	free(name);
+	free(descr);
+	free(data);
+
+	if (error) return 1;
+
+	*activities = result;
+	*count = (int)n;
+	return 0;
+}
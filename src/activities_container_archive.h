@@ -0,0 +1,74 @@
+#ifndef ACTIVITIES_CONTAINER_ARCHIVE_H             // Start of inclusion block
+#define ACTIVITIES_CONTAINER_ARCHIVE_H             // Macro definition to avoid multiple inclusions
+
+#include <stdio.h>
+#include "activities_container_avl.h"
+#include "activities_container_writer.h"
+
+// First bytes of a compact archive file
+#define ACTIVITY_ARCHIVE_MAGIC "PSDARCV"
+// Version of the compact archive format written by 'writeActivitiesArchive()'
+#define ACTIVITY_ARCHIVE_VERSION 1
+
+
+/*
+ * writeActivitiesArchive
+ *
+ * Syntactic Specification:
+ * int writeActivitiesArchive(ActivityWriter writer, TreeNode root);
+ *
+ * Semantic Specification:
+ * Writes the activities of the tree (in id order) with a writer in the compact archive format, meant for
+ * files that are kept and rarely read (e.g. the activities of past semesters). Every integer is a varint
+ * (7 bits per byte, least significant first, the high bit set on all the bytes but the last one), so the
+ * format doesn't depend on the byte order and small values take one byte:
+ * - a header: magic (8 bytes), then version, number of activities and number of courses
+ * - the course dictionary: every distinct course once (length and bytes), in order of first use
+ * - one record per activity: the id and the three dates as differences from the previous record (zigzag
+ *   encoded: a small negative difference is a small number too), total time, used time and priority,
+ *   the course as its position in the dictionary plus one, then name and description (length plus one
+ *   and bytes); a NULL string or course is a single 0
+ * Ids are increasing and the dates of near activities are close, so most of these fields take 1-3 bytes
+ * instead of 4-8, and a course repeated by many activities is stored once.
+ *
+ * Preconditions:
+ * - 'writer' created by 'newActivityWriter()' (the file is replaced by 'commitActivityWriter()')
+ *
+ * Postconditions:
+ * - Returns 0 if the archive has been passed to the writer (a failed write is reported by 'commitActivityWriter()')
+ * - Returns 1 if 'writer == NULL' or memory allocation fails
+ *
+ * Side Effects:
+ * - Writing to file
+ * - Allocates and deallocates the course dictionary
+ */
+int writeActivitiesArchive(ActivityWriter writer, TreeNode root);
+
+/*
+ * readActivitiesArchive
+ *
+ * Syntactic Specification:
+ * int readActivitiesArchive(FILE* file, Activity** activities, int* count);
+ *
+ * Semantic Specification:
+ * Reads a compact archive (see 'writeActivitiesArchive()') with a single read of the whole file and
+ * decodes its activities. Every value is checked while decoding (truncated or too long varints, values
+ * out of range, course positions outside the dictionary, bytes left after the last record).
+ *
+ * Preconditions:
+ * - 'file' opened for reading in binary mode, at the beginning of the archive
+ * - 'activities != NULL', 'count != NULL'
+ *
+ * Postconditions:
+ * - Returns 0 if the archive is valid: '*activities' is a new array with the '*count' activities in
+ *   file order (the caller deallocates the array and owns the activities)
+ * - Returns 1 if the file is not a valid archive (of this version) or memory allocation fails:
+ *   '*activities' is NULL and '*count' is 0
+ *
+ * Side Effects:
+ * - Reading from file
+ * - Allocates memory
+ */
+int readActivitiesArchive(FILE* file, Activity** activities, int* count);
+
+#endif // ACTIVITIES_CONTAINER_ARCHIVE_H          // End of inclusion block
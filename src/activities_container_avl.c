@@ -437,6 +437,7 @@ Node* minValueNode(Node* node) {
  * - If the node with 'activityId' doesn't exist, returns the unmodified tree
  * - Otherwise, deletes the node and rebalances the tree
  * - The activity contained in the deleted node is deallocated
+ * - The other activities are not moved nor copied (pointers to them stay valid)
  * 
  * Side Effects:
  * - Deallocates memory of the deleted node
@@ -484,13 +485,16 @@ TreeNode deleteNode(TreeNode root, int activityId) {
 			// Get the inorder successor (smallest in the right subtree)
 			Node* temp = minValueNode(root->right);
 
-			// Copy the inorder successor's data to this node
-			Activity tempActivity = root->activity;
-			root->activity = copyActivity(temp->activity);
+			// Move the inorder successor's activity to this node and park the activity
+			// to delete in the successor node (no copy: activity pointers stay valid).
+			// The successor is the leftmost node of the right subtree, so the search
+			// for the (smaller) id to delete still reaches it.
+			Activity activityToDelete = root->activity;
+			root->activity = temp->activity;
+			temp->activity = activityToDelete;
 
-			// Delete the inorder successor
-			deleteActivity(tempActivity);
-			root->right = deleteNode(root->right, getActivityId(temp->activity) );
+			// Delete the inorder successor node (and the parked activity)
+			root->right = deleteNode(root->right, getActivityId(activityToDelete) );
 		}
 	}
 
@@ -557,3 +561,122 @@ void deleteSubtree(TreeNode root) {
 	}
 }
 
+
+
+/*
+ * freeSubtreeNodes
+ * 
+ * Syntactic Specification:
+ * void freeSubtreeNodes(TreeNode root);
+ * 
+ * Semantic Specification:
+ * Recursively deallocates the nodes of a subtree, without deallocating their activities
+ * (e.g. when the activities are moved to a tree built again).
+ * 
+ * Preconditions:
+ * - None
+ * 
+ * Postconditions:
+ * - All subtree nodes are deallocated, the activities are unchanged
+ * 
+ * Side Effects:
+ * - Deallocates memory
+ */
+void freeSubtreeNodes(TreeNode root) {
+	if (root != NULL) {
+		freeSubtreeNodes(root->left);
+		freeSubtreeNodes(root->right);
+		free(root);
+	}
+}
+
+
+/*
+ * countTreeActivities
+ * 
+ * Syntactic Specification:
+ * int countTreeActivities(TreeNode root);
+ * 
+ * Semantic Specification:
+ * Counts the activities in the tree.
+ * 
+ * Preconditions:
+ * - None
+ * 
+ * Postconditions:
+ * - Returns the number of nodes of the tree (0 if 'root == NULL')
+ * 
+ * Side Effects:
+ * - None
+ */
+int countTreeActivities(TreeNode root) {
+	if (root == NULL) return 0;
+
+	return 1 + countTreeActivities(root->left) + countTreeActivities(root->right);
+}
+
+/*
+ * collectTreeActivities
+ * 
+ * Syntactic Specification:
+ * void collectTreeActivities(TreeNode root, Activity* activities, int* count);
+ * 
+ * Semantic Specification:
+ * Visits the tree in order and appends its activities to an array, so they are sorted by id.
+ * 
+ * Preconditions:
+ * - 'activities' has room for the activities of the tree after the first '*count'
+ * 
+ * Postconditions:
+ * - The activities of the tree follow the first '*count' ones, '*count' is updated
+ * 
+ * Side Effects:
+ * - Modifies the array
+ */
+void collectTreeActivities(TreeNode root, Activity* activities, int* count) {
+	if (root == NULL) return;
+	
+	collectTreeActivities(getLeftNode(root), activities, count);
+	activities[(*count)++] = getActivityFromNode(root);
+	collectTreeActivities(getRightNode(root), activities, count);
+}
+
+
+/*
+ * buildTreeFromSortedActivities
+ * 
+ * Syntactic Specification:
+ * TreeNode buildTreeFromSortedActivities(Activity* activities, int count);
+ * 
+ * Semantic Specification:
+ * Builds in O(n) a balanced tree with the activities of an array sorted by id, without comparisons
+ * and rotations: the middle activity is the root, the two halves are its subtrees.
+ * 
+ * Preconditions:
+ * - 'activities' has 'count' activities (not NULL) with strictly increasing ids
+ * 
+ * Postconditions:
+ * - Returns the root of the tree (NULL if 'count <= 0')
+ * - Returns NULL if memory allocation fails (no node is left allocated, the activities are not deallocated)
+ * 
+ * Side Effects:
+ * - Allocates memory for the nodes
+ */
+TreeNode buildTreeFromSortedActivities(Activity* activities, int count) {
+	if (activities == NULL || count <= 0) return NULL;
+	
+	int middle = count / 2;
+	Node* node = createNode(activities[middle]);
+	if (node == NULL) return NULL;
+	
+	node->left = buildTreeFromSortedActivities(activities, middle);
+	node->right = buildTreeFromSortedActivities(activities + middle + 1, count - middle - 1);
+	
+	if ((middle > 0 && node->left == NULL) || (count - middle - 1 > 0 && node->right == NULL)) {
+		freeSubtreeNodes(node);
+		return NULL;
+	}
+	
+	node->height = 1 + max(getHeight(node->left), getHeight(node->right));
+	return node;
+}
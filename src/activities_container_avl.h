@@ -135,6 +135,7 @@ TreeNode insertNode(TreeNode node, Activity activity);
  * - If the node with 'activityId' doesn't exist, returns the unmodified tree
  * - Otherwise, deletes the node and rebalances the tree
  * - The activity contained in the deleted node is deallocated
+ * - The other activities are not moved nor copied (pointers to them stay valid)
  * 
  * Side Effects:
  * - Deallocates memory of the deleted node
@@ -165,4 +166,90 @@ TreeNode deleteNode(TreeNode root, int activityId);
  */
 void deleteSubtree(TreeNode root);
 
+
+/*
+ * freeSubtreeNodes
+ * 
+ * Syntactic Specification:
+ * void freeSubtreeNodes(TreeNode root);
+ * 
+ * Semantic Specification:
+ * Recursively deallocates the nodes of a subtree, without deallocating their activities
+ * (e.g. when the activities are moved to a tree built again).
+ * 
+ * Preconditions:
+ * - None
+ * 
+ * Postconditions:
+ * - All subtree nodes are deallocated, the activities are unchanged
+ * 
+ * Side Effects:
+ * - Deallocates memory
+ */
+void freeSubtreeNodes(TreeNode root);
+
+
+/*
+ * countTreeActivities
+ * 
+ * Syntactic Specification:
+ * int countTreeActivities(TreeNode root);
+ * 
+ * Semantic Specification:
+ * Counts the activities in the tree.
+ * 
+ * Preconditions:
+ * - None
+ * 
+ * Postconditions:
+ * - Returns the number of nodes of the tree (0 if 'root == NULL')
+ * 
+ * Side Effects:
+ * - None
+ */
+int countTreeActivities(TreeNode root);
+
+/*
+ * collectTreeActivities
+ * 
+ * Syntactic Specification:
+ * void collectTreeActivities(TreeNode root, Activity* activities, int* count);
+ * 
+ * Semantic Specification:
+ * Visits the tree in order and appends its activities to an array, so they are sorted by id.
+ * 
+ * Preconditions:
+ * - 'activities' has room for the activities of the tree after the first '*count'
+ * 
+ * Postconditions:
+ * - The activities of the tree follow the first '*count' ones, '*count' is updated
+ * 
+ * Side Effects:
+ * - Modifies the array
+ */
+void collectTreeActivities(TreeNode root, Activity* activities, int* count);
+
+
+/*
+ * buildTreeFromSortedActivities
+ * 
+ * Syntactic Specification:
+ * TreeNode buildTreeFromSortedActivities(Activity* activities, int count);
+ * 
+ * Semantic Specification:
+ * Builds in O(n) a balanced tree with the activities of an array sorted by id, without comparisons
+ * and rotations: the middle activity is the root, the two halves are its subtrees.
+ * 
+ * Preconditions:
+ * - 'activities' has 'count' activities (not NULL) with strictly increasing ids
+ * 
+ * Postconditions:
+ * - Returns the root of the tree (NULL if 'count <= 0')
+ * - Returns NULL if memory allocation fails (no node is left allocated, the activities are not deallocated)
+ * 
+ * Side Effects:
+ * - Allocates memory for the nodes
+ */
+TreeNode buildTreeFromSortedActivities(Activity* activities, int count);
+
 #endif // ACTIVITIES_CONTAINER_AVL_H          // End of inclusion block
\ No newline at end of file
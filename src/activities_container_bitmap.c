@@ -0,0 +1,946 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "activities_container_bitmap.h"
+
+// Number of low bits of the ids kept inside a chunk (a chunk covers 65536 ids)
+#define BITMAP_CHUNK_BITS 16
+// Mask of the low bits of an id
+#define BITMAP_CHUNK_MASK 0xFFFF
+// Maximum number of values of an array chunk: above it the bitmap (8 KiB) is smaller than the array
+#define BITMAP_ARRAY_MAX_CARDINALITY 4096
+// Number of 64 bit words of a bitmap chunk
+#define BITMAP_CHUNK_WORDS 1024
+
+
+/*
+ * "struct bitmapChunk" Documentation
+ *
+ * Syntactic Specification:
+ * typedef struct bitmapChunk {
+ *     int key;
+ *     int cardinality;
+ *     int capacity;
+ *     unsigned short* values;
+ *     uint64_t* words;
+ * } BitmapChunk;
+ *
+ * Semantic Specification:
+ * The ids of a set that share the same high 16 bits ('key'), stored by their low 16 bits.
+ * An array chunk ('words == NULL') keeps the values sorted in 'values'; a bitmap chunk
+ * ('words != NULL') keeps one bit per value in 1024 words. A chunk is an array chunk
+ * if and only if it has at most BITMAP_ARRAY_MAX_CARDINALITY values.
+ *
+ * Fields:
+ * - key: High 16 bits of the ids of the chunk
+ * - cardinality: Number of ids in the chunk (never 0 in a set)
+ * - capacity: Allocated values of an array chunk
+ * - values: Sorted low 16 bits of the ids (array chunk, NULL otherwise)
+ * - words: Bitmap of the low 16 bits of the ids (bitmap chunk, NULL otherwise)
+ */
+typedef struct bitmapChunk {
+	int key;
+	int cardinality;
+	int capacity;
+	unsigned short* values;
+	uint64_t* words;
+} BitmapChunk;
+
+
+/*
+ * "struct activityBitmap" Documentation
+ *
+ * Syntactic Specification:
+ * struct activityBitmap {
+ *     BitmapChunk* chunks;
+ *     int count;
+ *     int capacity;
+ * };
+ *
+ * Semantic Specification:
+ * A compressed set of activity ids: the non empty chunks, sorted by key.
+ *
+ * Fields:
+ * - chunks: Array of the chunks, sorted by key
+ * - count: Number of chunks
+ * - capacity: Allocated chunks
+ */
+struct activityBitmap {
+	BitmapChunk* chunks;
+	int count;
+	int capacity;
+};
+
+
+
+/*
+ * freeBitmapChunk
+ *
+ * Syntactic Specification:
+ * void freeBitmapChunk(BitmapChunk* chunk);
+ *
+ * Semantic Specification:
+ * Deallocates the values of a chunk (not the chunk itself, which lives in the array of the set).
+ *
+ * Preconditions:
+ * - 'chunk != NULL'
+ *
+ * Postconditions:
+ * - The chunk is empty, with no memory allocated
+ *
+ * Side Effects:
+ * - Deallocates memory
+ */
+void freeBitmapChunk(BitmapChunk* chunk) {
+	free(chunk->values);
+	free(chunk->words);
+	chunk->values = NULL;
+	chunk->words = NULL;
+	chunk->cardinality = 0;
+	chunk->capacity = 0;
+}
+
+/*
+ * findValueInArrayChunk
+ *
+ * Syntactic Specification:
+ * int findValueInArrayChunk(const BitmapChunk* chunk, int value);
+ *
+ * Semantic Specification:
+ * Binary search in the values of an array chunk.
+ *
+ * Preconditions:
+ * - 'chunk' is an array chunk
+ *
+ * Postconditions:
+ * - Returns the position of the first value greater than or equal to 'value' ('cardinality' if there is none)
+ *
+ * Side Effects:
+ * - None
+ */
+int findValueInArrayChunk(const BitmapChunk* chunk, int value) {
+	int low = 0;
+	int high = chunk->cardinality;
+	while (low < high) {
+		int mid = low + (high - low) / 2;
+		if (chunk->values[mid] < value) low = mid + 1;
+		else high = mid;
+	}
+
+	return low;
+}
+
+/*
+ * isValueInBitmapChunk
+ *
+ * Syntactic Specification:
+ * int isValueInBitmapChunk(const BitmapChunk* chunk, int value);
+ *
+ * Semantic Specification:
+ * Checks if the low 16 bits 'value' are in the chunk.
+ *
+ * Preconditions:
+ * - 'chunk != NULL', '0 <= value <= 0xFFFF'
+ *
+ * Postconditions:
+ * - Returns 1 if the value is in the chunk, 0 otherwise
+ *
+ * Side Effects:
+ * - None
+ */
+int isValueInBitmapChunk(const BitmapChunk* chunk, int value) {
+	if (chunk->words != NULL) return (int)((chunk->words[value >> 6] >> (value & 63)) & 1);
+
+	int position = findValueInArrayChunk(chunk, value);
+	return (position < chunk->cardinality && chunk->values[position] == value) ? 1 : 0;
+}
+
+/*
+ * convertArrayChunkToWords
+ *
+ * Syntactic Specification:
+ * int convertArrayChunkToWords(BitmapChunk* chunk);
+ *
+ * Semantic Specification:
+ * Turns an array chunk into a bitmap chunk with the same values.
+ *
+ * Preconditions:
+ * - 'chunk' is an array chunk
+ *
+ * Postconditions:
+ * - Returns 0 on success, 1 if memory allocation fails (the chunk is unchanged)
+ *
+ * Side Effects:
+ * - Allocates and deallocates memory
+ */
+int convertArrayChunkToWords(BitmapChunk* chunk) {
+	uint64_t* words = calloc(BITMAP_CHUNK_WORDS, sizeof(uint64_t));
+	if (words == NULL) return 1;
+
+	for (int i = 0; i < chunk->cardinality; i++) {
+		words[chunk->values[i] >> 6] |= (uint64_t)1 << (chunk->values[i] & 63);
+	}
+
+	free(chunk->values);
+	chunk->values = NULL;
+	chunk->capacity = 0;
+	chunk->words = words;
+	return 0;
+}
+
+/*
+ * normalizeWordsChunk
+ *
+ * Syntactic Specification:
+ * int normalizeWordsChunk(BitmapChunk* chunk);
+ *
+ * Semantic Specification:
+ * Recounts the values of a bitmap chunk just computed by a word-parallel operation and turns it into
+ * an array chunk if it has at most BITMAP_ARRAY_MAX_CARDINALITY values (an empty chunk is freed).
+ *
+ * Preconditions:
+ * - 'chunk' is a bitmap chunk
+ *
+ * Postconditions:
+ * - Returns 0 on success, 1 if memory allocation fails (the chunk is freed)
+ *
+ * Side Effects:
+ * - Allocates and deallocates memory
+ */
+int normalizeWordsChunk(BitmapChunk* chunk) {
+	int cardinality = 0;
+	for (int i = 0; i < BITMAP_CHUNK_WORDS; i++) {
+		cardinality += __builtin_popcountll(chunk->words[i]);
+	}
+	chunk->cardinality = cardinality;
+
+	if (cardinality == 0) {
+		freeBitmapChunk(chunk);
+		return 0;
+	}
+	if (cardinality > BITMAP_ARRAY_MAX_CARDINALITY) return 0;
+
+	unsigned short* values = malloc(cardinality * sizeof(unsigned short));
+	if (values == NULL) {
+		freeBitmapChunk(chunk);
+		return 1;
+	}
+
+	int count = 0;
+	for (int i = 0; i < BITMAP_CHUNK_WORDS; i++) {
+		uint64_t word = chunk->words[i];
+		while (word != 0) {
+			values[count++] = (unsigned short)((i << 6) + __builtin_ctzll(word));
+			word &= word - 1;
+		}
+	}
+
+	free(chunk->words);
+	chunk->words = NULL;
+	chunk->values = values;
+	chunk->capacity = cardinality;
+	return 0;
+}
+
+/*
+ * copyBitmapChunk
+ *
+ * Syntactic Specification:
+ * int copyBitmapChunk(const BitmapChunk* source, BitmapChunk* copy);
+ *
+ * Semantic Specification:
+ * Makes a deep copy of a chunk.
+ *
+ * Preconditions:
+ * - 'source != NULL', 'copy != NULL'
+ *
+ * Postconditions:
+ * - Returns 0 on success, 1 if memory allocation fails ('copy' is left empty)
+ *
+ * Side Effects:
+ * - Allocates memory
+ */
+int copyBitmapChunk(const BitmapChunk* source, BitmapChunk* copy) {
+	*copy = (BitmapChunk){ source->key, source->cardinality, 0, NULL, NULL };
+
+	if (source->words != NULL) {
+		copy->words = malloc(BITMAP_CHUNK_WORDS * sizeof(uint64_t));
+		if (copy->words == NULL) return 1;
+		memcpy(copy->words, source->words, BITMAP_CHUNK_WORDS * sizeof(uint64_t));
+	} else {
+		copy->values = malloc(source->cardinality * sizeof(unsigned short));
+		if (copy->values == NULL) return 1;
+		memcpy(copy->values, source->values, source->cardinality * sizeof(unsigned short));
+		copy->capacity = source->cardinality;
+	}
+
+	return 0;
+}
+
+/*
+ * loadChunkIntoWords
+ *
+ * Syntactic Specification:
+ * void loadChunkIntoWords(const BitmapChunk* chunk, uint64_t* words);
+ *
+ * Semantic Specification:
+ * Sets in 'words' the bits of the values of the chunk (OR with the bits already set).
+ *
+ * Preconditions:
+ * - 'chunk != NULL', 'words' has BITMAP_CHUNK_WORDS words
+ *
+ * Postconditions:
+ * - All the values of the chunk are set in 'words'
+ *
+ * Side Effects:
+ * - Modifies 'words'
+ */
+void loadChunkIntoWords(const BitmapChunk* chunk, uint64_t* words) {
+	if (chunk->words != NULL) {
+		for (int i = 0; i < BITMAP_CHUNK_WORDS; i++) {
+			words[i] |= chunk->words[i];
+		}
+	} else {
+		for (int i = 0; i < chunk->cardinality; i++) {
+			words[chunk->values[i] >> 6] |= (uint64_t)1 << (chunk->values[i] & 63);
+		}
+	}
+}
+
+/*
+ * andBitmapChunks
+ *
+ * Syntactic Specification:
+ * int andBitmapChunks(const BitmapChunk* a, const BitmapChunk* b, BitmapChunk* result);
+ *
+ * Semantic Specification:
+ * Intersection of two chunks with the same key: AND of the words for two bitmap chunks, merge of
+ * the values for two array chunks, lookup of the array values in the bitmap otherwise.
+ *
+ * Preconditions:
+ * - 'a', 'b' and 'result' not NULL, 'a->key == b->key'
+ *
+ * Postconditions:
+ * - Returns 0 on success ('result' can be empty), 1 if memory allocation fails ('result' is left empty)
+ *
+ * Side Effects:
+ * - Allocates memory
+ */
+int andBitmapChunks(const BitmapChunk* a, const BitmapChunk* b, BitmapChunk* result) {
+	*result = (BitmapChunk){ a->key, 0, 0, NULL, NULL };
+
+	if (a->words != NULL && b->words != NULL) {
+		result->words = malloc(BITMAP_CHUNK_WORDS * sizeof(uint64_t));
+		if (result->words == NULL) return 1;
+		for (int i = 0; i < BITMAP_CHUNK_WORDS; i++) {
+			result->words[i] = a->words[i] & b->words[i];
+		}
+		return normalizeWordsChunk(result);
+	}
+
+	// at least one array chunk: the result has at most the values of the smaller array
+	if (a->words != NULL || (b->words == NULL && b->cardinality < a->cardinality)) {
+		const BitmapChunk* swap = a;
+		a = b;
+		b = swap;
+	}
+
+	result->values = malloc(a->cardinality * sizeof(unsigned short));
+	if (result->values == NULL) return 1;
+	result->capacity = a->cardinality;
+
+	int count = 0;
+	if (b->words != NULL) {
+		for (int i = 0; i < a->cardinality; i++) {
+			if (isValueInBitmapChunk(b, a->values[i])) result->values[count++] = a->values[i];
+		}
+	} else {
+		int i = 0, j = 0;
+		while (i < a->cardinality && j < b->cardinality) {
+			if (a->values[i] < b->values[j]) i++;
+			else if (a->values[i] > b->values[j]) j++;
+			else {
+				result->values[count++] = a->values[i];
+				i++;
+				j++;
+			}
+		}
+	}
+	result->cardinality = count;
+
+	if (count == 0) freeBitmapChunk(result);
+	return 0;
+}
+
+/*
+ * orBitmapChunks
+ *
+ * Syntactic Specification:
+ * int orBitmapChunks(const BitmapChunk* a, const BitmapChunk* b, BitmapChunk* result);
+ *
+ * Semantic Specification:
+ * Union of two chunks with the same key: merge of the values if the result surely fits in an array
+ * chunk, OR of the words otherwise.
+ *
+ * Preconditions:
+ * - 'a', 'b' and 'result' not NULL, 'a->key == b->key'
+ *
+ * Postconditions:
+ * - Returns 0 on success, 1 if memory allocation fails ('result' is left empty)
+ *
+ * Side Effects:
+ * - Allocates memory
+ */
+int orBitmapChunks(const BitmapChunk* a, const BitmapChunk* b, BitmapChunk* result) {
+	*result = (BitmapChunk){ a->key, 0, 0, NULL, NULL };
+
+	if (a->words == NULL && b->words == NULL && a->cardinality + b->cardinality <= BITMAP_ARRAY_MAX_CARDINALITY) {
+		result->values = malloc((a->cardinality + b->cardinality) * sizeof(unsigned short));
+		if (result->values == NULL) return 1;
+		result->capacity = a->cardinality + b->cardinality;
+
+		int i = 0, j = 0, count = 0;
+		while (i < a->cardinality || j < b->cardinality) {
+			if (j >= b->cardinality || (i < a->cardinality && a->values[i] < b->values[j])) {
+				result->values[count++] = a->values[i++];
+			} else if (i >= a->cardinality || b->values[j] < a->values[i]) {
+				result->values[count++] = b->values[j++];
+			} else {
+				result->values[count++] = a->values[i];
+				i++;
+				j++;
+			}
+		}
+		result->cardinality = count;
+		return 0;
+	}
+
+	result->words = calloc(BITMAP_CHUNK_WORDS, sizeof(uint64_t));
+	if (result->words == NULL) return 1;
+	loadChunkIntoWords(a, result->words);
+	loadChunkIntoWords(b, result->words);
+	return normalizeWordsChunk(result);
+}
+
+/*
+ * andNotBitmapChunks
+ *
+ * Syntactic Specification:
+ * int andNotBitmapChunks(const BitmapChunk* a, const BitmapChunk* b, BitmapChunk* result);
+ *
+ * Semantic Specification:
+ * Difference of two chunks with the same key: the values of 'a' not in 'b' are filtered if 'a' is
+ * an array chunk, otherwise the words of 'a' are masked with the (complemented) values of 'b'.
+ *
+ * Preconditions:
+ * - 'a', 'b' and 'result' not NULL, 'a->key == b->key'
+ *
+ * Postconditions:
+ * - Returns 0 on success ('result' can be empty), 1 if memory allocation fails ('result' is left empty)
+ *
+ * Side Effects:
+ * - Allocates memory
+ */
+int andNotBitmapChunks(const BitmapChunk* a, const BitmapChunk* b, BitmapChunk* result) {
+	*result = (BitmapChunk){ a->key, 0, 0, NULL, NULL };
+
+	if (a->words == NULL) {
+		result->values = malloc(a->cardinality * sizeof(unsigned short));
+		if (result->values == NULL) return 1;
+		result->capacity = a->cardinality;
+
+		int count = 0;
+		for (int i = 0; i < a->cardinality; i++) {
+			if (!isValueInBitmapChunk(b, a->values[i])) result->values[count++] = a->values[i];
+		}
+		result->cardinality = count;
+
+		if (count == 0) freeBitmapChunk(result);
+		return 0;
+	}
+
+	result->words = malloc(BITMAP_CHUNK_WORDS * sizeof(uint64_t));
+	if (result->words == NULL) return 1;
+	if (b->words != NULL) {
+		for (int i = 0; i < BITMAP_CHUNK_WORDS; i++) {
+			result->words[i] = a->words[i] & ~b->words[i];
+		}
+	} else {
+		memcpy(result->words, a->words, BITMAP_CHUNK_WORDS * sizeof(uint64_t));
+		for (int i = 0; i < b->cardinality; i++) {
+			result->words[b->values[i] >> 6] &= ~((uint64_t)1 << (b->values[i] & 63));
+		}
+	}
+	return normalizeWordsChunk(result);
+}
+
+/*
+ * findBitmapChunk
+ *
+ * Syntactic Specification:
+ * int findBitmapChunk(ActivityBitmap bitmap, int key);
+ *
+ * Semantic Specification:
+ * Binary search of a chunk by key.
+ *
+ * Preconditions:
+ * - 'bitmap != NULL'
+ *
+ * Postconditions:
+ * - Returns the position of the first chunk with key greater than or equal to 'key' ('count' if there is none)
+ *
+ * Side Effects:
+ * - None
+ */
+int findBitmapChunk(ActivityBitmap bitmap, int key) {
+	int low = 0;
+	int high = bitmap->count;
+	while (low < high) {
+		int mid = low + (high - low) / 2;
+		if (bitmap->chunks[mid].key < key) low = mid + 1;
+		else high = mid;
+	}
+
+	return low;
+}
+
+/*
+ * reserveBitmapChunks
+ *
+ * Syntactic Specification:
+ * int reserveBitmapChunks(ActivityBitmap bitmap, int count);
+ *
+ * Semantic Specification:
+ * Makes room for at least 'count' chunks (doubling the capacity).
+ *
+ * Preconditions:
+ * - 'bitmap != NULL'
+ *
+ * Postconditions:
+ * - Returns 0 on success, 1 if memory allocation fails (the set is unchanged)
+ *
+ * Side Effects:
+ * - May reallocate the array of the chunks
+ */
+int reserveBitmapChunks(ActivityBitmap bitmap, int count) {
+	if (count <= bitmap->capacity) return 0;
+
+	int capacity = (bitmap->capacity > 0) ? bitmap->capacity : 4;
+	while (capacity < count) capacity *= 2;
+
+	BitmapChunk* chunks = realloc(bitmap->chunks, capacity * sizeof(BitmapChunk));
+	if (chunks == NULL) return 1;
+
+	bitmap->chunks = chunks;
+	bitmap->capacity = capacity;
+	return 0;
+}
+
+/*
+ * appendBitmapChunk
+ *
+ * Syntactic Specification:
+ * int appendBitmapChunk(ActivityBitmap bitmap, BitmapChunk* chunk);
+ *
+ * Semantic Specification:
+ * Moves a chunk (just computed by an operation, with key greater than all the others) at the end of the set.
+ * Empty chunks are not added.
+ *
+ * Preconditions:
+ * - 'bitmap != NULL', 'chunk != NULL'
+ *
+ * Postconditions:
+ * - Returns 0 on success, 1 if memory allocation fails (the chunk is freed)
+ *
+ * Side Effects:
+ * - May reallocate the array of the chunks
+ */
+int appendBitmapChunk(ActivityBitmap bitmap, BitmapChunk* chunk) {
+	if (chunk->cardinality == 0) return 0;
+
+	if (reserveBitmapChunks(bitmap, bitmap->count + 1) != 0) {
+		freeBitmapChunk(chunk);
+		return 1;
+	}
+
+	bitmap->chunks[bitmap->count++] = *chunk;
+	return 0;
+}
+
+
+
+/*
+ * newActivityBitmap
+ *
+ * Syntactic Specification:
+ * ActivityBitmap newActivityBitmap(void);
+ *
+ * Semantic Specification:
+ * Creates a new empty set of activity ids.
+ * The ids are split in chunks of 65536 by their high 16 bits (Roaring-style): a chunk with few ids
+ * keeps them in a sorted array of 16 bit values, a dense chunk keeps them in a bitmap of 1024 words,
+ * so that two sets can be combined a word (64 ids) at a time.
+ *
+ * Preconditions:
+ * - None
+ *
+ * Postconditions:
+ * - Returns a new empty set
+ * - If allocation fails, returns 'NULL'
+ *
+ * Side Effects:
+ * - Allocates memory
+ */
+ActivityBitmap newActivityBitmap(void) {
+	ActivityBitmap bitmap = malloc(sizeof(struct activityBitmap));
+	if (bitmap == NULL) return NULL;
+
+	bitmap->chunks = NULL;
+	bitmap->count = 0;
+	bitmap->capacity = 0;
+	return bitmap;
+}
+
+/*
+ * deleteActivityBitmap
+ *
+ * Syntactic Specification:
+ * void deleteActivityBitmap(ActivityBitmap* bitmap);
+ *
+ * Semantic Specification:
+ * Deallocates the set. The parameter is a pointer passed by reference.
+ *
+ * Preconditions:
+ * - 'bitmap' can be NULL or point to a valid/NULL pointer
+ *
+ * Postconditions:
+ * - All the memory of the set is freed and '*bitmap' is set to NULL
+ *
+ * Side Effects:
+ * - Deallocates memory
+ */
+void deleteActivityBitmap(ActivityBitmap* bitmap) {
+	if (bitmap == NULL || *bitmap == NULL) return;
+
+	for (int i = 0; i < (*bitmap)->count; i++) {
+		freeBitmapChunk(&(*bitmap)->chunks[i]);
+	}
+	free((*bitmap)->chunks);
+	free(*bitmap);
+	*bitmap = NULL;
+}
+
+/*
+ * addIdToActivityBitmap
+ *
+ * Syntactic Specification:
+ * int addIdToActivityBitmap(ActivityBitmap bitmap, int activityId);
+ *
+ * Semantic Specification:
+ * Adds an activity id to the set (nothing changes if it is already there).
+ * Adding the ids in increasing order (e.g. visiting the tree in order) only appends to the last chunk.
+ *
+ * Preconditions:
+ * - 'bitmap != NULL', 'activityId >= 0'
+ *
+ * Postconditions:
+ * - Returns 0 if the id is in the set
+ * - Returns 1 if the parameters are not valid or memory allocation fails (the set is unchanged)
+ *
+ * Side Effects:
+ * - May allocate memory and modifies the set
+ */
+int addIdToActivityBitmap(ActivityBitmap bitmap, int activityId) {
+	if (bitmap == NULL || activityId < 0) return 1;
+
+	int key = activityId >> BITMAP_CHUNK_BITS;
+	int value = activityId & BITMAP_CHUNK_MASK;
+
+	int index = findBitmapChunk(bitmap, key);
+	if (index == bitmap->count || bitmap->chunks[index].key != key) {
+		if (reserveBitmapChunks(bitmap, bitmap->count + 1) != 0) return 1;
+
+		unsigned short* values = malloc(4 * sizeof(unsigned short));
+		if (values == NULL) return 1;
+
+		memmove(&bitmap->chunks[index + 1], &bitmap->chunks[index], (bitmap->count - index) * sizeof(BitmapChunk));
+		bitmap->chunks[index] = (BitmapChunk){ key, 1, 4, values, NULL };
+		values[0] = (unsigned short)value;
+		bitmap->count++;
+		return 0;
+	}
+
+	BitmapChunk* chunk = &bitmap->chunks[index];
+
+	if (chunk->words != NULL) {
+		uint64_t mask = (uint64_t)1 << (value & 63);
+		if ((chunk->words[value >> 6] & mask) == 0) {
+			chunk->words[value >> 6] |= mask;
+			chunk->cardinality++;
+		}
+		return 0;
+	}
+
+	int position = findValueInArrayChunk(chunk, value);
+	if (position < chunk->cardinality && chunk->values[position] == value) return 0;
+
+	if (chunk->cardinality == BITMAP_ARRAY_MAX_CARDINALITY) {
+		if (convertArrayChunkToWords(chunk) != 0) return 1;
+		chunk->words[value >> 6] |= (uint64_t)1 << (value & 63);
+		chunk->cardinality++;
+		return 0;
+	}
+
+	if (chunk->cardinality == chunk->capacity) {
+		int capacity = chunk->capacity * 2;
+		if (capacity > BITMAP_ARRAY_MAX_CARDINALITY) capacity = BITMAP_ARRAY_MAX_CARDINALITY;
+
+		unsigned short* values = realloc(chunk->values, capacity * sizeof(unsigned short));
+		if (values == NULL) return 1;
+		chunk->values = values;
+		chunk->capacity = capacity;
+	}
+
+	memmove(&chunk->values[position + 1], &chunk->values[position], (chunk->cardinality - position) * sizeof(unsigned short));
+	chunk->values[position] = (unsigned short)value;
+	chunk->cardinality++;
+	return 0;
+}
+
+/*
+ * isIdInActivityBitmap
+ *
+ * Syntactic Specification:
+ * int isIdInActivityBitmap(ActivityBitmap bitmap, int activityId);
+ *
+ * Semantic Specification:
+ * Checks if an activity id is in the set.
+ *
+ * Preconditions:
+ * - None
+ *
+ * Postconditions:
+ * - Returns 1 if the id is in the set, 0 otherwise (or if 'bitmap == NULL')
+ *
+ * Side Effects:
+ * - None
+ */
+int isIdInActivityBitmap(ActivityBitmap bitmap, int activityId) {
+	if (bitmap == NULL || activityId < 0) return 0;
+
+	int key = activityId >> BITMAP_CHUNK_BITS;
+	int index = findBitmapChunk(bitmap, key);
+	if (index == bitmap->count || bitmap->chunks[index].key != key) return 0;
+
+	return isValueInBitmapChunk(&bitmap->chunks[index], activityId & BITMAP_CHUNK_MASK);
+}
+
+/*
+ * getActivityBitmapCardinality
+ *
+ * Syntactic Specification:
+ * int getActivityBitmapCardinality(ActivityBitmap bitmap);
+ *
+ * Semantic Specification:
+ * Returns the number of ids in the set (kept per chunk, it is not recounted).
+ *
+ * Preconditions:
+ * - None
+ *
+ * Postconditions:
+ * - Returns the number of ids (0 if 'bitmap == NULL')
+ *
+ * Side Effects:
+ * - None
+ */
+int getActivityBitmapCardinality(ActivityBitmap bitmap) {
+	if (bitmap == NULL) return 0;
+
+	int cardinality = 0;
+	for (int i = 0; i < bitmap->count; i++) {
+		cardinality += bitmap->chunks[i].cardinality;
+	}
+
+	return cardinality;
+}
+
+/*
+ * getNextIdInActivityBitmap
+ *
+ * Syntactic Specification:
+ * int getNextIdInActivityBitmap(ActivityBitmap bitmap, int fromId);
+ *
+ * Semantic Specification:
+ * Returns the smallest id of the set greater than or equal to 'fromId'. Starting from 0 and then
+ * passing the last returned id + 1, the ids of the set are visited in increasing order.
+ *
+ * Preconditions:
+ * - None
+ *
+ * Postconditions:
+ * - Returns the id, or -1 if there are no more ids (or 'bitmap == NULL')
+ *
+ * Side Effects:
+ * - None
+ */
+int getNextIdInActivityBitmap(ActivityBitmap bitmap, int fromId) {
+	if (bitmap == NULL) return -1;
+	if (fromId < 0) fromId = 0;
+
+	int key = fromId >> BITMAP_CHUNK_BITS;
+	for (int index = findBitmapChunk(bitmap, key); index < bitmap->count; index++) {
+		const BitmapChunk* chunk = &bitmap->chunks[index];
+		int from = (chunk->key == key) ? (fromId & BITMAP_CHUNK_MASK) : 0;
+
+		if (chunk->words != NULL) {
+			int wordIndex = from >> 6;
+			uint64_t word = chunk->words[wordIndex] & (~(uint64_t)0 << (from & 63));
+			while (word == 0 && ++wordIndex < BITMAP_CHUNK_WORDS) {
+				word = chunk->words[wordIndex];
+			}
+			if (word != 0) return (chunk->key << BITMAP_CHUNK_BITS) | ((wordIndex << 6) + __builtin_ctzll(word));
+		} else {
+			int position = findValueInArrayChunk(chunk, from);
+			if (position < chunk->cardinality) return (chunk->key << BITMAP_CHUNK_BITS) | chunk->values[position];
+		}
+	}
+
+	return -1;
+}
+
+/*
+ * andActivityBitmaps
+ *
+ * Syntactic Specification:
+ * ActivityBitmap andActivityBitmaps(ActivityBitmap a, ActivityBitmap b);
+ *
+ * Semantic Specification:
+ * Returns a new set with the ids that are both in 'a' and in 'b' (intersection).
+ *
+ * Preconditions:
+ * - 'a != NULL', 'b != NULL'
+ *
+ * Postconditions:
+ * - Returns the new set (the operands are unchanged)
+ * - Returns 'NULL' if an operand is NULL or memory allocation fails
+ *
+ * Side Effects:
+ * - Allocates memory
+ */
+ActivityBitmap andActivityBitmaps(ActivityBitmap a, ActivityBitmap b) {
+	if (a == NULL || b == NULL) return NULL;
+
+	ActivityBitmap result = newActivityBitmap();
+	if (result == NULL) return NULL;
+
+	int i = 0, j = 0;
+	while (i < a->count && j < b->count) {
+		if (a->chunks[i].key < b->chunks[j].key) i++;
+		else if (a->chunks[i].key > b->chunks[j].key) j++;
+		else {
+			BitmapChunk chunk;
+			if (andBitmapChunks(&a->chunks[i], &b->chunks[j], &chunk) != 0 || appendBitmapChunk(result, &chunk) != 0) {
+				deleteActivityBitmap(&result);
+				return NULL;
+			}
+			i++;
+			j++;
+		}
+	}
+
+	return result;
+}
+
+/*
+ * orActivityBitmaps
+ *
+ * Syntactic Specification:
+ * ActivityBitmap orActivityBitmaps(ActivityBitmap a, ActivityBitmap b);
+ *
+ * Semantic Specification:
+ * Returns a new set with the ids that are in 'a' or in 'b' (union).
+ *
+ * Preconditions:
+ * - 'a != NULL', 'b != NULL'
+ *
+ * Postconditions:
+ * - Returns the new set (the operands are unchanged)
+ * - Returns 'NULL' if an operand is NULL or memory allocation fails
+ *
+ * Side Effects:
+ * - Allocates memory
+ */
+ActivityBitmap orActivityBitmaps(ActivityBitmap a, ActivityBitmap b) {
+	if (a == NULL || b == NULL) return NULL;
+
+	ActivityBitmap result = newActivityBitmap();
+	if (result == NULL) return NULL;
+
+	int i = 0, j = 0;
+	while (i < a->count || j < b->count) {
+		BitmapChunk chunk;
+		int error;
+		if (j >= b->count || (i < a->count && a->chunks[i].key < b->chunks[j].key)) {
+			error = copyBitmapChunk(&a->chunks[i++], &chunk);
+		} else if (i >= a->count || b->chunks[j].key < a->chunks[i].key) {
+			error = copyBitmapChunk(&b->chunks[j++], &chunk);
+		} else {
+			error = orBitmapChunks(&a->chunks[i++], &b->chunks[j++], &chunk);
+		}
+
+		if (error != 0 || appendBitmapChunk(result, &chunk) != 0) {
+			freeBitmapChunk(&chunk);
+			deleteActivityBitmap(&result);
+			return NULL;
+		}
+	}
+
+	return result;
+}
+
+/*
+ * andNotActivityBitmaps
+ *
+ * Syntactic Specification:
+ * ActivityBitmap andNotActivityBitmaps(ActivityBitmap a, ActivityBitmap b);
+ *
+ * Semantic Specification:
+ * Returns a new set with the ids that are in 'a' but not in 'b' (difference).
+ *
+ * Preconditions:
+ * - 'a != NULL', 'b != NULL'
+ *
+ * Postconditions:
+ * - Returns the new set (the operands are unchanged)
+ * - Returns 'NULL' if an operand is NULL or memory allocation fails
+ *
+ * Side Effects:
+ * - Allocates memory
+ */
+ActivityBitmap andNotActivityBitmaps(ActivityBitmap a, ActivityBitmap b) {
+	if (a == NULL || b == NULL) return NULL;
+
+	ActivityBitmap result = newActivityBitmap();
+	if (result == NULL) return NULL;
+
+	int j = 0;
+	for (int i = 0; i < a->count; i++) {
+		while (j < b->count && b->chunks[j].key < a->chunks[i].key) j++;
+
+		BitmapChunk chunk;
+		int error;
+		if (j < b->count && b->chunks[j].key == a->chunks[i].key) {
+			error = andNotBitmapChunks(&a->chunks[i], &b->chunks[j], &chunk);
+		} else {
+			error = copyBitmapChunk(&a->chunks[i], &chunk);
+		}
+
+		if (error != 0 || appendBitmapChunk(result, &chunk) != 0) {
+			freeBitmapChunk(&chunk);
+			deleteActivityBitmap(&result);
+			return NULL;
+		}
+	}
+
+	return result;
+}
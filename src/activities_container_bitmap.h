@@ -0,0 +1,198 @@
+#ifndef ACTIVITIES_CONTAINER_BITMAP_H             // Start of inclusion block
+#define ACTIVITIES_CONTAINER_BITMAP_H             // Macro definition to avoid multiple inclusions
+
+// Declare an opaque type for a compressed set of activity ids (result set of a filter, of a report bucket, ...)
+typedef struct activityBitmap* ActivityBitmap;
+
+
+/*
+ * newActivityBitmap
+ *
+ * Syntactic Specification:
+ * ActivityBitmap newActivityBitmap(void);
+ *
+ * Semantic Specification:
+ * Creates a new empty set of activity ids.
+ * The ids are split in chunks of 65536 by their high 16 bits (Roaring-style): a chunk with few ids
+ * keeps them in a sorted array of 16 bit values, a dense chunk keeps them in a bitmap of 1024 words,
+ * so that two sets can be combined a word (64 ids) at a time.
+ *
+ * Preconditions:
+ * - None
+ *
+ * Postconditions:
+ * - Returns a new empty set
+ * - If allocation fails, returns 'NULL'
+ *
+ * Side Effects:
+ * - Allocates memory
+ */
+ActivityBitmap newActivityBitmap(void);
+
+/*
+ * deleteActivityBitmap
+ *
+ * Syntactic Specification:
+ * void deleteActivityBitmap(ActivityBitmap* bitmap);
+ *
+ * Semantic Specification:
+ * Deallocates the set. The parameter is a pointer passed by reference.
+ *
+ * Preconditions:
+ * - 'bitmap' can be NULL or point to a valid/NULL pointer
+ *
+ * Postconditions:
+ * - All the memory of the set is freed and '*bitmap' is set to NULL
+ *
+ * Side Effects:
+ * - Deallocates memory
+ */
+void deleteActivityBitmap(ActivityBitmap* bitmap);
+
+/*
+ * addIdToActivityBitmap
+ *
+ * Syntactic Specification:
+ * int addIdToActivityBitmap(ActivityBitmap bitmap, int activityId);
+ *
+ * Semantic Specification:
+ * Adds an activity id to the set (nothing changes if it is already there).
+ * Adding the ids in increasing order (e.g. visiting the tree in order) only appends to the last chunk.
+ *
+ * Preconditions:
+ * - 'bitmap != NULL', 'activityId >= 0'
+ *
+ * Postconditions:
+ * - Returns 0 if the id is in the set
+ * - Returns 1 if the parameters are not valid or memory allocation fails (the set is unchanged)
+ *
+ * Side Effects:
+ * - May allocate memory and modifies the set
+ */
+int addIdToActivityBitmap(ActivityBitmap bitmap, int activityId);
+
+/*
+ * isIdInActivityBitmap
+ *
+ * Syntactic Specification:
+ * int isIdInActivityBitmap(ActivityBitmap bitmap, int activityId);
+ *
+ * Semantic Specification:
+ * Checks if an activity id is in the set.
+ *
+ * Preconditions:
+ * - None
+ *
+ * Postconditions:
+ * - Returns 1 if the id is in the set, 0 otherwise (or if 'bitmap == NULL')
+ *
+ * Side Effects:
+ * - None
+ */
+int isIdInActivityBitmap(ActivityBitmap bitmap, int activityId);
+
+/*
+ * getActivityBitmapCardinality
+ *
+ * Syntactic Specification:
+ * int getActivityBitmapCardinality(ActivityBitmap bitmap);
+ *
+ * Semantic Specification:
+ * Returns the number of ids in the set (kept per chunk, it is not recounted).
+ *
+ * Preconditions:
+ * - None
+ *
+ * Postconditions:
+ * - Returns the number of ids (0 if 'bitmap == NULL')
+ *
+ * Side Effects:
+ * - None
+ */
+int getActivityBitmapCardinality(ActivityBitmap bitmap);
+
+/*
+ * getNextIdInActivityBitmap
+ *
+ * Syntactic Specification:
+ * int getNextIdInActivityBitmap(ActivityBitmap bitmap, int fromId);
+ *
+ * Semantic Specification:
+ * Returns the smallest id of the set greater than or equal to 'fromId'. Starting from 0 and then
+ * passing the last returned id + 1, the ids of the set are visited in increasing order.
+ *
+ * Preconditions:
+ * - None
+ *
+ * Postconditions:
+ * - Returns the id, or -1 if there are no more ids (or 'bitmap == NULL')
+ *
+ * Side Effects:
+ * - None
+ */
+int getNextIdInActivityBitmap(ActivityBitmap bitmap, int fromId);
+
+/*
+ * andActivityBitmaps
+ *
+ * Syntactic Specification:
+ * ActivityBitmap andActivityBitmaps(ActivityBitmap a, ActivityBitmap b);
+ *
+ * Semantic Specification:
+ * Returns a new set with the ids that are both in 'a' and in 'b' (intersection).
+ *
+ * Preconditions:
+ * - 'a != NULL', 'b != NULL'
+ *
+ * Postconditions:
+ * - Returns the new set (the operands are unchanged)
+ * - Returns 'NULL' if an operand is NULL or memory allocation fails
+ *
+ * Side Effects:
+ * - Allocates memory
+ */
+ActivityBitmap andActivityBitmaps(ActivityBitmap a, ActivityBitmap b);
+
+/*
+ * orActivityBitmaps
+ *
+ * Syntactic Specification:
+ * ActivityBitmap orActivityBitmaps(ActivityBitmap a, ActivityBitmap b);
+ *
+ * Semantic Specification:
+ * Returns a new set with the ids that are in 'a' or in 'b' (union).
+ *
+ * Preconditions:
+ * - 'a != NULL', 'b != NULL'
+ *
+ * Postconditions:
+ * - Returns the new set (the operands are unchanged)
+ * - Returns 'NULL' if an operand is NULL or memory allocation fails
+ *
+ * Side Effects:
+ * - Allocates memory
+ */
+ActivityBitmap orActivityBitmaps(ActivityBitmap a, ActivityBitmap b);
+
+/*
+ * andNotActivityBitmaps
+ *
+ * Syntactic Specification:
+ * ActivityBitmap andNotActivityBitmaps(ActivityBitmap a, ActivityBitmap b);
+ *
+ * Semantic Specification:
+ * Returns a new set with the ids that are in 'a' but not in 'b' (difference).
+ *
+ * Preconditions:
+ * - 'a != NULL', 'b != NULL'
+ *
+ * Postconditions:
+ * - Returns the new set (the operands are unchanged)
+ * - Returns 'NULL' if an operand is NULL or memory allocation fails
+ *
+ * Side Effects:
+ * - Allocates memory
+ */
+ActivityBitmap andNotActivityBitmaps(ActivityBitmap a, ActivityBitmap b);
+
+#endif // ACTIVITIES_CONTAINER_BITMAP_H          // End of inclusion block
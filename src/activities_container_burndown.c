@@ -0,0 +1,241 @@
+#include <stdlib.h>
+#include "activity.h"
+#include "activity_helper.h"
+#include "activities_container_burndown.h"
+
+
+/*
+ * "struct burndownEvent" Documentation
+ *
+ * Syntactic Specification:
+ * typedef struct burndownEvent {
+ *     time_t date;
+ *     unsigned int remainingTime;
+ * } BurndownEvent;
+ *
+ * Semantic Specification:
+ * An activity entering (insert) or leaving (completion) the set of open activities.
+ *
+ * Fields:
+ * - date: When the event happens
+ * - remainingTime: Remaining minutes of the activity (totalTime - usedTime, 0 if negative)
+ */
+typedef struct burndownEvent {
+	time_t date;
+	unsigned int remainingTime;
+} BurndownEvent;
+
+
+
+/*
+ * compareBurndownEventsByDate
+ *
+ * Syntactic Specification:
+ * int compareBurndownEventsByDate(const void* a, const void* b);
+ *
+ * Semantic Specification:
+ * Comparator for qsort(): orders two burndown events by date.
+ *
+ * Preconditions:
+ * - 'a' and 'b' must point to valid BurndownEvent
+ *
+ * Postconditions:
+ * - Returns a negative value, 0 or a positive value if 'a' is before, at the same date or after 'b'
+ *
+ * Side Effects:
+ * - None
+ */
+int compareBurndownEventsByDate(const void* a, const void* b) {
+	time_t dateA = ((const BurndownEvent*)a)->date;
+	time_t dateB = ((const BurndownEvent*)b)->date;
+
+	return (dateA > dateB) - (dateA < dateB);
+}
+
+/*
+ * inOrderCollectBurndownEvents
+ *
+ * Syntactic Specification:
+ * void inOrderCollectBurndownEvents(TreeNode root, BurndownEvent* insertEvents, int* insertCount, BurndownEvent* completionEvents, int* completionCount);
+ *
+ * Semantic Specification:
+ * Recursively appends, for each activity of the tree, its insert event and (if completed) its completion event.
+ *
+ * Preconditions:
+ * - The arrays must have room for all the activities of the tree
+ *
+ * Postconditions:
+ * - '*insertCount' and '*completionCount' are incremented by the number of events appended
+ *
+ * Side Effects:
+ * - Modifies the arrays and the counters
+ */
+void inOrderCollectBurndownEvents(TreeNode root, BurndownEvent* insertEvents, int* insertCount, BurndownEvent* completionEvents, int* completionCount) {
+	if (root == NULL) return;
+
+	inOrderCollectBurndownEvents(getLeftNode(root), insertEvents, insertCount, completionEvents, completionCount);
+
+	Activity a = getActivityFromNode(root);
+	if (a != NULL) {
+		unsigned int totalTime = getActivityTotalTime(a);
+		unsigned int usedTime = getActivityUsedTime(a);
+		time_t insertDate = getActivityInsertDate(a);
+
+		BurndownEvent event;
+		event.date = insertDate;
+		event.remainingTime = (totalTime > usedTime) ? totalTime - usedTime : 0;
+		insertEvents[(*insertCount)++] = event;
+
+		if (isActivityCompleted(a) == 1) {
+			time_t completionDate = getActivityCompletionDate(a);
+			// An activity can't be closed before being open
+			event.date = (completionDate > insertDate) ? completionDate : insertDate;
+			completionEvents[(*completionCount)++] = event;
+		}
+	}
+
+	inOrderCollectBurndownEvents(getRightNode(root), insertEvents, insertCount, completionEvents, completionCount);
+}
+
+
+/*
+ * printTreeActivitiesBurndownToFile
+ *
+ * Syntactic Specification:
+ * int printTreeActivitiesBurndownToFile(TreeNode root, time_t fromDate, time_t toDate, FILE* file);
+ *
+ * Semantic Specification:
+ * Writes to file, in CSV format, the burndown time series of the tree activities: one row for each
+ * calendar day (local time) from the day of 'fromDate' to the day of 'toDate', with the number of
+ * activities completed up to the end of the day, the number of activities still open at the end
+ * of the day and their remaining minutes (totalTime - usedTime).
+ *
+ * Preconditions:
+ * - 'file' must be opened for writing
+ * - 'fromDate <= toDate'
+ *
+ * Postconditions:
+ * - If 'file == NULL', 'fromDate > toDate' or memory allocation fails, returns 1 (error)
+ * - Otherwise writes the header and one row per day, and returns 0 (success)
+ *
+ * Side Effects:
+ * - Writing to file
+ * - Allocates and deallocates temporary arrays
+ *
+ * Notes:
+ * - Insert and completion dates are sorted once and swept together with the day boundaries:
+ *   the cost is O(n log n + days), not O(n * days)
+ * - Activities inserted before 'fromDate' are counted from the first row
+ * - An activity counts as completed from max(insertDate, completionDate)
+ */
+int printTreeActivitiesBurndownToFile(TreeNode root, time_t fromDate, time_t toDate, FILE* file) {
+	if (file == NULL || fromDate > toDate) return 1;
+
+	int count = countTreeActivities(root);
+	BurndownEvent* insertEvents = (BurndownEvent*)malloc( (count > 0 ? count : 1) * sizeof(BurndownEvent) );
+	BurndownEvent* completionEvents = (BurndownEvent*)malloc( (count > 0 ? count : 1) * sizeof(BurndownEvent) );
+	if (insertEvents == NULL || completionEvents == NULL) {
+		free(insertEvents);
+		free(completionEvents);
+		return 1;
+	}
+
+	int insertCount = 0;
+	int completionCount = 0;
+	inOrderCollectBurndownEvents(root, insertEvents, &insertCount, completionEvents, &completionCount);
+
+	qsort(insertEvents, insertCount, sizeof(BurndownEvent), compareBurndownEventsByDate);
+	qsort(completionEvents, completionCount, sizeof(BurndownEvent), compareBurndownEventsByDate);
+
+	// Local midnight of the first day: localtime()/mktime() are called once per day, never per activity
+	struct tm day = *localtime(&fromDate);
+	day.tm_hour = 0;
+	day.tm_min = 0;
+	day.tm_sec = 0;
+	day.tm_isdst = -1;
+	time_t dayBegin = mktime(&day);
+
+	int insertIndex = 0;
+	int completionIndex = 0;
+	int completedActivities = 0;
+	int openActivities = 0;
+	unsigned long remainingTime = 0;
+
+	fprintf(file, "data,completate,aperte,minuti_rimanenti\n");
+
+	while (dayBegin <= toDate) {
+		int year = day.tm_year + 1900;
+		int month = day.tm_mon + 1;
+		int dayOfMonth = day.tm_mday;
+
+		// Next local midnight (mktime normalizes the day and handles DST changes)
+		day.tm_mday++;
+		day.tm_hour = 0;
+		day.tm_min = 0;
+		day.tm_sec = 0;
+		day.tm_isdst = -1;
+		time_t dayEnd = mktime(&day);
+		if (dayEnd <= dayBegin) break; // time_t overflow
+
+		while (insertIndex < insertCount && insertEvents[insertIndex].date < dayEnd) {
+			openActivities++;
+			remainingTime += insertEvents[insertIndex].remainingTime;
+			insertIndex++;
+		}
+
+		while (completionIndex < completionCount && completionEvents[completionIndex].date < dayEnd) {
+			completedActivities++;
+			openActivities--;
+			remainingTime -= completionEvents[completionIndex].remainingTime;
+			completionIndex++;
+		}
+
+		fprintf(file, "%04d-%02d-%02d,%d,%d,%lu\n", year, month, dayOfMonth, completedActivities, openActivities, remainingTime);
+
+		dayBegin = dayEnd;
+	}
+
+	free(insertEvents);
+	free(completionEvents);
+	return 0;
+}
+
+/*
+ * saveActivitiesBurndownFromTreeToFile
+ *
+ * Syntactic Specification:
+ * int saveActivitiesBurndownFromTreeToFile(const char* filename, TreeNode root, time_t fromDate, time_t toDate);
+ *
+ * Semantic Specification:
+ * Saves the burndown time series (CSV) of the tree activities to a file.
+ *
+ * Preconditions:
+ * - 'fromDate <= toDate'
+ *
+ * Postconditions:
+ * - If 'filename == NULL' or unable to open the file, returns 1 (error)
+ * - Otherwise returns the result of 'printTreeActivitiesBurndownToFile()'
+ *
+ * Side Effects:
+ * - File opening and writing
+ * - Output to stdout (informational messages)
+ */
+int saveActivitiesBurndownFromTreeToFile(const char* filename, TreeNode root, time_t fromDate, time_t toDate) {
+	if (filename == NULL) return 1;
+
+	FILE* file = fopen(filename, "w");
+	if (file == NULL) {
+		printf("Errore nell'apertura del file %s per la scrittura.\n", filename);
+		return 1;
+	}
+
+	int result = printTreeActivitiesBurndownToFile(root, fromDate, toDate, file);
+
+	fclose(file);
+	if (result == 0) {
+		printf("Burndown salvato con successo nel file %s\n", filename);
+	} else {
+		printf("Errore nel calcolo del burndown.\n");
+	}
+	return result;
+}
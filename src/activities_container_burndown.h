@@ -0,0 +1,63 @@
+#ifndef ACTIVITIES_CONTAINER_BURNDOWN_H             // Start of inclusion block
+#define ACTIVITIES_CONTAINER_BURNDOWN_H             // Macro definition to avoid multiple inclusions
+
+#include <stdio.h>
+#include <time.h>
+#include "activities_container_avl.h"
+
+
+/*
+ * printTreeActivitiesBurndownToFile
+ *
+ * Syntactic Specification:
+ * int printTreeActivitiesBurndownToFile(TreeNode root, time_t fromDate, time_t toDate, FILE* file);
+ *
+ * Semantic Specification:
+ * Writes to file, in CSV format, the burndown time series of the tree activities: one row for each
+ * calendar day (local time) from the day of 'fromDate' to the day of 'toDate', with the number of
+ * activities completed up to the end of the day, the number of activities still open at the end
+ * of the day and their remaining minutes (totalTime - usedTime).
+ *
+ * Preconditions:
+ * - 'file' must be opened for writing
+ * - 'fromDate <= toDate'
+ *
+ * Postconditions:
+ * - If 'file == NULL', 'fromDate > toDate' or memory allocation fails, returns 1 (error)
+ * - Otherwise writes the header and one row per day, and returns 0 (success)
+ *
+ * Side Effects:
+ * - Writing to file
+ * - Allocates and deallocates temporary arrays
+ *
+ * Notes:
+ * - Insert and completion dates are sorted once and swept together with the day boundaries:
+ *   the cost is O(n log n + days), not O(n * days)
+ * - Activities inserted before 'fromDate' are counted from the first row
+ * - An activity counts as completed from max(insertDate, completionDate)
+ */
+int printTreeActivitiesBurndownToFile(TreeNode root, time_t fromDate, time_t toDate, FILE* file);
+
+/*
+ * saveActivitiesBurndownFromTreeToFile
+ *
+ * Syntactic Specification:
+ * int saveActivitiesBurndownFromTreeToFile(const char* filename, TreeNode root, time_t fromDate, time_t toDate);
+ *
+ * Semantic Specification:
+ * Saves the burndown time series (CSV) of the tree activities to a file.
+ *
+ * Preconditions:
+ * - 'fromDate <= toDate'
+ *
+ * Postconditions:
+ * - If 'filename == NULL' or unable to open the file, returns 1 (error)
+ * - Otherwise returns the result of 'printTreeActivitiesBurndownToFile()'
+ *
+ * Side Effects:
+ * - File opening and writing
+ * - Output to stdout (informational messages)
+ */
+int saveActivitiesBurndownFromTreeToFile(const char* filename, TreeNode root, time_t fromDate, time_t toDate);
+
+#endif // ACTIVITIES_CONTAINER_BURNDOWN_H          // End of inclusion block
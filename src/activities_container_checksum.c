@@ -0,0 +1,774 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include "activities_container_checksum.h"
+#include "activities_container_writer.h"
+
+// Byte order mark of the header (see ACTIVITY_SNAPSHOT_BYTE_ORDER_MARK)
+#define ACTIVITY_CHECKSUM_BYTE_ORDER_MARK 0x01020304u
+// Castagnoli polynomial, in the reversed bit order of the table-driven implementation
+#define CRC32C_POLYNOMIAL 0x82F63B78u
+// Bytes read at a time by 'verifyActivityChecksums()' (a whole number of blocks)
+#define ACTIVITY_CHECKSUM_READ_SIZE (16 * ACTIVITY_CHECKSUM_BLOCK_SIZE)
+
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(ACTIVITY_CHECKSUM_NO_HARDWARE)
+#define ACTIVITY_CHECKSUM_HARDWARE 1
+#endif
+
+
+/*
+ * "struct checksumHeader" Documentation
+ *
+ * Syntactic Specification:
+ * typedef struct checksumHeader {
+ *     char magic[8];
+ *     uint32_t version;
+ *     uint32_t byteOrderMark;
+ *     uint32_t blockSize;
+ *     uint32_t reserved;
+ *     uint64_t fileSize;
+ * } ChecksumHeader;
+ *
+ * Semantic Specification:
+ * Header at the beginning of a checksum file (32 bytes, no padding).
+ *
+ * Fields:
+ * - magic: ACTIVITY_CHECKSUM_MAGIC, padded with '\0'
+ * - version: ACTIVITY_CHECKSUM_VERSION
+ * - byteOrderMark: ACTIVITY_CHECKSUM_BYTE_ORDER_MARK
+ * - blockSize: ACTIVITY_CHECKSUM_BLOCK_SIZE
+ * - reserved: 0
+ * - fileSize: Size in bytes of the file checksummed
+ */
+typedef struct checksumHeader {
+	char magic[8];
+	uint32_t version;
+	uint32_t byteOrderMark;
+	uint32_t blockSize;
+	uint32_t reserved;
+	uint64_t fileSize;
+} ChecksumHeader;
+
+
+/*
+ * "struct activityChecksums" Documentation
+ *
+ * Syntactic Specification:
+ * struct activityChecksums {
+ *     uint32_t* crcs;
+ *     size_t count;
+ *     size_t capacity;
+ *     uint32_t current;
+ *     size_t currentSize;
+ *     uint64_t fileSize;
+ *     int failed;
+ * };
+ *
+ * Semantic Specification:
+ * The CRC32C of the blocks of a file, computed while it's written (or read again).
+ *
+ * Fields:
+ * - crcs, count, capacity: The CRC32C of the complete blocks
+ * - current, currentSize: CRC32C and number of bytes of the block being filled
+ * - fileSize: Number of bytes added
+ * - failed: 1 if memory allocation has failed (the checksums are not complete)
+ */
+struct activityChecksums {
+	uint32_t* crcs;
+	size_t count;
+	size_t capacity;
+	uint32_t current;
+	size_t currentSize;
+	uint64_t fileSize;
+	int failed;
+};
+
+
+// Tables of the slicing-by-8 implementation: crc32cTables[k][b] is the CRC of byte b followed by k zero bytes
+uint32_t crc32cTables[8][256];
+// 1 if the processor has the crc32 instruction (SSE4.2)
+int hasCrc32cInstruction = 0;
+// Initialization of the tables and of 'hasCrc32cInstruction', done once
+pthread_once_t crc32cInitialization = PTHREAD_ONCE_INIT;
+
+
+/*
+ * initializeCrc32c
+ *
+ * Syntactic Specification:
+ * void initializeCrc32c(void);
+ *
+ * Semantic Specification:
+ * Fills the slicing-by-8 tables and checks if the processor has the crc32 instruction.
+ * Called once through 'pthread_once()'.
+ *
+ * Preconditions:
+ * - None
+ *
+ * Postconditions:
+ * - 'crc32cTables' and 'hasCrc32cInstruction' are set
+ *
+ * Side Effects:
+ * - Modifies the global tables
+ */
+void initializeCrc32c(void) {
+	for (uint32_t b = 0; b < 256; b++) {
+		uint32_t crc = b;
+		for (int bit = 0; bit < 8; bit++) {
+			crc = (crc & 1) ? (crc >> 1) ^ CRC32C_POLYNOMIAL : crc >> 1;
+		}
+		crc32cTables[0][b] = crc;
+	}
+	for (uint32_t b = 0; b < 256; b++) {
+		for (int k = 1; k < 8; k++) {
+			uint32_t previous = crc32cTables[k-1][b];
+			crc32cTables[k][b] = (previous >> 8) ^ crc32cTables[0][previous & 0xff];
+		}
+	}
+
+#ifdef ACTIVITY_CHECKSUM_HARDWARE
+	__builtin_cpu_init();
+	hasCrc32cInstruction = __builtin_cpu_supports("sse4.2") ? 1 : 0;
+#endif
+}
+
+/*
+ * computeCrc32cSoftware
+ *
+ * Syntactic Specification:
+ * uint32_t computeCrc32cSoftware(uint32_t crc, const void* data, size_t size);
+ *
+ * Semantic Specification:
+ * The slicing-by-8 implementation of 'computeCrc32c()', used when the processor has no crc32 instruction.
+ *
+ * Preconditions:
+ * - The same of 'computeCrc32c()'
+ *
+ * Postconditions:
+ * - The same of 'computeCrc32c()'
+ *
+ * Side Effects:
+ * - The first call fills the tables
+ */
+uint32_t computeCrc32cSoftware(uint32_t crc, const void* data, size_t size) {
+	pthread_once(&crc32cInitialization, initializeCrc32c);
+
+	const unsigned char* bytes = data;
+	uint32_t state = ~crc;
+
+	// 8 bytes at a time: the first 4 are combined with the state, all 8 looked up at once
+	while (size >= 8) {
+		uint32_t low = state ^ ((uint32_t)bytes[0] | (uint32_t)bytes[1] << 8 | (uint32_t)bytes[2] << 16 | (uint32_t)bytes[3] << 24);
+		state = crc32cTables[7][low & 0xff] ^ crc32cTables[6][(low >> 8) & 0xff] ^
+				  crc32cTables[5][(low >> 16) & 0xff] ^ crc32cTables[4][low >> 24] ^
+				  crc32cTables[3][bytes[4]] ^ crc32cTables[2][bytes[5]] ^
+				  crc32cTables[1][bytes[6]] ^ crc32cTables[0][bytes[7]];
+		bytes += 8;
+		size -= 8;
+	}
+	while (size > 0) {
+		state = (state >> 8) ^ crc32cTables[0][(state ^ *bytes) & 0xff];
+		bytes++;
+		size--;
+	}
+
+	return ~state;
+}
+
+#ifdef ACTIVITY_CHECKSUM_HARDWARE
+/*
+ * computeCrc32cHardware
+ *
+ * Syntactic Specification:
+ * uint32_t computeCrc32cHardware(uint32_t crc, const void* data, size_t size);
+ *
+ * Semantic Specification:
+ * The implementation of 'computeCrc32c()' with the crc32 instruction of SSE4.2, 8 bytes at a time
+ * (compiled for SSE4.2 whatever the build flags, called only if the processor has it).
+ *
+ * Preconditions:
+ * - The same of 'computeCrc32c()', the processor has SSE4.2
+ *
+ * Postconditions:
+ * - The same of 'computeCrc32c()'
+ *
+ * Side Effects:
+ * - None
+ */
+__attribute__((target("sse4.2")))
+uint32_t computeCrc32cHardware(uint32_t crc, const void* data, size_t size) {
+	const unsigned char* bytes = data;
+	unsigned long long state = ~crc;
+
+	while (size >= 8) {
+		unsigned long long word;
+		memcpy(&word, bytes, sizeof(word));
+		state = __builtin_ia32_crc32di(state, word);
+		bytes += 8;
+		size -= 8;
+	}
+	while (size > 0) {
+		state = __builtin_ia32_crc32qi((unsigned int)state, *bytes);
+		bytes++;
+		size--;
+	}
+
+	return ~(uint32_t)state;
+}
+#endif
+
+/*
+ * computeCrc32c
+ *
+ * Syntactic Specification:
+ * uint32_t computeCrc32c(uint32_t crc, const void* data, size_t size);
+ *
+ * Semantic Specification:
+ * Returns the CRC32C (Castagnoli polynomial, as in iSCSI and ext4) of the bytes following the ones whose
+ * CRC32C is 'crc' (0 for the first bytes): the CRC32C of a text can be computed a part at a time. On x86-64
+ * processors with SSE4.2 the crc32 instruction is used (8 bytes at a time), otherwise a table-driven
+ * implementation that reads 8 bytes at a time (slicing-by-8), with the same result. The hardware path can
+ * be left out at build time with -DACTIVITY_CHECKSUM_NO_HARDWARE.
+ *
+ * Preconditions:
+ * - 'data' has at least 'size' bytes (can be NULL if 'size == 0')
+ *
+ * Postconditions:
+ * - Returns the CRC32C (e.g. 0xE3069283 for "123456789" from 0)
+ *
+ * Side Effects:
+ * - The first call fills the tables and checks the processor
+ */
+uint32_t computeCrc32c(uint32_t crc, const void* data, size_t size) {
+	pthread_once(&crc32cInitialization, initializeCrc32c);
+
+#ifdef ACTIVITY_CHECKSUM_HARDWARE
+	if (hasCrc32cInstruction) return computeCrc32cHardware(crc, data, size);
+#endif
+
+	return computeCrc32cSoftware(crc, data, size);
+}
+
+/*
+ * getChecksumFilename
+ *
+ * Syntactic Specification:
+ * char* getChecksumFilename(const char* filename);
+ *
+ * Semantic Specification:
+ * Returns the name of the checksum file of a file ('filename' + ACTIVITY_CHECKSUM_EXTENSION).
+ *
+ * Preconditions:
+ * - 'filename != NULL'
+ *
+ * Postconditions:
+ * - Returns a new string (the caller deallocates it), NULL if memory allocation fails
+ *
+ * Side Effects:
+ * - Allocates memory
+ */
+char* getChecksumFilename(const char* filename) {
+	size_t length = strlen(filename);
+	char* checksumFilename = malloc(length + sizeof(ACTIVITY_CHECKSUM_EXTENSION));
+	if (checksumFilename == NULL) return NULL;
+
+	memcpy(checksumFilename, filename, length);
+	memcpy(checksumFilename + length, ACTIVITY_CHECKSUM_EXTENSION, sizeof(ACTIVITY_CHECKSUM_EXTENSION));
+	return checksumFilename;
+}
+
+/*
+ * newActivityChecksums
+ *
+ * Syntactic Specification:
+ * ActivityChecksums newActivityChecksums(void);
+ *
+ * Semantic Specification:
+ * Creates the checksums of a file that is going to be written from its beginning: the bytes are passed
+ * to 'addToActivityChecksums()' in the order they are written.
+ *
+ * Preconditions:
+ * - None
+ *
+ * Postconditions:
+ * - Returns the new checksums, NULL if memory allocation fails
+ *
+ * Side Effects:
+ * - Allocates memory
+ */
+ActivityChecksums newActivityChecksums(void) {
+	return calloc(1, sizeof(struct activityChecksums));
+}
+
+/*
+ * appendBlockChecksum
+ *
+ * Syntactic Specification:
+ * void appendBlockChecksum(ActivityChecksums checksums, uint32_t crc);
+ *
+ * Semantic Specification:
+ * Appends the CRC32C of a block to the checksums.
+ *
+ * Preconditions:
+ * - 'checksums != NULL'
+ *
+ * Postconditions:
+ * - The CRC32C follows the others, or 'failed' is set if memory allocation fails
+ *
+ * Side Effects:
+ * - May allocate memory
+ */
+void appendBlockChecksum(ActivityChecksums checksums, uint32_t crc) {
+	if (checksums->count == checksums->capacity) {
+		size_t capacity = (checksums->capacity > 0) ? checksums->capacity * 2 : 64;
+		uint32_t* crcs = realloc(checksums->crcs, capacity * sizeof(uint32_t));
+		if (crcs == NULL) {
+			checksums->failed = 1;
+			return;
+		}
+		checksums->crcs = crcs;
+		checksums->capacity = capacity;
+	}
+	checksums->crcs[checksums->count++] = crc;
+}
+
+/*
+ * addToActivityChecksums
+ *
+ * Syntactic Specification:
+ * void addToActivityChecksums(ActivityChecksums checksums, const void* data, size_t size);
+ *
+ * Semantic Specification:
+ * Adds the bytes that follow in the file to the CRC32C of its blocks of ACTIVITY_CHECKSUM_BLOCK_SIZE bytes.
+ *
+ * Preconditions:
+ * - 'data' has at least 'size' bytes
+ *
+ * Postconditions:
+ * - The checksums include the bytes; if memory allocation fails, 'writeActivityChecksums()' fails
+ * - No effect if 'checksums == NULL'
+ *
+ * Side Effects:
+ * - May allocate memory
+ */
+void addToActivityChecksums(ActivityChecksums checksums, const void* data, size_t size) {
+	if (checksums == NULL) return;
+
+	const unsigned char* bytes = data;
+	checksums->fileSize += size;
+	while (size > 0) {
+		size_t part = ACTIVITY_CHECKSUM_BLOCK_SIZE - checksums->currentSize;
+		if (part > size) part = size;
+
+		checksums->current = computeCrc32c(checksums->current, bytes, part);
+		checksums->currentSize += part;
+		bytes += part;
+		size -= part;
+
+		if (checksums->currentSize == ACTIVITY_CHECKSUM_BLOCK_SIZE) {
+			appendBlockChecksum(checksums, checksums->current);
+			checksums->current = 0;
+			checksums->currentSize = 0;
+		}
+	}
+}
+
+/*
+ * writeActivityChecksums
+ *
+ * Syntactic Specification:
+ * int writeActivityChecksums(ActivityChecksums checksums, const char* filename);
+ *
+ * Semantic Specification:
+ * Writes the checksum file of a file whose bytes have all been added, named 'filename' +
+ * ACTIVITY_CHECKSUM_EXTENSION:
+ * - a header: magic (8 bytes), version, byte order mark (0x01020304) and block size (32 bit), size of the
+ *   file (64 bit)
+ * - the CRC32C of every block of the file (32 bit), the last block being shorter if the size of the file
+ *   is not a multiple of the block size
+ * - the CRC32C of all the previous bytes of the checksum file (32 bit)
+ * The numbers are in the byte order of the machine, as in a binary snapshot. The checksum file is replaced
+ * only when complete (see 'commitActivityWriter()').
+ *
+ * Preconditions:
+ * - 'filename != NULL'
+ *
+ * Postconditions:
+ * - Returns 0 on success, 1 if 'checksums' is NULL, a memory allocation has failed or the checksum file
+ *   can't be written (it keeps its previous content)
+ *
+ * Side Effects:
+ * - Writing to file
+ */
+int writeActivityChecksums(ActivityChecksums checksums, const char* filename) {
+	if (checksums == NULL || filename == NULL) return 1;
+
+	// the last block, shorter than the others
+	if (checksums->currentSize > 0) {
+		appendBlockChecksum(checksums, checksums->current);
+		checksums->current = 0;
+		checksums->currentSize = 0;
+	}
+	if (checksums->failed) return 1;
+
+	char* checksumFilename = getChecksumFilename(filename);
+	if (checksumFilename == NULL) return 1;
+	ActivityWriter writer = newActivityWriter(checksumFilename);
+	free(checksumFilename);
+	if (writer == NULL) return 1;
+
+	ChecksumHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, ACTIVITY_CHECKSUM_MAGIC, sizeof(ACTIVITY_CHECKSUM_MAGIC));
+	header.version = ACTIVITY_CHECKSUM_VERSION;
+	header.byteOrderMark = ACTIVITY_CHECKSUM_BYTE_ORDER_MARK;
+	header.blockSize = ACTIVITY_CHECKSUM_BLOCK_SIZE;
+	header.fileSize = checksums->fileSize;
+
+	uint32_t crc = computeCrc32c(0, &header, sizeof(header));
+	crc = computeCrc32c(crc, checksums->crcs, checksums->count * sizeof(uint32_t));
+	writeBytesToActivityWriter(writer, &header, sizeof(header));
+	writeBytesToActivityWriter(writer, checksums->crcs, checksums->count * sizeof(uint32_t));
+	writeBytesToActivityWriter(writer, &crc, sizeof(crc));
+
+	return commitActivityWriter(&writer);
+}
+
+/*
+ * deleteActivityChecksums
+ *
+ * Syntactic Specification:
+ * void deleteActivityChecksums(ActivityChecksums* checksums);
+ *
+ * Semantic Specification:
+ * Deallocates the checksums. The parameter is a pointer passed by reference.
+ *
+ * Preconditions:
+ * - 'checksums' can be NULL or point to a valid/NULL pointer
+ *
+ * Postconditions:
+ * - '*checksums' is set to NULL
+ *
+ * Side Effects:
+ * - Deallocates memory
+ */
+void deleteActivityChecksums(ActivityChecksums* checksums) {
+	if (checksums == NULL || *checksums == NULL) return;
+
+	free((*checksums)->crcs);
+	free(*checksums);
+	*checksums = NULL;
+}
+
+/*
+ * readChecksumFile
+ *
+ * Syntactic Specification:
+ * ActivityChecksums readChecksumFile(const char* filename);
+ *
+ * Semantic Specification:
+ * Reads the checksum file of a file (see 'writeActivityChecksums()'), checking its header, its size and
+ * its own CRC32C.
+ *
+ * Preconditions:
+ * - 'filename != NULL' (the name of the checksummed file)
+ *
+ * Postconditions:
+ * - Returns the checksums of the blocks ('count' blocks, 'fileSize' bytes)
+ * - Returns NULL if the checksum file can't be read, is not valid or memory allocation fails
+ *
+ * Side Effects:
+ * - Reading from file
+ * - Allocates memory
+ */
+ActivityChecksums readChecksumFile(const char* filename) {
+	char* checksumFilename = getChecksumFilename(filename);
+	if (checksumFilename == NULL) return NULL;
+	FILE* file = fopen(checksumFilename, "rb");
+	free(checksumFilename);
+	if (file == NULL) return NULL;
+
+	ChecksumHeader header;
+	struct stat fileInfo;
+	if (fread(&header, sizeof(header), 1, file) != 1 || fstat(fileno(file), &fileInfo) != 0 ||
+		 memcmp(header.magic, ACTIVITY_CHECKSUM_MAGIC, sizeof(ACTIVITY_CHECKSUM_MAGIC)) != 0 ||
+		 header.version != ACTIVITY_CHECKSUM_VERSION || header.byteOrderMark != ACTIVITY_CHECKSUM_BYTE_ORDER_MARK ||
+		 header.blockSize != ACTIVITY_CHECKSUM_BLOCK_SIZE) {
+		fclose(file);
+		return NULL;
+	}
+
+	// a CRC32C per block and one of the checksum file
+	uint64_t blockCount = (header.fileSize + ACTIVITY_CHECKSUM_BLOCK_SIZE - 1) / ACTIVITY_CHECKSUM_BLOCK_SIZE;
+	if ((uint64_t)fileInfo.st_size != sizeof(header) + (blockCount + 1) * sizeof(uint32_t) || blockCount > SIZE_MAX / sizeof(uint32_t)) {
+		fclose(file);
+		return NULL;
+	}
+
+	ActivityChecksums checksums = newActivityChecksums();
+	uint32_t* crcs = malloc((blockCount > 0 ? (size_t)blockCount : 1) * sizeof(uint32_t));
+	uint32_t crc = 0;
+	if (checksums == NULL || crcs == NULL || fread(crcs, sizeof(uint32_t), (size_t)blockCount, file) != blockCount ||
+		 fread(&crc, sizeof(crc), 1, file) != 1 ||
+		 computeCrc32c(computeCrc32c(0, &header, sizeof(header)), crcs, (size_t)blockCount * sizeof(uint32_t)) != crc) {
+		free(crcs);
+		deleteActivityChecksums(&checksums);
+		fclose(file);
+		return NULL;
+	}
+	fclose(file);
+
+	checksums->crcs = crcs;
+	checksums->count = (size_t)blockCount;
+	checksums->capacity = (blockCount > 0) ? (size_t)blockCount : 1;
+	checksums->fileSize = header.fileSize;
+	return checksums;
+}
+
+/*
+ * compareBlockNumbers
+ *
+ * Syntactic Specification:
+ * int compareBlockNumbers(const void* first, const void* second);
+ *
+ * Semantic Specification:
+ * Comparison function for 'qsort()' of the numbers of blocks (uint64_t).
+ *
+ * Preconditions:
+ * - 'first' and 'second' point to uint64_t values
+ *
+ * Postconditions:
+ * - Returns a negative, zero or positive value as the first number is lower, equal or higher
+ *
+ * Side Effects:
+ * - None
+ */
+int compareBlockNumbers(const void* first, const void* second) {
+	uint64_t a = *(const uint64_t*)first;
+	uint64_t b = *(const uint64_t*)second;
+	return (a > b) - (a < b);
+}
+
+/*
+ * readBlockChecksum
+ *
+ * Syntactic Specification:
+ * int readBlockChecksum(int fd, uint64_t block, uint64_t fileSize, unsigned char* buffer, uint32_t* crc);
+ *
+ * Semantic Specification:
+ * Reads a block of a file with 'pread()' and computes its CRC32C.
+ *
+ * Preconditions:
+ * - 'fd' open for reading, 'block' a block of a file of 'fileSize' bytes
+ * - 'buffer' has room for ACTIVITY_CHECKSUM_BLOCK_SIZE bytes, 'crc != NULL'
+ *
+ * Postconditions:
+ * - Returns 0 on success ('*crc' is set), 1 if the block can't be read
+ *
+ * Side Effects:
+ * - Reading from file
+ */
+int readBlockChecksum(int fd, uint64_t block, uint64_t fileSize, unsigned char* buffer, uint32_t* crc) {
+	off_t offset = (off_t)(block * ACTIVITY_CHECKSUM_BLOCK_SIZE);
+	size_t size = (fileSize - (uint64_t)offset < ACTIVITY_CHECKSUM_BLOCK_SIZE) ? (size_t)(fileSize - (uint64_t)offset) : ACTIVITY_CHECKSUM_BLOCK_SIZE;
+
+	size_t done = 0;
+	while (done < size) {
+		ssize_t got = pread(fd, buffer + done, size - done, offset + (off_t)done);
+		if (got <= 0) return 1;
+		done += (size_t)got;
+	}
+
+	*crc = computeCrc32c(0, buffer, size);
+	return 0;
+}
+
+/*
+ * refreshActivityChecksums
+ *
+ * Syntactic Specification:
+ * int refreshActivityChecksums(const char* filename, int fd, uint64_t* blocks, size_t blockCount);
+ *
+ * Semantic Specification:
+ * Updates the checksum file of a file modified in place: only the given blocks, the blocks added at the
+ * end and the last block of the previous size are read again (with 'pread()') and checksummed, the others
+ * keep their CRC32C. If the checksum file is missing or not valid, every block is read.
+ *
+ * Preconditions:
+ * - 'filename != NULL', 'fd' open for reading on the file, the modifications written
+ * - 'blocks' has 'blockCount' numbers of blocks (in any order, repeated too), it's sorted by the function
+ *
+ * Postconditions:
+ * - Returns 0 on success, 1 if the file can't be read, memory allocation fails or the checksum file can't be written
+ *
+ * Side Effects:
+ * - Reading from file, writing to file
+ * - Sorts 'blocks'
+ */
+int refreshActivityChecksums(const char* filename, int fd, uint64_t* blocks, size_t blockCount) {
+	struct stat fileInfo;
+	if (filename == NULL || fstat(fd, &fileInfo) != 0) return 1;
+
+	uint64_t fileSize = (uint64_t)fileInfo.st_size;
+	uint64_t newCount = (fileSize + ACTIVITY_CHECKSUM_BLOCK_SIZE - 1) / ACTIVITY_CHECKSUM_BLOCK_SIZE;
+	if (newCount > SIZE_MAX / sizeof(uint32_t)) return 1;
+
+	ActivityChecksums checksums = readChecksumFile(filename);
+	// the blocks from 'firstChanged' on are all read again: the last one of the previous size may have grown
+	uint64_t firstChanged = 0;
+	if (checksums != NULL && checksums->count > 0) firstChanged = checksums->count - 1;
+	if (checksums == NULL) checksums = newActivityChecksums();
+	unsigned char* buffer = malloc(ACTIVITY_CHECKSUM_BLOCK_SIZE);
+	uint32_t* crcs = (checksums != NULL) ? realloc(checksums->crcs, (newCount > 0 ? (size_t)newCount : 1) * sizeof(uint32_t)) : NULL;
+	if (checksums == NULL || buffer == NULL || crcs == NULL) {
+		if (checksums != NULL && crcs != NULL) checksums->crcs = crcs;
+		deleteActivityChecksums(&checksums);
+		free(buffer);
+		return 1;
+	}
+	checksums->crcs = crcs;
+	checksums->count = (size_t)newCount;
+	checksums->capacity = (newCount > 0) ? (size_t)newCount : 1;
+	checksums->fileSize = fileSize;
+
+	int failed = 0;
+	qsort(blocks, blockCount, sizeof(uint64_t), compareBlockNumbers);
+	for (size_t i = 0; i < blockCount && !failed; i++) {
+		if (blocks[i] >= firstChanged || blocks[i] >= newCount || (i > 0 && blocks[i] == blocks[i-1])) continue;
+		failed = readBlockChecksum(fd, blocks[i], fileSize, buffer, &crcs[blocks[i]]);
+	}
+	for (uint64_t b = firstChanged; b < newCount && !failed; b++) {
+		failed = readBlockChecksum(fd, b, fileSize, buffer, &crcs[b]);
+	}
+	free(buffer);
+
+	if (!failed) failed = writeActivityChecksums(checksums, filename);
+	deleteActivityChecksums(&checksums);
+	return failed;
+}
+
+/*
+ * removeActivityChecksums
+ *
+ * Syntactic Specification:
+ * void removeActivityChecksums(const char* filename);
+ *
+ * Semantic Specification:
+ * Removes the checksum file of a file (if any): used when it couldn't be updated, so that a stale checksum
+ * file doesn't report as damaged a file that isn't.
+ *
+ * Preconditions:
+ * - None
+ *
+ * Postconditions:
+ * - The checksum file doesn't exist any more (if it could be removed)
+ *
+ * Side Effects:
+ * - Removal of a file
+ */
+void removeActivityChecksums(const char* filename) {
+	if (filename == NULL) return;
+
+	char* checksumFilename = getChecksumFilename(filename);
+	if (checksumFilename != NULL) unlink(checksumFilename);
+	free(checksumFilename);
+}
+
+/*
+ * verifyActivityChecksums
+ *
+ * Syntactic Specification:
+ * int verifyActivityChecksums(const char* filename);
+ *
+ * Semantic Specification:
+ * Checks a file against its checksum file, without parsing it: the size must be the one recorded and
+ * every block must have its CRC32C. The file is read sequentially, a large buffer at a time. The first
+ * ACTIVITY_CHECKSUM_MAX_REPORTED_BLOCKS damaged blocks are reported with their bytes, then a summary.
+ *
+ * Preconditions:
+ * - None
+ *
+ * Postconditions:
+ * - Returns 0 if the file is intact
+ * - Returns 1 if it's damaged (or shorter or longer than when it was written), if it or its checksum
+ *   file can't be read or the checksum file is not valid
+ *
+ * Side Effects:
+ * - Reading from files
+ * - Output to stdout (damaged blocks and result)
+ */
+int verifyActivityChecksums(const char* filename) {
+	if (filename == NULL) return 1;
+
+	ActivityChecksums checksums = readChecksumFile(filename);
+	if (checksums == NULL) {
+		printf("Il file di controllo di %s manca o non è valido.\n", filename);
+		return 1;
+	}
+
+	int fd = open(filename, O_RDONLY);
+	struct stat fileInfo;
+	if (fd < 0 || fstat(fd, &fileInfo) != 0) {
+		if (fd >= 0) close(fd);
+		printf("Errore nell'apertura del file %s.\n", filename);
+		deleteActivityChecksums(&checksums);
+		return 1;
+	}
+	if ((uint64_t)fileInfo.st_size != checksums->fileSize) {
+		printf("Il file %s è danneggiato: %llu byte invece di %llu.\n", filename,
+				 (unsigned long long)fileInfo.st_size, (unsigned long long)checksums->fileSize);
+		close(fd);
+		deleteActivityChecksums(&checksums);
+		return 1;
+	}
+
+	unsigned char* buffer = malloc(ACTIVITY_CHECKSUM_READ_SIZE);
+	int readFailed = (buffer == NULL);
+	unsigned long long damagedCount = 0;
+	uint64_t block = 0;
+	while (!readFailed && block < checksums->count) {
+		uint64_t offset = block * ACTIVITY_CHECKSUM_BLOCK_SIZE;
+		size_t size = (checksums->fileSize - offset < ACTIVITY_CHECKSUM_READ_SIZE) ? (size_t)(checksums->fileSize - offset) : ACTIVITY_CHECKSUM_READ_SIZE;
+		size_t done = 0;
+		while (done < size) {
+			ssize_t got = read(fd, buffer + done, size - done);
+			if (got <= 0) {
+				readFailed = 1;
+				break;
+			}
+			done += (size_t)got;
+		}
+
+		for (size_t position = 0; position < done; position += ACTIVITY_CHECKSUM_BLOCK_SIZE, block++) {
+			size_t blockSize = (done - position < ACTIVITY_CHECKSUM_BLOCK_SIZE) ? done - position : ACTIVITY_CHECKSUM_BLOCK_SIZE;
+			if (computeCrc32c(0, buffer + position, blockSize) == checksums->crcs[block]) continue;
+
+			if (damagedCount < ACTIVITY_CHECKSUM_MAX_REPORTED_BLOCKS) {
+				printf("Blocco %llu del file %s danneggiato (byte da %llu a %llu).\n", (unsigned long long)block, filename,
+						 (unsigned long long)(offset + position), (unsigned long long)(offset + position + blockSize - 1));
+			}
+			damagedCount++;
+		}
+	}
+	free(buffer);
+	close(fd);
+
+	uint64_t blockCount = checksums->count;
+	deleteActivityChecksums(&checksums);
+	if (readFailed) {
+		printf("Errore nella lettura del file %s.\n", filename);
+		return 1;
+	}
+	if (damagedCount > 0) {
+		printf("Il file %s è danneggiato: %llu blocchi su %llu.\n", filename, damagedCount, (unsigned long long)blockCount);
+		return 1;
+	}
+
+	printf("Il file %s è integro (%llu blocchi verificati).\n", filename, (unsigned long long)blockCount);
+	return 0;
+}
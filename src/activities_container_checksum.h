@@ -0,0 +1,227 @@
+#ifndef ACTIVITIES_CONTAINER_CHECKSUM_H             // Start of inclusion block
+#define ACTIVITIES_CONTAINER_CHECKSUM_H             // Macro definition to avoid multiple inclusions
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Extension of the checksum file of a saved file (written next to it)
+#define ACTIVITY_CHECKSUM_EXTENSION ".crc"
+// First bytes of a checksum file
+#define ACTIVITY_CHECKSUM_MAGIC "PSDCRC"
+// Version of the checksum file format written by 'writeActivityChecksums()'
+#define ACTIVITY_CHECKSUM_VERSION 1
+// Bytes of a block of the saved file: every block has its own CRC32C
+#define ACTIVITY_CHECKSUM_BLOCK_SIZE (1 << 16)
+// Number of damaged blocks reported one by one by 'verifyActivityChecksums()', the others are only counted
+#define ACTIVITY_CHECKSUM_MAX_REPORTED_BLOCKS 10
+
+// Declare an opaque type for the CRC32C of the blocks of a file being written
+typedef struct activityChecksums* ActivityChecksums;
+
+
+/*
+ * computeCrc32c
+ *
+ * Syntactic Specification:
+ * uint32_t computeCrc32c(uint32_t crc, const void* data, size_t size);
+ *
+ * Semantic Specification:
+ * Returns the CRC32C (Castagnoli polynomial, as in iSCSI and ext4) of the bytes following the ones whose
+ * CRC32C is 'crc' (0 for the first bytes): the CRC32C of a text can be computed a part at a time. On x86-64
+ * processors with SSE4.2 the crc32 instruction is used (8 bytes at a time), otherwise a table-driven
+ * implementation that reads 8 bytes at a time (slicing-by-8), with the same result. The hardware path can
+ * be left out at build time with -DACTIVITY_CHECKSUM_NO_HARDWARE.
+ *
+ * Preconditions:
+ * - 'data' has at least 'size' bytes (can be NULL if 'size == 0')
+ *
+ * Postconditions:
+ * - Returns the CRC32C (e.g. 0xE3069283 for "123456789" from 0)
+ *
+ * Side Effects:
+ * - The first call fills the tables and checks the processor
+ */
+uint32_t computeCrc32c(uint32_t crc, const void* data, size_t size);
+
+/*
+ * computeCrc32cSoftware
+ *
+ * Syntactic Specification:
+ * uint32_t computeCrc32cSoftware(uint32_t crc, const void* data, size_t size);
+ *
+ * Semantic Specification:
+ * The slicing-by-8 implementation of 'computeCrc32c()', used when the processor has no crc32 instruction.
+ *
+ * Preconditions:
+ * - The same of 'computeCrc32c()'
+ *
+ * Postconditions:
+ * - The same of 'computeCrc32c()'
+ *
+ * Side Effects:
+ * - The first call fills the tables
+ */
+uint32_t computeCrc32cSoftware(uint32_t crc, const void* data, size_t size);
+
+/*
+ * newActivityChecksums
+ *
+ * Syntactic Specification:
+ * ActivityChecksums newActivityChecksums(void);
+ *
+ * Semantic Specification:
+ * Creates the checksums of a file that is going to be written from its beginning: the bytes are passed
+ * to 'addToActivityChecksums()' in the order they are written.
+ *
+ * Preconditions:
+ * - None
+ *
+ * Postconditions:
+ * - Returns the new checksums, NULL if memory allocation fails
+ *
+ * Side Effects:
+ * - Allocates memory
+ */
+ActivityChecksums newActivityChecksums(void);
+
+/*
+ * addToActivityChecksums
+ *
+ * Syntactic Specification:
+ * void addToActivityChecksums(ActivityChecksums checksums, const void* data, size_t size);
+ *
+ * Semantic Specification:
+ * Adds the bytes that follow in the file to the CRC32C of its blocks of ACTIVITY_CHECKSUM_BLOCK_SIZE bytes.
+ *
+ * Preconditions:
+ * - 'data' has at least 'size' bytes
+ *
+ * Postconditions:
+ * - The checksums include the bytes; if memory allocation fails, 'writeActivityChecksums()' fails
+ * - No effect if 'checksums == NULL'
+ *
+ * Side Effects:
+ * - May allocate memory
+ */
+void addToActivityChecksums(ActivityChecksums checksums, const void* data, size_t size);
+
+/*
+ * writeActivityChecksums
+ *
+ * Syntactic Specification:
+ * int writeActivityChecksums(ActivityChecksums checksums, const char* filename);
+ *
+ * Semantic Specification:
+ * Writes the checksum file of a file whose bytes have all been added, named 'filename' +
+ * ACTIVITY_CHECKSUM_EXTENSION:
+ * - a header: magic (8 bytes), version, byte order mark (0x01020304) and block size (32 bit), size of the
+ *   file (64 bit)
+ * - the CRC32C of every block of the file (32 bit), the last block being shorter if the size of the file
+ *   is not a multiple of the block size
+ * - the CRC32C of all the previous bytes of the checksum file (32 bit)
+ * The numbers are in the byte order of the machine, as in a binary snapshot. The checksum file is replaced
+ * only when complete (see 'commitActivityWriter()').
+ *
+ * Preconditions:
+ * - 'filename != NULL'
+ *
+ * Postconditions:
+ * - Returns 0 on success, 1 if 'checksums' is NULL, a memory allocation has failed or the checksum file
+ *   can't be written (it keeps its previous content)
+ *
+ * Side Effects:
+ * - Writing to file
+ */
+int writeActivityChecksums(ActivityChecksums checksums, const char* filename);
+
+/*
+ * deleteActivityChecksums
+ *
+ * Syntactic Specification:
+ * void deleteActivityChecksums(ActivityChecksums* checksums);
+ *
+ * Semantic Specification:
+ * Deallocates the checksums. The parameter is a pointer passed by reference.
+ *
+ * Preconditions:
+ * - 'checksums' can be NULL or point to a valid/NULL pointer
+ *
+ * Postconditions:
+ * - '*checksums' is set to NULL
+ *
+ * Side Effects:
+ * - Deallocates memory
+ */
+void deleteActivityChecksums(ActivityChecksums* checksums);
+
+/*
+ * refreshActivityChecksums
+ *
+ * Syntactic Specification:
+ * int refreshActivityChecksums(const char* filename, int fd, uint64_t* blocks, size_t blockCount);
+ *
+ * Semantic Specification:
+ * Updates the checksum file of a file modified in place: only the given blocks, the blocks added at the
+ * end and the last block of the previous size are read again (with 'pread()') and checksummed, the others
+ * keep their CRC32C. If the checksum file is missing or not valid, every block is read.
+ *
+ * Preconditions:
+ * - 'filename != NULL', 'fd' open for reading on the file, the modifications written
+ * - 'blocks' has 'blockCount' numbers of blocks (in any order, repeated too), it's sorted by the function
+ *
+ * Postconditions:
+ * - Returns 0 on success, 1 if the file can't be read, memory allocation fails or the checksum file can't be written
+ *
+ * Side Effects:
+ * - Reading from file, writing to file
+ * - Sorts 'blocks'
+ */
+int refreshActivityChecksums(const char* filename, int fd, uint64_t* blocks, size_t blockCount);
+
+/*
+ * removeActivityChecksums
+ *
+ * Syntactic Specification:
+ * void removeActivityChecksums(const char* filename);
+ *
+ * Semantic Specification:
+ * Removes the checksum file of a file (if any): used when it couldn't be updated, so that a stale checksum
+ * file doesn't report as damaged a file that isn't.
+ *
+ * Preconditions:
+ * - None
+ *
+ * Postconditions:
+ * - The checksum file doesn't exist any more (if it could be removed)
+ *
+ * Side Effects:
+ * - Removal of a file
+ */
+void removeActivityChecksums(const char* filename);
+
+/*
+ * verifyActivityChecksums
+ *
+ * Syntactic Specification:
+ * int verifyActivityChecksums(const char* filename);
+ *
+ * Semantic Specification:
+ * Checks a file against its checksum file, without parsing it: the size must be the one recorded and
+ * every block must have its CRC32C. The file is read sequentially, a large buffer at a time. The first
+ * ACTIVITY_CHECKSUM_MAX_REPORTED_BLOCKS damaged blocks are reported with their bytes, then a summary.
+ *
+ * Preconditions:
+ * - None
+ *
+ * Postconditions:
+ * - Returns 0 if the file is intact
+ * - Returns 1 if it's damaged (or shorter or longer than when it was written), if it or its checksum
+ *   file can't be read or the checksum file is not valid
+ *
+ * Side Effects:
+ * - Reading from files
+ * - Output to stdout (damaged blocks and result)
+ */
+int verifyActivityChecksums(const char* filename);
+
+#endif // ACTIVITIES_CONTAINER_CHECKSUM_H          // End of inclusion block
@@ -0,0 +1,303 @@
+#include <string.h>
+#include "activity.h"
+#include "activities_container_export.h"
+#include "activities_container_writer.h"
+
+
+/*
+ * writeCsvField
+ *
+ * Syntactic Specification:
+ * void writeCsvField(ActivityWriter writer, const char* str);
+ *
+ * Semantic Specification:
+ * Writes a string as a CSV field: as it is if it has no comma, double quote or line end, otherwise
+ * enclosed in double quotes with its double quotes doubled. A NULL string is an empty field.
+ *
+ * Preconditions:
+ * - 'writer != NULL'
+ *
+ * Postconditions:
+ * - The field follows the previous data
+ *
+ * Side Effects:
+ * - Writing to file
+ */
+void writeCsvField(ActivityWriter writer, const char* str) {
+	if (str == NULL) return;
+
+	size_t length = strlen(str);
+	if (strpbrk(str, ",\"\r\n") == NULL) {
+		writeBytesToActivityWriter(writer, str, length);
+		return;
+	}
+
+	writeBytesToActivityWriter(writer, "\"", 1);
+	const char* run = str;
+	const char* quote = NULL;
+	while ((quote = strchr(run, '"')) != NULL) {
+		// the run up to the quote included, then the quote again
+		writeBytesToActivityWriter(writer, run, (size_t)(quote - run) + 1);
+		writeBytesToActivityWriter(writer, "\"", 1);
+		run = quote + 1;
+	}
+	writeBytesToActivityWriter(writer, run, strlen(run));
+	writeBytesToActivityWriter(writer, "\"", 1);
+}
+
+/*
+ * writeJsonString
+ *
+ * Syntactic Specification:
+ * void writeJsonString(ActivityWriter writer, const char* str);
+ *
+ * Semantic Specification:
+ * Writes a string as a JSON string: '"' and '\\' are escaped, as the control characters ('\n', '\r',
+ * '\t', '\b', '\f' by their short escapes, the others as \u00XX). The runs of characters that need no
+ * escape are written with a single call. A NULL string is written as null.
+ *
+ * Preconditions:
+ * - 'writer != NULL'
+ *
+ * Postconditions:
+ * - The string follows the previous data
+ *
+ * Side Effects:
+ * - Writing to file
+ */
+void writeJsonString(ActivityWriter writer, const char* str) {
+	if (str == NULL) {
+		writeBytesToActivityWriter(writer, "null", 4);
+		return;
+	}
+
+	writeBytesToActivityWriter(writer, "\"", 1);
+	const char* run = str;
+	for (const char* c = str; *c != '\0'; c++) {
+		unsigned char byte = (unsigned char)*c;
+		if (byte >= 0x20 && byte != '"' && byte != '\\') continue;
+
+		writeBytesToActivityWriter(writer, run, (size_t)(c - run));
+		run = c + 1;
+
+		char escape[7] = { '\\', 0, 0, 0, 0, 0, 0 };
+		size_t escapeLength = 2;
+		switch (byte) {
+			case '"':	escape[1] = '"';
+							break;
+			case '\\':	escape[1] = '\\';
+							break;
+			case '\n':	escape[1] = 'n';
+							break;
+			case '\r':	escape[1] = 'r';
+							break;
+			case '\t':	escape[1] = 't';
+							break;
+			case '\b':	escape[1] = 'b';
+							break;
+			case '\f':	escape[1] = 'f';
+							break;
+			default:	memcpy(escape + 1, "u00", 3);
+						escape[4] = "0123456789abcdef"[byte >> 4];
+						escape[5] = "0123456789abcdef"[byte & 0x0f];
+						escapeLength = 6;
+						break;
+		}
+		writeBytesToActivityWriter(writer, escape, escapeLength);
+	}
+	writeBytesToActivityWriter(writer, run, strlen(run));
+	writeBytesToActivityWriter(writer, "\"", 1);
+}
+
+/*
+ * writeActivityCsvRecord
+ *
+ * Syntactic Specification:
+ * void writeActivityCsvRecord(ActivityWriter writer, Activity a);
+ *
+ * Semantic Specification:
+ * Writes the CSV line of an activity (see 'writeActivitiesCsv()').
+ *
+ * Preconditions:
+ * - 'writer != NULL', 'a != NULL'
+ *
+ * Postconditions:
+ * - The line follows the previous data
+ *
+ * Side Effects:
+ * - Writing to file
+ */
+void writeActivityCsvRecord(ActivityWriter writer, Activity a) {
+	writeNumberToActivityWriter(writer, getActivityId(a));
+	writeBytesToActivityWriter(writer, ",", 1);
+	writeCsvField(writer, getActivityName(a));
+	writeBytesToActivityWriter(writer, ",", 1);
+	writeCsvField(writer, getActivityDescr(a));
+	if (!isActivityDescrLoaded(a)) failActivityWriter(writer);
+	writeBytesToActivityWriter(writer, ",", 1);
+	writeCsvField(writer, getActivityCourse(a));
+	writeBytesToActivityWriter(writer, ",", 1);
+	writeNumberToActivityWriter(writer, (long long)getActivityInsertDate(a));
+	writeBytesToActivityWriter(writer, ",", 1);
+	writeNumberToActivityWriter(writer, (long long)getActivityExpiryDate(a));
+	writeBytesToActivityWriter(writer, ",", 1);
+	writeNumberToActivityWriter(writer, (long long)getActivityCompletionDate(a));
+	writeBytesToActivityWriter(writer, ",", 1);
+	writeNumberToActivityWriter(writer, getActivityTotalTime(a));
+	writeBytesToActivityWriter(writer, ",", 1);
+	writeNumberToActivityWriter(writer, getActivityUsedTime(a));
+	writeBytesToActivityWriter(writer, ",", 1);
+	writeNumberToActivityWriter(writer, getActivityPriority(a));
+	writeBytesToActivityWriter(writer, "\n", 1);
+}
+
+/*
+ * writeActivityJsonlRecord
+ *
+ * Syntactic Specification:
+ * void writeActivityJsonlRecord(ActivityWriter writer, Activity a);
+ *
+ * Semantic Specification:
+ * Writes the JSON Lines line of an activity (see 'writeActivitiesJsonl()').
+ *
+ * Preconditions:
+ * - 'writer != NULL', 'a != NULL'
+ *
+ * Postconditions:
+ * - The line follows the previous data
+ *
+ * Side Effects:
+ * - Writing to file
+ */
+void writeActivityJsonlRecord(ActivityWriter writer, Activity a) {
+	writeBytesToActivityWriter(writer, "{\"id\":", 6);
+	writeNumberToActivityWriter(writer, getActivityId(a));
+	writeBytesToActivityWriter(writer, ",\"titolo\":", 10);
+	writeJsonString(writer, getActivityName(a));
+	writeBytesToActivityWriter(writer, ",\"descrizione\":", 15);
+	writeJsonString(writer, getActivityDescr(a));
+	if (!isActivityDescrLoaded(a)) failActivityWriter(writer);
+	writeBytesToActivityWriter(writer, ",\"corso\":", 9);
+	writeJsonString(writer, getActivityCourse(a));
+	writeBytesToActivityWriter(writer, ",\"data_inserimento\":", 20);
+	writeNumberToActivityWriter(writer, (long long)getActivityInsertDate(a));
+	writeBytesToActivityWriter(writer, ",\"data_scadenza\":", 17);
+	writeNumberToActivityWriter(writer, (long long)getActivityExpiryDate(a));
+	writeBytesToActivityWriter(writer, ",\"data_completamento\":", 22);
+	writeNumberToActivityWriter(writer, (long long)getActivityCompletionDate(a));
+	writeBytesToActivityWriter(writer, ",\"tempo_totale\":", 16);
+	writeNumberToActivityWriter(writer, getActivityTotalTime(a));
+	writeBytesToActivityWriter(writer, ",\"tempo_impiegato\":", 19);
+	writeNumberToActivityWriter(writer, getActivityUsedTime(a));
+	writeBytesToActivityWriter(writer, ",\"priorita\":", 12);
+	writeNumberToActivityWriter(writer, getActivityPriority(a));
+	writeBytesToActivityWriter(writer, "}\n", 2);
+}
+
+/*
+ * writeActivitiesCsvRecords
+ *
+ * Syntactic Specification:
+ * void writeActivitiesCsvRecords(ActivityWriter writer, TreeNode root);
+ *
+ * Semantic Specification:
+ * Visits the tree in order and writes the CSV line of every activity.
+ *
+ * Preconditions:
+ * - 'writer != NULL'
+ *
+ * Postconditions:
+ * - The lines follow the previous data
+ *
+ * Side Effects:
+ * - Writing to file
+ */
+void writeActivitiesCsvRecords(ActivityWriter writer, TreeNode root) {
+	if (root == NULL) return;
+
+	writeActivitiesCsvRecords(writer, getLeftNode(root));
+	writeActivityCsvRecord(writer, getActivityFromNode(root));
+	writeActivitiesCsvRecords(writer, getRightNode(root));
+}
+
+/*
+ * writeActivitiesJsonlRecords
+ *
+ * Syntactic Specification:
+ * void writeActivitiesJsonlRecords(ActivityWriter writer, TreeNode root);
+ *
+ * Semantic Specification:
+ * Visits the tree in order and writes the JSON Lines line of every activity.
+ *
+ * Preconditions:
+ * - 'writer != NULL'
+ *
+ * Postconditions:
+ * - The lines follow the previous data
+ *
+ * Side Effects:
+ * - Writing to file
+ */
+void writeActivitiesJsonlRecords(ActivityWriter writer, TreeNode root) {
+	if (root == NULL) return;
+
+	writeActivitiesJsonlRecords(writer, getLeftNode(root));
+	writeActivityJsonlRecord(writer, getActivityFromNode(root));
+	writeActivitiesJsonlRecords(writer, getRightNode(root));
+}
+
+/*
+ * writeActivitiesCsv
+ *
+ * Syntactic Specification:
+ * void writeActivitiesCsv(ActivityWriter writer, TreeNode root);
+ *
+ * Semantic Specification:
+ * Writes the activities of the tree (in id order) with a writer as CSV (RFC 4180, with '\n' line ends):
+ * the header ACTIVITY_EXPORT_CSV_HEADER, then one line per activity with all its fields, complete.
+ * A string with a comma, a double quote or a line end is enclosed in double quotes, its double quotes
+ * doubled; a NULL string is an empty field. The dates are in seconds since the epoch, as in the other formats.
+ * Every record is formatted in the buffer of the writer: the memory used doesn't grow with the activities.
+ *
+ * Preconditions:
+ * - 'writer' created by 'newActivityWriter()' (the file is replaced by 'commitActivityWriter()')
+ *
+ * Postconditions:
+ * - The export follows the previous data (a failed write is reported by 'commitActivityWriter()')
+ *
+ * Side Effects:
+ * - Writing to file
+ */
+void writeActivitiesCsv(ActivityWriter writer, TreeNode root) {
+	if (writer == NULL) return;
+
+	writeBytesToActivityWriter(writer, ACTIVITY_EXPORT_CSV_HEADER, strlen(ACTIVITY_EXPORT_CSV_HEADER));
+	writeActivitiesCsvRecords(writer, root);
+}
+
+/*
+ * writeActivitiesJsonl
+ *
+ * Syntactic Specification:
+ * void writeActivitiesJsonl(ActivityWriter writer, TreeNode root);
+ *
+ * Semantic Specification:
+ * Writes the activities of the tree (in id order) with a writer as JSON Lines: one JSON object per line
+ * per activity, with the columns of the CSV export as keys. Strings are escaped as JSON requires ('"',
+ * '\\' and control characters), the other bytes are copied (the strings are expected in UTF-8); a NULL
+ * string is 'null'. Every record is formatted in the buffer of the writer.
+ *
+ * Preconditions:
+ * - 'writer' created by 'newActivityWriter()' (the file is replaced by 'commitActivityWriter()')
+ *
+ * Postconditions:
+ * - The export follows the previous data (a failed write is reported by 'commitActivityWriter()')
+ *
+ * Side Effects:
+ * - Writing to file
+ */
+void writeActivitiesJsonl(ActivityWriter writer, TreeNode root) {
+	if (writer == NULL) return;
+
+	writeActivitiesJsonlRecords(writer, root);
+}
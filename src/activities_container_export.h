@@ -0,0 +1,98 @@
+#ifndef ACTIVITIES_CONTAINER_EXPORT_H             // Start of inclusion block
+#define ACTIVITIES_CONTAINER_EXPORT_H             // Macro definition to avoid multiple inclusions
+
+#include "activities_container_avl.h"
+#include "activities_container_writer.h"
+
+// First line of the CSV export: the names of the columns (the same names are the keys of the JSON Lines export)
+#define ACTIVITY_EXPORT_CSV_HEADER "id,titolo,descrizione,corso,data_inserimento,data_scadenza,data_completamento,tempo_totale,tempo_impiegato,priorita\n"
+
+
+/*
+ * writeActivitiesCsv
+ *
+ * Syntactic Specification:
+ * void writeActivitiesCsv(ActivityWriter writer, TreeNode root);
+ *
+ * Semantic Specification:
+ * Writes the activities of the tree (in id order) with a writer as CSV (RFC 4180, with '\n' line ends):
+ * the header ACTIVITY_EXPORT_CSV_HEADER, then one line per activity with all its fields, complete.
+ * A string with a comma, a double quote or a line end is enclosed in double quotes, its double quotes
+ * doubled; a NULL string is an empty field. The dates are in seconds since the epoch, as in the other formats.
+ * Every record is formatted in the buffer of the writer: the memory used doesn't grow with the activities.
+ *
+ * Preconditions:
+ * - 'writer' created by 'newActivityWriter()' (the file is replaced by 'commitActivityWriter()')
+ *
+ * Postconditions:
+ * - The export follows the previous data (a failed write is reported by 'commitActivityWriter()')
+ *
+ * Side Effects:
+ * - Writing to file
+ */
+void writeActivitiesCsv(ActivityWriter writer, TreeNode root);
+
+/*
+ * writeActivitiesJsonl
+ *
+ * Syntactic Specification:
+ * void writeActivitiesJsonl(ActivityWriter writer, TreeNode root);
+ *
+ * Semantic Specification:
+ * Writes the activities of the tree (in id order) with a writer as JSON Lines: one JSON object per line
+ * per activity, with the columns of the CSV export as keys. Strings are escaped as JSON requires ('"',
+ * '\\' and control characters), the other bytes are copied (the strings are expected in UTF-8); a NULL
+ * string is 'null'. Every record is formatted in the buffer of the writer.
+ *
+ * Preconditions:
+ * - 'writer' created by 'newActivityWriter()' (the file is replaced by 'commitActivityWriter()')
+ *
+ * Postconditions:
+ * - The export follows the previous data (a failed write is reported by 'commitActivityWriter()')
+ *
+ * Side Effects:
+ * - Writing to file
+ */
+void writeActivitiesJsonl(ActivityWriter writer, TreeNode root);
+
+/*
+ * writeActivityCsvRecord
+ *
+ * Syntactic Specification:
+ * void writeActivityCsvRecord(ActivityWriter writer, Activity a);
+ *
+ * Semantic Specification:
+ * Writes the CSV line of an activity (see 'writeActivitiesCsv()').
+ *
+ * Preconditions:
+ * - 'writer != NULL', 'a != NULL'
+ *
+ * Postconditions:
+ * - The line follows the previous data
+ *
+ * Side Effects:
+ * - Writing to file
+ */
+void writeActivityCsvRecord(ActivityWriter writer, Activity a);
+
+/*
+ * writeActivityJsonlRecord
+ *
+ * Syntactic Specification:
+ * void writeActivityJsonlRecord(ActivityWriter writer, Activity a);
+ *
+ * Semantic Specification:
+ * Writes the JSON Lines line of an activity (see 'writeActivitiesJsonl()').
+ *
+ * Preconditions:
+ * - 'writer != NULL', 'a != NULL'
+ *
+ * Postconditions:
+ * - The line follows the previous data
+ *
+ * Side Effects:
+ * - Writing to file
+ */
+void writeActivityJsonlRecord(ActivityWriter writer, Activity a);
+
+#endif // ACTIVITIES_CONTAINER_EXPORT_H          // End of inclusion block
@@ -1,6 +1,7 @@
 #include "activity_helper.h"
 #include "activities_container_helper.h"
-#include "activities_container_support_list.h"
+#include "activities_container_support_vector.h"
+#include "activities_container_writer.h"
 
 
 
@@ -9,25 +10,25 @@
  * inOrderSaveActivitiesToFile
  * 
  * Syntactic Specification:
- * void inOrderSaveActivitiesToFile(FILE* file, TreeNode root);
+ * void inOrderSaveActivitiesToFile(ActivityWriter writer, TreeNode root);
  * 
  * Semantic Specification:
  * Recursively saves all tree activities to file in in-order.
  * 
  * Preconditions:
- * - 'file' must be a file opened for writing
+ * - 'writer' must be a writer created by 'newActivityWriter()'
  * 
  * Postconditions:
  * - All activities are saved to file in ascending order of ID
  * 
  * Side Effects:
- * - Writing to file via 'saveActivityToFile()'
+ * - Writing to file via 'writeActivityToActivityWriter()' (same format of 'saveActivityToFile()')
  */
-void inOrderSaveActivitiesToFile(FILE* file, TreeNode root) {
+void inOrderSaveActivitiesToFile(ActivityWriter writer, TreeNode root) {
 	if (root != NULL) {
-		inOrderSaveActivitiesToFile(file, getLeftNode(root) );
-		saveActivityToFile(file, getActivityFromNode(root) );
-		inOrderSaveActivitiesToFile(file, getRightNode(root) );
+		inOrderSaveActivitiesToFile(writer, getLeftNode(root) );
+		writeActivityToActivityWriter(writer, getActivityFromNode(root) );
+		inOrderSaveActivitiesToFile(writer, getRightNode(root) );
 	}
 }
 
@@ -38,14 +39,17 @@ void inOrderSaveActivitiesToFile(FILE* file, TreeNode root) {
  * int saveActivitiesFromTreeToFile(const char* filename, TreeNode root);
  * 
  * Semantic Specification:
- * Saves all activities from the tree to a file.
+ * Saves all activities from the tree to a file. The records are formatted in a large buffer and
+ * written to a temporary file that replaces the file only when complete and synchronized to the disk
+ * (see 'commitActivityWriter()'): a save interrupted by a crash leaves the previous file intact.
+ * The CRC32C of its blocks is written to a checksum file next to it (see 'verifyActivityChecksums()').
  * 
  * Preconditions:
  * - None
  * 
  * Postconditions:
  * - If 'root == NULL' or 'filename != NULL', returns 1 (error)
- * - If unable to open the file, returns 1 (error)
+ * - If unable to open or write the file, returns 1 (error): the file keeps its previous content
  * - Otherwise, saves all activities and returns 0 (success)
  * 
  * Side Effects:
@@ -55,15 +59,19 @@ void inOrderSaveActivitiesToFile(FILE* file, TreeNode root) {
 int saveActivitiesFromTreeToFile(const char* filename, TreeNode root) {
 	if (root == NULL || filename == NULL) return 1;
 	
-	FILE* file = fopen(filename, "w");
-	if (file == NULL) {
+	ActivityWriter writer = newActivityWriter(filename);
+	if (writer == NULL) {
 		printf("Errore nell'apertura del file %s per la scrittura.\n", filename);
 		return 1;
 	}
+	enableActivityWriterChecksums(writer);
 
-	inOrderSaveActivitiesToFile(file, root);
+	inOrderSaveActivitiesToFile(writer, root);
 
-	fclose(file);
+	if (commitActivityWriter(&writer) != 0) {
+		printf("Errore nella scrittura del file %s.\n", filename);
+		return 1;
+	}
 	printf("Attività salvate con successo nel file %s\n", filename);
 	return 0;
 }
@@ -155,33 +163,111 @@ Activity createNewActivityFromUserInput() {
 
 
 /*
- * printInOrder
+ * printInOrderToFile
  * 
  * Syntactic Specification:
- * void printInOrder(TreeNode root);
+ * void printInOrderToFile(TreeNode root, FILE* file);
  * 
  * Semantic Specification:
- * Performs an in-order traversal of the tree printing the activities (print activity on a single line).
+ * Recursively prints tree activities to file (list format, one per line) in in-order.
  * 
  * Preconditions:
- * - None
+ * - 'file' must be opened for writing
  * 
  * Postconditions:
- * - All activities in the tree are printed in ascending order of ID
+ * - All activities are printed to file in ascending order of ID
  * 
  * Side Effects:
- * - Output to stdout via 'printActivityForList()'
+ * - Writing to file
  */
-void printInOrder(TreeNode root) {
+void printInOrderToFile(TreeNode root, FILE* file) {
 	if (root != NULL) {
-		printInOrder( getLeftNode(root) );
-		//printActivity(root->activity);
-		printActivityForList( getActivityFromNode(root) );
-		printInOrder( getRightNode(root) );
+		printInOrderToFile( getLeftNode(root), file );
+		printActivityForListToFile( getActivityFromNode(root), file );
+		printInOrderToFile( getRightNode(root), file );
+	}
+}
+
+/*
+ * printAllActivitiesToFile
+ * 
+ * Syntactic Specification:
+ * void printAllActivitiesToFile(TreeNode root, FILE* file);
+ * 
+ * Semantic Specification:
+ * Prints all container activities to file (list format, one per line).
+ * 
+ * Preconditions:
+ * - 'file' must be opened for writing
+ * 
+ * Postconditions:
+ * - If both parameters are valid, prints all activities to file
+ * 
+ * Side Effects:
+ * - Writing to file
+ */
+void printAllActivitiesToFile(TreeNode root, FILE* file) {
+	if (root != NULL && file != NULL) {
+		printInOrderToFile(root, file);
 	}
 }
 
 
+/*
+ * renderAllActivities
+ * 
+ * Syntactic Specification:
+ * void renderAllActivities(TreeNode root, FILE* stream);
+ * 
+ * Semantic Specification:
+ * Writes to 'stream' all activities (list format, one per line) from the tree in ascending order of ID, with headers.
+ * It's the screen version of the list: printAllActivities uses it with 'stream = stdout'.
+ * 
+ * Preconditions:
+ * - 'stream' must be opened for writing
+ * 
+ * Postconditions:
+ * - If 'root != NULL', writes all activities with headers
+ * 
+ * Side Effects:
+ * - Writing to stream
+ */
+void renderAllActivities(TreeNode root, FILE* stream) {
+	if (root != NULL && stream != NULL) {
+		renderAllActivitiesHeader(stream);
+		printInOrderToFile(root, stream);
+	}
+}
+
+/*
+ * renderAllActivitiesHeader
+ * 
+ * Syntactic Specification:
+ * void renderAllActivitiesHeader(FILE* stream);
+ * 
+ * Semantic Specification:
+ * Writes to 'stream' the headers of the list of all activities (see 'renderAllActivities()').
+ * 
+ * Preconditions:
+ * - 'stream' must be opened for writing
+ * 
+ * Postconditions:
+ * - The headers are written
+ * 
+ * Side Effects:
+ * - Writing to stream
+ */
+void renderAllActivitiesHeader(FILE* stream) {
+	fprintf(stream, "\n=============================\n");
+	fprintf(stream, "====== Tutte le attività =====\n");
+	fprintf(stream, "==============================\n");
+	fprintf(stream, "[NOTA: titolo, descrizione e corso potrebbero essere abbreviati. Vai al dettaglio attività per vedere le info complete]\n");
+	fprintf(stream, "[Le attività sono ordinate per id]\n");
+	fprintf(stream, "\n====================================================================================================\n");
+	fprintf(stream, "[id] Titolo | Descrizione | Corso | Priorità | Data scadenza o data completamento\n");
+	fprintf(stream, "====================================================================================================\n\n");
+}
+
 /*
  * printAllActivities
  * 
@@ -201,185 +287,161 @@ void printInOrder(TreeNode root) {
  * - Output to stdout
  */
 void printAllActivities(TreeNode root) {
-	if (root != NULL) {
-		printf("\n=============================\n");
-		printf("====== Tutte le attività =====\n");
-		printf("==============================\n");
-		printf("[NOTA: titolo, descrizione e corso potrebbero essere abbreviati. Vai al dettaglio attività per vedere le info complete]\n");
-		printf("[Le attività sono ordinate per id]\n");
-		printf("\n====================================================================================================\n");
-		printf("[id] Titolo | Descrizione | Corso | Priorità | Data scadenza o data completamento\n");
-		printf("====================================================================================================\n\n");
-
-		printInOrder(root);
-	}
+	renderAllActivities(root, stdout);
 }
 
 
 
 
 /*
- * printInOrderToFile
+ * printInOrderProgressToFile
  * 
  * Syntactic Specification:
- * void printInOrderToFile(TreeNode root, FILE* file);
+ * void printInOrderProgressToFile(TreeNode root, FILE* file);
  * 
  * Semantic Specification:
- * Recursively prints tree activities to file (list format, one per line) in in-order.
+ * Recursively prints activity progress to file (progress list format, one per line) in in-order.
  * 
  * Preconditions:
  * - 'file' must be opened for writing
  * 
  * Postconditions:
- * - All activities are printed to file in ascending order of ID
+ * - Progress of all activities is printed to file
  * 
  * Side Effects:
  * - Writing to file
  */
-void printInOrderToFile(TreeNode root, FILE* file) {
+void printInOrderProgressToFile(TreeNode root, FILE* file)  {
 	if (root != NULL) {
-		printInOrderToFile( getLeftNode(root), file );
-		printActivityForListToFile( getActivityFromNode(root), file );
-		printInOrderToFile( getRightNode(root), file );
+		printInOrderProgressToFile( getLeftNode(root), file );
+		printActivityProgressForListToFile( getActivityFromNode(root), file);
+		printInOrderProgressToFile( getRightNode(root), file);
 	}
 }
 
 /*
- * printAllActivitiesToFile
+ * printTreeActivitiesProgressToFile
  * 
  * Syntactic Specification:
- * void printAllActivitiesToFile(TreeNode root, FILE* file);
+ * void printTreeActivitiesProgressToFile(TreeNode root, FILE* file);
  * 
  * Semantic Specification:
- * Prints all container activities to file (list format, one per line).
+ * Prints the progress of all container activities to file (progress list format, one per line).
  * 
  * Preconditions:
  * - 'file' must be opened for writing
  * 
  * Postconditions:
- * - If both parameters are valid, prints all activities to file
+ * - If both parameters are valid, prints progress with header
  * 
  * Side Effects:
  * - Writing to file
  */
-void printAllActivitiesToFile(TreeNode root, FILE* file) {
+void printTreeActivitiesProgressToFile(TreeNode root, FILE* file) {
 	if (root != NULL && file != NULL) {
-		printInOrderToFile(root, file);
+		printActivitiesProgressHeaderToFile(file);
+		printInOrderProgressToFile(root, file);
 	}
 }
 
-
-
-
 /*
- * printInOrderProgress
+ * printActivitiesProgressHeaderToFile
  * 
  * Syntactic Specification:
- * void printInOrderProgress(TreeNode root);
+ * void printActivitiesProgressHeaderToFile(FILE* file);
  * 
  * Semantic Specification:
- * Recursively prints activity progress from the tree (progress list format with progress, one per line) in in-order.
+ * Writes to file the header of the progress list (see 'printTreeActivitiesProgressToFile()').
  * 
  * Preconditions:
- * - None
+ * - 'file' must be opened for writing
  * 
  * Postconditions:
- * - Progress of all activities is printed in ascending order of ID
+ * - The header is written
  * 
  * Side Effects:
- * - Output to stdout via 'printActivityProgressForList()'
+ * - Writing to file
  */
-void printInOrderProgress(TreeNode root) {
-	if (root != NULL) {
-		printInOrderProgress( getLeftNode(root) );
-		printActivityProgressForList( getActivityFromNode(root) );
-		printInOrderProgress( getRightNode(root) );
-	}
+void printActivitiesProgressHeaderToFile(FILE* file) {
+	fprintf(file, "=== MONITORAGGIO PROGRESSO ===\n");
 }
 
+
 /*
- * printTreeActivitiesProgress
+ * renderTreeActivitiesProgress
  * 
  * Syntactic Specification:
- * void printTreeActivitiesProgress(TreeNode root);
+ * void renderTreeActivitiesProgress(TreeNode root, FILE* stream);
  * 
  * Semantic Specification:
- * Prints the progress of all container activities (progress list format, one per line) with headers.
+ * Writes to 'stream' the progress of all container activities (progress list format, one per line) with headers.
+ * It's the screen version of the progress list: printTreeActivitiesProgress uses it with 'stream = stdout'.
  * 
  * Preconditions:
- * - None
+ * - 'stream' must be opened for writing
  * 
  * Postconditions:
- * - If 'root != NULL', prints progress of all activities in tree
+ * - If 'root != NULL', writes progress of all activities in tree
  * 
  * Side Effects:
- * - Output to stdout
+ * - Writing to stream
  */
-void printTreeActivitiesProgress(TreeNode root) {
-	if (root != NULL) {
-		printf("\n=============================\n");
-		printf("=== MONITORAGGIO PROGRESSO ===\n");
-		printf("==============================\n");
-		printf("[NOTA: titolo, descrizione e corso potrebbero essere abbreviati. Vai al dettaglio attività per vedere le info complete]\n");
-		printf("[Le attività sono ordinate per id. Qui NON vengono mostrate le attività completate]\n");
-		printf("\n====================================================================================================================================================\n");
-		printf("[id] Titolo | Descrizione | Corso | Priorità | Progresso (%%) | Tempo usato (min) | Tempo al completamento (min) | Tempo totale (min) | Data scadenza\n");
-		printf("====================================================================================================================================================\n\n");
-		
-		printInOrderProgress(root);
+void renderTreeActivitiesProgress(TreeNode root, FILE* stream) {
+	if (root != NULL && stream != NULL) {
+		renderActivitiesProgressHeader(stream);
+		printInOrderProgressToFile(root, stream);
 	}
 }
 
-
 /*
- * printInOrderProgressToFile
+ * renderActivitiesProgressHeader
  * 
  * Syntactic Specification:
- * void printInOrderProgressToFile(TreeNode root, FILE* file);
+ * void renderActivitiesProgressHeader(FILE* stream);
  * 
  * Semantic Specification:
- * Recursively prints activity progress to file (progress list format, one per line) in in-order.
+ * Writes to 'stream' the headers of the progress list (see 'renderTreeActivitiesProgress()').
  * 
  * Preconditions:
- * - 'file' must be opened for writing
+ * - 'stream' must be opened for writing
  * 
  * Postconditions:
- * - Progress of all activities is printed to file
+ * - The headers are written
  * 
  * Side Effects:
- * - Writing to file
+ * - Writing to stream
  */
-void printInOrderProgressToFile(TreeNode root, FILE* file)  {
-	if (root != NULL) {
-		printInOrderProgressToFile( getLeftNode(root), file );
-		printActivityProgressForListToFile( getActivityFromNode(root), file);
-		printInOrderProgressToFile( getRightNode(root), file);
-	}
+void renderActivitiesProgressHeader(FILE* stream) {
+	fprintf(stream, "\n=============================\n");
+	fprintf(stream, "=== MONITORAGGIO PROGRESSO ===\n");
+	fprintf(stream, "==============================\n");
+	fprintf(stream, "[NOTA: titolo, descrizione e corso potrebbero essere abbreviati. Vai al dettaglio attività per vedere le info complete]\n");
+	fprintf(stream, "[Le attività sono ordinate per id. Qui NON vengono mostrate le attività completate]\n");
+	fprintf(stream, "\n====================================================================================================================================================\n");
+	fprintf(stream, "[id] Titolo | Descrizione | Corso | Priorità | Progresso (%%) | Tempo usato (min) | Tempo al completamento (min) | Tempo totale (min) | Data scadenza\n");
+	fprintf(stream, "====================================================================================================================================================\n\n");
 }
 
 /*
- * printTreeActivitiesProgressToFile
+ * printTreeActivitiesProgress
  * 
  * Syntactic Specification:
- * void printTreeActivitiesProgressToFile(TreeNode root, FILE* file);
+ * void printTreeActivitiesProgress(TreeNode root);
  * 
  * Semantic Specification:
- * Prints the progress of all container activities to file (progress list format, one per line).
+ * Prints the progress of all container activities (progress list format, one per line) with headers.
  * 
  * Preconditions:
- * - 'file' must be opened for writing
+ * - None
  * 
  * Postconditions:
- * - If both parameters are valid, prints progress with header
+ * - If 'root != NULL', prints progress of all activities in tree
  * 
  * Side Effects:
- * - Writing to file
+ * - Output to stdout
  */
-void printTreeActivitiesProgressToFile(TreeNode root, FILE* file) {
-	if (root != NULL && file != NULL) {
-		fprintf(file, "=== MONITORAGGIO PROGRESSO ===\n");
-		printInOrderProgressToFile(root, file);
-	}
+void printTreeActivitiesProgress(TreeNode root) {
+	renderTreeActivitiesProgress(root, stdout);
 }
 
 
@@ -394,82 +456,79 @@ void printTreeActivitiesProgressToFile(TreeNode root, FILE* file) {
 
 
 /*
- * buildInOrderSupportListsForActivitiesReport
+ * buildInOrderSupportVectorsForActivitiesReport
  * 
  * Syntactic Specification:
- * void buildInOrderSupportListsForActivitiesReport(Node* root, 
- *     ActivitiesContainerSupportList completedList,
- *     ActivitiesContainerSupportList ongoingList, 
- *     ActivitiesContainerSupportList expiredList,
- *     ActivitiesContainerSupportList yetToBeginList, 
+ * void buildInOrderSupportVectorsForActivitiesReport(Node* root, 
+ *     ActivitiesContainerSupportVector completedVector,
+ *     ActivitiesContainerSupportVector ongoingVector, 
+ *     ActivitiesContainerSupportVector expiredVector,
+ *     ActivitiesContainerSupportVector yetToBeginVector, 
  *     time_t beginDate, time_t nowDate);
  * 
  * Semantic Specification:
- * Builds support lists by categorizing activities by status in a given period.
+ * Builds support vectors by categorizing activities by status in a given period.
  * 
  * Preconditions:
- * - All support lists must be initialized
+ * - All support vectors must be initialized
  * - 'beginDate <= nowDate'
  * 
  * Postconditions:
  * - Activities are categorized based on their status:
- *   - 'completedList': activities completed in the specified period
- *   - 'ongoingList': ongoing activities
- *   - 'expiredList': expired activities (no completed activities here)
- *   - 'yetToBeginList': activities not yet started
+ *   - 'completedVector': activities completed in the specified period
+ *   - 'ongoingVector': ongoing activities
+ *   - 'expiredVector': expired activities (no completed activities here)
+ *   - 'yetToBeginVector': activities not yet started
+ * - Activities are appended in ascending order of ID (equivalent activities stay in this order after a stable sort)
  * 
  * Side Effects:
  * - Memory allocation
  */
-void buildInOrderSupportListsForActivitiesReport(TreeNode root, ActivitiesContainerSupportList completedList, ActivitiesContainerSupportList ongoingList, ActivitiesContainerSupportList expiredList, ActivitiesContainerSupportList yetToBeginList, time_t beginDate, time_t nowDate) {
+void buildInOrderSupportVectorsForActivitiesReport(TreeNode root, ActivitiesContainerSupportVector completedVector, ActivitiesContainerSupportVector ongoingVector, ActivitiesContainerSupportVector expiredVector, ActivitiesContainerSupportVector yetToBeginVector, time_t beginDate, time_t nowDate) {
 	if (root != NULL) {
-		buildInOrderSupportListsForActivitiesReport( getLeftNode(root), completedList, ongoingList, expiredList, yetToBeginList, beginDate, nowDate); //left
+		buildInOrderSupportVectorsForActivitiesReport( getLeftNode(root), completedVector, ongoingVector, expiredVector, yetToBeginVector, beginDate, nowDate); //left
 		
 		Activity activity = getActivityFromNode(root);
 		int isCompleted = isActivityCompleted(activity);
 		if (isCompleted == 1) { //all complete activities
 			int wasCompletedInLastPeriod = wasActivityCompletedAfterDate(activity, beginDate);
 			if (wasCompletedInLastPeriod == 1) { //completed in the last period
-				addActivityToSupportList(completedList, activity);
+				addActivityToSupportVector(completedVector, activity);
 			}
 		} else if ( wasActivityExpiredBeforeDate(activity, nowDate) == 1 ) { //expired and not completed
-			addActivityToSupportList(expiredList, activity);
+			addActivityToSupportVector(expiredVector, activity);
 		} else if ( isActivityYetToBegin(activity) == 1 ) { //yet to begin
-			addActivityToSupportList(yetToBeginList, activity);
+			addActivityToSupportVector(yetToBeginVector, activity);
 		} else { //ongoing
-			addActivityToSupportList(ongoingList, activity);
+			addActivityToSupportVector(ongoingVector, activity);
 		}
 		
-		buildInOrderSupportListsForActivitiesReport( getRightNode(root), completedList, ongoingList, expiredList, yetToBeginList, beginDate, nowDate); //right
+		buildInOrderSupportVectorsForActivitiesReport( getRightNode(root), completedVector, ongoingVector, expiredVector, yetToBeginVector, beginDate, nowDate); //right
 	}
 }
 
 
 /*
- * printTreeActivitiesReport
+ * getReportBeginDateFromUser
  * 
  * Syntactic Specification:
- * void printTreeActivitiesReport(TreeNode root);
+ * time_t getReportBeginDateFromUser();
  * 
  * Semantic Specification:
- * Generates and prints a detailed report of activities categorized by status and period.
+ * Interacts with the user to define the beginning of the report period (default: one week ago).
  * 
  * Preconditions:
  * - None
  * 
  * Postconditions:
- * - If 'root' is valid, prints a complete report with categorized activities
- * - Interacts with user to define the report period
+ * - Returns the date chosen by the user, or the default date (one week ago) if the user
+ *   accepts it or inserts a date in the future
  * 
  * Side Effects:
  * - User interaction (input/output)
- * - Output to stdout
  * - Calls to time management functions
- * - Allocates and deallocates temporary support lists
  */
-void printTreeActivitiesReport(TreeNode root) {
-	if (root == NULL) return;
-	
+time_t getReportBeginDateFromUser() {
 	time_t beginDate = time(NULL); //now
 	beginDate = beginDate - 60*60*24*7; //one week ago
 	
@@ -499,54 +558,183 @@ void printTreeActivitiesReport(TreeNode root) {
 		}
 	}
 	
-	ActivitiesContainerSupportList completedList = newSupportList();
-	ActivitiesContainerSupportList ongoingList = newSupportList();
-	ActivitiesContainerSupportList expiredList = newSupportList();
-	ActivitiesContainerSupportList yetToBeginList = newSupportList();
-	buildInOrderSupportListsForActivitiesReport(root, completedList, ongoingList, expiredList, yetToBeginList, beginDate, time(NULL) );
-
-	sortSupportList(completedList, 6); //compareActivityByCompletionDate
-	sortSupportList(yetToBeginList, 4); //compareActivityByInsertDate
-	sortSupportList(ongoingList, 10); //compareActivityByPercentCompletion
-	sortSupportList(expiredList, 5); //compareActivityByExpiryDate
-
-	printf("\n=============================\n");
-	printf("=== REPORT ULTIMO PERIODO ====\n");
-	printf("==============================\n");
-	printf("[NOTA: titolo, descrizione e corso potrebbero essere abbreviati. Vai al dettaglio attività per vedere le info complete]\n");
-	printf("[Qui le attività completate vengono mostrate solo se completate nel periodo di riferimento del report (e non prima)]\n");
-
-	printf("\n\n=========================================================================");
-	printf("\n=== Attività COMPLETATE nel periodo (ordinate per data di completamento):\n");
-	printf("=======================================================================================\n");
-	printf("[id] Titolo | Descrizione | Corso | Priorità | Data scadenza o data completamento\n\n");
-	printActivitiesInSupportList(completedList, 0, NULL); //printActivityForList
+	return beginDate;
+}
+
+/*
+ * renderTreeActivitiesReport
+ * 
+ * Syntactic Specification:
+ * void renderTreeActivitiesReport(TreeNode root, time_t beginDate, time_t nowDate, FILE* stream);
+ * 
+ * Semantic Specification:
+ * Writes to 'stream' the detailed report of activities categorized by status, for the period
+ * from 'beginDate' to 'nowDate'. It's the screen version of the report (with all the headers).
+ * 
+ * Preconditions:
+ * - 'stream' must be opened for writing
+ * - 'beginDate <= nowDate'
+ * 
+ * Postconditions:
+ * - If 'root' is valid, writes a complete report with categorized activities
+ * 
+ * Side Effects:
+ * - Writing to stream
+ * - Allocates and deallocates temporary support vectors
+ */
+void renderTreeActivitiesReport(TreeNode root, time_t beginDate, time_t nowDate, FILE* stream) {
+	if (root == NULL || stream == NULL) return;
 	
-	printf("\n\n=========================================================================");
-	printf("\n=== Attività ANCORA DA INIZIARE (ordinate per data di inserimento):\n");
-	printf("=======================================================================================\n");
-	printf("[id] Titolo | Descrizione | Corso | Priorità | Data scadenza\n\n");
-	printActivitiesInSupportList(yetToBeginList, 0, NULL); //printActivityForList
+	ActivitiesContainerSupportVector completedVector = newSupportVector();
+	ActivitiesContainerSupportVector ongoingVector = newSupportVector();
+	ActivitiesContainerSupportVector expiredVector = newSupportVector();
+	ActivitiesContainerSupportVector yetToBeginVector = newSupportVector();
+	buildInOrderSupportVectorsForActivitiesReport(root, completedVector, ongoingVector, expiredVector, yetToBeginVector, beginDate, nowDate);
+
+	sortSupportVectorByKey(completedVector, 6); //compareActivityByCompletionDate
+	sortSupportVectorByKey(yetToBeginVector, 4); //compareActivityByInsertDate
+	sortSupportVectorByKey(ongoingVector, 10); //compareActivityByPercentCompletion
+	sortSupportVectorByKey(expiredVector, 5); //compareActivityByExpiryDate
+
+	fprintf(stream, "\n=============================\n");
+	fprintf(stream, "=== REPORT ULTIMO PERIODO ====\n");
+	fprintf(stream, "==============================\n");
+	fprintf(stream, "[NOTA: titolo, descrizione e corso potrebbero essere abbreviati. Vai al dettaglio attività per vedere le info complete]\n");
+	fprintf(stream, "[Qui le attività completate vengono mostrate solo se completate nel periodo di riferimento del report (e non prima)]\n");
+
+	fprintf(stream, "\n\n=========================================================================");
+	fprintf(stream, "\n=== Attività COMPLETATE nel periodo (ordinate per data di completamento):\n");
+	fprintf(stream, "=======================================================================================\n");
+	fprintf(stream, "[id] Titolo | Descrizione | Corso | Priorità | Data scadenza o data completamento\n\n");
+	printActivitiesInSupportVector(completedVector, 0, stream); //printActivityForList
 	
-	printf("\n\n=========================================================================");
-	printf("\n=== Attività IN CORSO (ordinate per percentuale di completamento):\n");
-	printf("====================================================================================================================================================\n");
-	printf("[id] Titolo | Descrizione | Corso | Priorità | Progresso (%%) | Tempo usato (min) | Tempo al completamento (min) | Tempo totale (min) | Data scadenza\n\n");
-	printActivitiesInSupportList(ongoingList, 1, NULL); //printActivityProgressForList
+	fprintf(stream, "\n\n=========================================================================");
+	fprintf(stream, "\n=== Attività ANCORA DA INIZIARE (ordinate per data di inserimento):\n");
+	fprintf(stream, "=======================================================================================\n");
+	fprintf(stream, "[id] Titolo | Descrizione | Corso | Priorità | Data scadenza\n\n");
+	printActivitiesInSupportVector(yetToBeginVector, 0, stream); //printActivityForList
 	
-	printf("\n\n=========================================================================");
-	printf("\n=== Attività IN RITARDO (ordinate per data di scadenza):\n");
-	printf("====================================================================================================================================================\n");
-	printf("[id] Titolo | Descrizione | Corso | Priorità | Progresso (%%) | Tempo usato (min) | Tempo al completamento (min) | Tempo totale (min) | Data scadenza\n\n");
-	printActivitiesInSupportList(expiredList, 1, NULL); //printActivityProgressForList
+	fprintf(stream, "\n\n=========================================================================");
+	fprintf(stream, "\n=== Attività IN CORSO (ordinate per percentuale di completamento):\n");
+	fprintf(stream, "====================================================================================================================================================\n");
+	fprintf(stream, "[id] Titolo | Descrizione | Corso | Priorità | Progresso (%%) | Tempo usato (min) | Tempo al completamento (min) | Tempo totale (min) | Data scadenza\n\n");
+	printActivitiesInSupportVector(ongoingVector, 1, stream); //printActivityProgressForList
+	
+	fprintf(stream, "\n\n=========================================================================");
+	fprintf(stream, "\n=== Attività IN RITARDO (ordinate per data di scadenza):\n");
+	fprintf(stream, "====================================================================================================================================================\n");
+	fprintf(stream, "[id] Titolo | Descrizione | Corso | Priorità | Progresso (%%) | Tempo usato (min) | Tempo al completamento (min) | Tempo totale (min) | Data scadenza\n\n");
+	printActivitiesInSupportVector(expiredVector, 1, stream); //printActivityProgressForList
+	
+	fprintf(stream, "\n");
+	
+	//delete support vectors
+	deleteSupportVector(&completedVector);
+	deleteSupportVector(&yetToBeginVector);
+	deleteSupportVector(&ongoingVector);
+	deleteSupportVector(&expiredVector);
+}
+
+/*
+ * printTreeActivitiesReport
+ * 
+ * Syntactic Specification:
+ * void printTreeActivitiesReport(TreeNode root);
+ * 
+ * Semantic Specification:
+ * Generates and prints a detailed report of activities categorized by status and period.
+ * 
+ * Preconditions:
+ * - None
+ * 
+ * Postconditions:
+ * - If 'root' is valid, prints a complete report with categorized activities
+ * - Interacts with user to define the report period
+ * 
+ * Side Effects:
+ * - User interaction (input/output)
+ * - Output to stdout
+ * - Calls to time management functions
+ * - Allocates and deallocates temporary support vectors
+ */
+void printTreeActivitiesReport(TreeNode root) {
+	if (root == NULL) return;
 	
-	printf("\n");
+	time_t beginDate = getReportBeginDateFromUser();
+	renderTreeActivitiesReport(root, beginDate, time(NULL), stdout);
+}
+
+/*
+ * updateInOrderReportValidity
+ * 
+ * Syntactic Specification:
+ * void updateInOrderReportValidity(TreeNode root, time_t beginDate, time_t nowDate, RenderValidity* validity);
+ * 
+ * Semantic Specification:
+ * Recursively narrows the validity ranges of a report made with 'beginDate' and 'nowDate', so that
+ * no activity of the tree changes its report category for dates inside the ranges.
+ * An activity completed in 'c' is in the report iff 'c > beginDate'; a not completed activity
+ * with expiry date 'e > 0' is late iff 'e < nowDate'.
+ * 
+ * Preconditions:
+ * - 'validity != NULL'
+ * 
+ * Postconditions:
+ * - '*validity' excludes every date at which an activity of the tree would change category
+ * 
+ * Side Effects:
+ * - Modifies '*validity'
+ */
+void updateInOrderReportValidity(TreeNode root, time_t beginDate, time_t nowDate, RenderValidity* validity) {
+	if (root != NULL) {
+		updateInOrderReportValidity( getLeftNode(root), beginDate, nowDate, validity);
+		
+		Activity activity = getActivityFromNode(root);
+		if (isActivityCompleted(activity) == 1) {
+			time_t completionDate = getActivityCompletionDate(activity);
+			if (completionDate > beginDate) { // in the report until beginDate reaches it
+				if (completionDate < validity->beginTo) validity->beginTo = completionDate;
+			} else { // out of the report while beginDate stays at or after it
+				if (completionDate > validity->beginFrom) validity->beginFrom = completionDate;
+			}
+		} else {
+			time_t expiryDate = getActivityExpiryDate(activity);
+			if (expiryDate > 0 && expiryDate < nowDate) { // late for every later 'now'
+				if (expiryDate + 1 > validity->nowFrom) validity->nowFrom = expiryDate + 1;
+			} else if (expiryDate > 0) { // late as soon as 'now' goes past it
+				if (expiryDate < validity->nowTo) validity->nowTo = expiryDate;
+			}
+		}
+		
+		updateInOrderReportValidity( getRightNode(root), beginDate, nowDate, validity);
+	}
+}
+
+/*
+ * computeTreeActivitiesReportValidity
+ * 
+ * Syntactic Specification:
+ * void computeTreeActivitiesReportValidity(TreeNode root, time_t beginDate, time_t nowDate, RenderValidity* validity);
+ * 
+ * Semantic Specification:
+ * Computes the ranges of 'beginDate' and 'nowDate' for which the report of the tree stays
+ * exactly the same as the one made with the given dates.
+ * 
+ * Preconditions:
+ * - 'validity != NULL'
+ * 
+ * Postconditions:
+ * - '*validity' contains 'beginDate' and 'nowDate'
+ * - The report is the same for every couple of dates inside '*validity'
+ * 
+ * Side Effects:
+ * - Modifies '*validity'
+ */
+void computeTreeActivitiesReportValidity(TreeNode root, time_t beginDate, time_t nowDate, RenderValidity* validity) {
+	if (validity == NULL) return;
 	
-	//delete support lists
-	deleteSupportList(&completedList);
-	deleteSupportList(&yetToBeginList);
-	deleteSupportList(&ongoingList);
-	deleteSupportList(&expiredList);
+	setRenderValidityToAlways(validity);
+	updateInOrderReportValidity(root, beginDate, nowDate, validity);
 }
 
 /*
@@ -567,42 +755,42 @@ void printTreeActivitiesReport(TreeNode root) {
  * 
  * Side Effects:
  * - Writing to file
- * - Allocates and deallocates temporary support lists
+ * - Allocates and deallocates temporary support vectors
  */
 void printTreeActivitiesReportToFile(TreeNode root, time_t beginDate, FILE* file) {
 	if (root == NULL || file == NULL || beginDate < 0) return;
 	
-	ActivitiesContainerSupportList completedList = newSupportList();
-	ActivitiesContainerSupportList ongoingList = newSupportList();
-	ActivitiesContainerSupportList expiredList = newSupportList();
-	ActivitiesContainerSupportList yetToBeginList = newSupportList();
-	buildInOrderSupportListsForActivitiesReport(root, completedList, ongoingList, expiredList, yetToBeginList, beginDate, time(NULL) );
+	ActivitiesContainerSupportVector completedVector = newSupportVector();
+	ActivitiesContainerSupportVector ongoingVector = newSupportVector();
+	ActivitiesContainerSupportVector expiredVector = newSupportVector();
+	ActivitiesContainerSupportVector yetToBeginVector = newSupportVector();
+	buildInOrderSupportVectorsForActivitiesReport(root, completedVector, ongoingVector, expiredVector, yetToBeginVector, beginDate, time(NULL) );
 
-	sortSupportList(completedList, 6); //compareActivityByCompletionDate
-	sortSupportList(yetToBeginList, 4); //compareActivityByInsertDate
-	sortSupportList(ongoingList, 10); //compareActivityByPercentCompletion
-	sortSupportList(expiredList, 5); //compareActivityByExpiryDate
+	sortSupportVectorByKey(completedVector, 6); //compareActivityByCompletionDate
+	sortSupportVectorByKey(yetToBeginVector, 4); //compareActivityByInsertDate
+	sortSupportVectorByKey(ongoingVector, 10); //compareActivityByPercentCompletion
+	sortSupportVectorByKey(expiredVector, 5); //compareActivityByExpiryDate
 
 	fprintf(file, "Data: %ld\n", beginDate);
 	fprintf(file, "=== REPORT ULTIMO PERIODO ====\n\n");
 
 	fprintf(file, "\n=== Attività COMPLETATE nel periodo (ordinate per data di completamento):\n");
-	printActivitiesInSupportList(completedList, 0, file); //printActivityForListToFile
+	printActivitiesInSupportVector(completedVector, 0, file); //printActivityForListToFile
 	
 	fprintf(file, "\n\n=== Attività ANCORA DA INIZIARE (ordinate per data di inserimento):\n");
-	printActivitiesInSupportList(yetToBeginList, 0, file); //printActivityForListToFile
+	printActivitiesInSupportVector(yetToBeginVector, 0, file); //printActivityForListToFile
 	
 	fprintf(file, "\n\n=== Attività IN CORSO (ordinate per percentuale di completamento):\n");
-	printActivitiesInSupportList(ongoingList, 1, file); //printActivityProgressForListToFile
+	printActivitiesInSupportVector(ongoingVector, 1, file); //printActivityProgressForListToFile
 	
 	fprintf(file, "\n\n=== Attività IN RITARDO (ordinate per data di scadenza):\n");
-	printActivitiesInSupportList(expiredList, 1, file); //printActivityProgressForListToFile
+	printActivitiesInSupportVector(expiredVector, 1, file); //printActivityProgressForListToFile
  
-	//delete support lists
-	deleteSupportList(&completedList);
-	deleteSupportList(&yetToBeginList);
-	deleteSupportList(&ongoingList);
-	deleteSupportList(&expiredList);
+	//delete support vectors
+	deleteSupportVector(&completedVector);
+	deleteSupportVector(&yetToBeginVector);
+	deleteSupportVector(&ongoingVector);
+	deleteSupportVector(&expiredVector);
 }
 
 
@@ -2,6 +2,7 @@
 #define ACTIVITIES_CONTAINER_HELPER_H             // Macro definition to avoid multiple inclusions
 
 #include "activities_container_avl.h"
+#include "activities_container_render_cache.h"
 
 
 /*
@@ -11,14 +12,17 @@
  * int saveActivitiesFromTreeToFile(const char* filename, TreeNode root);
  * 
  * Semantic Specification:
- * Saves all activities from the tree to a file.
+ * Saves all activities from the tree to a file. The records are formatted in a large buffer and
+ * written to a temporary file that replaces the file only when complete and synchronized to the disk
+ * (see 'commitActivityWriter()'): a save interrupted by a crash leaves the previous file intact.
+ * The CRC32C of its blocks is written to a checksum file next to it (see 'verifyActivityChecksums()').
  * 
  * Preconditions:
  * - None
  * 
  * Postconditions:
  * - If 'root == NULL' or 'filename != NULL', returns 1 (error)
- * - If unable to open the file, returns 1 (error)
+ * - If unable to open or write the file, returns 1 (error): the file keeps its previous content
  * - Otherwise, saves all activities and returns 0 (success)
  * 
  * Side Effects:
@@ -111,13 +115,165 @@ void printTreeActivitiesProgress(TreeNode root);
  * - User interaction (input/output)
  * - Output to stdout
  * - Calls to time management functions
- * - Allocates and deallocates temporary support lists
+ * - Allocates and deallocates temporary support vectors
  */
 void printTreeActivitiesReport(TreeNode root);
 
 
 
 
+/*
+ * renderAllActivities
+ * 
+ * Syntactic Specification:
+ * void renderAllActivities(TreeNode root, FILE* stream);
+ * 
+ * Semantic Specification:
+ * Writes to 'stream' all activities (list format, one per line) from the tree in ascending order of ID, with headers.
+ * It's the screen version of the list: printAllActivities uses it with 'stream = stdout'.
+ * 
+ * Preconditions:
+ * - 'stream' must be opened for writing
+ * 
+ * Postconditions:
+ * - If 'root != NULL', writes all activities with headers
+ * 
+ * Side Effects:
+ * - Writing to stream
+ */
+void renderAllActivities(TreeNode root, FILE* stream);
+
+/*
+ * renderAllActivitiesHeader
+ * 
+ * Syntactic Specification:
+ * void renderAllActivitiesHeader(FILE* stream);
+ * 
+ * Semantic Specification:
+ * Writes to 'stream' the headers of the list of all activities (see 'renderAllActivities()').
+ * 
+ * Preconditions:
+ * - 'stream' must be opened for writing
+ * 
+ * Postconditions:
+ * - The headers are written
+ * 
+ * Side Effects:
+ * - Writing to stream
+ */
+void renderAllActivitiesHeader(FILE* stream);
+
+/*
+ * renderTreeActivitiesProgress
+ * 
+ * Syntactic Specification:
+ * void renderTreeActivitiesProgress(TreeNode root, FILE* stream);
+ * 
+ * Semantic Specification:
+ * Writes to 'stream' the progress of all container activities (progress list format, one per line) with headers.
+ * It's the screen version of the progress list: printTreeActivitiesProgress uses it with 'stream = stdout'.
+ * 
+ * Preconditions:
+ * - 'stream' must be opened for writing
+ * 
+ * Postconditions:
+ * - If 'root != NULL', writes progress of all activities in tree
+ * 
+ * Side Effects:
+ * - Writing to stream
+ */
+void renderTreeActivitiesProgress(TreeNode root, FILE* stream);
+
+/*
+ * renderActivitiesProgressHeader
+ * 
+ * Syntactic Specification:
+ * void renderActivitiesProgressHeader(FILE* stream);
+ * 
+ * Semantic Specification:
+ * Writes to 'stream' the headers of the progress list (see 'renderTreeActivitiesProgress()').
+ * 
+ * Preconditions:
+ * - 'stream' must be opened for writing
+ * 
+ * Postconditions:
+ * - The headers are written
+ * 
+ * Side Effects:
+ * - Writing to stream
+ */
+void renderActivitiesProgressHeader(FILE* stream);
+
+/*
+ * getReportBeginDateFromUser
+ * 
+ * Syntactic Specification:
+ * time_t getReportBeginDateFromUser();
+ * 
+ * Semantic Specification:
+ * Interacts with the user to define the beginning of the report period (default: one week ago).
+ * 
+ * Preconditions:
+ * - None
+ * 
+ * Postconditions:
+ * - Returns the date chosen by the user, or the default date (one week ago) if the user
+ *   accepts it or inserts a date in the future
+ * 
+ * Side Effects:
+ * - User interaction (input/output)
+ * - Calls to time management functions
+ */
+time_t getReportBeginDateFromUser();
+
+/*
+ * renderTreeActivitiesReport
+ * 
+ * Syntactic Specification:
+ * void renderTreeActivitiesReport(TreeNode root, time_t beginDate, time_t nowDate, FILE* stream);
+ * 
+ * Semantic Specification:
+ * Writes to 'stream' the detailed report of activities categorized by status, for the period
+ * from 'beginDate' to 'nowDate'. It's the screen version of the report (with all the headers).
+ * 
+ * Preconditions:
+ * - 'stream' must be opened for writing
+ * - 'beginDate <= nowDate'
+ * 
+ * Postconditions:
+ * - If 'root' is valid, writes a complete report with categorized activities
+ * 
+ * Side Effects:
+ * - Writing to stream
+ * - Allocates and deallocates temporary support vectors
+ */
+void renderTreeActivitiesReport(TreeNode root, time_t beginDate, time_t nowDate, FILE* stream);
+
+/*
+ * computeTreeActivitiesReportValidity
+ * 
+ * Syntactic Specification:
+ * void computeTreeActivitiesReportValidity(TreeNode root, time_t beginDate, time_t nowDate, RenderValidity* validity);
+ * 
+ * Semantic Specification:
+ * Computes the ranges of 'beginDate' and 'nowDate' for which the report of the tree stays
+ * exactly the same as the one made with the given dates.
+ * 
+ * Preconditions:
+ * - 'validity != NULL'
+ * 
+ * Postconditions:
+ * - '*validity' contains 'beginDate' and 'nowDate'
+ * - The report is the same for every couple of dates inside '*validity'
+ * 
+ * Side Effects:
+ * - Modifies '*validity'
+ */
+void computeTreeActivitiesReportValidity(TreeNode root, time_t beginDate, time_t nowDate, RenderValidity* validity);
+
+
+
+
 /*
  * printAllActivitiesToFile
  * 
@@ -158,6 +314,26 @@ void printAllActivitiesToFile(TreeNode root, FILE* file);
  */
 void printTreeActivitiesProgressToFile(TreeNode root, FILE* file);
 
+/*
+ * printActivitiesProgressHeaderToFile
+ * 
+ * Syntactic Specification:
+ * void printActivitiesProgressHeaderToFile(FILE* file);
+ * 
+ * Semantic Specification:
+ * Writes to file the header of the progress list (see 'printTreeActivitiesProgressToFile()').
+ * 
+ * Preconditions:
+ * - 'file' must be opened for writing
+ * 
+ * Postconditions:
+ * - The header is written
+ * 
+ * Side Effects:
+ * - Writing to file
+ */
+void printActivitiesProgressHeaderToFile(FILE* file);
+
 /*
  * printTreeActivitiesReportToFile
  * 
@@ -176,7 +352,7 @@ void printTreeActivitiesProgressToFile(TreeNode root, FILE* file);
  * 
  * Side Effects:
  * - Writing to file
- * - Allocates and deallocates temporary support lists
+ * - Allocates and deallocates temporary support vectors
  */
 void printTreeActivitiesReportToFile(TreeNode root, time_t beginDate, FILE* file);
 
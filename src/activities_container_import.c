@@ -0,0 +1,917 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <errno.h>
+#include "activity.h"
+#include "activities_container_loader.h"
+#include "activities_container_import.h"
+
+// Longest JSON number token kept for a field
+#define IMPORT_NUMBER_MAX_LENGTH 31
+// Initial number of activities of the array returned by 'readImportedActivities()'
+#define IMPORT_INITIAL_CAPACITY 64
+
+// Names of the fields in the exports (ACTIVITY_EXPORT_CSV_HEADER), by ACTIVITY_FIELD_*: the default columns
+const char* const activityImportFieldNames[ACTIVITY_IMPORT_FIELD_COUNT] = {
+	"id", "titolo", "descrizione", "corso", "data_inserimento", "data_scadenza",
+	"data_completamento", "tempo_totale", "tempo_impiegato", "priorita"
+};
+
+
+/*
+ * "struct activityImportMapping" Documentation
+ *
+ * Syntactic Specification:
+ * struct activityImportMapping {
+ *     char* columns[ACTIVITY_IMPORT_FIELD_COUNT];
+ * };
+ *
+ * Semantic Specification:
+ * Columns (CSV header names or JSON keys) the fields of the activities are read from.
+ *
+ * Fields:
+ * - columns: Column of every field (by ACTIVITY_FIELD_*), NULL if the field is not imported
+ */
+struct activityImportMapping {
+	char* columns[ACTIVITY_IMPORT_FIELD_COUNT];
+};
+
+
+/*
+ * "struct importRecordReader" Documentation
+ *
+ * Syntactic Specification:
+ * typedef struct importRecordReader {
+ *     FILE* file;
+ *     char* line;
+ *     size_t lineCapacity;
+ *     char* record;
+ *     size_t recordLength;
+ *     size_t recordCapacity;
+ *     unsigned long lineNumber;
+ *     unsigned long recordLine;
+ *     char** fields;
+ *     int fieldCount;
+ *     int fieldCapacity;
+ *     char numbers[ACTIVITY_IMPORT_FIELD_COUNT][IMPORT_NUMBER_MAX_LENGTH + 1];
+ * } ImportRecordReader;
+ *
+ * Semantic Specification:
+ * Reader of the records of an imported file, one at a time: its buffers are reused by every record.
+ *
+ * Fields:
+ * - file: The file being read
+ * - line, lineCapacity: Buffer of 'getline()'
+ * - record, recordLength, recordCapacity: The current record (a CSV record can span several lines)
+ * - lineNumber: Number of lines read
+ * - recordLine: Line the current record begins at
+ * - fields, fieldCount, fieldCapacity: Fields of the current CSV record (pointers into 'record')
+ * - numbers: The JSON numbers of the current record, for the fields they are read for
+ */
+typedef struct importRecordReader {
+	FILE* file;
+	char* line;
+	size_t lineCapacity;
+	char* record;
+	size_t recordLength;
+	size_t recordCapacity;
+	unsigned long lineNumber;
+	unsigned long recordLine;
+	char** fields;
+	int fieldCount;
+	int fieldCapacity;
+	char numbers[ACTIVITY_IMPORT_FIELD_COUNT][IMPORT_NUMBER_MAX_LENGTH + 1];
+} ImportRecordReader;
+
+
+/*
+ * newActivityImportMapping
+ *
+ * Syntactic Specification:
+ * ActivityImportMapping newActivityImportMapping(void);
+ *
+ * Semantic Specification:
+ * Creates a mapping of the fields of the activities to the columns of a CSV file (by the names in its
+ * header) or to the keys of the objects of a JSON Lines file. Every field starts mapped to the column
+ * with its name in the exports (see ACTIVITY_EXPORT_CSV_HEADER), so an export is imported as it is.
+ *
+ * Preconditions:
+ * - None
+ *
+ * Postconditions:
+ * - Returns the new mapping, NULL if memory allocation fails
+ *
+ * Side Effects:
+ * - Allocates memory
+ */
+ActivityImportMapping newActivityImportMapping(void) {
+	ActivityImportMapping mapping = calloc(1, sizeof(struct activityImportMapping));
+	if (mapping == NULL) return NULL;
+
+	for (int field = 0; field < ACTIVITY_IMPORT_FIELD_COUNT; field++) {
+		if (setActivityImportMappingColumn(mapping, field, activityImportFieldNames[field]) != 0) {
+			deleteActivityImportMapping(&mapping);
+			return NULL;
+		}
+	}
+	return mapping;
+}
+
+/*
+ * setActivityImportMappingColumn
+ *
+ * Syntactic Specification:
+ * int setActivityImportMappingColumn(ActivityImportMapping mapping, int field, const char* column);
+ *
+ * Semantic Specification:
+ * Maps a field (ACTIVITY_FIELD_*) to a column; with 'column == NULL' the field is not imported (it
+ * takes its default value, see 'readImportedActivities()').
+ *
+ * Preconditions:
+ * - None
+ *
+ * Postconditions:
+ * - Returns 0 on success, 1 if 'mapping' is NULL, 'field' is not a field or memory allocation fails
+ *
+ * Side Effects:
+ * - Modifies the mapping
+ */
+int setActivityImportMappingColumn(ActivityImportMapping mapping, int field, const char* column) {
+	if (mapping == NULL || field < 0 || field >= ACTIVITY_IMPORT_FIELD_COUNT) return 1;
+
+	char* copy = NULL;
+	if (column != NULL) {
+		copy = malloc(strlen(column) + 1);
+		if (copy == NULL) return 1;
+		strcpy(copy, column);
+	}
+	free(mapping->columns[field]);
+	mapping->columns[field] = copy;
+	return 0;
+}
+
+/*
+ * parseActivityImportMapping
+ *
+ * Syntactic Specification:
+ * int parseActivityImportMapping(ActivityImportMapping mapping, const char* spec);
+ *
+ * Semantic Specification:
+ * Changes the mapping as described by a text of comma separated pairs "field=column", where field is the
+ * export name of a field (e.g. "titolo=Nome attività,corso=Insegnamento,id="): an empty column means that
+ * the field is not imported. The fields not named keep their mapping.
+ *
+ * Preconditions:
+ * - None
+ *
+ * Postconditions:
+ * - Returns 0 on success
+ * - Returns 1 if a pair is not valid or names an unknown field (the pairs before it are applied)
+ *
+ * Side Effects:
+ * - Modifies the mapping
+ */
+int parseActivityImportMapping(ActivityImportMapping mapping, const char* spec) {
+	if (mapping == NULL || spec == NULL) return 1;
+
+	const char* pair = spec;
+	while (*pair != '\0') {
+		size_t pairLength = strcspn(pair, ",");
+		const char* equals = memchr(pair, '=', pairLength);
+		if (equals == NULL) return 1;
+
+		int field = -1;
+		size_t nameLength = (size_t)(equals - pair);
+		for (int f = 0; f < ACTIVITY_IMPORT_FIELD_COUNT; f++) {
+			if (strlen(activityImportFieldNames[f]) == nameLength && strncmp(pair, activityImportFieldNames[f], nameLength) == 0) {
+				field = f;
+				break;
+			}
+		}
+		if (field < 0) return 1;
+
+		size_t columnLength = pairLength - nameLength - 1;
+		if (columnLength == 0) {
+			setActivityImportMappingColumn(mapping, field, NULL);
+		} else {
+			char* column = malloc(columnLength + 1);
+			if (column == NULL) return 1;
+			memcpy(column, equals + 1, columnLength);
+			column[columnLength] = '\0';
+			int result = setActivityImportMappingColumn(mapping, field, column);
+			free(column);
+			if (result != 0) return 1;
+		}
+
+		pair += pairLength;
+		if (*pair == ',') pair++;
+	}
+	return 0;
+}
+
+/*
+ * deleteActivityImportMapping
+ *
+ * Syntactic Specification:
+ * void deleteActivityImportMapping(ActivityImportMapping* mapping);
+ *
+ * Semantic Specification:
+ * Deallocates the mapping. The parameter is a pointer passed by reference.
+ *
+ * Preconditions:
+ * - 'mapping' can be NULL or point to a valid/NULL pointer
+ *
+ * Postconditions:
+ * - '*mapping' is set to NULL
+ *
+ * Side Effects:
+ * - Deallocates memory
+ */
+void deleteActivityImportMapping(ActivityImportMapping* mapping) {
+	if (mapping == NULL || *mapping == NULL) return;
+
+	for (int field = 0; field < ACTIVITY_IMPORT_FIELD_COUNT; field++) free((*mapping)->columns[field]);
+	free(*mapping);
+	*mapping = NULL;
+}
+
+/*
+ * readImportRecord
+ *
+ * Syntactic Specification:
+ * int readImportRecord(ImportRecordReader* reader, int csv);
+ *
+ * Semantic Specification:
+ * Reads the next record, without its final line end ("\n" or "\r\n"). A JSON Lines record is a line; a
+ * CSV record goes on with the next lines while a double quoted field is open (an odd number of '"').
+ *
+ * Preconditions:
+ * - 'reader' with an open file
+ *
+ * Postconditions:
+ * - Returns 0 if a record has been read ('reader->record', 'reader->recordLine')
+ * - Returns 1 at the end of the file, 2 if memory allocation fails
+ *
+ * Side Effects:
+ * - Reading from file
+ * - Allocates memory (buffers of the reader)
+ */
+int readImportRecord(ImportRecordReader* reader, int csv) {
+	reader->recordLength = 0;
+	reader->recordLine = reader->lineNumber + 1;
+	int inQuotes = 0;
+
+	do {
+		ssize_t lineLength = getline(&reader->line, &reader->lineCapacity, reader->file);
+		if (lineLength < 0) {
+			if (reader->recordLength == 0) return 1;
+			break; // a quoted field left open at the end of the file: the record is rejected as malformed
+		}
+		reader->lineNumber++;
+
+		if ((size_t)lineLength + reader->recordLength + 1 > reader->recordCapacity) {
+			size_t capacity = (reader->recordCapacity == 0) ? 256 : reader->recordCapacity;
+			while ((size_t)lineLength + reader->recordLength + 1 > capacity) capacity *= 2;
+			char* record = realloc(reader->record, capacity);
+			if (record == NULL) return 2;
+			reader->record = record;
+			reader->recordCapacity = capacity;
+		}
+		memcpy(reader->record + reader->recordLength, reader->line, (size_t)lineLength);
+		reader->recordLength += (size_t)lineLength;
+
+		if (csv) {
+			for (ssize_t i = 0; i < lineLength; i++) {
+				if (reader->line[i] == '"') inQuotes = !inQuotes;
+			}
+		}
+	} while (inQuotes);
+
+	if (reader->recordLength > 0 && reader->record[reader->recordLength - 1] == '\n') reader->recordLength--;
+	if (reader->recordLength > 0 && reader->record[reader->recordLength - 1] == '\r') reader->recordLength--;
+	reader->record[reader->recordLength] = '\0';
+	return 0;
+}
+
+/*
+ * splitCsvRecord
+ *
+ * Syntactic Specification:
+ * int splitCsvRecord(ImportRecordReader* reader);
+ *
+ * Semantic Specification:
+ * Splits the current record into its CSV fields, in place: the double quotes of a quoted field are
+ * removed and its doubled double quotes become one.
+ *
+ * Preconditions:
+ * - A record has been read by 'readImportRecord()'
+ *
+ * Postconditions:
+ * - Returns 0 and sets 'reader->fields' and 'reader->fieldCount' if the record is valid
+ * - Returns 1 if a quoted field is not closed or is followed by something else than a comma
+ * - Returns 2 if memory allocation fails
+ *
+ * Side Effects:
+ * - Modifies the record and the fields of the reader
+ */
+int splitCsvRecord(ImportRecordReader* reader) {
+	reader->fieldCount = 0;
+	char* read = reader->record;
+
+	while (1) {
+		char* start = read;
+		char* write = read;
+		if (*read == '"') {
+			read++;
+			while (1) {
+				if (*read == '\0') return 1;
+				if (*read == '"') {
+					if (read[1] != '"') break;
+					read++;
+				}
+				*write++ = *read++;
+			}
+			read++;
+			if (*read != ',' && *read != '\0') return 1;
+		} else {
+			while (*read != ',' && *read != '\0') read++;
+			write = read;
+		}
+
+		if (reader->fieldCount == reader->fieldCapacity) {
+			int capacity = (reader->fieldCapacity == 0) ? 16 : reader->fieldCapacity * 2;
+			char** fields = realloc(reader->fields, (size_t)capacity * sizeof(char*));
+			if (fields == NULL) return 2;
+			reader->fields = fields;
+			reader->fieldCapacity = capacity;
+		}
+		reader->fields[reader->fieldCount++] = start;
+
+		char separator = *read;
+		*write = '\0';
+		if (separator == '\0') return 0;
+		read++;
+	}
+}
+
+/*
+ * skipJsonSpace
+ *
+ * Syntactic Specification:
+ * char* skipJsonSpace(char* text);
+ *
+ * Semantic Specification:
+ * Skips the JSON white space (space, tab, '\r', '\n') at the beginning of a text.
+ *
+ * Preconditions:
+ * - 'text' is a valid string
+ *
+ * Postconditions:
+ * - Returns the first character that is not white space
+ *
+ * Side Effects:
+ * - None
+ */
+char* skipJsonSpace(char* text) {
+	while (*text == ' ' || *text == '\t' || *text == '\r' || *text == '\n') text++;
+	return text;
+}
+
+/*
+ * readJsonHexQuad
+ *
+ * Syntactic Specification:
+ * int readJsonHexQuad(const char* text, unsigned int* value);
+ *
+ * Semantic Specification:
+ * Reads the 4 hexadecimal digits of a \u escape.
+ *
+ * Preconditions:
+ * - 'text' is a valid string, 'value != NULL'
+ *
+ * Postconditions:
+ * - Returns 0 and sets '*value' if the 4 characters are hexadecimal digits, 1 otherwise
+ *
+ * Side Effects:
+ * - None
+ */
+int readJsonHexQuad(const char* text, unsigned int* value) {
+	*value = 0;
+	for (int i = 0; i < 4; i++) {
+		char c = text[i];
+		unsigned int digit;
+		if (c >= '0' && c <= '9') digit = (unsigned int)(c - '0');
+		else if (c >= 'a' && c <= 'f') digit = (unsigned int)(c - 'a' + 10);
+		else if (c >= 'A' && c <= 'F') digit = (unsigned int)(c - 'A' + 10);
+		else return 1;
+		*value = (*value << 4) | digit;
+	}
+	return 0;
+}
+
+/*
+ * readJsonString
+ *
+ * Syntactic Specification:
+ * char* readJsonString(char* text, char** value);
+ *
+ * Semantic Specification:
+ * Reads a JSON string and decodes it in place (the decoded string is never longer than its JSON text):
+ * the escapes are replaced by their characters, the \u escapes (surrogate pairs included) in UTF-8.
+ *
+ * Preconditions:
+ * - 'text' points to the opening '"', 'value != NULL'
+ *
+ * Postconditions:
+ * - Returns the character after the closing '"' and sets '*value' to the decoded string
+ * - Returns NULL if the string is not valid (not closed, unknown escape, control character, \u0000,
+ *   unpaired surrogate)
+ *
+ * Side Effects:
+ * - Modifies the text
+ */
+char* readJsonString(char* text, char** value) {
+	char* read = text + 1;
+	char* write = read;
+	*value = read;
+
+	while (*read != '"') {
+		unsigned char c = (unsigned char)*read;
+		if (c == '\0' || c < 0x20) return NULL;
+		if (c != '\\') {
+			*write++ = *read++;
+			continue;
+		}
+
+		read++;
+		switch (*read) {
+			case '"':	*write++ = '"';
+						break;
+			case '\\':	*write++ = '\\';
+						break;
+			case '/':	*write++ = '/';
+						break;
+			case 'b':	*write++ = '\b';
+						break;
+			case 'f':	*write++ = '\f';
+						break;
+			case 'n':	*write++ = '\n';
+						break;
+			case 'r':	*write++ = '\r';
+						break;
+			case 't':	*write++ = '\t';
+						break;
+			case 'u': {
+				unsigned int code;
+				if (readJsonHexQuad(read + 1, &code) != 0 || code == 0) return NULL;
+				read += 4;
+				if (code >= 0xDC00 && code <= 0xDFFF) return NULL;
+				if (code >= 0xD800 && code <= 0xDBFF) {
+					unsigned int low;
+					if (read[1] != '\\' || read[2] != 'u' || readJsonHexQuad(read + 3, &low) != 0) return NULL;
+					if (low < 0xDC00 || low > 0xDFFF) return NULL;
+					code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+					read += 6;
+				}
+
+				if (code < 0x80) {
+					*write++ = (char)code;
+				} else if (code < 0x800) {
+					*write++ = (char)(0xC0 | (code >> 6));
+					*write++ = (char)(0x80 | (code & 0x3F));
+				} else if (code < 0x10000) {
+					*write++ = (char)(0xE0 | (code >> 12));
+					*write++ = (char)(0x80 | ((code >> 6) & 0x3F));
+					*write++ = (char)(0x80 | (code & 0x3F));
+				} else {
+					*write++ = (char)(0xF0 | (code >> 18));
+					*write++ = (char)(0x80 | ((code >> 12) & 0x3F));
+					*write++ = (char)(0x80 | ((code >> 6) & 0x3F));
+					*write++ = (char)(0x80 | (code & 0x3F));
+				}
+				break;
+			}
+			default:	return NULL;
+		}
+		read++;
+	}
+
+	*write = '\0';
+	return read + 1;
+}
+
+/*
+ * parseJsonlRecord
+ *
+ * Syntactic Specification:
+ * int parseJsonlRecord(ImportRecordReader* reader, ActivityImportMapping mapping, char** values, const char** reason);
+ *
+ * Semantic Specification:
+ * Parses the current record as a flat JSON object and sets the value of every field whose column is one
+ * of its keys: strings are decoded in place, numbers and booleans are copied in 'reader->numbers' (as
+ * their text, rejected by the numeric fields), null is an empty value. The keys that are not mapped are skipped, whatever their value (but objects and arrays).
+ *
+ * Preconditions:
+ * - A record has been read by 'readImportRecord()'
+ * - 'values' has ACTIVITY_IMPORT_FIELD_COUNT elements, all NULL
+ *
+ * Postconditions:
+ * - Returns 0 if the record is a valid flat object
+ * - Returns 1 and sets '*reason' otherwise
+ *
+ * Side Effects:
+ * - Modifies the record and the numbers of the reader
+ */
+int parseJsonlRecord(ImportRecordReader* reader, ActivityImportMapping mapping, char** values, const char** reason) {
+	*reason = "oggetto JSON non valido";
+	char* p = skipJsonSpace(reader->record);
+	if (*p != '{') return 1;
+	p = skipJsonSpace(p + 1);
+
+	if (*p == '}') {
+		p++;
+	} else {
+		while (1) {
+			char* key;
+			if (*p != '"' || (p = readJsonString(p, &key)) == NULL) return 1;
+			p = skipJsonSpace(p);
+			if (*p != ':') return 1;
+			p = skipJsonSpace(p + 1);
+
+			char* value = NULL;
+			char* number = NULL;
+			size_t numberLength = 0;
+			if (*p == '"') {
+				char* str;
+				if ((p = readJsonString(p, &str)) == NULL) return 1;
+				value = str;
+			} else if (strncmp(p, "null", 4) == 0) {
+				p += 4;
+			} else if (strncmp(p, "true", 4) == 0 || strncmp(p, "false", 5) == 0) {
+				number = p;
+				numberLength = (*p == 't') ? 4 : 5;
+				p += numberLength;
+			} else if (*p == '-' || (*p >= '0' && *p <= '9')) {
+				number = p;
+				while (*p == '-' || *p == '+' || *p == '.' || *p == 'e' || *p == 'E' || (*p >= '0' && *p <= '9')) p++;
+				numberLength = (size_t)(p - number);
+			} else {
+				*reason = (*p == '{' || *p == '[') ? "oggetto JSON non piatto" : "oggetto JSON non valido";
+				return 1;
+			}
+
+			for (int field = 0; field < ACTIVITY_IMPORT_FIELD_COUNT; field++) {
+				if (mapping->columns[field] == NULL || strcmp(mapping->columns[field], key) != 0) continue;
+				if (number != NULL) {
+					if (numberLength > IMPORT_NUMBER_MAX_LENGTH) {
+						*reason = "numero non valido";
+						return 1;
+					}
+					memcpy(reader->numbers[field], number, numberLength);
+					reader->numbers[field][numberLength] = '\0';
+					values[field] = reader->numbers[field];
+				} else {
+					values[field] = value;
+				}
+			}
+
+			p = skipJsonSpace(p);
+			if (*p == '}') {
+				p++;
+				break;
+			}
+			if (*p != ',') return 1;
+			p = skipJsonSpace(p + 1);
+		}
+	}
+
+	if (*skipJsonSpace(p) != '\0') return 1;
+	return 0;
+}
+
+/*
+ * parseImportInteger
+ *
+ * Syntactic Specification:
+ * int parseImportInteger(const char* text, long long min, long long max, long long* value);
+ *
+ * Semantic Specification:
+ * Reads a decimal integer (white space allowed around it) in the range [min, max].
+ *
+ * Preconditions:
+ * - 'text' is a valid string, 'value != NULL'
+ *
+ * Postconditions:
+ * - Returns 0 and sets '*value' if the text is an integer in the range, 1 otherwise
+ *
+ * Side Effects:
+ * - None
+ */
+int parseImportInteger(const char* text, long long min, long long max, long long* value) {
+	char* end;
+	errno = 0;
+	long long number = strtoll(text, &end, 10);
+	if (end == text || errno != 0) return 1;
+	while (*end == ' ' || *end == '\t') end++;
+	if (*end != '\0' || number < min || number > max) return 1;
+
+	*value = number;
+	return 0;
+}
+
+/*
+ * parseImportDate
+ *
+ * Syntactic Specification:
+ * int parseImportDate(const char* text, time_t* value);
+ *
+ * Semantic Specification:
+ * Reads a date as seconds since the epoch or as "YYYY-MM-DD" (midnight, local time).
+ *
+ * Preconditions:
+ * - 'text' is a valid string, 'value != NULL'
+ *
+ * Postconditions:
+ * - Returns 0 and sets '*value' if the text is a valid date, 1 otherwise
+ *
+ * Side Effects:
+ * - None
+ */
+int parseImportDate(const char* text, time_t* value) {
+	int year, month, day;
+	char extra;
+	if (strlen(text) == 10 && text[4] == '-' && sscanf(text, "%4d-%2d-%2d%c", &year, &month, &day, &extra) == 3) {
+		struct tm date = {0};
+		date.tm_year = year - 1900;
+		date.tm_mon = month - 1;
+		date.tm_mday = day;
+		date.tm_isdst = -1;
+		time_t seconds = mktime(&date);
+		// 'mktime()' normalizes the days out of range: a different day means an invalid date
+		if (seconds == (time_t)-1 || date.tm_mday != day || date.tm_mon != month - 1) return 1;
+		*value = seconds;
+		return 0;
+	}
+
+	long long seconds;
+	if (parseImportInteger(text, LONG_MIN, LONG_MAX, &seconds) != 0) return 1;
+	*value = (time_t)seconds;
+	return 0;
+}
+
+/*
+ * normalizeImportString
+ *
+ * Syntactic Specification:
+ * int normalizeImportString(char* str);
+ *
+ * Semantic Specification:
+ * Replaces the line ends of an imported string ("\r\n", '\r' or '\n') with a space, in place, since the
+ * text format stores every string on a line.
+ *
+ * Preconditions:
+ * - 'str' is a valid string
+ *
+ * Postconditions:
+ * - Returns 0 if the string fits in a line of the text format, 1 if it's too long
+ *
+ * Side Effects:
+ * - Modifies the string
+ */
+int normalizeImportString(char* str) {
+	char* write = str;
+	for (char* read = str; *read != '\0'; read++) {
+		if (*read == '\r' && read[1] == '\n') read++;
+		*write++ = (*read == '\r' || *read == '\n') ? ' ' : *read;
+	}
+	*write = '\0';
+	return ((size_t)(write - str) >= MAPPED_LINE_MAX_LENGTH) ? 1 : 0;
+}
+
+/*
+ * buildImportedActivity
+ *
+ * Syntactic Specification:
+ * int buildImportedActivity(char** values, time_t importDate, Activity* activity, const char** reason);
+ *
+ * Semantic Specification:
+ * Validates the values of the fields of a row (see 'readImportedActivities()') and creates its activity.
+ * An empty value is a missing one.
+ *
+ * Preconditions:
+ * - 'values' has ACTIVITY_IMPORT_FIELD_COUNT elements (NULL if missing), 'activity' and 'reason' not NULL
+ *
+ * Postconditions:
+ * - Returns 0 and sets '*activity' if the row is valid
+ * - Returns 1 and sets '*reason' if it isn't
+ * - Returns 2 if memory allocation fails
+ *
+ * Side Effects:
+ * - Modifies the strings of the row (see 'normalizeImportString()')
+ * - Allocates memory
+ */
+int buildImportedActivity(char** values, time_t importDate, Activity* activity, const char** reason) {
+	for (int field = 0; field < ACTIVITY_IMPORT_FIELD_COUNT; field++) {
+		if (values[field] != NULL && values[field][0] == '\0') values[field] = NULL;
+	}
+
+	long long id = 0;
+	if (values[ACTIVITY_FIELD_ID] != NULL && parseImportInteger(values[ACTIVITY_FIELD_ID], 1, INT_MAX, &id) != 0) {
+		*reason = "id non valido";
+		return 1;
+	}
+	if (values[ACTIVITY_FIELD_NAME] == NULL) {
+		*reason = "titolo mancante";
+		return 1;
+	}
+	for (int field = ACTIVITY_FIELD_NAME; field <= ACTIVITY_FIELD_COURSE; field++) {
+		if (values[field] != NULL && normalizeImportString(values[field]) != 0) {
+			*reason = "testo troppo lungo";
+			return 1;
+		}
+	}
+
+	time_t dates[3] = { importDate, 0, 0 };
+	for (int field = ACTIVITY_FIELD_INSERT_DATE; field <= ACTIVITY_FIELD_COMPLETION_DATE; field++) {
+		if (values[field] != NULL && parseImportDate(values[field], &dates[field - ACTIVITY_FIELD_INSERT_DATE]) != 0) {
+			*reason = "data non valida";
+			return 1;
+		}
+	}
+
+	long long times[2] = { 0, 0 };
+	for (int field = ACTIVITY_FIELD_TOTAL_TIME; field <= ACTIVITY_FIELD_USED_TIME; field++) {
+		if (values[field] != NULL && parseImportInteger(values[field], 0, UINT_MAX, &times[field - ACTIVITY_FIELD_TOTAL_TIME]) != 0) {
+			*reason = "tempo non valido";
+			return 1;
+		}
+	}
+
+	long long priority = 2;
+	if (values[ACTIVITY_FIELD_PRIORITY] != NULL && parseImportInteger(values[ACTIVITY_FIELD_PRIORITY], 1, 3, &priority) != 0) {
+		*reason = "priorità non valida";
+		return 1;
+	}
+
+	*activity = newActivity((int)id, values[ACTIVITY_FIELD_NAME], values[ACTIVITY_FIELD_DESCR], values[ACTIVITY_FIELD_COURSE],
+	                        dates[0], dates[1], dates[2], (unsigned int)times[0], (unsigned int)times[1],
+	                        (short unsigned int)priority);
+	return (*activity == NULL) ? 2 : 0;
+}
+
+/*
+ * readImportedActivities
+ *
+ * Syntactic Specification:
+ * int readImportedActivities(const char* filename, int format, ActivityImportMapping mapping, time_t importDate,
+ *                            Activity** activities, int* count, int* rejectedCount);
+ *
+ * Semantic Specification:
+ * Reads the activities of a CSV (ACTIVITY_IMPORT_CSV, RFC 4180, first line with the names of the columns)
+ * or JSON Lines (ACTIVITY_IMPORT_JSONL, one flat object per line) file. The file is read one record at a
+ * time: only the record being read is kept in memory besides the activities. Every row is validated and a
+ * row that is not valid is rejected (the first ACTIVITY_IMPORT_MAX_REPORTED_ROWS are reported with their
+ * line and reason):
+ * - id: empty or missing for a new id (left 0, assigned by the container), otherwise from 1 to INT_MAX
+ * - titolo: required, not empty
+ * - descrizione, corso: can be empty (NULL); line ends in the strings become spaces (the text format has a
+ *   line per field) and every string must be shorter than MAPPED_LINE_MAX_LENGTH characters
+ * - dates: seconds since the epoch or "YYYY-MM-DD" (local midnight); if empty, 'importDate' for the insert
+ *   date and 0 (none) for the others
+ * - tempo_totale, tempo_impiegato: from 0 to UINT_MAX, 0 if empty
+ * - priorita: from 1 to 3, 2 if empty
+ *
+ * Preconditions:
+ * - 'mapping != NULL', 'activities', 'count' and 'rejectedCount' not NULL
+ *
+ * Postconditions:
+ * - Returns 0 if the file has been read: '*activities' is a new array with the '*count' valid activities in
+ *   file order (the caller deallocates the array and owns the activities), '*rejectedCount' is the number of
+ *   rejected rows
+ * - Returns 1 if the file can't be opened, the CSV header lacks the column of the title or memory allocation
+ *   fails: no activity is returned
+ *
+ * Side Effects:
+ * - Reading from file
+ * - Output to stdout (rejected rows)
+ * - Allocates memory
+ */
+int readImportedActivities(const char* filename, int format, ActivityImportMapping mapping, time_t importDate,
+                           Activity** activities, int* count, int* rejectedCount) {
+	*activities = NULL;
+	*count = 0;
+	*rejectedCount = 0;
+	if (filename == NULL || mapping == NULL) return 1;
+
+	ImportRecordReader reader = {0};
+	reader.file = fopen(filename, "r");
+	if (reader.file == NULL) {
+		printf("Errore nell'apertura del file %s.\n", filename);
+		return 1;
+	}
+
+	int csv = (format == ACTIVITY_IMPORT_CSV);
+	int columns[ACTIVITY_IMPORT_FIELD_COUNT]; // CSV: position of the column of every field, -1 if missing
+	int hasHeader = 0;
+	int capacity = 0;
+	int failed = 0;
+	int readResult = 0;
+
+	while (!failed && (readResult = readImportRecord(&reader, csv)) == 0) {
+		if (reader.recordLength == 0) continue; // blank line
+
+		char* values[ACTIVITY_IMPORT_FIELD_COUNT] = {0};
+		const char* reason = NULL;
+		int rowResult = 0;
+
+		if (csv) {
+			int splitResult = splitCsvRecord(&reader);
+			if (splitResult == 2) {
+				failed = 1;
+				break;
+			}
+
+			if (!hasHeader) {
+				if (splitResult != 0) {
+					printf("Intestazione CSV non valida nel file %s.\n", filename);
+					failed = 1;
+					break;
+				}
+				// a UTF-8 byte order mark written by some spreadsheets before the first name
+				if (strncmp(reader.fields[0], "\xEF\xBB\xBF", 3) == 0) reader.fields[0] += 3;
+				for (int field = 0; field < ACTIVITY_IMPORT_FIELD_COUNT; field++) {
+					columns[field] = -1;
+					for (int i = 0; mapping->columns[field] != NULL && i < reader.fieldCount; i++) {
+						if (strcmp(reader.fields[i], mapping->columns[field]) == 0) {
+							columns[field] = i;
+							break;
+						}
+					}
+				}
+				if (columns[ACTIVITY_FIELD_NAME] < 0) {
+					printf("Colonna del titolo non trovata nell'intestazione del file %s.\n", filename);
+					failed = 1;
+					break;
+				}
+				hasHeader = 1;
+				continue;
+			}
+
+			if (splitResult != 0) {
+				reason = "record CSV non valido";
+				rowResult = 1;
+			} else {
+				for (int field = 0; field < ACTIVITY_IMPORT_FIELD_COUNT; field++) {
+					if (columns[field] >= 0 && columns[field] < reader.fieldCount) values[field] = reader.fields[columns[field]];
+				}
+			}
+		} else {
+			rowResult = parseJsonlRecord(&reader, mapping, values, &reason);
+		}
+
+		Activity a = NULL;
+		if (rowResult == 0) rowResult = buildImportedActivity(values, importDate, &a, &reason);
+		if (rowResult == 2) {
+			failed = 1;
+			break;
+		}
+		if (rowResult != 0) {
+			if (*rejectedCount < ACTIVITY_IMPORT_MAX_REPORTED_ROWS) printf("Riga %lu scartata: %s.\n", reader.recordLine, reason);
+			(*rejectedCount)++;
+			continue;
+		}
+
+		if (*count == capacity) {
+			int newCapacity = (capacity == 0) ? IMPORT_INITIAL_CAPACITY : capacity * 2;
+			Activity* grown = realloc(*activities, (size_t)newCapacity * sizeof(Activity));
+			if (grown == NULL) {
+				deleteActivity(a);
+				failed = 1;
+				break;
+			}
+			*activities = grown;
+			capacity = newCapacity;
+		}
+		(*activities)[(*count)++] = a;
+	}
+	if (readResult == 2) failed = 1;
+
+	if (*rejectedCount > ACTIVITY_IMPORT_MAX_REPORTED_ROWS) {
+		printf("... e altre %d righe scartate.\n", *rejectedCount - ACTIVITY_IMPORT_MAX_REPORTED_ROWS);
+	}
+
+	fclose(reader.file);
+	free(reader.line);
+	free(reader.record);
+	free(reader.fields);
+
+	if (failed) {
+		for (int i = 0; i < *count; i++) deleteActivity((*activities)[i]);
+		free(*activities);
+		*activities = NULL;
+		*count = 0;
+		return 1;
+	}
+	return 0;
+}
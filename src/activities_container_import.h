@@ -0,0 +1,145 @@
+#ifndef ACTIVITIES_CONTAINER_IMPORT_H             // Start of inclusion block
+#define ACTIVITIES_CONTAINER_IMPORT_H             // Macro definition to avoid multiple inclusions
+
+#include <time.h>
+#include "activity.h"
+
+// Number of fields of an activity that can be imported (ACTIVITY_FIELD_ID ... ACTIVITY_FIELD_PRIORITY)
+#define ACTIVITY_IMPORT_FIELD_COUNT 10
+// Formats of the files read by 'readImportedActivities()'
+#define ACTIVITY_IMPORT_CSV 0
+#define ACTIVITY_IMPORT_JSONL 1
+// Number of rejected rows reported one by one, the others are only counted
+#define ACTIVITY_IMPORT_MAX_REPORTED_ROWS 10
+
+// Declare an opaque type for the mapping of the fields of the activities to the columns of an imported file
+typedef struct activityImportMapping* ActivityImportMapping;
+
+
+/*
+ * newActivityImportMapping
+ *
+ * Syntactic Specification:
+ * ActivityImportMapping newActivityImportMapping(void);
+ *
+ * Semantic Specification:
+ * Creates a mapping of the fields of the activities to the columns of a CSV file (by the names in its
+ * header) or to the keys of the objects of a JSON Lines file. Every field starts mapped to the column
+ * with its name in the exports (see ACTIVITY_EXPORT_CSV_HEADER), so an export is imported as it is.
+ *
+ * Preconditions:
+ * - None
+ *
+ * Postconditions:
+ * - Returns the new mapping, NULL if memory allocation fails
+ *
+ * Side Effects:
+ * - Allocates memory
+ */
+ActivityImportMapping newActivityImportMapping(void);
+
+/*
+ * setActivityImportMappingColumn
+ *
+ * Syntactic Specification:
+ * int setActivityImportMappingColumn(ActivityImportMapping mapping, int field, const char* column);
+ *
+ * Semantic Specification:
+ * Maps a field (ACTIVITY_FIELD_*) to a column; with 'column == NULL' the field is not imported (it
+ * takes its default value, see 'readImportedActivities()').
+ *
+ * Preconditions:
+ * - None
+ *
+ * Postconditions:
+ * - Returns 0 on success, 1 if 'mapping' is NULL, 'field' is not a field or memory allocation fails
+ *
+ * Side Effects:
+ * - Modifies the mapping
+ */
+int setActivityImportMappingColumn(ActivityImportMapping mapping, int field, const char* column);
+
+/*
+ * parseActivityImportMapping
+ *
+ * Syntactic Specification:
+ * int parseActivityImportMapping(ActivityImportMapping mapping, const char* spec);
+ *
+ * Semantic Specification:
+ * Changes the mapping as described by a text of comma separated pairs "field=column", where field is the
+ * export name of a field (e.g. "titolo=Nome attività,corso=Insegnamento,id="): an empty column means that
+ * the field is not imported. The fields not named keep their mapping.
+ *
+ * Preconditions:
+ * - None
+ *
+ * Postconditions:
+ * - Returns 0 on success
+ * - Returns 1 if a pair is not valid or names an unknown field (the pairs before it are applied)
+ *
+ * Side Effects:
+ * - Modifies the mapping
+ */
+int parseActivityImportMapping(ActivityImportMapping mapping, const char* spec);
+
+/*
+ * deleteActivityImportMapping
+ *
+ * Syntactic Specification:
+ * void deleteActivityImportMapping(ActivityImportMapping* mapping);
+ *
+ * Semantic Specification:
+ * Deallocates the mapping. The parameter is a pointer passed by reference.
+ *
+ * Preconditions:
+ * - 'mapping' can be NULL or point to a valid/NULL pointer
+ *
+ * Postconditions:
+ * - '*mapping' is set to NULL
+ *
+ * Side Effects:
+ * - Deallocates memory
+ */
+void deleteActivityImportMapping(ActivityImportMapping* mapping);
+
+/*
+ * readImportedActivities
+ *
+ * Syntactic Specification:
+ * int readImportedActivities(const char* filename, int format, ActivityImportMapping mapping, time_t importDate,
+ *                            Activity** activities, int* count, int* rejectedCount);
+ *
+ * Semantic Specification:
+ * Reads the activities of a CSV (ACTIVITY_IMPORT_CSV, RFC 4180, first line with the names of the columns)
+ * or JSON Lines (ACTIVITY_IMPORT_JSONL, one flat object per line) file. The file is read one record at a
+ * time: only the record being read is kept in memory besides the activities. Every row is validated and a
+ * row that is not valid is rejected (the first ACTIVITY_IMPORT_MAX_REPORTED_ROWS are reported with their
+ * line and reason):
+ * - id: empty or missing for a new id (left 0, assigned by the container), otherwise from 1 to INT_MAX
+ * - titolo: required, not empty
+ * - descrizione, corso: can be empty (NULL); line ends in the strings become spaces (the text format has a
+ *   line per field) and every string must be shorter than MAPPED_LINE_MAX_LENGTH characters
+ * - dates: seconds since the epoch or "YYYY-MM-DD" (local midnight); if empty, 'importDate' for the insert
+ *   date and 0 (none) for the others
+ * - tempo_totale, tempo_impiegato: from 0 to UINT_MAX, 0 if empty
+ * - priorita: from 1 to 3, 2 if empty
+ *
+ * Preconditions:
+ * - 'mapping != NULL', 'activities', 'count' and 'rejectedCount' not NULL
+ *
+ * Postconditions:
+ * - Returns 0 if the file has been read: '*activities' is a new array with the '*count' valid activities in
+ *   file order (the caller deallocates the array and owns the activities), '*rejectedCount' is the number of
+ *   rejected rows
+ * - Returns 1 if the file can't be opened, the CSV header lacks the column of the title or memory allocation
+ *   fails: no activity is returned
+ *
+ * Side Effects:
+ * - Reading from file
+ * - Output to stdout (rejected rows)
+ * - Allocates memory
+ */
+int readImportedActivities(const char* filename, int format, ActivityImportMapping mapping, time_t importDate,
+                           Activity** activities, int* count, int* rejectedCount);
+
+#endif // ACTIVITIES_CONTAINER_IMPORT_H          // End of inclusion block
@@ -0,0 +1,890 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "activity.h"
+#include "activities_container.h"
+#include "activities_container_journal.h"
+
+// Length of a NULL string in a record
+#define ACTIVITY_JOURNAL_NULL_STRING UINT32_MAX
+// Initial size of the buffer where the records are encoded
+#define ACTIVITY_JOURNAL_BUFFER_SIZE 256
+
+
+/*
+ * "struct activityJournal" Documentation
+ *
+ * Syntactic Specification:
+ * struct activityJournal {
+ *     FILE* file;
+ *     char* baseFilename;
+ *     unsigned char* buffer;
+ *     size_t capacity;
+ * };
+ *
+ * Semantic Specification:
+ * Journal of the modifications made to a container after its base file has been loaded.
+ * Every record is encoded in the native byte order as:
+ * - length of the body (32 bit)
+ * - body: type (8 bit, ACTIVITY_JOURNAL_*), id of the activity (32 bit), then
+ *   - insert: insert, expiry and completion date (64 bit), total and used time (32 bit), priority (16 bit),
+ *     name, description and course
+ *   - remove: nothing
+ *   - update: field (8 bit, ACTIVITY_FIELD_*), then the new value: a string for name, description and
+ *     course, a number (64 bit) for the other fields
+ *   where a string is its length (32 bit, ACTIVITY_JOURNAL_NULL_STRING for NULL) followed by its
+ *   characters and '\0'
+ * - checksum of the body (32 bit, FNV-1a), so that a record only partly written is recognized
+ *
+ * Fields:
+ * - file: The journal file, opened in append mode
+ * - baseFilename: Name of the base file (the journal is baseFilename + ACTIVITY_JOURNAL_EXTENSION)
+ * - buffer: Buffer where a record is encoded before being written with a single call
+ * - capacity: Size of 'buffer'
+ */
+struct activityJournal {
+	FILE* file;
+	char* baseFilename;
+	unsigned char* buffer;
+	size_t capacity;
+};
+
+
+/*
+ * "struct journalCursor" Documentation
+ *
+ * Syntactic Specification:
+ * typedef struct journalCursor {
+ *     const unsigned char* data;
+ *     size_t size;
+ *     size_t offset;
+ * } JournalCursor;
+ *
+ * Semantic Specification:
+ * Cursor over the body of a record read in memory.
+ *
+ * Fields:
+ * - data: The body
+ * - size: Number of bytes of the body
+ * - offset: Position of the next value
+ */
+typedef struct journalCursor {
+	const unsigned char* data;
+	size_t size;
+	size_t offset;
+} JournalCursor;
+
+
+
+/*
+ * getActivityJournalFilename
+ *
+ * Syntactic Specification:
+ * char* getActivityJournalFilename(const char* baseFilename);
+ *
+ * Semantic Specification:
+ * Returns the name of the journal of a base file ('baseFilename' + ACTIVITY_JOURNAL_EXTENSION).
+ *
+ * Preconditions:
+ * - 'baseFilename != NULL'
+ *
+ * Postconditions:
+ * - Returns a new string (the caller deallocates it), or NULL if memory allocation fails
+ *
+ * Side Effects:
+ * - Allocates memory
+ */
+char* getActivityJournalFilename(const char* baseFilename) {
+	size_t baseLength = strlen(baseFilename);
+	char* filename = malloc(baseLength + sizeof(ACTIVITY_JOURNAL_EXTENSION));
+	if (filename == NULL) return NULL;
+
+	memcpy(filename, baseFilename, baseLength);
+	memcpy(filename + baseLength, ACTIVITY_JOURNAL_EXTENSION, sizeof(ACTIVITY_JOURNAL_EXTENSION));
+	return filename;
+}
+
+/*
+ * computeJournalChecksum
+ *
+ * Syntactic Specification:
+ * uint32_t computeJournalChecksum(const unsigned char* data, size_t size);
+ *
+ * Semantic Specification:
+ * Computes the FNV-1a hash (32 bit) of the bytes of a record body.
+ *
+ * Preconditions:
+ * - 'data' has at least 'size' bytes
+ *
+ * Postconditions:
+ * - Returns the hash
+ *
+ * Side Effects:
+ * - None
+ */
+uint32_t computeJournalChecksum(const unsigned char* data, size_t size) {
+	uint32_t hash = 2166136261u;
+	for (size_t i = 0; i < size; i++) {
+		hash ^= data[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+/*
+ * getJournalStringSize
+ *
+ * Syntactic Specification:
+ * size_t getJournalStringSize(const char* string);
+ *
+ * Semantic Specification:
+ * Returns the number of bytes of a string encoded in a record.
+ *
+ * Preconditions:
+ * - None ('string' can be NULL)
+ *
+ * Postconditions:
+ * - Returns the size (length, characters and '\0')
+ *
+ * Side Effects:
+ * - None
+ */
+size_t getJournalStringSize(const char* string) {
+	if (string == NULL) return sizeof(uint32_t);
+
+	return sizeof(uint32_t) + strlen(string) + 1;
+}
+
+/*
+ * putJournalValue
+ *
+ * Syntactic Specification:
+ * void putJournalValue(unsigned char* buffer, size_t* offset, const void* value, size_t size);
+ *
+ * Semantic Specification:
+ * Copies the bytes of a value into the buffer at '*offset' and advances the offset.
+ *
+ * Preconditions:
+ * - The buffer has room for 'size' bytes at '*offset'
+ *
+ * Postconditions:
+ * - '*offset' is increased by 'size'
+ *
+ * Side Effects:
+ * - Writes the buffer
+ */
+void putJournalValue(unsigned char* buffer, size_t* offset, const void* value, size_t size) {
+	memcpy(buffer + *offset, value, size);
+	*offset += size;
+}
+
+/*
+ * putJournalString
+ *
+ * Syntactic Specification:
+ * void putJournalString(unsigned char* buffer, size_t* offset, const char* string);
+ *
+ * Semantic Specification:
+ * Encodes a string (see "struct activityJournal") into the buffer at '*offset' and advances the offset.
+ *
+ * Preconditions:
+ * - The buffer has room for 'getJournalStringSize(string)' bytes at '*offset'
+ *
+ * Postconditions:
+ * - '*offset' is increased by 'getJournalStringSize(string)'
+ *
+ * Side Effects:
+ * - Writes the buffer
+ */
+void putJournalString(unsigned char* buffer, size_t* offset, const char* string) {
+	uint32_t length = ACTIVITY_JOURNAL_NULL_STRING;
+	if (string == NULL) {
+		putJournalValue(buffer, offset, &length, sizeof(length));
+		return;
+	}
+
+	size_t stringSize = strlen(string) + 1;
+	length = (uint32_t)(stringSize - 1);
+	putJournalValue(buffer, offset, &length, sizeof(length));
+	putJournalValue(buffer, offset, string, stringSize);
+}
+
+/*
+ * beginActivityJournalRecord
+ *
+ * Syntactic Specification:
+ * unsigned char* beginActivityJournalRecord(ActivityJournal journal, size_t bodySize, int type, int activityId, size_t* offset);
+ *
+ * Semantic Specification:
+ * Prepares the buffer of the journal for a record with a body of 'bodySize' bytes (enlarging it if needed)
+ * and encodes the length, the type and the id of the activity.
+ *
+ * Preconditions:
+ * - 'journal != NULL', 'offset != NULL', 'bodySize' includes type and id
+ *
+ * Postconditions:
+ * - Returns the buffer, with '*offset' at the rest of the body
+ * - Returns NULL if the body is too large or memory allocation fails
+ *
+ * Side Effects:
+ * - May reallocate the buffer
+ */
+unsigned char* beginActivityJournalRecord(ActivityJournal journal, size_t bodySize, int type, int activityId, size_t* offset) {
+	if (bodySize > UINT32_MAX) return NULL;
+
+	size_t recordSize = sizeof(uint32_t) + bodySize + sizeof(uint32_t);
+	if (recordSize > journal->capacity) {
+		size_t capacity = journal->capacity;
+		while (capacity < recordSize) capacity *= 2;
+
+		unsigned char* buffer = realloc(journal->buffer, capacity);
+		if (buffer == NULL) return NULL;
+		journal->buffer = buffer;
+		journal->capacity = capacity;
+	}
+
+	uint32_t length = (uint32_t)bodySize;
+	uint8_t recordType = (uint8_t)type;
+	int32_t id = (int32_t)activityId;
+	*offset = 0;
+	putJournalValue(journal->buffer, offset, &length, sizeof(length));
+	putJournalValue(journal->buffer, offset, &recordType, sizeof(recordType));
+	putJournalValue(journal->buffer, offset, &id, sizeof(id));
+	return journal->buffer;
+}
+
+/*
+ * endActivityJournalRecord
+ *
+ * Syntactic Specification:
+ * int endActivityJournalRecord(ActivityJournal journal, size_t offset);
+ *
+ * Semantic Specification:
+ * Adds the checksum to the record encoded in the buffer (body ending at 'offset'), writes the record
+ * to the file with a single call and flushes it, so it reaches the file before the next modification.
+ *
+ * Preconditions:
+ * - 'journal != NULL', the record has been encoded by 'beginActivityJournalRecord()' and the body is complete
+ *
+ * Postconditions:
+ * - Returns 0 if the record has been written, 1 otherwise
+ *
+ * Side Effects:
+ * - Writing to file
+ */
+int endActivityJournalRecord(ActivityJournal journal, size_t offset) {
+	uint32_t checksum = computeJournalChecksum(journal->buffer + sizeof(uint32_t), offset - sizeof(uint32_t));
+	putJournalValue(journal->buffer, &offset, &checksum, sizeof(checksum));
+
+	if (fwrite(journal->buffer, 1, offset, journal->file) != offset) return 1;
+	if (fflush(journal->file) != 0) return 1;
+
+	return 0;
+}
+
+/*
+ * getJournalValue
+ *
+ * Syntactic Specification:
+ * int getJournalValue(JournalCursor* cursor, void* value, size_t size);
+ *
+ * Semantic Specification:
+ * Reads the next 'size' bytes of a record body into 'value'.
+ *
+ * Preconditions:
+ * - 'cursor != NULL', 'value' has room for 'size' bytes
+ *
+ * Postconditions:
+ * - Returns 0 and advances the cursor if the bytes are in the body, 1 otherwise
+ *
+ * Side Effects:
+ * - Writes 'value'
+ */
+int getJournalValue(JournalCursor* cursor, void* value, size_t size) {
+	if (cursor->size - cursor->offset < size) return 1;
+
+	memcpy(value, cursor->data + cursor->offset, size);
+	cursor->offset += size;
+	return 0;
+}
+
+/*
+ * getJournalString
+ *
+ * Syntactic Specification:
+ * int getJournalString(JournalCursor* cursor, const char** string);
+ *
+ * Semantic Specification:
+ * Reads the next string of a record body. The string is not copied: '*string' points into the body.
+ *
+ * Preconditions:
+ * - 'cursor != NULL', 'string != NULL'
+ *
+ * Postconditions:
+ * - Returns 0 and advances the cursor if a valid string (NULL or terminated by '\0') is in the body, 1 otherwise
+ *
+ * Side Effects:
+ * - Writes '*string'
+ */
+int getJournalString(JournalCursor* cursor, const char** string) {
+	uint32_t length = 0;
+	if (getJournalValue(cursor, &length, sizeof(length)) != 0) return 1;
+
+	if (length == ACTIVITY_JOURNAL_NULL_STRING) {
+		*string = NULL;
+		return 0;
+	}
+
+	if (cursor->size - cursor->offset <= length || cursor->data[cursor->offset + length] != '\0') return 1;
+
+	*string = (const char*)(cursor->data + cursor->offset);
+	cursor->offset += (size_t)length + 1;
+	return 0;
+}
+
+/*
+ * isStringActivityField
+ *
+ * Syntactic Specification:
+ * int isStringActivityField(int field);
+ *
+ * Semantic Specification:
+ * Tells if a field (ACTIVITY_FIELD_*) is a string: its value is journaled as a string instead of a number.
+ *
+ * Preconditions:
+ * - None
+ *
+ * Postconditions:
+ * - Returns 1 for name, description and course, 0 otherwise
+ *
+ * Side Effects:
+ * - None
+ */
+int isStringActivityField(int field) {
+	return field == ACTIVITY_FIELD_NAME || field == ACTIVITY_FIELD_DESCR || field == ACTIVITY_FIELD_COURSE;
+}
+
+/*
+ * getActivityStringField
+ *
+ * Syntactic Specification:
+ * const char* getActivityStringField(Activity a, int field);
+ *
+ * Semantic Specification:
+ * Returns the value of a string field (name, description or course) of an activity.
+ *
+ * Preconditions:
+ * - 'a != NULL', 'isStringActivityField(field)'
+ *
+ * Postconditions:
+ * - Returns the string (can be NULL)
+ *
+ * Side Effects:
+ * - None
+ */
+const char* getActivityStringField(Activity a, int field) {
+	if (field == ACTIVITY_FIELD_NAME) return getActivityName(a);
+	if (field == ACTIVITY_FIELD_DESCR) return getActivityDescr(a);
+	return getActivityCourse(a);
+}
+
+/*
+ * getActivityNumericField
+ *
+ * Syntactic Specification:
+ * int64_t getActivityNumericField(Activity a, int field);
+ *
+ * Semantic Specification:
+ * Returns the value of a numeric field (id, dates, times or priority) of an activity.
+ *
+ * Preconditions:
+ * - 'a != NULL', '!isStringActivityField(field)'
+ *
+ * Postconditions:
+ * - Returns the value (0 for an unknown field)
+ *
+ * Side Effects:
+ * - None
+ */
+int64_t getActivityNumericField(Activity a, int field) {
+	switch (field) {
+		case ACTIVITY_FIELD_ID: return getActivityId(a);
+		case ACTIVITY_FIELD_INSERT_DATE: return (int64_t)getActivityInsertDate(a);
+		case ACTIVITY_FIELD_EXPIRY_DATE: return (int64_t)getActivityExpiryDate(a);
+		case ACTIVITY_FIELD_COMPLETION_DATE: return (int64_t)getActivityCompletionDate(a);
+		case ACTIVITY_FIELD_TOTAL_TIME: return getActivityTotalTime(a);
+		case ACTIVITY_FIELD_USED_TIME: return getActivityUsedTime(a);
+		case ACTIVITY_FIELD_PRIORITY: return getActivityPriority(a);
+		default: return 0;
+	}
+}
+
+/*
+ * setActivityFieldFromJournal
+ *
+ * Syntactic Specification:
+ * void setActivityFieldFromJournal(Activity a, int field, int64_t number, const char* string);
+ *
+ * Semantic Specification:
+ * Sets a field of an activity with its setter: string fields take 'string', the other ones 'number'.
+ *
+ * Preconditions:
+ * - 'a != NULL'
+ *
+ * Postconditions:
+ * - The field is updated (no action for an unknown field)
+ *
+ * Side Effects:
+ * - Modifies the activity (and, through its observer, the container that holds it)
+ */
+void setActivityFieldFromJournal(Activity a, int field, int64_t number, const char* string) {
+	switch (field) {
+		case ACTIVITY_FIELD_ID: setActivityId(a, (int)number); break;
+		case ACTIVITY_FIELD_NAME: setActivityName(a, (char*)string); break;
+		case ACTIVITY_FIELD_DESCR: setActivityDescr(a, (char*)string); break;
+		case ACTIVITY_FIELD_COURSE: setActivityCourse(a, (char*)string); break;
+		case ACTIVITY_FIELD_INSERT_DATE: setActivityInsertDate(a, (time_t)number); break;
+		case ACTIVITY_FIELD_EXPIRY_DATE: setActivityExpiryDate(a, (time_t)number); break;
+		case ACTIVITY_FIELD_COMPLETION_DATE: setActivityCompletionDate(a, (time_t)number); break;
+		case ACTIVITY_FIELD_TOTAL_TIME: setActivityTotalTime(a, (unsigned int)number); break;
+		case ACTIVITY_FIELD_USED_TIME: setActivityUsedTime(a, (unsigned int)number); break;
+		case ACTIVITY_FIELD_PRIORITY: setActivityPriority(a, (short unsigned int)number); break;
+		default: break;
+	}
+}
+
+/*
+ * replayActivityJournalRecord
+ *
+ * Syntactic Specification:
+ * int replayActivityJournalRecord(JournalCursor* body, ActivitiesContainer container);
+ *
+ * Semantic Specification:
+ * Decodes a record body and applies it to the container. An insertion of an id already in the
+ * container and a removal or an update of an id not in the container have no effect.
+ *
+ * Preconditions:
+ * - 'body != NULL' (with a checksum already verified), 'container != NULL'
+ *
+ * Postconditions:
+ * - Returns 0 if the record has been applied
+ * - Returns 1 if the body is not a valid record, 2 if memory allocation fails
+ *
+ * Side Effects:
+ * - Modifies the container
+ */
+int replayActivityJournalRecord(JournalCursor* body, ActivitiesContainer container) {
+	uint8_t type = 0;
+	int32_t id = 0;
+	if (getJournalValue(body, &type, sizeof(type)) != 0 || getJournalValue(body, &id, sizeof(id)) != 0) return 1;
+
+	if (type == ACTIVITY_JOURNAL_REMOVE) {
+		removeActivity(container, id);
+		return 0;
+	}
+
+	if (type == ACTIVITY_JOURNAL_UPDATE) {
+		uint8_t field = 0;
+		int64_t number = 0;
+		const char* string = NULL;
+		if (getJournalValue(body, &field, sizeof(field)) != 0) return 1;
+		if (isStringActivityField(field)) {
+			if (getJournalString(body, &string) != 0) return 1;
+		} else {
+			if (getJournalValue(body, &number, sizeof(number)) != 0) return 1;
+		}
+
+		Activity activity = getActivityWithId(container, id);
+		if (activity != NULL) setActivityFieldFromJournal(activity, field, number, string);
+		return 0;
+	}
+
+	if (type != ACTIVITY_JOURNAL_INSERT) return 1;
+
+	int64_t dates[3];
+	uint32_t times[2];
+	uint16_t priority = 0;
+	const char* strings[3];
+	if (getJournalValue(body, dates, sizeof(dates)) != 0 || getJournalValue(body, times, sizeof(times)) != 0 ||
+		getJournalValue(body, &priority, sizeof(priority)) != 0) return 1;
+	for (int i = 0; i < 3; i++) {
+		if (getJournalString(body, &strings[i]) != 0) return 1;
+	}
+
+	if (id == 0 || getActivityWithId(container, id) != NULL) return 0; // already applied
+
+	Activity activity = newActivity(id, (char*)strings[0], (char*)strings[1], (char*)strings[2],
+									(time_t)dates[0], (time_t)dates[1], (time_t)dates[2],
+									times[0], times[1], priority);
+	if (activity == NULL) return 2;
+
+	insertActivity(container, activity);
+	return 0;
+}
+
+
+
+/*
+ * openActivityJournal
+ *
+ * Syntactic Specification:
+ * ActivityJournal openActivityJournal(const char* baseFilename);
+ *
+ * Semantic Specification:
+ * Opens (creating it if needed) the journal of a base file, named 'baseFilename' + ACTIVITY_JOURNAL_EXTENSION,
+ * to append records at its end.
+ *
+ * Preconditions:
+ * - 'baseFilename != NULL'
+ *
+ * Postconditions:
+ * - Returns the journal, or NULL if the file can't be opened or memory allocation fails
+ *
+ * Side Effects:
+ * - Opens (and possibly creates) the file
+ * - Allocates memory
+ */
+ActivityJournal openActivityJournal(const char* baseFilename) {
+	if (baseFilename == NULL) return NULL;
+
+	ActivityJournal journal = malloc(sizeof(struct activityJournal));
+	if (journal == NULL) return NULL;
+
+	size_t baseSize = strlen(baseFilename) + 1;
+	journal->baseFilename = malloc(baseSize);
+	journal->buffer = malloc(ACTIVITY_JOURNAL_BUFFER_SIZE);
+	journal->capacity = ACTIVITY_JOURNAL_BUFFER_SIZE;
+	journal->file = NULL;
+
+	char* filename = getActivityJournalFilename(baseFilename);
+	if (filename != NULL && journal->baseFilename != NULL && journal->buffer != NULL) {
+		memcpy(journal->baseFilename, baseFilename, baseSize);
+		journal->file = fopen(filename, "ab");
+	}
+	free(filename);
+
+	if (journal->file == NULL) {
+		closeActivityJournal(&journal);
+		return NULL;
+	}
+
+	return journal;
+}
+
+/*
+ * closeActivityJournal
+ *
+ * Syntactic Specification:
+ * void closeActivityJournal(ActivityJournal* journal);
+ *
+ * Semantic Specification:
+ * Closes the journal file and deallocates the journal. The parameter is a pointer passed by reference.
+ *
+ * Preconditions:
+ * - 'journal' can be NULL or point to a valid/NULL pointer
+ *
+ * Postconditions:
+ * - The file is closed, the memory is freed and '*journal' is set to NULL
+ *
+ * Side Effects:
+ * - Closes the file
+ * - Deallocates memory
+ */
+void closeActivityJournal(ActivityJournal* journal) {
+	if (journal == NULL || *journal == NULL) return;
+
+	if ((*journal)->file != NULL) fclose((*journal)->file);
+	free((*journal)->baseFilename);
+	free((*journal)->buffer);
+	free(*journal);
+	*journal = NULL;
+}
+
+/*
+ * getActivityJournalBaseFilename
+ *
+ * Syntactic Specification:
+ * const char* getActivityJournalBaseFilename(ActivityJournal journal);
+ *
+ * Semantic Specification:
+ * Returns the name of the base file of the journal.
+ *
+ * Preconditions:
+ * - None
+ *
+ * Postconditions:
+ * - Returns the name (NULL if 'journal == NULL')
+ *
+ * Side Effects:
+ * - None
+ */
+const char* getActivityJournalBaseFilename(ActivityJournal journal) {
+	if (journal == NULL) return NULL;
+
+	return journal->baseFilename;
+}
+
+/*
+ * appendInsertToActivityJournal
+ *
+ * Syntactic Specification:
+ * int appendInsertToActivityJournal(ActivityJournal journal, Activity activity);
+ *
+ * Semantic Specification:
+ * Appends a record with the insertion of an activity (all its fields).
+ * Every record is written with one write and flushed to the file, so a record costs a few
+ * microseconds whatever the size of the container (no synchronization to the disk).
+ *
+ * Preconditions:
+ * - 'journal != NULL', 'activity != NULL'
+ *
+ * Postconditions:
+ * - Returns 0 if the record has been written, 1 otherwise (also if the description can't be
+ *   read from its file: a record with no description would delete it on replay)
+ *
+ * Side Effects:
+ * - Writing to file
+ */
+int appendInsertToActivityJournal(ActivityJournal journal, Activity activity) {
+	if (journal == NULL || activity == NULL) return 1;
+
+	const char* strings[3] = { getActivityName(activity), getActivityDescr(activity), getActivityCourse(activity) };
+	if (!isActivityDescrLoaded(activity)) return 1;
+	int64_t dates[3] = { (int64_t)getActivityInsertDate(activity), (int64_t)getActivityExpiryDate(activity),
+							(int64_t)getActivityCompletionDate(activity) };
+	uint32_t times[2] = { getActivityTotalTime(activity), getActivityUsedTime(activity) };
+	uint16_t priority = getActivityPriority(activity);
+
+	size_t bodySize = sizeof(uint8_t) + sizeof(int32_t) + sizeof(dates) + sizeof(times) + sizeof(priority);
+	for (int i = 0; i < 3; i++) {
+		bodySize += getJournalStringSize(strings[i]);
+	}
+
+	size_t offset = 0;
+	unsigned char* buffer = beginActivityJournalRecord(journal, bodySize, ACTIVITY_JOURNAL_INSERT, getActivityId(activity), &offset);
+	if (buffer == NULL) return 1;
+
+	putJournalValue(buffer, &offset, dates, sizeof(dates));
+	putJournalValue(buffer, &offset, times, sizeof(times));
+	putJournalValue(buffer, &offset, &priority, sizeof(priority));
+	for (int i = 0; i < 3; i++) {
+		putJournalString(buffer, &offset, strings[i]);
+	}
+
+	return endActivityJournalRecord(journal, offset);
+}
+
+/*
+ * appendRemoveToActivityJournal
+ *
+ * Syntactic Specification:
+ * int appendRemoveToActivityJournal(ActivityJournal journal, int activityId);
+ *
+ * Semantic Specification:
+ * Appends a record with the removal of the activity with id 'activityId'.
+ *
+ * Preconditions:
+ * - 'journal != NULL'
+ *
+ * Postconditions:
+ * - Returns 0 if the record has been written, 1 otherwise
+ *
+ * Side Effects:
+ * - Writing to file
+ */
+int appendRemoveToActivityJournal(ActivityJournal journal, int activityId) {
+	if (journal == NULL) return 1;
+
+	size_t offset = 0;
+	if (beginActivityJournalRecord(journal, sizeof(uint8_t) + sizeof(int32_t), ACTIVITY_JOURNAL_REMOVE, activityId, &offset) == NULL) return 1;
+
+	return endActivityJournalRecord(journal, offset);
+}
+
+/*
+ * appendUpdateToActivityJournal
+ *
+ * Syntactic Specification:
+ * int appendUpdateToActivityJournal(ActivityJournal journal, int activityId, Activity activity, int field);
+ *
+ * Semantic Specification:
+ * Appends a record with the new value of a field (ACTIVITY_FIELD_*) of the activity that had id
+ * 'activityId' before the change (it differs from the current id only when the field is the id).
+ *
+ * Preconditions:
+ * - 'journal != NULL', 'activity != NULL', 'field' is an ACTIVITY_FIELD_* value
+ *
+ * Postconditions:
+ * - Returns 0 if the record has been written, 1 otherwise
+ *
+ * Side Effects:
+ * - Writing to file
+ */
+int appendUpdateToActivityJournal(ActivityJournal journal, int activityId, Activity activity, int field) {
+	if (journal == NULL || activity == NULL) return 1;
+
+	uint8_t recordField = (uint8_t)field;
+	int64_t number = 0;
+	const char* string = NULL;
+	size_t bodySize = sizeof(uint8_t) + sizeof(int32_t) + sizeof(recordField);
+	if (isStringActivityField(field)) {
+		string = getActivityStringField(activity, field);
+		if (field == ACTIVITY_FIELD_DESCR && !isActivityDescrLoaded(activity)) return 1;
+		bodySize += getJournalStringSize(string);
+	} else {
+		number = getActivityNumericField(activity, field);
+		bodySize += sizeof(number);
+	}
+
+	size_t offset = 0;
+	unsigned char* buffer = beginActivityJournalRecord(journal, bodySize, ACTIVITY_JOURNAL_UPDATE, activityId, &offset);
+	if (buffer == NULL) return 1;
+
+	putJournalValue(buffer, &offset, &recordField, sizeof(recordField));
+	if (isStringActivityField(field)) {
+		putJournalString(buffer, &offset, string);
+	} else {
+		putJournalValue(buffer, &offset, &number, sizeof(number));
+	}
+
+	return endActivityJournalRecord(journal, offset);
+}
+
+/*
+ * truncateActivityJournal
+ *
+ * Syntactic Specification:
+ * int truncateActivityJournal(ActivityJournal journal);
+ *
+ * Semantic Specification:
+ * Removes all the records of the journal (after its base file has been rewritten).
+ *
+ * Preconditions:
+ * - 'journal != NULL'
+ *
+ * Postconditions:
+ * - Returns 0 if the journal is empty, 1 otherwise
+ *
+ * Side Effects:
+ * - Truncates the file
+ */
+int truncateActivityJournal(ActivityJournal journal) {
+	if (journal == NULL) return 1;
+
+	if (fflush(journal->file) != 0) return 1;
+	if (ftruncate(fileno(journal->file), 0) != 0) return 1;
+
+	return 0;
+}
+
+/*
+ * replayActivityJournal
+ *
+ * Syntactic Specification:
+ * int replayActivityJournal(const char* baseFilename, ActivitiesContainer container, int* replayed);
+ *
+ * Semantic Specification:
+ * Applies to the container, in order, the records of the journal of a base file: insertions with
+ * 'insertActivity()', removals with 'removeActivity()' and field updates with the setters of the
+ * activities. Replaying a record already applied to the base file has no effect, so a journal left
+ * behind by an interrupted compaction is harmless. The reading stops at the first incomplete or
+ * damaged record (an append interrupted by a crash), which is cut from the file with the rest.
+ *
+ * Preconditions:
+ * - 'baseFilename != NULL', 'container != NULL', 'replayed != NULL'
+ * - The container has no journal attached (the replayed records must not be journaled again)
+ *
+ * Postconditions:
+ * - Returns 0 and sets '*replayed' to the number of records applied (0 if there is no journal)
+ * - Returns 1 if memory allocation fails (the records before are applied)
+ *
+ * Side Effects:
+ * - Reading (and possibly truncating) the file
+ * - Modifies the container
+ */
+int replayActivityJournal(const char* baseFilename, ActivitiesContainer container, int* replayed) {
+	if (baseFilename == NULL || container == NULL || replayed == NULL) return 1;
+	*replayed = 0;
+
+	char* filename = getActivityJournalFilename(baseFilename);
+	if (filename == NULL) return 1;
+
+	FILE* file = fopen(filename, "rb");
+	if (file == NULL) {
+		free(filename);
+		return 0; // no journal: nothing to replay
+	}
+
+	struct stat fileInfo;
+	unsigned char* data = NULL;
+	size_t size = 0;
+	int result = 0;
+	if (fstat(fileno(file), &fileInfo) == 0 && fileInfo.st_size > 0) {
+		size = (size_t)fileInfo.st_size;
+		data = malloc(size);
+		if (data == NULL) result = 1;
+		else size = fread(data, 1, size, file);
+	}
+	fclose(file);
+
+	size_t offset = 0;
+	while (result == 0 && size - offset >= 2 * sizeof(uint32_t)) {
+		uint32_t length = 0;
+		uint32_t checksum = 0;
+		memcpy(&length, data + offset, sizeof(length));
+		if (size - offset - 2 * sizeof(uint32_t) < length) break; // incomplete record
+
+		JournalCursor body = { data + offset + sizeof(uint32_t), length, 0 };
+		memcpy(&checksum, body.data + length, sizeof(checksum));
+		if (checksum != computeJournalChecksum(body.data, length)) break; // damaged record
+
+		int recordResult = replayActivityJournalRecord(&body, container);
+		if (recordResult == 1) break; // not a record of this format
+		if (recordResult == 2) result = 1;
+		else {
+			offset += 2 * sizeof(uint32_t) + length;
+			*replayed += 1;
+		}
+	}
+
+	// The records after the last valid one are never replayed: cut them, so the next ones follow a valid record
+	if (result == 0 && offset < size) truncate(filename, (off_t)offset);
+
+	free(data);
+	free(filename);
+	return result;
+}
+
+/*
+ * hasActivityJournalRecords
+ *
+ * Syntactic Specification:
+ * int hasActivityJournalRecords(const char* baseFilename);
+ *
+ * Semantic Specification:
+ * Tells whether the journal of a base file holds records, i.e. whether the base file alone
+ * does not describe the last modifications.
+ *
+ * Preconditions:
+ * - 'baseFilename != NULL'
+ *
+ * Postconditions:
+ * - Returns 1 if the journal exists and is not empty, 0 otherwise
+ *
+ * Side Effects:
+ * - None
+ */
+int hasActivityJournalRecords(const char* baseFilename) {
+	if (baseFilename == NULL) return 0;
+
+	char* filename = getActivityJournalFilename(baseFilename);
+	if (filename == NULL) return 0;
+
+	struct stat fileInfo;
+	int result = stat(filename, &fileInfo) == 0 && fileInfo.st_size > 0;
+	free(filename);
+	return result;
+}
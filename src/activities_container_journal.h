@@ -0,0 +1,213 @@
+#ifndef ACTIVITIES_CONTAINER_JOURNAL_H             // Start of inclusion block
+#define ACTIVITIES_CONTAINER_JOURNAL_H             // Macro definition to avoid multiple inclusions
+
+#include "activities_container.h"
+
+// Extension added to the name of a base file (text or binary) to get the name of its journal
+#define ACTIVITY_JOURNAL_EXTENSION ".journal"
+
+// Types of the journal records
+#define ACTIVITY_JOURNAL_INSERT 1
+#define ACTIVITY_JOURNAL_REMOVE 2
+#define ACTIVITY_JOURNAL_UPDATE 3
+
+// Declare an opaque type for an append-only journal of the modifications of a container
+typedef struct activityJournal* ActivityJournal;
+
+
+/*
+ * openActivityJournal
+ *
+ * Syntactic Specification:
+ * ActivityJournal openActivityJournal(const char* baseFilename);
+ *
+ * Semantic Specification:
+ * Opens (creating it if needed) the journal of a base file, named 'baseFilename' + ACTIVITY_JOURNAL_EXTENSION,
+ * to append records at its end.
+ *
+ * Preconditions:
+ * - 'baseFilename != NULL'
+ *
+ * Postconditions:
+ * - Returns the journal, or NULL if the file can't be opened or memory allocation fails
+ *
+ * Side Effects:
+ * - Opens (and possibly creates) the file
+ * - Allocates memory
+ */
+ActivityJournal openActivityJournal(const char* baseFilename);
+
+/*
+ * closeActivityJournal
+ *
+ * Syntactic Specification:
+ * void closeActivityJournal(ActivityJournal* journal);
+ *
+ * Semantic Specification:
+ * Closes the journal file and deallocates the journal. The parameter is a pointer passed by reference.
+ *
+ * Preconditions:
+ * - 'journal' can be NULL or point to a valid/NULL pointer
+ *
+ * Postconditions:
+ * - The file is closed, the memory is freed and '*journal' is set to NULL
+ *
+ * Side Effects:
+ * - Closes the file
+ * - Deallocates memory
+ */
+void closeActivityJournal(ActivityJournal* journal);
+
+/*
+ * getActivityJournalBaseFilename
+ *
+ * Syntactic Specification:
+ * const char* getActivityJournalBaseFilename(ActivityJournal journal);
+ *
+ * Semantic Specification:
+ * Returns the name of the base file of the journal.
+ *
+ * Preconditions:
+ * - None
+ *
+ * Postconditions:
+ * - Returns the name (NULL if 'journal == NULL')
+ *
+ * Side Effects:
+ * - None
+ */
+const char* getActivityJournalBaseFilename(ActivityJournal journal);
+
+/*
+ * appendInsertToActivityJournal
+ *
+ * Syntactic Specification:
+ * int appendInsertToActivityJournal(ActivityJournal journal, Activity activity);
+ *
+ * Semantic Specification:
+ * Appends a record with the insertion of an activity (all its fields).
+ * Every record is written with one write and flushed to the file, so a record costs a few
+ * microseconds whatever the size of the container (no synchronization to the disk).
+ *
+ * Preconditions:
+ * - 'journal != NULL', 'activity != NULL'
+ *
+ * Postconditions:
+ * - Returns 0 if the record has been written, 1 otherwise (also if the description can't be
+ *   read from its file: a record with no description would delete it on replay)
+ *
+ * Side Effects:
+ * - Writing to file
+ */
+int appendInsertToActivityJournal(ActivityJournal journal, Activity activity);
+
+/*
+ * appendRemoveToActivityJournal
+ *
+ * Syntactic Specification:
+ * int appendRemoveToActivityJournal(ActivityJournal journal, int activityId);
+ *
+ * Semantic Specification:
+ * Appends a record with the removal of the activity with id 'activityId'.
+ *
+ * Preconditions:
+ * - 'journal != NULL'
+ *
+ * Postconditions:
+ * - Returns 0 if the record has been written, 1 otherwise
+ *
+ * Side Effects:
+ * - Writing to file
+ */
+int appendRemoveToActivityJournal(ActivityJournal journal, int activityId);
+
+/*
+ * appendUpdateToActivityJournal
+ *
+ * Syntactic Specification:
+ * int appendUpdateToActivityJournal(ActivityJournal journal, int activityId, Activity activity, int field);
+ *
+ * Semantic Specification:
+ * Appends a record with the new value of a field (ACTIVITY_FIELD_*) of the activity that had id
+ * 'activityId' before the change (it differs from the current id only when the field is the id).
+ *
+ * Preconditions:
+ * - 'journal != NULL', 'activity != NULL', 'field' is an ACTIVITY_FIELD_* value
+ *
+ * Postconditions:
+ * - Returns 0 if the record has been written, 1 otherwise
+ *
+ * Side Effects:
+ * - Writing to file
+ */
+int appendUpdateToActivityJournal(ActivityJournal journal, int activityId, Activity activity, int field);
+
+/*
+ * truncateActivityJournal
+ *
+ * Syntactic Specification:
+ * int truncateActivityJournal(ActivityJournal journal);
+ *
+ * Semantic Specification:
+ * Removes all the records of the journal (after its base file has been rewritten).
+ *
+ * Preconditions:
+ * - 'journal != NULL'
+ *
+ * Postconditions:
+ * - Returns 0 if the journal is empty, 1 otherwise
+ *
+ * Side Effects:
+ * - Truncates the file
+ */
+int truncateActivityJournal(ActivityJournal journal);
+
+/*
+ * replayActivityJournal
+ *
+ * Syntactic Specification:
+ * int replayActivityJournal(const char* baseFilename, ActivitiesContainer container, int* replayed);
+ *
+ * Semantic Specification:
+ * Applies to the container, in order, the records of the journal of a base file: insertions with
+ * 'insertActivity()', removals with 'removeActivity()' and field updates with the setters of the
+ * activities. Replaying a record already applied to the base file has no effect, so a journal left
+ * behind by an interrupted compaction is harmless. The reading stops at the first incomplete or
+ * damaged record (an append interrupted by a crash), which is cut from the file with the rest.
+ *
+ * Preconditions:
+ * - 'baseFilename != NULL', 'container != NULL', 'replayed != NULL'
+ * - The container has no journal attached (the replayed records must not be journaled again)
+ *
+ * Postconditions:
+ * - Returns 0 and sets '*replayed' to the number of records applied (0 if there is no journal)
+ * - Returns 1 if memory allocation fails (the records before are applied)
+ *
+ * Side Effects:
+ * - Reading (and possibly truncating) the file
+ * - Modifies the container
+ */
+int replayActivityJournal(const char* baseFilename, ActivitiesContainer container, int* replayed);
+
+/*
+ * hasActivityJournalRecords
+ *
+ * Syntactic Specification:
+ * int hasActivityJournalRecords(const char* baseFilename);
+ *
+ * Semantic Specification:
+ * Tells whether the journal of a base file holds records, i.e. whether the base file alone
+ * does not describe the last modifications.
+ *
+ * Preconditions:
+ * - 'baseFilename != NULL'
+ *
+ * Postconditions:
+ * - Returns 1 if the journal exists and is not empty, 0 otherwise
+ *
+ * Side Effects:
+ * - None
+ */
+int hasActivityJournalRecords(const char* baseFilename);
+
+#endif // ACTIVITIES_CONTAINER_JOURNAL_H          // End of inclusion block
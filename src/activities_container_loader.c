@@ -0,0 +1,659 @@
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "activity.h"
+#include "activities_container.h"
+#include "activities_container_loader.h"
+
+// Number of lines of a record (an activity) in the text format
+#define MAPPED_RECORD_LINES 10
+#define PARALLEL_LOAD_MAX_THREADS 64 // upper bound of the threads used by the parallel loader
+
+
+/*
+ * "struct mappedLines" Documentation
+ *
+ * Syntactic Specification:
+ * typedef struct mappedLines {
+ *     const char* data;
+ *     size_t size;
+ *     size_t offset;
+ *     int reachedEnd;
+ *     ActivityStringSource descrSource;
+ * } MappedLines;
+ *
+ * Semantic Specification:
+ * Cursor over the lines of a text in memory, read as 'readLine()' reads them from a file.
+ *
+ * Fields:
+ * - data: The text (not terminated)
+ * - size: Number of bytes of the text
+ * - offset: Position of the next line
+ * - reachedEnd: 1 if a read has hit the end of the text (as the end-of-file indicator of a stream)
+ * - descrSource: The mapped file, if the descriptions are left in it (see 'setActivityLazyDescr()'), or NULL
+ */
+typedef struct mappedLines {
+	const char* data;
+	size_t size;
+	size_t offset;
+	int reachedEnd;
+	ActivityStringSource descrSource;
+} MappedLines;
+
+
+/*
+ * "struct parallelLoadTask" Documentation
+ *
+ * Syntactic Specification:
+ * typedef struct parallelLoadTask {
+ *     const char* data;
+ *     size_t size;
+ *     size_t from;
+ *     size_t to;
+ *     size_t lineCount;
+ *     size_t skippedLines;
+ *     Activity* activities;
+ *     int count;
+ *     int capacity;
+ *     int reachedEnd;
+ *     int failed;
+ *     ActivityStringSource descrSource;
+ * } ParallelLoadTask;
+ *
+ * Semantic Specification:
+ * Chunk of a mapped file read by one thread of the parallel loader. The chunk begins at the beginning of
+ * a line of the file (after a '\n') and ends after a '\n' (or at the end of the file); its thread reads
+ * the records that begin in the chunk, the last one possibly ending in the next chunk.
+ *
+ * Fields:
+ * - data: The whole text
+ * - size: Number of bytes of the text
+ * - from: Position of the chunk
+ * - to: Position after the chunk
+ * - lineCount: Number of lines of the chunk, as 'readMappedLine()' splits them (first phase)
+ * - skippedLines: Lines at the beginning of the chunk that belong to a record of the previous chunk
+ * - activities: Activities read from the chunk, in file order (second phase)
+ * - count: Number of activities read
+ * - capacity: Number of activities 'activities' can hold
+ * - reachedEnd: 1 if the reading of the last record hit the end of the text (see 'MappedLines')
+ * - failed: 1 if memory allocation has failed
+ * - descrSource: The file the descriptions are left in, or NULL (see 'MappedLines')
+ */
+typedef struct parallelLoadTask {
+	const char* data;
+	size_t size;
+	size_t from;
+	size_t to;
+	size_t lineCount;
+	size_t skippedLines;
+	Activity* activities;
+	int count;
+	int capacity;
+	int reachedEnd;
+	int failed;
+	ActivityStringSource descrSource;
+} ParallelLoadTask;
+
+
+/*
+ * readMappedLine
+ *
+ * Syntactic Specification:
+ * int readMappedLine(MappedLines* lines, const char** line, size_t* length);
+ *
+ * Semantic Specification:
+ * Reads the next line as 'readLine()' does: at most MAPPED_LINE_MAX_LENGTH bytes up to and including
+ * the first '\n', ending at the first '\0', without the final '\n' and then without the final '\r'.
+ * The line is not copied: '*line' points into the text.
+ *
+ * Preconditions:
+ * - 'lines', 'line' and 'length' not NULL
+ *
+ * Postconditions:
+ * - Returns 0 and sets '*line' and '*length' if a line has been read
+ * - Returns 1 if there are no more lines
+ * - 'lines->reachedEnd' is set when the read stops at the end of the text
+ *
+ * Side Effects:
+ * - Advances the cursor
+ */
+int readMappedLine(MappedLines* lines, const char** line, size_t* length) {
+	size_t remaining = lines->size - lines->offset;
+	if (remaining == 0) {
+		lines->reachedEnd = 1;
+		return 1;
+	}
+
+	const char* start = lines->data + lines->offset;
+	size_t chunk = (remaining < MAPPED_LINE_MAX_LENGTH) ? remaining : MAPPED_LINE_MAX_LENGTH;
+	const char* newline = memchr(start, '\n', chunk);
+	if (newline != NULL) {
+		chunk = (size_t)(newline - start) + 1;
+	} else if (remaining < MAPPED_LINE_MAX_LENGTH) {
+		// 'fgets()' looked for more characters and found the end of the file
+		lines->reachedEnd = 1;
+	}
+	lines->offset += chunk;
+
+	const char* terminator = memchr(start, '\0', chunk);
+	size_t len = (terminator != NULL) ? (size_t)(terminator - start) : chunk;
+	if (len > 0 && start[len - 1] == '\n') len--;
+	if (len > 0 && start[len - 1] == '\r') len--;
+
+	*line = start;
+	*length = len;
+	return 0;
+}
+
+/*
+ * parseMappedNumber
+ *
+ * Syntactic Specification:
+ * int parseMappedNumber(const char* text, size_t length, int isSigned, unsigned long* value);
+ *
+ * Semantic Specification:
+ * Converts the number at the beginning of the text as 'sscanf()' does with a decimal conversion:
+ * the leading white spaces are skipped, then an optional sign and the digits are read with the
+ * result of 'strtol()' ('isSigned != 0') or 'strtoul()' ('isSigned == 0'): out of range values
+ * are saturated and, for 'strtoul()', a negative number is negated in the unsigned type.
+ *
+ * Preconditions:
+ * - 'text' has at least 'length' bytes, 'value != NULL'
+ *
+ * Postconditions:
+ * - Returns 1 and sets '*value' (the bits of the long for a signed conversion) if there is a number
+ * - Returns 0 if there are no digits ('*value' is unchanged)
+ *
+ * Side Effects:
+ * - None
+ */
+int parseMappedNumber(const char* text, size_t length, int isSigned, unsigned long* value) {
+	size_t i = 0;
+	while (i < length && (text[i] == ' ' || (text[i] >= '\t' && text[i] <= '\r'))) i++;
+
+	int negative = 0;
+	if (i < length && (text[i] == '+' || text[i] == '-')) {
+		negative = (text[i] == '-');
+		i++;
+	}
+	if (i == length || text[i] < '0' || text[i] > '9') return 0;
+
+	// magnitude accumulated up to the limit of the conversion
+	unsigned long limit = ULONG_MAX;
+	if (isSigned) limit = negative ? (unsigned long)LONG_MAX + 1 : (unsigned long)LONG_MAX;
+
+	unsigned long magnitude = 0;
+	int overflow = 0;
+	for (; i < length && text[i] >= '0' && text[i] <= '9'; i++) {
+		unsigned long digit = (unsigned long)(text[i] - '0');
+		if (overflow || magnitude > (limit - digit) / 10) {
+			overflow = 1;
+		} else {
+			magnitude = magnitude * 10 + digit;
+		}
+	}
+
+	if (overflow) {
+		if (isSigned) *value = negative ? (unsigned long)LONG_MIN : (unsigned long)LONG_MAX;
+		else *value = ULONG_MAX;
+	} else {
+		*value = negative ? (0UL - magnitude) : magnitude;
+	}
+
+	return 1;
+}
+
+/*
+ * readMappedActivity
+ *
+ * Syntactic Specification:
+ * Activity readMappedActivity(MappedLines* lines);
+ *
+ * Semantic Specification:
+ * Reads the next record (10 lines) as 'readActivityFromFile()' does and creates its activity.
+ * The strings are copied once, from the text straight into the activity ('newActivityWithLengths()'),
+ * and an empty line is a NULL string, as for 'readActivityFromFile()'. If the cursor has a 'descrSource',
+ * a non empty description is not copied: the activity keeps its position in the file (see
+ * 'setActivityLazyDescr()').
+ *
+ * Preconditions:
+ * - 'lines != NULL'
+ *
+ * Postconditions:
+ * - Returns the new activity
+ * - Returns NULL if less than 10 lines are left or memory allocation fails
+ *
+ * Side Effects:
+ * - Advances the cursor (by the lines read, also when less than 10)
+ * - Allocates memory
+ */
+Activity readMappedActivity(MappedLines* lines) {
+	const char* line[MAPPED_RECORD_LINES];
+	size_t length[MAPPED_RECORD_LINES];
+	for (int i = 0; i < MAPPED_RECORD_LINES; i++) {
+		if (readMappedLine(lines, &line[i], &length[i]) != 0) return NULL;
+	}
+
+	unsigned long value = 0;
+	int id = 0;
+	time_t insertDate = 0;
+	time_t expiryDate = 0;
+	time_t completionDate = 0;
+	unsigned int totalTime = 0;
+	unsigned int usedTime = 0;
+	short unsigned int priority = 2;
+
+	if (parseMappedNumber(line[0], length[0], 1, &value)) id = (int)(long)value;
+	if (parseMappedNumber(line[4], length[4], 1, &value)) insertDate = (time_t)(long)value;
+	if (parseMappedNumber(line[5], length[5], 1, &value)) expiryDate = (time_t)(long)value;
+	if (parseMappedNumber(line[6], length[6], 1, &value)) completionDate = (time_t)(long)value;
+	if (parseMappedNumber(line[7], length[7], 0, &value)) totalTime = (unsigned int)value;
+	if (parseMappedNumber(line[8], length[8], 0, &value)) usedTime = (unsigned int)value;
+	if (parseMappedNumber(line[9], length[9], 0, &value)) priority = (short unsigned int)value;
+
+	int lazyDescr = (lines->descrSource != NULL && length[2] > 0);
+	Activity activity = newActivityWithLengths(id, (length[1] > 0) ? line[1] : NULL, length[1],
+							(length[2] > 0 && !lazyDescr) ? line[2] : NULL, length[2],
+							(length[3] > 0) ? line[3] : NULL, length[3], insertDate, expiryDate, completionDate,
+							totalTime, usedTime, priority);
+	if (activity != NULL && lazyDescr) {
+		setActivityLazyDescr(activity, lines->descrSource, (off_t)(line[2] - lines->data), length[2]);
+	}
+	return activity;
+}
+
+/*
+ * readActivitiesFromMappedFile
+ *
+ * Syntactic Specification:
+ * int readActivitiesFromMappedFile(const char* filename, int lazyDescr, Activity** activities, int* count, int* reachedEnd);
+ *
+ * Semantic Specification:
+ * Reads the activities of a file in the text format of 'saveActivityToFile()' into an array, in file order:
+ * the activities are not inserted, so that the caller can build the tree at once (see 'insertSortedActivities()').
+ * The file is mapped in memory ('mmap()'): the lines are found with 'memchr()' directly in the mapping and the
+ * numeric fields are parsed in place, so only the strings are copied (once) before building the activity.
+ * The accepted input is exactly the one of 'readActivityFromFile()' called until the end of the file:
+ * - the lines are split as 'readLine()' does (at most 1023 characters per line, the rest is the next line;
+ *   a final '\n' and then a final '\r' are removed; a line ends at its first '\0')
+ * - the numeric fields are converted as 'sscanf()' does with "%d", "%ld", "%u" and "%hu" (leading spaces,
+ *   sign, out of range values), and a field with no number keeps its default value
+ * - the reading stops at the first record with less than 10 lines
+ * With 'lazyDescr' the descriptions are not read: the file stays open (shared by the activities, see
+ * 'newActivityStringSource()') and every description is read from it the first time it's needed.
+ *
+ * Preconditions:
+ * - 'activities != NULL', 'count != NULL', 'reachedEnd != NULL'
+ *
+ * Postconditions:
+ * - Returns 1 if the file can't be mapped (it doesn't exist, it is not a regular file, ...) or memory
+ *   allocation fails: nothing is read and the caller can fall back to 'readActivityFromFile()'
+ * - Otherwise returns 0: '*activities' is a new array with the '*count' activities in file order (the
+ *   caller deallocates the array and owns the activities) and '*reachedEnd' is 1 if the reading ended
+ *   after a complete record at the end of the file (when 'feof()' would be set), 0 if it stopped at an
+ *   incomplete record
+ *
+ * Side Effects:
+ * - Maps and unmaps the file
+ * - Allocates the activities and their array
+ * - With 'lazyDescr', the file stays open until no activity needs to read its description from it
+ */
+int readActivitiesFromMappedFile(const char* filename, int lazyDescr, Activity** activities, int* count, int* reachedEnd) {
+	if (filename == NULL || activities == NULL || count == NULL || reachedEnd == NULL) return 1;
+
+	int fd = open(filename, O_RDONLY);
+	if (fd < 0) return 1;
+
+	struct stat fileInfo;
+	if (fstat(fd, &fileInfo) != 0 || !S_ISREG(fileInfo.st_mode)) {
+		close(fd);
+		return 1;
+	}
+
+	MappedLines lines = { NULL, (size_t)fileInfo.st_size, 0, 0, NULL };
+	void* mapping = NULL;
+	if (lines.size > 0) {
+		mapping = mmap(NULL, lines.size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (mapping == MAP_FAILED) {
+			close(fd);
+			return 1;
+		}
+		madvise(mapping, lines.size, MADV_SEQUENTIAL);
+		lines.data = mapping;
+	}
+	if (lazyDescr) lines.descrSource = newActivityStringSource(fd); // descriptions copied if it fails
+	if (lines.descrSource == NULL) close(fd);
+
+	Activity* read = NULL;
+	int capacity = 0;
+	int failed = 0;
+	*count = 0;
+	*reachedEnd = 0;
+	while (!lines.reachedEnd) {
+		if (*count == capacity) {
+			int newCapacity = (capacity > 0) ? capacity * 2 : 1024;
+			Activity* grown = realloc(read, newCapacity * sizeof(Activity));
+			if (grown == NULL) {
+				failed = 1;
+				break;
+			}
+			read = grown;
+			capacity = newCapacity;
+		}
+
+		Activity activity = readMappedActivity(&lines);
+		if (activity == NULL) break;
+
+		read[*count] = activity;
+		*count += 1;
+		*reachedEnd = lines.reachedEnd;
+	}
+
+	if (mapping != NULL) munmap(mapping, lines.size);
+	releaseActivityStringSource(&lines.descrSource); // the file stays open while an activity needs it
+
+	if (failed) {
+		for (int i = 0; i < *count; i++) deleteActivity(read[i]);
+		free(read);
+		*count = 0;
+		return 1;
+	}
+
+	*activities = read;
+	return 0;
+}
+
+
+/*
+ * countMappedLinesTask
+ *
+ * Syntactic Specification:
+ * void* countMappedLinesTask(void* argument);
+ *
+ * Semantic Specification:
+ * Thread routine of the first phase of the parallel loader: counts the lines of the chunk as
+ * 'readMappedLine()' splits them, with no need to know where the records begin. A line of the file of
+ * n bytes (its '\n' included) is read in ceil(n / MAPPED_LINE_MAX_LENGTH) parts, since every read takes at
+ * most MAPPED_LINE_MAX_LENGTH bytes and stops after the first '\n'.
+ *
+ * Preconditions:
+ * - 'argument' points to a valid ParallelLoadTask
+ *
+ * Postconditions:
+ * - Returns NULL; 'lineCount' is set
+ *
+ * Side Effects:
+ * - Modifies the task
+ */
+void* countMappedLinesTask(void* argument) {
+	ParallelLoadTask* task = (ParallelLoadTask*)argument;
+
+	size_t lineCount = 0;
+	size_t position = task->from;
+	while (position < task->to) {
+		const char* newline = memchr(task->data + position, '\n', task->to - position);
+		size_t end = (newline != NULL) ? (size_t)(newline - task->data) + 1 : task->to;
+		lineCount += (end - position + MAPPED_LINE_MAX_LENGTH - 1) / MAPPED_LINE_MAX_LENGTH;
+		position = end;
+	}
+
+	task->lineCount = lineCount;
+	return NULL;
+}
+
+/*
+ * readMappedActivitiesTask
+ *
+ * Syntactic Specification:
+ * void* readMappedActivitiesTask(void* argument);
+ *
+ * Semantic Specification:
+ * Thread routine of the second phase of the parallel loader: skips the lines that end a record of the
+ * previous chunk, then reads with 'readMappedActivity()' the records that begin in the chunk, exactly as
+ * 'readActivitiesFromMappedFile()' would read them (the same reads from the same positions).
+ *
+ * Preconditions:
+ * - 'argument' points to a valid ParallelLoadTask with 'skippedLines' set
+ *
+ * Postconditions:
+ * - Returns NULL; 'activities', 'count' and 'reachedEnd' are set ('failed' if memory allocation fails)
+ *
+ * Side Effects:
+ * - Allocates the activities and their array
+ */
+void* readMappedActivitiesTask(void* argument) {
+	ParallelLoadTask* task = (ParallelLoadTask*)argument;
+	MappedLines lines = { task->data, task->size, task->from, 0, task->descrSource };
+
+	const char* line = NULL;
+	size_t length = 0;
+	for (size_t i = 0; i < task->skippedLines; i++) {
+		if (readMappedLine(&lines, &line, &length) != 0) return NULL;
+	}
+
+	while (!lines.reachedEnd && lines.offset < task->to) {
+		if (task->count == task->capacity) {
+			int capacity = (task->capacity > 0) ? task->capacity * 2 : 1024;
+			Activity* activities = realloc(task->activities, capacity * sizeof(Activity));
+			if (activities == NULL) {
+				task->failed = 1;
+				return NULL;
+			}
+			task->activities = activities;
+			task->capacity = capacity;
+		}
+
+		Activity activity = readMappedActivity(&lines);
+		if (activity == NULL) {
+			// at the end of the text the record is incomplete, otherwise memory allocation has failed
+			if (!lines.reachedEnd) task->failed = 1;
+			return NULL;
+		}
+
+		task->activities[task->count++] = activity;
+		task->reachedEnd = lines.reachedEnd;
+	}
+
+	return NULL;
+}
+
+/*
+ * runParallelLoadTasks
+ *
+ * Syntactic Specification:
+ * void runParallelLoadTasks(void* (*routine)(void*), ParallelLoadTask* tasks, int taskCount);
+ *
+ * Semantic Specification:
+ * Runs routine on every task, one thread per task, and waits for all of them.
+ * A task whose thread can't be created is run by the calling thread.
+ *
+ * Preconditions:
+ * - 0 < taskCount <= PARALLEL_LOAD_MAX_THREADS
+ *
+ * Postconditions:
+ * - All the tasks are done
+ *
+ * Side Effects:
+ * - Creates and joins threads
+ */
+void runParallelLoadTasks(void* (*routine)(void*), ParallelLoadTask* tasks, int taskCount) {
+	pthread_t threads[PARALLEL_LOAD_MAX_THREADS];
+	int started[PARALLEL_LOAD_MAX_THREADS];
+
+	// The calling thread takes the first task itself
+	for (int t = 1; t < taskCount; t++) {
+		started[t] = (pthread_create(&threads[t], NULL, routine, &tasks[t]) == 0) ? 1 : 0;
+	}
+
+	routine(&tasks[0]);
+	for (int t = 1; t < taskCount; t++) {
+		if (started[t] == 1) {
+			pthread_join(threads[t], NULL);
+		} else {
+			routine(&tasks[t]);
+		}
+	}
+}
+
+/*
+ * resolveLoadThreadCount
+ *
+ * Syntactic Specification:
+ * int resolveLoadThreadCount(int threadCount, size_t minChunkSize, size_t size);
+ *
+ * Semantic Specification:
+ * Returns the number of threads the parallel loader uses for a file of 'size' bytes: threadCount, or one
+ * per online processor if threadCount <= 0, limited to PARALLEL_LOAD_MAX_THREADS and so that every thread
+ * reads at least minChunkSize bytes (PARALLEL_LOAD_MIN_CHUNK_SIZE if minChunkSize is 0).
+ *
+ * Preconditions:
+ * - None
+ *
+ * Postconditions:
+ * - Returns a value between 1 and PARALLEL_LOAD_MAX_THREADS
+ *
+ * Side Effects:
+ * - None
+ */
+int resolveLoadThreadCount(int threadCount, size_t minChunkSize, size_t size) {
+	if (threadCount <= 0) {
+		long processors = sysconf(_SC_NPROCESSORS_ONLN);
+		threadCount = (processors > 0) ? (int)processors : 1;
+	}
+	if (minChunkSize == 0) minChunkSize = PARALLEL_LOAD_MIN_CHUNK_SIZE;
+
+	size_t count = (size_t)threadCount;
+	if (count > PARALLEL_LOAD_MAX_THREADS) count = PARALLEL_LOAD_MAX_THREADS;
+	if (count > size / minChunkSize) count = size / minChunkSize;
+
+	return (count > 0) ? (int)count : 1;
+}
+
+/*
+ * readActivitiesFromMappedFileInParallel
+ *
+ * Syntactic Specification:
+ * int readActivitiesFromMappedFileInParallel(const char* filename, int lazyDescr, int threadCount, size_t minChunkSize,
+ *                                             Activity** activities, int* count, int* reachedEnd);
+ *
+ * Semantic Specification:
+ * Reads the activities of a large file in the text format on several threads, with the same result of
+ * 'readActivitiesFromMappedFile()'. The threads are threadCount (one per online processor if it's 0), but
+ * each one reads at least minChunkSize bytes (PARALLEL_LOAD_MIN_CHUNK_SIZE if it's 0): a smaller file is
+ * read by fewer threads (see 'resolveLoadThreadCount()'). The mapped file is split in chunks of about the
+ * same size, each one beginning at the beginning of a line; then, in two parallel phases:
+ * - every thread counts the lines of its chunk (see 'countMappedLinesTask()'): the sums of the counts of
+ *   the previous chunks tell where the first record of every chunk begins (records have 10 lines)
+ * - every thread reads the records that begin in its chunk into its own array
+ * The arrays are joined in file order: the activities are not inserted, so that the caller can build
+ * the tree at once (see 'insertSortedActivities()'). 'lazyDescr' is the same of 'readActivitiesFromMappedFile()'.
+ *
+ * Preconditions:
+ * - 'activities != NULL', 'count != NULL', 'reachedEnd != NULL'
+ *
+ * Postconditions:
+ * - Returns 1 if the file can't be mapped, is too small to be split on two threads or memory allocation
+ *   fails: nothing is read and the caller can fall back to 'readActivitiesFromMappedFile()'
+ * - Otherwise returns 0: '*activities' is a new array with the '*count' activities in file order (the
+ *   caller deallocates the array and owns the activities) and '*reachedEnd' is set as by
+ *   'readActivitiesFromMappedFile()'
+ *
+ * Side Effects:
+ * - Maps and unmaps the file
+ * - Creates and joins threads
+ * - Allocates memory
+ */
+int readActivitiesFromMappedFileInParallel(const char* filename, int lazyDescr, int threadCount, size_t minChunkSize,
+											Activity** activities, int* count, int* reachedEnd) {
+	if (filename == NULL || activities == NULL || count == NULL || reachedEnd == NULL) return 1;
+
+	int fd = open(filename, O_RDONLY);
+	if (fd < 0) return 1;
+
+	struct stat fileInfo;
+	if (fstat(fd, &fileInfo) != 0 || !S_ISREG(fileInfo.st_mode)) {
+		close(fd);
+		return 1;
+	}
+
+	size_t size = (size_t)fileInfo.st_size;
+	threadCount = resolveLoadThreadCount(threadCount, minChunkSize, size);
+	if (threadCount < 2) {
+		close(fd);
+		return 1;
+	}
+
+	void* mapping = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (mapping == MAP_FAILED) {
+		close(fd);
+		return 1;
+	}
+	ActivityStringSource descrSource = lazyDescr ? newActivityStringSource(fd) : NULL;
+	if (descrSource == NULL) close(fd);
+	madvise(mapping, size, MADV_WILLNEED);
+	const char* data = mapping;
+
+	// Chunks of about the same size, moved forward to the beginning of a line
+	ParallelLoadTask tasks[PARALLEL_LOAD_MAX_THREADS];
+	size_t bounds[PARALLEL_LOAD_MAX_THREADS + 1];
+	bounds[0] = 0;
+	bounds[threadCount] = size;
+	for (int t = 1; t < threadCount; t++) {
+		size_t bound = (size_t)((unsigned long long)size * t / threadCount);
+		if (bound < bounds[t-1]) bound = bounds[t-1];
+		// 'bound > 0', since every chunk has at least minChunkSize bytes
+		const char* newline = memchr(data + bound - 1, '\n', size - bound + 1);
+		bounds[t] = (newline != NULL) ? (size_t)(newline - data) + 1 : size;
+	}
+
+	for (int t = 0; t < threadCount; t++) {
+		ParallelLoadTask task = { data, size, bounds[t], bounds[t+1], 0, 0, NULL, 0, 0, 0, 0, descrSource };
+		tasks[t] = task;
+	}
+	runParallelLoadTasks(countMappedLinesTask, tasks, threadCount);
+
+	size_t linesBefore = 0;
+	for (int t = 0; t < threadCount; t++) {
+		tasks[t].skippedLines = (MAPPED_RECORD_LINES - linesBefore % MAPPED_RECORD_LINES) % MAPPED_RECORD_LINES;
+		linesBefore += tasks[t].lineCount;
+	}
+	runParallelLoadTasks(readMappedActivitiesTask, tasks, threadCount);
+	munmap(mapping, size);
+	releaseActivityStringSource(&descrSource);
+
+	// Join the arrays of the chunks in file order
+	size_t total = 0;
+	int failed = 0;
+	for (int t = 0; t < threadCount; t++) {
+		total += (size_t)tasks[t].count;
+		if (tasks[t].failed) failed = 1;
+	}
+
+	Activity* joined = NULL;
+	if (!failed && total <= INT_MAX) joined = malloc((total > 0 ? total : 1) * sizeof(Activity));
+
+	*count = 0;
+	*reachedEnd = 0;
+	for (int t = 0; t < threadCount; t++) {
+		for (int i = 0; i < tasks[t].count; i++) {
+			if (joined != NULL) joined[*count] = tasks[t].activities[i];
+			else deleteActivity(tasks[t].activities[i]);
+			*count += (joined != NULL) ? 1 : 0;
+		}
+		if (tasks[t].count > 0) *reachedEnd = tasks[t].reachedEnd;
+		free(tasks[t].activities);
+	}
+
+	if (joined == NULL) {
+		*count = 0;
+		return 1;
+	}
+
+	*activities = joined;
+	return 0;
+}
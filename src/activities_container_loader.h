@@ -0,0 +1,89 @@
+#ifndef ACTIVITIES_CONTAINER_LOADER_H             // Start of inclusion block
+#define ACTIVITIES_CONTAINER_LOADER_H             // Macro definition to avoid multiple inclusions
+
+#include "activities_container.h"
+
+// Maximum number of characters of a line read at once: the same of 'readLine()' (buffer of 1024 bytes for 'fgets()')
+#define MAPPED_LINE_MAX_LENGTH 1023
+
+// Minimum number of bytes read by every thread of the parallel loader (when the caller doesn't choose it)
+// (it can be changed at build time, e.g. -DPARALLEL_LOAD_MIN_CHUNK_SIZE=4194304)
+#ifndef PARALLEL_LOAD_MIN_CHUNK_SIZE
+#define PARALLEL_LOAD_MIN_CHUNK_SIZE (1 << 20)
+#endif
+
+
+/*
+ * readActivitiesFromMappedFile
+ *
+ * Syntactic Specification:
+ * int readActivitiesFromMappedFile(const char* filename, int lazyDescr, Activity** activities, int* count, int* reachedEnd);
+ *
+ * Semantic Specification:
+ * Reads the activities of a file in the text format of 'saveActivityToFile()' and inserts them into the container.
+ * The file is mapped in memory ('mmap()'): the lines are found with 'memchr()' directly in the mapping and the
+ * numeric fields are parsed in place, so only the strings are copied (once) before building the activity.
+ * The accepted input is exactly the one of 'readActivityFromFile()' called until the end of the file:
+ * - the lines are split as 'readLine()' does (at most 1023 characters per line, the rest is the next line;
+ *   a final '\n' and then a final '\r' are removed; a line ends at its first '\0')
+ * - the numeric fields are converted as 'sscanf()' does with "%d", "%ld", "%u" and "%hu" (leading spaces,
+ *   sign, out of range values), and a field with no number keeps its default value
+ * - the reading stops at the first record with less than 10 lines
+ * With 'lazyDescr' the descriptions are not read: the file stays open (shared by the activities, see
+ * 'newActivityStringSource()') and every description is read from it the first time it's needed.
+ *
+ * Preconditions:
+ * - 'container != NULL', 'count != NULL', 'reachedEnd != NULL'
+ *
+ * Postconditions:
+ * - Returns 1 if the file can't be mapped (it doesn't exist, it is not a regular file, ...): nothing is read
+ *   and the caller can fall back to 'readActivityFromFile()'
+ * - Otherwise returns 0, '*count' is the number of activities read and '*reachedEnd' is 1 if the reading
+ *   ended after a complete record at the end of the file (when 'feof()' would be set), 0 if it stopped at an
+ *   incomplete record
+ *
+ * Side Effects:
+ * - Maps and unmaps the file
+ * - Allocates the activities and inserts them into the container
+ * - With 'lazyDescr', the file stays open until no activity needs to read its description from it
+ */
+int readActivitiesFromMappedFile(const char* filename, int lazyDescr, Activity** activities, int* count, int* reachedEnd);
+
+/*
+ * readActivitiesFromMappedFileInParallel
+ *
+ * Syntactic Specification:
+ * int readActivitiesFromMappedFileInParallel(const char* filename, int lazyDescr, int threadCount, size_t minChunkSize,
+ *                                             Activity** activities, int* count, int* reachedEnd);
+ *
+ * Semantic Specification:
+ * Reads the activities of a large file in the text format on several threads, with the same result of
+ * 'readActivitiesFromMappedFile()'. The threads are threadCount (one per online processor if it's 0), but
+ * each one reads at least minChunkSize bytes (PARALLEL_LOAD_MIN_CHUNK_SIZE if it's 0): a smaller file is
+ * read by fewer threads (see 'resolveLoadThreadCount()'). The mapped file is split in chunks of about the
+ * same size, each one beginning at the beginning of a line; then, in two parallel phases:
+ * - every thread counts the lines of its chunk (see 'countMappedLinesTask()'): the sums of the counts of
+ *   the previous chunks tell where the first record of every chunk begins (records have 10 lines)
+ * - every thread reads the records that begin in its chunk into its own array
+ * The arrays are joined in file order: the activities are not inserted, so that the caller can build
+ * the tree at once (see 'insertSortedActivities()'). 'lazyDescr' is the same of 'readActivitiesFromMappedFile()'.
+ *
+ * Preconditions:
+ * - 'activities != NULL', 'count != NULL', 'reachedEnd != NULL'
+ *
+ * Postconditions:
+ * - Returns 1 if the file can't be mapped, is too small to be split on two threads or memory allocation
+ *   fails: nothing is read and the caller can fall back to 'readActivitiesFromMappedFile()'
+ * - Otherwise returns 0: '*activities' is a new array with the '*count' activities in file order (the
+ *   caller deallocates the array and owns the activities) and '*reachedEnd' is set as by
+ *   'readActivitiesFromMappedFile()'
+ *
+ * Side Effects:
+ * - Maps and unmaps the file
+ * - Creates and joins threads
+ * - Allocates memory
+ */
+int readActivitiesFromMappedFileInParallel(const char* filename, int lazyDescr, int threadCount, size_t minChunkSize,
+											Activity** activities, int* count, int* reachedEnd);
+
+#endif // ACTIVITIES_CONTAINER_LOADER_H          // End of inclusion block
@@ -0,0 +1,1460 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "activity.h"
+#include "activities_container_mapped.h"
+#include "activities_container_writer.h"
+#include "activities_container_checksum.h"
+
+// Byte order mark of the header (see ACTIVITY_SNAPSHOT_BYTE_ORDER_MARK)
+#define ACTIVITY_MAP_BYTE_ORDER_MARK 0x01020304u
+// Length of a NULL string in a node
+#define ACTIVITY_MAP_NULL_STRING UINT32_MAX
+// Alignment of the nodes in the file
+#define ACTIVITY_MAP_NODE_ALIGNMENT 8
+// Number of strings of a node (name, description, course)
+#define ACTIVITY_MAP_STRING_FIELDS 3
+
+
+/*
+ * "struct mapHeader" Documentation
+ *
+ * Syntactic Specification:
+ * typedef struct mapHeader {
+ *     char magic[8];
+ *     uint32_t version;
+ *     uint32_t byteOrderMark;
+ *     uint32_t nodeSize;
+ *     uint32_t reserved;
+ *     uint64_t used;
+ *     uint64_t root;
+ *     uint64_t count;
+ *     uint64_t deadBytes;
+ *     uint64_t reserved2;
+ * } MapHeader;
+ *
+ * Semantic Specification:
+ * Header at the beginning of a mapped store (64 bytes, no padding).
+ *
+ * Fields:
+ * - magic: ACTIVITY_MAP_MAGIC, padded with '\0'
+ * - version: ACTIVITY_MAP_VERSION
+ * - byteOrderMark: ACTIVITY_MAP_BYTE_ORDER_MARK
+ * - nodeSize: Size of a node (sizeof(MapNode))
+ * - reserved, reserved2: 0
+ * - used: Bytes of the file in use (header, nodes and strings); the rest of the file is room to grow
+ * - root: Offset of the root node of the tree, 0 if there are no activities
+ * - count: Number of activities (nodes of the tree)
+ * - deadBytes: Bytes of nodes and strings in use but no longer reachable from the root
+ */
+typedef struct mapHeader {
+	char magic[8];
+	uint32_t version;
+	uint32_t byteOrderMark;
+	uint32_t nodeSize;
+	uint32_t reserved;
+	uint64_t used;
+	uint64_t root;
+	uint64_t count;
+	uint64_t deadBytes;
+	uint64_t reserved2;
+} MapHeader;
+
+
+/*
+ * "struct mapNode" Documentation
+ *
+ * Syntactic Specification:
+ * typedef struct mapNode {
+ *     uint64_t left;
+ *     uint64_t right;
+ *     int64_t insertDate;
+ *     int64_t expiryDate;
+ *     int64_t completionDate;
+ *     uint64_t strings[ACTIVITY_MAP_STRING_FIELDS];
+ *     uint32_t lengths[ACTIVITY_MAP_STRING_FIELDS];
+ *     int32_t id;
+ *     int32_t height;
+ *     uint32_t totalTime;
+ *     uint32_t usedTime;
+ *     uint16_t priority;
+ *     uint16_t reserved;
+ * } MapNode;
+ *
+ * Semantic Specification:
+ * Node of the AVL tree of a mapped store, with its activity (96 bytes, no padding).
+ *
+ * Fields:
+ * - left, right: Offsets of the child nodes, 0 for none
+ * - insertDate, expiryDate, completionDate: Dates of the activity
+ * - strings: Offsets of name, description and course (each ending with '\0')
+ * - lengths: Lengths of the strings, ACTIVITY_MAP_NULL_STRING for a NULL string
+ * - id, totalTime, usedTime, priority: Fields of the activity
+ * - height: Height of the subtree of the node (1 for a leaf)
+ * - reserved: 0
+ */
+typedef struct mapNode {
+	uint64_t left;
+	uint64_t right;
+	int64_t insertDate;
+	int64_t expiryDate;
+	int64_t completionDate;
+	uint64_t strings[ACTIVITY_MAP_STRING_FIELDS];
+	uint32_t lengths[ACTIVITY_MAP_STRING_FIELDS];
+	int32_t id;
+	int32_t height;
+	uint32_t totalTime;
+	uint32_t usedTime;
+	uint16_t priority;
+	uint16_t reserved;
+} MapNode;
+
+
+/*
+ * "struct mapCursor" Documentation
+ *
+ * Syntactic Specification:
+ * typedef struct mapCursor {
+ *     uint64_t stack[ACTIVITY_MAP_MAX_HEIGHT];
+ *     int depth;
+ * } MapCursor;
+ *
+ * Semantic Specification:
+ * Position of an in-order visit of the tree of a mapped store. Only offsets are kept, so the visit goes
+ * on after the file is mapped again at another address.
+ *
+ * Fields:
+ * - stack: Offsets of the nodes whose right subtree is still to visit, the next one on top
+ * - depth: Number of offsets in 'stack'
+ */
+typedef struct mapCursor {
+	uint64_t stack[ACTIVITY_MAP_MAX_HEIGHT];
+	int depth;
+} MapCursor;
+
+
+/*
+ * "struct activityMap" Documentation
+ *
+ * Syntactic Specification:
+ * struct activityMap {
+ *     char* filename;
+ *     int fd;
+ *     unsigned char* base;
+ *     size_t mappedSize;
+ *     int readOnly;
+ *     uint64_t used;
+ *     uint64_t count;
+ *     uint64_t deadBytes;
+ *     int failed;
+ *     dev_t device;
+ *     ino_t inode;
+ *     off_t size;
+ *     struct timespec modified;
+ * };
+ *
+ * Semantic Specification:
+ * A mapped store: the file, mapped in memory with 'MAP_SHARED', and the state of the update in progress.
+ *
+ * Fields:
+ * - filename: Name of the file
+ * - fd: The file, open for reading (and writing unless 'readOnly')
+ * - base, mappedSize: Address and size of the mapping (the whole file)
+ * - readOnly: 1 if the file can't be written
+ * - used, count, deadBytes: The fields of the header during an update, the header being written only at the end
+ * - failed: 1 if a node or a string is not valid, or the file couldn't grow
+ * - device, inode, size, modified: Identity of the file at the last save or opening, to detect a file changed
+ */
+struct activityMap {
+	char* filename;
+	int fd;
+	unsigned char* base;
+	size_t mappedSize;
+	int readOnly;
+	uint64_t used;
+	uint64_t count;
+	uint64_t deadBytes;
+	int failed;
+	dev_t device;
+	ino_t inode;
+	off_t size;
+	struct timespec modified;
+};
+
+
+/*
+ * getMapNode
+ *
+ * Syntactic Specification:
+ * MapNode* getMapNode(ActivityMap map, uint64_t offset);
+ *
+ * Semantic Specification:
+ * Returns the node at an offset of the mapping, checking that it's aligned and inside the bytes in use.
+ * The address is valid until the file grows (see 'growActivityMap()').
+ *
+ * Preconditions:
+ * - 'map != NULL'
+ *
+ * Postconditions:
+ * - Returns the node, NULL if the offset is not valid ('map->failed' is set)
+ *
+ * Side Effects:
+ * - May modify 'map->failed'
+ */
+MapNode* getMapNode(ActivityMap map, uint64_t offset) {
+	if (offset < sizeof(MapHeader) || offset % ACTIVITY_MAP_NODE_ALIGNMENT != 0 || map->used < sizeof(MapNode) ||
+		 offset > map->used - sizeof(MapNode)) {
+		map->failed = 1;
+		return NULL;
+	}
+	return (MapNode*)(map->base + offset);
+}
+
+/*
+ * getMapNodeHeight
+ *
+ * Syntactic Specification:
+ * int32_t getMapNodeHeight(ActivityMap map, uint64_t offset);
+ *
+ * Semantic Specification:
+ * Returns the height of the subtree of a node (0 for no node).
+ *
+ * Preconditions:
+ * - 'map != NULL'
+ *
+ * Postconditions:
+ * - Returns the height, 0 if the offset is 0 or not valid ('map->failed' is set)
+ *
+ * Side Effects:
+ * - May modify 'map->failed'
+ */
+int32_t getMapNodeHeight(ActivityMap map, uint64_t offset) {
+	if (offset == 0) return 0;
+
+	MapNode* node = getMapNode(map, offset);
+	return (node != NULL) ? node->height : 0;
+}
+
+/*
+ * getMapString
+ *
+ * Syntactic Specification:
+ * char* getMapString(ActivityMap map, uint64_t offset, uint32_t length);
+ *
+ * Semantic Specification:
+ * Returns a string of the mapping, checking that it's inside the bytes in use and ends with its '\0'.
+ *
+ * Preconditions:
+ * - 'map != NULL'
+ *
+ * Postconditions:
+ * - Returns the string (in the mapping), NULL for a NULL string or if it's not valid ('map->failed' is set)
+ *
+ * Side Effects:
+ * - May modify 'map->failed'
+ */
+char* getMapString(ActivityMap map, uint64_t offset, uint32_t length) {
+	if (length == ACTIVITY_MAP_NULL_STRING) return NULL;
+
+	if (offset < sizeof(MapHeader) || offset >= map->used || map->used - offset <= length || map->base[offset + length] != '\0') {
+		map->failed = 1;
+		return NULL;
+	}
+	return (char*)(map->base + offset);
+}
+
+/*
+ * getMapNodeStringBytes
+ *
+ * Syntactic Specification:
+ * uint64_t getMapNodeStringBytes(const MapNode* node);
+ *
+ * Semantic Specification:
+ * Returns the bytes taken by the strings of a node (each with its '\0').
+ *
+ * Preconditions:
+ * - 'node != NULL'
+ *
+ * Postconditions:
+ * - Returns the number of bytes
+ *
+ * Side Effects:
+ * - None
+ */
+uint64_t getMapNodeStringBytes(const MapNode* node) {
+	uint64_t bytes = 0;
+	for (int field = 0; field < ACTIVITY_MAP_STRING_FIELDS; field++) {
+		if (node->lengths[field] != ACTIVITY_MAP_NULL_STRING) bytes += (uint64_t)node->lengths[field] + 1;
+	}
+	return bytes;
+}
+
+/*
+ * newActivityFromMapNode
+ *
+ * Syntactic Specification:
+ * Activity newActivityFromMapNode(ActivityMap map, uint64_t offset);
+ *
+ * Semantic Specification:
+ * Creates the activity of a node (its strings copied from the mapping). The activity is clean.
+ *
+ * Preconditions:
+ * - 'map != NULL'
+ *
+ * Postconditions:
+ * - Returns the new activity, NULL if the node or a string is not valid ('map->failed' is set) or memory
+ *   allocation fails
+ *
+ * Side Effects:
+ * - Allocates memory
+ * - May modify 'map->failed'
+ */
+Activity newActivityFromMapNode(ActivityMap map, uint64_t offset) {
+	MapNode* node = getMapNode(map, offset);
+	if (node == NULL) return NULL;
+
+	char* strings[ACTIVITY_MAP_STRING_FIELDS];
+	for (int field = 0; field < ACTIVITY_MAP_STRING_FIELDS; field++) {
+		strings[field] = getMapString(map, node->strings[field], node->lengths[field]);
+	}
+	if (map->failed) return NULL;
+
+	Activity a = newActivity(node->id, strings[0], strings[1], strings[2], (time_t)node->insertDate,
+									 (time_t)node->expiryDate, (time_t)node->completionDate, node->totalTime,
+									 node->usedTime, node->priority);
+	if (a != NULL) markActivityClean(a);
+	return a;
+}
+
+/*
+ * growActivityMap
+ *
+ * Syntactic Specification:
+ * int growActivityMap(ActivityMap map, uint64_t neededSize);
+ *
+ * Semantic Specification:
+ * Makes the file at least 'neededSize' bytes long: it's extended ('ftruncate()') at least doubling, by
+ * ACTIVITY_MAP_MIN_GROWTH bytes at least, and mapped again. The mapping can move: the offsets in the file
+ * stay valid, the addresses of nodes and strings taken before don't.
+ *
+ * Preconditions:
+ * - 'map != NULL', not read-only
+ *
+ * Postconditions:
+ * - Returns 0 if the file and the mapping have the size needed, 1 otherwise (the previous mapping is kept)
+ *
+ * Side Effects:
+ * - Extension of the file, memory mapping
+ */
+int growActivityMap(ActivityMap map, uint64_t neededSize) {
+	if (neededSize <= map->mappedSize) return 0;
+	if (map->readOnly) return 1;
+
+	uint64_t size = (uint64_t)map->mappedSize * 2;
+	if (size < (uint64_t)map->mappedSize + ACTIVITY_MAP_MIN_GROWTH) size = (uint64_t)map->mappedSize + ACTIVITY_MAP_MIN_GROWTH;
+	if (size < neededSize) size = neededSize;
+	if (size > SIZE_MAX || ftruncate(map->fd, (off_t)size) != 0) return 1;
+
+	void* base = mmap(NULL, (size_t)size, PROT_READ | PROT_WRITE, MAP_SHARED, map->fd, 0);
+	if (base == MAP_FAILED) return 1;
+
+	munmap(map->base, map->mappedSize);
+	map->base = base;
+	map->mappedSize = (size_t)size;
+	return 0;
+}
+
+/*
+ * allocateMapBytes
+ *
+ * Syntactic Specification:
+ * uint64_t allocateMapBytes(ActivityMap map, uint64_t size, uint64_t alignment);
+ *
+ * Semantic Specification:
+ * Takes 'size' bytes after the bytes in use, at an offset multiple of 'alignment' (the padding is zeroed),
+ * growing the file if needed.
+ *
+ * Preconditions:
+ * - 'map != NULL', 'alignment > 0'
+ *
+ * Postconditions:
+ * - Returns the offset of the bytes, 0 if the file can't grow ('map->failed' is set)
+ *
+ * Side Effects:
+ * - May extend the file and map it again
+ */
+uint64_t allocateMapBytes(ActivityMap map, uint64_t size, uint64_t alignment) {
+	uint64_t offset = (map->used + alignment - 1) / alignment * alignment;
+	if (growActivityMap(map, offset + size) != 0) {
+		map->failed = 1;
+		return 0;
+	}
+
+	memset(map->base + map->used, 0, (size_t)(offset - map->used));
+	map->used = offset + size;
+	return offset;
+}
+
+/*
+ * storeMapNode
+ *
+ * Syntactic Specification:
+ * uint64_t storeMapNode(ActivityMap map, const MapNode* node);
+ *
+ * Semantic Specification:
+ * Appends a copy of a node after the bytes in use.
+ *
+ * Preconditions:
+ * - 'map != NULL', 'node' not in the mapping (it can move)
+ *
+ * Postconditions:
+ * - Returns the offset of the new node, 0 if the file can't grow ('map->failed' is set)
+ *
+ * Side Effects:
+ * - Writing to the mapping, may extend the file
+ */
+uint64_t storeMapNode(ActivityMap map, const MapNode* node) {
+	uint64_t offset = allocateMapBytes(map, sizeof(MapNode), ACTIVITY_MAP_NODE_ALIGNMENT);
+	if (offset != 0) memcpy(map->base + offset, node, sizeof(MapNode));
+	return offset;
+}
+
+/*
+ * fillMapNode
+ *
+ * Syntactic Specification:
+ * int fillMapNode(ActivityMap map, Activity a, MapNode* node);
+ *
+ * Semantic Specification:
+ * Fills a node (with no children) with the fields of an activity, appending its strings to the mapping.
+ *
+ * Preconditions:
+ * - 'map != NULL', 'a != NULL', 'node' not in the mapping
+ *
+ * Postconditions:
+ * - Returns 0 on success, 1 if a string is too long, the description can't be read from its file or the
+ *   file can't grow ('map->failed' is set)
+ *
+ * Side Effects:
+ * - Writing to the mapping, may extend the file
+ */
+int fillMapNode(ActivityMap map, Activity a, MapNode* node) {
+	memset(node, 0, sizeof(MapNode));
+	const char* strings[ACTIVITY_MAP_STRING_FIELDS] = { getActivityName(a), getActivityDescr(a), getActivityCourse(a) };
+	if (!isActivityDescrLoaded(a)) {
+		map->failed = 1;
+		return 1;
+	}
+	for (int field = 0; field < ACTIVITY_MAP_STRING_FIELDS; field++) {
+		node->lengths[field] = ACTIVITY_MAP_NULL_STRING;
+		if (strings[field] == NULL) continue;
+
+		size_t length = strlen(strings[field]);
+		if (length >= ACTIVITY_MAP_NULL_STRING) {
+			map->failed = 1;
+			return 1;
+		}
+		uint64_t offset = allocateMapBytes(map, (uint64_t)length + 1, 1);
+		if (offset == 0) return 1;
+		memcpy(map->base + offset, strings[field], length + 1);
+		node->strings[field] = offset;
+		node->lengths[field] = (uint32_t)length;
+	}
+
+	node->insertDate = (int64_t)getActivityInsertDate(a);
+	node->expiryDate = (int64_t)getActivityExpiryDate(a);
+	node->completionDate = (int64_t)getActivityCompletionDate(a);
+	node->id = getActivityId(a);
+	node->height = 1;
+	node->totalTime = getActivityTotalTime(a);
+	node->usedTime = getActivityUsedTime(a);
+	node->priority = getActivityPriority(a);
+	return 0;
+}
+
+/*
+ * updateMapNodeHeight
+ *
+ * Syntactic Specification:
+ * void updateMapNodeHeight(ActivityMap map, MapNode* node);
+ *
+ * Semantic Specification:
+ * Sets the height of a node from the ones of its children.
+ *
+ * Preconditions:
+ * - 'map != NULL', 'node != NULL'
+ *
+ * Postconditions:
+ * - 'node->height' is set
+ *
+ * Side Effects:
+ * - May modify 'map->failed'
+ */
+void updateMapNodeHeight(ActivityMap map, MapNode* node) {
+	int32_t leftHeight = getMapNodeHeight(map, node->left);
+	int32_t rightHeight = getMapNodeHeight(map, node->right);
+	node->height = 1 + ((leftHeight > rightHeight) ? leftHeight : rightHeight);
+}
+
+/*
+ * rotateMapNodeRight
+ *
+ * Syntactic Specification:
+ * uint64_t rotateMapNodeRight(ActivityMap map, MapNode node);
+ *
+ * Semantic Specification:
+ * Right rotation of a new node (not yet in the mapping) with a left child: the node and a copy of its
+ * left child are appended, the left child becoming the root of the subtree. The old left child is no
+ * longer reachable.
+ *
+ * Preconditions:
+ * - 'map != NULL', 'node.left != 0'
+ *
+ * Postconditions:
+ * - Returns the offset of the new root of the subtree, 0 on error ('map->failed' is set)
+ *
+ * Side Effects:
+ * - Writing to the mapping, may extend the file
+ */
+uint64_t rotateMapNodeRight(ActivityMap map, MapNode node) {
+	MapNode* leftNode = getMapNode(map, node.left);
+	if (leftNode == NULL) return 0;
+
+	MapNode left = *leftNode;
+	map->deadBytes += sizeof(MapNode);
+	node.left = left.right;
+	updateMapNodeHeight(map, &node);
+	left.right = storeMapNode(map, &node);
+	if (left.right == 0) return 0;
+
+	updateMapNodeHeight(map, &left);
+	return storeMapNode(map, &left);
+}
+
+/*
+ * rotateMapNodeLeft
+ *
+ * Syntactic Specification:
+ * uint64_t rotateMapNodeLeft(ActivityMap map, MapNode node);
+ *
+ * Semantic Specification:
+ * Left rotation of a new node with a right child, symmetric to 'rotateMapNodeRight()'.
+ *
+ * Preconditions:
+ * - 'map != NULL', 'node.right != 0'
+ *
+ * Postconditions:
+ * - Returns the offset of the new root of the subtree, 0 on error ('map->failed' is set)
+ *
+ * Side Effects:
+ * - Writing to the mapping, may extend the file
+ */
+uint64_t rotateMapNodeLeft(ActivityMap map, MapNode node) {
+	MapNode* rightNode = getMapNode(map, node.right);
+	if (rightNode == NULL) return 0;
+
+	MapNode right = *rightNode;
+	map->deadBytes += sizeof(MapNode);
+	node.right = right.left;
+	updateMapNodeHeight(map, &node);
+	right.left = storeMapNode(map, &node);
+	if (right.left == 0) return 0;
+
+	updateMapNodeHeight(map, &right);
+	return storeMapNode(map, &right);
+}
+
+/*
+ * balanceMapNode
+ *
+ * Syntactic Specification:
+ * uint64_t balanceMapNode(ActivityMap map, MapNode node);
+ *
+ * Semantic Specification:
+ * Appends a new node (a modified copy of a node, whose subtrees differ in height by 2 at most), with the
+ * rotations that balance it as in 'insertNode()'.
+ *
+ * Preconditions:
+ * - 'map != NULL', 'node' not in the mapping
+ *
+ * Postconditions:
+ * - Returns the offset of the root of the balanced subtree, 0 on error ('map->failed' is set)
+ *
+ * Side Effects:
+ * - Writing to the mapping, may extend the file
+ */
+uint64_t balanceMapNode(ActivityMap map, MapNode node) {
+	updateMapNodeHeight(map, &node);
+	int32_t balance = getMapNodeHeight(map, node.left) - getMapNodeHeight(map, node.right);
+
+	if (balance > 1) {
+		MapNode* leftNode = getMapNode(map, node.left);
+		if (leftNode == NULL) return 0;
+		if (getMapNodeHeight(map, leftNode->left) < getMapNodeHeight(map, leftNode->right)) {
+			MapNode left = *leftNode;
+			map->deadBytes += sizeof(MapNode);
+			node.left = rotateMapNodeLeft(map, left);
+			if (node.left == 0) return 0;
+		}
+		return rotateMapNodeRight(map, node);
+	}
+
+	if (balance < -1) {
+		MapNode* rightNode = getMapNode(map, node.right);
+		if (rightNode == NULL) return 0;
+		if (getMapNodeHeight(map, rightNode->right) < getMapNodeHeight(map, rightNode->left)) {
+			MapNode right = *rightNode;
+			map->deadBytes += sizeof(MapNode);
+			node.right = rotateMapNodeRight(map, right);
+			if (node.right == 0) return 0;
+		}
+		return rotateMapNodeLeft(map, node);
+	}
+
+	return storeMapNode(map, &node);
+}
+
+/*
+ * putMapNode
+ *
+ * Syntactic Specification:
+ * uint64_t putMapNode(ActivityMap map, uint64_t offset, Activity a, int depth);
+ *
+ * Semantic Specification:
+ * Inserts an activity in the subtree of a node, or replaces the node with the same id, copying the nodes
+ * of the path (the subtree in the file is not modified).
+ *
+ * Preconditions:
+ * - 'map != NULL', 'a != NULL', 'depth' the depth of the node (0 for the root)
+ *
+ * Postconditions:
+ * - Returns the offset of the root of the new subtree, 0 on error ('map->failed' is set)
+ *
+ * Side Effects:
+ * - Writing to the mapping, may extend the file
+ */
+uint64_t putMapNode(ActivityMap map, uint64_t offset, Activity a, int depth) {
+	if (depth >= ACTIVITY_MAP_MAX_HEIGHT) {
+		map->failed = 1;
+		return 0;
+	}
+
+	MapNode node;
+	if (offset == 0) {
+		if (fillMapNode(map, a, &node) != 0) return 0;
+		map->count++;
+		return storeMapNode(map, &node);
+	}
+
+	MapNode* oldNode = getMapNode(map, offset);
+	if (oldNode == NULL) return 0;
+	node = *oldNode;
+	map->deadBytes += sizeof(MapNode);
+
+	int id = getActivityId(a);
+	if (id < node.id) {
+		node.left = putMapNode(map, node.left, a, depth + 1);
+	} else if (id > node.id) {
+		node.right = putMapNode(map, node.right, a, depth + 1);
+	} else {
+		// same id: a new node with the new fields, in the same place of the tree
+		map->deadBytes += getMapNodeStringBytes(&node);
+		MapNode replacement;
+		if (fillMapNode(map, a, &replacement) != 0) return 0;
+		replacement.left = node.left;
+		replacement.right = node.right;
+		replacement.height = node.height;
+		return storeMapNode(map, &replacement);
+	}
+	if (map->failed) return 0;
+
+	return balanceMapNode(map, node);
+}
+
+/*
+ * removeMinMapNode
+ *
+ * Syntactic Specification:
+ * uint64_t removeMinMapNode(ActivityMap map, uint64_t offset, uint64_t* minOffset, int depth);
+ *
+ * Semantic Specification:
+ * Removes the node with the lowest id from the subtree of a node, copying the nodes of the path.
+ *
+ * Preconditions:
+ * - 'map != NULL', 'offset != 0', 'minOffset != NULL'
+ *
+ * Postconditions:
+ * - Returns the offset of the root of the new subtree (0 if empty); '*minOffset' is the offset of the
+ *   removed node, still in the mapping. On error 'map->failed' is set
+ *
+ * Side Effects:
+ * - Writing to the mapping, may extend the file
+ */
+uint64_t removeMinMapNode(ActivityMap map, uint64_t offset, uint64_t* minOffset, int depth) {
+	MapNode* oldNode = (depth < ACTIVITY_MAP_MAX_HEIGHT) ? getMapNode(map, offset) : NULL;
+	if (oldNode == NULL) {
+		map->failed = 1;
+		return 0;
+	}
+
+	MapNode node = *oldNode;
+	if (node.left == 0) {
+		*minOffset = offset;
+		return node.right;
+	}
+
+	map->deadBytes += sizeof(MapNode);
+	node.left = removeMinMapNode(map, node.left, minOffset, depth + 1);
+	if (map->failed) return 0;
+
+	return balanceMapNode(map, node);
+}
+
+/*
+ * removeMapNode
+ *
+ * Syntactic Specification:
+ * uint64_t removeMapNode(ActivityMap map, uint64_t offset, int activityId, int depth);
+ *
+ * Semantic Specification:
+ * Removes the node of an activity from the subtree of a node, copying the nodes of the path as
+ * 'deleteNode()' does (a node with two children is replaced by a copy of its successor).
+ *
+ * Preconditions:
+ * - 'map != NULL', the activity is in the subtree
+ *
+ * Postconditions:
+ * - Returns the offset of the root of the new subtree (0 if empty). On error 'map->failed' is set
+ *
+ * Side Effects:
+ * - Writing to the mapping, may extend the file
+ */
+uint64_t removeMapNode(ActivityMap map, uint64_t offset, int activityId, int depth) {
+	MapNode* oldNode = (depth < ACTIVITY_MAP_MAX_HEIGHT) ? getMapNode(map, offset) : NULL;
+	if (oldNode == NULL) {
+		map->failed = 1;
+		return 0;
+	}
+
+	MapNode node = *oldNode;
+	map->deadBytes += sizeof(MapNode);
+	if (activityId < node.id) {
+		node.left = removeMapNode(map, node.left, activityId, depth + 1);
+	} else if (activityId > node.id) {
+		node.right = removeMapNode(map, node.right, activityId, depth + 1);
+	} else {
+		map->deadBytes += getMapNodeStringBytes(&node);
+		map->count--;
+		if (node.left == 0) return node.right;
+		if (node.right == 0) return node.left;
+
+		uint64_t minOffset = 0;
+		uint64_t right = removeMinMapNode(map, node.right, &minOffset, depth + 1);
+		MapNode* minNode = map->failed ? NULL : getMapNode(map, minOffset);
+		if (minNode == NULL) return 0;
+
+		MapNode successor = *minNode;
+		map->deadBytes += sizeof(MapNode);
+		successor.left = node.left;
+		successor.right = right;
+		return balanceMapNode(map, successor);
+	}
+	if (map->failed) return 0;
+
+	return balanceMapNode(map, node);
+}
+
+/*
+ * pushMapCursorPath
+ *
+ * Syntactic Specification:
+ * void pushMapCursorPath(ActivityMap map, MapCursor* cursor, uint64_t offset);
+ *
+ * Semantic Specification:
+ * Pushes a node and its left descendants on the stack of the cursor.
+ *
+ * Preconditions:
+ * - 'map != NULL', 'cursor != NULL'
+ *
+ * Postconditions:
+ * - The nodes are on the stack; 'map->failed' is set if a node is not valid or the tree is too high
+ *
+ * Side Effects:
+ * - Modifies the cursor
+ */
+void pushMapCursorPath(ActivityMap map, MapCursor* cursor, uint64_t offset) {
+	while (offset != 0) {
+		MapNode* node = (cursor->depth < ACTIVITY_MAP_MAX_HEIGHT) ? getMapNode(map, offset) : NULL;
+		if (node == NULL) {
+			map->failed = 1;
+			return;
+		}
+		cursor->stack[cursor->depth++] = offset;
+		offset = node->left;
+	}
+}
+
+/*
+ * nextMapCursor
+ *
+ * Syntactic Specification:
+ * uint64_t nextMapCursor(ActivityMap map, MapCursor* cursor);
+ *
+ * Semantic Specification:
+ * Returns the next node of the in-order visit and moves the cursor after it.
+ *
+ * Preconditions:
+ * - 'map != NULL', 'cursor' started with 'pushMapCursorPath()' on the root
+ *
+ * Postconditions:
+ * - Returns the offset of the node, 0 at the end of the visit or if a node is not valid ('map->failed' is set)
+ *
+ * Side Effects:
+ * - Modifies the cursor
+ */
+uint64_t nextMapCursor(ActivityMap map, MapCursor* cursor) {
+	if (cursor->depth == 0 || map->failed) return 0;
+
+	uint64_t offset = cursor->stack[--cursor->depth];
+	MapNode* node = getMapNode(map, offset);
+	if (node == NULL) return 0;
+
+	pushMapCursorPath(map, cursor, node->right);
+	return map->failed ? 0 : offset;
+}
+
+/*
+ * fillMapHeader
+ *
+ * Syntactic Specification:
+ * void fillMapHeader(MapHeader* header, uint64_t used, uint64_t root, uint64_t count, uint64_t deadBytes);
+ *
+ * Semantic Specification:
+ * Fills the header of a mapped store.
+ *
+ * Preconditions:
+ * - 'header != NULL'
+ *
+ * Postconditions:
+ * - The header is filled
+ *
+ * Side Effects:
+ * - None
+ */
+void fillMapHeader(MapHeader* header, uint64_t used, uint64_t root, uint64_t count, uint64_t deadBytes) {
+	memset(header, 0, sizeof(MapHeader));
+	memcpy(header->magic, ACTIVITY_MAP_MAGIC, sizeof(ACTIVITY_MAP_MAGIC));
+	header->version = ACTIVITY_MAP_VERSION;
+	header->byteOrderMark = ACTIVITY_MAP_BYTE_ORDER_MARK;
+	header->nodeSize = sizeof(MapNode);
+	header->used = used;
+	header->root = root;
+	header->count = count;
+	header->deadBytes = deadBytes;
+}
+
+/*
+ * writeMapSubtree
+ *
+ * Syntactic Specification:
+ * uint64_t writeMapSubtree(ActivityWriter writer, Activity* activities, int first, int last, uint64_t* position, int32_t* height);
+ *
+ * Semantic Specification:
+ * Writes the balanced subtree of the activities from 'first' to 'last': the subtree of the left half,
+ * the one of the right half, the strings of the middle activity and its node. With a NULL writer nothing
+ * is written and only the offsets are computed (the same of the writing).
+ *
+ * Preconditions:
+ * - 'activities' sorted by id, 'position' the offset of the next byte, 'height != NULL'
+ *
+ * Postconditions:
+ * - Returns the offset of the root of the subtree (0 if empty): '*position' follows the subtree,
+ *   '*height' is its height
+ *
+ * Side Effects:
+ * - May write to file
+ */
+uint64_t writeMapSubtree(ActivityWriter writer, Activity* activities, int first, int last, uint64_t* position, int32_t* height) {
+	if (first > last) {
+		*height = 0;
+		return 0;
+	}
+
+	int middle = first + (last - first) / 2;
+	int32_t leftHeight = 0;
+	int32_t rightHeight = 0;
+	MapNode node;
+	memset(&node, 0, sizeof(node));
+	node.left = writeMapSubtree(writer, activities, first, middle - 1, position, &leftHeight);
+	node.right = writeMapSubtree(writer, activities, middle + 1, last, position, &rightHeight);
+
+	Activity a = activities[middle];
+	const char* strings[ACTIVITY_MAP_STRING_FIELDS] = { getActivityName(a), getActivityDescr(a), getActivityCourse(a) };
+	if (!isActivityDescrLoaded(a)) failActivityWriter(writer);
+	for (int field = 0; field < ACTIVITY_MAP_STRING_FIELDS; field++) {
+		node.lengths[field] = ACTIVITY_MAP_NULL_STRING;
+		if (strings[field] == NULL) continue;
+
+		size_t length = strlen(strings[field]);
+		node.strings[field] = *position;
+		node.lengths[field] = (uint32_t)length;
+		writeBytesToActivityWriter(writer, strings[field], length + 1);
+		*position += length + 1;
+	}
+
+	static const char padding[ACTIVITY_MAP_NODE_ALIGNMENT] = { 0 };
+	size_t paddingSize = (size_t)((ACTIVITY_MAP_NODE_ALIGNMENT - *position % ACTIVITY_MAP_NODE_ALIGNMENT) % ACTIVITY_MAP_NODE_ALIGNMENT);
+	writeBytesToActivityWriter(writer, padding, paddingSize);
+	*position += paddingSize;
+
+	node.insertDate = (int64_t)getActivityInsertDate(a);
+	node.expiryDate = (int64_t)getActivityExpiryDate(a);
+	node.completionDate = (int64_t)getActivityCompletionDate(a);
+	node.id = getActivityId(a);
+	node.height = 1 + ((leftHeight > rightHeight) ? leftHeight : rightHeight);
+	node.totalTime = getActivityTotalTime(a);
+	node.usedTime = getActivityUsedTime(a);
+	node.priority = getActivityPriority(a);
+
+	uint64_t offset = *position;
+	writeBytesToActivityWriter(writer, &node, sizeof(node));
+	*position += sizeof(node);
+	*height = node.height;
+	return offset;
+}
+
+
+
+/*
+ * writeActivityMap
+ *
+ * Syntactic Specification:
+ * ActivityMap writeActivityMap(const char* filename, Activity* activities, int count);
+ *
+ * Semantic Specification:
+ * Writes the activities to a file in the mapped store format, used in place through a memory mapping
+ * instead of being parsed (see 'openActivityMap()'):
+ * - a header of 64 bytes: magic (8 bytes), version, byte order mark (0x01020304), size of a node and a
+ *   reserved field (32 bit); bytes in use, offset of the root node, number of activities, bytes no longer
+ *   reachable and a reserved field (64 bit)
+ * - the nodes of an AVL tree by id, one per activity (96 bytes, aligned to 8 bytes): offsets of the left
+ *   and right nodes, dates, offsets and lengths of name, description and course, id, height, times and priority
+ * - the strings, each ending with '\0'
+ * Every reference is an offset from the beginning of the file (0: none), never a pointer, so the file
+ * can be mapped anywhere. The tree is written balanced, every node after its strings and its subtrees.
+ * The numbers are in the byte order of the machine, as in a binary snapshot. The file is written through
+ * an ActivityWriter (replaced only when complete, with its checksum file), then mapped; every activity is clean.
+ *
+ * Preconditions:
+ * - 'filename != NULL', 'activities' has 'count' activities sorted by id
+ *
+ * Postconditions:
+ * - Returns the mapped store of the new file
+ * - Returns NULL if the file can't be written or mapped, or memory allocation fails: the file keeps its
+ *   previous content (if it couldn't be written) and the activities their dirty bit
+ *
+ * Side Effects:
+ * - Writing to file, memory mapping of the file
+ * - Allocates memory
+ * - Modifies the dirty bit of the activities
+ */
+ActivityMap writeActivityMap(const char* filename, Activity* activities, int count) {
+	if (filename == NULL || (activities == NULL && count > 0)) return NULL;
+
+	// the offsets first, for the header
+	uint64_t used = sizeof(MapHeader);
+	int32_t height = 0;
+	uint64_t root = writeMapSubtree(NULL, activities, 0, count - 1, &used, &height);
+
+	ActivityWriter writer = newActivityWriter(filename);
+	if (writer == NULL) return NULL;
+	enableActivityWriterChecksums(writer);
+
+	MapHeader header;
+	fillMapHeader(&header, used, root, (uint64_t)count, 0);
+	writeBytesToActivityWriter(writer, &header, sizeof(header));
+	uint64_t position = sizeof(MapHeader);
+	writeMapSubtree(writer, activities, 0, count - 1, &position, &height);
+	if (position != used || commitActivityWriter(&writer) != 0) {
+		if (writer != NULL) discardActivityWriter(&writer);
+		return NULL;
+	}
+
+	ActivityMap map = openActivityMap(filename);
+	if (map == NULL) return NULL;
+
+	for (int i = 0; i < count; i++) markActivityClean(activities[i]);
+	return map;
+}
+
+/*
+ * openActivityMap
+ *
+ * Syntactic Specification:
+ * ActivityMap openActivityMap(const char* filename);
+ *
+ * Semantic Specification:
+ * Opens a mapped store (see 'writeActivityMap()'): the file is mapped in memory and only its header is
+ * checked, so the cost doesn't depend on the number of activities (no parsing, no tree to build). The
+ * nodes and strings are checked when they are reached. A file that can't be written is mapped read-only
+ * (it can be read, not updated).
+ *
+ * Preconditions:
+ * - 'filename != NULL'
+ *
+ * Postconditions:
+ * - Returns the mapped store, NULL if the file can't be opened or mapped, its header is not valid (of this
+ *   version and byte order) or memory allocation fails
+ *
+ * Side Effects:
+ * - Opening and memory mapping of the file
+ * - Allocates memory
+ */
+ActivityMap openActivityMap(const char* filename) {
+	if (filename == NULL) return NULL;
+
+	ActivityMap map = calloc(1, sizeof(struct activityMap));
+	if (map == NULL) return NULL;
+
+	size_t filenameSize = strlen(filename) + 1;
+	map->filename = malloc(filenameSize);
+	map->fd = open(filename, O_RDWR);
+	if (map->fd < 0) {
+		map->fd = open(filename, O_RDONLY);
+		map->readOnly = 1;
+	}
+
+	struct stat fileInfo;
+	if (map->filename == NULL || map->fd < 0 || fstat(map->fd, &fileInfo) != 0 ||
+		 (uint64_t)fileInfo.st_size < sizeof(MapHeader) || (uint64_t)fileInfo.st_size > SIZE_MAX) {
+		deleteActivityMap(&map);
+		return NULL;
+	}
+	memcpy(map->filename, filename, filenameSize);
+
+	void* base = mmap(NULL, (size_t)fileInfo.st_size, PROT_READ | (map->readOnly ? 0 : PROT_WRITE), MAP_SHARED, map->fd, 0);
+	if (base == MAP_FAILED) {
+		deleteActivityMap(&map);
+		return NULL;
+	}
+	map->base = base;
+	map->mappedSize = (size_t)fileInfo.st_size;
+
+	MapHeader* header = (MapHeader*)map->base;
+	if (memcmp(header->magic, ACTIVITY_MAP_MAGIC, sizeof(ACTIVITY_MAP_MAGIC)) != 0 || header->version != ACTIVITY_MAP_VERSION ||
+		 header->byteOrderMark != ACTIVITY_MAP_BYTE_ORDER_MARK || header->nodeSize != sizeof(MapNode) ||
+		 header->used < sizeof(MapHeader) || header->used > map->mappedSize || header->deadBytes > header->used ||
+		 header->count > header->used / sizeof(MapNode) || header->count > INT_MAX || (header->root == 0) != (header->count == 0)) {
+		deleteActivityMap(&map);
+		return NULL;
+	}
+
+	map->used = header->used;
+	map->count = header->count;
+	map->deadBytes = header->deadBytes;
+	if (header->root != 0 && getMapNode(map, header->root) == NULL) {
+		deleteActivityMap(&map);
+		return NULL;
+	}
+
+	map->device = fileInfo.st_dev;
+	map->inode = fileInfo.st_ino;
+	map->size = fileInfo.st_size;
+	map->modified = fileInfo.st_mtim;
+	return map;
+}
+
+/*
+ * updateActivityMap
+ *
+ * Syntactic Specification:
+ * int updateActivityMap(ActivityMap map, Activity* activities, int count, int* writtenCount);
+ *
+ * Semantic Specification:
+ * Saves the activities to the mapped store writing only what has changed since the last save: the tree
+ * of the file is visited in order together with the activities, the dirty and new activities are inserted
+ * and the ones no longer present are removed. The nodes are never modified in place: every node on the
+ * path of an insertion or removal is copied, with its rotations, after the bytes in use (growing the file
+ * when needed), so the tree of the header stays whole. The new bytes are synchronized ('msync()'), then the
+ * header points to the new root and is synchronized too: a crash leaves either the previous tree or the
+ * new one. The bytes no longer reachable are counted; the checksum file is updated only for the blocks
+ * written (see 'refreshActivityChecksums()'), or removed if it can't be.
+ *
+ * Preconditions:
+ * - 'map' returned by 'writeActivityMap()' or 'openActivityMap()', 'writtenCount != NULL'
+ * - 'activities' has 'count' activities sorted by id, all the activities of the container
+ *
+ * Postconditions:
+ * - Returns 0 if the file has been updated: '*writtenCount' is the number of activities inserted or
+ *   removed, every activity is clean
+ * - Returns 1 if the file must be written again with 'writeActivityMap()': it's read-only, it has been
+ *   changed or replaced since the last save, more than half of its bytes are no longer reachable, it's
+ *   not valid or a write failed (the header still points to the previous tree)
+ *
+ * Side Effects:
+ * - Writing to file (through the mapping), growth and synchronization of the file
+ * - Modifies the dirty bit of the activities
+ */
+int updateActivityMap(ActivityMap map, Activity* activities, int count, int* writtenCount) {
+	*writtenCount = 0;
+	if (map == NULL || map->readOnly || (activities == NULL && count > 0)) return 1;
+
+	struct stat fileInfo;
+	if (fstat(map->fd, &fileInfo) != 0 || fileInfo.st_dev != map->device || fileInfo.st_ino != map->inode ||
+		 fileInfo.st_size != map->size || fileInfo.st_mtim.tv_sec != map->modified.tv_sec ||
+		 fileInfo.st_mtim.tv_nsec != map->modified.tv_nsec) {
+		return 1;
+	}
+
+	// a file with mostly unreachable bytes is compacted by writing it again
+	MapHeader* header = (MapHeader*)map->base;
+	if (header->deadBytes > header->used / 2) return 1;
+
+	uint64_t committedUsed = header->used;
+	uint64_t root = header->root;
+	map->used = committedUsed;
+	map->count = header->count;
+	map->deadBytes = header->deadBytes;
+	map->failed = 0;
+
+	// the tree of the header is never modified, so it's visited while the new one is built
+	MapCursor cursor;
+	cursor.depth = 0;
+	pushMapCursorPath(map, &cursor, root);
+	uint64_t mapOffset = nextMapCursor(map, &cursor);
+	int written = 0;
+	int i = 0;
+	while (!map->failed && (i < count || mapOffset != 0)) {
+		MapNode* node = (mapOffset != 0) ? getMapNode(map, mapOffset) : NULL;
+		if (map->failed) break;
+
+		if (node != NULL && (i == count || node->id < getActivityId(activities[i]))) {
+			root = removeMapNode(map, root, node->id, 0);
+			mapOffset = nextMapCursor(map, &cursor);
+			written++;
+		} else if (node != NULL && node->id == getActivityId(activities[i])) {
+			if (isActivityDirty(activities[i])) {
+				root = putMapNode(map, root, activities[i], 0);
+				written++;
+			}
+			mapOffset = nextMapCursor(map, &cursor);
+			i++;
+		} else {
+			root = putMapNode(map, root, activities[i], 0);
+			written++;
+			i++;
+		}
+	}
+
+	long pageSize = sysconf(_SC_PAGESIZE);
+	uint64_t syncStart = (pageSize > 0) ? committedUsed / (uint64_t)pageSize * (uint64_t)pageSize : 0;
+	int failed = map->failed;
+	if (!failed && written > 0) {
+		// the new nodes and strings, then the header that makes them the tree
+		if (map->used > syncStart && msync(map->base + syncStart, (size_t)(map->used - syncStart), MS_SYNC) != 0) failed = 1;
+		if (!failed) {
+			header = (MapHeader*)map->base;
+			fillMapHeader(header, map->used, root, map->count, map->deadBytes);
+			if (msync(map->base, sizeof(MapHeader), MS_SYNC) != 0) failed = 1;
+		}
+	}
+
+	if (!failed && written > 0) {
+		uint64_t firstBlock = committedUsed / ACTIVITY_CHECKSUM_BLOCK_SIZE;
+		uint64_t lastBlock = (map->used - 1) / ACTIVITY_CHECKSUM_BLOCK_SIZE;
+		size_t blockCount = (size_t)(lastBlock - firstBlock + 2);
+		uint64_t* blocks = malloc(blockCount * sizeof(uint64_t));
+		if (blocks != NULL) {
+			blocks[0] = 0; // the header
+			for (size_t b = 1; b < blockCount; b++) blocks[b] = firstBlock + b - 1;
+		}
+		if (blocks == NULL || refreshActivityChecksums(map->filename, map->fd, blocks, blockCount) != 0) {
+			removeActivityChecksums(map->filename);
+		}
+		free(blocks);
+	} else if (failed) {
+		removeActivityChecksums(map->filename);
+	}
+
+	if (failed || fstat(map->fd, &fileInfo) != 0) {
+		// the header still has the previous tree
+		header = (MapHeader*)map->base;
+		map->used = header->used;
+		map->count = header->count;
+		map->deadBytes = header->deadBytes;
+		map->failed = 0;
+		return 1;
+	}
+
+	map->size = fileInfo.st_size;
+	map->modified = fileInfo.st_mtim;
+	for (int a = 0; a < count; a++) markActivityClean(activities[a]);
+	*writtenCount = written;
+	return 0;
+}
+
+/*
+ * readActivityMap
+ *
+ * Syntactic Specification:
+ * int readActivityMap(ActivityMap map, Activity** activities, int* count);
+ *
+ * Semantic Specification:
+ * Creates the activities of the mapped store, visiting its tree in order. Every activity is clean.
+ *
+ * Preconditions:
+ * - 'map != NULL', 'activities != NULL', 'count != NULL'
+ *
+ * Postconditions:
+ * - Returns 0 on success: '*activities' is a new array with the '*count' activities sorted by id (the
+ *   caller deallocates the array and owns the activities)
+ * - Returns 1 if the tree is not valid or memory allocation fails: '*activities' is NULL and '*count' is 0
+ *
+ * Side Effects:
+ * - Allocates memory
+ */
+int readActivityMap(ActivityMap map, Activity** activities, int* count) {
+	*activities = NULL;
+	*count = 0;
+	if (map == NULL) return 1;
+
+	MapHeader* header = (MapHeader*)map->base;
+	int expectedCount = (int)header->count;
+	Activity* result = malloc((expectedCount > 0 ? expectedCount : 1) * sizeof(Activity));
+	if (result == NULL) return 1;
+
+	map->failed = 0;
+	MapCursor cursor;
+	cursor.depth = 0;
+	pushMapCursorPath(map, &cursor, header->root);
+	int resultCount = 0;
+	int error = 0;
+	uint64_t offset = 0;
+	while ((offset = nextMapCursor(map, &cursor)) != 0) {
+		Activity a = (resultCount < expectedCount) ? newActivityFromMapNode(map, offset) : NULL;
+		// the ids must increase, as in a search tree
+		if (a == NULL || (resultCount > 0 && getActivityId(result[resultCount - 1]) >= getActivityId(a))) {
+			if (a != NULL) deleteActivity(a);
+			error = 1;
+			break;
+		}
+		result[resultCount++] = a;
+	}
+
+	if (error || map->failed || resultCount != expectedCount) {
+		for (int i = 0; i < resultCount; i++) deleteActivity(result[i]);
+		free(result);
+		map->failed = 0;
+		return 1;
+	}
+
+	*activities = result;
+	*count = resultCount;
+	return 0;
+}
+
+/*
+ * visitActivityMap
+ *
+ * Syntactic Specification:
+ * int visitActivityMap(ActivityMap map, void (*visit)(Activity a, void* context), void* context);
+ *
+ * Semantic Specification:
+ * Calls 'visit' on every activity of the mapped store, in id order, without creating them all: each one
+ * is created from its node, visited and deallocated, so the memory used doesn't grow with the activities.
+ *
+ * Preconditions:
+ * - 'map != NULL', 'visit != NULL' (it must not keep the activity)
+ *
+ * Postconditions:
+ * - Returns 0 if every activity has been visited, 1 if the tree is not valid or memory allocation fails
+ *   (the activities before have been visited)
+ *
+ * Side Effects:
+ * - The ones of 'visit'
+ */
+int visitActivityMap(ActivityMap map, void (*visit)(Activity a, void* context), void* context) {
+	if (map == NULL || visit == NULL) return 1;
+
+	map->failed = 0;
+	MapCursor cursor;
+	cursor.depth = 0;
+	pushMapCursorPath(map, &cursor, ((MapHeader*)map->base)->root);
+	uint64_t offset = 0;
+	while ((offset = nextMapCursor(map, &cursor)) != 0) {
+		Activity a = newActivityFromMapNode(map, offset);
+		if (a == NULL) {
+			map->failed = 1;
+			break;
+		}
+		visit(a, context);
+		deleteActivity(a);
+	}
+
+	int result = map->failed ? 1 : 0;
+	map->failed = 0;
+	return result;
+}
+
+/*
+ * getActivityFromMap
+ *
+ * Syntactic Specification:
+ * Activity getActivityFromMap(ActivityMap map, int activityId);
+ *
+ * Semantic Specification:
+ * Searches an activity in the tree of the mapped store (O(log n) nodes read) and creates it.
+ *
+ * Preconditions:
+ * - None
+ *
+ * Postconditions:
+ * - Returns a new activity (the caller owns it), NULL if it's not found, 'map' is NULL, the tree is not
+ *   valid or memory allocation fails
+ *
+ * Side Effects:
+ * - Allocates memory
+ */
+Activity getActivityFromMap(ActivityMap map, int activityId) {
+	if (map == NULL) return NULL;
+
+	map->failed = 0;
+	uint64_t offset = ((MapHeader*)map->base)->root;
+	for (int depth = 0; offset != 0 && depth < ACTIVITY_MAP_MAX_HEIGHT; depth++) {
+		MapNode* node = getMapNode(map, offset);
+		if (node == NULL) break;
+
+		if (activityId == node->id) {
+			Activity a = newActivityFromMapNode(map, offset);
+			map->failed = 0;
+			return a;
+		}
+		offset = (activityId < node->id) ? node->left : node->right;
+	}
+
+	map->failed = 0;
+	return NULL;
+}
+
+/*
+ * getActivityMapCount
+ *
+ * Syntactic Specification:
+ * int getActivityMapCount(ActivityMap map);
+ *
+ * Semantic Specification:
+ * Returns the number of activities of the mapped store, from its header.
+ *
+ * Preconditions:
+ * - None
+ *
+ * Postconditions:
+ * - Returns the number of activities, 0 if 'map == NULL'
+ *
+ * Side Effects:
+ * - None
+ */
+int getActivityMapCount(ActivityMap map) {
+	if (map == NULL) return 0;
+
+	return (int)((MapHeader*)map->base)->count;
+}
+
+/*
+ * getActivityMapMaxId
+ *
+ * Syntactic Specification:
+ * int getActivityMapMaxId(ActivityMap map);
+ *
+ * Semantic Specification:
+ * Returns the highest id of the activities of the mapped store, following the right children from the
+ * root (O(log n) nodes read, no activity created).
+ *
+ * Preconditions:
+ * - None
+ *
+ * Postconditions:
+ * - Returns the highest id, 0 if 'map' is NULL, the store is empty or the tree is not valid
+ *
+ * Side Effects:
+ * - None
+ */
+int getActivityMapMaxId(ActivityMap map) {
+	if (map == NULL) return 0;
+
+	map->failed = 0;
+	int maxId = 0;
+	uint64_t offset = ((MapHeader*)map->base)->root;
+	for (int depth = 0; offset != 0 && depth < ACTIVITY_MAP_MAX_HEIGHT; depth++) {
+		MapNode* node = getMapNode(map, offset);
+		if (node == NULL) {
+			maxId = 0;
+			break;
+		}
+		maxId = node->id;
+		offset = node->right;
+	}
+
+	map->failed = 0;
+	return maxId;
+}
+
+/*
+ * getActivityMapFilename
+ *
+ * Syntactic Specification:
+ * const char* getActivityMapFilename(ActivityMap map);
+ *
+ * Semantic Specification:
+ * Returns the name of the file of the mapped store.
+ *
+ * Preconditions:
+ * - None
+ *
+ * Postconditions:
+ * - Returns the file name, NULL if 'map == NULL'
+ *
+ * Side Effects:
+ * - None
+ */
+const char* getActivityMapFilename(ActivityMap map) {
+	if (map == NULL) return NULL;
+
+	return map->filename;
+}
+
+/*
+ * deleteActivityMap
+ *
+ * Syntactic Specification:
+ * void deleteActivityMap(ActivityMap* map);
+ *
+ * Semantic Specification:
+ * Removes the memory mapping, closes the file and deallocates the mapped store (the file is not modified).
+ * The parameter is a pointer passed by reference.
+ *
+ * Preconditions:
+ * - 'map' can be NULL or point to a valid/NULL pointer
+ *
+ * Postconditions:
+ * - '*map' is set to NULL
+ *
+ * Side Effects:
+ * - Removal of the mapping, closing of the file
+ * - Deallocates memory
+ */
+void deleteActivityMap(ActivityMap* map) {
+	if (map == NULL || *map == NULL) return;
+
+	if ((*map)->base != NULL) munmap((*map)->base, (*map)->mappedSize);
+	if ((*map)->fd >= 0) close((*map)->fd);
+	free((*map)->filename);
+	free(*map);
+	*map = NULL;
+}
@@ -0,0 +1,263 @@
+#ifndef ACTIVITIES_CONTAINER_MAPPED_H             // Start of inclusion block
+#define ACTIVITIES_CONTAINER_MAPPED_H             // Macro definition to avoid multiple inclusions
+
+#include "activity.h"
+
+// First bytes of a mapped store
+#define ACTIVITY_MAP_MAGIC "PSDMAP"
+// Version of the mapped store format written by 'writeActivityMap()'
+#define ACTIVITY_MAP_VERSION 1
+// Upper bound of the height of the tree of a mapped store (a valid AVL tree of 2^31 nodes is lower)
+#define ACTIVITY_MAP_MAX_HEIGHT 64
+// Minimum number of bytes a mapped store grows by when an update doesn't fit in it
+// (it can be changed at build time, e.g. -DACTIVITY_MAP_MIN_GROWTH=1048576)
+#ifndef ACTIVITY_MAP_MIN_GROWTH
+#define ACTIVITY_MAP_MIN_GROWTH (1 << 16)
+#endif
+
+// Declare an opaque type for a mapped store: a file of activities used in place through a memory mapping
+typedef struct activityMap* ActivityMap;
+
+
+/*
+ * writeActivityMap
+ *
+ * Syntactic Specification:
+ * ActivityMap writeActivityMap(const char* filename, Activity* activities, int count);
+ *
+ * Semantic Specification:
+ * Writes the activities to a file in the mapped store format, used in place through a memory mapping
+ * instead of being parsed (see 'openActivityMap()'):
+ * - a header of 64 bytes: magic (8 bytes), version, byte order mark (0x01020304), size of a node and a
+ *   reserved field (32 bit); bytes in use, offset of the root node, number of activities, bytes no longer
+ *   reachable and a reserved field (64 bit)
+ * - the nodes of an AVL tree by id, one per activity (96 bytes, aligned to 8 bytes): offsets of the left
+ *   and right nodes, dates, offsets and lengths of name, description and course, id, height, times and priority
+ * - the strings, each ending with '\0'
+ * Every reference is an offset from the beginning of the file (0: none), never a pointer, so the file
+ * can be mapped anywhere. The tree is written balanced, every node after its strings and its subtrees.
+ * The numbers are in the byte order of the machine, as in a binary snapshot. The file is written through
+ * an ActivityWriter (replaced only when complete, with its checksum file), then mapped; every activity is clean.
+ *
+ * Preconditions:
+ * - 'filename != NULL', 'activities' has 'count' activities sorted by id
+ *
+ * Postconditions:
+ * - Returns the mapped store of the new file
+ * - Returns NULL if the file can't be written or mapped, or memory allocation fails: the file keeps its
+ *   previous content (if it couldn't be written) and the activities their dirty bit
+ *
+ * Side Effects:
+ * - Writing to file, memory mapping of the file
+ * - Allocates memory
+ * - Modifies the dirty bit of the activities
+ */
+ActivityMap writeActivityMap(const char* filename, Activity* activities, int count);
+
+/*
+ * openActivityMap
+ *
+ * Syntactic Specification:
+ * ActivityMap openActivityMap(const char* filename);
+ *
+ * Semantic Specification:
+ * Opens a mapped store (see 'writeActivityMap()'): the file is mapped in memory and only its header is
+ * checked, so the cost doesn't depend on the number of activities (no parsing, no tree to build). The
+ * nodes and strings are checked when they are reached. A file that can't be written is mapped read-only
+ * (it can be read, not updated).
+ *
+ * Preconditions:
+ * - 'filename != NULL'
+ *
+ * Postconditions:
+ * - Returns the mapped store, NULL if the file can't be opened or mapped, its header is not valid (of this
+ *   version and byte order) or memory allocation fails
+ *
+ * Side Effects:
+ * - Opening and memory mapping of the file
+ * - Allocates memory
+ */
+ActivityMap openActivityMap(const char* filename);
+
+/*
+ * updateActivityMap
+ *
+ * Syntactic Specification:
+ * int updateActivityMap(ActivityMap map, Activity* activities, int count, int* writtenCount);
+ *
+ * Semantic Specification:
+ * Saves the activities to the mapped store writing only what has changed since the last save: the tree
+ * of the file is visited in order together with the activities, the dirty and new activities are inserted
+ * and the ones no longer present are removed. The nodes are never modified in place: every node on the
+ * path of an insertion or removal is copied, with its rotations, after the bytes in use (growing the file
+ * when needed), so the tree of the header stays whole. The new bytes are synchronized ('msync()'), then the
+ * header points to the new root and is synchronized too: a crash leaves either the previous tree or the
+ * new one. The bytes no longer reachable are counted; the checksum file is updated only for the blocks
+ * written (see 'refreshActivityChecksums()'), or removed if it can't be.
+ *
+ * Preconditions:
+ * - 'map' returned by 'writeActivityMap()' or 'openActivityMap()', 'writtenCount != NULL'
+ * - 'activities' has 'count' activities sorted by id, all the activities of the container
+ *
+ * Postconditions:
+ * - Returns 0 if the file has been updated: '*writtenCount' is the number of activities inserted or
+ *   removed, every activity is clean
+ * - Returns 1 if the file must be written again with 'writeActivityMap()': it's read-only, it has been
+ *   changed or replaced since the last save, more than half of its bytes are no longer reachable, it's
+ *   not valid or a write failed (the header still points to the previous tree)
+ *
+ * Side Effects:
+ * - Writing to file (through the mapping), growth and synchronization of the file
+ * - Modifies the dirty bit of the activities
+ */
+int updateActivityMap(ActivityMap map, Activity* activities, int count, int* writtenCount);
+
+/*
+ * readActivityMap
+ *
+ * Syntactic Specification:
+ * int readActivityMap(ActivityMap map, Activity** activities, int* count);
+ *
+ * Semantic Specification:
+ * Creates the activities of the mapped store, visiting its tree in order. Every activity is clean.
+ *
+ * Preconditions:
+ * - 'map != NULL', 'activities != NULL', 'count != NULL'
+ *
+ * Postconditions:
+ * - Returns 0 on success: '*activities' is a new array with the '*count' activities sorted by id (the
+ *   caller deallocates the array and owns the activities)
+ * - Returns 1 if the tree is not valid or memory allocation fails: '*activities' is NULL and '*count' is 0
+ *
+ * Side Effects:
+ * - Allocates memory
+ */
+int readActivityMap(ActivityMap map, Activity** activities, int* count);
+
+/*
+ * visitActivityMap
+ *
+ * Syntactic Specification:
+ * int visitActivityMap(ActivityMap map, void (*visit)(Activity a, void* context), void* context);
+ *
+ * Semantic Specification:
+ * Calls 'visit' on every activity of the mapped store, in id order, without creating them all: each one
+ * is created from its node, visited and deallocated, so the memory used doesn't grow with the activities.
+ *
+ * Preconditions:
+ * - 'map != NULL', 'visit != NULL' (it must not keep the activity)
+ *
+ * Postconditions:
+ * - Returns 0 if every activity has been visited, 1 if the tree is not valid or memory allocation fails
+ *   (the activities before have been visited)
+ *
+ * Side Effects:
+ * - The ones of 'visit'
+ */
+int visitActivityMap(ActivityMap map, void (*visit)(Activity a, void* context), void* context);
+
+/*
+ * getActivityFromMap
+ *
+ * Syntactic Specification:
+ * Activity getActivityFromMap(ActivityMap map, int activityId);
+ *
+ * Semantic Specification:
+ * Searches an activity in the tree of the mapped store (O(log n) nodes read) and creates it.
+ *
+ * Preconditions:
+ * - None
+ *
+ * Postconditions:
+ * - Returns a new activity (the caller owns it), NULL if it's not found, 'map' is NULL, the tree is not
+ *   valid or memory allocation fails
+ *
+ * Side Effects:
+ * - Allocates memory
+ */
+Activity getActivityFromMap(ActivityMap map, int activityId);
+
+/*
+ * getActivityMapCount
+ *
+ * Syntactic Specification:
+ * int getActivityMapCount(ActivityMap map);
+ *
+ * Semantic Specification:
+ * Returns the number of activities of the mapped store, from its header.
+ *
+ * Preconditions:
+ * - None
+ *
+ * Postconditions:
+ * - Returns the number of activities, 0 if 'map == NULL'
+ *
+ * Side Effects:
+ * - None
+ */
+int getActivityMapCount(ActivityMap map);
+
+/*
+ * getActivityMapMaxId
+ *
+ * Syntactic Specification:
+ * int getActivityMapMaxId(ActivityMap map);
+ *
+ * Semantic Specification:
+ * Returns the highest id of the activities of the mapped store, following the right children from the
+ * root (O(log n) nodes read, no activity created).
+ *
+ * Preconditions:
+ * - None
+ *
+ * Postconditions:
+ * - Returns the highest id, 0 if 'map' is NULL, the store is empty or the tree is not valid
+ *
+ * Side Effects:
+ * - None
+ */
+int getActivityMapMaxId(ActivityMap map);
+
+/*
+ * getActivityMapFilename
+ *
+ * Syntactic Specification:
+ * const char* getActivityMapFilename(ActivityMap map);
+ *
+ * Semantic Specification:
+ * Returns the name of the file of the mapped store.
+ *
+ * Preconditions:
+ * - None
+ *
+ * Postconditions:
+ * - Returns the file name, NULL if 'map == NULL'
+ *
+ * Side Effects:
+ * - None
+ */
+const char* getActivityMapFilename(ActivityMap map);
+
+/*
+ * deleteActivityMap
+ *
+ * Syntactic Specification:
+ * void deleteActivityMap(ActivityMap* map);
+ *
+ * Semantic Specification:
+ * Removes the memory mapping, closes the file and deallocates the mapped store (the file is not modified).
+ * The parameter is a pointer passed by reference.
+ *
+ * Preconditions:
+ * - 'map' can be NULL or point to a valid/NULL pointer
+ *
+ * Postconditions:
+ * - '*map' is set to NULL
+ *
+ * Side Effects:
+ * - Removal of the mapping, closing of the file
+ * - Deallocates memory
+ */
+void deleteActivityMap(ActivityMap* map);
+
+#endif // ACTIVITIES_CONTAINER_MAPPED_H          // End of inclusion block
@@ -0,0 +1,212 @@
+#include <stdlib.h>
+#include <limits.h>
+#include "activities_container_render_cache.h"
+
+
+/*
+ * "struct renderCacheEntry" Documentation
+ *
+ * Syntactic Specification:
+ * typedef struct renderCacheEntry {
+ *     int isValid;
+ *     unsigned long version;
+ *     RenderValidity validity;
+ *     char* buffer;
+ *     size_t size;
+ * } RenderCacheEntry;
+ *
+ * Semantic Specification:
+ * A pre-formatted rendering (the exact bytes printed) with the key it was made for.
+ *
+ * Fields:
+ * - isValid: 1 if the entry contains a rendering, 0 otherwise
+ * - version: Modification counter of the container when the rendering was made
+ * - validity: Ranges of report dates for which the rendering can be reused
+ * - buffer: The rendered bytes (dynamically allocated, not null-terminated necessarily)
+ * - size: Number of bytes in 'buffer'
+ */
+typedef struct renderCacheEntry {
+	int isValid;
+	unsigned long version;
+	RenderValidity validity;
+	char* buffer;
+	size_t size;
+} RenderCacheEntry;
+
+
+/*
+ * "struct renderCache" Documentation
+ *
+ * Syntactic Specification:
+ * struct renderCache {
+ *     RenderCacheEntry entries[RENDER_KINDS];
+ * };
+ *
+ * Semantic Specification:
+ * Keeps the last rendering of each kind (list, progress, report).
+ *
+ * Notes:
+ * - Only the last rendering of a kind is kept: polling clients ask the same thing again and again
+ */
+struct renderCache {
+	RenderCacheEntry entries[RENDER_KINDS];
+};
+
+
+
+/*
+ * setRenderValidityToAlways
+ *
+ * Syntactic Specification:
+ * void setRenderValidityToAlways(RenderValidity* validity);
+ *
+ * Semantic Specification:
+ * Sets the validity ranges to the whole time_t range (rendering independent from dates).
+ *
+ * Preconditions:
+ * - 'validity != NULL'
+ *
+ * Postconditions:
+ * - Any 'beginDate' and 'nowDate' is inside the validity ranges
+ *
+ * Side Effects:
+ * - Modifies '*validity'
+ */
+void setRenderValidityToAlways(RenderValidity* validity) {
+	validity->beginFrom = LONG_MIN;
+	validity->beginTo = LONG_MAX;
+	validity->nowFrom = LONG_MIN;
+	validity->nowTo = LONG_MAX;
+}
+
+/*
+ * newRenderCache
+ *
+ * Syntactic Specification:
+ * RenderCache newRenderCache(void);
+ *
+ * Semantic Specification:
+ * Creates a new empty cache of pre-formatted renderings.
+ *
+ * Preconditions:
+ * - None
+ *
+ * Postconditions:
+ * - Returns a new cache with no valid entries
+ * - If allocation fails, returns 'NULL'
+ *
+ * Side Effects:
+ * - Allocates memory for the cache
+ */
+RenderCache newRenderCache(void) {
+	RenderCache cache = (struct renderCache*)malloc(sizeof(struct renderCache));
+	if (cache == NULL) return NULL;
+
+	for (int i=0; i<RENDER_KINDS; i++) {
+		cache->entries[i].isValid = 0;
+		cache->entries[i].version = 0;
+		setRenderValidityToAlways( &(cache->entries[i].validity) );
+		cache->entries[i].buffer = NULL;
+		cache->entries[i].size = 0;
+	}
+
+	return cache;
+}
+
+/*
+ * deleteRenderCache
+ *
+ * Syntactic Specification:
+ * void deleteRenderCache(RenderCache* cache);
+ *
+ * Semantic Specification:
+ * Deallocates the cache and all the renderings kept in it. The parameter is a pointer passed by reference.
+ *
+ * Preconditions:
+ * - 'cache' can be NULL or point to a valid/NULL pointer
+ *
+ * Postconditions:
+ * - All the memory of the cache is freed and '*cache' is set to NULL
+ *
+ * Side Effects:
+ * - Deallocates memory
+ */
+void deleteRenderCache(RenderCache* cache) {
+	if (cache == NULL || *cache == NULL) return;
+
+	for (int i=0; i<RENDER_KINDS; i++) {
+		free( (*cache)->entries[i].buffer );
+	}
+
+	free(*cache);
+	*cache = NULL;
+}
+
+/*
+ * printCachedRendering
+ *
+ * Syntactic Specification:
+ * int printCachedRendering(RenderCache cache, int kind, unsigned long version, time_t beginDate, time_t nowDate, FILE* file);
+ *
+ * Semantic Specification:
+ * Writes the cached rendering of the given kind, if it was made for the same container version and
+ * its validity ranges contain 'beginDate' and 'nowDate'.
+ *
+ * Preconditions:
+ * - 'kind' must be one of RENDER_KIND_*
+ * - 'file' must be opened for writing
+ *
+ * Postconditions:
+ * - Returns 1 if the cached bytes have been written to 'file' (cache hit)
+ * - Returns 0 otherwise (cache miss, nothing is written)
+ *
+ * Side Effects:
+ * - Writing to file
+ */
+int printCachedRendering(RenderCache cache, int kind, unsigned long version, time_t beginDate, time_t nowDate, FILE* file) {
+	if (cache == NULL || file == NULL || kind < 0 || kind >= RENDER_KINDS) return 0;
+
+	RenderCacheEntry* entry = &(cache->entries[kind]);
+	if (entry->isValid == 0 || entry->version != version) return 0;
+
+	if (beginDate < entry->validity.beginFrom || beginDate >= entry->validity.beginTo) return 0;
+	if (nowDate < entry->validity.nowFrom || nowDate > entry->validity.nowTo) return 0;
+
+	fwrite(entry->buffer, 1, entry->size, file);
+	return 1;
+}
+
+/*
+ * storeRendering
+ *
+ * Syntactic Specification:
+ * void storeRendering(RenderCache cache, int kind, unsigned long version, RenderValidity validity, char* buffer, size_t size);
+ *
+ * Semantic Specification:
+ * Keeps 'buffer' as the rendering of the given kind for the given container version, replacing the previous one.
+ *
+ * Preconditions:
+ * - 'buffer' must be dynamically allocated (the cache takes ownership of it)
+ *
+ * Postconditions:
+ * - The rendering is stored in the cache
+ * - If 'cache == NULL' or 'kind' is not valid, 'buffer' is freed
+ *
+ * Side Effects:
+ * - Deallocates the previous rendering of the same kind
+ */
+void storeRendering(RenderCache cache, int kind, unsigned long version, RenderValidity validity, char* buffer, size_t size) {
+	if (cache == NULL || kind < 0 || kind >= RENDER_KINDS) {
+		free(buffer);
+		return;
+	}
+
+	RenderCacheEntry* entry = &(cache->entries[kind]);
+	free(entry->buffer);
+
+	entry->isValid = (buffer != NULL) ? 1 : 0;
+	entry->version = version;
+	entry->validity = validity;
+	entry->buffer = buffer;
+	entry->size = size;
+}
@@ -0,0 +1,152 @@
+#ifndef ACTIVITIES_CONTAINER_RENDER_CACHE_H             // Start of inclusion block
+#define ACTIVITIES_CONTAINER_RENDER_CACHE_H             // Macro definition to avoid multiple inclusions
+
+#include <stdio.h>
+#include <time.h>
+
+/*
+ * Kinds of renderings kept in the cache (one entry for each kind).
+ */
+#define RENDER_KIND_LIST 0       // printActivities
+#define RENDER_KIND_PROGRESS 1   // printActivitiesProgress
+#define RENDER_KIND_REPORT 2     // printActivitiesReport
+#define RENDER_KINDS 3
+
+// Declare an opaque type for the renderings cache
+typedef struct renderCache* RenderCache;
+
+
+/*
+ * "struct renderValidity" Documentation
+ *
+ * Syntactic Specification:
+ * typedef struct renderValidity {
+ *     time_t beginFrom;
+ *     time_t beginTo;
+ *     time_t nowFrom;
+ *     time_t nowTo;
+ * } RenderValidity;
+ *
+ * Semantic Specification:
+ * Range of report dates for which a rendering stays the same (the "beginDate bucket").
+ * A rendering made with a given 'beginDate' and 'nowDate' can be reused for any other
+ * 'beginDate' in [beginFrom, beginTo) and 'nowDate' in [nowFrom, nowTo], because no
+ * activity changes its report category inside these ranges.
+ *
+ * Notes:
+ * - Renderings that don't depend on dates (list, progress) use the full time_t range
+ */
+typedef struct renderValidity {
+	time_t beginFrom;
+	time_t beginTo;
+	time_t nowFrom;
+	time_t nowTo;
+} RenderValidity;
+
+
+/*
+ * setRenderValidityToAlways
+ *
+ * Syntactic Specification:
+ * void setRenderValidityToAlways(RenderValidity* validity);
+ *
+ * Semantic Specification:
+ * Sets the validity ranges to the whole time_t range (rendering independent from dates).
+ *
+ * Preconditions:
+ * - 'validity != NULL'
+ *
+ * Postconditions:
+ * - Any 'beginDate' and 'nowDate' is inside the validity ranges
+ *
+ * Side Effects:
+ * - Modifies '*validity'
+ */
+void setRenderValidityToAlways(RenderValidity* validity);
+
+/*
+ * newRenderCache
+ *
+ * Syntactic Specification:
+ * RenderCache newRenderCache(void);
+ *
+ * Semantic Specification:
+ * Creates a new empty cache of pre-formatted renderings.
+ *
+ * Preconditions:
+ * - None
+ *
+ * Postconditions:
+ * - Returns a new cache with no valid entries
+ * - If allocation fails, returns 'NULL'
+ *
+ * Side Effects:
+ * - Allocates memory for the cache
+ */
+RenderCache newRenderCache(void);
+
+/*
+ * deleteRenderCache
+ *
+ * Syntactic Specification:
+ * void deleteRenderCache(RenderCache* cache);
+ *
+ * Semantic Specification:
+ * Deallocates the cache and all the renderings kept in it. The parameter is a pointer passed by reference.
+ *
+ * Preconditions:
+ * - 'cache' can be NULL or point to a valid/NULL pointer
+ *
+ * Postconditions:
+ * - All the memory of the cache is freed and '*cache' is set to NULL
+ *
+ * Side Effects:
+ * - Deallocates memory
+ */
+void deleteRenderCache(RenderCache* cache);
+
+/*
+ * printCachedRendering
+ *
+ * Syntactic Specification:
+ * int printCachedRendering(RenderCache cache, int kind, unsigned long version, time_t beginDate, time_t nowDate, FILE* file);
+ *
+ * Semantic Specification:
+ * Writes the cached rendering of the given kind, if it was made for the same container version and
+ * its validity ranges contain 'beginDate' and 'nowDate'.
+ *
+ * Preconditions:
+ * - 'kind' must be one of RENDER_KIND_*
+ * - 'file' must be opened for writing
+ *
+ * Postconditions:
+ * - Returns 1 if the cached bytes have been written to 'file' (cache hit)
+ * - Returns 0 otherwise (cache miss, nothing is written)
+ *
+ * Side Effects:
+ * - Writing to file
+ */
+int printCachedRendering(RenderCache cache, int kind, unsigned long version, time_t beginDate, time_t nowDate, FILE* file);
+
+/*
+ * storeRendering
+ *
+ * Syntactic Specification:
+ * void storeRendering(RenderCache cache, int kind, unsigned long version, RenderValidity validity, char* buffer, size_t size);
+ *
+ * Semantic Specification:
+ * Keeps 'buffer' as the rendering of the given kind for the given container version, replacing the previous one.
+ *
+ * Preconditions:
+ * - 'buffer' must be dynamically allocated (the cache takes ownership of it)
+ *
+ * Postconditions:
+ * - The rendering is stored in the cache
+ * - If 'cache == NULL' or 'kind' is not valid, 'buffer' is freed
+ *
+ * Side Effects:
+ * - Deallocates the previous rendering of the same kind
+ */
+void storeRendering(RenderCache cache, int kind, unsigned long version, RenderValidity validity, char* buffer, size_t size);
+
+#endif // ACTIVITIES_CONTAINER_RENDER_CACHE_H          // End of inclusion block
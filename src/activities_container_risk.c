@@ -0,0 +1,426 @@
+#include <stdlib.h>
+#include "activity.h"
+#include "activity_helper.h"
+#include "activities_container_risk.h"
+
+
+/*
+ * "struct riskEntry" Documentation
+ *
+ * Syntactic Specification:
+ * typedef struct riskEntry {
+ *     double slack;
+ *     int id;
+ * } RiskEntry;
+ *
+ * Semantic Specification:
+ * An activity at risk, with its slack (minutes), as kept in the results.
+ */
+typedef struct riskEntry {
+	double slack;
+	int id;
+} RiskEntry;
+
+
+/*
+ * "struct riskColumns" Documentation
+ *
+ * Syntactic Specification:
+ * struct riskColumns {
+ *     int count;
+ *     int capacity;
+ *     int* ids;
+ *     double* expiryDates;
+ *     double* remainingTimes;
+ *     double* slacks;
+ *     int atRiskCount;
+ *     RiskEntry* atRisk;
+ * };
+ *
+ * Semantic Specification:
+ * The numeric data needed by the "rischio" view, packed in parallel arrays (one column per field).
+ *
+ * Fields:
+ * - count: Number of activities in the columns
+ * - capacity: Allocated length of each column
+ * - ids: Activity ids
+ * - expiryDates: Expiry dates (as double, exact for any realistic time_t)
+ * - remainingTimes: totalTime - usedTime (0 if negative)
+ * - slacks: Slack computed by the last 'computeAtRiskActivities()'
+ * - atRiskCount: Number of activities at risk found by the last computation
+ * - atRisk: The activities at risk, sorted by slack (allocated with 'capacity' elements)
+ *
+ * Notes:
+ * - Dates and minutes are doubles so that the slack loop has a single data type (vectorizable)
+ */
+struct riskColumns {
+	int count;
+	int capacity;
+	int* ids;
+	double* expiryDates;
+	double* remainingTimes;
+	double* slacks;
+	int atRiskCount;
+	RiskEntry* atRisk;
+};
+
+
+
+/*
+ * compareRiskEntries
+ *
+ * Syntactic Specification:
+ * int compareRiskEntries(const void* a, const void* b);
+ *
+ * Semantic Specification:
+ * Comparator for qsort(): orders by slack (ascending, most critical first) and then by id.
+ *
+ * Preconditions:
+ * - 'a' and 'b' must point to valid RiskEntry
+ *
+ * Postconditions:
+ * - Returns a negative value, 0 or a positive value if 'a' comes before, together or after 'b'
+ *
+ * Side Effects:
+ * - None
+ */
+int compareRiskEntries(const void* a, const void* b) {
+	const RiskEntry* entryA = (const RiskEntry*)a;
+	const RiskEntry* entryB = (const RiskEntry*)b;
+
+	if (entryA->slack < entryB->slack) return -1;
+	if (entryA->slack > entryB->slack) return 1;
+	return (entryA->id > entryB->id) - (entryA->id < entryB->id);
+}
+
+/*
+ * freeRiskColumnsArrays
+ *
+ * Syntactic Specification:
+ * void freeRiskColumnsArrays(RiskColumns columns);
+ *
+ * Semantic Specification:
+ * Deallocates the arrays of the columns and leaves them empty.
+ *
+ * Preconditions:
+ * - 'columns != NULL'
+ *
+ * Postconditions:
+ * - All arrays are NULL, 'count', 'capacity' and 'atRiskCount' are 0
+ *
+ * Side Effects:
+ * - Deallocates memory
+ */
+void freeRiskColumnsArrays(RiskColumns columns) {
+	free(columns->ids);
+	free(columns->expiryDates);
+	free(columns->remainingTimes);
+	free(columns->slacks);
+	free(columns->atRisk);
+
+	columns->ids = NULL;
+	columns->expiryDates = NULL;
+	columns->remainingTimes = NULL;
+	columns->slacks = NULL;
+	columns->atRisk = NULL;
+	columns->count = 0;
+	columns->capacity = 0;
+	columns->atRiskCount = 0;
+}
+
+/*
+ * countRiskCandidates
+ *
+ * Syntactic Specification:
+ * int countRiskCandidates(TreeNode root);
+ *
+ * Semantic Specification:
+ * Counts the activities of the tree that are not completed and have an expiry date.
+ *
+ * Preconditions:
+ * - None
+ *
+ * Postconditions:
+ * - Returns the number of such activities (0 if 'root == NULL')
+ *
+ * Side Effects:
+ * - None
+ */
+int countRiskCandidates(TreeNode root) {
+	if (root == NULL) return 0;
+
+	Activity a = getActivityFromNode(root);
+	int isCandidate = (a != NULL && isActivityCompleted(a) == 0 && getActivityExpiryDate(a) != 0) ? 1 : 0;
+
+	return isCandidate + countRiskCandidates( getLeftNode(root) ) + countRiskCandidates( getRightNode(root) );
+}
+
+/*
+ * inOrderFillRiskColumns
+ *
+ * Syntactic Specification:
+ * void inOrderFillRiskColumns(TreeNode root, RiskColumns columns);
+ *
+ * Semantic Specification:
+ * Recursively appends to the columns the activities that are not completed and have an expiry date.
+ *
+ * Preconditions:
+ * - 'columns' must have room for all of them
+ *
+ * Postconditions:
+ * - The activities are appended in ascending order of ID and 'columns->count' is updated
+ *
+ * Side Effects:
+ * - Modifies the columns
+ */
+void inOrderFillRiskColumns(TreeNode root, RiskColumns columns) {
+	if (root == NULL) return;
+
+	inOrderFillRiskColumns(getLeftNode(root), columns);
+
+	Activity a = getActivityFromNode(root);
+	if (a != NULL && isActivityCompleted(a) == 0 && getActivityExpiryDate(a) != 0) {
+		unsigned int totalTime = getActivityTotalTime(a);
+		unsigned int usedTime = getActivityUsedTime(a);
+		int i = columns->count;
+
+		columns->ids[i] = getActivityId(a);
+		columns->expiryDates[i] = (double)getActivityExpiryDate(a);
+		columns->remainingTimes[i] = (totalTime > usedTime) ? (double)(totalTime - usedTime) : 0.0;
+		columns->count++;
+	}
+
+	inOrderFillRiskColumns(getRightNode(root), columns);
+}
+
+/*
+ * computeSlacks
+ *
+ * Syntactic Specification:
+ * void computeSlacks(int count, const double* restrict expiryDates, const double* restrict remainingTimes, double* restrict slacks, double nowDate, double minutesPerSecond);
+ *
+ * Semantic Specification:
+ * slacks[i] = max(0, (expiryDates[i] - nowDate) * minutesPerSecond) - remainingTimes[i]
+ *
+ * Preconditions:
+ * - The arrays have at least 'count' elements and don't overlap
+ *
+ * Postconditions:
+ * - 'slacks' is filled
+ *
+ * Side Effects:
+ * - Modifies 'slacks'
+ *
+ * Notes:
+ * - Straight-line body over packed arrays: compiled to SIMD code (see CFLAGS in the Makefile)
+ */
+void computeSlacks(int count, const double* restrict expiryDates, const double* restrict remainingTimes, double* restrict slacks, double nowDate, double minutesPerSecond) {
+	for (int i=0; i<count; i++) {
+		double workingTime = (expiryDates[i] - nowDate) * minutesPerSecond;
+		workingTime = (workingTime > 0.0) ? workingTime : 0.0;
+		slacks[i] = workingTime - remainingTimes[i];
+	}
+}
+
+
+
+/*
+ * newRiskColumns
+ *
+ * Syntactic Specification:
+ * RiskColumns newRiskColumns(void);
+ *
+ * Semantic Specification:
+ * Creates new empty packed columns (expiry date, remaining minutes, id) for the "rischio" view.
+ *
+ * Preconditions:
+ * - None
+ *
+ * Postconditions:
+ * - Returns new empty columns
+ * - If allocation fails, returns 'NULL'
+ *
+ * Side Effects:
+ * - Allocates memory
+ */
+RiskColumns newRiskColumns(void) {
+	RiskColumns columns = (struct riskColumns*)malloc(sizeof(struct riskColumns));
+	if (columns == NULL) return NULL;
+
+	columns->ids = NULL;
+	columns->expiryDates = NULL;
+	columns->remainingTimes = NULL;
+	columns->slacks = NULL;
+	columns->atRisk = NULL;
+	freeRiskColumnsArrays(columns);
+
+	return columns;
+}
+
+/*
+ * deleteRiskColumns
+ *
+ * Syntactic Specification:
+ * void deleteRiskColumns(RiskColumns* columns);
+ *
+ * Semantic Specification:
+ * Deallocates the columns and the last computed results. The parameter is a pointer passed by reference.
+ *
+ * Preconditions:
+ * - 'columns' can be NULL or point to a valid/NULL pointer
+ *
+ * Postconditions:
+ * - All the memory is freed and '*columns' is set to NULL
+ *
+ * Side Effects:
+ * - Deallocates memory
+ */
+void deleteRiskColumns(RiskColumns* columns) {
+	if (columns == NULL || *columns == NULL) return;
+
+	freeRiskColumnsArrays(*columns);
+	free(*columns);
+	*columns = NULL;
+}
+
+/*
+ * loadRiskColumnsFromTree
+ *
+ * Syntactic Specification:
+ * int loadRiskColumnsFromTree(RiskColumns columns, TreeNode root);
+ *
+ * Semantic Specification:
+ * Replaces the content of the columns with the activities of the tree that can be at risk:
+ * not completed and with an expiry date.
+ *
+ * Preconditions:
+ * - 'columns != NULL'
+ *
+ * Postconditions:
+ * - Returns 0 on success, 1 if 'columns == NULL' or memory allocation fails (columns left empty)
+ *
+ * Side Effects:
+ * - Modifies and possibly reallocates the columns
+ */
+int loadRiskColumnsFromTree(RiskColumns columns, TreeNode root) {
+	if (columns == NULL) return 1;
+
+	int count = countRiskCandidates(root);
+
+	if (count > columns->capacity) {
+		freeRiskColumnsArrays(columns);
+
+		columns->ids = (int*)malloc(count * sizeof(int));
+		columns->expiryDates = (double*)malloc(count * sizeof(double));
+		columns->remainingTimes = (double*)malloc(count * sizeof(double));
+		columns->slacks = (double*)malloc(count * sizeof(double));
+		columns->atRisk = (RiskEntry*)malloc(count * sizeof(RiskEntry));
+
+		if (columns->ids == NULL || columns->expiryDates == NULL || columns->remainingTimes == NULL || columns->slacks == NULL || columns->atRisk == NULL) {
+			freeRiskColumnsArrays(columns);
+			return 1;
+		}
+		columns->capacity = count;
+	}
+
+	columns->count = 0;
+	columns->atRiskCount = 0;
+	inOrderFillRiskColumns(root, columns);
+
+	return 0;
+}
+
+/*
+ * computeAtRiskActivities
+ *
+ * Syntactic Specification:
+ * int computeAtRiskActivities(RiskColumns columns, time_t nowDate, unsigned int dailyCapacity);
+ *
+ * Semantic Specification:
+ * Computes the slack of every activity in the columns:
+ *     slack = max(0, working minutes left before expiryDate) - (totalTime - usedTime)
+ * where the working minutes left are the days left before expiryDate times 'dailyCapacity'.
+ * The activities with negative slack (remaining minutes exceed the working minutes left) are at risk.
+ *
+ * Preconditions:
+ * - 'columns != NULL'
+ * - 'dailyCapacity' in minutes (0-1440)
+ *
+ * Postconditions:
+ * - Returns the number of activities at risk, sorted by slack (most critical first, then by id)
+ * - Returns 0 if 'columns == NULL' or memory allocation fails
+ *
+ * Side Effects:
+ * - Modifies the results kept in the columns (replacing the previous ones)
+ *
+ * Notes:
+ * - The slack loop works only on packed double arrays (no getters, no branches) so that the compiler can vectorize it
+ */
+int computeAtRiskActivities(RiskColumns columns, time_t nowDate, unsigned int dailyCapacity) {
+	if (columns == NULL) return 0;
+
+	double minutesPerSecond = (double)dailyCapacity / (24.0 * 60.0 * 60.0);
+	computeSlacks(columns->count, columns->expiryDates, columns->remainingTimes, columns->slacks, (double)nowDate, minutesPerSecond);
+
+	int atRiskCount = 0;
+	for (int i=0; i<columns->count; i++) {
+		if (columns->slacks[i] < 0.0) {
+			columns->atRisk[atRiskCount].slack = columns->slacks[i];
+			columns->atRisk[atRiskCount].id = columns->ids[i];
+			atRiskCount++;
+		}
+	}
+
+	qsort(columns->atRisk, atRiskCount, sizeof(RiskEntry), compareRiskEntries);
+	columns->atRiskCount = atRiskCount;
+
+	return atRiskCount;
+}
+
+/*
+ * getAtRiskActivityId
+ *
+ * Syntactic Specification:
+ * int getAtRiskActivityId(RiskColumns columns, int index);
+ *
+ * Semantic Specification:
+ * Returns the id of the activity at position 'index' of the last computed results.
+ *
+ * Preconditions:
+ * - '0 <= index < ' last result of 'computeAtRiskActivities()'
+ *
+ * Postconditions:
+ * - Returns the id, or -1 if 'columns == NULL' or 'index' is not valid
+ *
+ * Side Effects:
+ * - None
+ */
+int getAtRiskActivityId(RiskColumns columns, int index) {
+	if (columns == NULL || index < 0 || index >= columns->atRiskCount) return -1;
+
+	return columns->atRisk[index].id;
+}
+
+/*
+ * getAtRiskActivitySlack
+ *
+ * Syntactic Specification:
+ * double getAtRiskActivitySlack(RiskColumns columns, int index);
+ *
+ * Semantic Specification:
+ * Returns the slack (in minutes, negative) of the activity at position 'index' of the last computed results.
+ *
+ * Preconditions:
+ * - '0 <= index < ' last result of 'computeAtRiskActivities()'
+ *
+ * Postconditions:
+ * - Returns the slack, or 0 if 'columns == NULL' or 'index' is not valid
+ *
+ * Side Effects:
+ * - None
+ */
+double getAtRiskActivitySlack(RiskColumns columns, int index) {
+	if (columns == NULL || index < 0 || index >= columns->atRiskCount) return 0.0;
+
+	return columns->atRisk[index].slack;
+}
@@ -0,0 +1,141 @@
+#ifndef ACTIVITIES_CONTAINER_RISK_H             // Start of inclusion block
+#define ACTIVITIES_CONTAINER_RISK_H             // Macro definition to avoid multiple inclusions
+
+#include <time.h>
+#include "activities_container_avl.h"
+
+// Declare an opaque type for the packed numeric columns of the "rischio" view
+typedef struct riskColumns* RiskColumns;
+
+
+/*
+ * newRiskColumns
+ *
+ * Syntactic Specification:
+ * RiskColumns newRiskColumns(void);
+ *
+ * Semantic Specification:
+ * Creates new empty packed columns (expiry date, remaining minutes, id) for the "rischio" view.
+ *
+ * Preconditions:
+ * - None
+ *
+ * Postconditions:
+ * - Returns new empty columns
+ * - If allocation fails, returns 'NULL'
+ *
+ * Side Effects:
+ * - Allocates memory
+ */
+RiskColumns newRiskColumns(void);
+
+/*
+ * deleteRiskColumns
+ *
+ * Syntactic Specification:
+ * void deleteRiskColumns(RiskColumns* columns);
+ *
+ * Semantic Specification:
+ * Deallocates the columns and the last computed results. The parameter is a pointer passed by reference.
+ *
+ * Preconditions:
+ * - 'columns' can be NULL or point to a valid/NULL pointer
+ *
+ * Postconditions:
+ * - All the memory is freed and '*columns' is set to NULL
+ *
+ * Side Effects:
+ * - Deallocates memory
+ */
+void deleteRiskColumns(RiskColumns* columns);
+
+/*
+ * loadRiskColumnsFromTree
+ *
+ * Syntactic Specification:
+ * int loadRiskColumnsFromTree(RiskColumns columns, TreeNode root);
+ *
+ * Semantic Specification:
+ * Replaces the content of the columns with the activities of the tree that can be at risk:
+ * not completed and with an expiry date.
+ *
+ * Preconditions:
+ * - 'columns != NULL'
+ *
+ * Postconditions:
+ * - Returns 0 on success, 1 if 'columns == NULL' or memory allocation fails (columns left empty)
+ *
+ * Side Effects:
+ * - Modifies and possibly reallocates the columns
+ */
+int loadRiskColumnsFromTree(RiskColumns columns, TreeNode root);
+
+/*
+ * computeAtRiskActivities
+ *
+ * Syntactic Specification:
+ * int computeAtRiskActivities(RiskColumns columns, time_t nowDate, unsigned int dailyCapacity);
+ *
+ * Semantic Specification:
+ * Computes the slack of every activity in the columns:
+ *     slack = max(0, working minutes left before expiryDate) - (totalTime - usedTime)
+ * where the working minutes left are the days left before expiryDate times 'dailyCapacity'.
+ * The activities with negative slack (remaining minutes exceed the working minutes left) are at risk.
+ *
+ * Preconditions:
+ * - 'columns != NULL'
+ * - 'dailyCapacity' in minutes (0-1440)
+ *
+ * Postconditions:
+ * - Returns the number of activities at risk, sorted by slack (most critical first, then by id)
+ * - Returns 0 if 'columns == NULL' or memory allocation fails
+ *
+ * Side Effects:
+ * - Modifies the results kept in the columns (replacing the previous ones)
+ *
+ * Notes:
+ * - The slack loop works only on packed double arrays (no getters, no branches) so that the compiler can vectorize it
+ */
+int computeAtRiskActivities(RiskColumns columns, time_t nowDate, unsigned int dailyCapacity);
+
+/*
+ * getAtRiskActivityId
+ *
+ * Syntactic Specification:
+ * int getAtRiskActivityId(RiskColumns columns, int index);
+ *
+ * Semantic Specification:
+ * Returns the id of the activity at position 'index' of the last computed results.
+ *
+ * Preconditions:
+ * - '0 <= index < ' last result of 'computeAtRiskActivities()'
+ *
+ * Postconditions:
+ * - Returns the id, or -1 if 'columns == NULL' or 'index' is not valid
+ *
+ * Side Effects:
+ * - None
+ */
+int getAtRiskActivityId(RiskColumns columns, int index);
+
+/*
+ * getAtRiskActivitySlack
+ *
+ * Syntactic Specification:
+ * double getAtRiskActivitySlack(RiskColumns columns, int index);
+ *
+ * Semantic Specification:
+ * Returns the slack (in minutes, negative) of the activity at position 'index' of the last computed results.
+ *
+ * Preconditions:
+ * - '0 <= index < ' last result of 'computeAtRiskActivities()'
+ *
+ * Postconditions:
+ * - Returns the slack, or 0 if 'columns == NULL' or 'index' is not valid
+ *
+ * Side Effects:
+ * - None
+ */
+double getAtRiskActivitySlack(RiskColumns columns, int index);
+
+#endif // ACTIVITIES_CONTAINER_RISK_H          // End of inclusion block
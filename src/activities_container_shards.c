@@ -0,0 +1,736 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <errno.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include "activity.h"
+#include "activities_container_shards.h"
+#include "activities_container_snapshot.h"
+#include "activities_container_writer.h"
+#include "activities_container_checksum.h"
+
+// Maximum number of characters of the name of a shard file ("shard_" and the 10 digits of an index)
+#define ACTIVITY_SHARD_NAME_LENGTH 32
+
+
+/*
+ * "struct shardEntry" Documentation
+ *
+ * Syntactic Specification:
+ * typedef struct shardEntry {
+ *     int index;
+ *     int count;
+ * } ShardEntry;
+ *
+ * Semantic Specification:
+ * A shard listed in the manifest.
+ *
+ * Fields:
+ * - index: Number of the shard (its range of ids, see 'writeActivityShards()')
+ * - count: Number of activities of the shard, as last written or read
+ */
+typedef struct shardEntry {
+	int index;
+	int count;
+} ShardEntry;
+
+
+/*
+ * "struct activityShards" Documentation
+ *
+ * Syntactic Specification:
+ * struct activityShards {
+ *     char* directory;
+ *     int idRange;
+ *     ShardEntry* entries;
+ *     int entryCount;
+ * };
+ *
+ * Semantic Specification:
+ * A sharded directory as it was after the last save (or read).
+ *
+ * Fields:
+ * - directory: Name of the directory
+ * - idRange: Number of ids of a shard
+ * - entries, entryCount: The shards listed in the manifest, by increasing index
+ */
+struct activityShards {
+	char* directory;
+	int idRange;
+	ShardEntry* entries;
+	int entryCount;
+};
+
+
+/*
+ * "struct shardReadTask" Documentation
+ *
+ * Syntactic Specification:
+ * typedef struct shardReadTask {
+ *     ActivityShards shards;
+ *     int first;
+ *     int step;
+ *     Activity** activities;
+ *     int* counts;
+ *     int failed;
+ * } ShardReadTask;
+ *
+ * Semantic Specification:
+ * Work of one thread of 'readActivityShards()': the shards 'first', 'first + step', 'first + 2 * step', ...
+ *
+ * Fields:
+ * - shards: The sharded directory, with the entries of the manifest
+ * - first, step: The shards of the task
+ * - activities, counts: For every shard of the directory, its activities and their number (shared by the
+ *   tasks, each one writes only the elements of its shards)
+ * - failed: 1 if a shard of the task can't be read or is not valid
+ */
+typedef struct shardReadTask {
+	ActivityShards shards;
+	int first;
+	int step;
+	Activity** activities;
+	int* counts;
+	int failed;
+} ShardReadTask;
+
+
+/*
+ * getActivityShardIndex
+ *
+ * Syntactic Specification:
+ * int getActivityShardIndex(int activityId, int idRange);
+ *
+ * Semantic Specification:
+ * Returns the number of the shard of an id: the ids from n * range + 1 to (n + 1) * range are in shard n,
+ * the ids lower than 1 in shard 0.
+ *
+ * Preconditions:
+ * - 'idRange > 0'
+ *
+ * Postconditions:
+ * - Returns the number of the shard (not negative)
+ *
+ * Side Effects:
+ * - None
+ */
+int getActivityShardIndex(int activityId, int idRange) {
+	if (activityId < 1) return 0;
+
+	return (activityId - 1) / idRange;
+}
+
+/*
+ * newShardPath
+ *
+ * Syntactic Specification:
+ * char* newShardPath(const char* directory, const char* name);
+ *
+ * Semantic Specification:
+ * Returns the path of a file of the directory.
+ *
+ * Preconditions:
+ * - 'directory != NULL', 'name != NULL'
+ *
+ * Postconditions:
+ * - Returns a new string (the caller deallocates it), NULL if memory allocation fails
+ *
+ * Side Effects:
+ * - Allocates memory
+ */
+char* newShardPath(const char* directory, const char* name) {
+	size_t length = strlen(directory) + 1 + strlen(name) + 1;
+	char* path = malloc(length);
+	if (path != NULL) snprintf(path, length, "%s/%s", directory, name);
+
+	return path;
+}
+
+/*
+ * formatShardName
+ *
+ * Syntactic Specification:
+ * void formatShardName(char* name, int index);
+ *
+ * Semantic Specification:
+ * Writes the name of the file of a shard, "shard_<index>.bin".
+ *
+ * Preconditions:
+ * - 'name' has room for ACTIVITY_SHARD_NAME_LENGTH characters
+ *
+ * Postconditions:
+ * - 'name' holds the name
+ *
+ * Side Effects:
+ * - None
+ */
+void formatShardName(char* name, int index) {
+	snprintf(name, ACTIVITY_SHARD_NAME_LENGTH, "shard_%d.bin", index);
+}
+
+/*
+ * newActivityShards
+ *
+ * Syntactic Specification:
+ * ActivityShards newActivityShards(const char* directory);
+ *
+ * Semantic Specification:
+ * Creates a sharded directory with no shards yet, with ACTIVITY_SHARD_ID_RANGE ids per shard: the first
+ * 'writeActivityShards()' writes every shard (the directory is created if it doesn't exist).
+ *
+ * Preconditions:
+ * - 'directory != NULL'
+ *
+ * Postconditions:
+ * - Returns the sharded directory, NULL if memory allocation fails
+ *
+ * Side Effects:
+ * - Allocates memory
+ */
+ActivityShards newActivityShards(const char* directory) {
+	if (directory == NULL) return NULL;
+
+	ActivityShards shards = calloc(1, sizeof(struct activityShards));
+	if (shards == NULL) return NULL;
+	shards->directory = malloc(strlen(directory) + 1);
+	if (shards->directory == NULL) {
+		free(shards);
+		return NULL;
+	}
+	strcpy(shards->directory, directory);
+	shards->idRange = ACTIVITY_SHARD_ID_RANGE;
+
+	return shards;
+}
+
+/*
+ * writeShardsManifest
+ *
+ * Syntactic Specification:
+ * int writeShardsManifest(ActivityShards shards, ShardEntry* entries, int entryCount);
+ *
+ * Semantic Specification:
+ * Writes the manifest of the sharded directory with the given shards (see 'writeActivityShards()'),
+ * replacing the previous one only when complete.
+ *
+ * Preconditions:
+ * - 'shards != NULL', 'entries' has 'entryCount' shards by increasing index
+ *
+ * Postconditions:
+ * - Returns 0 on success, 1 if the manifest can't be written (it keeps its previous content)
+ *
+ * Side Effects:
+ * - Writing to file
+ */
+int writeShardsManifest(ActivityShards shards, ShardEntry* entries, int entryCount) {
+	char* path = newShardPath(shards->directory, ACTIVITY_SHARDS_MANIFEST);
+	if (path == NULL) return 1;
+
+	ActivityWriter writer = newActivityWriter(path);
+	free(path);
+	if (writer == NULL) return 1;
+	enableActivityWriterChecksums(writer);
+
+	writeBytesToActivityWriter(writer, ACTIVITY_SHARDS_MAGIC " ", strlen(ACTIVITY_SHARDS_MAGIC) + 1);
+	writeNumberToActivityWriter(writer, ACTIVITY_SHARDS_VERSION);
+	writeBytesToActivityWriter(writer, "\n", 1);
+	writeNumberToActivityWriter(writer, shards->idRange);
+	writeBytesToActivityWriter(writer, "\n", 1);
+	writeNumberToActivityWriter(writer, entryCount);
+	writeBytesToActivityWriter(writer, "\n", 1);
+
+	char name[ACTIVITY_SHARD_NAME_LENGTH];
+	for (int e = 0; e < entryCount; e++) {
+		long long firstId = (long long)entries[e].index * shards->idRange + 1;
+		long long lastId = firstId + shards->idRange - 1;
+		formatShardName(name, entries[e].index);
+
+		writeNumberToActivityWriter(writer, entries[e].index);
+		writeBytesToActivityWriter(writer, " ", 1);
+		writeNumberToActivityWriter(writer, firstId);
+		writeBytesToActivityWriter(writer, " ", 1);
+		writeNumberToActivityWriter(writer, (lastId > INT_MAX) ? INT_MAX : lastId);
+		writeBytesToActivityWriter(writer, " ", 1);
+		writeNumberToActivityWriter(writer, entries[e].count);
+		writeBytesToActivityWriter(writer, " ", 1);
+		writeBytesToActivityWriter(writer, name, strlen(name));
+		writeBytesToActivityWriter(writer, "\n", 1);
+	}
+
+	return commitActivityWriter(&writer);
+}
+
+/*
+ * writeActivityShard
+ *
+ * Syntactic Specification:
+ * int writeActivityShard(ActivityShards shards, int index, Activity* activities, int count);
+ *
+ * Semantic Specification:
+ * Writes a shard of the directory as a binary snapshot of its activities, replacing its file only when complete.
+ *
+ * Preconditions:
+ * - 'shards != NULL', 'activities' has the 'count' activities of the shard, sorted by id
+ *
+ * Postconditions:
+ * - Returns 0 on success, 1 if the shard can't be written (its file keeps its previous content)
+ *
+ * Side Effects:
+ * - Writing to file
+ */
+int writeActivityShard(ActivityShards shards, int index, Activity* activities, int count) {
+	char name[ACTIVITY_SHARD_NAME_LENGTH];
+	formatShardName(name, index);
+	char* path = newShardPath(shards->directory, name);
+	if (path == NULL) return 1;
+
+	ActivityWriter writer = newActivityWriter(path);
+	free(path);
+	if (writer == NULL) return 1;
+	enableActivityWriterChecksums(writer);
+
+	if (writeActivitiesSnapshotOfArray(writer, activities, (size_t)count) != 0) {
+		discardActivityWriter(&writer);
+		return 1;
+	}
+
+	return commitActivityWriter(&writer);
+}
+
+/*
+ * writeActivityShards
+ *
+ * Syntactic Specification:
+ * int writeActivityShards(ActivityShards shards, Activity* activities, int count, int* writtenCount);
+ *
+ * Semantic Specification:
+ * Saves the activities to the sharded directory: the ids are split in ranges of the same number of ids,
+ * shard n holding the ids from n * range + 1 to (n + 1) * range (the ids lower than 1 in shard 0), and
+ * every shard that isn't empty is a binary snapshot (see 'writeActivitiesSnapshot()') named
+ * "shard_<n>.bin". The manifest ACTIVITY_SHARDS_MANIFEST is a text file:
+ * - a line with ACTIVITY_SHARDS_MAGIC and the version, a line with the number of ids of a shard and a
+ *   line with the number of shards
+ * - a line per shard, by increasing n: n, first and last id of its range, number of activities, file name
+ * Only the shards that have changed since the last save are written: the ones with a dirty activity (see
+ * 'isActivityDirty()'), with a different number of activities (an activity removed) or new. Every shard
+ * is replaced only when complete, then the manifest; the files of the shards that became empty are
+ * removed after it. Then every activity is clean.
+ *
+ * Preconditions:
+ * - 'shards != NULL', 'writtenCount != NULL'
+ * - 'activities' has 'count' activities sorted by id, all the activities of the container
+ *
+ * Postconditions:
+ * - Returns 0 on success: '*writtenCount' is the number of shards written
+ * - Returns 1 if the directory, a shard or the manifest can't be written, or memory allocation fails:
+ *   the manifest keeps its previous content (with the shards it lists), the activities keep their dirty bit
+ *
+ * Side Effects:
+ * - Creation of the directory, writing and removal of files
+ * - Modifies the sharded directory and the dirty bit of the activities
+ */
+int writeActivityShards(ActivityShards shards, Activity* activities, int count, int* writtenCount) {
+	*writtenCount = 0;
+	if (shards == NULL || (activities == NULL && count > 0)) return 1;
+
+	if (mkdir(shards->directory, 0777) != 0 && errno != EEXIST) return 1;
+
+	// at most one shard per activity
+	ShardEntry* entries = malloc((count > 0 ? count : 1) * sizeof(ShardEntry));
+	if (entries == NULL) return 1;
+
+	int entryCount = 0;
+	int oldEntry = 0;
+	int failed = 0;
+	int i = 0;
+	while (i < count && !failed) {
+		int index = getActivityShardIndex(getActivityId(activities[i]), shards->idRange);
+		int isDirty = 0;
+		int j = i;
+		while (j < count && getActivityShardIndex(getActivityId(activities[j]), shards->idRange) == index) {
+			if (isActivityDirty(activities[j])) isDirty = 1;
+			j++;
+		}
+
+		while (oldEntry < shards->entryCount && shards->entries[oldEntry].index < index) oldEntry++;
+		int isListed = (oldEntry < shards->entryCount && shards->entries[oldEntry].index == index);
+		if (!isListed || isDirty || shards->entries[oldEntry].count != j - i) {
+			if (writeActivityShard(shards, index, activities + i, j - i) != 0) failed = 1;
+			else (*writtenCount)++;
+		}
+
+		entries[entryCount].index = index;
+		entries[entryCount].count = j - i;
+		entryCount++;
+		i = j;
+	}
+
+	if (failed || writeShardsManifest(shards, entries, entryCount) != 0) {
+		free(entries);
+		return 1;
+	}
+
+	// the shards that are not listed any more
+	char name[ACTIVITY_SHARD_NAME_LENGTH];
+	int e = 0;
+	for (int o = 0; o < shards->entryCount; o++) {
+		while (e < entryCount && entries[e].index < shards->entries[o].index) e++;
+		if (e < entryCount && entries[e].index == shards->entries[o].index) continue;
+
+		formatShardName(name, shards->entries[o].index);
+		char* path = newShardPath(shards->directory, name);
+		if (path != NULL) unlink(path);
+		removeActivityChecksums(path);
+		free(path);
+	}
+
+	free(shards->entries);
+	shards->entries = entries;
+	shards->entryCount = entryCount;
+	for (int a = 0; a < count; a++) markActivityClean(activities[a]);
+
+	return 0;
+}
+
+/*
+ * readShardsManifest
+ *
+ * Syntactic Specification:
+ * int readShardsManifest(ActivityShards shards);
+ *
+ * Semantic Specification:
+ * Reads the manifest of the sharded directory (see 'writeActivityShards()') into its entries.
+ *
+ * Preconditions:
+ * - 'shards != NULL', with no entries
+ *
+ * Postconditions:
+ * - Returns 0 on success: 'idRange' and the entries are set
+ * - Returns 1 if the manifest can't be read, is not valid (of this version, with shards by increasing
+ *   index and the names 'writeActivityShards()' gives them) or memory allocation fails
+ *
+ * Side Effects:
+ * - Reading from file
+ * - Allocates memory
+ */
+int readShardsManifest(ActivityShards shards) {
+	char* path = newShardPath(shards->directory, ACTIVITY_SHARDS_MANIFEST);
+	if (path == NULL) return 1;
+
+	FILE* file = fopen(path, "r");
+	free(path);
+	if (file == NULL) return 1;
+
+	char magic[16];
+	int version = 0;
+	int entryCount = 0;
+	if (fscanf(file, "%15s %d %d %d", magic, &version, &shards->idRange, &entryCount) != 4 ||
+		 strcmp(magic, ACTIVITY_SHARDS_MAGIC) != 0 || version != ACTIVITY_SHARDS_VERSION ||
+		 shards->idRange <= 0 || entryCount < 0) {
+		fclose(file);
+		return 1;
+	}
+
+	shards->entries = malloc((entryCount > 0 ? entryCount : 1) * sizeof(ShardEntry));
+	if (shards->entries == NULL) {
+		fclose(file);
+		return 1;
+	}
+
+	int error = 0;
+	char name[ACTIVITY_SHARD_NAME_LENGTH];
+	char expectedName[ACTIVITY_SHARD_NAME_LENGTH];
+	for (int e = 0; e < entryCount && !error; e++) {
+		ShardEntry* entry = &shards->entries[e];
+		long long firstId = 0;
+		long long lastId = 0;
+		if (fscanf(file, "%d %lld %lld %d %31s", &entry->index, &firstId, &lastId, &entry->count, name) != 5 ||
+			 entry->index < 0 || entry->count < 0 || (e > 0 && entry->index <= shards->entries[e-1].index)) {
+			error = 1;
+			break;
+		}
+		formatShardName(expectedName, entry->index);
+		if (strcmp(name, expectedName) != 0) error = 1;
+		shards->entryCount = e + 1;
+	}
+	fclose(file);
+
+	return error;
+}
+
+/*
+ * readShardsTask
+ *
+ * Syntactic Specification:
+ * void* readShardsTask(void* argument);
+ *
+ * Semantic Specification:
+ * Thread routine of 'readActivityShards()': reads the shards of the task, checking that every activity
+ * is in the range of ids of its shard.
+ *
+ * Preconditions:
+ * - 'argument' points to a valid ShardReadTask
+ *
+ * Postconditions:
+ * - Returns NULL; the activities of the shards of the task are set, or 'failed' is set
+ *
+ * Side Effects:
+ * - Reading from files
+ * - Allocates the activities and their arrays
+ */
+void* readShardsTask(void* argument) {
+	ShardReadTask* task = (ShardReadTask*)argument;
+	ActivityShards shards = task->shards;
+	char name[ACTIVITY_SHARD_NAME_LENGTH];
+
+	for (int e = task->first; e < shards->entryCount && !task->failed; e += task->step) {
+		int index = shards->entries[e].index;
+		formatShardName(name, index);
+		char* path = newShardPath(shards->directory, name);
+		FILE* file = (path != NULL) ? fopen(path, "rb") : NULL;
+		free(path);
+		if (file == NULL || readActivitiesSnapshot(file, &task->activities[e], &task->counts[e]) != 0) {
+			if (file != NULL) fclose(file);
+			task->failed = 1;
+			break;
+		}
+		fclose(file);
+
+		for (int i = 0; i < task->counts[e]; i++) {
+			if (getActivityShardIndex(getActivityId(task->activities[e][i]), shards->idRange) != index) task->failed = 1;
+		}
+	}
+
+	return NULL;
+}
+
+/*
+ * resolveShardsThreadCount
+ *
+ * Syntactic Specification:
+ * int resolveShardsThreadCount(int shardCount);
+ *
+ * Semantic Specification:
+ * Returns the number of threads that read the shards: one per online processor, limited to
+ * ACTIVITY_SHARDS_MAX_THREADS and to the number of shards.
+ *
+ * Preconditions:
+ * - None
+ *
+ * Postconditions:
+ * - Returns a value between 1 and ACTIVITY_SHARDS_MAX_THREADS
+ *
+ * Side Effects:
+ * - None
+ */
+int resolveShardsThreadCount(int shardCount) {
+	long processors = sysconf(_SC_NPROCESSORS_ONLN);
+	int threadCount = (processors > 0) ? (int)((processors < ACTIVITY_SHARDS_MAX_THREADS) ? processors : ACTIVITY_SHARDS_MAX_THREADS) : 1;
+	if (threadCount > shardCount) threadCount = shardCount;
+
+	return (threadCount > 0) ? threadCount : 1;
+}
+
+/*
+ * readActivityShards
+ *
+ * Syntactic Specification:
+ * ActivityShards readActivityShards(const char* directory, Activity** activities, int* count);
+ *
+ * Semantic Specification:
+ * Reads the manifest of a sharded directory (see 'writeActivityShards()') and then its shards on several
+ * threads, one per online processor (at most ACTIVITY_SHARDS_MAX_THREADS and one per shard), each thread
+ * reading whole shards. The shards are joined in the order of the manifest: since they cover ranges of
+ * increasing ids, the activities are sorted by id. Every activity is clean.
+ *
+ * Preconditions:
+ * - 'directory != NULL', 'activities != NULL', 'count != NULL'
+ *
+ * Postconditions:
+ * - Returns the sharded directory: '*activities' is a new array with the '*count' activities (the caller
+ *   deallocates the array and owns the activities)
+ * - Returns NULL if the manifest or a shard can't be read or is not valid, or memory allocation fails:
+ *   '*activities' is NULL and '*count' is 0
+ *
+ * Side Effects:
+ * - Reading from files
+ * - Allocates memory
+ * - May create and join threads
+ */
+ActivityShards readActivityShards(const char* directory, Activity** activities, int* count) {
+	*activities = NULL;
+	*count = 0;
+
+	ActivityShards shards = newActivityShards(directory);
+	if (shards == NULL) return NULL;
+	if (readShardsManifest(shards) != 0) {
+		deleteActivityShards(&shards);
+		return NULL;
+	}
+
+	int shardCount = shards->entryCount;
+	Activity** shardActivities = calloc(shardCount > 0 ? shardCount : 1, sizeof(Activity*));
+	int* shardCounts = calloc(shardCount > 0 ? shardCount : 1, sizeof(int));
+	int threadCount = resolveShardsThreadCount(shardCount);
+	ShardReadTask tasks[ACTIVITY_SHARDS_MAX_THREADS];
+	int failed = (shardActivities == NULL || shardCounts == NULL);
+
+	if (!failed) {
+		for (int t = 0; t < threadCount; t++) {
+			tasks[t].shards = shards;
+			tasks[t].first = t;
+			tasks[t].step = threadCount;
+			tasks[t].activities = shardActivities;
+			tasks[t].counts = shardCounts;
+			tasks[t].failed = 0;
+		}
+
+		// The calling thread takes the first task itself
+		pthread_t threads[ACTIVITY_SHARDS_MAX_THREADS];
+		int started[ACTIVITY_SHARDS_MAX_THREADS];
+		for (int t = 1; t < threadCount; t++) {
+			started[t] = (pthread_create(&threads[t], NULL, readShardsTask, &tasks[t]) == 0) ? 1 : 0;
+		}
+		readShardsTask(&tasks[0]);
+		for (int t = 1; t < threadCount; t++) {
+			if (started[t] == 1) pthread_join(threads[t], NULL);
+			else readShardsTask(&tasks[t]);
+		}
+		for (int t = 0; t < threadCount; t++) {
+			if (tasks[t].failed) failed = 1;
+		}
+	}
+
+	long long total = 0;
+	for (int e = 0; e < shardCount && !failed; e++) total += shardCounts[e];
+	Activity* result = (!failed && total <= INT_MAX) ? malloc((total > 0 ? (size_t)total : 1) * sizeof(Activity)) : NULL;
+
+	int resultCount = 0;
+	for (int e = 0; e < shardCount && shardActivities != NULL; e++) {
+		for (int i = 0; i < shardCounts[e]; i++) {
+			if (result != NULL) {
+				markActivityClean(shardActivities[e][i]);
+				result[resultCount++] = shardActivities[e][i];
+			} else {
+				deleteActivity(shardActivities[e][i]);
+			}
+		}
+		if (result != NULL) shards->entries[e].count = shardCounts[e]; // the shards as they are on the disk
+		free(shardActivities[e]);
+	}
+	free(shardActivities);
+	free(shardCounts);
+
+	if (result == NULL) {
+		deleteActivityShards(&shards);
+		return NULL;
+	}
+
+	*activities = result;
+	*count = resultCount;
+	return shards;
+}
+
+/*
+ * getActivityShardsDirectory
+ *
+ * Syntactic Specification:
+ * const char* getActivityShardsDirectory(ActivityShards shards);
+ *
+ * Semantic Specification:
+ * Returns the name of the directory of the shards.
+ *
+ * Preconditions:
+ * - None
+ *
+ * Postconditions:
+ * - Returns the directory name, NULL if 'shards == NULL'
+ *
+ * Side Effects:
+ * - None
+ */
+const char* getActivityShardsDirectory(ActivityShards shards) {
+	if (shards == NULL) return NULL;
+
+	return shards->directory;
+}
+
+/*
+ * verifyActivityShards
+ *
+ * Syntactic Specification:
+ * int verifyActivityShards(const char* directory);
+ *
+ * Semantic Specification:
+ * Checks a sharded directory against its checksum files, without reading the activities: first the
+ * manifest, then every shard it lists (see 'verifyActivityChecksums()').
+ *
+ * Preconditions:
+ * - None
+ *
+ * Postconditions:
+ * - Returns 0 if the manifest and every shard are intact
+ * - Returns 1 if a file is damaged, can't be read or has no valid checksum file, or memory allocation fails
+ *
+ * Side Effects:
+ * - Reading from files
+ * - Output to stdout (damaged blocks and result of every file)
+ */
+int verifyActivityShards(const char* directory) {
+	if (directory == NULL) return 1;
+
+	char* path = newShardPath(directory, ACTIVITY_SHARDS_MANIFEST);
+	if (path == NULL) return 1;
+	int result = verifyActivityChecksums(path);
+	free(path);
+	if (result != 0) return 1;
+
+	ActivityShards shards = newActivityShards(directory);
+	if (shards == NULL || readShardsManifest(shards) != 0) {
+		printf("Errore nella lettura del manifesto della cartella %s.\n", directory);
+		deleteActivityShards(&shards);
+		return 1;
+	}
+
+	// every shard is checked, so that all the damaged ones are reported
+	char name[ACTIVITY_SHARD_NAME_LENGTH];
+	for (int e = 0; e < shards->entryCount; e++) {
+		formatShardName(name, shards->entries[e].index);
+		path = newShardPath(directory, name);
+		if (path == NULL || verifyActivityChecksums(path) != 0) result = 1;
+		free(path);
+	}
+
+	deleteActivityShards(&shards);
+	return result;
+}
+
+/*
+ * deleteActivityShards
+ *
+ * Syntactic Specification:
+ * void deleteActivityShards(ActivityShards* shards);
+ *
+ * Semantic Specification:
+ * Deallocates the sharded directory (its files are not modified). The parameter is a pointer passed by reference.
+ *
+ * Preconditions:
+ * - 'shards' can be NULL or point to a valid/NULL pointer
+ *
+ * Postconditions:
+ * - '*shards' is set to NULL
+ *
+ * Side Effects:
+ * - Deallocates memory
+ */
+void deleteActivityShards(ActivityShards* shards) {
+	if (shards == NULL || *shards == NULL) return;
+
+	free((*shards)->directory);
+	free((*shards)->entries);
+	free(*shards);
+	*shards = NULL;
+}
@@ -0,0 +1,170 @@
+#ifndef ACTIVITIES_CONTAINER_SHARDS_H             // Start of inclusion block
+#define ACTIVITIES_CONTAINER_SHARDS_H             // Macro definition to avoid multiple inclusions
+
+#include "activity.h"
+
+// First word of the manifest of a sharded directory
+#define ACTIVITY_SHARDS_MAGIC "PSDSHARDS"
+// Version of the sharded directory layout written by 'writeActivityShards()'
+#define ACTIVITY_SHARDS_VERSION 1
+// Name of the manifest in a sharded directory
+#define ACTIVITY_SHARDS_MANIFEST "manifest.txt"
+// Number of consecutive ids of a shard of a new sharded directory
+// (it can be changed at build time, e.g. -DACTIVITY_SHARD_ID_RANGE=65536)
+#ifndef ACTIVITY_SHARD_ID_RANGE
+#define ACTIVITY_SHARD_ID_RANGE 4096
+#endif
+// Upper bound of the threads that read the shards of a directory
+#define ACTIVITY_SHARDS_MAX_THREADS 64
+
+// Declare an opaque type for a sharded directory bound to the activities read from or saved to it
+typedef struct activityShards* ActivityShards;
+
+
+/*
+ * newActivityShards
+ *
+ * Syntactic Specification:
+ * ActivityShards newActivityShards(const char* directory);
+ *
+ * Semantic Specification:
+ * Creates a sharded directory with no shards yet, with ACTIVITY_SHARD_ID_RANGE ids per shard: the first
+ * 'writeActivityShards()' writes every shard (the directory is created if it doesn't exist).
+ *
+ * Preconditions:
+ * - 'directory != NULL'
+ *
+ * Postconditions:
+ * - Returns the sharded directory, NULL if memory allocation fails
+ *
+ * Side Effects:
+ * - Allocates memory
+ */
+ActivityShards newActivityShards(const char* directory);
+
+/*
+ * writeActivityShards
+ *
+ * Syntactic Specification:
+ * int writeActivityShards(ActivityShards shards, Activity* activities, int count, int* writtenCount);
+ *
+ * Semantic Specification:
+ * Saves the activities to the sharded directory: the ids are split in ranges of the same number of ids,
+ * shard n holding the ids from n * range + 1 to (n + 1) * range (the ids lower than 1 in shard 0), and
+ * every shard that isn't empty is a binary snapshot (see 'writeActivitiesSnapshot()') named
+ * "shard_<n>.bin". The manifest ACTIVITY_SHARDS_MANIFEST is a text file:
+ * - a line with ACTIVITY_SHARDS_MAGIC and the version, a line with the number of ids of a shard and a
+ *   line with the number of shards
+ * - a line per shard, by increasing n: n, first and last id of its range, number of activities, file name
+ * Only the shards that have changed since the last save are written: the ones with a dirty activity (see
+ * 'isActivityDirty()'), with a different number of activities (an activity removed) or new. Every shard
+ * is replaced only when complete, then the manifest; the files of the shards that became empty are
+ * removed after it. Then every activity is clean.
+ *
+ * Preconditions:
+ * - 'shards != NULL', 'writtenCount != NULL'
+ * - 'activities' has 'count' activities sorted by id, all the activities of the container
+ *
+ * Postconditions:
+ * - Returns 0 on success: '*writtenCount' is the number of shards written
+ * - Returns 1 if the directory, a shard or the manifest can't be written, or memory allocation fails:
+ *   the manifest keeps its previous content (with the shards it lists), the activities keep their dirty bit
+ *
+ * Side Effects:
+ * - Creation of the directory, writing and removal of files
+ * - Modifies the sharded directory and the dirty bit of the activities
+ */
+int writeActivityShards(ActivityShards shards, Activity* activities, int count, int* writtenCount);
+
+/*
+ * readActivityShards
+ *
+ * Syntactic Specification:
+ * ActivityShards readActivityShards(const char* directory, Activity** activities, int* count);
+ *
+ * Semantic Specification:
+ * Reads the manifest of a sharded directory (see 'writeActivityShards()') and then its shards on several
+ * threads, one per online processor (at most ACTIVITY_SHARDS_MAX_THREADS and one per shard), each thread
+ * reading whole shards. The shards are joined in the order of the manifest: since they cover ranges of
+ * increasing ids, the activities are sorted by id. Every activity is clean.
+ *
+ * Preconditions:
+ * - 'directory != NULL', 'activities != NULL', 'count != NULL'
+ *
+ * Postconditions:
+ * - Returns the sharded directory: '*activities' is a new array with the '*count' activities (the caller
+ *   deallocates the array and owns the activities)
+ * - Returns NULL if the manifest or a shard can't be read or is not valid, or memory allocation fails:
+ *   '*activities' is NULL and '*count' is 0
+ *
+ * Side Effects:
+ * - Reading from files
+ * - Allocates memory
+ * - May create and join threads
+ */
+ActivityShards readActivityShards(const char* directory, Activity** activities, int* count);
+
+/*
+ * getActivityShardsDirectory
+ *
+ * Syntactic Specification:
+ * const char* getActivityShardsDirectory(ActivityShards shards);
+ *
+ * Semantic Specification:
+ * Returns the name of the directory of the shards.
+ *
+ * Preconditions:
+ * - None
+ *
+ * Postconditions:
+ * - Returns the directory name, NULL if 'shards == NULL'
+ *
+ * Side Effects:
+ * - None
+ */
+const char* getActivityShardsDirectory(ActivityShards shards);
+
+/*
+ * verifyActivityShards
+ *
+ * Syntactic Specification:
+ * int verifyActivityShards(const char* directory);
+ *
+ * Semantic Specification:
+ * Checks a sharded directory against its checksum files, without reading the activities: first the
+ * manifest, then every shard it lists (see 'verifyActivityChecksums()').
+ *
+ * Preconditions:
+ * - None
+ *
+ * Postconditions:
+ * - Returns 0 if the manifest and every shard are intact
+ * - Returns 1 if a file is damaged, can't be read or has no valid checksum file, or memory allocation fails
+ *
+ * Side Effects:
+ * - Reading from files
+ * - Output to stdout (damaged blocks and result of every file)
+ */
+int verifyActivityShards(const char* directory);
+
+/*
+ * deleteActivityShards
+ *
+ * Syntactic Specification:
+ * void deleteActivityShards(ActivityShards* shards);
+ *
+ * Semantic Specification:
+ * Deallocates the sharded directory (its files are not modified). The parameter is a pointer passed by reference.
+ *
+ * Preconditions:
+ * - 'shards' can be NULL or point to a valid/NULL pointer
+ *
+ * Postconditions:
+ * - '*shards' is set to NULL
+ *
+ * Side Effects:
+ * - Deallocates memory
+ */
+void deleteActivityShards(ActivityShards* shards);
+
+#endif // ACTIVITIES_CONTAINER_SHARDS_H          // End of inclusion block
@@ -0,0 +1,450 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <sys/stat.h>
+#include "activity.h"
+#include "activities_container_snapshot.h"
+#include "activities_container_writer.h"
+
+// Byte order mark of the header: read back with another value, the snapshot comes from a machine with a different byte order
+#define ACTIVITY_SNAPSHOT_BYTE_ORDER_MARK 0x01020304u
+// Offset of a NULL string in the string columns
+#define ACTIVITY_SNAPSHOT_NULL_STRING UINT64_MAX
+// Number of string columns (name, description, course)
+#define ACTIVITY_SNAPSHOT_STRING_COLUMNS 3
+// Bytes of the columns for one activity: id, 3 dates, 2 times, priority, 3 string offsets
+#define ACTIVITY_SNAPSHOT_RECORD_SIZE (4 + 3 * 8 + 2 * 4 + 2 + ACTIVITY_SNAPSHOT_STRING_COLUMNS * 8)
+
+
+/*
+ * "struct snapshotHeader" Documentation
+ *
+ * Syntactic Specification:
+ * typedef struct snapshotHeader {
+ *     char magic[8];
+ *     uint32_t version;
+ *     uint32_t byteOrderMark;
+ *     uint64_t count;
+ *     uint64_t stringTableSize;
+ * } SnapshotHeader;
+ *
+ * Semantic Specification:
+ * Header at the beginning of a binary snapshot (32 bytes, no padding).
+ *
+ * Fields:
+ * - magic: ACTIVITY_SNAPSHOT_MAGIC, terminated by '\0'
+ * - version: ACTIVITY_SNAPSHOT_VERSION
+ * - byteOrderMark: ACTIVITY_SNAPSHOT_BYTE_ORDER_MARK
+ * - count: Number of activities (number of values of each column)
+ * - stringTableSize: Number of bytes of the string table
+ */
+typedef struct snapshotHeader {
+	char magic[8];
+	uint32_t version;
+	uint32_t byteOrderMark;
+	uint64_t count;
+	uint64_t stringTableSize;
+} SnapshotHeader;
+
+
+
+/*
+ * countSnapshotTreeNodes
+ *
+ * Syntactic Specification:
+ * size_t countSnapshotTreeNodes(TreeNode root);
+ *
+ * Semantic Specification:
+ * Counts the nodes of the tree.
+ *
+ * Preconditions:
+ * - None
+ *
+ * Postconditions:
+ * - Returns the number of nodes (0 if 'root == NULL')
+ *
+ * Side Effects:
+ * - None
+ */
+size_t countSnapshotTreeNodes(TreeNode root) {
+	if (root == NULL) return 0;
+
+	return 1 + countSnapshotTreeNodes(getLeftNode(root)) + countSnapshotTreeNodes(getRightNode(root));
+}
+
+/*
+ * collectSnapshotActivities
+ *
+ * Syntactic Specification:
+ * void collectSnapshotActivities(TreeNode root, Activity* activities, size_t* index);
+ *
+ * Semantic Specification:
+ * Visits the tree in order and stores its activities in the array (in id order) starting from '*index'.
+ *
+ * Preconditions:
+ * - 'activities' has room for all the nodes of the tree after '*index'
+ *
+ * Postconditions:
+ * - The activities are stored and '*index' is advanced by their number
+ *
+ * Side Effects:
+ * - Modifies the array and '*index'
+ */
+void collectSnapshotActivities(TreeNode root, Activity* activities, size_t* index) {
+	if (root == NULL) return;
+
+	collectSnapshotActivities(getLeftNode(root), activities, index);
+	activities[(*index)++] = getActivityFromNode(root);
+	collectSnapshotActivities(getRightNode(root), activities, index);
+}
+
+/*
+ * getSnapshotString
+ *
+ * Syntactic Specification:
+ * char* getSnapshotString(Activity a, int column);
+ *
+ * Semantic Specification:
+ * Returns the string field of the activity stored in a string column (0 name, 1 description, 2 course).
+ *
+ * Preconditions:
+ * - 'a != NULL', '0 <= column < ACTIVITY_SNAPSHOT_STRING_COLUMNS'
+ *
+ * Postconditions:
+ * - Returns the string (can be NULL)
+ *
+ * Side Effects:
+ * - None
+ */
+char* getSnapshotString(Activity a, int column) {
+	switch (column) {
+		case 0: return getActivityName(a);
+		case 1: return getActivityDescr(a);
+		default: return getActivityCourse(a);
+	}
+}
+
+/*
+ * writeSnapshotColumn
+ *
+ * Syntactic Specification:
+ * void writeSnapshotColumn(ActivityWriter writer, const void* column, size_t width, size_t count);
+ *
+ * Semantic Specification:
+ * Writes a column of 'count' values of 'width' bytes with a single call.
+ *
+ * Preconditions:
+ * - 'writer != NULL', 'column' has 'count' values
+ *
+ * Postconditions:
+ * - The column follows the previous data (a failed write is reported by 'commitActivityWriter()')
+ *
+ * Side Effects:
+ * - Writing to file
+ */
+void writeSnapshotColumn(ActivityWriter writer, const void* column, size_t width, size_t count) {
+	writeBytesToActivityWriter(writer, column, width * count);
+}
+
+/*
+ * readSnapshotColumn
+ *
+ * Syntactic Specification:
+ * void* readSnapshotColumn(FILE* file, size_t width, size_t count);
+ *
+ * Semantic Specification:
+ * Reads a column of 'count' values of 'width' bytes with a single read into a new array.
+ *
+ * Preconditions:
+ * - 'file' opened for reading
+ *
+ * Postconditions:
+ * - Returns the new array (at least one byte is allocated, also when 'count == 0')
+ * - Returns NULL if memory allocation or the read fails
+ *
+ * Side Effects:
+ * - Reading from file
+ * - Allocates memory
+ */
+void* readSnapshotColumn(FILE* file, size_t width, size_t count) {
+	void* column = malloc((count > 0) ? width * count : 1);
+	if (column == NULL) return NULL;
+
+	if (fread(column, width, count, file) != count) {
+		free(column);
+		return NULL;
+	}
+
+	return column;
+}
+
+/*
+ * writeActivitiesSnapshot
+ *
+ * Syntactic Specification:
+ * int writeActivitiesSnapshot(ActivityWriter writer, TreeNode root);
+ *
+ * Semantic Specification:
+ * Writes the activities of the tree (in id order) with a writer in the binary snapshot format:
+ * - a header: magic (8 bytes), version (32 bit), byte order mark (32 bit, 0x01020304), number of
+ *   activities and size of the string table (64 bit)
+ * - one column per numeric field, with fixed width values: id (32 bit), insert, expiry and completion
+ *   date (64 bit), total and used time (32 bit), priority (16 bit)
+ * - one column per string field (name, description, course) with the offsets (64 bit) of the strings
+ *   in the string table (UINT64_MAX for a NULL string)
+ * - the string table: the strings, each terminated by '\0'
+ * The numbers are in the byte order of the machine (checked by the reader with the byte order mark),
+ * so each column is written and read with a single call.
+ *
+ * Preconditions:
+ * - 'writer' created by 'newActivityWriter()' (the file is replaced by 'commitActivityWriter()')
+ *
+ * Postconditions:
+ * - Returns 0 if the snapshot has been passed to the writer (a failed write is reported by 'commitActivityWriter()')
+ * - Returns 1 if 'writer == NULL' or memory allocation fails
+ *
+ * Side Effects:
+ * - Writing to file
+ * - Allocates and deallocates the columns
+ */
+int writeActivitiesSnapshot(ActivityWriter writer, TreeNode root) {
+	if (writer == NULL) return 1;
+
+	size_t count = countSnapshotTreeNodes(root);
+	Activity* activities = malloc((count > 0 ? count : 1) * sizeof(Activity));
+	if (activities == NULL) return 1;
+
+	size_t index = 0;
+	collectSnapshotActivities(root, activities, &index);
+
+	int writeResult = writeActivitiesSnapshotOfArray(writer, activities, count);
+	free(activities);
+	return writeResult;
+}
+
+/*
+ * writeActivitiesSnapshotOfArray
+ *
+ * Syntactic Specification:
+ * int writeActivitiesSnapshotOfArray(ActivityWriter writer, Activity* activities, size_t count);
+ *
+ * Semantic Specification:
+ * Writes the activities of an array, in its order, with a writer in the binary snapshot format (see
+ * 'writeActivitiesSnapshot()'): a part of the activities of a container can be written without a tree.
+ *
+ * Preconditions:
+ * - 'writer' created by 'newActivityWriter()' (the file is replaced by 'commitActivityWriter()')
+ * - 'activities' has 'count' activities (not NULL), sorted by id to be read back as a snapshot of a tree
+ *
+ * Postconditions:
+ * - Returns 0 if the snapshot has been passed to the writer (a failed write is reported by 'commitActivityWriter()')
+ * - Returns 1 if 'writer == NULL' or memory allocation fails
+ *
+ * Side Effects:
+ * - Writing to file
+ * - Allocates and deallocates the columns
+ */
+int writeActivitiesSnapshotOfArray(ActivityWriter writer, Activity* activities, size_t count) {
+	if (writer == NULL) return 1;
+
+	// one buffer, reused for every column (the widest values have 8 bytes)
+	void* column = malloc((count > 0 ? count : 1) * sizeof(uint64_t));
+	if (column == NULL) return 1;
+
+	SnapshotHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, ACTIVITY_SNAPSHOT_MAGIC, sizeof(ACTIVITY_SNAPSHOT_MAGIC));
+	header.version = ACTIVITY_SNAPSHOT_VERSION;
+	header.byteOrderMark = ACTIVITY_SNAPSHOT_BYTE_ORDER_MARK;
+	header.count = count;
+	for (int c = 0; c < ACTIVITY_SNAPSHOT_STRING_COLUMNS; c++) {
+		for (size_t i = 0; i < count; i++) {
+			char* str = getSnapshotString(activities[i], c);
+			if (str != NULL) header.stringTableSize += strlen(str) + 1;
+			// a description that can't be read from its file would be saved as NULL
+			if (c == 1 && !isActivityDescrLoaded(activities[i])) failActivityWriter(writer);
+		}
+	}
+
+	writeBytesToActivityWriter(writer, &header, sizeof(header));
+
+	int32_t* ids = column;
+	for (size_t i = 0; i < count; i++) ids[i] = getActivityId(activities[i]);
+	writeSnapshotColumn(writer, ids, sizeof(int32_t), count);
+
+	int64_t* dates = column;
+	for (size_t i = 0; i < count; i++) dates[i] = getActivityInsertDate(activities[i]);
+	writeSnapshotColumn(writer, dates, sizeof(int64_t), count);
+	for (size_t i = 0; i < count; i++) dates[i] = getActivityExpiryDate(activities[i]);
+	writeSnapshotColumn(writer, dates, sizeof(int64_t), count);
+	for (size_t i = 0; i < count; i++) dates[i] = getActivityCompletionDate(activities[i]);
+	writeSnapshotColumn(writer, dates, sizeof(int64_t), count);
+
+	uint32_t* times = column;
+	for (size_t i = 0; i < count; i++) times[i] = getActivityTotalTime(activities[i]);
+	writeSnapshotColumn(writer, times, sizeof(uint32_t), count);
+	for (size_t i = 0; i < count; i++) times[i] = getActivityUsedTime(activities[i]);
+	writeSnapshotColumn(writer, times, sizeof(uint32_t), count);
+
+	uint16_t* priorities = column;
+	for (size_t i = 0; i < count; i++) priorities[i] = getActivityPriority(activities[i]);
+	writeSnapshotColumn(writer, priorities, sizeof(uint16_t), count);
+
+	// the string table has all the names, then all the descriptions, then all the courses
+	uint64_t* offsets = column;
+	uint64_t offset = 0;
+	for (int c = 0; c < ACTIVITY_SNAPSHOT_STRING_COLUMNS; c++) {
+		for (size_t i = 0; i < count; i++) {
+			char* str = getSnapshotString(activities[i], c);
+			if (str == NULL) {
+				offsets[i] = ACTIVITY_SNAPSHOT_NULL_STRING;
+			} else {
+				offsets[i] = offset;
+				offset += strlen(str) + 1;
+			}
+		}
+		writeSnapshotColumn(writer, offsets, sizeof(uint64_t), count);
+	}
+
+	for (int c = 0; c < ACTIVITY_SNAPSHOT_STRING_COLUMNS; c++) {
+		for (size_t i = 0; i < count; i++) {
+			char* str = getSnapshotString(activities[i], c);
+			if (str != NULL) writeSnapshotColumn(writer, str, 1, strlen(str) + 1);
+		}
+	}
+
+	free(column);
+	return 0;
+}
+
+/*
+ * readActivitiesSnapshot
+ *
+ * Syntactic Specification:
+ * int readActivitiesSnapshot(FILE* file, Activity** activities, int* count);
+ *
+ * Semantic Specification:
+ * Reads a binary snapshot (see 'writeActivitiesSnapshot()') with one read per column and creates its
+ * activities, with no parsing of the fields. Header, size of the file and offsets are checked first.
+ *
+ * Preconditions:
+ * - 'file' opened for reading in binary mode, at the beginning of the snapshot
+ * - 'activities != NULL', 'count != NULL'
+ *
+ * Postconditions:
+ * - Returns 0 if the snapshot is valid: '*activities' is a new array with the '*count' activities in
+ *   file order (the caller deallocates the array and owns the activities)
+ * - Returns 1 if the file is not a valid snapshot (of this version and byte order) or memory allocation
+ *   fails: '*activities' is NULL and '*count' is 0
+ *
+ * Side Effects:
+ * - Reading from file
+ * - Allocates memory
+ */
+int readActivitiesSnapshot(FILE* file, Activity** activities, int* count) {
+	if (activities == NULL || count == NULL) return 1;
+	*activities = NULL;
+	*count = 0;
+	if (file == NULL) return 1;
+
+	SnapshotHeader header;
+	if (fread(&header, sizeof(header), 1, file) != 1) return 1;
+	if (memcmp(header.magic, ACTIVITY_SNAPSHOT_MAGIC, sizeof(ACTIVITY_SNAPSHOT_MAGIC)) != 0 ||
+		 header.version != ACTIVITY_SNAPSHOT_VERSION || header.byteOrderMark != ACTIVITY_SNAPSHOT_BYTE_ORDER_MARK ||
+		 header.count > INT_MAX || header.stringTableSize > (uint64_t)SIZE_MAX - 1) {
+		return 1;
+	}
+
+	// the size of the file must be exactly the one described by the header
+	struct stat fileInfo;
+	uint64_t expectedSize = sizeof(header) + header.count * ACTIVITY_SNAPSHOT_RECORD_SIZE;
+	if (fstat(fileno(file), &fileInfo) != 0 || (uint64_t)fileInfo.st_size < expectedSize ||
+		 (uint64_t)fileInfo.st_size - expectedSize != header.stringTableSize) {
+		return 1;
+	}
+
+	size_t n = (size_t)header.count;
+	int32_t* ids = readSnapshotColumn(file, sizeof(int32_t), n);
+	int64_t* insertDates = readSnapshotColumn(file, sizeof(int64_t), n);
+	int64_t* expiryDates = readSnapshotColumn(file, sizeof(int64_t), n);
+	int64_t* completionDates = readSnapshotColumn(file, sizeof(int64_t), n);
+	uint32_t* totalTimes = readSnapshotColumn(file, sizeof(uint32_t), n);
+	uint32_t* usedTimes = readSnapshotColumn(file, sizeof(uint32_t), n);
+	uint16_t* priorities = readSnapshotColumn(file, sizeof(uint16_t), n);
+	uint64_t* offsets[ACTIVITY_SNAPSHOT_STRING_COLUMNS];
+	for (int c = 0; c < ACTIVITY_SNAPSHOT_STRING_COLUMNS; c++) {
+		offsets[c] = readSnapshotColumn(file, sizeof(uint64_t), n);
+	}
+	// one more byte: the table is terminated also if its last string is not
+	char* table = malloc((size_t)header.stringTableSize + 1);
+	if (table != NULL && fread(table, 1, (size_t)header.stringTableSize, file) != header.stringTableSize) {
+		free(table);
+		table = NULL;
+	}
+	Activity* result = malloc((n > 0 ? n : 1) * sizeof(Activity));
+
+	int error = (ids == NULL || insertDates == NULL || expiryDates == NULL || completionDates == NULL ||
+					 totalTimes == NULL || usedTimes == NULL || priorities == NULL || table == NULL || result == NULL);
+	for (int c = 0; c < ACTIVITY_SNAPSHOT_STRING_COLUMNS; c++) {
+		if (offsets[c] == NULL) error = 1;
+	}
+
+	for (int c = 0; c < ACTIVITY_SNAPSHOT_STRING_COLUMNS && !error; c++) {
+		for (size_t i = 0; i < n; i++) {
+			if (offsets[c][i] != ACTIVITY_SNAPSHOT_NULL_STRING && offsets[c][i] >= header.stringTableSize) {
+				error = 1;
+				break;
+			}
+		}
+	}
+
+	size_t created = 0;
+	if (!error) {
+		table[header.stringTableSize] = '\0';
+
+		char* strings[ACTIVITY_SNAPSHOT_STRING_COLUMNS];
+		for (; created < n; created++) {
+			for (int c = 0; c < ACTIVITY_SNAPSHOT_STRING_COLUMNS; c++) {
+				uint64_t offset = offsets[c][created];
+				strings[c] = (offset == ACTIVITY_SNAPSHOT_NULL_STRING) ? NULL : table + offset;
+			}
+
+			result[created] = newActivity(ids[created], strings[0], strings[1], strings[2],
+														(time_t)insertDates[created], (time_t)expiryDates[created],
+														(time_t)completionDates[created], totalTimes[created],
+														usedTimes[created], priorities[created]);
+			if (result[created] == NULL) {
+				error = 1;
+				break;
+			}
+		}
+	}
+
+	if (error && result != NULL) {
+		for (size_t i = 0; i < created; i++) {
+			deleteActivity(result[i]);
+		}
+		free(result);
+		result = NULL;
+	}
+
+	free(ids);
+	free(insertDates);
+	free(expiryDates);
+	free(completionDates);
+	free(totalTimes);
+	free(usedTimes);
+	free(priorities);
+	for (int c = 0; c < ACTIVITY_SNAPSHOT_STRING_COLUMNS; c++) {
+		free(offsets[c]);
+	}
+	free(table);
+
+	if (error) return 1;
+
+	*activities = result;
+	*count = (int)n;
+	return 0;
+}
@@ -0,0 +1,95 @@
+#ifndef ACTIVITIES_CONTAINER_SNAPSHOT_H             // Start of inclusion block
+#define ACTIVITIES_CONTAINER_SNAPSHOT_H             // Macro definition to avoid multiple inclusions
+
+#include <stdio.h>
+#include "activities_container_avl.h"
+#include "activities_container_writer.h"
+
+// First bytes of a binary snapshot file
+#define ACTIVITY_SNAPSHOT_MAGIC "PSDSNAP"
+// Version of the snapshot format written by 'writeActivitiesSnapshot()'
+#define ACTIVITY_SNAPSHOT_VERSION 1
+
+
+/*
+ * writeActivitiesSnapshot
+ *
+ * Syntactic Specification:
+ * int writeActivitiesSnapshot(ActivityWriter writer, TreeNode root);
+ *
+ * Semantic Specification:
+ * Writes the activities of the tree (in id order) with a writer in the binary snapshot format:
+ * - a header: magic (8 bytes), version (32 bit), byte order mark (32 bit, 0x01020304), number of
+ *   activities and size of the string table (64 bit)
+ * - one column per numeric field, with fixed width values: id (32 bit), insert, expiry and completion
+ *   date (64 bit), total and used time (32 bit), priority (16 bit)
+ * - one column per string field (name, description, course) with the offsets (64 bit) of the strings
+ *   in the string table (UINT64_MAX for a NULL string)
+ * - the string table: the strings, each terminated by '\0'
+ * The numbers are in the byte order of the machine (checked by the reader with the byte order mark),
+ * so each column is written and read with a single call.
+ *
+ * Preconditions:
+ * - 'writer' created by 'newActivityWriter()' (the file is replaced by 'commitActivityWriter()')
+ *
+ * Postconditions:
+ * - Returns 0 if the snapshot has been passed to the writer (a failed write is reported by 'commitActivityWriter()')
+ * - Returns 1 if 'writer == NULL' or memory allocation fails
+ *
+ * Side Effects:
+ * - Writing to file
+ * - Allocates and deallocates the columns
+ */
+int writeActivitiesSnapshot(ActivityWriter writer, TreeNode root);
+
+/*
+ * writeActivitiesSnapshotOfArray
+ *
+ * Syntactic Specification:
+ * int writeActivitiesSnapshotOfArray(ActivityWriter writer, Activity* activities, size_t count);
+ *
+ * Semantic Specification:
+ * Writes the activities of an array, in its order, with a writer in the binary snapshot format (see
+ * 'writeActivitiesSnapshot()'): a part of the activities of a container can be written without a tree.
+ *
+ * Preconditions:
+ * - 'writer' created by 'newActivityWriter()' (the file is replaced by 'commitActivityWriter()')
+ * - 'activities' has 'count' activities (not NULL), sorted by id to be read back as a snapshot of a tree
+ *
+ * Postconditions:
+ * - Returns 0 if the snapshot has been passed to the writer (a failed write is reported by 'commitActivityWriter()')
+ * - Returns 1 if 'writer == NULL' or memory allocation fails
+ *
+ * Side Effects:
+ * - Writing to file
+ * - Allocates and deallocates the columns
+ */
+int writeActivitiesSnapshotOfArray(ActivityWriter writer, Activity* activities, size_t count);
+
+/*
+ * readActivitiesSnapshot
+ *
+ * Syntactic Specification:
+ * int readActivitiesSnapshot(FILE* file, Activity** activities, int* count);
+ *
+ * Semantic Specification:
+ * Reads a binary snapshot (see 'writeActivitiesSnapshot()') with one read per column and creates its
+ * activities, with no parsing of the fields. Header, size of the file and offsets are checked first.
+ *
+ * Preconditions:
+ * - 'file' opened for reading in binary mode, at the beginning of the snapshot
+ * - 'activities != NULL', 'count != NULL'
+ *
+ * Postconditions:
+ * - Returns 0 if the snapshot is valid: '*activities' is a new array with the '*count' activities in
+ *   file order (the caller deallocates the array and owns the activities)
+ * - Returns 1 if the file is not a valid snapshot (of this version and byte order) or memory allocation
+ *   fails: '*activities' is NULL and '*count' is 0
+ *
+ * Side Effects:
+ * - Reading from file
+ * - Allocates memory
+ */
+int readActivitiesSnapshot(FILE* file, Activity** activities, int* count);
+
+#endif // ACTIVITIES_CONTAINER_SNAPSHOT_H          // End of inclusion block
@@ -0,0 +1,591 @@
+#include <stdlib.h>
+#include "activity.h"
+#include "activity_helper.h"
+#include "activities_container_sorted_view.h"
+
+
+/*
+ * "struct viewNode" Documentation
+ *
+ * Syntactic Specification:
+ * typedef struct viewNode {
+ *     Activity activity;
+ *     struct viewNode* left;
+ *     struct viewNode* right;
+ *     int height;
+ * } ViewNode;
+ *
+ * Semantic Specification:
+ * Node of the AVL tree of a sorted view. The activity is not owned by the view.
+ *
+ * Fields:
+ * - activity: The activity (never NULL)
+ * - left, right: Subtrees with the activities before and after this one in the view order
+ * - height: Height of the subtree rooted at this node (1 for a leaf)
+ */
+typedef struct viewNode {
+	Activity activity;
+	struct viewNode* left;
+	struct viewNode* right;
+	int height;
+} ViewNode;
+
+
+/*
+ * "struct sortedView" Documentation
+ *
+ * Syntactic Specification:
+ * struct sortedView {
+ *     int sortBy;
+ *     ViewNode* root;
+ *     int size;
+ * };
+ *
+ * Semantic Specification:
+ * The activities of a container ordered by one criterion of 'compareActivityBy()', then by id.
+ *
+ * Fields:
+ * - sortBy: Sorting criterion of the view
+ * - root: Root of the AVL tree (NULL if the view is empty)
+ * - size: Number of activities in the view
+ */
+struct sortedView {
+	int sortBy;
+	ViewNode* root;
+	int size;
+};
+
+
+
+/*
+ * compareSortedViewActivities
+ *
+ * Syntactic Specification:
+ * int compareSortedViewActivities(Activity a, Activity b, int sortBy);
+ *
+ * Semantic Specification:
+ * Key of the view tree: compares two activities by the criterion 'sortBy' and, when they are equivalent, by id.
+ *
+ * Preconditions:
+ * - 'a != NULL', 'b != NULL'
+ *
+ * Postconditions:
+ * - Returns a negative value, 0 or a positive value if 'a' comes before, in the same position or after 'b'
+ *
+ * Side Effects:
+ * - None
+ */
+int compareSortedViewActivities(Activity a, Activity b, int sortBy) {
+	int cmp = compareActivityBy(a, b, sortBy);
+	if (cmp == 0) cmp = compareActivityById(a, b);
+
+	return cmp;
+}
+
+/*
+ * getViewNodeHeight
+ *
+ * Syntactic Specification:
+ * int getViewNodeHeight(ViewNode* node);
+ *
+ * Semantic Specification:
+ * Returns the height of the subtree rooted at 'node'.
+ *
+ * Preconditions:
+ * - None
+ *
+ * Postconditions:
+ * - Returns 0 if 'node == NULL', its height otherwise
+ *
+ * Side Effects:
+ * - None
+ */
+int getViewNodeHeight(ViewNode* node) {
+	return (node != NULL) ? node->height : 0;
+}
+
+/*
+ * updateViewNodeHeight
+ *
+ * Syntactic Specification:
+ * void updateViewNodeHeight(ViewNode* node);
+ *
+ * Semantic Specification:
+ * Recomputes the height of the node from the heights of its children.
+ *
+ * Preconditions:
+ * - 'node != NULL'
+ *
+ * Postconditions:
+ * - 'node->height' is 1 + the height of the higher child
+ *
+ * Side Effects:
+ * - Modifies the node
+ */
+void updateViewNodeHeight(ViewNode* node) {
+	node->height = 1 + max( getViewNodeHeight(node->left), getViewNodeHeight(node->right) );
+}
+
+/*
+ * rotateViewNodeRight
+ *
+ * Syntactic Specification:
+ * ViewNode* rotateViewNodeRight(ViewNode* node);
+ *
+ * Semantic Specification:
+ * Right rotation of the subtree rooted at 'node' (its left child becomes the root).
+ *
+ * Preconditions:
+ * - 'node != NULL', 'node->left != NULL'
+ *
+ * Postconditions:
+ * - Returns the new root of the subtree, heights are updated
+ *
+ * Side Effects:
+ * - Modifies the subtree
+ */
+ViewNode* rotateViewNodeRight(ViewNode* node) {
+	ViewNode* newRoot = node->left;
+
+	node->left = newRoot->right;
+	newRoot->right = node;
+	updateViewNodeHeight(node);
+	updateViewNodeHeight(newRoot);
+
+	return newRoot;
+}
+
+/*
+ * rotateViewNodeLeft
+ *
+ * Syntactic Specification:
+ * ViewNode* rotateViewNodeLeft(ViewNode* node);
+ *
+ * Semantic Specification:
+ * Left rotation of the subtree rooted at 'node' (its right child becomes the root).
+ *
+ * Preconditions:
+ * - 'node != NULL', 'node->right != NULL'
+ *
+ * Postconditions:
+ * - Returns the new root of the subtree, heights are updated
+ *
+ * Side Effects:
+ * - Modifies the subtree
+ */
+ViewNode* rotateViewNodeLeft(ViewNode* node) {
+	ViewNode* newRoot = node->right;
+
+	node->right = newRoot->left;
+	newRoot->left = node;
+	updateViewNodeHeight(node);
+	updateViewNodeHeight(newRoot);
+
+	return newRoot;
+}
+
+/*
+ * rebalanceViewNode
+ *
+ * Syntactic Specification:
+ * ViewNode* rebalanceViewNode(ViewNode* node);
+ *
+ * Semantic Specification:
+ * Updates the height of the node and restores the AVL balance of its subtree (after an insertion
+ * or a removal in one of its children) with one or two rotations.
+ *
+ * Preconditions:
+ * - 'node != NULL', its children are balanced and their heights differ by at most 2
+ *
+ * Postconditions:
+ * - Returns the new (balanced) root of the subtree
+ *
+ * Side Effects:
+ * - Modifies the subtree
+ */
+ViewNode* rebalanceViewNode(ViewNode* node) {
+	updateViewNodeHeight(node);
+	int balance = getViewNodeHeight(node->left) - getViewNodeHeight(node->right);
+
+	if (balance > 1) {
+		if (getViewNodeHeight(node->left->left) < getViewNodeHeight(node->left->right)) {
+			node->left = rotateViewNodeLeft(node->left); // Case "LR"
+		}
+		return rotateViewNodeRight(node); // Case "LL"
+	}
+
+	if (balance < -1) {
+		if (getViewNodeHeight(node->right->right) < getViewNodeHeight(node->right->left)) {
+			node->right = rotateViewNodeRight(node->right); // Case "RL"
+		}
+		return rotateViewNodeLeft(node); // Case "RR"
+	}
+
+	return node;
+}
+
+/*
+ * insertViewNode
+ *
+ * Syntactic Specification:
+ * ViewNode* insertViewNode(ViewNode* node, Activity activity, int sortBy, int* result);
+ *
+ * Semantic Specification:
+ * Recursively inserts the activity in the subtree (AVL insertion keyed by (criterion, id)).
+ *
+ * Preconditions:
+ * - 'activity != NULL', 'result != NULL'
+ *
+ * Postconditions:
+ * - Returns the new root of the subtree
+ * - '*result' is 0 if the activity has been inserted, 1 if its position is taken or allocation fails
+ *
+ * Side Effects:
+ * - Allocates memory and modifies the subtree
+ */
+ViewNode* insertViewNode(ViewNode* node, Activity activity, int sortBy, int* result) {
+	if (node == NULL) {
+		ViewNode* newNode = (ViewNode*)malloc(sizeof(ViewNode));
+		if (newNode == NULL) {
+			*result = 1;
+			return NULL;
+		}
+		newNode->activity = activity;
+		newNode->left = NULL;
+		newNode->right = NULL;
+		newNode->height = 1;
+		*result = 0;
+		return newNode;
+	}
+
+	int cmp = compareSortedViewActivities(activity, node->activity, sortBy);
+	if (cmp < 0) {
+		node->left = insertViewNode(node->left, activity, sortBy, result);
+	} else if (cmp > 0) {
+		node->right = insertViewNode(node->right, activity, sortBy, result);
+	} else {
+		*result = 1;
+		return node;
+	}
+
+	return (*result == 0) ? rebalanceViewNode(node) : node;
+}
+
+/*
+ * removeViewNode
+ *
+ * Syntactic Specification:
+ * ViewNode* removeViewNode(ViewNode* node, Activity activity, int sortBy, int* result);
+ *
+ * Semantic Specification:
+ * Recursively removes the node of the activity from the subtree (AVL deletion keyed by (criterion, id)).
+ * A node with two children takes the activity of its in-order successor, whose node is removed instead.
+ *
+ * Preconditions:
+ * - 'activity != NULL', 'result != NULL'
+ *
+ * Postconditions:
+ * - Returns the new root of the subtree
+ * - '*result' is 0 if the activity has been removed, 1 if it was not found
+ *
+ * Side Effects:
+ * - Deallocates memory and modifies the subtree
+ */
+ViewNode* removeViewNode(ViewNode* node, Activity activity, int sortBy, int* result) {
+	if (node == NULL) {
+		*result = 1;
+		return NULL;
+	}
+
+	int cmp = compareSortedViewActivities(activity, node->activity, sortBy);
+	if (cmp < 0) {
+		node->left = removeViewNode(node->left, activity, sortBy, result);
+	} else if (cmp > 0) {
+		node->right = removeViewNode(node->right, activity, sortBy, result);
+	} else if (node->left == NULL || node->right == NULL) {
+		ViewNode* child = (node->left != NULL) ? node->left : node->right;
+		free(node);
+		*result = 0;
+		return child;
+	} else {
+		ViewNode* successor = node->right;
+		while (successor->left != NULL) {
+			successor = successor->left;
+		}
+		node->activity = successor->activity;
+		node->right = removeViewNode(node->right, successor->activity, sortBy, result);
+	}
+
+	return (*result == 0) ? rebalanceViewNode(node) : node;
+}
+
+/*
+ * deleteViewNodes
+ *
+ * Syntactic Specification:
+ * void deleteViewNodes(ViewNode* node);
+ *
+ * Semantic Specification:
+ * Deallocates all the nodes of the subtree (not the activities).
+ *
+ * Preconditions:
+ * - None
+ *
+ * Postconditions:
+ * - The nodes are freed
+ *
+ * Side Effects:
+ * - Deallocates memory
+ */
+void deleteViewNodes(ViewNode* node) {
+	if (node == NULL) return;
+
+	deleteViewNodes(node->left);
+	deleteViewNodes(node->right);
+	free(node);
+}
+
+/*
+ * inOrderLoadSortedView
+ *
+ * Syntactic Specification:
+ * int inOrderLoadSortedView(SortedView view, TreeNode root);
+ *
+ * Semantic Specification:
+ * Recursively adds the activities of the (id) tree to the view.
+ *
+ * Preconditions:
+ * - 'view != NULL'
+ *
+ * Postconditions:
+ * - Returns 0 on success, 1 if an activity could not be added
+ *
+ * Side Effects:
+ * - Allocates memory and modifies the view
+ */
+int inOrderLoadSortedView(SortedView view, TreeNode root) {
+	if (root == NULL) return 0;
+
+	if (inOrderLoadSortedView(view, getLeftNode(root)) != 0) return 1;
+
+	Activity activity = getActivityFromNode(root);
+	if (activity != NULL && addActivityToSortedView(view, activity) != 0) return 1;
+
+	return inOrderLoadSortedView(view, getRightNode(root));
+}
+
+/*
+ * printViewNodesToFile
+ *
+ * Syntactic Specification:
+ * void printViewNodesToFile(ViewNode* node, FILE* file);
+ *
+ * Semantic Specification:
+ * Recursively prints the activities of the subtree in order (list format, one per line).
+ *
+ * Preconditions:
+ * - 'file' can be NULL (screen) or a file opened for writing
+ *
+ * Postconditions:
+ * - The activities are printed
+ *
+ * Side Effects:
+ * - Output to stdout or writing to file
+ */
+void printViewNodesToFile(ViewNode* node, FILE* file) {
+	if (node == NULL) return;
+
+	printViewNodesToFile(node->left, file);
+	printActivityForListToScreenOrFile(node->activity, file);
+	printViewNodesToFile(node->right, file);
+}
+
+
+
+/*
+ * newSortedView
+ *
+ * Syntactic Specification:
+ * SortedView newSortedView(int sortBy);
+ *
+ * Semantic Specification:
+ * Creates a new empty view ordered by the criterion 'sortBy' of 'compareActivityBy()' and then by id.
+ * The activities are kept in an AVL tree keyed by (criterion, id), so they can be added and removed
+ * one at a time in O(log n) and listed in order without sorting.
+ *
+ * Preconditions:
+ * - 'sortBy' should be a valid criterion (0-12); other values mean 0 (id)
+ *
+ * Postconditions:
+ * - Returns a new empty view
+ * - If allocation fails, returns 'NULL'
+ *
+ * Side Effects:
+ * - Allocates memory
+ */
+SortedView newSortedView(int sortBy) {
+	SortedView view = (SortedView)malloc(sizeof(struct sortedView));
+	if (view != NULL) {
+		view->sortBy = (sortBy >= 0 && sortBy < ACTIVITY_SORT_CRITERIA_COUNT) ? sortBy : 0;
+		view->root = NULL;
+		view->size = 0;
+	}
+
+	return view;
+}
+
+/*
+ * deleteSortedView
+ *
+ * Syntactic Specification:
+ * void deleteSortedView(SortedView* view);
+ *
+ * Semantic Specification:
+ * Deallocates the view (the activities are not deallocated). The parameter is a pointer passed by reference.
+ *
+ * Preconditions:
+ * - 'view' can be NULL or point to a valid/NULL pointer
+ *
+ * Postconditions:
+ * - All the memory of the view is freed and '*view' is set to NULL
+ *
+ * Side Effects:
+ * - Deallocates memory
+ */
+void deleteSortedView(SortedView* view) {
+	if (view == NULL || *view == NULL) return;
+
+	deleteViewNodes( (*view)->root );
+	free(*view);
+	*view = NULL;
+}
+
+/*
+ * getSortedViewSize
+ *
+ * Syntactic Specification:
+ * int getSortedViewSize(SortedView view);
+ *
+ * Semantic Specification:
+ * Returns the number of activities in the view.
+ *
+ * Preconditions:
+ * - None
+ *
+ * Postconditions:
+ * - Returns the number of activities (0 if 'view == NULL')
+ *
+ * Side Effects:
+ * - None
+ */
+int getSortedViewSize(SortedView view) {
+	return (view != NULL) ? view->size : 0;
+}
+
+/*
+ * addActivityToSortedView
+ *
+ * Syntactic Specification:
+ * int addActivityToSortedView(SortedView view, Activity activity);
+ *
+ * Semantic Specification:
+ * Adds an activity to the view, in the position given by its current field values.
+ *
+ * Preconditions:
+ * - 'view != NULL', 'activity != NULL'
+ * - The activity is not already in the view
+ *
+ * Postconditions:
+ * - Returns 0 if the activity has been added
+ * - Returns 1 if the parameters are not valid, an activity with the same position (same id) is
+ *   already in the view or memory allocation fails (the view is unchanged)
+ *
+ * Side Effects:
+ * - Allocates memory and modifies the view
+ */
+int addActivityToSortedView(SortedView view, Activity activity) {
+	if (view == NULL || activity == NULL) return 1;
+
+	int result = 1;
+	view->root = insertViewNode(view->root, activity, view->sortBy, &result);
+	if (result == 0) view->size++;
+
+	return result;
+}
+
+/*
+ * removeActivityFromSortedView
+ *
+ * Syntactic Specification:
+ * int removeActivityFromSortedView(SortedView view, Activity activity);
+ *
+ * Semantic Specification:
+ * Removes an activity from the view. The activity is looked up by its current field values, so it
+ * must be removed before its fields change (see ACTIVITY_CHANGE_BEFORE) and added again afterwards.
+ *
+ * Preconditions:
+ * - The fields of the activity are the same they had when it was added to the view
+ *
+ * Postconditions:
+ * - Returns 0 if the activity has been removed, 1 if it was not in the view (or the parameters are not valid)
+ *
+ * Side Effects:
+ * - Deallocates memory and modifies the view
+ */
+int removeActivityFromSortedView(SortedView view, Activity activity) {
+	if (view == NULL || activity == NULL) return 1;
+
+	int result = 1;
+	view->root = removeViewNode(view->root, activity, view->sortBy, &result);
+	if (result == 0) view->size--;
+
+	return result;
+}
+
+/*
+ * loadSortedViewFromTree
+ *
+ * Syntactic Specification:
+ * int loadSortedViewFromTree(SortedView view, TreeNode root);
+ *
+ * Semantic Specification:
+ * Adds all the activities of the (id) tree to the view.
+ *
+ * Preconditions:
+ * - 'view != NULL' and empty
+ *
+ * Postconditions:
+ * - Returns 0 on success, 1 if 'view == NULL' or memory allocation fails (the view is left partially loaded)
+ *
+ * Side Effects:
+ * - Allocates memory and modifies the view
+ */
+int loadSortedViewFromTree(SortedView view, TreeNode root) {
+	if (view == NULL) return 1;
+
+	return inOrderLoadSortedView(view, root);
+}
+
+/*
+ * printSortedViewToFile
+ *
+ * Syntactic Specification:
+ * void printSortedViewToFile(SortedView view, FILE* file);
+ *
+ * Semantic Specification:
+ * Prints the activities of the view in its order (list format, one per line) to file (to screen if 'file' is NULL).
+ *
+ * Preconditions:
+ * - 'file' can be NULL (screen) or a file opened for writing
+ *
+ * Postconditions:
+ * - If 'view' is NULL or empty, nothing is printed
+ *
+ * Side Effects:
+ * - Output to stdout or writing to file
+ */
+void printSortedViewToFile(SortedView view, FILE* file) {
+	if (view == NULL) return;
+
+	printViewNodesToFile(view->root, file);
+}
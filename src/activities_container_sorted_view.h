@@ -0,0 +1,158 @@
+#ifndef ACTIVITIES_CONTAINER_SORTED_VIEW_H             // Start of inclusion block
+#define ACTIVITIES_CONTAINER_SORTED_VIEW_H             // Macro definition to avoid multiple inclusions
+
+#include <stdio.h>
+#include "activities_container_avl.h"
+
+// Declare an opaque type for a sorted view: the activities of a container kept in the order of one sorting criterion
+typedef struct sortedView* SortedView;
+
+
+/*
+ * newSortedView
+ *
+ * Syntactic Specification:
+ * SortedView newSortedView(int sortBy);
+ *
+ * Semantic Specification:
+ * Creates a new empty view ordered by the criterion 'sortBy' of 'compareActivityBy()' and then by id.
+ * The activities are kept in an AVL tree keyed by (criterion, id), so they can be added and removed
+ * one at a time in O(log n) and listed in order without sorting.
+ *
+ * Preconditions:
+ * - 'sortBy' should be a valid criterion (0-12); other values mean 0 (id)
+ *
+ * Postconditions:
+ * - Returns a new empty view
+ * - If allocation fails, returns 'NULL'
+ *
+ * Side Effects:
+ * - Allocates memory
+ */
+SortedView newSortedView(int sortBy);
+
+/*
+ * deleteSortedView
+ *
+ * Syntactic Specification:
+ * void deleteSortedView(SortedView* view);
+ *
+ * Semantic Specification:
+ * Deallocates the view (the activities are not deallocated). The parameter is a pointer passed by reference.
+ *
+ * Preconditions:
+ * - 'view' can be NULL or point to a valid/NULL pointer
+ *
+ * Postconditions:
+ * - All the memory of the view is freed and '*view' is set to NULL
+ *
+ * Side Effects:
+ * - Deallocates memory
+ */
+void deleteSortedView(SortedView* view);
+
+/*
+ * getSortedViewSize
+ *
+ * Syntactic Specification:
+ * int getSortedViewSize(SortedView view);
+ *
+ * Semantic Specification:
+ * Returns the number of activities in the view.
+ *
+ * Preconditions:
+ * - None
+ *
+ * Postconditions:
+ * - Returns the number of activities (0 if 'view == NULL')
+ *
+ * Side Effects:
+ * - None
+ */
+int getSortedViewSize(SortedView view);
+
+/*
+ * addActivityToSortedView
+ *
+ * Syntactic Specification:
+ * int addActivityToSortedView(SortedView view, Activity activity);
+ *
+ * Semantic Specification:
+ * Adds an activity to the view, in the position given by its current field values.
+ *
+ * Preconditions:
+ * - 'view != NULL', 'activity != NULL'
+ * - The activity is not already in the view
+ *
+ * Postconditions:
+ * - Returns 0 if the activity has been added
+ * - Returns 1 if the parameters are not valid, an activity with the same position (same id) is
+ *   already in the view or memory allocation fails (the view is unchanged)
+ *
+ * Side Effects:
+ * - Allocates memory and modifies the view
+ */
+int addActivityToSortedView(SortedView view, Activity activity);
+
+/*
+ * removeActivityFromSortedView
+ *
+ * Syntactic Specification:
+ * int removeActivityFromSortedView(SortedView view, Activity activity);
+ *
+ * Semantic Specification:
+ * Removes an activity from the view. The activity is looked up by its current field values, so it
+ * must be removed before its fields change (see ACTIVITY_CHANGE_BEFORE) and added again afterwards.
+ *
+ * Preconditions:
+ * - The fields of the activity are the same they had when it was added to the view
+ *
+ * Postconditions:
+ * - Returns 0 if the activity has been removed, 1 if it was not in the view (or the parameters are not valid)
+ *
+ * Side Effects:
+ * - Deallocates memory and modifies the view
+ */
+int removeActivityFromSortedView(SortedView view, Activity activity);
+
+/*
+ * loadSortedViewFromTree
+ *
+ * Syntactic Specification:
+ * int loadSortedViewFromTree(SortedView view, TreeNode root);
+ *
+ * Semantic Specification:
+ * Adds all the activities of the (id) tree to the view.
+ *
+ * Preconditions:
+ * - 'view != NULL' and empty
+ *
+ * Postconditions:
+ * - Returns 0 on success, 1 if 'view == NULL' or memory allocation fails (the view is left partially loaded)
+ *
+ * Side Effects:
+ * - Allocates memory and modifies the view
+ */
+int loadSortedViewFromTree(SortedView view, TreeNode root);
+
+/*
+ * printSortedViewToFile
+ *
+ * Syntactic Specification:
+ * void printSortedViewToFile(SortedView view, FILE* file);
+ *
+ * Semantic Specification:
+ * Prints the activities of the view in its order (list format, one per line) to file (to screen if 'file' is NULL).
+ *
+ * Preconditions:
+ * - 'file' can be NULL (screen) or a file opened for writing
+ *
+ * Postconditions:
+ * - If 'view' is NULL or empty, nothing is printed
+ *
+ * Side Effects:
+ * - Output to stdout or writing to file
+ */
+void printSortedViewToFile(SortedView view, FILE* file);
+
+#endif // ACTIVITIES_CONTAINER_SORTED_VIEW_H          // End of inclusion block
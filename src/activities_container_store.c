@@ -0,0 +1,1009 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "activity.h"
+#include "activities_container_store.h"
+#include "activities_container_writer.h"
+#include "activities_container_checksum.h"
+
+// Byte order mark of the header (see ACTIVITY_SNAPSHOT_BYTE_ORDER_MARK)
+#define ACTIVITY_STORE_BYTE_ORDER_MARK 0x01020304u
+// Length of a NULL string in a record
+#define ACTIVITY_STORE_NULL_STRING UINT32_MAX
+// States of a record
+#define ACTIVITY_STORE_TOMBSTONE 0
+#define ACTIVITY_STORE_LIVE 1
+// Number of string fields of a record (name, description, course)
+#define ACTIVITY_STORE_STRING_FIELDS 3
+
+
+/*
+ * "struct storeHeader" Documentation
+ *
+ * Syntactic Specification:
+ * typedef struct storeHeader {
+ *     char magic[8];
+ *     uint32_t version;
+ *     uint32_t byteOrderMark;
+ *     uint32_t slotSize;
+ *     uint32_t reserved;
+ *     uint64_t slotCount;
+ *     uint64_t deadSlotCount;
+ *     unsigned char padding[24];
+ * } StoreHeader;
+ *
+ * Semantic Specification:
+ * Header at the beginning of a slotted store: one slot (64 bytes, no padding).
+ *
+ * Fields:
+ * - magic: ACTIVITY_STORE_MAGIC, terminated by '\0'
+ * - version: ACTIVITY_STORE_VERSION
+ * - byteOrderMark: ACTIVITY_STORE_BYTE_ORDER_MARK
+ * - slotSize: ACTIVITY_STORE_SLOT_SIZE
+ * - reserved, padding: 0
+ * - slotCount: Number of slots after the header (records and tombstones); bytes after them are ignored
+ * - deadSlotCount: Number of those slots that are tombstones
+ */
+typedef struct storeHeader {
+	char magic[8];
+	uint32_t version;
+	uint32_t byteOrderMark;
+	uint32_t slotSize;
+	uint32_t reserved;
+	uint64_t slotCount;
+	uint64_t deadSlotCount;
+	unsigned char padding[24];
+} StoreHeader;
+
+
+/*
+ * "struct storeRecordHeader" Documentation
+ *
+ * Syntactic Specification:
+ * typedef struct storeRecordHeader {
+ *     uint32_t slotCount;
+ *     uint32_t state;
+ *     int32_t id;
+ *     uint32_t totalTime;
+ *     uint32_t usedTime;
+ *     uint16_t priority;
+ *     uint16_t reserved;
+ *     int64_t insertDate;
+ *     int64_t expiryDate;
+ *     int64_t completionDate;
+ *     uint32_t lengths[ACTIVITY_STORE_STRING_FIELDS];
+ *     uint32_t reserved2;
+ * } StoreRecordHeader;
+ *
+ * Semantic Specification:
+ * Fixed part of a record: its first slot (64 bytes, no padding). The strings follow it.
+ *
+ * Fields:
+ * - slotCount: Number of slots of the record (at least 1): the next record begins after them
+ * - state: ACTIVITY_STORE_LIVE, or ACTIVITY_STORE_TOMBSTONE if the slots are not used any more
+ * - id, totalTime, usedTime, priority, insertDate, expiryDate, completionDate: The fields of the activity
+ * - lengths: Lengths of name, description and course (without the '\0'), ACTIVITY_STORE_NULL_STRING if NULL
+ * - reserved, reserved2: 0
+ */
+typedef struct storeRecordHeader {
+	uint32_t slotCount;
+	uint32_t state;
+	int32_t id;
+	uint32_t totalTime;
+	uint32_t usedTime;
+	uint16_t priority;
+	uint16_t reserved;
+	int64_t insertDate;
+	int64_t expiryDate;
+	int64_t completionDate;
+	uint32_t lengths[ACTIVITY_STORE_STRING_FIELDS];
+	uint32_t reserved2;
+} StoreRecordHeader;
+
+
+/*
+ * "struct storeRun" Documentation
+ *
+ * Syntactic Specification:
+ * typedef struct storeRun {
+ *     long long slot;
+ *     unsigned int slotCount;
+ * } StoreRun;
+ *
+ * Semantic Specification:
+ * Slots of a record that will become a tombstone at the next update.
+ *
+ * Fields:
+ * - slot: First slot of the record
+ * - slotCount: Number of slots of the record
+ */
+typedef struct storeRun {
+	long long slot;
+	unsigned int slotCount;
+} StoreRun;
+
+
+/*
+ * "struct activityStore" Documentation
+ *
+ * Syntactic Specification:
+ * struct activityStore {
+ *     char* filename;
+ *     dev_t device;
+ *     ino_t inode;
+ *     off_t size;
+ *     struct timespec modified;
+ *     uint64_t slotCount;
+ *     uint64_t deadSlotCount;
+ *     StoreRun* freedRuns;
+ *     int freedCount;
+ *     int freedCapacity;
+ *     int hasLostRuns;
+ * };
+ *
+ * Semantic Specification:
+ * A slotted store file as it was after the last save (or read), with the records to make tombstones.
+ *
+ * Fields:
+ * - filename: Name of the file
+ * - device, inode, size, modified: Identity, size and modification time of the file after the last save:
+ *   if they differ, the file has been changed by someone else and the positions are not valid
+ * - slotCount, deadSlotCount: As in the header of the file
+ * - freedRuns, freedCount, freedCapacity: Records of the removed activities (see 'freeActivityStoreRecord()')
+ * - hasLostRuns: 1 if a removed record could not be recorded (the file must be written again)
+ */
+struct activityStore {
+	char* filename;
+	dev_t device;
+	ino_t inode;
+	off_t size;
+	struct timespec modified;
+	uint64_t slotCount;
+	uint64_t deadSlotCount;
+	StoreRun* freedRuns;
+	int freedCount;
+	int freedCapacity;
+	int hasLostRuns;
+};
+
+
+/*
+ * "struct storeEncoder" Documentation
+ *
+ * Syntactic Specification:
+ * typedef struct storeEncoder {
+ *     unsigned char* buffer;
+ *     size_t capacity;
+ *     size_t size;
+ * } StoreEncoder;
+ *
+ * Semantic Specification:
+ * Buffer the records are encoded in, reused by every record.
+ *
+ * Fields:
+ * - buffer: The encoded record, padded with zeros to a whole number of slots
+ * - capacity: Number of bytes of the buffer
+ * - size: Number of bytes of the encoded record (a multiple of ACTIVITY_STORE_SLOT_SIZE)
+ */
+typedef struct storeEncoder {
+	unsigned char* buffer;
+	size_t capacity;
+	size_t size;
+} StoreEncoder;
+
+
+/*
+ * getStoreString
+ *
+ * Syntactic Specification:
+ * char* getStoreString(Activity a, int field);
+ *
+ * Semantic Specification:
+ * Returns the string field of a record: 0 name, 1 description, 2 course.
+ *
+ * Preconditions:
+ * - 'a != NULL', '0 <= field < ACTIVITY_STORE_STRING_FIELDS'
+ *
+ * Postconditions:
+ * - Returns the string (can be NULL)
+ *
+ * Side Effects:
+ * - Loads a description left in its file (see 'getActivityDescr()')
+ */
+char* getStoreString(Activity a, int field) {
+	switch (field) {
+		case 0:	return getActivityName(a);
+		case 1:	return getActivityDescr(a);
+		default:	return getActivityCourse(a);
+	}
+}
+
+/*
+ * encodeStoreRecord
+ *
+ * Syntactic Specification:
+ * unsigned int encodeStoreRecord(StoreEncoder* encoder, Activity a, unsigned int slotCount);
+ *
+ * Semantic Specification:
+ * Encodes the record of an activity in the buffer of the encoder, padded to a whole number of slots.
+ * The number of slots written in the record is 'slotCount' (the slots it has in the file), or the slots
+ * it needs if 'slotCount' is 0 or too small.
+ *
+ * Preconditions:
+ * - 'encoder != NULL', 'a != NULL'
+ *
+ * Postconditions:
+ * - Returns the number of slots the record needs ('encoder->size' bytes are encoded)
+ * - Returns 0 if memory allocation fails, a string is too long for a record or the description can't
+ *   be read from its file (see 'isActivityDescrLoaded()')
+ *
+ * Side Effects:
+ * - Modifies the buffer of the encoder
+ */
+unsigned int encodeStoreRecord(StoreEncoder* encoder, Activity a, unsigned int slotCount) {
+	StoreRecordHeader header;
+	memset(&header, 0, sizeof(header));
+
+	size_t size = sizeof(header);
+	char* strings[ACTIVITY_STORE_STRING_FIELDS];
+	for (int f = 0; f < ACTIVITY_STORE_STRING_FIELDS; f++) {
+		strings[f] = getStoreString(a, f);
+		if (strings[f] == NULL) {
+			header.lengths[f] = ACTIVITY_STORE_NULL_STRING;
+			continue;
+		}
+		size_t length = strlen(strings[f]);
+		if (length >= ACTIVITY_STORE_NULL_STRING) return 0;
+		header.lengths[f] = (uint32_t)length;
+		size += length + 1;
+	}
+	if (!isActivityDescrLoaded(a)) return 0;
+
+	size_t neededSlots = (size + ACTIVITY_STORE_SLOT_SIZE - 1) / ACTIVITY_STORE_SLOT_SIZE;
+	if (neededSlots > UINT32_MAX) return 0;
+	size_t paddedSize = neededSlots * ACTIVITY_STORE_SLOT_SIZE;
+	if (paddedSize > encoder->capacity) {
+		unsigned char* buffer = realloc(encoder->buffer, paddedSize);
+		if (buffer == NULL) return 0;
+		encoder->buffer = buffer;
+		encoder->capacity = paddedSize;
+	}
+
+	header.slotCount = (slotCount >= neededSlots) ? slotCount : (uint32_t)neededSlots;
+	header.state = ACTIVITY_STORE_LIVE;
+	header.id = getActivityId(a);
+	header.totalTime = getActivityTotalTime(a);
+	header.usedTime = getActivityUsedTime(a);
+	header.priority = getActivityPriority(a);
+	header.insertDate = getActivityInsertDate(a);
+	header.expiryDate = getActivityExpiryDate(a);
+	header.completionDate = getActivityCompletionDate(a);
+
+	memcpy(encoder->buffer, &header, sizeof(header));
+	size_t offset = sizeof(header);
+	for (int f = 0; f < ACTIVITY_STORE_STRING_FIELDS; f++) {
+		if (strings[f] == NULL) continue;
+		memcpy(encoder->buffer + offset, strings[f], header.lengths[f] + 1);
+		offset += header.lengths[f] + 1;
+	}
+	memset(encoder->buffer + offset, 0, paddedSize - offset);
+
+	encoder->size = paddedSize;
+	return (unsigned int)neededSlots;
+}
+
+/*
+ * getStoreSlotOffset
+ *
+ * Syntactic Specification:
+ * off_t getStoreSlotOffset(uint64_t slot);
+ *
+ * Semantic Specification:
+ * Returns the position in the file of a slot (the header takes the first one).
+ *
+ * Preconditions:
+ * - None
+ *
+ * Postconditions:
+ * - Returns the offset in bytes
+ *
+ * Side Effects:
+ * - None
+ */
+off_t getStoreSlotOffset(uint64_t slot) {
+	return (off_t)((slot + 1) * ACTIVITY_STORE_SLOT_SIZE);
+}
+
+/*
+ * writeAllToStoreFile
+ *
+ * Syntactic Specification:
+ * int writeAllToStoreFile(int fd, const void* data, size_t size, off_t offset);
+ *
+ * Semantic Specification:
+ * Writes all the bytes at a position of the file, with as many 'pwrite()' calls as needed.
+ *
+ * Preconditions:
+ * - 'fd' open for writing, 'data' has at least 'size' bytes
+ *
+ * Postconditions:
+ * - Returns 0 if all the bytes have been written, 1 otherwise
+ *
+ * Side Effects:
+ * - Writing to file
+ */
+int writeAllToStoreFile(int fd, const void* data, size_t size, off_t offset) {
+	const char* bytes = data;
+	while (size > 0) {
+		ssize_t written = pwrite(fd, bytes, size, offset);
+		if (written <= 0) return 1;
+		bytes += written;
+		size -= (size_t)written;
+		offset += written;
+	}
+	return 0;
+}
+
+/*
+ * newActivityStore
+ *
+ * Syntactic Specification:
+ * ActivityStore newActivityStore(const char* filename, uint64_t slotCount, uint64_t deadSlotCount);
+ *
+ * Semantic Specification:
+ * Creates the store of a file just written or read, taking its identity with 'stat()'.
+ *
+ * Preconditions:
+ * - 'filename != NULL'
+ *
+ * Postconditions:
+ * - Returns the store, NULL if the file can't be examined or memory allocation fails
+ *
+ * Side Effects:
+ * - Allocates memory
+ */
+ActivityStore newActivityStore(const char* filename, uint64_t slotCount, uint64_t deadSlotCount) {
+	struct stat fileInfo;
+	if (stat(filename, &fileInfo) != 0) return NULL;
+
+	ActivityStore store = calloc(1, sizeof(struct activityStore));
+	if (store == NULL) return NULL;
+	store->filename = malloc(strlen(filename) + 1);
+	if (store->filename == NULL) {
+		free(store);
+		return NULL;
+	}
+	strcpy(store->filename, filename);
+
+	store->device = fileInfo.st_dev;
+	store->inode = fileInfo.st_ino;
+	store->size = fileInfo.st_size;
+	store->modified = fileInfo.st_mtim;
+	store->slotCount = slotCount;
+	store->deadSlotCount = deadSlotCount;
+	return store;
+}
+
+/*
+ * fillStoreHeader
+ *
+ * Syntactic Specification:
+ * void fillStoreHeader(StoreHeader* header, uint64_t slotCount, uint64_t deadSlotCount);
+ *
+ * Semantic Specification:
+ * Fills the header of a slotted store.
+ *
+ * Preconditions:
+ * - 'header != NULL'
+ *
+ * Postconditions:
+ * - The header is complete
+ *
+ * Side Effects:
+ * - None
+ */
+void fillStoreHeader(StoreHeader* header, uint64_t slotCount, uint64_t deadSlotCount) {
+	memset(header, 0, sizeof(*header));
+	memcpy(header->magic, ACTIVITY_STORE_MAGIC, sizeof(ACTIVITY_STORE_MAGIC));
+	header->version = ACTIVITY_STORE_VERSION;
+	header->byteOrderMark = ACTIVITY_STORE_BYTE_ORDER_MARK;
+	header->slotSize = ACTIVITY_STORE_SLOT_SIZE;
+	header->slotCount = slotCount;
+	header->deadSlotCount = deadSlotCount;
+}
+
+/*
+ * writeStoreRecords
+ *
+ * Syntactic Specification:
+ * int writeStoreRecords(ActivityWriter writer, StoreEncoder* encoder, TreeNode root, uint64_t* slotCount);
+ *
+ * Semantic Specification:
+ * Visits the tree in order and writes the record of every activity after the previous ones, recording
+ * its slots in the activity.
+ *
+ * Preconditions:
+ * - 'writer', 'encoder' and 'slotCount' not NULL ('*slotCount' is the first free slot)
+ *
+ * Postconditions:
+ * - Returns 0 on success ('*slotCount' is updated), 1 if a record can't be encoded
+ *
+ * Side Effects:
+ * - Writing to file
+ * - Modifies the store position and dirty bit of the activities
+ */
+int writeStoreRecords(ActivityWriter writer, StoreEncoder* encoder, TreeNode root, uint64_t* slotCount) {
+	if (root == NULL) return 0;
+
+	if (writeStoreRecords(writer, encoder, getLeftNode(root), slotCount) != 0) return 1;
+
+	Activity a = getActivityFromNode(root);
+	unsigned int slots = encodeStoreRecord(encoder, a, 0);
+	if (slots == 0) return 1;
+	writeBytesToActivityWriter(writer, encoder->buffer, encoder->size);
+	setActivityStoreSlot(a, (long long)*slotCount, slots);
+	*slotCount += slots;
+
+	return writeStoreRecords(writer, encoder, getRightNode(root), slotCount);
+}
+
+/*
+ * countStoreRecordSlots
+ *
+ * Syntactic Specification:
+ * uint64_t countStoreRecordSlots(TreeNode root);
+ *
+ * Semantic Specification:
+ * Returns the number of slots the records of the activities of the tree need.
+ *
+ * Preconditions:
+ * - None
+ *
+ * Postconditions:
+ * - Returns the number of slots (0 if 'root == NULL')
+ *
+ * Side Effects:
+ * - Loads the descriptions left in their file (see 'getActivityDescr()')
+ */
+uint64_t countStoreRecordSlots(TreeNode root) {
+	if (root == NULL) return 0;
+
+	Activity a = getActivityFromNode(root);
+	size_t size = sizeof(StoreRecordHeader);
+	for (int f = 0; f < ACTIVITY_STORE_STRING_FIELDS; f++) {
+		char* str = getStoreString(a, f);
+		if (str != NULL) size += strlen(str) + 1;
+	}
+
+	return (size + ACTIVITY_STORE_SLOT_SIZE - 1) / ACTIVITY_STORE_SLOT_SIZE +
+			 countStoreRecordSlots(getLeftNode(root)) + countStoreRecordSlots(getRightNode(root));
+}
+
+/*
+ * writeActivitiesStore
+ *
+ * Syntactic Specification:
+ * ActivityStore writeActivitiesStore(const char* filename, TreeNode root);
+ *
+ * Semantic Specification:
+ * Writes the activities of the tree (in id order) to a file in the slotted store format, the format that
+ * can be updated in place by 'updateActivitiesStore()':
+ * - a header slot: magic (8 bytes), version, byte order mark and slot size (32 bit), then number of slots
+ *   of the records and number of those slots that are tombstones (64 bit)
+ * - one record per activity, taking a whole number of slots (the unused bytes of its last slot are the room
+ *   a record has to grow in place): a fixed part of one slot (number of slots of the record, state, id,
+ *   times, priority, dates, lengths of the strings) followed by name, description and course, each
+ *   terminated by '\0'
+ * The numbers are in the byte order of the machine, as in a binary snapshot. The file is written through
+ * an ActivityWriter (replaced only when complete); then every activity records its slots and is clean
+ * (see 'setActivityStoreSlot()').
+ *
+ * Preconditions:
+ * - 'filename != NULL'
+ *
+ * Postconditions:
+ * - Returns the store bound to the new file
+ * - Returns NULL if the file can't be written or memory allocation fails: the file keeps its previous content,
+ *   the slots recorded by the activities are not valid
+ *
+ * Side Effects:
+ * - Writing to file
+ * - Allocates memory
+ * - Modifies the store position and dirty bit of every activity
+ */
+ActivityStore writeActivitiesStore(const char* filename, TreeNode root) {
+	if (filename == NULL) return NULL;
+
+	ActivityWriter writer = newActivityWriter(filename);
+	if (writer == NULL) return NULL;
+	enableActivityWriterChecksums(writer);
+
+	StoreHeader header;
+	fillStoreHeader(&header, countStoreRecordSlots(root), 0);
+	writeBytesToActivityWriter(writer, &header, sizeof(header));
+
+	StoreEncoder encoder = { NULL, 0, 0 };
+	uint64_t slotCount = 0;
+	int writeResult = writeStoreRecords(writer, &encoder, root, &slotCount);
+	free(encoder.buffer);
+
+	if (writeResult != 0 || slotCount != header.slotCount) {
+		discardActivityWriter(&writer);
+		return NULL;
+	}
+	if (commitActivityWriter(&writer) != 0) return NULL;
+
+	return newActivityStore(filename, slotCount, 0);
+}
+
+/*
+ * "struct storeUpdate" Documentation
+ *
+ * Syntactic Specification:
+ * typedef struct storeUpdate {
+ *     int fd;
+ *     ActivityStore store;
+ *     StoreEncoder encoder;
+ *     int inPlace;
+ *     int writtenCount;
+ *     int failed;
+ *     uint64_t* blocks;
+ *     size_t blockCount;
+ *     size_t blockCapacity;
+ *     int blocksLost;
+ * } StoreUpdate;
+ *
+ * Semantic Specification:
+ * State of an update of a slotted store, passed along the visit of the tree.
+ *
+ * Fields:
+ * - fd: The file, open for reading and writing
+ * - store: The store being updated
+ * - encoder: Buffer of the records
+ * - inPlace: 0 while the records that don't fit in their slots are appended, 1 while the others are rewritten
+ * - writtenCount: Number of records written
+ * - failed: 1 if a write (or an encoding) has failed
+ * - blocks, blockCount, blockCapacity: Checksum blocks written (see 'refreshActivityChecksums()'), repeated too
+ * - blocksLost: 1 if memory allocation has failed for 'blocks' (the checksum file can't be updated)
+ */
+typedef struct storeUpdate {
+	int fd;
+	ActivityStore store;
+	StoreEncoder encoder;
+	int inPlace;
+	int writtenCount;
+	int failed;
+	uint64_t* blocks;
+	size_t blockCount;
+	size_t blockCapacity;
+	int blocksLost;
+} StoreUpdate;
+
+/*
+ * writeToStoreUpdate
+ *
+ * Syntactic Specification:
+ * int writeToStoreUpdate(StoreUpdate* update, const void* data, size_t size, off_t offset);
+ *
+ * Semantic Specification:
+ * Writes bytes at a position of the file being updated (see 'writeAllToStoreFile()') and records the
+ * checksum blocks they touch, so that only those are checksummed again after the update.
+ *
+ * Preconditions:
+ * - 'update != NULL', 'data' has at least 'size' bytes
+ *
+ * Postconditions:
+ * - Returns 0 if all the bytes have been written, 1 otherwise
+ *
+ * Side Effects:
+ * - Writing to file
+ * - May allocate memory
+ */
+int writeToStoreUpdate(StoreUpdate* update, const void* data, size_t size, off_t offset) {
+	if (writeAllToStoreFile(update->fd, data, size, offset) != 0) return 1;
+	if (size == 0 || update->blocksLost) return 0;
+
+	uint64_t first = (uint64_t)offset / ACTIVITY_CHECKSUM_BLOCK_SIZE;
+	uint64_t last = ((uint64_t)offset + size - 1) / ACTIVITY_CHECKSUM_BLOCK_SIZE;
+	for (uint64_t b = first; b <= last; b++) {
+		if (update->blockCount == update->blockCapacity) {
+			size_t capacity = (update->blockCapacity > 0) ? update->blockCapacity * 2 : 64;
+			uint64_t* blocks = realloc(update->blocks, capacity * sizeof(uint64_t));
+			if (blocks == NULL) {
+				update->blocksLost = 1;
+				return 0;
+			}
+			update->blocks = blocks;
+			update->blockCapacity = capacity;
+		}
+		update->blocks[update->blockCount++] = b;
+	}
+	return 0;
+}
+
+/*
+ * writeDirtyStoreRecords
+ *
+ * Syntactic Specification:
+ * void writeDirtyStoreRecords(StoreUpdate* update, TreeNode root);
+ *
+ * Semantic Specification:
+ * Visits the tree and writes the records of the dirty activities: with 'update->inPlace == 0', the ones
+ * with no slots or that don't fit in their slots, appended after the last slot (their old slots are added
+ * to the tombstones to write); with 'update->inPlace == 1', the others, in their slots.
+ *
+ * Preconditions:
+ * - 'update != NULL'
+ *
+ * Postconditions:
+ * - The records are written and their activities are clean, unless 'update->failed' is set
+ *
+ * Side Effects:
+ * - Writing to file
+ * - Modifies the store position and dirty bit of the activities written
+ */
+void writeDirtyStoreRecords(StoreUpdate* update, TreeNode root) {
+	if (root == NULL || update->failed) return;
+
+	writeDirtyStoreRecords(update, getLeftNode(root));
+
+	Activity a = getActivityFromNode(root);
+	if (isActivityDirty(a)) {
+		unsigned int slotCount = 0;
+		long long slot = getActivityStoreSlot(a, &slotCount);
+		unsigned int neededSlots = encodeStoreRecord(&update->encoder, a, slotCount);
+		int fits = (neededSlots > 0 && slot >= 0 && neededSlots <= slotCount);
+
+		if (neededSlots == 0) {
+			update->failed = 1;
+		} else if (update->inPlace && fits) {
+			if (writeToStoreUpdate(update, update->encoder.buffer, update->encoder.size, getStoreSlotOffset((uint64_t)slot)) != 0) {
+				update->failed = 1;
+			} else {
+				setActivityStoreSlot(a, slot, slotCount);
+				update->writtenCount++;
+			}
+		} else if (!update->inPlace && !fits) {
+			ActivityStore store = update->store;
+			if (writeToStoreUpdate(update, update->encoder.buffer, update->encoder.size, getStoreSlotOffset(store->slotCount)) != 0) {
+				update->failed = 1;
+			} else {
+				freeActivityStoreRecord(store, a);
+				setActivityStoreSlot(a, (long long)store->slotCount, neededSlots);
+				store->slotCount += neededSlots;
+				update->writtenCount++;
+			}
+		}
+	}
+
+	writeDirtyStoreRecords(update, getRightNode(root));
+}
+
+/*
+ * updateActivitiesStore
+ *
+ * Syntactic Specification:
+ * int updateActivitiesStore(ActivityStore store, TreeNode root, int* writtenCount);
+ *
+ * Semantic Specification:
+ * Saves the activities of the tree to the file of the store writing only what has changed since the last
+ * save: the record of a dirty activity is rewritten in its slots if it still fits, otherwise it is appended
+ * after the last slot (as the records of the new activities) and its old slots become a tombstone, as the
+ * records of the activities removed (see 'freeActivityStoreRecord()'). The file is updated in this order:
+ * appended records, synced; records rewritten in place and tombstones; header, synced. Until the header is
+ * written the appended records are not part of the file, so a crash leaves every record whole but for the
+ * one being rewritten, and the modifications are still in the journal (compacted only after the save).
+ * The cost is proportional to the records written, not to the size of the file (the tree is visited in
+ * memory to find the dirty activities). The checksum file is updated only for the blocks written (see
+ * 'refreshActivityChecksums()'), or removed if it can't be.
+ *
+ * Preconditions:
+ * - 'store' returned by 'writeActivitiesStore()' or 'readActivitiesStore()' for the activities of the tree
+ * - 'writtenCount != NULL'
+ *
+ * Postconditions:
+ * - Returns 0 if the file has been updated: '*writtenCount' is the number of records written, every activity
+ *   is clean
+ * - Returns 1 if the file must be written again with 'writeActivitiesStore()': it has been changed or replaced
+ *   since the last save, more than half of its slots are tombstones, or a write failed
+ *
+ * Side Effects:
+ * - Writing to file
+ * - Modifies the store position and dirty bit of the activities written
+ */
+int updateActivitiesStore(ActivityStore store, TreeNode root, int* writtenCount) {
+	*writtenCount = 0;
+	if (store == NULL || store->hasLostRuns) return 1;
+
+	int fd = open(store->filename, O_RDWR);
+	if (fd < 0) return 1;
+
+	struct stat fileInfo;
+	StoreHeader header;
+	if (fstat(fd, &fileInfo) != 0 || fileInfo.st_dev != store->device || fileInfo.st_ino != store->inode ||
+		 fileInfo.st_size != store->size || fileInfo.st_mtim.tv_sec != store->modified.tv_sec ||
+		 fileInfo.st_mtim.tv_nsec != store->modified.tv_nsec ||
+		 pread(fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header) ||
+		 memcmp(header.magic, ACTIVITY_STORE_MAGIC, sizeof(ACTIVITY_STORE_MAGIC)) != 0 ||
+		 header.slotCount != store->slotCount) {
+		close(fd);
+		return 1;
+	}
+
+	// a file with mostly tombstones is compacted by writing it again
+	if (store->deadSlotCount > store->slotCount / 2) {
+		close(fd);
+		return 1;
+	}
+
+	StoreUpdate update = { fd, store, { NULL, 0, 0 }, 0, 0, 0, NULL, 0, 0, 0 };
+	uint64_t oldSlotCount = store->slotCount;
+
+	// appended records first: they're not in the file until the header counts them
+	writeDirtyStoreRecords(&update, root);
+	if (!update.failed && store->slotCount != oldSlotCount && fdatasync(fd) != 0) update.failed = 1;
+
+	update.inPlace = 1;
+	writeDirtyStoreRecords(&update, root);
+
+	uint32_t tombstone = ACTIVITY_STORE_TOMBSTONE;
+	for (int i = 0; i < store->freedCount && !update.failed; i++) {
+		StoreRun run = store->freedRuns[i];
+		off_t stateOffset = getStoreSlotOffset((uint64_t)run.slot) + (off_t)offsetof(StoreRecordHeader, state);
+		if (writeToStoreUpdate(&update, &tombstone, sizeof(tombstone), stateOffset) != 0) update.failed = 1;
+		else store->deadSlotCount += run.slotCount;
+	}
+	store->freedCount = 0;
+
+	if (!update.failed) {
+		fillStoreHeader(&header, store->slotCount, store->deadSlotCount);
+		if (writeToStoreUpdate(&update, &header, sizeof(header), 0) != 0 || fdatasync(fd) != 0) update.failed = 1;
+	}
+
+	// the checksum file follows the blocks written; a stale one is removed rather than left behind
+	if (update.failed || update.blocksLost ||
+		 refreshActivityChecksums(store->filename, fd, update.blocks, update.blockCount) != 0) {
+		removeActivityChecksums(store->filename);
+	}
+
+	free(update.encoder.buffer);
+	free(update.blocks);
+	if (!update.failed && fstat(fd, &fileInfo) == 0) {
+		store->size = fileInfo.st_size;
+		store->modified = fileInfo.st_mtim;
+	} else {
+		update.failed = 1;
+	}
+	close(fd);
+
+	*writtenCount = update.writtenCount;
+	return update.failed ? 1 : 0;
+}
+
+/*
+ * readActivitiesStore
+ *
+ * Syntactic Specification:
+ * ActivityStore readActivitiesStore(const char* filename, Activity** activities, int* count);
+ *
+ * Semantic Specification:
+ * Reads a slotted store (see 'writeActivitiesStore()') with a single read of the whole file and creates
+ * the activities of its records, skipping the tombstones. Every activity records its slots and is clean.
+ * Header, numbers of slots and lengths of the strings are checked.
+ *
+ * Preconditions:
+ * - 'filename != NULL', 'activities != NULL', 'count != NULL'
+ *
+ * Postconditions:
+ * - Returns the store bound to the file: '*activities' is a new array with the '*count' activities in file
+ *   order (the caller deallocates the array and owns the activities)
+ * - Returns NULL if the file can't be read, is not a valid store (of this version and byte order) or memory
+ *   allocation fails: '*activities' is NULL and '*count' is 0
+ *
+ * Side Effects:
+ * - Reading from file
+ * - Allocates memory
+ */
+ActivityStore readActivitiesStore(const char* filename, Activity** activities, int* count) {
+	*activities = NULL;
+	*count = 0;
+	if (filename == NULL) return NULL;
+
+	FILE* file = fopen(filename, "rb");
+	if (file == NULL) return NULL;
+
+	StoreHeader header;
+	struct stat fileInfo;
+	if (fread(&header, sizeof(header), 1, file) != 1 || fstat(fileno(file), &fileInfo) != 0 ||
+		 memcmp(header.magic, ACTIVITY_STORE_MAGIC, sizeof(ACTIVITY_STORE_MAGIC)) != 0 ||
+		 header.version != ACTIVITY_STORE_VERSION || header.byteOrderMark != ACTIVITY_STORE_BYTE_ORDER_MARK ||
+		 header.slotSize != ACTIVITY_STORE_SLOT_SIZE || header.deadSlotCount > header.slotCount ||
+		 header.slotCount > ((uint64_t)fileInfo.st_size / ACTIVITY_STORE_SLOT_SIZE) - 1 ||
+		 header.slotCount > SIZE_MAX / ACTIVITY_STORE_SLOT_SIZE) {
+		fclose(file);
+		return NULL;
+	}
+
+	size_t size = (size_t)header.slotCount * ACTIVITY_STORE_SLOT_SIZE;
+	unsigned char* data = malloc(size > 0 ? size : 1);
+	if (data == NULL || fread(data, 1, size, file) != size) {
+		free(data);
+		fclose(file);
+		return NULL;
+	}
+	fclose(file);
+
+	Activity* result = NULL;
+	int resultCount = 0;
+	int capacity = 0;
+	int error = 0;
+	uint64_t slot = 0;
+	while (slot < header.slotCount && !error) {
+		StoreRecordHeader record;
+		unsigned char* base = data + slot * ACTIVITY_STORE_SLOT_SIZE;
+		memcpy(&record, base, sizeof(record));
+		if (record.slotCount == 0 || record.slotCount > header.slotCount - slot ||
+			 (record.state != ACTIVITY_STORE_LIVE && record.state != ACTIVITY_STORE_TOMBSTONE)) {
+			error = 1;
+			break;
+		}
+		if (record.state == ACTIVITY_STORE_TOMBSTONE) {
+			slot += record.slotCount;
+			continue;
+		}
+
+		// every string must end with its '\0' inside the slots of the record
+		size_t recordSize = (size_t)record.slotCount * ACTIVITY_STORE_SLOT_SIZE;
+		size_t offset = sizeof(record);
+		char* strings[ACTIVITY_STORE_STRING_FIELDS];
+		for (int f = 0; f < ACTIVITY_STORE_STRING_FIELDS && !error; f++) {
+			if (record.lengths[f] == ACTIVITY_STORE_NULL_STRING) {
+				strings[f] = NULL;
+				continue;
+			}
+			if (record.lengths[f] >= recordSize - offset || base[offset + record.lengths[f]] != '\0') {
+				error = 1;
+				break;
+			}
+			strings[f] = (char*)base + offset;
+			offset += (size_t)record.lengths[f] + 1;
+		}
+		if (error) break;
+
+		if (resultCount == capacity) {
+			if (capacity > INT_MAX / 2) {
+				error = 1;
+				break;
+			}
+			int newCapacity = (capacity == 0) ? 64 : capacity * 2;
+			Activity* grown = realloc(result, (size_t)newCapacity * sizeof(Activity));
+			if (grown == NULL) {
+				error = 1;
+				break;
+			}
+			result = grown;
+			capacity = newCapacity;
+		}
+
+		Activity a = newActivity(record.id, strings[0], strings[1], strings[2], (time_t)record.insertDate,
+										 (time_t)record.expiryDate, (time_t)record.completionDate, record.totalTime,
+										 record.usedTime, record.priority);
+		if (a == NULL) {
+			error = 1;
+			break;
+		}
+		setActivityStoreSlot(a, (long long)slot, record.slotCount);
+		result[resultCount++] = a;
+		slot += record.slotCount;
+	}
+	free(data);
+
+	ActivityStore store = error ? NULL : newActivityStore(filename, header.slotCount, header.deadSlotCount);
+	if (store == NULL) {
+		for (int i = 0; i < resultCount; i++) deleteActivity(result[i]);
+		free(result);
+		return NULL;
+	}
+
+	*activities = result;
+	*count = resultCount;
+	return store;
+}
+
+/*
+ * getActivitiesStoreFilename
+ *
+ * Syntactic Specification:
+ * const char* getActivitiesStoreFilename(ActivityStore store);
+ *
+ * Semantic Specification:
+ * Returns the name of the file of the store.
+ *
+ * Preconditions:
+ * - None
+ *
+ * Postconditions:
+ * - Returns the file name, NULL if 'store == NULL'
+ *
+ * Side Effects:
+ * - None
+ */
+const char* getActivitiesStoreFilename(ActivityStore store) {
+	if (store == NULL) return NULL;
+
+	return store->filename;
+}
+
+/*
+ * freeActivityStoreRecord
+ *
+ * Syntactic Specification:
+ * void freeActivityStoreRecord(ActivityStore store, Activity a);
+ *
+ * Semantic Specification:
+ * Records that an activity is being removed: the next 'updateActivitiesStore()' makes its record a tombstone.
+ *
+ * Preconditions:
+ * - 'a' is one of the activities of the store, called before it's deallocated
+ *
+ * Postconditions:
+ * - The slots of the record (if any) will become a tombstone; if memory allocation fails, the next update
+ *   writes the whole file again
+ *
+ * Side Effects:
+ * - Allocates memory
+ */
+void freeActivityStoreRecord(ActivityStore store, Activity a) {
+	if (store == NULL || a == NULL) return;
+
+	unsigned int slotCount = 0;
+	long long slot = getActivityStoreSlot(a, &slotCount);
+	if (slot < 0) return;
+
+	if (store->freedCount == store->freedCapacity) {
+		int capacity = (store->freedCapacity == 0) ? 16 : store->freedCapacity * 2;
+		StoreRun* runs = realloc(store->freedRuns, (size_t)capacity * sizeof(StoreRun));
+		if (runs == NULL) {
+			store->hasLostRuns = 1;
+			return;
+		}
+		store->freedRuns = runs;
+		store->freedCapacity = capacity;
+	}
+	store->freedRuns[store->freedCount].slot = slot;
+	store->freedRuns[store->freedCount].slotCount = slotCount;
+	store->freedCount++;
+}
+
+/*
+ * deleteActivitiesStore
+ *
+ * Syntactic Specification:
+ * void deleteActivitiesStore(ActivityStore* store);
+ *
+ * Semantic Specification:
+ * Deallocates the store (the file is not modified). The parameter is a pointer passed by reference.
+ *
+ * Preconditions:
+ * - 'store' can be NULL or point to a valid/NULL pointer
+ *
+ * Postconditions:
+ * - '*store' is set to NULL
+ *
+ * Side Effects:
+ * - Deallocates memory
+ */
+void deleteActivitiesStore(ActivityStore* store) {
+	if (store == NULL || *store == NULL) return;
+
+	free((*store)->filename);
+	free((*store)->freedRuns);
+	free(*store);
+	*store = NULL;
+}
@@ -0,0 +1,173 @@
+#ifndef ACTIVITIES_CONTAINER_STORE_H             // Start of inclusion block
+#define ACTIVITIES_CONTAINER_STORE_H             // Macro definition to avoid multiple inclusions
+
+#include "activity.h"
+#include "activities_container_avl.h"
+
+// First bytes of a slotted store file
+#define ACTIVITY_STORE_MAGIC "PSDSLOT"
+// Version of the slotted store format written by 'writeActivitiesStore()'
+#define ACTIVITY_STORE_VERSION 1
+// Bytes of a slot: the header and every record take a whole number of slots
+#define ACTIVITY_STORE_SLOT_SIZE 64
+
+// Declare an opaque type for a slotted store file bound to the activities read from or saved to it
+typedef struct activityStore* ActivityStore;
+
+
+/*
+ * writeActivitiesStore
+ *
+ * Syntactic Specification:
+ * ActivityStore writeActivitiesStore(const char* filename, TreeNode root);
+ *
+ * Semantic Specification:
+ * Writes the activities of the tree (in id order) to a file in the slotted store format, the format that
+ * can be updated in place by 'updateActivitiesStore()':
+ * - a header slot: magic (8 bytes), version, byte order mark and slot size (32 bit), then number of slots
+ *   of the records and number of those slots that are tombstones (64 bit)
+ * - one record per activity, taking a whole number of slots (the unused bytes of its last slot are the room
+ *   a record has to grow in place): a fixed part of one slot (number of slots of the record, state, id,
+ *   times, priority, dates, lengths of the strings) followed by name, description and course, each
+ *   terminated by '\0'
+ * The numbers are in the byte order of the machine, as in a binary snapshot. The file is written through
+ * an ActivityWriter (replaced only when complete); then every activity records its slots and is clean
+ * (see 'setActivityStoreSlot()').
+ *
+ * Preconditions:
+ * - 'filename != NULL'
+ *
+ * Postconditions:
+ * - Returns the store bound to the new file
+ * - Returns NULL if the file can't be written or memory allocation fails: the file keeps its previous content,
+ *   the slots recorded by the activities are not valid
+ *
+ * Side Effects:
+ * - Writing to file
+ * - Allocates memory
+ * - Modifies the store position and dirty bit of every activity
+ */
+ActivityStore writeActivitiesStore(const char* filename, TreeNode root);
+
+/*
+ * updateActivitiesStore
+ *
+ * Syntactic Specification:
+ * int updateActivitiesStore(ActivityStore store, TreeNode root, int* writtenCount);
+ *
+ * Semantic Specification:
+ * Saves the activities of the tree to the file of the store writing only what has changed since the last
+ * save: the record of a dirty activity is rewritten in its slots if it still fits, otherwise it is appended
+ * after the last slot (as the records of the new activities) and its old slots become a tombstone, as the
+ * records of the activities removed (see 'freeActivityStoreRecord()'). The file is updated in this order:
+ * appended records, synced; records rewritten in place and tombstones; header, synced. Until the header is
+ * written the appended records are not part of the file, so a crash leaves every record whole but for the
+ * one being rewritten, and the modifications are still in the journal (compacted only after the save).
+ * The cost is proportional to the records written, not to the size of the file (the tree is visited in
+ * memory to find the dirty activities). The checksum file is updated only for the blocks written (see
+ * 'refreshActivityChecksums()'), or removed if it can't be.
+ *
+ * Preconditions:
+ * - 'store' returned by 'writeActivitiesStore()' or 'readActivitiesStore()' for the activities of the tree
+ * - 'writtenCount != NULL'
+ *
+ * Postconditions:
+ * - Returns 0 if the file has been updated: '*writtenCount' is the number of records written, every activity
+ *   is clean
+ * - Returns 1 if the file must be written again with 'writeActivitiesStore()': it has been changed or replaced
+ *   since the last save, more than half of its slots are tombstones, or a write failed
+ *
+ * Side Effects:
+ * - Writing to file
+ * - Modifies the store position and dirty bit of the activities written
+ */
+int updateActivitiesStore(ActivityStore store, TreeNode root, int* writtenCount);
+
+/*
+ * readActivitiesStore
+ *
+ * Syntactic Specification:
+ * ActivityStore readActivitiesStore(const char* filename, Activity** activities, int* count);
+ *
+ * Semantic Specification:
+ * Reads a slotted store (see 'writeActivitiesStore()') with a single read of the whole file and creates
+ * the activities of its records, skipping the tombstones. Every activity records its slots and is clean.
+ * Header, numbers of slots and lengths of the strings are checked.
+ *
+ * Preconditions:
+ * - 'filename != NULL', 'activities != NULL', 'count != NULL'
+ *
+ * Postconditions:
+ * - Returns the store bound to the file: '*activities' is a new array with the '*count' activities in file
+ *   order (the caller deallocates the array and owns the activities)
+ * - Returns NULL if the file can't be read, is not a valid store (of this version and byte order) or memory
+ *   allocation fails: '*activities' is NULL and '*count' is 0
+ *
+ * Side Effects:
+ * - Reading from file
+ * - Allocates memory
+ */
+ActivityStore readActivitiesStore(const char* filename, Activity** activities, int* count);
+
+/*
+ * getActivitiesStoreFilename
+ *
+ * Syntactic Specification:
+ * const char* getActivitiesStoreFilename(ActivityStore store);
+ *
+ * Semantic Specification:
+ * Returns the name of the file of the store.
+ *
+ * Preconditions:
+ * - None
+ *
+ * Postconditions:
+ * - Returns the file name, NULL if 'store == NULL'
+ *
+ * Side Effects:
+ * - None
+ */
+const char* getActivitiesStoreFilename(ActivityStore store);
+
+/*
+ * freeActivityStoreRecord
+ *
+ * Syntactic Specification:
+ * void freeActivityStoreRecord(ActivityStore store, Activity a);
+ *
+ * Semantic Specification:
+ * Records that an activity is being removed: the next 'updateActivitiesStore()' makes its record a tombstone.
+ *
+ * Preconditions:
+ * - 'a' is one of the activities of the store, called before it's deallocated
+ *
+ * Postconditions:
+ * - The slots of the record (if any) will become a tombstone; if memory allocation fails, the next update
+ *   writes the whole file again
+ *
+ * Side Effects:
+ * - Allocates memory
+ */
+void freeActivityStoreRecord(ActivityStore store, Activity a);
+
+/*
+ * deleteActivitiesStore
+ *
+ * Syntactic Specification:
+ * void deleteActivitiesStore(ActivityStore* store);
+ *
+ * Semantic Specification:
+ * Deallocates the store (the file is not modified). The parameter is a pointer passed by reference.
+ *
+ * Preconditions:
+ * - 'store' can be NULL or point to a valid/NULL pointer
+ *
+ * Postconditions:
+ * - '*store' is set to NULL
+ *
+ * Side Effects:
+ * - Deallocates memory
+ */
+void deleteActivitiesStore(ActivityStore* store);
+
+#endif // ACTIVITIES_CONTAINER_STORE_H          // End of inclusion block
@@ -42,6 +42,8 @@ typedef struct nodelist {
     struct nodelist* next;
 } NodeList;
 
+#define SUPPORT_LIST_SORT_BINS 64 // bins of the bottom-up merge sort: bins[k] holds 2^k nodes
+
 
 
 /*
@@ -228,175 +230,278 @@ void addActivityToSupportList(ActivitiesContainerSupportList list, Activity acti
 
 
 /*
- * splitSupportList
+ * DEFINE_SUPPORT_LIST_SORT
  * 
  * Syntactic Specification:
- *   NodeList* splitSupportList(NodeList* head);
+ *   DEFINE_SUPPORT_LIST_SORT(sortBy, Criterion)
  * 
  * Semantic Specification:
- *   Support function for merge sort that divides a list into two approximately 
- *   equal halves using the "tortoise and hare" technique 
- *   (slow - the tortoise - and fast - the hare - pointers).
+ *   Template (used with ACTIVITY_SORT_CRITERIA) that defines the bottom-up
+ *   merge sort specialized for one sorting criterion. The comparator
+ *   'compareActivityBy##Criterion()' is called directly, so the compiler can
+ *   inline it. For each criterion it defines:
+ * 
+ *   - int compareSupportListNodesBy##Criterion(NodeList* nodeA, NodeList* nodeB);
+ *       Compares the activities of two nodes (NULL activities are placed
+ *       after all the others). Returns a negative value if nodeA comes before
+ *       nodeB, 0 if they are equivalent, a positive value otherwise.
+ * 
+ *   - NodeList* mergeSupportListsBy##Criterion(NodeList* listA, NodeList* listB);
+ *       Merges two sorted lists (either can be NULL) into a single sorted
+ *       list, reconnecting the nodes (no allocation, iterative). listA must
+ *       hold the elements that came first in the unsorted list: on
+ *       equivalent elements the one from listB is taken first.
+ * 
+ *   - NodeList* mergeSortSupportListBy##Criterion(NodeList* head);
+ *       Sorts the list and returns its new head. The nodes are detached one
+ *       at a time from the list and pushed into 'bins', where 'bins[k]' is
+ *       empty or holds a sorted run of 2^k nodes: like adding 1 to a binary
+ *       counter, equal-sized runs are merged until an empty bin is found. At
+ *       the end, the bins are merged together (higher bins hold earlier
+ *       nodes). Equivalent elements end up in the same order produced by the
+ *       recursive top-down merge sort (the later run always wins ties).
+ * 
+ * Side Effects:
+ *   - The generated functions modify the list structure (next pointers only)
+ *   - Walks the list only once (no split walks) and uses a fixed-size array of bins
+ */
+#define DEFINE_SUPPORT_LIST_SORT(sortBy, Criterion) \
+int compareSupportListNodesBy##Criterion(NodeList* nodeA, NodeList* nodeB) { \
+	if (nodeA->activity == NULL && nodeB->activity != NULL) return 1; \
+	if (nodeA->activity != NULL && nodeB->activity == NULL) return -1; \
+	if (nodeA->activity == NULL && nodeB->activity == NULL) return 0; \
+	\
+	return compareActivityBy##Criterion(nodeA->activity, nodeB->activity); \
+} \
+\
+NodeList* mergeSupportListsBy##Criterion(NodeList* listA, NodeList* listB) { \
+	NodeList mergedHead; /* placeholder before the first merged node */ \
+	NodeList* tail = &mergedHead; \
+	\
+	/* Pick the smaller node between listA and listB and append it to the merged list */ \
+	while (listA != NULL && listB != NULL) { \
+		if (compareSupportListNodesBy##Criterion(listA, listB) < 0) { /* listA->data < listB->data */ \
+			tail->next = listA; \
+			listA = listA->next; \
+		} else { \
+			tail->next = listB; \
+			listB = listB->next; \
+		} \
+		tail = tail->next; \
+	} \
+	\
+	/* Link the rest of the list that is not empty */ \
+	tail->next = (listA != NULL) ? listA : listB; \
+	return mergedHead.next; \
+} \
+\
+NodeList* mergeSortSupportListBy##Criterion(NodeList* head) { \
+	/* if the list is empty or has only one node, it's already sorted (base case) */ \
+	if (head == NULL || head->next == NULL) return head; \
+	\
+	NodeList* bins[SUPPORT_LIST_SORT_BINS] = { NULL }; \
+	int usedBins = 0; \
+	\
+	while (head != NULL) { \
+		/* Detach the first node: it's a sorted run of one element */ \
+		NodeList* run = head; \
+		head = head->next; \
+		run->next = NULL; \
+		\
+		/* Merge with the (earlier) runs of the same size, carrying to the next bin */ \
+		int k = 0; \
+		while (k < SUPPORT_LIST_SORT_BINS - 1 && bins[k] != NULL) { \
+			run = mergeSupportListsBy##Criterion(bins[k], run); \
+			bins[k] = NULL; \
+			k++; \
+		} \
+		if (bins[k] != NULL) { /* last bin: never reached with less than 2^63 nodes */ \
+			run = mergeSupportListsBy##Criterion(bins[k], run); \
+		} \
+		bins[k] = run; \
+		if (k >= usedBins) usedBins = k + 1; \
+	} \
+	\
+	/* Higher bins hold earlier nodes */ \
+	NodeList* sorted = NULL; \
+	for (int k=0; k<usedBins; k++) { \
+		if (bins[k] != NULL) { \
+			sorted = mergeSupportListsBy##Criterion(bins[k], sorted); \
+		} \
+	} \
+	\
+	return sorted; \
+}
+
+ACTIVITY_SORT_CRITERIA(DEFINE_SUPPORT_LIST_SORT)
+
+/*
+ * mergeSortSupportList
+ * 
+ * Syntactic Specification:
+ *   NodeList* mergeSortSupportList(NodeList* head, int sortBy);
+ * 
+ * Semantic Specification:
+ *   Sorts a linked list of activities according to the specified criterion
+ *   (sortBy) with the merge sort specialized for that criterion
+ *   (see DEFINE_SUPPORT_LIST_SORT): the criterion is checked once per sort,
+ *   not once per comparison.
  * 
  * Preconditions:
  *   - head can be NULL or point to a valid node
+ *   - sortBy must be a valid integer value (0-12)
  * 
  * Postconditions:
- *   - If head is NULL: returns NULL
- *   - Otherwise: divides the list and returns pointer to the second half
- *   - The first half remains linked to head
- *   - The connection between the two halves is broken
+ *   - Returns pointer to the new head of the sorted list
+ *   - If the list is empty or has one element: returns head unchanged
+ *   - The resulting list is sorted according to the sortBy criterion
+ *     (by ID for invalid sortBy values, like 'compareActivityBy()')
  * 
  * Side Effects:
- *   - Modifies the original list structure by breaking connections
- *   - Modifies next pointers to divide the list
- *   - Does not allocate or deallocate memory
+ *   - Completely modifies the original list structure
+ *   - Reorganizes all list pointers
  */
-NodeList* splitSupportList(NodeList* head) {
-	if (head == NULL) return NULL;
-
-	NodeList* ptrSlow = head;
-	NodeList* ptrFast = head; // prtFast moves at 2X
-
-	// Move ptrSlow one step and ptrFast two steps (until ptrFast reaches the end)
-	while (ptrFast != NULL && ptrFast->next != NULL) {
-		ptrFast = ptrFast->next->next;
-		if (ptrFast != NULL) {
-			ptrSlow = ptrSlow->next;
-		}
+NodeList* mergeSortSupportList(NodeList* head, int sortBy) {
+	switch (sortBy) {
+#define SUPPORT_LIST_SORT_CASE(criterionSortBy, Criterion) \
+		case criterionSortBy: return mergeSortSupportListBy##Criterion(head);
+		ACTIVITY_SORT_CRITERIA(SUPPORT_LIST_SORT_CASE)
+#undef SUPPORT_LIST_SORT_CASE
+		default: return mergeSortSupportListById(head);
 	}
-
-	// Split the list into two halves
-	NodeList* temp = ptrSlow->next;
-	ptrSlow->next = NULL;
-	return temp;
 }
 
 /*
- * mergeSupportLists
+ * sortSupportList
  * 
  * Syntactic Specification:
- *   NodeList* mergeSupportLists(NodeList* listA, NodeList* listB, int sortBy);
+ *   void sortSupportList(ActivitiesContainerSupportList list, int sortBy);
  * 
  * Semantic Specification:
- *   Support function for merge sort that merges two sorted lists into 
- *   a single sorted list according to the criterion specified by sortBy.
+ *   Sorts an activity list according to the specified criterion using 
+ *   the (non recursive, bottom-up) merge sort algorithm. Modifies the original list.
  * 
  * Preconditions:
- *   - listA and listB can be NULL or point to already sorted lists
- *   - sortBy must be a valid integer value (0-11) that specifies the 
+ *   - list must be a valid pointer to a listItem structure (not NULL)
+ *   - sortBy must be a valid integer value (0-12) that specifies the 
  *     sorting criterion
  * 
  * Postconditions:
- *   - Returns a sorted list containing all elements from listA and listB
- *   - If both lists are NULL: returns NULL
- *   - If one list is NULL: returns the other list
- *   - Sorting follows the criterion specified by sortBy
+ *   - If the list is empty: no effect
+ *   - If the list is not empty: it is sorted according to the sortBy criterion
+ *   - The list's head field points to the new first sorted element
  * 
  * Side Effects:
- *   - Modifies the structure of the original lists by reconnecting nodes
- *   - Reorganizes pointers to merge the lists
- *   - Does not allocate new memory for nodes
+ *   - Permanently modifies the order of elements in the list
+ *   - Reorders all elements in the list
+ *   - Updates the head pointer of the main structure
  */
-NodeList* mergeSupportLists(NodeList* listA, NodeList* listB, int sortBy) {
-	if (listA == NULL && listB == NULL) return NULL;
-
-	// If either list is empty, return the other list
-	if (listA == NULL) return listB;
-	if (listB == NULL) return listA;
-
-	// Pick the smaller value between listA and listB nodes
-	int cmp = 0;
-	if (listA->activity == NULL && listB->activity != NULL) {
-		cmp = 1;
-	} else if (listA->activity != NULL && listB->activity == NULL) {
-		cmp = -1;
-	} else if (listA->activity != NULL && listB->activity != NULL) {		
-		cmp = compareActivityBy(listA->activity, listB->activity, sortBy);
-	}
+void sortSupportList(ActivitiesContainerSupportList list, int sortBy) {
+	if ( isSupportListEmpty(list) == 1 ) return;
 	
-	if (cmp < 0) { //listA->data < listB->data
-		// Recursively merge the rest of the lists and link the result to the current node
-		listA->next = mergeSupportLists(listA->next, listB, sortBy);
-		return listA;
-	} else {
-		// Recursively merge the rest of the lists and link the result to the current node
-		listB->next = mergeSupportLists(listA, listB->next, sortBy);
-		return listB;
-	}
+	list->head = mergeSortSupportList(list->head, sortBy); 
 }
 
 /*
- * mergeSortSupportList
+ * reverseSupportListNodes
  * 
  * Syntactic Specification:
- *   NodeList* mergeSortSupportList(NodeList* head, int sortBy);
+ *   NodeList* reverseSupportListNodes(NodeList* head);
  * 
  * Semantic Specification:
- *   Implements the recursive merge sort algorithm to sort a linked 
- *   list of activities according to the specified criterion (sortBy).
+ *   Reverses the order of the nodes of a linked list.
  * 
  * Preconditions:
  *   - head can be NULL or point to a valid node
- *   - sortBy must be a valid integer value (0-11)
  * 
  * Postconditions:
- *   - Returns pointer to the new head of the sorted list
- *   - If the list is empty or has one element: returns head unchanged
- *   - The resulting list is sorted according to the sortBy criterion
+ *   - Returns the new head (the old last node)
  * 
  * Side Effects:
- *   - Completely modifies the original list structure
- *   - Uses the stack for recursion
- *   - Recursively divides the list into sublists
- *   - Sorts and merges the sublists
- *   - Reorganizes all list pointers
+ *   - Modifies the next pointers of all the nodes
  */
-NodeList* mergeSortSupportList(NodeList* head, int sortBy) {
-
-	// if the list is empty or has only one node, it's already sorted (base case)
-	if (head == NULL || head->next == NULL) return head;
-
-	// Split the list into two halves
-	NodeList* secondHalf = splitSupportList(head);
-
-	// Recursively sort each half
-	head = mergeSortSupportList(head, sortBy);
-	secondHalf = mergeSortSupportList(secondHalf, sortBy);
-
-	// Merge the two sorted halves
-	return mergeSupportLists(head, secondHalf, sortBy);
+NodeList* reverseSupportListNodes(NodeList* head) {
+	NodeList* reversed = NULL;
+
+	while (head != NULL) {
+		NodeList* nextNode = head->next;
+		head->next = reversed;
+		reversed = head;
+		head = nextNode;
+	}
+	return reversed;
 }
 
 /*
- * sortSupportList
+ * sortSupportListParallel
  * 
  * Syntactic Specification:
- *   void sortSupportList(ActivitiesContainerSupportList list, int sortBy);
+ *   void sortSupportListParallel(ActivitiesContainerSupportList list, int sortBy, int threadCount);
  * 
  * Semantic Specification:
- *   Sorts an activity list according to the specified criterion using 
- *   the merge sort algorithm. Modifies the original list.
+ *   Sorts an activity list according to the specified criterion with the
+ *   same result as 'sortSupportList()' (equivalent activities included).
+ *   With at least SUPPORT_PARALLEL_SORT_THRESHOLD activities, the activities
+ *   are copied to a support vector and sorted there by several threads
+ *   (see 'sortSupportVectorParallel()'), then written back into the nodes.
+ *   Shorter lists are sorted with 'sortSupportList()'.
  * 
  * Preconditions:
  *   - list must be a valid pointer to a listItem structure (not NULL)
- *   - sortBy must be a valid integer value (0-11) that specifies the 
+ *   - sortBy must be a valid integer value (0-12) that specifies the 
  *     sorting criterion
+ *   - threadCount is the maximum number of threads (0 or less: one per online processor)
  * 
  * Postconditions:
  *   - If the list is empty: no effect
- *   - If the list is not empty: it is sorted according to the sortBy criterion
- *   - The list's head field points to the new first sorted element
+ *   - If the list is not empty: it is sorted according to the sortBy criterion,
+ *     in the same order whatever the number of threads
  * 
  * Side Effects:
  *   - Permanently modifies the order of elements in the list
- *   - Reorders all elements in the list
- *   - Updates the head pointer of the main structure
+ *   - May create and join threads
+ *   - Allocates and deallocates a temporary vector (if its allocation fails,
+ *     'sortSupportList()' is used)
  */
-void sortSupportList(ActivitiesContainerSupportList list, int sortBy) {
+void sortSupportListParallel(ActivitiesContainerSupportList list, int sortBy, int threadCount) {
 	if ( isSupportListEmpty(list) == 1 ) return;
-	
-	list->head = mergeSortSupportList(list->head, sortBy); 
+
+	int count = 0;
+	for (NodeList* currentNode = list->head; currentNode != NULL; currentNode = currentNode->next) {
+		count++;
+	}
+	if (count < SUPPORT_PARALLEL_SORT_THRESHOLD) {
+		sortSupportList(list, sortBy);
+		return;
+	}
+
+	// The list merge sort puts equivalent activities in reverse list order, the
+	// vector sort keeps their order: copying the activities from the reversed
+	// list gives the same result as 'sortSupportList()'
+	list->head = reverseSupportListNodes(list->head);
+
+	ActivitiesContainerSupportVector vector = newSupportVector();
+	if (vector != NULL) {
+		for (NodeList* currentNode = list->head; currentNode != NULL; currentNode = currentNode->next) {
+			addActivityToSupportVector(vector, currentNode->activity);
+		}
+	}
+	if (getSupportVectorSize(vector) != count) {
+		deleteSupportVector(&vector);
+		list->head = reverseSupportListNodes(list->head);
+		sortSupportList(list, sortBy);
+		return;
+	}
+
+	sortSupportVectorParallel(vector, sortBy, threadCount);
+
+	// The nodes are interchangeable: they just receive the activities in sorted order
+	int index = 0;
+	for (NodeList* currentNode = list->head; currentNode != NULL; currentNode = currentNode->next) {
+		currentNode->activity = getActivityFromSupportVector(vector, index++);
+	}
+
+	deleteSupportVector(&vector);
 }
 
 
@@ -2,6 +2,7 @@
 #define ACTIVITIES_CONTAINER_SUPPORT_LIST_H             // Macro definition to avoid multiple inclusions
 
 #include "activity.h"
+#include "activities_container_support_vector.h"
 
 // Declare an opaque type for the activities support list.
 typedef struct listItem* ActivitiesContainerSupportList;
@@ -96,11 +97,11 @@ void deleteSupportList(ActivitiesContainerSupportList* list);
  * 
  * Semantic Specification:
  *   Sorts an activity list according to the specified criterion using 
- *   the merge sort algorithm. Modifies the original list.
+ *   the (non recursive, bottom-up) merge sort algorithm. Modifies the original list.
  * 
  * Preconditions:
  *   - list must be a valid pointer to a listItem structure (not NULL)
- *   - sortBy must be a valid integer value (0-11) that specifies the 
+ *   - sortBy must be a valid integer value (0-12) that specifies the 
  *     sorting criterion
  * 
  * Postconditions:
@@ -115,6 +116,39 @@ void deleteSupportList(ActivitiesContainerSupportList* list);
  */
 void sortSupportList(ActivitiesContainerSupportList list, int sortBy);
 
+/*
+ * sortSupportListParallel
+ * 
+ * Syntactic Specification:
+ *   void sortSupportListParallel(ActivitiesContainerSupportList list, int sortBy, int threadCount);
+ * 
+ * Semantic Specification:
+ *   Sorts an activity list according to the specified criterion with the
+ *   same result as 'sortSupportList()' (equivalent activities included).
+ *   With at least SUPPORT_PARALLEL_SORT_THRESHOLD activities, the activities
+ *   are copied to a support vector and sorted there by several threads
+ *   (see 'sortSupportVectorParallel()'), then written back into the nodes.
+ *   Shorter lists are sorted with 'sortSupportList()'.
+ * 
+ * Preconditions:
+ *   - list must be a valid pointer to a listItem structure (not NULL)
+ *   - sortBy must be a valid integer value (0-12) that specifies the 
+ *     sorting criterion
+ *   - threadCount is the maximum number of threads (0 or less: one per online processor)
+ * 
+ * Postconditions:
+ *   - If the list is empty: no effect
+ *   - If the list is not empty: it is sorted according to the sortBy criterion,
+ *     in the same order whatever the number of threads
+ * 
+ * Side Effects:
+ *   - Permanently modifies the order of elements in the list
+ *   - May create and join threads
+ *   - Allocates and deallocates a temporary vector (if its allocation fails,
+ *     'sortSupportList()' is used)
+ */
+void sortSupportListParallel(ActivitiesContainerSupportList list, int sortBy, int threadCount);
+
 /*
  * printActivitiesInSupportList
  * 
@@ -0,0 +1,1237 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "activity_helper.h"
+#include "activities_container_support_vector.h"
+
+#define SUPPORT_VECTOR_INITIAL_CAPACITY 16
+#define SUPPORT_VECTOR_INSERTION_SORT_LIMIT 16 // ranges up to this length are sorted by insertion
+#define SUPPORT_VECTOR_RADIX_SORT_THRESHOLD 512 // keyed sorts of at least this many activities use the radix sort
+#define SORT_KEY_DIGITS 12 // radix digits (bytes) of a (key, id) pair: 4 of the id, then 8 of the key
+#define SUPPORT_VECTOR_MAX_SORT_THREADS 64 // upper bound of the threads used by the parallel sort
+
+
+/*
+ * "struct vectorItem" Documentation
+ *
+ * Syntactic Specification:
+ *   struct vectorItem {
+ *       Activity* items;
+ *       int size;
+ *       int capacity;
+ *   };
+ *
+ * Semantic Specification:
+ *   Contiguous growable array of activity pointers. The activities are not
+ *   owned by the vector (like in the support list).
+ *
+ * Fields:
+ *   - items: Array of activity pointers (NULL until the first insertion)
+ *   - size: Number of elements in the vector
+ *   - capacity: Number of elements the array can hold before being reallocated
+ */
+struct vectorItem {
+	Activity* items;
+	int size;
+	int capacity;
+};
+
+
+/*
+ * "struct sortKeyItem" Documentation
+ *
+ * Syntactic Specification:
+ *   typedef struct sortKeyItem {
+ *       long long key;
+ *       int id;
+ *       Activity activity;
+ *   } SortKeyItem;
+ *
+ * Semantic Specification:
+ *   An activity decorated with its precomputed sort key and its ID (tiebreaker).
+ */
+typedef struct sortKeyItem {
+	long long key;
+	int id;
+	Activity activity;
+} SortKeyItem;
+
+
+/*
+ * "struct parallelSortTask" Documentation
+ *
+ * Syntactic Specification:
+ *   typedef struct parallelSortTask {
+ *       Activity* source;
+ *       Activity* destination;
+ *       const int* runBounds;
+ *       int runCount;
+ *       int from;
+ *       int to;
+ *       int sortBy;
+ *   } ParallelSortTask;
+ *
+ * Semantic Specification:
+ *   The work of one thread of the parallel sort, in one of its phases.
+ *
+ * Fields:
+ *   - source: Array being sorted (chunk phase) or holding the sorted runs (merge phase)
+ *   - destination: Array receiving the merged runs (merge phase only)
+ *   - runBounds: runCount + 1 boundaries of the sorted runs in source (merge phase only)
+ *   - runCount: Number of sorted runs in source (merge phase only)
+ *   - from, to: Chunk of source to sort (chunk phase) or slice of destination to fill (merge phase)
+ *   - sortBy: Sorting criterion
+ */
+typedef struct parallelSortTask {
+	Activity* source;
+	Activity* destination;
+	const int* runBounds;
+	int runCount;
+	int from;
+	int to;
+	int sortBy;
+} ParallelSortTask;
+
+
+
+/*
+ * compareSupportVectorItems
+ *
+ * Syntactic Specification:
+ *   int compareSupportVectorItems(Activity a, Activity b, int sortBy);
+ *
+ * Semantic Specification:
+ *   Compares two activities according to the criterion specified by sortBy.
+ *   NULL activities are placed after all the others.
+ *
+ * Preconditions:
+ *   - sortBy must be a valid integer value (0-12)
+ *
+ * Postconditions:
+ *   - Returns a negative value if a comes before b, 0 if they are
+ *     equivalent, a positive value otherwise
+ *
+ * Side Effects:
+ *   - None
+ */
+int compareSupportVectorItems(Activity a, Activity b, int sortBy) {
+	if (a == NULL && b != NULL) return 1;
+	if (a != NULL && b == NULL) return -1;
+	if (a == NULL && b == NULL) return 0;
+
+	return compareActivityBy(a, b, sortBy);
+}
+
+/*
+ * insertionSortActivities
+ *
+ * Syntactic Specification:
+ *   void insertionSortActivities(Activity* items, int from, int to, int sortBy);
+ *
+ * Semantic Specification:
+ *   Stable insertion sort of items[from..to) (used on short ranges).
+ *
+ * Preconditions:
+ *   - 0 <= from <= to <= length of items
+ *
+ * Postconditions:
+ *   - items[from..to) is sorted, equivalent activities keep their order
+ *
+ * Side Effects:
+ *   - Modifies items
+ */
+void insertionSortActivities(Activity* items, int from, int to, int sortBy) {
+	for (int i=from+1; i<to; i++) {
+		Activity current = items[i];
+		int j = i - 1;
+		while (j >= from && compareSupportVectorItems(items[j], current, sortBy) > 0) {
+			items[j + 1] = items[j];
+			j--;
+		}
+		items[j + 1] = current;
+	}
+}
+
+/*
+ * DEFINE_SUPPORT_VECTOR_STABLE_SORT
+ *
+ * Syntactic Specification:
+ *   DEFINE_SUPPORT_VECTOR_STABLE_SORT(sortBy, Criterion)
+ *
+ * Semantic Specification:
+ *   Template (used with ACTIVITY_SORT_CRITERIA) that defines the stable sort
+ *   specialized for one sorting criterion. The comparator
+ *   'compareActivityBy##Criterion()' is called directly, so the compiler can
+ *   inline it. For each criterion it defines:
+ *
+ *   - int compareSupportVectorItemsBy##Criterion(Activity a, Activity b);
+ *       Compares two activities (NULL activities are placed after all the others).
+ *
+ *   - void insertionSortActivitiesBy##Criterion(Activity* items, int from, int to);
+ *       Stable insertion sort of items[from..to) (used on short ranges).
+ *
+ *   - void mergeActivitiesRunsBy##Criterion(Activity* source, Activity* destination, int from, int middle, int to);
+ *       Merges the sorted runs source[from..middle) and source[middle..to)
+ *       into destination[from..to). On equivalent activities the one from
+ *       the first run is taken first (stability).
+ *
+ *   - void mergeActivitiesRunsSliceBy##Criterion(Activity* source, Activity* destination, int from, int middle, int to, int sliceFrom, int sliceTo);
+ *       Writes only destination[sliceFrom..sliceTo) (from <= sliceFrom <= sliceTo <= to)
+ *       of the merge of source[from..middle) and source[middle..to), with
+ *       the same result as 'mergeActivitiesRunsBy##Criterion()'. The split
+ *       point of each run is found with a binary search along the merge path,
+ *       so disjoint slices of the same merge can be filled by different threads.
+ *
+ *   - void stableSortActivitiesBy##Criterion(Activity* items, int size);
+ *       Bottom-up merge sort with a buffer of 'size' elements: runs of
+ *       SUPPORT_VECTOR_INSERTION_SORT_LIMIT elements are sorted by insertion,
+ *       then merged alternating between the array and the buffer (insertion
+ *       sort of the whole array if the buffer can't be allocated).
+ *
+ * Side Effects:
+ *   - The generated functions modify the arrays they receive
+ */
+#define DEFINE_SUPPORT_VECTOR_STABLE_SORT(sortBy, Criterion) \
+int compareSupportVectorItemsBy##Criterion(Activity a, Activity b) { \
+	if (a == NULL && b != NULL) return 1; \
+	if (a != NULL && b == NULL) return -1; \
+	if (a == NULL && b == NULL) return 0; \
+	\
+	return compareActivityBy##Criterion(a, b); \
+} \
+\
+void insertionSortActivitiesBy##Criterion(Activity* items, int from, int to) { \
+	for (int i=from+1; i<to; i++) { \
+		Activity current = items[i]; \
+		int j = i - 1; \
+		while (j >= from && compareSupportVectorItemsBy##Criterion(items[j], current) > 0) { \
+			items[j + 1] = items[j]; \
+			j--; \
+		} \
+		items[j + 1] = current; \
+	} \
+} \
+\
+void mergeActivitiesRunsBy##Criterion(Activity* source, Activity* destination, int from, int middle, int to) { \
+	int i = from; \
+	int j = middle; \
+	int k = from; \
+	\
+	while (i < middle && j < to) { \
+		if (compareSupportVectorItemsBy##Criterion(source[j], source[i]) < 0) { \
+			destination[k++] = source[j++]; \
+		} else { \
+			destination[k++] = source[i++]; \
+		} \
+	} \
+	\
+	while (i < middle) destination[k++] = source[i++]; \
+	while (j < to) destination[k++] = source[j++]; \
+} \
+\
+void mergeActivitiesRunsSliceBy##Criterion(Activity* source, Activity* destination, int from, int middle, int to, int sliceFrom, int sliceTo) { \
+	/* Merge path: how many elements of the first run are among the first 'diagonal' merged ones */ \
+	int diagonal = sliceFrom - from; \
+	int low = (diagonal > to - middle) ? diagonal - (to - middle) : 0; \
+	int high = (diagonal < middle - from) ? diagonal : middle - from; \
+	while (low < high) { \
+		int mid = low + (high - low) / 2; \
+		if (compareSupportVectorItemsBy##Criterion(source[middle + diagonal - mid - 1], source[from + mid]) < 0) { \
+			high = mid; \
+		} else { \
+			low = mid + 1; \
+		} \
+	} \
+	\
+	int i = from + low; \
+	int j = middle + diagonal - low; \
+	for (int k=sliceFrom; k<sliceTo; k++) { \
+		if (j < to && (i >= middle || compareSupportVectorItemsBy##Criterion(source[j], source[i]) < 0)) { \
+			destination[k] = source[j++]; \
+		} else { \
+			destination[k] = source[i++]; \
+		} \
+	} \
+} \
+\
+void stableSortActivitiesBy##Criterion(Activity* items, int size) { \
+	if (size < 2) return; \
+	\
+	Activity* buffer = (Activity*)malloc(size * sizeof(Activity)); \
+	if (buffer == NULL) { \
+		insertionSortActivitiesBy##Criterion(items, 0, size); \
+		return; \
+	} \
+	\
+	for (int from=0; from<size; from+=SUPPORT_VECTOR_INSERTION_SORT_LIMIT) { \
+		int to = (from + SUPPORT_VECTOR_INSERTION_SORT_LIMIT < size) ? from + SUPPORT_VECTOR_INSERTION_SORT_LIMIT : size; \
+		insertionSortActivitiesBy##Criterion(items, from, to); \
+	} \
+	\
+	Activity* source = items; \
+	Activity* destination = buffer; \
+	for (int width=SUPPORT_VECTOR_INSERTION_SORT_LIMIT; width<size; width*=2) { \
+		for (int from=0; from<size; from+=2*width) { \
+			int middle = (from + width < size) ? from + width : size; \
+			int to = (middle + width < size) ? middle + width : size; \
+			mergeActivitiesRunsBy##Criterion(source, destination, from, middle, to); \
+		} \
+		Activity* swap = source; \
+		source = destination; \
+		destination = swap; \
+	} \
+	\
+	if (source != items) { \
+		memcpy(items, source, size * sizeof(Activity)); \
+	} \
+	free(buffer); \
+}
+
+ACTIVITY_SORT_CRITERIA(DEFINE_SUPPORT_VECTOR_STABLE_SORT)
+
+/*
+ * stableSortActivities
+ *
+ * Syntactic Specification:
+ *   void stableSortActivities(Activity* items, int size, int sortBy);
+ *
+ * Semantic Specification:
+ *   Stable sort of the array with the routine specialized for the criterion
+ *   (see DEFINE_SUPPORT_VECTOR_STABLE_SORT): the criterion is checked once
+ *   per sort, not once per comparison.
+ *
+ * Preconditions:
+ *   - items has at least 'size' elements
+ *   - sortBy must be a valid integer value (0-12); other values mean 0 (ID)
+ *
+ * Postconditions:
+ *   - items is sorted, equivalent activities keep their order
+ *
+ * Side Effects:
+ *   - Modifies items
+ *   - Allocates and deallocates a temporary buffer
+ */
+void stableSortActivities(Activity* items, int size, int sortBy) {
+	switch (sortBy) {
+#define SUPPORT_VECTOR_STABLE_SORT_CASE(criterionSortBy, Criterion) \
+		case criterionSortBy: stableSortActivitiesBy##Criterion(items, size); break;
+		ACTIVITY_SORT_CRITERIA(SUPPORT_VECTOR_STABLE_SORT_CASE)
+#undef SUPPORT_VECTOR_STABLE_SORT_CASE
+		default: stableSortActivitiesById(items, size); break;
+	}
+}
+
+/*
+ * mergeActivitiesRunsSlice
+ *
+ * Syntactic Specification:
+ *   void mergeActivitiesRunsSlice(Activity* source, Activity* destination, int from, int middle, int to, int sliceFrom, int sliceTo, int sortBy);
+ *
+ * Semantic Specification:
+ *   Fills destination[sliceFrom..sliceTo) with the corresponding slice of the
+ *   stable merge of the sorted runs source[from..middle) and source[middle..to),
+ *   with the routine specialized for the criterion (see DEFINE_SUPPORT_VECTOR_STABLE_SORT).
+ *
+ * Preconditions:
+ *   - from <= middle <= to and from <= sliceFrom <= sliceTo <= to
+ *   - both runs are sorted according to sortBy
+ *   - sortBy must be a valid integer value (0-12); other values mean 0 (ID)
+ *
+ * Postconditions:
+ *   - destination[sliceFrom..sliceTo) holds the slice of the merged runs
+ *
+ * Side Effects:
+ *   - Modifies destination[sliceFrom..sliceTo) only
+ */
+void mergeActivitiesRunsSlice(Activity* source, Activity* destination, int from, int middle, int to, int sliceFrom, int sliceTo, int sortBy) {
+	switch (sortBy) {
+#define SUPPORT_VECTOR_MERGE_SLICE_CASE(criterionSortBy, Criterion) \
+		case criterionSortBy: mergeActivitiesRunsSliceBy##Criterion(source, destination, from, middle, to, sliceFrom, sliceTo); break;
+		ACTIVITY_SORT_CRITERIA(SUPPORT_VECTOR_MERGE_SLICE_CASE)
+#undef SUPPORT_VECTOR_MERGE_SLICE_CASE
+		default: mergeActivitiesRunsSliceById(source, destination, from, middle, to, sliceFrom, sliceTo); break;
+	}
+}
+
+/*
+ * sortActivitiesChunkTask
+ *
+ * Syntactic Specification:
+ *   void* sortActivitiesChunkTask(void* argument);
+ *
+ * Semantic Specification:
+ *   Thread routine of the chunk phase of the parallel sort: stable sort of
+ *   source[from..to) of the task.
+ *
+ * Preconditions:
+ *   - argument points to a valid ParallelSortTask
+ *
+ * Postconditions:
+ *   - Returns NULL; source[from..to) is sorted
+ *
+ * Side Effects:
+ *   - Modifies the chunk of the task (chunks of different tasks are disjoint)
+ */
+void* sortActivitiesChunkTask(void* argument) {
+	ParallelSortTask* task = (ParallelSortTask*)argument;
+
+	stableSortActivities(task->source + task->from, task->to - task->from, task->sortBy);
+	return NULL;
+}
+
+/*
+ * mergeActivitiesRunsTask
+ *
+ * Syntactic Specification:
+ *   void* mergeActivitiesRunsTask(void* argument);
+ *
+ * Semantic Specification:
+ *   Thread routine of a merge phase of the parallel sort: the runs of source
+ *   are merged in pairs (run 0 with run 1, run 2 with run 3, ...; a last
+ *   unpaired run is copied) and the task fills only destination[from..to),
+ *   which can span the end of a pair and the beginning of the next one.
+ *
+ * Preconditions:
+ *   - argument points to a valid ParallelSortTask
+ *
+ * Postconditions:
+ *   - Returns NULL; destination[from..to) holds its slice of the merged pairs
+ *
+ * Side Effects:
+ *   - Modifies destination[from..to) only (slices of different tasks are disjoint)
+ */
+void* mergeActivitiesRunsTask(void* argument) {
+	ParallelSortTask* task = (ParallelSortTask*)argument;
+
+	for (int run=0; run<task->runCount; run+=2) {
+		int from = task->runBounds[run];
+		int middle = task->runBounds[run + 1];
+		int to = (run + 2 <= task->runCount) ? task->runBounds[run + 2] : middle;
+
+		int sliceFrom = (task->from > from) ? task->from : from;
+		int sliceTo = (task->to < to) ? task->to : to;
+		if (sliceFrom < sliceTo) {
+			mergeActivitiesRunsSlice(task->source, task->destination, from, middle, to, sliceFrom, sliceTo, task->sortBy);
+		}
+	}
+	return NULL;
+}
+
+/*
+ * runParallelSortTasks
+ *
+ * Syntactic Specification:
+ *   void runParallelSortTasks(void* (*routine)(void*), ParallelSortTask* tasks, int taskCount);
+ *
+ * Semantic Specification:
+ *   Runs routine on every task, one thread per task, and waits for all of them.
+ *   A task whose thread can't be created is run by the calling thread, so the
+ *   result never depends on how many threads were actually started.
+ *
+ * Preconditions:
+ *   - 0 < taskCount <= SUPPORT_VECTOR_MAX_SORT_THREADS
+ *   - the tasks write disjoint parts of the arrays
+ *
+ * Postconditions:
+ *   - All the tasks are done
+ *
+ * Side Effects:
+ *   - Creates and joins threads
+ */
+void runParallelSortTasks(void* (*routine)(void*), ParallelSortTask* tasks, int taskCount) {
+	pthread_t threads[SUPPORT_VECTOR_MAX_SORT_THREADS];
+	int started[SUPPORT_VECTOR_MAX_SORT_THREADS];
+
+	// The calling thread takes the first task itself
+	for (int t=1; t<taskCount; t++) {
+		started[t] = (pthread_create(&threads[t], NULL, routine, &tasks[t]) == 0) ? 1 : 0;
+	}
+
+	routine(&tasks[0]);
+	for (int t=1; t<taskCount; t++) {
+		if (started[t] == 1) {
+			pthread_join(threads[t], NULL);
+		} else {
+			routine(&tasks[t]);
+		}
+	}
+}
+
+/*
+ * resolveSortThreadCount
+ *
+ * Syntactic Specification:
+ *   int resolveSortThreadCount(int threadCount, int size);
+ *
+ * Semantic Specification:
+ *   Returns the number of threads the parallel sort uses for 'size' elements:
+ *   threadCount, or the number of online processors if threadCount <= 0,
+ *   limited to SUPPORT_VECTOR_MAX_SORT_THREADS and so that every chunk holds at
+ *   least SUPPORT_VECTOR_INSERTION_SORT_LIMIT elements.
+ *
+ * Preconditions:
+ *   - size >= 0
+ *
+ * Postconditions:
+ *   - Returns a value between 1 and SUPPORT_VECTOR_MAX_SORT_THREADS
+ *
+ * Side Effects:
+ *   - None
+ */
+int resolveSortThreadCount(int threadCount, int size) {
+	if (threadCount <= 0) {
+		long processors = sysconf(_SC_NPROCESSORS_ONLN);
+		threadCount = (processors > 0 && processors < SUPPORT_VECTOR_MAX_SORT_THREADS) ? (int)processors : (processors > 0 ? SUPPORT_VECTOR_MAX_SORT_THREADS : 1);
+	}
+	if (threadCount > SUPPORT_VECTOR_MAX_SORT_THREADS) threadCount = SUPPORT_VECTOR_MAX_SORT_THREADS;
+	if (threadCount > size / SUPPORT_VECTOR_INSERTION_SORT_LIMIT) threadCount = size / SUPPORT_VECTOR_INSERTION_SORT_LIMIT;
+
+	return (threadCount > 0) ? threadCount : 1;
+}
+
+/*
+ * parallelStableSortActivities
+ *
+ * Syntactic Specification:
+ *   void parallelStableSortActivities(Activity* items, int size, int sortBy, int threadCount);
+ *
+ * Semantic Specification:
+ *   Stable sort of the array on threadCount threads. The array is split in
+ *   threadCount chunks of (almost) the same size, sorted concurrently with
+ *   'stableSortActivities()'. Then the sorted runs are merged in pairs, round
+ *   after round, alternating between the array and a buffer: in every round
+ *   the output is split in threadCount slices of the same size, and each
+ *   thread fills its slice with 'mergeActivitiesRunsSlice()', so the work
+ *   stays balanced even when one pair of runs is much longer than another.
+ *   Since a stable sort has only one possible result, the order is the same
+ *   as 'stableSortActivities()' whatever the number of threads.
+ *
+ * Preconditions:
+ *   - items has at least 'size' elements
+ *   - 1 <= threadCount <= SUPPORT_VECTOR_MAX_SORT_THREADS
+ *   - sortBy must be a valid integer value (0-12); other values mean 0 (ID)
+ *
+ * Postconditions:
+ *   - items is sorted, equivalent activities keep their order
+ *
+ * Side Effects:
+ *   - Modifies items
+ *   - Creates and joins threads, allocates and deallocates a buffer (if its
+ *     allocation fails, 'stableSortActivities()' is used)
+ */
+void parallelStableSortActivities(Activity* items, int size, int sortBy, int threadCount) {
+	Activity* buffer = (Activity*)malloc(size * sizeof(Activity));
+	if (buffer == NULL || threadCount < 2) {
+		free(buffer);
+		stableSortActivities(items, size, sortBy);
+		return;
+	}
+
+	ParallelSortTask tasks[SUPPORT_VECTOR_MAX_SORT_THREADS];
+	int runBounds[SUPPORT_VECTOR_MAX_SORT_THREADS + 1];
+	for (int t=0; t<=threadCount; t++) {
+		runBounds[t] = (int)( (long long)size * t / threadCount );
+	}
+
+	// Chunk phase: every thread sorts its own chunk
+	for (int t=0; t<threadCount; t++) {
+		tasks[t].source = items;
+		tasks[t].destination = NULL;
+		tasks[t].runBounds = NULL;
+		tasks[t].runCount = 0;
+		tasks[t].from = runBounds[t];
+		tasks[t].to = runBounds[t + 1];
+		tasks[t].sortBy = sortBy;
+	}
+	runParallelSortTasks(sortActivitiesChunkTask, tasks, threadCount);
+
+	// Merge phase: pairs of runs are merged until only one run is left
+	Activity* source = items;
+	Activity* destination = buffer;
+	int runCount = threadCount;
+	while (runCount > 1) {
+		for (int t=0; t<threadCount; t++) {
+			tasks[t].source = source;
+			tasks[t].destination = destination;
+			tasks[t].runBounds = runBounds;
+			tasks[t].runCount = runCount;
+			tasks[t].from = (int)( (long long)size * t / threadCount );
+			tasks[t].to = (int)( (long long)size * (t + 1) / threadCount );
+		}
+		runParallelSortTasks(mergeActivitiesRunsTask, tasks, threadCount);
+
+		// Each merged pair starts where its first run started
+		int mergedCount = (runCount + 1) / 2;
+		for (int run=0; run<mergedCount; run++) {
+			runBounds[run] = runBounds[2 * run];
+		}
+		runBounds[mergedCount] = size;
+		runCount = mergedCount;
+
+		Activity* swap = source;
+		source = destination;
+		destination = swap;
+	}
+
+	if (source != items) {
+		memcpy(items, source, size * sizeof(Activity));
+	}
+	free(buffer);
+}
+
+/*
+ * compareSortKeyItems
+ *
+ * Syntactic Specification:
+ *   int compareSortKeyItems(const void* a, const void* b);
+ *
+ * Semantic Specification:
+ *   Comparator for qsort(): orders two decorated activities by key and then by ID.
+ *
+ * Preconditions:
+ *   - a and b must point to valid SortKeyItem
+ *
+ * Postconditions:
+ *   - Returns a negative value, 0 or a positive value if a comes before, together or after b
+ *
+ * Side Effects:
+ *   - None
+ */
+int compareSortKeyItems(const void* a, const void* b) {
+	const SortKeyItem* itemA = (const SortKeyItem*)a;
+	const SortKeyItem* itemB = (const SortKeyItem*)b;
+
+	if (itemA->key != itemB->key) return (itemA->key < itemB->key) ? -1 : 1;
+	return (itemA->id > itemB->id) - (itemA->id < itemB->id);
+}
+
+/*
+ * sortKeyItemDigit
+ *
+ * Syntactic Specification:
+ *   unsigned int sortKeyItemDigit(const SortKeyItem* item, int digit);
+ *
+ * Semantic Specification:
+ *   Returns the byte 'digit' of the (key, id) pair, seen as a 96-bit unsigned
+ *   number whose least significant bytes are the id: digits 0-3 are the bytes
+ *   of the id, digits 4-11 the bytes of the key. The sign bits are flipped so
+ *   that the unsigned order is the signed order (negative dates first, then
+ *   zero dates, then the others, like the comparators).
+ *
+ * Preconditions:
+ *   - 0 <= digit < SORT_KEY_DIGITS
+ *
+ * Postconditions:
+ *   - Returns a value between 0 and 255
+ *
+ * Side Effects:
+ *   - None
+ */
+unsigned int sortKeyItemDigit(const SortKeyItem* item, int digit) {
+	if (digit < 4) {
+		unsigned int id = (unsigned int)item->id ^ 0x80000000u;
+		return (id >> (8 * digit)) & 0xFF;
+	}
+
+	unsigned long long key = (unsigned long long)item->key ^ 0x8000000000000000ull;
+	return (unsigned int)(key >> (8 * (digit - 4))) & 0xFF;
+}
+
+/*
+ * radixSortSortKeyItems
+ *
+ * Syntactic Specification:
+ *   void radixSortSortKeyItems(SortKeyItem* items, int count);
+ *
+ * Semantic Specification:
+ *   LSD radix sort (one byte per pass) of the decorated activities by key and
+ *   then by ID, in O(n) time. The histograms of all the digits are computed in
+ *   a single pass; the passes of the digits that are equal for all the items
+ *   (e.g. the high bytes of the dates) are skipped. If the items are already
+ *   in ID order (checked with a linear scan, e.g. a vector filled from the
+ *   tree) the 4 ID digits are skipped too: the passes on the key are stable,
+ *   so they keep the ties in ID order.
+ *
+ * Preconditions:
+ *   - items has at least 'count' elements
+ *
+ * Postconditions:
+ *   - items is sorted by key and then by ID (same order as 'compareSortKeyItems()')
+ *
+ * Side Effects:
+ *   - Modifies items
+ *   - Allocates and deallocates a buffer of 'count' elements (qsort() is used if its allocation fails)
+ */
+void radixSortSortKeyItems(SortKeyItem* items, int count) {
+	SortKeyItem* buffer = (SortKeyItem*)malloc(count * sizeof(SortKeyItem));
+	if (buffer == NULL) {
+		qsort(items, count, sizeof(SortKeyItem), compareSortKeyItems);
+		return;
+	}
+
+	int (*histograms)[256] = (int (*)[256])calloc(SORT_KEY_DIGITS, sizeof(int[256]));
+	if (histograms == NULL) {
+		free(buffer);
+		qsort(items, count, sizeof(SortKeyItem), compareSortKeyItems);
+		return;
+	}
+
+	// Digits 0-3 (the id) are needed only if the items aren't already in id order
+	int firstDigit = 4;
+	for (int i=1; i<count; i++) {
+		if (items[i - 1].id > items[i].id) {
+			firstDigit = 0;
+			break;
+		}
+	}
+
+	for (int i=0; i<count; i++) {
+		for (int digit=firstDigit; digit<SORT_KEY_DIGITS; digit++) {
+			histograms[digit][ sortKeyItemDigit(&items[i], digit) ]++;
+		}
+	}
+
+	SortKeyItem* source = items;
+	SortKeyItem* destination = buffer;
+	for (int digit=firstDigit; digit<SORT_KEY_DIGITS; digit++) {
+		int* histogram = histograms[digit];
+		if (histogram[ sortKeyItemDigit(&source[0], digit) ] == count) continue; // same byte everywhere
+
+		// Histogram to starting positions
+		int position = 0;
+		for (int value=0; value<256; value++) {
+			int valueCount = histogram[value];
+			histogram[value] = position;
+			position += valueCount;
+		}
+
+		// Stable scatter
+		for (int i=0; i<count; i++) {
+			destination[ histogram[ sortKeyItemDigit(&source[i], digit) ]++ ] = source[i];
+		}
+
+		SortKeyItem* swap = source;
+		source = destination;
+		destination = swap;
+	}
+
+	if (source != items) {
+		memcpy(items, source, count * sizeof(SortKeyItem));
+	}
+	free(histograms);
+	free(buffer);
+}
+
+/*
+ * siftDownActivities
+ *
+ * Syntactic Specification:
+ *   void siftDownActivities(Activity* items, int root, int size, int sortBy);
+ *
+ * Semantic Specification:
+ *   Moves items[root] down the max-heap items[0..size) to its place.
+ *
+ * Preconditions:
+ *   - The subtrees of 'root' are max-heaps
+ *
+ * Postconditions:
+ *   - The subtree of 'root' is a max-heap
+ *
+ * Side Effects:
+ *   - Modifies items
+ */
+void siftDownActivities(Activity* items, int root, int size, int sortBy) {
+	Activity rootItem = items[root];
+
+	while (2 * root + 1 < size) {
+		int child = 2 * root + 1;
+		if (child + 1 < size && compareSupportVectorItems(items[child], items[child + 1], sortBy) < 0) {
+			child++;
+		}
+		if (compareSupportVectorItems(rootItem, items[child], sortBy) >= 0) break;
+
+		items[root] = items[child];
+		root = child;
+	}
+
+	items[root] = rootItem;
+}
+
+/*
+ * heapSortActivities
+ *
+ * Syntactic Specification:
+ *   void heapSortActivities(Activity* items, int size, int sortBy);
+ *
+ * Semantic Specification:
+ *   In-place heapsort (O(n log n) worst case), used by introsort when quicksort degenerates.
+ *
+ * Preconditions:
+ *   - items has at least 'size' elements
+ *
+ * Postconditions:
+ *   - items is sorted
+ *
+ * Side Effects:
+ *   - Modifies items
+ */
+void heapSortActivities(Activity* items, int size, int sortBy) {
+	for (int i=size/2-1; i>=0; i--) {
+		siftDownActivities(items, i, size, sortBy);
+	}
+
+	for (int last=size-1; last>0; last--) {
+		Activity max = items[0];
+		items[0] = items[last];
+		items[last] = max;
+		siftDownActivities(items, 0, last, sortBy);
+	}
+}
+
+/*
+ * introSortActivities
+ *
+ * Syntactic Specification:
+ *   void introSortActivities(Activity* items, int size, int depthLimit, int sortBy);
+ *
+ * Semantic Specification:
+ *   Quicksort with median of three pivot and Hoare partition. Recurses on the
+ *   smaller part and loops on the larger one; switches to heapsort when
+ *   'depthLimit' partitions have been made and to insertion sort on short ranges.
+ *
+ * Preconditions:
+ *   - items has at least 'size' elements
+ *
+ * Postconditions:
+ *   - items is sorted
+ *
+ * Side Effects:
+ *   - Modifies items
+ */
+void introSortActivities(Activity* items, int size, int depthLimit, int sortBy) {
+	while (size > SUPPORT_VECTOR_INSERTION_SORT_LIMIT) {
+		if (depthLimit == 0) {
+			heapSortActivities(items, size, sortBy);
+			return;
+		}
+		depthLimit--;
+
+		// Median of three: items[0] <= items[middle] <= items[last]
+		int middle = size / 2;
+		int last = size - 1;
+		Activity swap;
+		if (compareSupportVectorItems(items[middle], items[0], sortBy) < 0) { swap = items[middle]; items[middle] = items[0]; items[0] = swap; }
+		if (compareSupportVectorItems(items[last], items[middle], sortBy) < 0) {
+			swap = items[last]; items[last] = items[middle]; items[middle] = swap;
+			if (compareSupportVectorItems(items[middle], items[0], sortBy) < 0) { swap = items[middle]; items[middle] = items[0]; items[0] = swap; }
+		}
+		Activity pivot = items[middle];
+
+		// Hoare partition: items[0..j] <= pivot <= items[j+1..size)
+		int i = -1;
+		int j = size;
+		while (1) {
+			do { i++; } while (compareSupportVectorItems(items[i], pivot, sortBy) < 0);
+			do { j--; } while (compareSupportVectorItems(items[j], pivot, sortBy) > 0);
+			if (i >= j) break;
+			swap = items[i]; items[i] = items[j]; items[j] = swap;
+		}
+
+		int leftSize = j + 1;
+		int rightSize = size - leftSize;
+		if (leftSize < rightSize) {
+			introSortActivities(items, leftSize, depthLimit, sortBy);
+			items += leftSize;
+			size = rightSize;
+		} else {
+			introSortActivities(items + leftSize, rightSize, depthLimit, sortBy);
+			size = leftSize;
+		}
+	}
+
+	insertionSortActivities(items, 0, size, sortBy);
+}
+
+
+
+/*
+ * newSupportVector
+ *
+ * Syntactic Specification:
+ *   ActivitiesContainerSupportVector newSupportVector(void);
+ *
+ * Semantic Specification:
+ *   Creates and initializes a new empty vector to contain activities.
+ *   The elements (activity pointers) are kept in a contiguous growable array.
+ *
+ * Preconditions:
+ *   - No specific preconditions
+ *
+ * Postconditions:
+ *   - If memory allocation succeeds: returns a valid pointer to an empty vector
+ *   - If allocation fails: returns NULL
+ *
+ * Side Effects:
+ *   - Allocates dynamic memory for a vectorItem structure
+ */
+ActivitiesContainerSupportVector newSupportVector(void) {
+	ActivitiesContainerSupportVector vector = (struct vectorItem*)malloc(sizeof(struct vectorItem));
+	if (vector != NULL) {
+		vector->items = NULL;
+		vector->size = 0;
+		vector->capacity = 0;
+	}
+	return vector;
+}
+
+/*
+ * addActivityToSupportVector
+ *
+ * Syntactic Specification:
+ *   void addActivityToSupportVector(ActivitiesContainerSupportVector vector, Activity activity);
+ *
+ * Semantic Specification:
+ *   Adds an activity (the activity pointer) to the end of the vector.
+ *   When the array is full its capacity is doubled (amortized O(1) insertion).
+ *
+ * Preconditions:
+ *   - vector must be a valid pointer to a vectorItem structure (not NULL)
+ *
+ * Postconditions:
+ *   - If allocation succeeds: the activity is the last element of the vector
+ *   - If allocation fails: the vector remains unchanged
+ *
+ * Side Effects:
+ *   - Modifies the vector structure
+ *   - May reallocate the array of the elements
+ */
+void addActivityToSupportVector(ActivitiesContainerSupportVector vector, Activity activity) {
+	if (vector == NULL) return;
+
+	if (vector->size == vector->capacity) {
+		int newCapacity = (vector->capacity == 0) ? SUPPORT_VECTOR_INITIAL_CAPACITY : vector->capacity * 2;
+		Activity* newItems = (Activity*)realloc(vector->items, newCapacity * sizeof(Activity));
+		if (newItems == NULL) return; // return (vector is unchanged)
+
+		vector->items = newItems;
+		vector->capacity = newCapacity;
+	}
+
+	vector->items[vector->size] = activity;
+	vector->size++;
+}
+
+/*
+ * deleteSupportVector
+ *
+ * Syntactic Specification:
+ *   void deleteSupportVector(ActivitiesContainerSupportVector* vector);
+ *
+ * Semantic Specification:
+ *   Completely deallocates a vector (the activities are not deallocated).
+ *   Sets the vector pointer to NULL to avoid dangling references.
+ *   The parameter is a pointer passed by reference.
+ *
+ * Preconditions:
+ *   - vector can be NULL or point to a valid/NULL pointer
+ *
+ * Postconditions:
+ *   - All allocated memory for the vector is freed
+ *   - *vector is set to NULL
+ *   - If vector or *vector were NULL, the function has no effect
+ *
+ * Side Effects:
+ *   - Frees memory of the array and of the main structure
+ *   - Modifies the value of the pointer passed by reference
+ */
+void deleteSupportVector(ActivitiesContainerSupportVector* vector) {
+	if (vector == NULL || *vector == NULL) return;
+
+	free( (*vector)->items );
+	free(*vector);
+	*vector = NULL;
+}
+
+/*
+ * isSupportVectorEmpty
+ *
+ * Syntactic Specification:
+ *   int isSupportVectorEmpty(ActivitiesContainerSupportVector vector);
+ *
+ * Semantic Specification:
+ *   Checks if the vector is empty.
+ *
+ * Preconditions:
+ *   - No specific preconditions (vector can be NULL)
+ *
+ * Postconditions:
+ *   - Returns 1 if vector is NULL or has no elements
+ *   - Returns 0 otherwise
+ *
+ * Side Effects:
+ *   - No side effects
+ */
+int isSupportVectorEmpty(ActivitiesContainerSupportVector vector) {
+	return (vector == NULL || vector->size == 0) ? 1 : 0;
+}
+
+/*
+ * getSupportVectorSize
+ *
+ * Syntactic Specification:
+ *   int getSupportVectorSize(ActivitiesContainerSupportVector vector);
+ *
+ * Semantic Specification:
+ *   Returns the number of elements in the vector.
+ *
+ * Preconditions:
+ *   - No specific preconditions (vector can be NULL)
+ *
+ * Postconditions:
+ *   - Returns the number of elements (0 if vector is NULL)
+ *
+ * Side Effects:
+ *   - No side effects
+ */
+int getSupportVectorSize(ActivitiesContainerSupportVector vector) {
+	return (vector == NULL) ? 0 : vector->size;
+}
+
+/*
+ * sortSupportVector
+ *
+ * Syntactic Specification:
+ *   void sortSupportVector(ActivitiesContainerSupportVector vector, int sortBy);
+ *
+ * Semantic Specification:
+ *   Sorts the vector according to the specified criterion with a stable
+ *   merge sort (with a temporary buffer): equivalent activities keep
+ *   their insertion order. NULL activities are placed at the end.
+ *
+ * Preconditions:
+ *   - vector must be a valid pointer to a vectorItem structure (not NULL)
+ *   - sortBy must be a valid integer value (0-12) that specifies the
+ *     sorting criterion
+ *
+ * Postconditions:
+ *   - If the vector is empty: no effect
+ *   - Otherwise: it is sorted according to the sortBy criterion
+ *
+ * Side Effects:
+ *   - Permanently modifies the order of elements in the vector
+ *   - Allocates and deallocates a temporary buffer (if its allocation fails,
+ *     a stable insertion sort is used)
+ */
+void sortSupportVector(ActivitiesContainerSupportVector vector, int sortBy) {
+	if ( isSupportVectorEmpty(vector) == 1 ) return;
+
+	stableSortActivities(vector->items, vector->size, sortBy);
+}
+
+/*
+ * sortSupportVectorUnstable
+ *
+ * Syntactic Specification:
+ *   void sortSupportVectorUnstable(ActivitiesContainerSupportVector vector, int sortBy);
+ *
+ * Semantic Specification:
+ *   Sorts the vector according to the specified criterion with an in-place
+ *   introsort (quicksort with median of three, heapsort when the recursion
+ *   gets too deep, insertion sort on short ranges). Faster than
+ *   'sortSupportVector()' but the order of equivalent activities is not
+ *   defined. NULL activities are placed at the end.
+ *
+ * Preconditions:
+ *   - vector must be a valid pointer to a vectorItem structure (not NULL)
+ *   - sortBy must be a valid integer value (0-12) that specifies the
+ *     sorting criterion
+ *
+ * Postconditions:
+ *   - If the vector is empty: no effect
+ *   - Otherwise: it is sorted according to the sortBy criterion
+ *
+ * Side Effects:
+ *   - Permanently modifies the order of elements in the vector
+ *   - No memory allocation, O(log n) stack
+ */
+void sortSupportVectorUnstable(ActivitiesContainerSupportVector vector, int sortBy) {
+	if ( isSupportVectorEmpty(vector) == 1 ) return;
+
+	// Depth limit: 2 * floor(log2(size))
+	int depthLimit = 0;
+	for (int size=vector->size; size>1; size/=2) {
+		depthLimit += 2;
+	}
+
+	introSortActivities(vector->items, vector->size, depthLimit, sortBy);
+}
+
+/*
+ * sortSupportVectorByKey
+ *
+ * Syntactic Specification:
+ *   void sortSupportVectorByKey(ActivitiesContainerSupportVector vector, int sortBy);
+ *
+ * Semantic Specification:
+ *   Sorts the vector according to the specified criterion with precomputed
+ *   keys (decorate-sort-undecorate): the integer key of each activity (see
+ *   'activityNumericSortKey()') is extracted once, then the (key, id, activity)
+ *   triples are sorted comparing only integers, with the ID as tiebreaker.
+ *   Equivalent activities are therefore ordered by ID. NULL activities are
+ *   placed at the end. For the string criteria (name, description, course)
+ *   it falls back to 'sortSupportVectorParallel()'.
+ *   With at least SUPPORT_VECTOR_RADIX_SORT_THRESHOLD activities the triples
+ *   are sorted with an LSD radix sort (linear time), otherwise with qsort().
+ *
+ * Preconditions:
+ *   - vector must be a valid pointer to a vectorItem structure (not NULL)
+ *   - sortBy must be a valid integer value (0-12) that specifies the
+ *     sorting criterion
+ *
+ * Postconditions:
+ *   - If the vector is empty: no effect
+ *   - Otherwise: it is sorted according to the sortBy criterion (and then by ID)
+ *
+ * Side Effects:
+ *   - Permanently modifies the order of elements in the vector
+ *   - Allocates and deallocates a temporary array of keys (if its allocation
+ *     fails, 'sortSupportVectorParallel()' is used)
+ */
+void sortSupportVectorByKey(ActivitiesContainerSupportVector vector, int sortBy) {
+	if ( isSupportVectorEmpty(vector) == 1 ) return;
+
+	SortKeyItem* decorated = NULL;
+	if (hasActivityNumericSortKey(sortBy) == 1) {
+		decorated = (SortKeyItem*)malloc(vector->size * sizeof(SortKeyItem));
+	}
+	if (decorated == NULL) {
+		sortSupportVectorParallel(vector, sortBy, 0);
+		return;
+	}
+
+	// Decorate (NULL activities are left out and put back at the end)
+	int count = 0;
+	for (int i=0; i<vector->size; i++) {
+		Activity activity = vector->items[i];
+		if (activity != NULL) {
+			decorated[count].key = activityNumericSortKey(activity, sortBy);
+			decorated[count].id = getActivityId(activity);
+			decorated[count].activity = activity;
+			count++;
+		}
+	}
+
+	if (count >= SUPPORT_VECTOR_RADIX_SORT_THRESHOLD) {
+		radixSortSortKeyItems(decorated, count);
+	} else {
+		qsort(decorated, count, sizeof(SortKeyItem), compareSortKeyItems);
+	}
+
+	// Undecorate
+	for (int i=0; i<count; i++) {
+		vector->items[i] = decorated[i].activity;
+	}
+	for (int i=count; i<vector->size; i++) {
+		vector->items[i] = NULL;
+	}
+
+	free(decorated);
+}
+
+/*
+ * sortSupportVectorParallel
+ *
+ * Syntactic Specification:
+ *   void sortSupportVectorParallel(ActivitiesContainerSupportVector vector, int sortBy, int threadCount);
+ *
+ * Semantic Specification:
+ *   Sorts the vector according to the specified criterion with the same
+ *   result as 'sortSupportVector()' (stable, NULL activities at the end).
+ *   With at least SUPPORT_PARALLEL_SORT_THRESHOLD activities the work is
+ *   split across threads: the chunks are sorted concurrently and then merged
+ *   in parallel, partitioning every merge along its merge path.
+ *
+ * Preconditions:
+ *   - vector must be a valid pointer to a vectorItem structure (not NULL)
+ *   - sortBy must be a valid integer value (0-12) that specifies the
+ *     sorting criterion
+ *   - threadCount is the maximum number of threads (0 or less: one per online processor)
+ *
+ * Postconditions:
+ *   - If the vector is empty: no effect
+ *   - Otherwise: it is sorted according to the sortBy criterion, in the same
+ *     order whatever the number of threads
+ *
+ * Side Effects:
+ *   - Permanently modifies the order of elements in the vector
+ *   - May create and join threads
+ *   - Allocates and deallocates a temporary buffer
+ */
+void sortSupportVectorParallel(ActivitiesContainerSupportVector vector, int sortBy, int threadCount) {
+	if ( isSupportVectorEmpty(vector) == 1 ) return;
+
+	if (vector->size < SUPPORT_PARALLEL_SORT_THRESHOLD) {
+		stableSortActivities(vector->items, vector->size, sortBy);
+		return;
+	}
+
+	parallelStableSortActivities(vector->items, vector->size, sortBy, resolveSortThreadCount(threadCount, vector->size));
+}
+
+/*
+ * getActivityFromSupportVector
+ *
+ * Syntactic Specification:
+ *   Activity getActivityFromSupportVector(ActivitiesContainerSupportVector vector, int index);
+ *
+ * Semantic Specification:
+ *   Returns the activity at position 'index' of the vector.
+ *
+ * Preconditions:
+ *   - No specific preconditions (vector can be NULL)
+ *
+ * Postconditions:
+ *   - Returns the activity, or NULL if vector is NULL or index is out of range
+ *
+ * Side Effects:
+ *   - No side effects
+ */
+Activity getActivityFromSupportVector(ActivitiesContainerSupportVector vector, int index) {
+	if (vector == NULL || index < 0 || index >= vector->size) return NULL;
+
+	return vector->items[index];
+}
+
+/*
+ * printActivitiesInSupportVector
+ *
+ * Syntactic Specification:
+ *   void printActivitiesInSupportVector(ActivitiesContainerSupportVector vector, int printType, FILE* file);
+ *
+ * Semantic Specification:
+ *   Prints all activities of the vector to the specified file (or to screen if file is NULL),
+ *   in the order of the vector.
+ *
+ * Preconditions:
+ *   - vector must be a valid pointer to a vectorItem structure
+ *   - printType must be 0 (list format) or 1 (progress format); other values mean 0
+ *   - file can be NULL (screen) or a file opened for writing
+ *
+ * Postconditions:
+ *   - If the vector is empty: no output
+ *   - Otherwise: all activities are printed in the chosen format
+ *
+ * Side Effects:
+ *   - Output to stdout or writing to file
+ */
+void printActivitiesInSupportVector(ActivitiesContainerSupportVector vector, int printType, FILE* file) {
+	if ( isSupportVectorEmpty(vector) == 1 ) return;
+
+	int pType = (printType == 0 || printType == 1) ? printType : 0;
+
+	for (int i=0; i<vector->size; i++) {
+		(pType == 0) ? printActivityForListToScreenOrFile(vector->items[i], file) : printActivityProgressForListToScreenOrFile(vector->items[i], file);
+	}
+}
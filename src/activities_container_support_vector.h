@@ -0,0 +1,291 @@
+#ifndef ACTIVITIES_CONTAINER_SUPPORT_VECTOR_H             //  Start of inclusion block
+#define ACTIVITIES_CONTAINER_SUPPORT_VECTOR_H             // Macro definition to avoid multiple inclusions
+
+#include <stdio.h>
+#include "activity.h"
+
+// Declare an opaque type for the activities support vector (contiguous variant of the support list).
+typedef struct vectorItem* ActivitiesContainerSupportVector;
+
+// Minimum number of activities for which the parallel sorts actually use more than one thread
+// (it can be changed at build time, e.g. -DSUPPORT_PARALLEL_SORT_THRESHOLD=100000)
+#ifndef SUPPORT_PARALLEL_SORT_THRESHOLD
+#define SUPPORT_PARALLEL_SORT_THRESHOLD 65536
+#endif
+
+
+/*
+ * newSupportVector
+ *
+ * Syntactic Specification:
+ *   ActivitiesContainerSupportVector newSupportVector(void);
+ *
+ * Semantic Specification:
+ *   Creates and initializes a new empty vector to contain activities.
+ *   The elements (activity pointers) are kept in a contiguous growable array.
+ *
+ * Preconditions:
+ *   - No specific preconditions
+ *
+ * Postconditions:
+ *   - If memory allocation succeeds: returns a valid pointer to an empty vector
+ *   - If allocation fails: returns NULL
+ *
+ * Side Effects:
+ *   - Allocates dynamic memory for a vectorItem structure
+ */
+ActivitiesContainerSupportVector newSupportVector(void);
+
+/*
+ * addActivityToSupportVector
+ *
+ * Syntactic Specification:
+ *   void addActivityToSupportVector(ActivitiesContainerSupportVector vector, Activity activity);
+ *
+ * Semantic Specification:
+ *   Adds an activity (the activity pointer) to the end of the vector.
+ *   When the array is full its capacity is doubled (amortized O(1) insertion).
+ *
+ * Preconditions:
+ *   - vector must be a valid pointer to a vectorItem structure (not NULL)
+ *
+ * Postconditions:
+ *   - If allocation succeeds: the activity is the last element of the vector
+ *   - If allocation fails: the vector remains unchanged
+ *
+ * Side Effects:
+ *   - Modifies the vector structure
+ *   - May reallocate the array of the elements
+ */
+void addActivityToSupportVector(ActivitiesContainerSupportVector vector, Activity activity);
+
+/*
+ * deleteSupportVector
+ *
+ * Syntactic Specification:
+ *   void deleteSupportVector(ActivitiesContainerSupportVector* vector);
+ *
+ * Semantic Specification:
+ *   Completely deallocates a vector (the activities are not deallocated).
+ *   Sets the vector pointer to NULL to avoid dangling references.
+ *   The parameter is a pointer passed by reference.
+ *
+ * Preconditions:
+ *   - vector can be NULL or point to a valid/NULL pointer
+ *
+ * Postconditions:
+ *   - All allocated memory for the vector is freed
+ *   - *vector is set to NULL
+ *   - If vector or *vector were NULL, the function has no effect
+ *
+ * Side Effects:
+ *   - Frees memory of the array and of the main structure
+ *   - Modifies the value of the pointer passed by reference
+ */
+void deleteSupportVector(ActivitiesContainerSupportVector* vector);
+
+/*
+ * isSupportVectorEmpty
+ *
+ * Syntactic Specification:
+ *   int isSupportVectorEmpty(ActivitiesContainerSupportVector vector);
+ *
+ * Semantic Specification:
+ *   Checks if the vector is empty.
+ *
+ * Preconditions:
+ *   - No specific preconditions (vector can be NULL)
+ *
+ * Postconditions:
+ *   - Returns 1 if vector is NULL or has no elements
+ *   - Returns 0 otherwise
+ *
+ * Side Effects:
+ *   - No side effects
+ */
+int isSupportVectorEmpty(ActivitiesContainerSupportVector vector);
+
+/*
+ * getSupportVectorSize
+ *
+ * Syntactic Specification:
+ *   int getSupportVectorSize(ActivitiesContainerSupportVector vector);
+ *
+ * Semantic Specification:
+ *   Returns the number of elements in the vector.
+ *
+ * Preconditions:
+ *   - No specific preconditions (vector can be NULL)
+ *
+ * Postconditions:
+ *   - Returns the number of elements (0 if vector is NULL)
+ *
+ * Side Effects:
+ *   - No side effects
+ */
+int getSupportVectorSize(ActivitiesContainerSupportVector vector);
+
+/*
+ * sortSupportVector
+ *
+ * Syntactic Specification:
+ *   void sortSupportVector(ActivitiesContainerSupportVector vector, int sortBy);
+ *
+ * Semantic Specification:
+ *   Sorts the vector according to the specified criterion with a stable
+ *   merge sort (with a temporary buffer): equivalent activities keep
+ *   their insertion order. NULL activities are placed at the end.
+ *
+ * Preconditions:
+ *   - vector must be a valid pointer to a vectorItem structure (not NULL)
+ *   - sortBy must be a valid integer value (0-12) that specifies the
+ *     sorting criterion
+ *
+ * Postconditions:
+ *   - If the vector is empty: no effect
+ *   - Otherwise: it is sorted according to the sortBy criterion
+ *
+ * Side Effects:
+ *   - Permanently modifies the order of elements in the vector
+ *   - Allocates and deallocates a temporary buffer (if its allocation fails,
+ *     a stable insertion sort is used)
+ */
+void sortSupportVector(ActivitiesContainerSupportVector vector, int sortBy);
+
+/*
+ * sortSupportVectorUnstable
+ *
+ * Syntactic Specification:
+ *   void sortSupportVectorUnstable(ActivitiesContainerSupportVector vector, int sortBy);
+ *
+ * Semantic Specification:
+ *   Sorts the vector according to the specified criterion with an in-place
+ *   introsort (quicksort with median of three, heapsort when the recursion
+ *   gets too deep, insertion sort on short ranges). Faster than
+ *   'sortSupportVector()' but the order of equivalent activities is not
+ *   defined. NULL activities are placed at the end.
+ *
+ * Preconditions:
+ *   - vector must be a valid pointer to a vectorItem structure (not NULL)
+ *   - sortBy must be a valid integer value (0-12) that specifies the
+ *     sorting criterion
+ *
+ * Postconditions:
+ *   - If the vector is empty: no effect
+ *   - Otherwise: it is sorted according to the sortBy criterion
+ *
+ * Side Effects:
+ *   - Permanently modifies the order of elements in the vector
+ *   - No memory allocation, O(log n) stack
+ */
+void sortSupportVectorUnstable(ActivitiesContainerSupportVector vector, int sortBy);
+
+/*
+ * sortSupportVectorByKey
+ *
+ * Syntactic Specification:
+ *   void sortSupportVectorByKey(ActivitiesContainerSupportVector vector, int sortBy);
+ *
+ * Semantic Specification:
+ *   Sorts the vector according to the specified criterion with precomputed
+ *   keys (decorate-sort-undecorate): the integer key of each activity (see
+ *   'activityNumericSortKey()') is extracted once, then the (key, id, activity)
+ *   triples are sorted comparing only integers, with the ID as tiebreaker.
+ *   Equivalent activities are therefore ordered by ID. NULL activities are
+ *   placed at the end. For the string criteria (name, description, course)
+ *   it falls back to 'sortSupportVectorParallel()'.
+ *   Above a size threshold the triples are sorted with an LSD radix sort
+ *   (linear time), otherwise with qsort().
+ *
+ * Preconditions:
+ *   - vector must be a valid pointer to a vectorItem structure (not NULL)
+ *   - sortBy must be a valid integer value (0-12) that specifies the
+ *     sorting criterion
+ *
+ * Postconditions:
+ *   - If the vector is empty: no effect
+ *   - Otherwise: it is sorted according to the sortBy criterion (and then by ID)
+ *
+ * Side Effects:
+ *   - Permanently modifies the order of elements in the vector
+ *   - Allocates and deallocates a temporary array of keys (if its allocation
+ *     fails, 'sortSupportVectorParallel()' is used)
+ */
+void sortSupportVectorByKey(ActivitiesContainerSupportVector vector, int sortBy);
+
+/*
+ * sortSupportVectorParallel
+ *
+ * Syntactic Specification:
+ *   void sortSupportVectorParallel(ActivitiesContainerSupportVector vector, int sortBy, int threadCount);
+ *
+ * Semantic Specification:
+ *   Sorts the vector according to the specified criterion with the same
+ *   result as 'sortSupportVector()' (stable, NULL activities at the end).
+ *   With at least SUPPORT_PARALLEL_SORT_THRESHOLD activities the work is
+ *   split across threads: the chunks are sorted concurrently and then merged
+ *   in parallel, partitioning every merge along its merge path.
+ *
+ * Preconditions:
+ *   - vector must be a valid pointer to a vectorItem structure (not NULL)
+ *   - sortBy must be a valid integer value (0-12) that specifies the
+ *     sorting criterion
+ *   - threadCount is the maximum number of threads (0 or less: one per online processor)
+ *
+ * Postconditions:
+ *   - If the vector is empty: no effect
+ *   - Otherwise: it is sorted according to the sortBy criterion, in the same
+ *     order whatever the number of threads
+ *
+ * Side Effects:
+ *   - Permanently modifies the order of elements in the vector
+ *   - May create and join threads
+ *   - Allocates and deallocates a temporary buffer
+ */
+void sortSupportVectorParallel(ActivitiesContainerSupportVector vector, int sortBy, int threadCount);
+
+/*
+ * getActivityFromSupportVector
+ *
+ * Syntactic Specification:
+ *   Activity getActivityFromSupportVector(ActivitiesContainerSupportVector vector, int index);
+ *
+ * Semantic Specification:
+ *   Returns the activity at position 'index' of the vector.
+ *
+ * Preconditions:
+ *   - No specific preconditions (vector can be NULL)
+ *
+ * Postconditions:
+ *   - Returns the activity, or NULL if vector is NULL or index is out of range
+ *
+ * Side Effects:
+ *   - No side effects
+ */
+Activity getActivityFromSupportVector(ActivitiesContainerSupportVector vector, int index);
+
+/*
+ * printActivitiesInSupportVector
+ *
+ * Syntactic Specification:
+ *   void printActivitiesInSupportVector(ActivitiesContainerSupportVector vector, int printType, FILE* file);
+ *
+ * Semantic Specification:
+ *   Prints all activities of the vector to the specified file (or to screen if file is NULL),
+ *   in the order of the vector.
+ *
+ * Preconditions:
+ *   - vector must be a valid pointer to a vectorItem structure
+ *   - printType must be 0 (list format) or 1 (progress format); other values mean 0
+ *   - file can be NULL (screen) or a file opened for writing
+ *
+ * Postconditions:
+ *   - If the vector is empty: no output
+ *   - Otherwise: all activities are printed in the chosen format
+ *
+ * Side Effects:
+ *   - Output to stdout or writing to file
+ */
+void printActivitiesInSupportVector(ActivitiesContainerSupportVector vector, int printType, FILE* file);
+
+#endif // ACTIVITIES_CONTAINER_SUPPORT_VECTOR_H          // End of inclusion block
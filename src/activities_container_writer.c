@@ -0,0 +1,597 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "activity.h"
+#include "activities_container_writer.h"
+#include "activities_container_checksum.h"
+
+// Maximum number of characters of a formatted number (the 20 digits of a 64 bit value and the sign)
+#define ACTIVITY_WRITER_NUMBER_LENGTH 21
+
+
+/*
+ * "struct activityWriter" Documentation
+ *
+ * Syntactic Specification:
+ * struct activityWriter {
+ *     int fd;
+ *     char* filename;
+ *     char* tempFilename;
+ *     char* buffer;
+ *     size_t used;
+ *     int failed;
+ *     ActivityChecksums checksums;
+ * };
+ *
+ * Semantic Specification:
+ * Buffered writer of a file through a temporary file that replaces it when complete.
+ *
+ * Fields:
+ * - fd: Descriptor of the temporary file
+ * - filename: Name of the file to replace
+ * - tempFilename: Name of the temporary file
+ * - buffer: Data not yet written (ACTIVITY_WRITER_BUFFER_SIZE bytes)
+ * - used: Number of bytes in 'buffer'
+ * - failed: 1 if a write has failed (the file must not be replaced)
+ * - checksums: CRC32C of the blocks written, NULL if the file has no checksum file
+ */
+struct activityWriter {
+	int fd;
+	char* filename;
+	char* tempFilename;
+	char* buffer;
+	size_t used;
+	int failed;
+	ActivityChecksums checksums;
+};
+
+
+/*
+ * writeAllToDescriptor
+ *
+ * Syntactic Specification:
+ * int writeAllToDescriptor(int fd, const char* data, size_t size);
+ *
+ * Semantic Specification:
+ * Writes all the bytes to a file descriptor, repeating 'write()' after a partial write or an interruption.
+ *
+ * Preconditions:
+ * - 'fd' opened for writing, 'data' has at least 'size' bytes
+ *
+ * Postconditions:
+ * - Returns 0 if all the bytes have been written, 1 otherwise
+ *
+ * Side Effects:
+ * - Writing to file
+ */
+int writeAllToDescriptor(int fd, const char* data, size_t size) {
+	while (size > 0) {
+		ssize_t written = write(fd, data, size);
+		if (written < 0) {
+			if (errno == EINTR) continue;
+			return 1;
+		}
+		data += written;
+		size -= (size_t)written;
+	}
+	return 0;
+}
+
+/*
+ * flushActivityWriter
+ *
+ * Syntactic Specification:
+ * void flushActivityWriter(ActivityWriter writer);
+ *
+ * Semantic Specification:
+ * Writes the content of the buffer to the temporary file and empties the buffer.
+ *
+ * Preconditions:
+ * - 'writer != NULL'
+ *
+ * Postconditions:
+ * - The buffer is empty; 'writer->failed' is set if the write fails
+ *
+ * Side Effects:
+ * - Writing to file
+ */
+void flushActivityWriter(ActivityWriter writer) {
+	if (writer->used > 0 && !writer->failed) {
+		addToActivityChecksums(writer->checksums, writer->buffer, writer->used);
+		if (writeAllToDescriptor(writer->fd, writer->buffer, writer->used) != 0) writer->failed = 1;
+	}
+	writer->used = 0;
+}
+
+/*
+ * reserveActivityWriter
+ *
+ * Syntactic Specification:
+ * char* reserveActivityWriter(ActivityWriter writer, size_t size);
+ *
+ * Semantic Specification:
+ * Returns room for 'size' bytes at the end of the buffer, flushing it first if they don't fit.
+ *
+ * Preconditions:
+ * - 'writer != NULL', 'size <= ACTIVITY_WRITER_BUFFER_SIZE'
+ *
+ * Postconditions:
+ * - Returns the position where the bytes can be formatted (then counted in 'writer->used' by the caller)
+ *
+ * Side Effects:
+ * - May write to file
+ */
+char* reserveActivityWriter(ActivityWriter writer, size_t size) {
+	if (ACTIVITY_WRITER_BUFFER_SIZE - writer->used < size) flushActivityWriter(writer);
+
+	return writer->buffer + writer->used;
+}
+
+/*
+ * formatUnsignedNumber
+ *
+ * Syntactic Specification:
+ * size_t formatUnsignedNumber(char* text, unsigned long long value);
+ *
+ * Semantic Specification:
+ * Writes the decimal digits of a number (as "%llu"), computed from the last one, with no format string to parse.
+ *
+ * Preconditions:
+ * - 'text' has room for ACTIVITY_WRITER_NUMBER_LENGTH characters
+ *
+ * Postconditions:
+ * - Returns the number of characters written (not terminated)
+ *
+ * Side Effects:
+ * - Writes 'text'
+ */
+size_t formatUnsignedNumber(char* text, unsigned long long value) {
+	char digits[ACTIVITY_WRITER_NUMBER_LENGTH];
+	size_t count = 0;
+	do {
+		digits[count++] = (char)('0' + value % 10);
+		value /= 10;
+	} while (value > 0);
+
+	for (size_t i = 0; i < count; i++) {
+		text[i] = digits[count - 1 - i];
+	}
+	return count;
+}
+
+/*
+ * formatSignedNumber
+ *
+ * Syntactic Specification:
+ * size_t formatSignedNumber(char* text, long long value);
+ *
+ * Semantic Specification:
+ * Writes a signed number in decimal (as "%lld").
+ *
+ * Preconditions:
+ * - 'text' has room for ACTIVITY_WRITER_NUMBER_LENGTH characters
+ *
+ * Postconditions:
+ * - Returns the number of characters written (not terminated)
+ *
+ * Side Effects:
+ * - Writes 'text'
+ */
+size_t formatSignedNumber(char* text, long long value) {
+	if (value >= 0) return formatUnsignedNumber(text, (unsigned long long)value);
+
+	text[0] = '-';
+	// the magnitude is computed in the unsigned type, so the minimum value doesn't overflow
+	return 1 + formatUnsignedNumber(text + 1, 0ULL - (unsigned long long)value);
+}
+
+/*
+ * writeStringLineToActivityWriter
+ *
+ * Syntactic Specification:
+ * void writeStringLineToActivityWriter(ActivityWriter writer, const char* string);
+ *
+ * Semantic Specification:
+ * Appends a string followed by '\n' (an empty line for a NULL string).
+ *
+ * Preconditions:
+ * - 'writer != NULL'
+ *
+ * Postconditions:
+ * - The line follows the previous data
+ *
+ * Side Effects:
+ * - May write to file
+ */
+void writeStringLineToActivityWriter(ActivityWriter writer, const char* string) {
+	if (string != NULL) writeBytesToActivityWriter(writer, string, strlen(string));
+	writeBytesToActivityWriter(writer, "\n", 1);
+}
+
+/*
+ * getWriterDirectoryName
+ *
+ * Syntactic Specification:
+ * char* getWriterDirectoryName(const char* filename);
+ *
+ * Semantic Specification:
+ * Returns the name of the directory of a file ("." for a name with no directory).
+ *
+ * Preconditions:
+ * - 'filename != NULL'
+ *
+ * Postconditions:
+ * - Returns a new string (the caller deallocates it), or NULL if memory allocation fails
+ *
+ * Side Effects:
+ * - Allocates memory
+ */
+char* getWriterDirectoryName(const char* filename) {
+	const char* slash = strrchr(filename, '/');
+	size_t length = (slash == NULL) ? 1 : (slash == filename) ? 1 : (size_t)(slash - filename);
+
+	char* directory = malloc(length + 1);
+	if (directory == NULL) return NULL;
+
+	memcpy(directory, (slash == NULL) ? "." : filename, length);
+	directory[length] = '\0';
+	return directory;
+}
+
+/*
+ * syncWriterDirectory
+ *
+ * Syntactic Specification:
+ * void syncWriterDirectory(const char* filename);
+ *
+ * Semantic Specification:
+ * Synchronizes to the disk the directory of a file, so that a rename in it survives a crash.
+ *
+ * Preconditions:
+ * - 'filename != NULL'
+ *
+ * Postconditions:
+ * - None (the synchronization is not possible on every file system: failures are ignored)
+ *
+ * Side Effects:
+ * - Synchronization of the directory
+ */
+void syncWriterDirectory(const char* filename) {
+	char* directory = getWriterDirectoryName(filename);
+	if (directory == NULL) return;
+
+	int fd = open(directory, O_RDONLY);
+	if (fd >= 0) {
+		fsync(fd);
+		close(fd);
+	}
+	free(directory);
+}
+
+/*
+ * deleteActivityWriter
+ *
+ * Syntactic Specification:
+ * void deleteActivityWriter(ActivityWriter* writer);
+ *
+ * Semantic Specification:
+ * Deallocates a writer (its temporary file must already be closed).
+ *
+ * Preconditions:
+ * - 'writer' can be NULL or point to a valid/NULL pointer
+ *
+ * Postconditions:
+ * - The memory is freed and '*writer' is set to NULL
+ *
+ * Side Effects:
+ * - Deallocates memory
+ */
+void deleteActivityWriter(ActivityWriter* writer) {
+	if (writer == NULL || *writer == NULL) return;
+
+	free((*writer)->filename);
+	free((*writer)->tempFilename);
+	free((*writer)->buffer);
+	deleteActivityChecksums(&(*writer)->checksums);
+	free(*writer);
+	*writer = NULL;
+}
+
+
+
+/*
+ * newActivityWriter
+ *
+ * Syntactic Specification:
+ * ActivityWriter newActivityWriter(const char* filename);
+ *
+ * Semantic Specification:
+ * Creates a writer for a file. The data is collected in a large buffer and written, in a few large
+ * 'write()' calls, to a temporary file in the same directory ('filename' + ACTIVITY_WRITER_TEMP_EXTENSION
+ * + process id): the file itself is replaced only by 'commitActivityWriter()', so until then (and if the
+ * program stops while writing) its previous content is untouched.
+ *
+ * Preconditions:
+ * - 'filename != NULL'
+ *
+ * Postconditions:
+ * - Returns the writer, or NULL if the temporary file can't be created or memory allocation fails
+ *
+ * Side Effects:
+ * - Creates the temporary file
+ * - Allocates memory
+ */
+ActivityWriter newActivityWriter(const char* filename) {
+	if (filename == NULL) return NULL;
+
+	ActivityWriter writer = malloc(sizeof(struct activityWriter));
+	if (writer == NULL) return NULL;
+
+	size_t filenameSize = strlen(filename) + 1;
+	size_t tempFilenameSize = filenameSize + sizeof(ACTIVITY_WRITER_TEMP_EXTENSION) + ACTIVITY_WRITER_NUMBER_LENGTH;
+	writer->fd = -1;
+	writer->filename = malloc(filenameSize);
+	writer->tempFilename = malloc(tempFilenameSize);
+	writer->buffer = malloc(ACTIVITY_WRITER_BUFFER_SIZE);
+	writer->used = 0;
+	writer->failed = 0;
+	writer->checksums = NULL;
+	if (writer->filename == NULL || writer->tempFilename == NULL || writer->buffer == NULL) {
+		deleteActivityWriter(&writer);
+		return NULL;
+	}
+
+	memcpy(writer->filename, filename, filenameSize);
+	snprintf(writer->tempFilename, tempFilenameSize, "%s" ACTIVITY_WRITER_TEMP_EXTENSION "%ld", filename, (long)getpid());
+
+	writer->fd = open(writer->tempFilename, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+	if (writer->fd < 0) {
+		deleteActivityWriter(&writer);
+		return NULL;
+	}
+
+	return writer;
+}
+
+/*
+ * enableActivityWriterChecksums
+ *
+ * Syntactic Specification:
+ * int enableActivityWriterChecksums(ActivityWriter writer);
+ *
+ * Semantic Specification:
+ * Makes the writer compute the CRC32C of the blocks of the file while it's written: 'commitActivityWriter()'
+ * then writes its checksum file too (see 'writeActivityChecksums()'), which 'verifyActivityChecksums()'
+ * checks the file against. To be called before any data is written.
+ *
+ * Preconditions:
+ * - 'writer != NULL', no data written yet
+ *
+ * Postconditions:
+ * - Returns 0 on success, 1 if memory allocation fails (the file is written with no checksum file)
+ *
+ * Side Effects:
+ * - Allocates memory
+ */
+int enableActivityWriterChecksums(ActivityWriter writer) {
+	if (writer == NULL) return 1;
+
+	if (writer->checksums == NULL) writer->checksums = newActivityChecksums();
+	return (writer->checksums == NULL) ? 1 : 0;
+}
+
+/*
+ * failActivityWriter
+ *
+ * Syntactic Specification:
+ * void failActivityWriter(ActivityWriter writer);
+ *
+ * Semantic Specification:
+ * Marks the writer as failed, as a failed write does: 'commitActivityWriter()' then discards the temporary
+ * file and keeps the file to replace. Used by the encoders that find data they can't write, like a
+ * description that can't be read from its file (see 'isActivityDescrLoaded()').
+ *
+ * Preconditions:
+ * - None
+ *
+ * Postconditions:
+ * - 'commitActivityWriter()' fails (no effect if 'writer == NULL')
+ *
+ * Side Effects:
+ * - Modification of the writer
+ */
+void failActivityWriter(ActivityWriter writer) {
+	if (writer == NULL) return;
+
+	writer->failed = 1;
+}
+
+/*
+ * writeBytesToActivityWriter
+ *
+ * Syntactic Specification:
+ * void writeBytesToActivityWriter(ActivityWriter writer, const void* data, size_t size);
+ *
+ * Semantic Specification:
+ * Appends bytes to the file: they are copied into the buffer, which is written to the temporary file
+ * when full (data larger than the buffer is written directly).
+ *
+ * Preconditions:
+ * - 'writer != NULL', 'data' has at least 'size' bytes
+ *
+ * Postconditions:
+ * - The bytes follow the previous ones; a failed write is remembered and reported by 'commitActivityWriter()'
+ *
+ * Side Effects:
+ * - May write to the temporary file
+ */
+void writeBytesToActivityWriter(ActivityWriter writer, const void* data, size_t size) {
+	if (writer == NULL || size == 0) return;
+
+	if (size > ACTIVITY_WRITER_BUFFER_SIZE - writer->used) {
+		flushActivityWriter(writer);
+		if (size > ACTIVITY_WRITER_BUFFER_SIZE) {
+			addToActivityChecksums(writer->checksums, data, size);
+			if (!writer->failed && writeAllToDescriptor(writer->fd, data, size) != 0) writer->failed = 1;
+			return;
+		}
+	}
+
+	memcpy(writer->buffer + writer->used, data, size);
+	writer->used += size;
+}
+
+/*
+ * writeNumberToActivityWriter
+ *
+ * Syntactic Specification:
+ * void writeNumberToActivityWriter(ActivityWriter writer, long long value);
+ *
+ * Semantic Specification:
+ * Appends a number in decimal (as "%lld"), converted digit by digit directly in the buffer.
+ *
+ * Preconditions:
+ * - 'writer != NULL'
+ *
+ * Postconditions:
+ * - The number follows the previous data
+ *
+ * Side Effects:
+ * - May write to the temporary file
+ */
+void writeNumberToActivityWriter(ActivityWriter writer, long long value) {
+	if (writer == NULL) return;
+
+	char* text = reserveActivityWriter(writer, ACTIVITY_WRITER_NUMBER_LENGTH);
+	writer->used += formatSignedNumber(text, value);
+}
+
+/*
+ * writeActivityToActivityWriter
+ *
+ * Syntactic Specification:
+ * void writeActivityToActivityWriter(ActivityWriter writer, Activity activity);
+ *
+ * Semantic Specification:
+ * Appends an activity in the 10-line text format, with the same bytes written by 'saveActivityToFile()'.
+ * The record is formatted directly in the buffer: the numbers are converted digit by digit, with no
+ * format string to parse.
+ *
+ * Preconditions:
+ * - 'writer != NULL'
+ *
+ * Postconditions:
+ * - The record follows the previous data (no output if 'activity == NULL')
+ * - The writer fails (see 'failActivityWriter()') if the description can't be read from its file
+ *
+ * Side Effects:
+ * - May write to the temporary file
+ */
+void writeActivityToActivityWriter(ActivityWriter writer, Activity activity) {
+	if (writer == NULL || activity == NULL) return;
+
+	char* text = reserveActivityWriter(writer, ACTIVITY_WRITER_NUMBER_LENGTH + 1);
+	size_t length = formatSignedNumber(text, getActivityId(activity));
+	text[length++] = '\n';
+	writer->used += length;
+
+	writeStringLineToActivityWriter(writer, getActivityName(activity));
+	writeStringLineToActivityWriter(writer, getActivityDescr(activity));
+	if (!isActivityDescrLoaded(activity)) writer->failed = 1;
+	writeStringLineToActivityWriter(writer, getActivityCourse(activity));
+
+	// the six numeric lines, formatted at once
+	text = reserveActivityWriter(writer, 6 * (ACTIVITY_WRITER_NUMBER_LENGTH + 1));
+	length = formatSignedNumber(text, (long long)getActivityInsertDate(activity));
+	text[length++] = '\n';
+	length += formatSignedNumber(text + length, (long long)getActivityExpiryDate(activity));
+	text[length++] = '\n';
+	length += formatSignedNumber(text + length, (long long)getActivityCompletionDate(activity));
+	text[length++] = '\n';
+	length += formatUnsignedNumber(text + length, getActivityTotalTime(activity));
+	text[length++] = '\n';
+	length += formatUnsignedNumber(text + length, getActivityUsedTime(activity));
+	text[length++] = '\n';
+	length += formatUnsignedNumber(text + length, getActivityPriority(activity));
+	text[length++] = '\n';
+	writer->used += length;
+}
+
+/*
+ * commitActivityWriter
+ *
+ * Syntactic Specification:
+ * int commitActivityWriter(ActivityWriter* writer);
+ *
+ * Semantic Specification:
+ * Completes the file: writes the rest of the buffer, synchronizes the temporary file to the disk ('fsync()'),
+ * renames it to the name of the file (replacing it at once) and synchronizes the directory. On error the
+ * temporary file is removed and the file keeps its previous content. If the checksums are enabled, the checksum
+ * file is written after the rename; if it can't be written, it's removed rather than left stale (the file is
+ * saved anyway). The parameter is a pointer passed by reference.
+ *
+ * Preconditions:
+ * - 'writer' and '*writer' not NULL
+ *
+ * Postconditions:
+ * - Returns 0 if the file has been replaced with all the data written, 1 otherwise
+ * - The writer is deallocated and '*writer' is set to NULL
+ *
+ * Side Effects:
+ * - Writing, synchronization and renaming of files
+ * - Deallocates memory
+ */
+int commitActivityWriter(ActivityWriter* writer) {
+	if (writer == NULL || *writer == NULL) return 1;
+
+	flushActivityWriter(*writer);
+	if ((*writer)->failed || fsync((*writer)->fd) != 0) {
+		discardActivityWriter(writer);
+		return 1;
+	}
+
+	int closeResult = close((*writer)->fd);
+	(*writer)->fd = -1;
+	if (closeResult != 0 || rename((*writer)->tempFilename, (*writer)->filename) != 0) {
+		discardActivityWriter(writer);
+		return 1;
+	}
+
+	syncWriterDirectory((*writer)->filename);
+	if ((*writer)->checksums != NULL && writeActivityChecksums((*writer)->checksums, (*writer)->filename) != 0) {
+		removeActivityChecksums((*writer)->filename);
+	}
+	deleteActivityWriter(writer);
+	return 0;
+}
+
+/*
+ * discardActivityWriter
+ *
+ * Syntactic Specification:
+ * void discardActivityWriter(ActivityWriter* writer);
+ *
+ * Semantic Specification:
+ * Abandons the writing: the temporary file is removed and the file keeps its previous content.
+ * The parameter is a pointer passed by reference.
+ *
+ * Preconditions:
+ * - 'writer' can be NULL or point to a valid/NULL pointer
+ *
+ * Postconditions:
+ * - The writer is deallocated and '*writer' is set to NULL
+ *
+ * Side Effects:
+ * - Removes the temporary file
+ * - Deallocates memory
+ */
+void discardActivityWriter(ActivityWriter* writer) {
+	if (writer == NULL || *writer == NULL) return;
+
+	if ((*writer)->fd >= 0) close((*writer)->fd);
+	unlink((*writer)->tempFilename);
+	deleteActivityWriter(writer);
+}
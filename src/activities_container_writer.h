@@ -0,0 +1,196 @@
+#ifndef ACTIVITIES_CONTAINER_WRITER_H             // Start of inclusion block
+#define ACTIVITIES_CONTAINER_WRITER_H             // Macro definition to avoid multiple inclusions
+
+#include <stddef.h>
+#include "activity.h"
+
+// Size of the buffer of a writer: the file is written in calls of this size
+#define ACTIVITY_WRITER_BUFFER_SIZE (1 << 20)
+// Extension added to the name of the file to get the name of the temporary file written before the replace
+#define ACTIVITY_WRITER_TEMP_EXTENSION ".tmp"
+
+// Declare an opaque type for a buffered writer that replaces a file atomically
+typedef struct activityWriter* ActivityWriter;
+
+
+/*
+ * newActivityWriter
+ *
+ * Syntactic Specification:
+ * ActivityWriter newActivityWriter(const char* filename);
+ *
+ * Semantic Specification:
+ * Creates a writer for a file. The data is collected in a large buffer and written, in a few large
+ * 'write()' calls, to a temporary file in the same directory ('filename' + ACTIVITY_WRITER_TEMP_EXTENSION
+ * + process id): the file itself is replaced only by 'commitActivityWriter()', so until then (and if the
+ * program stops while writing) its previous content is untouched.
+ *
+ * Preconditions:
+ * - 'filename != NULL'
+ *
+ * Postconditions:
+ * - Returns the writer, or NULL if the temporary file can't be created or memory allocation fails
+ *
+ * Side Effects:
+ * - Creates the temporary file
+ * - Allocates memory
+ */
+ActivityWriter newActivityWriter(const char* filename);
+
+/*
+ * enableActivityWriterChecksums
+ *
+ * Syntactic Specification:
+ * int enableActivityWriterChecksums(ActivityWriter writer);
+ *
+ * Semantic Specification:
+ * Makes the writer compute the CRC32C of the blocks of the file while it's written: 'commitActivityWriter()'
+ * then writes its checksum file too (see 'writeActivityChecksums()'), which 'verifyActivityChecksums()'
+ * checks the file against. To be called before any data is written.
+ *
+ * Preconditions:
+ * - 'writer != NULL', no data written yet
+ *
+ * Postconditions:
+ * - Returns 0 on success, 1 if memory allocation fails (the file is written with no checksum file)
+ *
+ * Side Effects:
+ * - Allocates memory
+ */
+int enableActivityWriterChecksums(ActivityWriter writer);
+
+/*
+ * failActivityWriter
+ *
+ * Syntactic Specification:
+ * void failActivityWriter(ActivityWriter writer);
+ *
+ * Semantic Specification:
+ * Marks the writer as failed, as a failed write does: 'commitActivityWriter()' then discards the temporary
+ * file and keeps the file to replace. Used by the encoders that find data they can't write, like a
+ * description that can't be read from its file (see 'isActivityDescrLoaded()').
+ *
+ * Preconditions:
+ * - None
+ *
+ * Postconditions:
+ * - 'commitActivityWriter()' fails (no effect if 'writer == NULL')
+ *
+ * Side Effects:
+ * - Modification of the writer
+ */
+void failActivityWriter(ActivityWriter writer);
+
+/*
+ * writeBytesToActivityWriter
+ *
+ * Syntactic Specification:
+ * void writeBytesToActivityWriter(ActivityWriter writer, const void* data, size_t size);
+ *
+ * Semantic Specification:
+ * Appends bytes to the file: they are copied into the buffer, which is written to the temporary file
+ * when full (data larger than the buffer is written directly).
+ *
+ * Preconditions:
+ * - 'writer != NULL', 'data' has at least 'size' bytes
+ *
+ * Postconditions:
+ * - The bytes follow the previous ones; a failed write is remembered and reported by 'commitActivityWriter()'
+ *
+ * Side Effects:
+ * - May write to the temporary file
+ */
+void writeBytesToActivityWriter(ActivityWriter writer, const void* data, size_t size);
+
+/*
+ * writeNumberToActivityWriter
+ *
+ * Syntactic Specification:
+ * void writeNumberToActivityWriter(ActivityWriter writer, long long value);
+ *
+ * Semantic Specification:
+ * Appends a number in decimal (as "%lld"), converted digit by digit directly in the buffer.
+ *
+ * Preconditions:
+ * - 'writer != NULL'
+ *
+ * Postconditions:
+ * - The number follows the previous data
+ *
+ * Side Effects:
+ * - May write to the temporary file
+ */
+void writeNumberToActivityWriter(ActivityWriter writer, long long value);
+
+/*
+ * writeActivityToActivityWriter
+ *
+ * Syntactic Specification:
+ * void writeActivityToActivityWriter(ActivityWriter writer, Activity activity);
+ *
+ * Semantic Specification:
+ * Appends an activity in the 10-line text format, with the same bytes written by 'saveActivityToFile()'.
+ * The record is formatted directly in the buffer: the numbers are converted digit by digit, with no
+ * format string to parse.
+ *
+ * Preconditions:
+ * - 'writer != NULL'
+ *
+ * Postconditions:
+ * - The record follows the previous data (no output if 'activity == NULL')
+ * - The writer fails (see 'failActivityWriter()') if the description can't be read from its file
+ *
+ * Side Effects:
+ * - May write to the temporary file
+ */
+void writeActivityToActivityWriter(ActivityWriter writer, Activity activity);
+
+/*
+ * commitActivityWriter
+ *
+ * Syntactic Specification:
+ * int commitActivityWriter(ActivityWriter* writer);
+ *
+ * Semantic Specification:
+ * Completes the file: writes the rest of the buffer, synchronizes the temporary file to the disk ('fsync()'),
+ * renames it to the name of the file (replacing it at once) and synchronizes the directory. On error the
+ * temporary file is removed and the file keeps its previous content. If the checksums are enabled, the checksum
+ * file is written after the rename; if it can't be written, it's removed rather than left stale (the file is
+ * saved anyway). The parameter is a pointer passed by reference.
+ *
+ * Preconditions:
+ * - 'writer' and '*writer' not NULL
+ *
+ * Postconditions:
+ * - Returns 0 if the file has been replaced with all the data written, 1 otherwise
+ * - The writer is deallocated and '*writer' is set to NULL
+ *
+ * Side Effects:
+ * - Writing, synchronization and renaming of files
+ * - Deallocates memory
+ */
+int commitActivityWriter(ActivityWriter* writer);
+
+/*
+ * discardActivityWriter
+ *
+ * Syntactic Specification:
+ * void discardActivityWriter(ActivityWriter* writer);
+ *
+ * Semantic Specification:
+ * Abandons the writing: the temporary file is removed and the file keeps its previous content.
+ * The parameter is a pointer passed by reference.
+ *
+ * Preconditions:
+ * - 'writer' can be NULL or point to a valid/NULL pointer
+ *
+ * Postconditions:
+ * - The writer is deallocated and '*writer' is set to NULL
+ *
+ * Side Effects:
+ * - Removes the temporary file
+ * - Deallocates memory
+ */
+void discardActivityWriter(ActivityWriter* writer);
+
+#endif // ACTIVITIES_CONTAINER_WRITER_H          // End of inclusion block
@@ -17,6 +17,20 @@
  *     unsigned int totalTime;
  *     unsigned int usedTime;
  *     short unsigned int priority;
+ *     char* nameKey;
+ *     size_t nameKeyLength;
+ *     char* descrKey;
+ *     size_t descrKeyLength;
+ *     char* courseKey;
+ *     size_t courseKeyLength;
+ *     ActivityStringSource descrSource;
+ *     off_t descrOffset;
+ *     size_t descrLength;
+ *     ActivityChangeObserver observer;
+ *     void* observerContext;
+ *     int isDirty;
+ *     long long storeSlot;
+ *     unsigned int storeSlotCount;
  * };
  * 
  * Semantic Specification:
@@ -35,6 +49,19 @@
  * - totalTime: Total allocated time for the activity in minutes (unsigned int)
  * - usedTime: Time already spent on the activity in minutes (unsigned int)
  * - priority: Priority level of the activity (short unsigned int)
+ * - nameKey, descrKey, courseKey: Collation keys of name, descr and course (see 'newCollationKey()'),
+ *   built by the first sort that compares them (see 'getActivityNameKey()') and dropped every time the
+ *   string is set; NULL until then, or if the string is NULL
+ * - nameKeyLength, descrKeyLength, courseKeyLength: Lengths in bytes of the collation keys
+ * - descrSource: File the description is still in (see 'setActivityLazyDescr()'), NULL once it's loaded:
+ *   until then descr and descrKey are NULL
+ * - descrOffset, descrLength: Position and length in bytes of the description in 'descrSource'
+ * - observer: Function notified before and after every change made by a setter (NULL if none)
+ * - observerContext: Opaque pointer passed back to the observer (e.g.: the container owning the activity)
+ * - isDirty: 1 if the activity has changed since its record was last written to a slotted store (a new
+ *   activity is dirty), 0 otherwise
+ * - storeSlot, storeSlotCount: First slot and number of slots of the record of the activity in the slotted
+ *   store it was last saved to or read from (see 'setActivityStoreSlot()'); -1 and 0 if none
  * 
  * Notes:
  * - All string fields (name, descr, course) are dynamically allocated and may be NULL
@@ -54,6 +81,20 @@ struct activity {
 	unsigned int totalTime; //minutes
 	unsigned int usedTime;  //minutes
 	short unsigned int priority;
+	char* nameKey; // Collation keys, used for sorting (NULL: not built yet)
+	size_t nameKeyLength;
+	char* descrKey;
+	size_t descrKeyLength;
+	char* courseKey;
+	size_t courseKeyLength;
+	ActivityStringSource descrSource; // File the description is loaded from when needed (NULL: loaded)
+	off_t descrOffset;
+	size_t descrLength;
+	ActivityChangeObserver observer; // Notified before and after every setter call (can be NULL)
+	void* observerContext;
+	int isDirty; // Changed since the record was written to the slotted store
+	long long storeSlot; // Record in the slotted store (-1: none)
+	unsigned int storeSlotCount;
 };
 
 
@@ -90,6 +131,41 @@ Activity newActivity( int id, char* name, char* descr, char* course,
 							time_t insertDate, time_t expiryDate, time_t completionDate, 
 							unsigned int totalTime, unsigned int usedTime, 
 							short unsigned int priority ) {
+	return newActivityWithLengths(id, name, (name != NULL) ? strlen(name) : 0, descr, (descr != NULL) ? strlen(descr) : 0,
+							course, (course != NULL) ? strlen(course) : 0, insertDate, expiryDate, completionDate,
+							totalTime, usedTime, priority);
+}
+
+/*
+ * newActivityWithLengths
+ * 
+ * Syntactic Specification:
+ * Activity newActivityWithLengths(int id, const char* name, size_t nameLength, const char* descr, size_t descrLength,
+ *                     const char* course, size_t courseLength, time_t insertDate, time_t expiryDate,
+ *                     time_t completionDate, unsigned int totalTime, unsigned int usedTime,
+ *                     short unsigned int priority);
+ * 
+ * Semantic Specification:
+ * Creates a new activity like 'newActivity()', with strings given as (pointer, length) pairs that don't
+ * need to be terminated: the bytes are copied once, straight into the strings of the activity (see
+ * 'copyStringWithLength()'). Used by the loaders to build activities from the lines of a mapped file.
+ * 
+ * Preconditions:
+ * - Sufficient memory available for allocation
+ * - String parameters may be NULL (their length is ignored), otherwise they have at least the given length
+ * 
+ * Postconditions:
+ * - Returns a pointer to an Activity initialized with the provided values
+ * - Returns NULL if allocation fails
+ * - Strings are copied, not just referenced
+ * 
+ * Side Effects:
+ * Allocates dynamic memory for a new Activity structure and its strings.
+ */
+Activity newActivityWithLengths( int id, const char* name, size_t nameLength, const char* descr, size_t descrLength,
+							const char* course, size_t courseLength, time_t insertDate, time_t expiryDate,
+							time_t completionDate, unsigned int totalTime, unsigned int usedTime,
+							short unsigned int priority ) {
 	Activity activity = (Activity)malloc(sizeof(struct activity));
 	if (activity == NULL) {
    		return NULL;
@@ -97,9 +173,16 @@ Activity newActivity( int id, char* name, char* descr, char* course,
 	 
 	activity->id = id; 
 	
-	activity->name = copyString(name);
-	activity->descr = copyString(descr);
-	activity->course = copyString(course);
+	activity->name = copyStringWithLength(name, nameLength);
+	activity->descr = copyStringWithLength(descr, descrLength);
+	activity->course = copyStringWithLength(course, courseLength);
+	
+	activity->nameKey = NULL; // built by the first sort on the string
+	activity->nameKeyLength = 0;
+	activity->descrKey = NULL;
+	activity->descrKeyLength = 0;
+	activity->courseKey = NULL;
+	activity->courseKeyLength = 0;
 	
 	activity->insertDate = insertDate;
 	activity->expiryDate = expiryDate;
@@ -108,6 +191,17 @@ Activity newActivity( int id, char* name, char* descr, char* course,
 	activity->usedTime = usedTime;
 	activity->priority = priority;
 	
+	activity->descrSource = NULL;
+	activity->descrOffset = 0;
+	activity->descrLength = 0;
+	
+	activity->observer = NULL;
+	activity->observerContext = NULL;
+	
+	activity->isDirty = 1; // not yet in any store
+	activity->storeSlot = -1;
+	activity->storeSlotCount = 0;
+	
 	return activity;
 }
 
@@ -136,6 +230,11 @@ void deleteActivity(Activity a) {
 	free(a->descr);
 	free(a->course);
 	
+	free(a->nameKey);
+	free(a->descrKey);
+	free(a->courseKey);
+	
+	releaseActivityStringSource( &(a->descrSource) );
 	free(a);
 }
 
@@ -154,6 +253,7 @@ void deleteActivity(Activity a) {
  * Postconditions:
  * - Returns a pointer to a new Activity that is a copy of old
  * - Returns NULL if old is NULL or if allocation fails
+ * - The change observer is not copied
  * 
  * Side Effects:
  * Allocates dynamic memory for a new Activity structure and its strings.
@@ -161,11 +261,323 @@ void deleteActivity(Activity a) {
 Activity copyActivity(Activity old) {
 	if(!old) return NULL;
 	
-	return newActivity(old->id, old->name, old->descr, old->course, 
+	return newActivity(old->id, old->name, getActivityDescr(old), old->course, 
 							old->insertDate, old->expiryDate, old->completionDate, 
 							old->totalTime, old->usedTime, old->priority);
 }
 
+/*
+ * setActivityLazyDescr
+ * 
+ * Syntactic Specification:
+ * void setActivityLazyDescr(Activity a, ActivityStringSource source, off_t offset, size_t length);
+ * 
+ * Semantic Specification:
+ * Leaves the description of the activity in a file: only its position and length are kept, and the
+ * string is read from the file by the first call that needs it
+ * ('getActivityDescr()', 'getActivityDescrKey()'). Used by the loaders to keep out of memory the
+ * descriptions of activities that are only listed. It's not a setter: the observer is not notified.
+ * 
+ * Preconditions:
+ * - 'a' has no description ('NULL'), 'source != NULL', 'length > 0'
+ * 
+ * Postconditions:
+ * - The activity takes a reference to the source (released when the description is loaded or replaced)
+ * - No effect if a is NULL
+ * 
+ * Side Effects:
+ * - Modification of the Activity object's state
+ */
+void setActivityLazyDescr(Activity a, ActivityStringSource source, off_t offset, size_t length) {
+	if (a == NULL || source == NULL) return;
+	
+	retainActivityStringSource(source);
+	releaseActivityStringSource( &(a->descrSource) );
+	a->descrSource = source;
+	a->descrOffset = offset;
+	a->descrLength = length;
+}
+
+/*
+ * loadActivityLazyDescr
+ * 
+ * Syntactic Specification:
+ * void loadActivityLazyDescr(Activity a);
+ * 
+ * Semantic Specification:
+ * Reads the description left in a file by 'setActivityLazyDescr()', if not yet loaded. The check of a
+ * loaded description costs an atomic read; the loading is serialized by 'lockActivityStringSources()',
+ * so an activity read by several threads at once loads it only once. If the read fails, the description
+ * stays in the file (NULL for now, see 'isActivityDescrLoaded()') and the next call tries again.
+ * 
+ * Preconditions:
+ * - 'a != NULL'
+ * 
+ * Postconditions:
+ * - 'descr' is loaded, the reference to the source is released (unless the read fails)
+ * 
+ * Side Effects:
+ * - Reading from file
+ * - Allocates memory
+ */
+void loadActivityLazyDescr(Activity a) {
+	if (__atomic_load_n(&a->descrSource, __ATOMIC_ACQUIRE) == NULL) return;
+	
+	lockActivityStringSources();
+	ActivityStringSource source = a->descrSource;
+	if (source != NULL) {
+		char* descr = readActivityStringSource(source, a->descrOffset, a->descrLength);
+		if (descr != NULL) {
+			a->descr = descr;
+			__atomic_store_n(&a->descrSource, NULL, __ATOMIC_RELEASE);
+			releaseActivityStringSource(&source);
+		}
+	}
+	unlockActivityStringSources();
+}
+
+/*
+ * isActivityDescrLoaded
+ * 
+ * Syntactic Specification:
+ * int isActivityDescrLoaded(Activity a);
+ * 
+ * Semantic Specification:
+ * Tells if the description of the activity is in memory, that is if it was never left in a file by
+ * 'setActivityLazyDescr()' or if it has been loaded. After 'getActivityDescr()' it tells a description
+ * that is really NULL from one whose read has failed: a writer that finds 0 must not save the activity.
+ * 
+ * Preconditions:
+ * - None
+ * 
+ * Postconditions:
+ * - Returns 1 if the description is in memory (or if a is NULL), 0 if it's still in its file
+ * 
+ * Side Effects:
+ * - None
+ */
+int isActivityDescrLoaded(Activity a) {
+	if (a == NULL) return 1;
+	
+	return __atomic_load_n(&a->descrSource, __ATOMIC_ACQUIRE) == NULL;
+}
+
+/*
+ * getActivityCollationKey
+ * 
+ * Syntactic Specification:
+ * const char* getActivityCollationKey(const char* str, char** key, size_t* storedKeyLength, size_t* keyLength);
+ * 
+ * Semantic Specification:
+ * Returns the collation key of a string of an activity, kept in '*key' and '*storedKeyLength': if it's
+ * not built yet, it's built now. The check of a built key costs an atomic read; a key is built without
+ * any lock (not behind the file reads of 'lockActivityStringSources()') and published with an atomic
+ * compare and exchange, so the threads of a parallel sort build their keys at once: if two of them build
+ * the key of the same string, the first published is kept and the other copy is freed. The length is the
+ * same for every copy, so it's stored before the key is published.
+ * 
+ * Preconditions:
+ * - 'key', 'storedKeyLength' are the fields of the key of 'str', 'keyLength != NULL'
+ * - 'str' is not changed by another thread meanwhile
+ * 
+ * Postconditions:
+ * - Returns the key and stores its length in '*keyLength'
+ * - Returns NULL ('*keyLength' is 0) if 'str' is NULL or the key could not be allocated (the next call
+ *   tries again)
+ * 
+ * Side Effects:
+ * - Allocates memory (first call)
+ */
+const char* getActivityCollationKey(const char* str, char** key, size_t* storedKeyLength, size_t* keyLength) {
+	*keyLength = 0;
+	if (str == NULL) return NULL;
+	
+	char* builtKey = __atomic_load_n(key, __ATOMIC_ACQUIRE);
+	if (builtKey == NULL) {
+		size_t length = 0;
+		char* newKey = newCollationKey(str, &length);
+		if (newKey == NULL) return NULL;
+		
+		__atomic_store_n(storedKeyLength, length, __ATOMIC_RELAXED); // published by the exchange below
+		if (__atomic_compare_exchange_n(key, &builtKey, newKey, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+			builtKey = newKey;
+		} else {
+			free(newKey); // another thread has published the same key ('builtKey')
+		}
+	}
+	
+	*keyLength = __atomic_load_n(storedKeyLength, __ATOMIC_RELAXED);
+	return builtKey;
+}
+
+/*
+ * setActivityChangeObserver
+ * 
+ * Syntactic Specification:
+ * void setActivityChangeObserver(Activity a, ActivityChangeObserver observer, void* context);
+ * 
+ * Semantic Specification:
+ * Registers the function to call every time a field of the activity is changed by a setter.
+ * Used by the activities container to know when an activity stored in it has been modified.
+ * 
+ * Preconditions:
+ * - 'observer' can be NULL (no notification)
+ * 
+ * Postconditions:
+ * - Every setter call calls 'observer(a, field, ACTIVITY_CHANGE_BEFORE, context)' before changing the field
+ *   and 'observer(a, field, ACTIVITY_CHANGE_AFTER, context)' after ('field' is one of ACTIVITY_FIELD_*)
+ * - Only one observer is kept: a new registration replaces the previous one
+ * - No effect if a is NULL
+ * 
+ * Side Effects:
+ * - Modification of the Activity object's state
+ */
+void setActivityChangeObserver(Activity a, ActivityChangeObserver observer, void* context) {
+	if (a == NULL) return;
+	
+	a->observer = observer;
+	a->observerContext = context;
+}
+
+/*
+ * isActivityDirty
+ * 
+ * Syntactic Specification:
+ * int isActivityDirty(Activity a);
+ * 
+ * Semantic Specification:
+ * Tells if the activity has changed since its record was last written to (or read from) a slotted store
+ * or a sharded directory: every setter marks the activity as dirty, and a new activity is dirty until
+ * it's saved to one of them.
+ * 
+ * Preconditions:
+ * - None
+ * 
+ * Postconditions:
+ * - Returns 1 if the activity is dirty, 0 otherwise (or if a is NULL)
+ * 
+ * Side Effects:
+ * - None
+ */
+int isActivityDirty(Activity a) {
+	if (a == NULL) return 0;
+	
+	return a->isDirty;
+}
+
+/*
+ * getActivityStoreSlot
+ * 
+ * Syntactic Specification:
+ * long long getActivityStoreSlot(Activity a, unsigned int* slotCount);
+ * 
+ * Semantic Specification:
+ * Returns the position of the record of the activity in the slotted store it was last saved to or read
+ * from (see 'setActivityStoreSlot()').
+ * 
+ * Preconditions:
+ * - 'slotCount != NULL'
+ * 
+ * Postconditions:
+ * - Returns the first slot of the record and sets '*slotCount' to its number of slots
+ * - Returns -1 and sets '*slotCount' to 0 if the activity has no record (or a is NULL)
+ * 
+ * Side Effects:
+ * - None
+ */
+long long getActivityStoreSlot(Activity a, unsigned int* slotCount) {
+	if (a == NULL) {
+		*slotCount = 0;
+		return -1;
+	}
+	
+	*slotCount = a->storeSlotCount;
+	return a->storeSlot;
+}
+
+/*
+ * setActivityStoreSlot
+ * 
+ * Syntactic Specification:
+ * void setActivityStoreSlot(Activity a, long long slot, unsigned int slotCount);
+ * 
+ * Semantic Specification:
+ * Records where the record of the activity has been written in (or read from) a slotted store and
+ * marks the activity as clean. It's not a setter: the observer is not notified.
+ * 
+ * Preconditions:
+ * - 'slot' is the first slot of the record and 'slotCount > 0', or 'slot == -1' (no record) and 'slotCount == 0'
+ * 
+ * Postconditions:
+ * - The position is recorded and the activity is not dirty
+ * - No effect if a is NULL
+ * 
+ * Side Effects:
+ * - Modification of the Activity object's state
+ */
+void setActivityStoreSlot(Activity a, long long slot, unsigned int slotCount) {
+	if (a == NULL) return;
+	
+	a->storeSlot = slot;
+	a->storeSlotCount = slotCount;
+	a->isDirty = 0;
+}
+
+/*
+ * markActivityClean
+ * 
+ * Syntactic Specification:
+ * void markActivityClean(Activity a);
+ * 
+ * Semantic Specification:
+ * Marks the activity as clean after it has been written to (or read from) a sharded directory, where
+ * no position is recorded. It's not a setter: the observer is not notified.
+ * 
+ * Preconditions:
+ * - None
+ * 
+ * Postconditions:
+ * - The activity is not dirty
+ * - No effect if a is NULL
+ * 
+ * Side Effects:
+ * - Modification of the Activity object's state
+ */
+void markActivityClean(Activity a) {
+	if (a == NULL) return;
+	
+	a->isDirty = 0;
+}
+
+/*
+ * notifyActivityChange
+ * 
+ * Syntactic Specification:
+ * void notifyActivityChange(Activity a, int field, int phase);
+ * 
+ * Semantic Specification:
+ * Calls the change observer of the activity (if any) for the given field and phase. Used by the setters,
+ * so it's also where every setter marks the activity as dirty (see 'isActivityDirty()').
+ * 
+ * Preconditions:
+ * - 'a != NULL'
+ * - 'field' must be one of ACTIVITY_FIELD_*
+ * - 'phase' must be ACTIVITY_CHANGE_BEFORE or ACTIVITY_CHANGE_AFTER
+ * 
+ * Postconditions:
+ * - If an observer is registered, it has been called
+ * - After the change, the activity is dirty
+ * 
+ * Side Effects:
+ * - Effects of the observer
+ */
+void notifyActivityChange(Activity a, int field, int phase) {
+	if (phase == ACTIVITY_CHANGE_AFTER) a->isDirty = 1;
+	if (a->observer != NULL) {
+		a->observer(a, field, phase, a->observerContext);
+	}
+}
+
 
 
 
@@ -220,6 +632,7 @@ char* getActivityName(Activity a) {
 char* getActivityDescr(Activity a) {
 	if (a == NULL) return NULL;
 	
+	loadActivityLazyDescr(a);
 	return a->descr;
 }
 
@@ -267,6 +680,61 @@ short unsigned int getActivityPriority(Activity a) {
 
 
 
+/*
+ * Collation Key Getters (getActivityNameKey, getActivityDescrKey, getActivityCourseKey)
+ * 
+ * Syntactic Specification:
+ * const char* getActivityNameKey(Activity a, size_t* keyLength);
+ * const char* getActivityDescrKey(Activity a, size_t* keyLength);
+ * const char* getActivityCourseKey(Activity a, size_t* keyLength);
+ * 
+ * Semantic Specification:
+ * Return the collation keys (see 'newCollationKey()') of the name, description and course. A key
+ * is built by the first call (see 'getActivityCollationKey()'), so only the activities that are
+ * sorted by that string keep it; then sorting on it costs a memcmp per comparison, with no case or
+ * accent folding. Setting the string drops its key.
+ * 
+ * Preconditions:
+ * - 'keyLength' must not be NULL
+ * 
+ * Postconditions:
+ * - Return the key and store its length in '*keyLength'
+ * - Return NULL ('*keyLength' is 0) if a is NULL, the string is NULL or the key could not be allocated
+ * 
+ * Side Effects:
+ * - Allocates memory (first call for the string)
+ */
+ 
+const char* getActivityNameKey(Activity a, size_t* keyLength) {
+	if (a == NULL) {
+		*keyLength = 0;
+		return NULL;
+	}
+	
+	return getActivityCollationKey(a->name, &a->nameKey, &a->nameKeyLength, keyLength);
+}
+
+const char* getActivityDescrKey(Activity a, size_t* keyLength) {
+	if (a == NULL) {
+		*keyLength = 0;
+		return NULL;
+	}
+	
+	loadActivityLazyDescr(a);
+	return getActivityCollationKey(a->descr, &a->descrKey, &a->descrKeyLength, keyLength);
+}
+
+const char* getActivityCourseKey(Activity a, size_t* keyLength) {
+	if (a == NULL) {
+		*keyLength = 0;
+		return NULL;
+	}
+	
+	return getActivityCollationKey(a->course, &a->courseKey, &a->courseKeyLength, keyLength);
+}
+
+
+
 
 
 
@@ -294,82 +762,126 @@ short unsigned int getActivityPriority(Activity a) {
  * 
  * Postconditions:
  * - The corresponding field is updated if a is not NULL
- * - For strings: the old string is freed and the new one is copied
+ * - For strings: the old string is freed and the new one is copied, and its collation key is dropped
+ * - The change observer of the activity (if any) is notified before and after the change
  * - No effect if a is NULL
  * 
  * Side Effects:
  * - String memory deallocation and allocation
  * - Modification of the Activity object's state
+ * - Call to the change observer
  */
  
 void setActivityId(Activity a, int newId) {
-	if(a) a->id = newId;
+	if (a == NULL) return;
+	
+	notifyActivityChange(a, ACTIVITY_FIELD_ID, ACTIVITY_CHANGE_BEFORE);
+	
+	a->id = newId;
+	notifyActivityChange(a, ACTIVITY_FIELD_ID, ACTIVITY_CHANGE_AFTER);
 }
 
 void setActivityName(Activity a, char* name) {
 	if (a == NULL) return;
 	
+	notifyActivityChange(a, ACTIVITY_FIELD_NAME, ACTIVITY_CHANGE_BEFORE);
+	
 	if (a->name != NULL) {
 		free(a->name);
 	}
 	
 	a->name = copyString(name);
+	free(a->nameKey);
+	a->nameKey = NULL; // rebuilt by the next sort on it
+	a->nameKeyLength = 0;
+	notifyActivityChange(a, ACTIVITY_FIELD_NAME, ACTIVITY_CHANGE_AFTER);
 }
 
 void setActivityDescr(Activity a, char* descr) {
 	if (a == NULL) return;
 	
+	notifyActivityChange(a, ACTIVITY_FIELD_DESCR, ACTIVITY_CHANGE_BEFORE);
+	
+	releaseActivityStringSource( &(a->descrSource) ); // the description in the file is not needed any more
 	if (a->descr != NULL) {
 		free(a->descr);
 	}
 	
 	a->descr = copyString(descr);
+	free(a->descrKey);
+	a->descrKey = NULL; // rebuilt by the next sort on it
+	a->descrKeyLength = 0;
+	notifyActivityChange(a, ACTIVITY_FIELD_DESCR, ACTIVITY_CHANGE_AFTER);
 }
 
 void setActivityCourse(Activity a, char* course) {
 	if (a == NULL) return;
 	
+	notifyActivityChange(a, ACTIVITY_FIELD_COURSE, ACTIVITY_CHANGE_BEFORE);
+	
 	if (a->course != NULL) {
 		free(a->course);
 	}
 	
 	a->course = copyString(course);
+	free(a->courseKey);
+	a->courseKey = NULL; // rebuilt by the next sort on it
+	a->courseKeyLength = 0;
+	notifyActivityChange(a, ACTIVITY_FIELD_COURSE, ACTIVITY_CHANGE_AFTER);
 }
 
 void setActivityInsertDate(Activity a, time_t insertDate) {
 	if (a == NULL) return;
 	
+	notifyActivityChange(a, ACTIVITY_FIELD_INSERT_DATE, ACTIVITY_CHANGE_BEFORE);
+	
 	a->insertDate = insertDate;
+	notifyActivityChange(a, ACTIVITY_FIELD_INSERT_DATE, ACTIVITY_CHANGE_AFTER);
 }
 
 void setActivityExpiryDate(Activity a, time_t expiryDate) {
 	if (a == NULL) return;
 	
+	notifyActivityChange(a, ACTIVITY_FIELD_EXPIRY_DATE, ACTIVITY_CHANGE_BEFORE);
+	
 	a->expiryDate = expiryDate;
+	notifyActivityChange(a, ACTIVITY_FIELD_EXPIRY_DATE, ACTIVITY_CHANGE_AFTER);
 }
 
 void setActivityCompletionDate(Activity a, time_t completionDate) {
 	if (a == NULL) return;
 	
+	notifyActivityChange(a, ACTIVITY_FIELD_COMPLETION_DATE, ACTIVITY_CHANGE_BEFORE);
+	
 	a->completionDate = completionDate;
+	notifyActivityChange(a, ACTIVITY_FIELD_COMPLETION_DATE, ACTIVITY_CHANGE_AFTER);
 }
 
 void setActivityTotalTime(Activity a, unsigned int totalTime) {
 	if (a == NULL) return;
 	
+	notifyActivityChange(a, ACTIVITY_FIELD_TOTAL_TIME, ACTIVITY_CHANGE_BEFORE);
+	
 	a->totalTime = totalTime;
+	notifyActivityChange(a, ACTIVITY_FIELD_TOTAL_TIME, ACTIVITY_CHANGE_AFTER);
 }
 
 void setActivityUsedTime(Activity a, unsigned int usedTime) {
 	if (a == NULL) return;
 	
+	notifyActivityChange(a, ACTIVITY_FIELD_USED_TIME, ACTIVITY_CHANGE_BEFORE);
+	
 	a->usedTime = usedTime;
+	notifyActivityChange(a, ACTIVITY_FIELD_USED_TIME, ACTIVITY_CHANGE_AFTER);
 }
 
 void setActivityPriority(Activity a, short unsigned int priority) {
 	if (a == NULL) return;
 	
+	notifyActivityChange(a, ACTIVITY_FIELD_PRIORITY, ACTIVITY_CHANGE_BEFORE);
+	
 	a->priority = priority;
+	notifyActivityChange(a, ACTIVITY_FIELD_PRIORITY, ACTIVITY_CHANGE_AFTER);
 }
 
 
@@ -2,10 +2,36 @@
 #define ACTIVITY_H             // Macro definition to avoid multiple inclusions
 
 #include "utils.h"
+#include "activity_string_source.h"
 
 // Declare an opaque type for the activity type
 typedef struct activity* Activity;
 
+/*
+ * Activity fields identifiers.
+ * The numbering is the same used by the sorting criteria 0-9 of 'compareActivityBy'.
+ */
+#define ACTIVITY_FIELD_ID 0
+#define ACTIVITY_FIELD_NAME 1
+#define ACTIVITY_FIELD_DESCR 2
+#define ACTIVITY_FIELD_COURSE 3
+#define ACTIVITY_FIELD_INSERT_DATE 4
+#define ACTIVITY_FIELD_EXPIRY_DATE 5
+#define ACTIVITY_FIELD_COMPLETION_DATE 6
+#define ACTIVITY_FIELD_TOTAL_TIME 7
+#define ACTIVITY_FIELD_USED_TIME 8
+#define ACTIVITY_FIELD_PRIORITY 9
+
+/*
+ * Phases of a change notification: every setter notifies the observer once before
+ * changing the field (the activity still has the old value) and once after.
+ */
+#define ACTIVITY_CHANGE_BEFORE 0
+#define ACTIVITY_CHANGE_AFTER 1
+
+// Function called before and after a field of an activity is changed by a setter
+typedef void (*ActivityChangeObserver)(Activity a, int field, int phase, void* context);
+
 
 
 /*
@@ -38,6 +64,37 @@ Activity newActivity( int id, char* name, char* descr, char* course,
 							unsigned int totalTime, unsigned int usedTime, 
 							short unsigned int priority );
 
+/*
+ * newActivityWithLengths
+ * 
+ * Syntactic Specification:
+ * Activity newActivityWithLengths(int id, const char* name, size_t nameLength, const char* descr, size_t descrLength,
+ *                     const char* course, size_t courseLength, time_t insertDate, time_t expiryDate,
+ *                     time_t completionDate, unsigned int totalTime, unsigned int usedTime,
+ *                     short unsigned int priority);
+ * 
+ * Semantic Specification:
+ * Creates a new activity like 'newActivity()', with strings given as (pointer, length) pairs that don't
+ * need to be terminated: the bytes are copied once, straight into the strings of the activity (see
+ * 'copyStringWithLength()'). Used by the loaders to build activities from the lines of a mapped file.
+ * 
+ * Preconditions:
+ * - Sufficient memory available for allocation
+ * - String parameters may be NULL (their length is ignored), otherwise they have at least the given length
+ * 
+ * Postconditions:
+ * - Returns a pointer to an Activity initialized with the provided values
+ * - Returns NULL if allocation fails
+ * - Strings are copied, not just referenced
+ * 
+ * Side Effects:
+ * Allocates dynamic memory for a new Activity structure and its strings.
+ */
+Activity newActivityWithLengths( int id, const char* name, size_t nameLength, const char* descr, size_t descrLength,
+							const char* course, size_t courseLength, time_t insertDate, time_t expiryDate,
+							time_t completionDate, unsigned int totalTime, unsigned int usedTime,
+							short unsigned int priority );
+
 /*
  * deleteActivity
  * 
@@ -77,7 +134,165 @@ void deleteActivity(Activity a);
  * Side Effects:
  * Allocates dynamic memory for a new Activity structure and its strings.
  */
-Activity copyActivity(Activity old); //used on node rotation (tree, on node delete)
+Activity copyActivity(Activity old);
+
+/*
+ * setActivityLazyDescr
+ * 
+ * Syntactic Specification:
+ * void setActivityLazyDescr(Activity a, ActivityStringSource source, off_t offset, size_t length);
+ * 
+ * Semantic Specification:
+ * Leaves the description of the activity in a file: only its position and length are kept, and the
+ * string is read from the file by the first call that needs it
+ * ('getActivityDescr()', 'getActivityDescrKey()'). Used by the loaders to keep out of memory the
+ * descriptions of activities that are only listed. It's not a setter: the observer is not notified.
+ * 
+ * Preconditions:
+ * - 'a' has no description ('NULL'), 'source != NULL', 'length > 0'
+ * 
+ * Postconditions:
+ * - The activity takes a reference to the source (released when the description is loaded or replaced)
+ * - No effect if a is NULL
+ * 
+ * Side Effects:
+ * - Modification of the Activity object's state
+ */
+void setActivityLazyDescr(Activity a, ActivityStringSource source, off_t offset, size_t length);
+
+/*
+ * isActivityDescrLoaded
+ * 
+ * Syntactic Specification:
+ * int isActivityDescrLoaded(Activity a);
+ * 
+ * Semantic Specification:
+ * Tells if the description of the activity is in memory, that is if it was never left in a file by
+ * 'setActivityLazyDescr()' or if it has been loaded. After 'getActivityDescr()' it tells a description
+ * that is really NULL from one whose read has failed: a writer that finds 0 must not save the activity.
+ * 
+ * Preconditions:
+ * - None
+ * 
+ * Postconditions:
+ * - Returns 1 if the description is in memory (or if a is NULL), 0 if it's still in its file
+ * 
+ * Side Effects:
+ * - None
+ */
+int isActivityDescrLoaded(Activity a);
+
+/*
+ * setActivityChangeObserver
+ * 
+ * Syntactic Specification:
+ * void setActivityChangeObserver(Activity a, ActivityChangeObserver observer, void* context);
+ * 
+ * Semantic Specification:
+ * Registers the function to call every time a field of the activity is changed by a setter.
+ * Used by the activities container to know when an activity stored in it has been modified.
+ * 
+ * Preconditions:
+ * - 'observer' can be NULL (no notification)
+ * 
+ * Postconditions:
+ * - Every setter call calls 'observer(a, field, ACTIVITY_CHANGE_BEFORE, context)' before changing the field
+ *   and 'observer(a, field, ACTIVITY_CHANGE_AFTER, context)' after ('field' is one of ACTIVITY_FIELD_*)
+ * - Only one observer is kept: a new registration replaces the previous one
+ * - No effect if a is NULL
+ * 
+ * Side Effects:
+ * - Modification of the Activity object's state
+ */
+void setActivityChangeObserver(Activity a, ActivityChangeObserver observer, void* context);
+
+/*
+ * isActivityDirty
+ * 
+ * Syntactic Specification:
+ * int isActivityDirty(Activity a);
+ * 
+ * Semantic Specification:
+ * Tells if the activity has changed since its record was last written to (or read from) a slotted store
+ * or a sharded directory: every setter marks the activity as dirty, and a new activity is dirty until
+ * it's saved to one of them.
+ * 
+ * Preconditions:
+ * - None
+ * 
+ * Postconditions:
+ * - Returns 1 if the activity is dirty, 0 otherwise (or if a is NULL)
+ * 
+ * Side Effects:
+ * - None
+ */
+int isActivityDirty(Activity a);
+
+/*
+ * getActivityStoreSlot
+ * 
+ * Syntactic Specification:
+ * long long getActivityStoreSlot(Activity a, unsigned int* slotCount);
+ * 
+ * Semantic Specification:
+ * Returns the position of the record of the activity in the slotted store it was last saved to or read
+ * from (see 'setActivityStoreSlot()').
+ * 
+ * Preconditions:
+ * - 'slotCount != NULL'
+ * 
+ * Postconditions:
+ * - Returns the first slot of the record and sets '*slotCount' to its number of slots
+ * - Returns -1 and sets '*slotCount' to 0 if the activity has no record (or a is NULL)
+ * 
+ * Side Effects:
+ * - None
+ */
+long long getActivityStoreSlot(Activity a, unsigned int* slotCount);
+
+/*
+ * setActivityStoreSlot
+ * 
+ * Syntactic Specification:
+ * void setActivityStoreSlot(Activity a, long long slot, unsigned int slotCount);
+ * 
+ * Semantic Specification:
+ * Records where the record of the activity has been written in (or read from) a slotted store and
+ * marks the activity as clean. It's not a setter: the observer is not notified.
+ * 
+ * Preconditions:
+ * - 'slot' is the first slot of the record and 'slotCount > 0', or 'slot == -1' (no record) and 'slotCount == 0'
+ * 
+ * Postconditions:
+ * - The position is recorded and the activity is not dirty
+ * - No effect if a is NULL
+ * 
+ * Side Effects:
+ * - Modification of the Activity object's state
+ */
+void setActivityStoreSlot(Activity a, long long slot, unsigned int slotCount);
+
+/*
+ * markActivityClean
+ * 
+ * Syntactic Specification:
+ * void markActivityClean(Activity a);
+ * 
+ * Semantic Specification:
+ * Marks the activity as clean after it has been written to (or read from) a sharded directory, where
+ * no position is recorded. It's not a setter: the observer is not notified.
+ * 
+ * Preconditions:
+ * - None
+ * 
+ * Postconditions:
+ * - The activity is not dirty
+ * - No effect if a is NULL
+ * 
+ * Side Effects:
+ * - Modification of the Activity object's state
+ */
+void markActivityClean(Activity a);
 
 
 
@@ -125,6 +340,36 @@ unsigned int getActivityUsedTime(Activity a);
 short unsigned int getActivityPriority(Activity a);
 
 
+/*
+ * Collation Key Getters (getActivityNameKey, getActivityDescrKey, getActivityCourseKey)
+ * 
+ * Syntactic Specification:
+ * const char* getActivityNameKey(Activity a, size_t* keyLength);
+ * const char* getActivityDescrKey(Activity a, size_t* keyLength);
+ * const char* getActivityCourseKey(Activity a, size_t* keyLength);
+ * 
+ * Semantic Specification:
+ * Return the collation keys (see 'newCollationKey()') of the name, description and course. A key
+ * is built by the first call, so only the activities that are sorted by that string keep it; then
+ * sorting on it costs a memcmp per comparison, with no case or accent folding. Setting the string
+ * drops its key. Safe to call from several threads at once (one key is kept, without locks).
+ * 
+ * Preconditions:
+ * - 'keyLength' must not be NULL
+ * 
+ * Postconditions:
+ * - Return the key and store its length in '*keyLength'
+ * - Return NULL ('*keyLength' is 0) if a is NULL, the string is NULL or the key could not be allocated
+ * 
+ * Side Effects:
+ * - Allocates memory (first call for the string)
+ */
+ 
+const char* getActivityNameKey(Activity a, size_t* keyLength);
+const char* getActivityDescrKey(Activity a, size_t* keyLength);
+const char* getActivityCourseKey(Activity a, size_t* keyLength);
+
+
 
 /*
  * Setter Functions (setActivityId, setActivityName, setActivityDescr, etc.)
@@ -149,12 +394,14 @@ short unsigned int getActivityPriority(Activity a);
  * 
  * Postconditions:
  * - The corresponding field is updated if a is not NULL
- * - For strings: the old string is freed and the new one is copied
+ * - For strings: the old string is freed and the new one is copied, and its collation key is dropped
+ * - The change observer of the activity (if any) is notified before and after the change
  * - No effect if a is NULL
  * 
  * Side Effects:
  * - String memory deallocation and allocation
  * - Modification of the Activity object's state
+ * - Call to the change observer
  */
  
 void setActivityId(Activity a, int newId);
@@ -265,14 +265,17 @@ int compareActivityById(const Activity a, const Activity b) {
  * int compareActivityByName(const Activity a, const Activity b);
  * 
  * Semantic Specification:
- * Compares two activities by name using strcmp.
+ * Compares two activities by name, ignoring case and accents (e.g. "Èsame" and "esame" come before "Fisica"):
+ * the collation keys (see 'newCollationKey()', built by the first comparison) are compared with memcmp.
+ * Names that differ only in case or accents are ordered by their bytes.
  * 
  * Preconditions:
  * None.
  * 
  * Postconditions:
- * - Returns the result of strcmp if both names are not NULL
+ * - Returns the result of 'compareCollationKeys()' if both names are not NULL
  * - Handles NULL cases using compareNullString
+ * - Falls back to strcmp if a collation key could not be allocated
  * 
  * Side Effects:
  * None.
@@ -287,7 +290,14 @@ int compareActivityByName(const Activity a, const Activity b) {
 		return compareNullString(a_name, b_name);
 	}
 	
-	return strcmp(a_name, b_name);
+	size_t a_keyLength, b_keyLength;
+	const char* a_key = getActivityNameKey(a, &a_keyLength);
+	const char* b_key = getActivityNameKey(b, &b_keyLength);
+	if (a_key == NULL || b_key == NULL) {
+		return strcmp(a_name, b_name);
+	}
+	
+	return compareCollationKeys(a_key, a_keyLength, b_key, b_keyLength);
 }
 
 /*
@@ -297,14 +307,17 @@ int compareActivityByName(const Activity a, const Activity b) {
  * int compareActivityByDescr(const Activity a, const Activity b);
  * 
  * Semantic Specification:
- * Compares two activities by description using strcmp.
+ * Compares two activities by description, ignoring case and accents (e.g. "Èsame" and "esame" come before "Fisica"):
+ * the collation keys (see 'newCollationKey()', built by the first comparison) are compared with memcmp.
+ * Descriptions that differ only in case or accents are ordered by their bytes.
  * 
  * Preconditions:
  * None.
  * 
  * Postconditions:
- * - Returns the result of strcmp if both descriptions are not NULL
+ * - Returns the result of 'compareCollationKeys()' if both descriptions are not NULL
  * - Handles NULL cases using compareNullString
+ * - Falls back to strcmp if a collation key could not be allocated
  * 
  * Side Effects:
  * None.
@@ -319,7 +332,14 @@ int compareActivityByDescr(const Activity a, const Activity b) {
 		return compareNullString(a_descr, b_descr);
 	}
 	
-	return strcmp(a_descr, b_descr);
+	size_t a_keyLength, b_keyLength;
+	const char* a_key = getActivityDescrKey(a, &a_keyLength);
+	const char* b_key = getActivityDescrKey(b, &b_keyLength);
+	if (a_key == NULL || b_key == NULL) {
+		return strcmp(a_descr, b_descr);
+	}
+	
+	return compareCollationKeys(a_key, a_keyLength, b_key, b_keyLength);
 }
 
 /*
@@ -329,14 +349,17 @@ int compareActivityByDescr(const Activity a, const Activity b) {
  * int compareActivityByCourse(const Activity a, const Activity b);
  * 
  * Semantic Specification:
- * Compares two activities by course using strcmp.
+ * Compares two activities by course, ignoring case and accents (e.g. "Èsame" and "esame" come before "Fisica"):
+ * the collation keys (see 'newCollationKey()', built by the first comparison) are compared with memcmp.
+ * Courses that differ only in case or accents are ordered by their bytes.
  * 
  * Preconditions:
  * None.
  * 
  * Postconditions:
- * - Returns the result of strcmp if both courses are not NULL
+ * - Returns the result of 'compareCollationKeys()' if both courses are not NULL
  * - Handles NULL cases using compareNullString
+ * - Falls back to strcmp if a collation key could not be allocated
  * 
  * Side Effects:
  * None.
@@ -351,7 +374,14 @@ int compareActivityByCourse(const Activity a, const Activity b) {
 		return compareNullString(a_course, b_course);
 	}
 	
-	return strcmp(a_course, b_course);
+	size_t a_keyLength, b_keyLength;
+	const char* a_key = getActivityCourseKey(a, &a_keyLength);
+	const char* b_key = getActivityCourseKey(b, &b_keyLength);
+	if (a_key == NULL || b_key == NULL) {
+		return strcmp(a_course, b_course);
+	}
+	
+	return compareCollationKeys(a_key, a_keyLength, b_key, b_keyLength);
 }
 
 /*
@@ -379,7 +409,7 @@ int compareActivityByInsertDate(const Activity a, const Activity b) {
 	if (!a || !b) return compareNullActivity(a, b);
 	
 	time_t a_insertDate = getActivityInsertDate(a);
-	time_t b_insertDate = getActivityInsertDate(a);
+	time_t b_insertDate = getActivityInsertDate(b);
 	
 	if (a_insertDate == b_insertDate) return 0;
 	
@@ -411,7 +441,7 @@ int compareActivityByExpiryDate(const Activity a, const Activity b) {
 	if (!a || !b) return compareNullActivity(a, b);
 	
 	time_t a_expiryDate = getActivityExpiryDate(a);
-	time_t b_expiryDate = getActivityExpiryDate(a);
+	time_t b_expiryDate = getActivityExpiryDate(b);
 	
 	if (a_expiryDate == b_expiryDate) return 0;
 	
@@ -443,7 +473,7 @@ int compareActivityByCompletionDate(const Activity a, const Activity b) {
 	if (!a || !b) return compareNullActivity(a, b);
 	
 	time_t a_completionDate = getActivityCompletionDate(a);
-	time_t b_completionDate = getActivityCompletionDate(a);
+	time_t b_completionDate = getActivityCompletionDate(b);
 	
 	if (a_completionDate == b_completionDate) return 0;
 	
@@ -624,6 +654,26 @@ int compareActivityByTimeToCompletion(Activity a, Activity b) {
 	return (a_timeToCompletion < b_timeToCompletion) ? -1 : 1;
 }
 
+/*
+ * compareActivityByPriorityExpiryDateId
+ * 
+ * Syntactic Specification:
+ * int compareActivityByPriorityExpiryDateId(Activity a, Activity b);
+ * 
+ * Semantic Specification:
+ * Compares two activities by priority; on equal priority by expiry date; on equal expiry date by ID.
+ * 
+ * Preconditions:
+ * - None (NULL activities are handled like in the other comparators)
+ * 
+ * Postconditions:
+ * - Returns -1, 0 or 1 like the other comparators
+ * 
+ * Side Effects:
+ * None.
+ */
+DEFINE_ACTIVITY_COMPARATOR_CHAIN(PriorityExpiryDateId, Priority, ExpiryDate, Id)
+
 /*
  * compareActivityBy
  * 
@@ -651,10 +701,11 @@ int compareActivityByTimeToCompletion(Activity a, Activity b) {
  *   9    | Priority
  *  10    | Completion Percentage
  *  11    | Time to Completion
+ *  12    | Priority, then Expiry Date, then Activity ID
  *
  * 
  * Preconditions:
- * - compareBy should be a valid integer (0-11 for defined comparisons)
+ * - compareBy should be a valid integer (0-12 for defined comparisons)
  * 
  * Postconditions:
  * - Returns 0 if the activities are equal according to the specified criterion
@@ -705,6 +756,9 @@ int compareActivityBy(Activity a, Activity b, int compareBy) {
 		case 11: cmp = compareActivityByTimeToCompletion(a, b);
 				break;
 				
+		case 12: cmp = compareActivityByPriorityExpiryDateId(a, b);
+				break;
+				
 		default: cmp = compareActivityById(a, b);
 				break;
 	}
@@ -712,6 +766,109 @@ int compareActivityBy(Activity a, Activity b, int compareBy) {
 	return cmp;
 }
 
+/*
+ * hasActivityNumericSortKey
+ * 
+ * Syntactic Specification:
+ * int hasActivityNumericSortKey(int sortBy);
+ * 
+ * Semantic Specification:
+ * Tells if the sorting criterion can be expressed as an integer key (see 'activityNumericSortKey()'):
+ * all the criteria of 'compareActivityBy()' except the string ones (name, description, course).
+ * 
+ * Preconditions:
+ * - None
+ * 
+ * Postconditions:
+ * - Returns 1 for 'sortBy' in 0, 4-11; 0 otherwise
+ * 
+ * Side Effects:
+ * None.
+ */
+int hasActivityNumericSortKey(int sortBy) {
+	return (sortBy == 0 || (sortBy >= 4 && sortBy <= 11)) ? 1 : 0;
+}
+
+/*
+ * activityNumericSortKey
+ * 
+ * Syntactic Specification:
+ * long long activityNumericSortKey(Activity a, int sortBy);
+ * 
+ * Semantic Specification:
+ * Returns the integer value compared by 'compareActivityBy()' for the given criterion (id, dates,
+ * times, priority, completion percentage, time to completion): for two non-NULL activities,
+ * 'compareActivityBy(a, b, sortBy)' has the same sign as the comparison of their keys.
+ * 
+ * Preconditions:
+ * - 'a != NULL'
+ * - 'hasActivityNumericSortKey(sortBy) == 1'
+ * 
+ * Postconditions:
+ * - Returns the key (0 if 'a == NULL' or the criterion has no numeric key)
+ * 
+ * Side Effects:
+ * None.
+ */
+long long activityNumericSortKey(Activity a, int sortBy) {
+	if (a == NULL) return 0;
+	
+	switch (sortBy) {
+		case 0: return getActivityId(a);
+		case 4: return getActivityInsertDate(a);
+		case 5: return getActivityExpiryDate(a);
+		case 6: return getActivityCompletionDate(a);
+		case 7: return getActivityTotalTime(a);
+		case 8: return getActivityUsedTime(a);
+		case 9: return getActivityPriority(a);
+		case 10: return activityCompletionPercentage(a);
+		case 11: {
+			unsigned int totalTime = getActivityTotalTime(a);
+			unsigned int usedTime = getActivityUsedTime(a);
+			return (totalTime >= usedTime) ? totalTime - usedTime : 0;
+		}
+		default: return 0;
+	}
+}
+
+/*
+ * sortCriterionToText
+ * 
+ * Syntactic Specification:
+ * char* sortCriterionToText(int sortBy);
+ * 
+ * Semantic Specification:
+ * Returns the (Italian) description of a sorting criterion of 'compareActivityBy()', used in the headers of the sorted listings.
+ * 
+ * Preconditions:
+ * None.
+ * 
+ * Postconditions:
+ * - Returns a constant string (the description of the ID criterion for invalid values)
+ * 
+ * Side Effects:
+ * None.
+ */
+char* sortCriterionToText(int sortBy) {
+	switch (sortBy) {
+		case 1: return "titolo";
+		case 2: return "descrizione";
+		case 3: return "corso";
+		case 4: return "data di inserimento";
+		case 5: return "data di scadenza";
+		case 6: return "data di completamento";
+		case 7: return "tempo totale";
+		case 8: return "tempo impiegato";
+		case 9: return "priorità";
+		case 10: return "percentuale di completamento";
+		case 11: return "tempo al completamento";
+		case 12: return "priorità, poi data di scadenza";
+		default: break;
+	}
+	
+	return "id";
+}
+
 
 /*
  * priorityToText
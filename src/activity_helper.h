@@ -179,6 +179,53 @@ int compareActivityById(Activity a, Activity b);
 
 
 
+/*
+ * ACTIVITY_SORT_CRITERIA
+ * 
+ * X-macro listing all the sorting criteria of 'compareActivityBy()' as X(sortBy, Criterion), where
+ * 'compareActivityBy##Criterion(a, b)' is the comparator of the criterion. It's used to declare the
+ * comparators and to generate sort routines specialized for each criterion (support list and vector):
+ * they call the comparator directly (so it can be inlined) instead of going through the
+ * 'compareActivityBy()' switch on every comparison.
+ */
+#define ACTIVITY_SORT_CRITERIA(X) \
+	X(0, Id) \
+	X(1, Name) \
+	X(2, Descr) \
+	X(3, Course) \
+	X(4, InsertDate) \
+	X(5, ExpiryDate) \
+	X(6, CompletionDate) \
+	X(7, TotalTime) \
+	X(8, UsedTime) \
+	X(9, Priority) \
+	X(10, PercentCompletion) \
+	X(11, TimeToCompletion) \
+	X(12, PriorityExpiryDateId)
+
+#define ACTIVITY_SORT_CRITERIA_COUNT 13 // Number of criteria in ACTIVITY_SORT_CRITERIA (sortBy from 0 to 12)
+
+/*
+ * DEFINE_ACTIVITY_COMPARATOR_CHAIN
+ * 
+ * Defines 'int compareActivityBy##Criterion(Activity a, Activity b)' as the lexicographic chain of
+ * three comparators: the second one decides only the ties of the first one, the third one only the
+ * ties of the second one. E.g. (Priority, ExpiryDate, Id).
+ */
+#define DEFINE_ACTIVITY_COMPARATOR_CHAIN(Criterion, First, Second, Third) \
+int compareActivityBy##Criterion(Activity a, Activity b) { \
+	int cmp = compareActivityBy##First(a, b); \
+	if (cmp == 0) cmp = compareActivityBy##Second(a, b); \
+	if (cmp == 0) cmp = compareActivityBy##Third(a, b); \
+	return cmp; \
+}
+
+// Declaration of the comparator of each criterion: int compareActivityBy##Criterion(Activity a, Activity b);
+#define DECLARE_ACTIVITY_COMPARATOR(sortBy, Criterion) int compareActivityBy##Criterion(Activity a, Activity b);
+ACTIVITY_SORT_CRITERIA(DECLARE_ACTIVITY_COMPARATOR)
+#undef DECLARE_ACTIVITY_COMPARATOR
+
+
 /*
  * compareActivityBy
  * 
@@ -206,10 +253,11 @@ int compareActivityById(Activity a, Activity b);
  *   9    | Priority
  *  10    | Completion Percentage
  *  11    | Time to Completion
+ *  12    | Priority, then Expiry Date, then Activity ID
  *
  * 
  * Preconditions:
- * - compareBy should be a valid integer (0-11 for defined comparisons)
+ * - compareBy should be a valid integer (0-12 for defined comparisons)
  * 
  * Postconditions:
  * - Returns 0 if the activities are equal according to the specified criterion
@@ -223,6 +271,70 @@ int compareActivityById(Activity a, Activity b);
  */
 int compareActivityBy(Activity a, Activity b, int compareBy);
 
+/*
+ * hasActivityNumericSortKey
+ * 
+ * Syntactic Specification:
+ * int hasActivityNumericSortKey(int sortBy);
+ * 
+ * Semantic Specification:
+ * Tells if the sorting criterion can be expressed as an integer key (see 'activityNumericSortKey()'):
+ * all the criteria of 'compareActivityBy()' except the string ones (name, description, course).
+ * 
+ * Preconditions:
+ * - None
+ * 
+ * Postconditions:
+ * - Returns 1 for 'sortBy' in 0, 4-11; 0 otherwise
+ * 
+ * Side Effects:
+ * None.
+ */
+int hasActivityNumericSortKey(int sortBy);
+
+/*
+ * activityNumericSortKey
+ * 
+ * Syntactic Specification:
+ * long long activityNumericSortKey(Activity a, int sortBy);
+ * 
+ * Semantic Specification:
+ * Returns the integer value compared by 'compareActivityBy()' for the given criterion (id, dates,
+ * times, priority, completion percentage, time to completion): for two non-NULL activities,
+ * 'compareActivityBy(a, b, sortBy)' has the same sign as the comparison of their keys.
+ * 
+ * Preconditions:
+ * - 'a != NULL'
+ * - 'hasActivityNumericSortKey(sortBy) == 1'
+ * 
+ * Postconditions:
+ * - Returns the key (0 if 'a == NULL' or the criterion has no numeric key)
+ * 
+ * Side Effects:
+ * None.
+ */
+long long activityNumericSortKey(Activity a, int sortBy);
+
+/*
+ * sortCriterionToText
+ * 
+ * Syntactic Specification:
+ * char* sortCriterionToText(int sortBy);
+ * 
+ * Semantic Specification:
+ * Returns the (Italian) description of a sorting criterion of 'compareActivityBy()', used in the headers of the sorted listings.
+ * 
+ * Preconditions:
+ * None.
+ * 
+ * Postconditions:
+ * - Returns a constant string (the description of the ID criterion for invalid values)
+ * 
+ * Side Effects:
+ * None.
+ */
+char* sortCriterionToText(int sortBy);
+
 
 
 
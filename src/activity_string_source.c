@@ -0,0 +1,181 @@
+#include <stdlib.h>
+#include <errno.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "activity_string_source.h"
+
+
+/*
+ * "struct activityStringSource" Documentation
+ *
+ * Syntactic Specification:
+ * struct activityStringSource {
+ *     int fd;
+ *     int references;
+ * };
+ *
+ * Semantic Specification:
+ * File shared by the activities whose strings are read from it only when needed.
+ *
+ * Fields:
+ * - fd: The open file
+ * - references: Number of references (the activities with a string in the file, the loader while reading)
+ */
+struct activityStringSource {
+	int fd;
+	int references;
+};
+
+// Lock of the loading of the strings (see 'lockActivityStringSources()')
+pthread_mutex_t activityStringSourcesLock = PTHREAD_MUTEX_INITIALIZER;
+
+
+/*
+ * newActivityStringSource
+ *
+ * Syntactic Specification:
+ * ActivityStringSource newActivityStringSource(int fd);
+ *
+ * Semantic Specification:
+ * Creates a source of strings on an open file. The source is shared by the activities whose strings
+ * are still in the file: it's reference counted and the file is closed when the last reference is
+ * released. Since the file stays open, the strings can be read also after the file has been replaced
+ * by a save (the saves rename a new file over the old one, whose content doesn't change).
+ *
+ * Preconditions:
+ * - 'fd' opened for reading: the source takes ownership of it
+ *
+ * Postconditions:
+ * - Returns the source with one reference (of the caller)
+ * - Returns NULL if memory allocation fails: 'fd' is not closed
+ *
+ * Side Effects:
+ * - Allocates memory
+ */
+ActivityStringSource newActivityStringSource(int fd) {
+	ActivityStringSource source = malloc(sizeof(struct activityStringSource));
+	if (source == NULL) return NULL;
+
+	source->fd = fd;
+	source->references = 1;
+	return source;
+}
+
+/*
+ * retainActivityStringSource
+ *
+ * Syntactic Specification:
+ * void retainActivityStringSource(ActivityStringSource source);
+ *
+ * Semantic Specification:
+ * Adds a reference to the source (thread safe).
+ *
+ * Preconditions:
+ * - 'source != NULL', with at least one reference
+ *
+ * Postconditions:
+ * - The reference count is incremented
+ *
+ * Side Effects:
+ * - Modifies the source
+ */
+void retainActivityStringSource(ActivityStringSource source) {
+	__atomic_add_fetch(&source->references, 1, __ATOMIC_RELAXED);
+}
+
+/*
+ * releaseActivityStringSource
+ *
+ * Syntactic Specification:
+ * void releaseActivityStringSource(ActivityStringSource* source);
+ *
+ * Semantic Specification:
+ * Releases a reference to the source (thread safe): the last one closes the file and deallocates the source.
+ * The parameter is a pointer passed by reference.
+ *
+ * Preconditions:
+ * - 'source' can be NULL or point to a valid/NULL pointer
+ *
+ * Postconditions:
+ * - '*source' is set to NULL
+ *
+ * Side Effects:
+ * - May close the file and deallocate memory
+ */
+void releaseActivityStringSource(ActivityStringSource* source) {
+	if (source == NULL || *source == NULL) return;
+
+	if (__atomic_sub_fetch(&(*source)->references, 1, __ATOMIC_ACQ_REL) == 0) {
+		close((*source)->fd);
+		free(*source);
+	}
+	*source = NULL;
+}
+
+/*
+ * readActivityStringSource
+ *
+ * Syntactic Specification:
+ * char* readActivityStringSource(ActivityStringSource source, off_t offset, size_t length);
+ *
+ * Semantic Specification:
+ * Reads a string of 'length' bytes at 'offset' of the file with 'pread()' (the position of the file is
+ * not used, so reads of different threads don't interfere).
+ *
+ * Preconditions:
+ * - 'source != NULL'
+ *
+ * Postconditions:
+ * - Returns a new string terminated by '\0' (the caller deallocates it)
+ * - Returns NULL if the bytes can't be read or memory allocation fails
+ *
+ * Side Effects:
+ * - Reading from file
+ * - Allocates memory
+ */
+char* readActivityStringSource(ActivityStringSource source, off_t offset, size_t length) {
+	char* string = malloc(length + 1);
+	if (string == NULL) return NULL;
+
+	size_t done = 0;
+	while (done < length) {
+		ssize_t count = pread(source->fd, string + done, length - done, offset + (off_t)done);
+		if (count < 0 && errno == EINTR) continue;
+		if (count <= 0) {
+			free(string);
+			return NULL;
+		}
+		done += (size_t)count;
+	}
+
+	string[length] = '\0';
+	return string;
+}
+
+/*
+ * lockActivityStringSources / unlockActivityStringSources
+ *
+ * Syntactic Specification:
+ * void lockActivityStringSources(void);
+ * void unlockActivityStringSources(void);
+ *
+ * Semantic Specification:
+ * Acquire and release the lock that serializes the loading of the strings from the sources, so that an
+ * activity shared by several threads (e.g. during a parallel sort) loads its string only once.
+ *
+ * Preconditions:
+ * - 'unlockActivityStringSources()' only after 'lockActivityStringSources()' by the same thread
+ *
+ * Postconditions:
+ * - The lock is held / released
+ *
+ * Side Effects:
+ * - May wait for other threads
+ */
+void lockActivityStringSources(void) {
+	pthread_mutex_lock(&activityStringSourcesLock);
+}
+
+void unlockActivityStringSources(void) {
+	pthread_mutex_unlock(&activityStringSourcesLock);
+}
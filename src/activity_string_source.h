@@ -0,0 +1,122 @@
+#ifndef ACTIVITY_STRING_SOURCE_H             // Start of inclusion block
+#define ACTIVITY_STRING_SOURCE_H             // Macro definition to avoid multiple inclusions
+
+#include <stddef.h>
+#include <sys/types.h>
+
+// Declare an opaque type for a file the strings of the activities are read from when first needed
+typedef struct activityStringSource* ActivityStringSource;
+
+
+/*
+ * newActivityStringSource
+ *
+ * Syntactic Specification:
+ * ActivityStringSource newActivityStringSource(int fd);
+ *
+ * Semantic Specification:
+ * Creates a source of strings on an open file. The source is shared by the activities whose strings
+ * are still in the file: it's reference counted and the file is closed when the last reference is
+ * released. Since the file stays open, the strings can be read also after the file has been replaced
+ * by a save (the saves rename a new file over the old one, whose content doesn't change).
+ *
+ * Preconditions:
+ * - 'fd' opened for reading: the source takes ownership of it
+ *
+ * Postconditions:
+ * - Returns the source with one reference (of the caller)
+ * - Returns NULL if memory allocation fails: 'fd' is not closed
+ *
+ * Side Effects:
+ * - Allocates memory
+ */
+ActivityStringSource newActivityStringSource(int fd);
+
+/*
+ * retainActivityStringSource
+ *
+ * Syntactic Specification:
+ * void retainActivityStringSource(ActivityStringSource source);
+ *
+ * Semantic Specification:
+ * Adds a reference to the source (thread safe).
+ *
+ * Preconditions:
+ * - 'source != NULL', with at least one reference
+ *
+ * Postconditions:
+ * - The reference count is incremented
+ *
+ * Side Effects:
+ * - Modifies the source
+ */
+void retainActivityStringSource(ActivityStringSource source);
+
+/*
+ * releaseActivityStringSource
+ *
+ * Syntactic Specification:
+ * void releaseActivityStringSource(ActivityStringSource* source);
+ *
+ * Semantic Specification:
+ * Releases a reference to the source (thread safe): the last one closes the file and deallocates the source.
+ * The parameter is a pointer passed by reference.
+ *
+ * Preconditions:
+ * - 'source' can be NULL or point to a valid/NULL pointer
+ *
+ * Postconditions:
+ * - '*source' is set to NULL
+ *
+ * Side Effects:
+ * - May close the file and deallocate memory
+ */
+void releaseActivityStringSource(ActivityStringSource* source);
+
+/*
+ * readActivityStringSource
+ *
+ * Syntactic Specification:
+ * char* readActivityStringSource(ActivityStringSource source, off_t offset, size_t length);
+ *
+ * Semantic Specification:
+ * Reads a string of 'length' bytes at 'offset' of the file with 'pread()' (the position of the file is
+ * not used, so reads of different threads don't interfere).
+ *
+ * Preconditions:
+ * - 'source != NULL'
+ *
+ * Postconditions:
+ * - Returns a new string terminated by '\0' (the caller deallocates it)
+ * - Returns NULL if the bytes can't be read or memory allocation fails
+ *
+ * Side Effects:
+ * - Reading from file
+ * - Allocates memory
+ */
+char* readActivityStringSource(ActivityStringSource source, off_t offset, size_t length);
+
+/*
+ * lockActivityStringSources / unlockActivityStringSources
+ *
+ * Syntactic Specification:
+ * void lockActivityStringSources(void);
+ * void unlockActivityStringSources(void);
+ *
+ * Semantic Specification:
+ * Acquire and release the lock that serializes the loading of the strings from the sources, so that an
+ * activity shared by several threads (e.g. during a parallel sort) loads its string only once.
+ *
+ * Preconditions:
+ * - 'unlockActivityStringSources()' only after 'lockActivityStringSources()' by the same thread
+ *
+ * Postconditions:
+ * - The lock is held / released
+ *
+ * Side Effects:
+ * - May wait for other threads
+ */
+void lockActivityStringSources(void);
+void unlockActivityStringSources(void);
+
+#endif // ACTIVITY_STRING_SOURCE_H          // End of inclusion block
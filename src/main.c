@@ -5,6 +5,108 @@
 #include "activities_container.h"
 
 #define DEFAULT_ACTIVITIES_FILE "activities_list.txt"
+#define DEFAULT_BURNDOWN_FILE "burndown.csv"
+#define DEFAULT_EXPORT_CSV_FILE "activities_export.csv"
+#define DEFAULT_EXPORT_JSONL_FILE "activities_export.jsonl"
+#define BINARY_ARCHIVE_EXTENSION ".bin" // Files with this extension are loaded and saved in the binary snapshot format
+#define COMPACT_ARCHIVE_EXTENSION ".arc" // Files with this extension are loaded and saved in the compact archive format
+#define SLOTTED_STORE_EXTENSION ".slt" // Files with this extension are loaded and saved in the slotted store format
+#define SHARDED_DIRECTORY_EXTENSION ".shards" // Directories with this extension are loaded and saved as a sharded directory
+#define MAPPED_STORE_EXTENSION ".map" // Files with this extension are loaded and saved in the mapped store format
+
+/*
+ * hasFileExtension
+ * 
+ * Syntactic Specification:
+ * int hasFileExtension(const char* filename, const char* extension);
+ * 
+ * Semantic Specification:
+ * Checks if a file name ends with an extension (and has something before it).
+ * 
+ * Preconditions:
+ * - 'extension != NULL'
+ * 
+ * Postconditions:
+ * - Returns 1 if 'filename' ends with 'extension', 0 otherwise (or if it is NULL)
+ * 
+ * Side Effects:
+ * - None
+ */
+int hasFileExtension(const char* filename, const char* extension) {
+	if (filename == NULL) return 0;
+	
+	size_t length = strlen(filename);
+	size_t extensionLength = strlen(extension);
+	return (length > extensionLength && strcmp(filename + length - extensionLength, extension) == 0) ? 1 : 0;
+}
+
+/*
+ * getActivitiesFileFormat
+ * 
+ * Syntactic Specification:
+ * int getActivitiesFileFormat(const char* filename);
+ * 
+ * Semantic Specification:
+ * Returns the format of a file of activities from the extension of its name: binary snapshot for
+ * BINARY_ARCHIVE_EXTENSION, compact archive for COMPACT_ARCHIVE_EXTENSION, slotted store for
+ * SLOTTED_STORE_EXTENSION, sharded directory for SHARDED_DIRECTORY_EXTENSION, mapped store for
+ * MAPPED_STORE_EXTENSION, text for any other name.
+ * 
+ * Preconditions:
+ * - None
+ * 
+ * Postconditions:
+ * - Returns ACTIVITIES_FORMAT_BINARY, ACTIVITIES_FORMAT_ARCHIVE, ACTIVITIES_FORMAT_STORE, ACTIVITIES_FORMAT_SHARDS,
+ *   ACTIVITIES_FORMAT_MAPPED or ACTIVITIES_FORMAT_TEXT
+ * 
+ * Side Effects:
+ * - None
+ */
+int getActivitiesFileFormat(const char* filename) {
+	if (hasFileExtension(filename, BINARY_ARCHIVE_EXTENSION)) return ACTIVITIES_FORMAT_BINARY;
+	if (hasFileExtension(filename, COMPACT_ARCHIVE_EXTENSION)) return ACTIVITIES_FORMAT_ARCHIVE;
+	if (hasFileExtension(filename, SLOTTED_STORE_EXTENSION)) return ACTIVITIES_FORMAT_STORE;
+	if (hasFileExtension(filename, SHARDED_DIRECTORY_EXTENSION)) return ACTIVITIES_FORMAT_SHARDS;
+	if (hasFileExtension(filename, MAPPED_STORE_EXTENSION)) return ACTIVITIES_FORMAT_MAPPED;
+	
+	return ACTIVITIES_FORMAT_TEXT;
+}
+
+/*
+ * readActivitiesFromAnyFile
+ * 
+ * Syntactic Specification:
+ * ActivitiesContainer readActivitiesFromAnyFile(const char* filename, int lazyDescr);
+ * 
+ * Semantic Specification:
+ * Reads the activities of a file into a new container, in the format given by the extension of its
+ * name (see 'getActivitiesFileFormat()'). With 'lazyDescr', the descriptions of a text file are read
+ * only when needed (see 'readActivitiesFromFileWithLazyDescr()'). A mapped store is only opened: its
+ * activities are read by the first operation that needs them (see 'readActivitiesFromMapFile()').
+ * 
+ * Preconditions:
+ * - 'filename != NULL'
+ * 
+ * Postconditions:
+ * - Returns the new container (empty if the file doesn't exist or is not valid), NULL if memory allocation fails
+ * 
+ * Side Effects:
+ * - File reading
+ * - Output to stdout (informational messages)
+ */
+ActivitiesContainer readActivitiesFromAnyFile(const char* filename, int lazyDescr) {
+	int numActivities = 0;
+	switch (getActivitiesFileFormat(filename)) {
+		case ACTIVITIES_FORMAT_BINARY:	return readActivitiesFromBinaryFile(filename, &numActivities);
+		case ACTIVITIES_FORMAT_ARCHIVE:	return readActivitiesFromArchiveFile(filename, &numActivities);
+		case ACTIVITIES_FORMAT_STORE:	return readActivitiesFromStoreFile(filename, &numActivities);
+		case ACTIVITIES_FORMAT_SHARDS:	return readActivitiesFromShardsDirectory(filename, &numActivities);
+		case ACTIVITIES_FORMAT_MAPPED:	return readActivitiesFromMapFile(filename, &numActivities);
+		default:	break;
+	}
+	
+	return lazyDescr ? readActivitiesFromFileWithLazyDescr(filename, &numActivities) : readActivitiesFromFile(filename, &numActivities);
+}
 
 /*
  * displayStartMenu
@@ -31,6 +133,7 @@ void displayStartMenu() {
 	printf("=========================\n");
 	printf("1. Carica le attività da file\n");
 	printf("2. Crea un nuovo contenitore (vuoto) di attività\n");
+	printf("3. Carica le attività da file (descrizioni lette dal file solo quando servono)\n");
 	printf("0. Esci\n");
 	printf("Scelta: ");
 }
@@ -65,6 +168,10 @@ void displayMainMenu() {
 	printf("5. Visualizza report settimanale\n");
 	printf("6. Visualizza dettaglio attività\n");
 	printf("7. Salva su file\n");
+	printf("8. Esporta burndown (CSV)\n");
+	printf("9. Visualizza attività a rischio\n");
+	printf("10. Esporta attività (CSV o JSON Lines)\n");
+	printf("11. Importa attività (CSV o JSON Lines)\n");
 	printf("0. Esci\n");
 	printf("Scelta: ");
 }
@@ -84,7 +191,7 @@ void displayMainMenu() {
  * - None
  * 
  * Postconditions:
- * - Returns a valid ActivitiesContainer if user chooses option 1 or 2
+ * - Returns a valid ActivitiesContainer if user chooses option 1, 2 or 3
  * - Returns NULL if user chooses to exit (option 0)
  * - Memory allocated for userFile is freed if necessary
  * 
@@ -92,11 +199,11 @@ void displayMainMenu() {
  * - Input from stdin
  * - Output to stdout
  * - Dynamic memory allocation/deallocation
- * - Possible file reading
+ * - Possible file reading (the loaded file and its journal)
  */
 ActivitiesContainer handleStartMenu() {
 	displayStartMenu();
-	int choice = getChoice(2);
+	int choice = getChoice(3);
 
 	ActivitiesContainer container = NULL;
 
@@ -105,15 +212,15 @@ ActivitiesContainer handleStartMenu() {
 			printf("Uscita in corso...\n");
 			break;
 
-		case 1: {
-			char* userFile = getInfoFromUser("Nome file da caricare (lascia vuoto per default): ");
-			int numActivities = 0;
-			if (userFile == NULL) {
-				container = readActivitiesFromFile(DEFAULT_ACTIVITIES_FILE, &numActivities);
-			} else {
-				container = readActivitiesFromFile(userFile, &numActivities);
-				free(userFile);
-			}
+		case 1:
+		case 3: { // 3: the descriptions of a text file are read only when needed
+			char* userFile = getInfoFromUser("Nome file da caricare (estensione " BINARY_ARCHIVE_EXTENSION " per un archivio binario, " COMPACT_ARCHIVE_EXTENSION " per un archivio compatto, " SLOTTED_STORE_EXTENSION " per un archivio a slot, " SHARDED_DIRECTORY_EXTENSION " per una cartella a blocchi, " MAPPED_STORE_EXTENSION " per un archivio mappato in memoria - lascia vuoto per default): ");
+			const char* filename = (userFile != NULL) ? userFile : DEFAULT_ACTIVITIES_FILE;
+			container = readActivitiesFromAnyFile(filename, choice == 3);
+			
+			// The modifications not yet saved to the file are in its journal
+			openActivitiesJournal(container, filename);
+			free(userFile);
 			break;
 		}
 
@@ -148,7 +255,7 @@ ActivitiesContainer handleStartMenu() {
  * Postconditions:
  * - Returns -1 if user chooses to exit (option 0)
  * - Returns the chosen option number in other cases
- * - Container may be modified by operations 2 and 3
+ * - Container may be modified by operations 2, 3 and 11
  * - If option 0 is confirmed, container is deallocated and program terminates
  * 
  * Side Effects:
@@ -156,12 +263,13 @@ ActivitiesContainer handleStartMenu() {
  * - Output to stdout
  * - Possible modification of activities container
  * - Possible dynamic memory allocation/deallocation
- * - Possible file writing (option 7)
+ * - Possible file reading (option 11)
+ * - Possible file writing (options 7, 8 and 10)
  * - Possible complete memory deallocation (option 0)
  */
 int handleMainMenu(ActivitiesContainer container) {
 	displayMainMenu();
-	int choice = getChoice(7);
+	int choice = getChoice(11);
 	
 	switch (choice) {
 		case 0: { // Menu: '0. Esci'
@@ -175,7 +283,15 @@ int handleMainMenu(ActivitiesContainer container) {
 		}
 
 		case 1: { // Menu: '1. Visualizza tutte le attività'
-			printActivities(container);
+			printf("\nOrdina per: 0. id | 1. titolo | 2. descrizione | 3. corso | 4. data inserimento | 5. data scadenza | 6. data completamento\n");
+			printf("            7. tempo totale | 8. tempo impiegato | 9. priorità | 10. %% completamento | 11. tempo al completamento | 12. priorità e scadenza\n");
+			printf("Scelta: ");
+			int sortBy = getChoice(12);
+			if (sortBy == 0) {
+				printActivities(container);
+			} else {
+				printActivitiesSorted(container, sortBy);
+			}
 			break;
 		}
 
@@ -224,15 +340,77 @@ int handleMainMenu(ActivitiesContainer container) {
 		}
 
 		case 7: { // Menu: '7. Salva su file'
-			char* userFile = getInfoFromUser("Nome file per salvataggio (se esiste sarà sovrascritto - lascia vuoto per default): ");
-			int saveResult = 0;
+			char* userFile = getInfoFromUser("Nome file per salvataggio (se esiste sarà sovrascritto - estensione " BINARY_ARCHIVE_EXTENSION " per un archivio binario, " COMPACT_ARCHIVE_EXTENSION " per un archivio compatto, " SLOTTED_STORE_EXTENSION " per un archivio a slot, " SHARDED_DIRECTORY_EXTENSION " per una cartella a blocchi, " MAPPED_STORE_EXTENSION " per un archivio mappato in memoria - lascia vuoto per default): ");
+			const char* filename = (userFile != NULL) ? userFile : DEFAULT_ACTIVITIES_FILE;
+			
+			// Saving to the loaded file also compacts its journal
+			saveActivitiesAndCompactJournal(filename, container, getActivitiesFileFormat(filename));
+			free(userFile);
+			
+			break;
+		}
+
+		case 8: { // Menu: '8. Esporta burndown (CSV)'
+			printf("\nData di inizio del periodo (la fine è la data odierna):");
+			time_t fromDate = getDateFromUser();
+			time_t toDate = time(NULL);
+			if (fromDate > toDate) {
+				printf("\nLa data di inizio deve precedere la data odierna.\n");
+				break;
+			}
+
+			char* userFile = getInfoFromUser("Nome file CSV (se esiste sarà sovrascritto - lascia vuoto per default): ");
 			if (userFile == NULL) {
-				saveResult = saveActivitiesToFile(DEFAULT_ACTIVITIES_FILE, container);
+				saveActivitiesBurndownToFile(DEFAULT_BURNDOWN_FILE, container, fromDate, toDate);
 			} else {
-				saveResult = saveActivitiesToFile(userFile, container);
+				saveActivitiesBurndownToFile(userFile, container, fromDate, toDate);
 				free(userFile);
 			}
-			
+			break;
+		}
+
+		case 9: { // Menu: '9. Visualizza attività a rischio'
+			printf("\nMinuti di lavoro disponibili al giorno (da 1 a 1440, 0 per il default di %d): ", DEFAULT_DAILY_CAPACITY);
+			unsigned int dailyCapacity = getChoice(1440);
+			if (dailyCapacity == 0) dailyCapacity = DEFAULT_DAILY_CAPACITY;
+			printActivitiesRisk(container, dailyCapacity);
+			break;
+		}
+
+		case 10: { // Menu: '10. Esporta attività (CSV o JSON Lines)'
+			printf("\nFormato: 1. CSV | 2. JSON Lines\nScelta: ");
+			int format = getChoice(2);
+			if (format == 0) break;
+
+			char* userFile = getInfoFromUser("Nome file di esportazione (se esiste sarà sovrascritto - lascia vuoto per default): ");
+			if (format == 1) {
+				exportActivitiesToCsv((userFile != NULL) ? userFile : DEFAULT_EXPORT_CSV_FILE, container);
+			} else {
+				exportActivitiesToJsonl((userFile != NULL) ? userFile : DEFAULT_EXPORT_JSONL_FILE, container);
+			}
+			free(userFile);
+			break;
+		}
+
+		case 11: { // Menu: '11. Importa attività (CSV o JSON Lines)'
+			printf("\nFormato: 1. CSV | 2. JSON Lines\nScelta: ");
+			int format = getChoice(2);
+			if (format == 0) break;
+
+			char* userFile = getInfoFromUser("Nome file da importare: ");
+			if (userFile == NULL) break;
+
+			ActivityImportMapping mapping = newActivityImportMapping();
+			char* userMapping = getInfoFromUser("Colonne (es. titolo=Nome,corso=Insegnamento,id= - lascia vuoto per le colonne dell'esportazione): ");
+			if (mapping != NULL && userMapping != NULL && parseActivityImportMapping(mapping, userMapping) != 0) {
+				printf("Corrispondenza delle colonne non valida.\n");
+			} else if (mapping != NULL) {
+				int imported = 0;
+				importActivitiesFromFile(container, userFile, (format == 1) ? ACTIVITY_IMPORT_CSV : ACTIVITY_IMPORT_JSONL, mapping, &imported);
+			}
+			deleteActivityImportMapping(&mapping);
+			free(userMapping);
+			free(userFile);
 			break;
 		}
 
@@ -244,7 +422,94 @@ int handleMainMenu(ActivitiesContainer container) {
 	return choice;
 }
 	
-int main() {
+/*
+ * handleCommandLine
+ * 
+ * Syntactic Specification:
+ * int handleCommandLine(int argc, char* argv[]);
+ * 
+ * Semantic Specification:
+ * Runs the operation given on the command line, with no menu (e.g. from a script):
+ * - '--export-csv <file attività> <file CSV>': exports the activities of the file as CSV
+ * - '--export-jsonl <file attività> <file JSONL>': exports the activities of the file as JSON Lines
+ * - '--import-csv <file CSV> <file attività> [colonne]': imports the activities of a CSV file into the file
+ *   of activities (created if it doesn't exist), with the column mapping of 'parseActivityImportMapping()'
+ * - '--import-jsonl <file JSONL> <file attività> [colonne]': the same for a JSON Lines file
+ * - '--verify <file attività>': checks the file against its checksum file, without reading the activities
+ *   (see 'verifyActivitiesFile()')
+ * The file of activities is read and saved in the format given by its extension (see 'getActivitiesFileFormat()');
+ * an import also applies and then compacts its journal, as the menu does, and an export replays it first
+ * (see 'exportActivitiesWithJournal()'), so it holds the activities the menu would show. A mapped store with
+ * an empty journal is exported straight from its mapping, without reading it into a container
+ * (see 'exportActivitiesFromMapFile()').
+ * 
+ * Preconditions:
+ * - 'argc > 1', 'argv' as passed to 'main()'
+ * 
+ * Postconditions:
+ * - Returns 0 if the operation succeeds (for '--verify', if the file is intact), 1 otherwise (unknown operation
+ *   or wrong arguments: the usage is printed)
+ * 
+ * Side Effects:
+ * - File reading and writing
+ * - Output to stdout and stderr
+ */
+int handleCommandLine(int argc, char* argv[]) {
+	int isCsv = (strcmp(argv[1], "--export-csv") == 0);
+	int isJsonl = (strcmp(argv[1], "--export-jsonl") == 0);
+	int isImportCsv = (strcmp(argv[1], "--import-csv") == 0);
+	int isImportJsonl = (strcmp(argv[1], "--import-jsonl") == 0);
+	int isVerify = (strcmp(argv[1], "--verify") == 0);
+	if (((isCsv || isJsonl) && argc != 4) || ((isImportCsv || isImportJsonl) && (argc < 4 || argc > 5)) ||
+	    (isVerify && argc != 3) || (!isCsv && !isJsonl && !isImportCsv && !isImportJsonl && !isVerify)) {
+		fprintf(stderr, "Uso: %s [--export-csv <file attività> <file CSV> | --export-jsonl <file attività> <file JSONL> |\n"
+		                "       --import-csv <file CSV> <file attività> [colonne] | --import-jsonl <file JSONL> <file attività> [colonne] |\n"
+		                "       --verify <file attività>]\n", argv[0]);
+		return 1;
+	}
+	
+	if (isVerify) return verifyActivitiesFile(argv[2], getActivitiesFileFormat(argv[2]));
+	
+	if ((isCsv || isJsonl) && getActivitiesFileFormat(argv[2]) == ACTIVITIES_FORMAT_MAPPED) {
+		return exportActivitiesFromMapFile(argv[2], argv[3], isJsonl);
+	}
+	
+	if (isCsv || isJsonl) {
+		ActivitiesContainer container = readActivitiesFromAnyFile(argv[2], 0);
+		if (container == NULL) return 1;
+		
+		int result = exportActivitiesWithJournal(argv[2], container, argv[3], isJsonl);
+		deleteActivityContainer(container);
+		return result;
+	}
+	
+	ActivityImportMapping mapping = newActivityImportMapping();
+	if (mapping == NULL) return 1;
+	if (argc == 5 && parseActivityImportMapping(mapping, argv[4]) != 0) {
+		fprintf(stderr, "Corrispondenza delle colonne non valida: %s\n", argv[4]);
+		deleteActivityImportMapping(&mapping);
+		return 1;
+	}
+	
+	ActivitiesContainer container = readActivitiesFromAnyFile(argv[3], 0);
+	if (container == NULL) {
+		deleteActivityImportMapping(&mapping);
+		return 1;
+	}
+	openActivitiesJournal(container, argv[3]);
+	
+	int imported = 0;
+	int result = importActivitiesFromFile(container, argv[2], isImportCsv ? ACTIVITY_IMPORT_CSV : ACTIVITY_IMPORT_JSONL, mapping, &imported);
+	if (result == 0) result = saveActivitiesAndCompactJournal(argv[3], container, getActivitiesFileFormat(argv[3]));
+	
+	deleteActivityContainer(container);
+	deleteActivityImportMapping(&mapping);
+	return result;
+}
+
+int main(int argc, char* argv[]) {
+	if (argc > 1) return handleCommandLine(argc, argv);
+	
 	ActivitiesContainer activities =  handleStartMenu();
 	
 	if (activities != NULL) {
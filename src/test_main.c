@@ -1,10 +1,20 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
 
 #include "activity_helper.h"
 #include "activities_container.h"
 #include "activities_container_helper.h"
+#include "activities_container_journal.h"
+#include "activities_container_writer.h"
+#include "activities_container_shards.h"
+#include "activities_container_checksum.h"
+#include "activities_container_mapped.h"
+#include "activities_container_support_list.h"
+#include "activities_container_support_vector.h"
 
 #define TESTS_RESULTS_FILENAME "TESTS_RESULT.txt" 
 
@@ -85,6 +95,65 @@ int compareFiles(const char* filenameA, const char* filenameB) {
 }
 
 
+/*
+ * redirectStdoutToFile
+ * 
+ * Syntactic Specification:
+ * int redirectStdoutToFile(const char* filename);
+ * 
+ * Semantic Specification:
+ * Redirects stdout to a file (created or truncated), to test the functions that print only to stdout
+ * (e.g. the cached renderings). 'restoreStdout()' brings it back.
+ * 
+ * Preconditions:
+ * - 'filename != NULL'
+ * 
+ * Postconditions:
+ * - Returns the descriptor of the previous stdout (to pass to 'restoreStdout()'), -1 on error (stdout unchanged)
+ * 
+ * Side Effects:
+ * - Flushes stdout, creates the file
+ */
+int redirectStdoutToFile(const char* filename) {
+	fflush(stdout);
+	int savedFd = dup(STDOUT_FILENO);
+	int fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (savedFd < 0 || fd < 0 || dup2(fd, STDOUT_FILENO) < 0) {
+		if (savedFd >= 0) close(savedFd);
+		if (fd >= 0) close(fd);
+		return -1;
+	}
+	close(fd);
+	return savedFd;
+}
+
+/*
+ * restoreStdout
+ * 
+ * Syntactic Specification:
+ * void restoreStdout(int savedFd);
+ * 
+ * Semantic Specification:
+ * Brings back stdout redirected by 'redirectStdoutToFile()'.
+ * 
+ * Preconditions:
+ * - 'savedFd' returned by 'redirectStdoutToFile()' (no effect if negative)
+ * 
+ * Postconditions:
+ * - stdout is the previous one, the file has all the output
+ * 
+ * Side Effects:
+ * - Flushes stdout, closes 'savedFd'
+ */
+void restoreStdout(int savedFd) {
+	if (savedFd < 0) return;
+	
+	fflush(stdout);
+	dup2(savedFd, STDOUT_FILENO);
+	close(savedFd);
+}
+
+
 /*
  * tc_1
  * 
@@ -407,67 +476,1719 @@ int tc_16() {
 
 
 /*
- * execTest
+ * tc_17
  * 
  * Syntactic Specification:
- * void execTest(int numTest, FILE* fileWithTestsResult);
+ * int tc_17();
  * 
  * Semantic Specification:
- * Executes a specific test and records the results both to console and file.
+ * Test case 17: loads activities from file and prints and tests the burndown time series (CSV).
+ *               This also includes: activities completed before being inserted and activities completed after the period.
  * 
  * Preconditions:
- * - 'numTest' must be a value between 1 and 16
- * - 'fileWithTestsResult' can be NULL or a valid file pointer opened for writing
+ * - The file "tc_17.txt" must exist and be accessible
+ * - The file "tc_17_oracle.txt" must exist for comparison
  * 
  * Postconditions:
- * - The specified test is executed
- * - Results are printed to console
- * - If the file is valid, results are also written to file
+ * - Returns 0 if the test passes
+ * - Returns 1 if the test fails
  * 
  * Side Effects:
- * - Prints messages to stdout
- * - Writes to file if the pointer is valid
- * - May print error messages for unsupported tests
+ * - Creates the file "tc_17_output.txt"
+ * - Allocates and deallocates memory for the container
+ * - Opens and closes files for writing
  */
-void execTest(int numTest, FILE* fileWithTestsResult) {
-	printf("Eseguo TC_%d...\n", numTest);
-	int tc_result = 1;
+int tc_17() {
+	int numActivities = 0;
+	ActivitiesContainer container = readActivitiesFromFile("tc_17.txt", &numActivities);
+	FILE* file = fopen("tc_17_output.txt", "w");
+	if (file == NULL) return 1; //KO
+	int burndownResult = printActivitiesBurndownToFile(container, 1746500000, 1747900000, file);
+	fclose(file);
+	deleteActivityContainer(container);
+	if (burndownResult != 0) return 1; //KO
+	int compareResult = compareFiles("tc_17_output.txt", "tc_17_oracle.txt");
+	return (compareResult == 0) ? 0 : 1;
+}
 
-	char* okText = "SUPERATO";
-	char* errorText = "FALLITO";
+
+/*
+ * tc_18
+ * 
+ * Syntactic Specification:
+ * int tc_18();
+ * 
+ * Semantic Specification:
+ * Test case 18: loads activities from file and prints and tests the "rischio" view (at a fixed date),
+ *               then modifies an activity and checks that the view is updated.
+ * 
+ * Preconditions:
+ * - The file "tc_18.txt" must exist and be accessible
+ * - The file "tc_18_oracle.txt" must exist for comparison
+ * 
+ * Postconditions:
+ * - Returns 0 if the test passes
+ * - Returns 1 if the test fails
+ * 
+ * Side Effects:
+ * - Creates the file "tc_18_output.txt"
+ * - Allocates and deallocates memory for the container
+ * - Opens and closes files for writing
+ */
+int tc_18() {
+	int numActivities = 0;
+	ActivitiesContainer container = readActivitiesFromFile("tc_18.txt", &numActivities);
+	FILE* file = fopen("tc_18_output.txt", "w");
+	if (file == NULL) return 1; //KO
+	printActivitiesRiskToFile(container, 1748000000, 60, file);
+	Activity activity = getActivityWithId(container, 5);
+	if (activity != NULL) setActivityUsedTime(activity, 3900);
+	printActivitiesRiskToFile(container, 1748000000, 60, file);
+	fclose(file);
+	deleteActivityContainer(container);
+	int compareResult = compareFiles("tc_18_output.txt", "tc_18_oracle.txt");
+	return (compareResult == 0) ? 0 : 1;
+}
+
+
+/*
+ * tc_19
+ * 
+ * Syntactic Specification:
+ * int tc_19();
+ * 
+ * Semantic Specification:
+ * Test case 19: loads activities from file and prints them sorted by priority and by time to completion
+ *               (sorted views), then modifies, removes and inserts activities and checks that the views are updated.
+ * 
+ * Preconditions:
+ * - The file "tc_19.txt" must exist and be accessible
+ * - The file "tc_19_oracle.txt" must exist for comparison
+ * 
+ * Postconditions:
+ * - Returns 0 if the test passes
+ * - Returns 1 if the test fails
+ * 
+ * Side Effects:
+ * - Creates the file "tc_19_output.txt"
+ * - Allocates and deallocates memory for the container
+ * - Opens and closes files for writing
+ */
+int tc_19() {
+	int numActivities = 0;
+	ActivitiesContainer container = readActivitiesFromFile("tc_19.txt", &numActivities);
+	FILE* file = fopen("tc_19_output.txt", "w");
+	if (file == NULL) return 1; //KO
+	int printResult = printActivitiesSortedToFile(container, 9, file);
+	printResult += printActivitiesSortedToFile(container, 11, file);
+	Activity activity = getActivityWithId(container, 1);
+	if (activity != NULL) setActivityPriority(activity, 3);
+	activity = getActivityWithId(container, 7);
+	if (activity != NULL) setActivityUsedTime(activity, 0);
+	removeActivity(container, 3);
+	insertActivity(container, newActivity(0, "Nuova activity", "Inserita dopo le viste", "PSD", 1746700000, 1749000000, 0, 300, 0, 1) );
+	fprintf(file, "\n");
+	printResult += printActivitiesSortedToFile(container, 9, file);
+	printResult += printActivitiesSortedToFile(container, 11, file);
+	printResult += printActivitiesSortedToFile(container, 12, file);
+	fclose(file);
+	deleteActivityContainer(container);
+	if (printResult != 0) return 1; //KO
+	int compareResult = compareFiles("tc_19_output.txt", "tc_19_oracle.txt");
+	return (compareResult == 0) ? 0 : 1;
+}
+
+
+/*
+ * hasActivityPriority
+ *
+ * Syntactic Specification:
+ * int hasActivityPriority(Activity a, void* context);
+ *
+ * Semantic Specification:
+ * Filter for 'getActivitiesBitmapWhere()': selects the activities with the priority pointed by 'context'.
+ *
+ * Preconditions:
+ * - 'a != NULL', 'context' points to a short unsigned int
+ *
+ * Postconditions:
+ * - Returns 1 if the activity has the priority, 0 otherwise
+ *
+ * Side Effects:
+ * - None
+ */
+int hasActivityPriority(Activity a, void* context) {
+	return getActivityPriority(a) == *(short unsigned int*)context;
+}
+
+/*
+ * isActivityCompletedFilter
+ *
+ * Syntactic Specification:
+ * int isActivityCompletedFilter(Activity a, void* context);
+ *
+ * Semantic Specification:
+ * Filter for 'getActivitiesBitmapWhere()': selects the completed activities ('context' is not used).
+ *
+ * Preconditions:
+ * - 'a != NULL'
+ *
+ * Postconditions:
+ * - Returns 1 if the activity is completed, 0 otherwise
+ *
+ * Side Effects:
+ * - None
+ */
+int isActivityCompletedFilter(Activity a, void* context) {
+	(void)context;
+	return isActivityCompleted(a);
+}
+
+/*
+ * printActivityBitmapSummaryToFile
+ *
+ * Syntactic Specification:
+ * void printActivityBitmapSummaryToFile(const char* label, ActivityBitmap bitmap, FILE* file);
+ *
+ * Semantic Specification:
+ * Prints to file the cardinality of the set, the sum of its ids (visited in order) and its first and last ids.
+ *
+ * Preconditions:
+ * - 'label != NULL', 'file' opened for writing
+ *
+ * Postconditions:
+ * - A line is printed ("NULL" if 'bitmap == NULL')
+ *
+ * Side Effects:
+ * - Writing to file
+ */
+void printActivityBitmapSummaryToFile(const char* label, ActivityBitmap bitmap, FILE* file) {
+	if (bitmap == NULL) {
+		fprintf(file, "%s: NULL\n", label);
+		return;
+	}
+
+	long long sum = 0;
+	int first = getNextIdInActivityBitmap(bitmap, 0);
+	int last = -1;
+	for (int id = first; id >= 0; id = getNextIdInActivityBitmap(bitmap, id + 1)) {
+		sum += id;
+		last = id;
+	}
+	fprintf(file, "%s: %d id, somma %lld, primo %d, ultimo %d\n", label, getActivityBitmapCardinality(bitmap), sum, first, last);
+}
+
+/*
+ * tc_20
+ *
+ * Syntactic Specification:
+ * int tc_20();
+ *
+ * Semantic Specification:
+ * Test case 20: loads activities from file and combines the result sets of some filters (priority,
+ * completion) with AND/OR/ANDNOT, printing the selected activities; then combines large sets of ids
+ * (sparse and dense chunks) and prints their cardinality and the sum of their ids.
+ *
+ * Preconditions:
+ * - The file "tc_20.txt" must exist and be accessible
+ * - The file "tc_20_oracle.txt" must exist for comparison
+ *
+ * Postconditions:
+ * - Returns 0 if the test passes
+ * - Returns 1 if the test fails
+ *
+ * Side Effects:
+ * - Creates the file "tc_20_output.txt"
+ * - Allocates and deallocates memory for the container and the sets
+ * - Opens and closes files for writing
+ */
+int tc_20() {
+	int numActivities = 0;
+	ActivitiesContainer container = readActivitiesFromFile("tc_20.txt", &numActivities);
+	FILE* file = fopen("tc_20_output.txt", "w");
+	if (file == NULL) return 1; //KO
+
+	short unsigned int high = 1, medium = 2;
+	ActivityBitmap all = getActivitiesBitmapWhere(container, NULL, NULL);
+	ActivityBitmap highPriority = getActivitiesBitmapWhere(container, hasActivityPriority, &high);
+	ActivityBitmap mediumPriority = getActivitiesBitmapWhere(container, hasActivityPriority, &medium);
+	ActivityBitmap completed = getActivitiesBitmapWhere(container, isActivityCompletedFilter, NULL);
+	ActivityBitmap notCompleted = andNotActivityBitmaps(all, completed);
+	ActivityBitmap highOrMedium = orActivityBitmaps(highPriority, mediumPriority);
+	ActivityBitmap selected = andActivityBitmaps(highOrMedium, notCompleted);
+	printActivityBitmapSummaryToFile("tutte", all, file);
+	printActivityBitmapSummaryToFile("completate", completed, file);
+	printActivityBitmapSummaryToFile("alta o media, non completate", selected, file);
+	printActivitiesInBitmapToFile(container, selected, file);
+	removeActivity(container, 5);
+	printActivitiesInBitmapToFile(container, selected, file);
+
+	ActivityBitmap even = newActivityBitmap();
+	ActivityBitmap multipleOfThree = newActivityBitmap();
+	ActivityBitmap firstIds = newActivityBitmap();
+	ActivityBitmap sparse = newActivityBitmap();
+	int addResult = 0;
+	for (int id = 199998; id >= 0; id -= 2) addResult += addIdToActivityBitmap(even, id);
+	for (int id = 0; id < 200000; id += 3) addResult += addIdToActivityBitmap(multipleOfThree, id);
+	for (int id = 0; id < 4000; id++) addResult += addIdToActivityBitmap(firstIds, id);
+	addResult += addIdToActivityBitmap(sparse, 140001);
+	addResult += addIdToActivityBitmap(sparse, 5);
+	addResult += addIdToActivityBitmap(sparse, 70000);
+	addResult += addIdToActivityBitmap(sparse, 70000);
+	fprintf(file, "\n");
+
+	ActivityBitmap results[] = {
+		andActivityBitmaps(even, multipleOfThree), orActivityBitmaps(even, multipleOfThree),
+		andNotActivityBitmaps(even, multipleOfThree), andNotActivityBitmaps(multipleOfThree, even),
+		andActivityBitmaps(firstIds, even), orActivityBitmaps(firstIds, sparse),
+		andActivityBitmaps(sparse, even), andNotActivityBitmaps(sparse, even)
+	};
+	char* labels[] = {
+		"pari AND multipli di 3", "pari OR multipli di 3", "pari ANDNOT multipli di 3", "multipli di 3 ANDNOT pari",
+		"primi 4000 AND pari", "primi 4000 OR sparsi", "sparsi AND pari", "sparsi ANDNOT pari"
+	};
+	printActivityBitmapSummaryToFile("pari", even, file);
+	printActivityBitmapSummaryToFile("multipli di 3", multipleOfThree, file);
+	printActivityBitmapSummaryToFile("sparsi", sparse, file);
+	for (int i = 0; i < 8; i++) {
+		printActivityBitmapSummaryToFile(labels[i], results[i], file);
+		deleteActivityBitmap(&results[i]);
+	}
+	fprintf(file, "appartenenza: %d %d %d %d\n", isIdInActivityBitmap(even, 131072), isIdInActivityBitmap(even, 131073),
+			isIdInActivityBitmap(sparse, 5), isIdInActivityBitmap(sparse, 6));
+	fclose(file);
+
+	deleteActivityBitmap(&all);
+	deleteActivityBitmap(&highPriority);
+	deleteActivityBitmap(&mediumPriority);
+	deleteActivityBitmap(&completed);
+	deleteActivityBitmap(&notCompleted);
+	deleteActivityBitmap(&highOrMedium);
+	deleteActivityBitmap(&selected);
+	deleteActivityBitmap(&even);
+	deleteActivityBitmap(&multipleOfThree);
+	deleteActivityBitmap(&firstIds);
+	deleteActivityBitmap(&sparse);
+	deleteActivityContainer(container);
+	if (addResult != 0) return 1; //KO
+	int compareResult = compareFiles("tc_20_output.txt", "tc_20_oracle.txt");
+	return (compareResult == 0) ? 0 : 1;
+}
+
+
+/*
+ * tc_21
+ *
+ * Syntactic Specification:
+ * int tc_21();
+ *
+ * Semantic Specification:
+ * Test case 21: loads activities from a file with unusual lines (CRLF line endings, signs, spaces and
+ * trailing characters around the numbers, out of range and missing numbers, a line longer than the
+ * 1023 characters read at once, no final newline) and saves them, checking the memory mapped loader.
+ *
+ * Preconditions:
+ * - The file "tc_21.txt" must exist and be accessible
+ * - The file "tc_21_oracle.txt" must exist for comparison
+ *
+ * Postconditions:
+ * - Returns 0 if the test passes (output file equals oracle)
+ * - Returns 1 if the test fails
+ *
+ * Side Effects:
+ * - Creates the file "tc_21_output.txt"
+ * - Allocates and deallocates memory for the activity container
+ */
+int tc_21() {
+	int numActivities = 0;
+	ActivitiesContainer container = readActivitiesFromFile("tc_21.txt", &numActivities);
+	int saveResult = saveActivitiesToFile("tc_21_output.txt", container);
+	deleteActivityContainer(container);
+	if (saveResult != 0 || numActivities != 3) return 1;
+	int compareResult = compareFiles("tc_21_output.txt", "tc_21_oracle.txt");
+	return (compareResult == 0) ? 0 : 1;
+}
+
+
+/*
+ * tc_22
+ *
+ * Syntactic Specification:
+ * int tc_22();
+ *
+ * Semantic Specification:
+ * Test case 22: loads activities from a text file, saves them in the binary snapshot format, loads the
+ * snapshot (bulk build of the tree) and saves it as text; also checks that a text file is rejected as snapshot.
+ *
+ * Preconditions:
+ * - The file "tc_22.txt" must exist and be accessible
+ * - The file "tc_22_oracle.txt" must exist for comparison
+ *
+ * Postconditions:
+ * - Returns 0 if the test passes (output file equals oracle)
+ * - Returns 1 if the test fails
+ *
+ * Side Effects:
+ * - Creates the files "tc_22_output.bin" and "tc_22_output.txt"
+ * - Allocates and deallocates memory for the activity containers
+ */
+int tc_22() {
+	int numActivities = 0;
+	ActivitiesContainer container = readActivitiesFromFile("tc_22.txt", &numActivities);
+	int saveResult = saveActivitiesToBinaryFile("tc_22_output.bin", container);
+	deleteActivityContainer(container);
 	
-	switch (numTest) {
-		case 1:	tc_result = tc_1();
-					break;
-		case 2:	tc_result = tc_2();
-					break;
-		case 3:	tc_result = tc_3_to_11(3, "tc_3.txt", "tc_3_output.txt","tc_3_oracle.txt");
-					break;
-		case 4:	tc_result = tc_3_to_11(4, "tc_4.txt", "tc_4_output.txt","tc_4_oracle.txt");
-					break;
-		case 5:	tc_result = tc_3_to_11(5, "tc_5.txt", "tc_5_output.txt","tc_5_oracle.txt");
-					break;
-		case 6:	tc_result = tc_3_to_11(6, "tc_6.txt", "tc_6_output.txt","tc_6_oracle.txt");
-					break;
-		case 7:	tc_result = tc_3_to_11(7, "tc_7.txt", "tc_7_output.txt","tc_7_oracle.txt");
-					break;
-		case 8:	tc_result = tc_3_to_11(8, "tc_8.txt", "tc_8_output.txt","tc_8_oracle.txt");
-					break;
-		case 9:	tc_result = tc_3_to_11(9, "tc_9.txt", "tc_9_output.txt","tc_9_oracle.txt");
-					break;
-		case 10:	tc_result = tc_3_to_11(10, "tc_10.txt", "tc_10_output.txt","tc_10_oracle.txt");
-					break;
-		case 11:	tc_result = tc_3_to_11(11, "tc_11.txt", "tc_11_output.txt","tc_11_oracle.txt");
-					break;
-		case 12:	tc_result = tc_12();
-					break;
-		case 13:	tc_result = tc_13();
-					break;
-		case 14:	tc_result = tc_14();
-					break;
-		case 15:	tc_result = tc_15();
-					break;
-		case 16:	tc_result = tc_16();
+	int numBinaryActivities = 0;
+	container = readActivitiesFromBinaryFile("tc_22_output.bin", &numBinaryActivities);
+	saveResult += saveActivitiesToFile("tc_22_output.txt", container);
+	int nextId = getNextId(container);
+	deleteActivityContainer(container);
+	
+	int numInvalidActivities = 0;
+	container = readActivitiesFromBinaryFile("tc_22.txt", &numInvalidActivities);
+	int isInvalidEmpty = (getNextId(container) == 1 && numInvalidActivities == 0);
+	deleteActivityContainer(container);
+	
+	if (saveResult != 0 || numBinaryActivities != numActivities || nextId != 10 || !isInvalidEmpty) return 1;
+	int compareResult = compareFiles("tc_22_output.txt", "tc_22_oracle.txt");
+	return (compareResult == 0) ? 0 : 1;
+}
+
+
+/*
+ * tc_23
+ *
+ * Syntactic Specification:
+ * int tc_23();
+ *
+ * Semantic Specification:
+ * Test case 23: copies the activities of a file to a base file, attaches its journal and modifies the
+ * container (field updates, a removal, an insertion), then loads the base file again replaying the journal
+ * (with a damaged record appended, as after a crash) and compacts it saving to the base file.
+ *
+ * Preconditions:
+ * - The file "tc_23.txt" must exist and be accessible
+ * - The file "tc_23_oracle.txt" must exist for comparison
+ *
+ * Postconditions:
+ * - Returns 0 if the test passes (modified and replayed containers equal the oracle, journal empty after the compaction)
+ * - Returns 1 if the test fails
+ *
+ * Side Effects:
+ * - Creates the files "tc_23_output.txt", "tc_23_output.txt.journal" and "tc_23_output_live.txt"
+ * - Allocates and deallocates memory for the activity containers
+ */
+int tc_23() {
+	int numActivities = 0;
+	ActivitiesContainer container = readActivitiesFromFile("tc_23.txt", &numActivities);
+	int saveResult = saveActivitiesToFile("tc_23_output.txt", container);
+	deleteActivityContainer(container);
+	remove("tc_23_output.txt" ACTIVITY_JOURNAL_EXTENSION);
+	
+	container = readActivitiesFromFile("tc_23_output.txt", &numActivities);
+	int journalResult = openActivitiesJournal(container, "tc_23_output.txt");
+	setActivityPriority(getActivityWithId(container, 1), 3);
+	setActivityName(getActivityWithId(container, 5), "Attività rinominata");
+	setActivityCourse(getActivityWithId(container, 5), NULL);
+	removeActivity(container, 3);
+	Activity activity = newActivity(0, "Attività dal registro", "Inserita dopo il caricamento", "Fisica I",
+									1746612500, 1750413600, 0, 3000, 0, 1);
+	insertActivity(container, activity);
+	setActivityUsedTime(activity, 1200);
+	saveResult += saveActivitiesToFile("tc_23_output_live.txt", container);
+	deleteActivityContainer(container);
+	
+	// An append interrupted by a crash: the record is incomplete
+	FILE* journalFile = fopen("tc_23_output.txt" ACTIVITY_JOURNAL_EXTENSION, "ab");
+	if (journalFile == NULL) return 1;
+	fwrite("\x40\0\0\0\x01", 1, 5, journalFile);
+	fclose(journalFile);
+	
+	container = readActivitiesFromFile("tc_23_output.txt", &numActivities);
+	journalResult += openActivitiesJournal(container, "tc_23_output.txt");
+	int nextId = getNextId(container);
+	saveResult += saveActivitiesAndCompactJournal("tc_23_output.txt", container, ACTIVITIES_FORMAT_TEXT);
+	deleteActivityContainer(container);
+	
+	journalFile = fopen("tc_23_output.txt" ACTIVITY_JOURNAL_EXTENSION, "rb");
+	if (journalFile == NULL) return 1;
+	int isJournalEmpty = (fgetc(journalFile) == EOF);
+	fclose(journalFile);
+	
+	if (saveResult != 0 || journalResult != 0 || nextId != 12 || !isJournalEmpty) return 1;
+	if (compareFiles("tc_23_output_live.txt", "tc_23_oracle.txt") != 0) return 1;
+	int compareResult = compareFiles("tc_23_output.txt", "tc_23_oracle.txt");
+	return (compareResult == 0) ? 0 : 1;
+}
+
+
+/*
+ * tc_24
+ *
+ * Syntactic Specification:
+ * int tc_24();
+ *
+ * Semantic Specification:
+ * Test case 24: saves the activities of a file twice to the same file (the second save replaces the
+ * first one through the temporary file of the writer) and checks that no temporary file is left behind
+ * and that a save to a directory that doesn't exist fails.
+ *
+ * Preconditions:
+ * - The file "tc_24.txt" must exist and be accessible
+ * - The file "tc_24_oracle.txt" must exist for comparison
+ *
+ * Postconditions:
+ * - Returns 0 if the test passes (output file equals oracle)
+ * - Returns 1 if the test fails
+ *
+ * Side Effects:
+ * - Creates the file "tc_24_output.txt"
+ * - Allocates and deallocates memory for the activity container
+ */
+int tc_24() {
+	int numActivities = 0;
+	ActivitiesContainer container = readActivitiesFromFile("tc_24.txt", &numActivities);
+	setActivityUsedTime(getActivityWithId(container, 1), 7200);
+	int saveResult = saveActivitiesToFile("tc_24_output.txt", container);
+	setActivityUsedTime(getActivityWithId(container, 1), 1800);
+	saveResult += saveActivitiesToFile("tc_24_output.txt", container);
+	int missingDirectoryResult = saveActivitiesToFile("tc_24_missing/tc_24_output.txt", container);
+	deleteActivityContainer(container);
+	
+	char tempFilename[64];
+	snprintf(tempFilename, sizeof(tempFilename), "tc_24_output.txt" ACTIVITY_WRITER_TEMP_EXTENSION "%ld", (long)getpid());
+	FILE* tempFile = fopen(tempFilename, "r");
+	if (tempFile != NULL) {
+		fclose(tempFile);
+		return 1;
+	}
+	
+	if (saveResult != 0 || missingDirectoryResult != 1) return 1;
+	int compareResult = compareFiles("tc_24_output.txt", "tc_24_oracle.txt");
+	return (compareResult == 0) ? 0 : 1;
+}
+
+
+/*
+ * tc_25
+ *
+ * Syntactic Specification:
+ * int tc_25();
+ *
+ * Semantic Specification:
+ * Test case 25: reads a file leaving the descriptions in it ('readActivitiesFromFileWithLazyDescr()'),
+ * replaces the file with a save that changes a description, then changes another description and saves
+ * the activities again: the descriptions not yet read must still be read from the replaced file.
+ *
+ * Preconditions:
+ * - The file "tc_25.txt" must exist and be accessible
+ * - The file "tc_25_oracle.txt" must exist for comparison
+ *
+ * Postconditions:
+ * - Returns 0 if the test passes (output file equals oracle)
+ * - Returns 1 if the test fails
+ *
+ * Side Effects:
+ * - Creates the file "tc_25_output.txt"
+ * - Allocates and deallocates memory for the activity containers
+ */
+int tc_25() {
+	int numActivities = 0;
+	ActivitiesContainer eagerContainer = readActivitiesFromFile("tc_25.txt", &numActivities);
+	int saveResult = saveActivitiesToFile("tc_25_output.txt", eagerContainer);
+	
+	ActivitiesContainer container = readActivitiesFromFileWithLazyDescr("tc_25_output.txt", &numActivities);
+	setActivityDescr(getActivityWithId(eagerContainer, 1), "Descrizione sostituita");
+	saveResult += saveActivitiesToFile("tc_25_output.txt", eagerContainer);
+	deleteActivityContainer(eagerContainer);
+	
+	setActivityDescr(getActivityWithId(container, 3), "Descrizione modificata");
+	saveResult += saveActivitiesToFile("tc_25_output.txt", container);
+	deleteActivityContainer(container);
+	
+	if (saveResult != 0) return 1;
+	int compareResult = compareFiles("tc_25_output.txt", "tc_25_oracle.txt");
+	return (compareResult == 0) ? 0 : 1;
+}
+
+
+/*
+ * tc_26
+ *
+ * Syntactic Specification:
+ * int tc_26();
+ *
+ * Semantic Specification:
+ * Test case 26: saves the activities of a file in the compact archive format, reads the archive back
+ * and saves it in the text format; also checks that the archive is smaller than the text file and
+ * that a file that is not an archive is refused.
+ *
+ * Preconditions:
+ * - The file "tc_26.txt" must exist and be accessible
+ * - The file "tc_26_oracle.txt" must exist for comparison
+ *
+ * Postconditions:
+ * - Returns 0 if the test passes (output file equals oracle)
+ * - Returns 1 if the test fails
+ *
+ * Side Effects:
+ * - Creates the files "tc_26_output.arc" and "tc_26_output.txt"
+ * - Allocates and deallocates memory for the activity containers
+ */
+int tc_26() {
+	int numActivities = 0;
+	ActivitiesContainer container = readActivitiesFromFile("tc_26.txt", &numActivities);
+	int saveResult = saveActivitiesToArchiveFile("tc_26_output.arc", container);
+	deleteActivityContainer(container);
+	
+	container = readActivitiesFromArchiveFile("tc_26_output.arc", &numActivities);
+	saveResult += saveActivitiesToFile("tc_26_output.txt", container);
+	deleteActivityContainer(container);
+	if (saveResult != 0 || numActivities != 7) return 1;
+	
+	int notArchiveCount = -1;
+	container = readActivitiesFromArchiveFile("tc_26.txt", &notArchiveCount);
+	deleteActivityContainer(container);
+	if (notArchiveCount != 0) return 1;
+	
+	struct stat archiveInfo;
+	struct stat textInfo;
+	if (stat("tc_26_output.arc", &archiveInfo) != 0 || stat("tc_26_output.txt", &textInfo) != 0 ||
+		 archiveInfo.st_size >= textInfo.st_size) {
+		return 1;
+	}
+	
+	int compareResult = compareFiles("tc_26_output.txt", "tc_26_oracle.txt");
+	return (compareResult == 0) ? 0 : 1;
+}
+
+
+/*
+ * tc_27
+ *
+ * Syntactic Specification:
+ * int tc_27();
+ *
+ * Semantic Specification:
+ * Test case 27: exports the activities of a file as CSV and as JSON Lines, after setting strings that
+ * need escaping (commas, double quotes, line ends, tabs, backslashes) and a NULL course.
+ *
+ * Preconditions:
+ * - The file "tc_27.txt" must exist and be accessible
+ * - The files "tc_27_oracle.csv" and "tc_27_oracle.jsonl" must exist for comparison
+ *
+ * Postconditions:
+ * - Returns 0 if the test passes (output files equal oracles)
+ * - Returns 1 if the test fails
+ *
+ * Side Effects:
+ * - Creates the files "tc_27_output.csv" and "tc_27_output.jsonl"
+ * - Allocates and deallocates memory for the activity container
+ */
+int tc_27() {
+	int numActivities = 0;
+	ActivitiesContainer container = readActivitiesFromFile("tc_27.txt", &numActivities);
+	setActivityName(getActivityWithId(container, 1), "Prima, con \"virgolette\"");
+	setActivityDescr(getActivityWithId(container, 3), "Riga 1\nRiga 2\tcon \\ e \x01");
+	setActivityCourse(getActivityWithId(container, 5), NULL);
+	int exportResult = exportActivitiesToCsv("tc_27_output.csv", container);
+	exportResult += exportActivitiesToJsonl("tc_27_output.jsonl", container);
+	deleteActivityContainer(container);
+	
+	if (exportResult != 0) return 1;
+	int compareResult = compareFiles("tc_27_output.csv", "tc_27_oracle.csv");
+	compareResult += compareFiles("tc_27_output.jsonl", "tc_27_oracle.jsonl");
+	return (compareResult == 0) ? 0 : 1;
+}
+
+
+/*
+ * tc_28
+ *
+ * Syntactic Specification:
+ * int tc_28();
+ *
+ * Semantic Specification:
+ * Test case 28: imports into the activities of a file a CSV file with its own column names (a multi-line
+ * quoted field, an id already taken, an id repeated, rows without an id or not valid) and then a JSON Lines
+ * file with the export keys (\u escapes, null, unknown keys, a nested object), and saves the result.
+ *
+ * Preconditions:
+ * - The files "tc_28.txt", "tc_28_import.csv" and "tc_28_import.jsonl" must exist and be accessible
+ * - The file "tc_28_oracle.txt" must exist for comparison
+ *
+ * Postconditions:
+ * - Returns 0 if the test passes (output file equals oracle)
+ * - Returns 1 if the test fails
+ *
+ * Side Effects:
+ * - Creates the file "tc_28_output.txt"
+ * - Allocates and deallocates memory for the activity container and the column mappings
+ */
+int tc_28() {
+	int numActivities = 0;
+	ActivitiesContainer container = readActivitiesFromFile("tc_28.txt", &numActivities);
+	
+	ActivityImportMapping mapping = newActivityImportMapping();
+	int importResult = parseActivityImportMapping(mapping, "titolo=Nome,corso=Insegnamento,descrizione=Note");
+	int csvCount = 0;
+	importResult += importActivitiesFromFile(container, "tc_28_import.csv", ACTIVITY_IMPORT_CSV, mapping, &csvCount);
+	deleteActivityImportMapping(&mapping);
+	
+	mapping = newActivityImportMapping();
+	int jsonlCount = 0;
+	importResult += importActivitiesFromFile(container, "tc_28_import.jsonl", ACTIVITY_IMPORT_JSONL, mapping, &jsonlCount);
+	deleteActivityImportMapping(&mapping);
+	
+	int saveResult = saveActivitiesToFile("tc_28_output.txt", container);
+	deleteActivityContainer(container);
+	if (importResult != 0 || saveResult != 0 || csvCount != 2 || jsonlCount != 2) return 1;
+	
+	int compareResult = compareFiles("tc_28_output.txt", "tc_28_oracle.txt");
+	return (compareResult == 0) ? 0 : 1;
+}
+
+
+/*
+ * tc_29
+ *
+ * Syntactic Specification:
+ * int tc_29();
+ *
+ * Semantic Specification:
+ * Test case 29: saves the activities of a file as a slotted store, then modifies an activity in place,
+ * makes the description of another one longer than its slots, removes one and inserts a new one, and saves
+ * again: the store must be updated in place (same file, not replaced). The store is read back and saved as text.
+ *
+ * Preconditions:
+ * - The file "tc_29.txt" must exist and be accessible
+ * - The file "tc_29_oracle.txt" must exist for comparison
+ *
+ * Postconditions:
+ * - Returns 0 if the test passes (store updated in place and output file equals oracle)
+ * - Returns 1 if the test fails
+ *
+ * Side Effects:
+ * - Creates the files "tc_29_output.slt" and "tc_29_output.txt"
+ * - Allocates and deallocates memory for the activity containers
+ */
+int tc_29() {
+	int numActivities = 0;
+	ActivitiesContainer container = readActivitiesFromFile("tc_29.txt", &numActivities);
+	int saveResult = saveActivitiesToStoreFile("tc_29_output.slt", container);
+	
+	struct stat firstInfo;
+	struct stat secondInfo;
+	int statResult = stat("tc_29_output.slt", &firstInfo);
+	
+	setActivityUsedTime(getActivityWithId(container, 3), 4500);
+	setActivityDescr(getActivityWithId(container, 5), "Una descrizione molto più lunga della precedente, che non entra più negli slot del suo record");
+	removeActivity(container, 7);
+	insertActivity(container, newActivity(0, "Nuova activity", NULL, "Basi di dati", 1746613562, 1748600762, 0, 3600, 0, 2));
+	saveResult += saveActivitiesToStoreFile("tc_29_output.slt", container);
+	statResult += stat("tc_29_output.slt", &secondInfo);
+	deleteActivityContainer(container);
+	
+	container = readActivitiesFromStoreFile("tc_29_output.slt", &numActivities);
+	saveResult += saveActivitiesToFile("tc_29_output.txt", container);
+	deleteActivityContainer(container);
+	if (saveResult != 0 || statResult != 0 || firstInfo.st_ino != secondInfo.st_ino || numActivities != 7) return 1;
+	
+	int compareResult = compareFiles("tc_29_output.txt", "tc_29_oracle.txt");
+	return (compareResult == 0) ? 0 : 1;
+}
+
+
+/*
+ * tc_30
+ *
+ * Syntactic Specification:
+ * int tc_30();
+ *
+ * Semantic Specification:
+ * Test case 30: saves the activities of a file, with two more in the next ranges of ids, as a sharded
+ * directory (three shards), then modifies the activity of the second shard and removes the one of the
+ * third, saving after each change: only the second shard must be rewritten (its file replaced, the one
+ * of the first shard kept) and the third one removed. The directory is read back and saved as text.
+ *
+ * Preconditions:
+ * - The file "tc_30.txt" must exist and be accessible
+ * - The file "tc_30_oracle.txt" must exist for comparison
+ *
+ * Postconditions:
+ * - Returns 0 if the test passes (only the modified shards written and output file equals oracle)
+ * - Returns 1 if the test fails
+ *
+ * Side Effects:
+ * - Creates the directory "tc_30_output.shards" and the file "tc_30_output.txt"
+ * - Allocates and deallocates memory for the activity containers
+ */
+int tc_30() {
+	int numActivities = 0;
+	ActivitiesContainer container = readActivitiesFromFile("tc_30.txt", &numActivities);
+	insertActivity(container, newActivity(ACTIVITY_SHARD_ID_RANGE + 1, "Activity del secondo blocco", "Nel secondo intervallo di id", "Basi di dati", 1746613562, 1748600762, 0, 3600, 0, 2));
+	insertActivity(container, newActivity(2 * ACTIVITY_SHARD_ID_RANGE + 1, "Activity del terzo blocco", NULL, "Basi di dati", 1746613562, 1748600762, 0, 1800, 0, 3));
+	int saveResult = saveActivitiesToShardsDirectory("tc_30_output.shards", container);
+	
+	struct stat firstShard[3];
+	struct stat secondShard[3];
+	int statResult = stat("tc_30_output.shards/shard_0.bin", &firstShard[0]) + stat("tc_30_output.shards/shard_1.bin", &secondShard[0]);
+	
+	setActivityUsedTime(getActivityWithId(container, ACTIVITY_SHARD_ID_RANGE + 1), 1200);
+	saveResult += saveActivitiesToShardsDirectory("tc_30_output.shards", container);
+	statResult += stat("tc_30_output.shards/shard_0.bin", &firstShard[1]) + stat("tc_30_output.shards/shard_1.bin", &secondShard[1]);
+	
+	removeActivity(container, 2 * ACTIVITY_SHARD_ID_RANGE + 1);
+	saveResult += saveActivitiesToShardsDirectory("tc_30_output.shards", container);
+	statResult += stat("tc_30_output.shards/shard_0.bin", &firstShard[2]) + stat("tc_30_output.shards/shard_1.bin", &secondShard[2]);
+	int isThirdRemoved = (access("tc_30_output.shards/shard_2.bin", F_OK) != 0);
+	deleteActivityContainer(container);
+	
+	container = readActivitiesFromShardsDirectory("tc_30_output.shards", &numActivities);
+	saveResult += saveActivitiesToFile("tc_30_output.txt", container);
+	deleteActivityContainer(container);
+	if (saveResult != 0 || statResult != 0 || numActivities != 8 || !isThirdRemoved) return 1;
+	if (firstShard[0].st_ino != firstShard[1].st_ino || firstShard[1].st_ino != firstShard[2].st_ino ||
+		 secondShard[0].st_ino == secondShard[1].st_ino || secondShard[1].st_ino != secondShard[2].st_ino) return 1;
+	
+	int compareResult = compareFiles("tc_30_output.txt", "tc_30_oracle.txt");
+	return (compareResult == 0) ? 0 : 1;
+}
+
+/*
+ * tc_31
+ *
+ * Syntactic Specification:
+ * int tc_31();
+ *
+ * Semantic Specification:
+ * Test case 31: checks the CRC32C of "123456789" with both implementations, then saves the activities of
+ * a file as a slotted store and verifies it against its checksum file, again after an activity has been
+ * modified and saved in place. Then a byte of the store is changed: the verification must report it.
+ * The activities are also saved as text, verified and compared with the oracle.
+ *
+ * Preconditions:
+ * - The file "tc_31.txt" must exist and be accessible
+ * - The file "tc_31_oracle.txt" must exist for comparison
+ *
+ * Postconditions:
+ * - Returns 0 if the test passes (intact files verified, damaged one reported and output file equals oracle)
+ * - Returns 1 if the test fails
+ *
+ * Side Effects:
+ * - Creates the files "tc_31_output.slt" and "tc_31_output.txt" with their checksum files
+ * - Allocates and deallocates memory for the activity container
+ */
+int tc_31() {
+	if (computeCrc32c(0, "123456789", 9) != 0xE3069283u || computeCrc32cSoftware(0, "123456789", 9) != 0xE3069283u) return 1;
+	
+	int numActivities = 0;
+	ActivitiesContainer container = readActivitiesFromFile("tc_31.txt", &numActivities);
+	int saveResult = saveActivitiesToStoreFile("tc_31_output.slt", container);
+	int verifyResult = verifyActivitiesFile("tc_31_output.slt", ACTIVITIES_FORMAT_STORE);
+	
+	setActivityUsedTime(getActivityWithId(container, 3), 2400);
+	saveResult += saveActivitiesToStoreFile("tc_31_output.slt", container);
+	verifyResult += verifyActivitiesFile("tc_31_output.slt", ACTIVITIES_FORMAT_STORE);
+	
+	saveResult += saveActivitiesToFile("tc_31_output.txt", container);
+	verifyResult += verifyActivitiesFile("tc_31_output.txt", ACTIVITIES_FORMAT_TEXT);
+	deleteActivityContainer(container);
+	
+	// a byte of the last record changed behind the back of the store
+	FILE* file = fopen("tc_31_output.slt", "r+b");
+	if (file == NULL) return 1;
+	fseek(file, -8, SEEK_END);
+	int byte = fgetc(file);
+	fseek(file, -8, SEEK_END);
+	fputc(byte ^ 0x5A, file);
+	fclose(file);
+	int damagedResult = verifyActivitiesFile("tc_31_output.slt", ACTIVITIES_FORMAT_STORE);
+	
+	if (saveResult != 0 || verifyResult != 0 || damagedResult != 1 || numActivities != 7) return 1;
+	
+	int compareResult = compareFiles("tc_31_output.txt", "tc_31_oracle.txt");
+	return (compareResult == 0) ? 0 : 1;
+}
+
+
+/*
+ * tc_32
+ *
+ * Syntactic Specification:
+ * int tc_32();
+ *
+ * Semantic Specification:
+ * Test case 32: saves the activities of a file as a mapped store, then modifies one activity, removes one,
+ * inserts a new one and saves again: the store must be updated in the same file (same inode) with only
+ * those three activities written. The store is opened on its own (count from the header, lookup of an
+ * id, a removed id not found) and verified against its checksum file, then read back into a container,
+ * saved as text and compared with the oracle.
+ *
+ * Preconditions:
+ * - The file "tc_32.txt" must exist and be accessible
+ * - The file "tc_32_oracle.txt" must exist for comparison
+ *
+ * Postconditions:
+ * - Returns 0 if the test passes (store updated in place, opened, verified and output file equals oracle)
+ * - Returns 1 if the test fails
+ *
+ * Side Effects:
+ * - Creates the files "tc_32_output.map" and "tc_32_output.txt" with their checksum files
+ * - Allocates and deallocates memory for the activity container
+ */
+int tc_32() {
+	int numActivities = 0;
+	ActivitiesContainer container = readActivitiesFromFile("tc_32.txt", &numActivities);
+	int saveResult = saveActivitiesToMapFile("tc_32_output.map", container);
+	struct stat before;
+	if (stat("tc_32_output.map", &before) != 0) saveResult = 1;
+	
+	setActivityUsedTime(getActivityWithId(container, 3), 2400);
+	removeActivity(container, 8);
+	insertActivity(container, newActivity(0, "Attività mappata", "Aggiunta dopo il primo salvataggio", "Basi di dati", 1746613562, 1748600762, 0, 3600, 0, 2));
+	saveResult += saveActivitiesToMapFile("tc_32_output.map", container);
+	deleteActivityContainer(container);
+	struct stat after;
+	if (stat("tc_32_output.map", &after) != 0 || after.st_ino != before.st_ino) saveResult = 1;
+	
+	ActivityMap map = openActivityMap("tc_32_output.map");
+	Activity modified = getActivityFromMap(map, 3);
+	Activity removed = getActivityFromMap(map, 8);
+	int mapResult = (map == NULL || getActivityMapCount(map) != 7 || modified == NULL || getActivityUsedTime(modified) != 2400 || removed != NULL);
+	deleteActivity(modified);
+	deleteActivity(removed);
+	deleteActivityMap(&map);
+	int verifyResult = verifyActivitiesFile("tc_32_output.map", ACTIVITIES_FORMAT_MAPPED);
+	
+	int readCount = 0;
+	container = readActivitiesFromMapFile("tc_32_output.map", &readCount);
+	saveResult += saveActivitiesToFile("tc_32_output.txt", container);
+	deleteActivityContainer(container);
+	
+	if (saveResult != 0 || mapResult != 0 || verifyResult != 0 || numActivities != 7 || readCount != 7) return 1;
+	
+	int compareResult = compareFiles("tc_32_output.txt", "tc_32_oracle.txt");
+	return (compareResult == 0) ? 0 : 1;
+}
+
+
+/*
+ * tc_33
+ *
+ * Syntactic Specification:
+ * int tc_33();
+ *
+ * Semantic Specification:
+ * Test case 33: prints the list of the activities twice (the second time from the cache), then renames an
+ * activity through its setter and prints the list again: the cached rendering must not be printed. Then an
+ * activity with an id already in the container is inserted (so it's rejected) and modified through its
+ * setters: the contained activity with that id must stay in the sorted listing, the journal must not
+ * record the change (the base file with the journal replayed is printed too). Everything is printed to
+ * stdout, redirected to the output file.
+ *
+ * Preconditions:
+ * - The file "tc_33.txt" must exist and be accessible
+ * - The file "tc_33_oracle.txt" must exist for comparison
+ *
+ * Postconditions:
+ * - Returns 0 if the test passes (renderings updated, duplicate ignored and output file equals oracle)
+ * - Returns 1 if the test fails
+ *
+ * Side Effects:
+ * - Creates the files "tc_33_output.txt" and "tc_33_output_live.txt" with its journal
+ * - Allocates and deallocates memory for the activity container
+ */
+int tc_33() {
+	int numActivities = 0;
+	ActivitiesContainer container = readActivitiesFromFile("tc_33.txt", &numActivities);
+	saveActivitiesToFile("tc_33_output_live.txt", container);
+	remove("tc_33_output_live.txt" ACTIVITY_JOURNAL_EXTENSION);
+	int journalResult = openActivitiesJournal(container, "tc_33_output_live.txt");
+	
+	int savedFd = redirectStdoutToFile("tc_33_output.txt");
+	if (savedFd < 0) {
+		deleteActivityContainer(container);
+		return 1;
+	}
+	printActivities(container);
+	printActivities(container);
+	setActivityName(getActivityWithId(container, 3), "Seconda activity rinominata");
+	printActivities(container);
+	
+	Activity duplicate = newActivity(5, "Duplicata", NULL, "Nessun corso", 1746613562, 1748600762, 0, 60, 0, 1);
+	insertActivity(container, duplicate);
+	setActivityPriority(duplicate, 3);
+	setActivityName(duplicate, "Duplicata modificata");
+	printActivitiesSorted(container, 1);
+	int duplicateResult = (getActivityWithId(container, 5) == duplicate);
+	deleteActivity(duplicate);
+	deleteActivityContainer(container);
+	
+	// the journal replayed on the base file has the rename of activity 3 only
+	container = readActivitiesFromFile("tc_33_output_live.txt", &numActivities);
+	journalResult += openActivitiesJournal(container, "tc_33_output_live.txt");
+	printActivitiesToFile(container, stdout);
+	deleteActivityContainer(container);
+	restoreStdout(savedFd);
+	
+	if (journalResult != 0 || duplicateResult != 0 || numActivities != 7) return 1;
+	
+	int compareResult = compareFiles("tc_33_output.txt", "tc_33_oracle.txt");
+	return (compareResult == 0) ? 0 : 1;
+}
+
+
+/*
+ * "struct referenceItem" Documentation
+ *
+ * Syntactic Specification:
+ * typedef struct referenceItem {
+ *     Activity activity;
+ *     int position;
+ * } ReferenceItem;
+ *
+ * Semantic Specification:
+ * An activity with its position before the sort, to compute the reference orders of tc_34 with qsort().
+ */
+typedef struct referenceItem {
+	Activity activity;
+	int position;
+} ReferenceItem;
+
+// Criterion of the reference order being computed by qsort() (see 'compareReferenceItemsStable()')
+int referenceSortBy = 0;
+
+/*
+ * compareReferenceItemsStable
+ *
+ * Syntactic Specification:
+ * int compareReferenceItemsStable(const void* a, const void* b);
+ *
+ * Semantic Specification:
+ * Comparator for qsort(): orders by 'referenceSortBy', the ties by position before the sort (the order of a
+ * stable sort).
+ *
+ * Preconditions:
+ * - 'a' and 'b' point to valid ReferenceItem
+ *
+ * Postconditions:
+ * - Returns a negative value, 0 or a positive value if 'a' comes before, together or after 'b'
+ *
+ * Side Effects:
+ * - None
+ */
+int compareReferenceItemsStable(const void* a, const void* b) {
+	const ReferenceItem* itemA = (const ReferenceItem*)a;
+	const ReferenceItem* itemB = (const ReferenceItem*)b;
+	int cmp = compareActivityBy(itemA->activity, itemB->activity, referenceSortBy);
+	return (cmp != 0) ? cmp : itemA->position - itemB->position;
+}
+
+/*
+ * compareReferenceItemsById
+ *
+ * Syntactic Specification:
+ * int compareReferenceItemsById(const void* a, const void* b);
+ *
+ * Semantic Specification:
+ * Comparator for qsort(): orders by 'referenceSortBy', the ties by id (the order of 'sortSupportVectorByKey()').
+ *
+ * Preconditions:
+ * - 'a' and 'b' point to valid ReferenceItem
+ *
+ * Postconditions:
+ * - Returns a negative value, 0 or a positive value if 'a' comes before, together or after 'b'
+ *
+ * Side Effects:
+ * - None
+ */
+int compareReferenceItemsById(const void* a, const void* b) {
+	const ReferenceItem* itemA = (const ReferenceItem*)a;
+	const ReferenceItem* itemB = (const ReferenceItem*)b;
+	int cmp = compareActivityBy(itemA->activity, itemB->activity, referenceSortBy);
+	return (cmp != 0) ? cmp : compareActivityById(itemA->activity, itemB->activity);
+}
+
+/*
+ * checkSortedVector
+ *
+ * Syntactic Specification:
+ * int checkSortedVector(ActivitiesContainerSupportVector vector, ReferenceItem* reference, int count);
+ *
+ * Semantic Specification:
+ * Checks that a sorted support vector has the activities of the reference, in the same order.
+ *
+ * Preconditions:
+ * - 'reference' has 'count' items
+ *
+ * Postconditions:
+ * - Returns 0 if the orders are the same, 1 otherwise
+ *
+ * Side Effects:
+ * - None
+ */
+int checkSortedVector(ActivitiesContainerSupportVector vector, ReferenceItem* reference, int count) {
+	if (getSupportVectorSize(vector) != count) return 1;
+	
+	for (int i = 0; i < count; i++) {
+		if (getActivityFromSupportVector(vector, i) != reference[i].activity) return 1;
+	}
+	return 0;
+}
+
+/*
+ * checkSortedList
+ *
+ * Syntactic Specification:
+ * int checkSortedList(ActivitiesContainerSupportList list, ReferenceItem* reference, int count);
+ *
+ * Semantic Specification:
+ * Checks that a sorted support list has the activities of the reference, in the same order: the list has
+ * no accessors, so both are printed (with their ids) to memory and compared.
+ *
+ * Preconditions:
+ * - 'reference' has 'count' items
+ *
+ * Postconditions:
+ * - Returns 0 if the orders are the same, 1 otherwise (or if memory allocation fails)
+ *
+ * Side Effects:
+ * - Allocates and deallocates memory
+ */
+int checkSortedList(ActivitiesContainerSupportList list, ReferenceItem* reference, int count) {
+	char* listText = NULL;
+	size_t listSize = 0;
+	FILE* listStream = open_memstream(&listText, &listSize);
+	char* referenceText = NULL;
+	size_t referenceSize = 0;
+	FILE* referenceStream = open_memstream(&referenceText, &referenceSize);
+	ActivitiesContainerSupportVector referenceVector = newSupportVector();
+	if (listStream == NULL || referenceStream == NULL || referenceVector == NULL) {
+		if (listStream != NULL) fclose(listStream);
+		if (referenceStream != NULL) fclose(referenceStream);
+		free(listText);
+		free(referenceText);
+		deleteSupportVector(&referenceVector);
+		return 1;
+	}
+	
+	for (int i = 0; i < count; i++) addActivityToSupportVector(referenceVector, reference[i].activity);
+	printActivitiesInSupportList(list, 0, listStream);
+	printActivitiesInSupportVector(referenceVector, 0, referenceStream);
+	fclose(listStream);
+	fclose(referenceStream);
+	
+	int result = (listSize == referenceSize && memcmp(listText, referenceText, listSize) == 0) ? 0 : 1;
+	free(listText);
+	free(referenceText);
+	deleteSupportVector(&referenceVector);
+	return result;
+}
+
+/*
+ * tc_34
+ *
+ * Syntactic Specification:
+ * int tc_34();
+ *
+ * Semantic Specification:
+ * Test case 34: generates activities with many ties (names differing only in case, shared dates, times and
+ * priorities, empty dates and descriptions), in an order that is not the id order, and sorts them by every
+ * criterion through every sort entry point: the support list (bottom-up merge sort and parallel sort), the
+ * support vector (stable merge sort, introsort, keyed sort and parallel merge path sort). The sizes cover
+ * the qsort and radix sort paths of the keyed sort (from a shuffled order and from the id order) and, above SUPPORT_PARALLEL_SORT_THRESHOLD, the parallel
+ * sorts on 4 threads. Every order is compared with a reference computed by qsort(): the stable sorts must keep
+ * the ties in their previous order (the list ones in reverse order, like the original recursive merge sort),
+ * the keyed sort must order them by id, the introsort must be sorted.
+ *
+ * Preconditions:
+ * - None
+ *
+ * Postconditions:
+ * - Returns 0 if every sort gives the reference order
+ * - Returns 1 if the test fails
+ *
+ * Side Effects:
+ * - Allocates and deallocates memory, creates and joins threads
+ */
+int tc_34() {
+	static char* names[] = { "Progetto", "progetto", "Esame", "esame", "Relazione", "Laboratorio" };
+	static char* courses[] = { "Analisi I", "analisi i", "Fisica", "PSD", "Basi di dati" };
+	const int sizes[] = { 100, 600, SUPPORT_PARALLEL_SORT_THRESHOLD + 1000 };
+	const int maxCount = sizes[2];
+	
+	Activity* activities = malloc(maxCount * sizeof(Activity));
+	ReferenceItem* reference = malloc(maxCount * sizeof(ReferenceItem));
+	if (activities == NULL || reference == NULL) {
+		free(activities);
+		free(reference);
+		return 1;
+	}
+	
+	// ids from 1 to maxCount in a shuffled order
+	srand(34);
+	for (int i = 0; i < maxCount; i++) {
+		char descr[32];
+		snprintf(descr, sizeof(descr), "Descrizione %d", rand() % 50);
+		time_t expiryDate = (rand() % 8 == 0) ? 0 : 1748000000 + (rand() % 40) * 86400;
+		time_t completionDate = (rand() % 4 == 0) ? 1747000000 + (rand() % 30) * 86400 : 0;
+		activities[i] = newActivity(i + 1, names[rand() % 6], (rand() % 10 == 0) ? NULL : descr, courses[rand() % 5],
+									1746000000 + (rand() % 50) * 86400, expiryDate, completionDate,
+									(rand() % 10) * 600, (rand() % 8) * 600, 1 + rand() % 3);
+	}
+	for (int i = maxCount - 1; i > 0; i--) {
+		int j = rand() % (i + 1);
+		Activity swap = activities[i];
+		activities[i] = activities[j];
+		activities[j] = swap;
+	}
+	
+	int failures = 0;
+	for (int s = 0; s < 3; s++) {
+		int count = sizes[s];
+		for (int sortBy = 0; sortBy < ACTIVITY_SORT_CRITERIA_COUNT; sortBy++) {
+			referenceSortBy = sortBy;
+			for (int i = 0; i < count; i++) reference[i].activity = activities[i];
+			
+			// support list: head insertion, so the activities are added from the last one. The list merge sort
+			// puts the ties in reverse list order (the later activity first)
+			for (int i = 0; i < count; i++) reference[i].position = count - 1 - i;
+			qsort(reference, count, sizeof(ReferenceItem), compareReferenceItemsStable);
+			for (int parallel = 0; parallel <= 1; parallel++) {
+				ActivitiesContainerSupportList list = newSupportList();
+				for (int i = count - 1; i >= 0; i--) addActivityToSupportList(list, activities[i]);
+				if (parallel) sortSupportListParallel(list, sortBy, 4);
+				else sortSupportList(list, sortBy);
+				failures += checkSortedList(list, reference, count);
+				deleteSupportList(&list);
+			}
+			
+			for (int i = 0; i < count; i++) {
+				reference[i].activity = activities[i];
+				reference[i].position = i;
+			}
+			qsort(reference, count, sizeof(ReferenceItem), compareReferenceItemsStable);
+			
+			// support vector: stable, parallel, unstable and keyed sorts (the last one also from the id order)
+			for (int entryPoint = 0; entryPoint < 5; entryPoint++) {
+				ActivitiesContainerSupportVector vector = newSupportVector();
+				for (int i = 0; i < count; i++) addActivityToSupportVector(vector, activities[i]);
+				switch (entryPoint) {
+					case 0:	sortSupportVector(vector, sortBy);
+								failures += checkSortedVector(vector, reference, count);
+								break;
+					case 1:	sortSupportVectorParallel(vector, sortBy, 4);
+								failures += checkSortedVector(vector, reference, count);
+								break;
+					case 2:	sortSupportVectorUnstable(vector, sortBy);
+								for (int i = 1; i < count; i++) {
+									if (compareActivityBy(getActivityFromSupportVector(vector, i - 1), getActivityFromSupportVector(vector, i), sortBy) > 0) {
+										failures++;
+										break;
+									}
+								}
+								// every id once
+								long long idSum = 0;
+								for (int i = 0; i < count; i++) idSum += getActivityId(getActivityFromSupportVector(vector, i));
+								long long expectedSum = 0;
+								for (int i = 0; i < count; i++) expectedSum += getActivityId(activities[i]);
+								if (getSupportVectorSize(vector) != count || idSum != expectedSum) failures++;
+								break;
+					default:	if (entryPoint == 4) sortSupportVectorByKey(vector, 0);
+								sortSupportVectorByKey(vector, sortBy);
+								if (hasActivityNumericSortKey(sortBy) == 1 || entryPoint == 4) {
+									// keyed sort (or stable sort from the id order): ties by id
+									ReferenceItem* byId = malloc(count * sizeof(ReferenceItem));
+									if (byId == NULL) {
+										failures++;
+										break;
+									}
+									memcpy(byId, reference, count * sizeof(ReferenceItem));
+									qsort(byId, count, sizeof(ReferenceItem), compareReferenceItemsById);
+									failures += checkSortedVector(vector, byId, count);
+									free(byId);
+								} else {
+									failures += checkSortedVector(vector, reference, count);
+								}
+								break;
+				}
+				deleteSupportVector(&vector);
+			}
+			
+			if (failures != 0) {
+				printf("TC_34: ordine errato con %d attività per il criterio %d.\n", count, sortBy);
+				s = 3;
+				break;
+			}
+		}
+	}
+	
+	for (int i = 0; i < maxCount; i++) deleteActivity(activities[i]);
+	free(activities);
+	free(reference);
+	return (failures == 0) ? 0 : 1;
+}
+
+
+/*
+ * tc_35
+ *
+ * Syntactic Specification:
+ * int tc_35();
+ *
+ * Semantic Specification:
+ * Test case 35: loads activities whose insert, expiry and completion dates are not in id order (with a tie on
+ * the insert date) and prints them sorted by each of the three dates (sorted views), then prints the report,
+ * whose completed, expired and yet to begin sections are sorted by completion, expiry and insert date.
+ *
+ * Preconditions:
+ * - The file "tc_35.txt" must exist and be accessible
+ * - The file "tc_35_oracle.txt" must exist for comparison
+ *
+ * Postconditions:
+ * - Returns 0 if the test passes
+ * - Returns 1 if the test fails
+ *
+ * Side Effects:
+ * - Creates the file "tc_35_output.txt"
+ * - Allocates and deallocates memory for the container
+ * - Opens and closes files for writing
+ */
+int tc_35() {
+	int numActivities = 0;
+	ActivitiesContainer container = readActivitiesFromFile("tc_35.txt", &numActivities);
+	FILE* file = fopen("tc_35_output.txt", "w");
+	if (file == NULL) return 1; //KO
+	int printResult = printActivitiesSortedToFile(container, 4, file);
+	printResult += printActivitiesSortedToFile(container, 5, file);
+	printResult += printActivitiesSortedToFile(container, 6, file);
+	fprintf(file, "\n");
+	printActivitiesReportToFile(container, 1746400000, file);
+	fclose(file);
+	deleteActivityContainer(container);
+	if (printResult != 0) return 1; //KO
+	int compareResult = compareFiles("tc_35_output.txt", "tc_35_oracle.txt");
+	return (compareResult == 0) ? 0 : 1;
+}
+
+
+/*
+ * tc_36
+ *
+ * Syntactic Specification:
+ * int tc_36();
+ *
+ * Semantic Specification:
+ * Test case 36: loads activities whose names, descriptions and courses differ in case and accents (with
+ * 'ß' and 'Æ' folded to two letters, and some identical names) and prints them sorted by name, description
+ * and course, which compares their collation keys; then renames two activities and sorts again by name,
+ * with the keys built again for the new names.
+ *
+ * Preconditions:
+ * - The file "tc_36.txt" must exist and be accessible
+ * - The file "tc_36_oracle.txt" must exist for comparison
+ *
+ * Postconditions:
+ * - Returns 0 if the test passes
+ * - Returns 1 if the test fails
+ *
+ * Side Effects:
+ * - Creates the file "tc_36_output.txt"
+ * - Allocates and deallocates memory for the container
+ * - Opens and closes files for writing
+ */
+int tc_36() {
+	int numActivities = 0;
+	ActivitiesContainer container = readActivitiesFromFile("tc_36.txt", &numActivities);
+	FILE* file = fopen("tc_36_output.txt", "w");
+	if (file == NULL) return 1; //KO
+	int printResult = printActivitiesSortedToFile(container, 1, file);
+	printResult += printActivitiesSortedToFile(container, 2, file);
+	printResult += printActivitiesSortedToFile(container, 3, file);
+	setActivityName(getActivityWithId(container, 10), "Zaino");
+	setActivityName(getActivityWithId(container, 4), "ésame");
+	fprintf(file, "\n");
+	printResult += printActivitiesSortedToFile(container, 1, file);
+	fclose(file);
+	deleteActivityContainer(container);
+	if (printResult != 0) return 1; //KO
+	int compareResult = compareFiles("tc_36_output.txt", "tc_36_oracle.txt");
+	return (compareResult == 0) ? 0 : 1;
+}
+
+
+/*
+ * tc_37
+ *
+ * Syntactic Specification:
+ * int tc_37();
+ *
+ * Semantic Specification:
+ * Test case 37: loads a file whose ids are not in order, with some ids repeated (the last record too),
+ * sequentially and then in parallel on 2, 3, 4 and 7 threads with small chunks, so that the chunks split
+ * the records and the tree is built from the activities sorted by id. Every parallel load must give the
+ * same activities (the first record of each id is kept) and the same next id (after the id of the last
+ * record) of the sequential one, which is printed.
+ *
+ * Preconditions:
+ * - The file "tc_37.txt" must exist and be accessible
+ * - The file "tc_37_oracle.txt" must exist for comparison
+ *
+ * Postconditions:
+ * - Returns 0 if the test passes
+ * - Returns 1 if the test fails
+ *
+ * Side Effects:
+ * - Creates the file "tc_37_output.txt"
+ * - Allocates and deallocates memory for the containers
+ * - Opens and closes files for writing, creates and joins threads
+ */
+int tc_37() {
+	const int threadCounts[] = { 2, 3, 4, 7 };
+	int numActivities = 0;
+	ActivitiesContainer sequential = readActivitiesFromFileInParallel("tc_37.txt", 1, 0, &numActivities);
+	char* sequentialText = NULL;
+	size_t sequentialSize = 0;
+	FILE* stream = open_memstream(&sequentialText, &sequentialSize);
+	if (stream == NULL) return 1; //KO
+	printActivitiesToFile(sequential, stream);
+	fclose(stream);
+	
+	FILE* file = fopen("tc_37_output.txt", "w");
+	if (file == NULL) return 1; //KO
+	fprintf(file, "%s", sequentialText);
+	fprintf(file, "Lette %d attività, prossimo id %d\n", numActivities, getNextId(sequential));
+	
+	for (int i = 0; i < 4; i++) {
+		int parallelCount = 0;
+		ActivitiesContainer parallel = readActivitiesFromFileInParallel("tc_37.txt", threadCounts[i], 256, &parallelCount);
+		char* parallelText = NULL;
+		size_t parallelSize = 0;
+		stream = open_memstream(&parallelText, &parallelSize);
+		if (stream != NULL) {
+			printActivitiesToFile(parallel, stream);
+			fclose(stream);
+		}
+		int isSame = (stream != NULL && parallelSize == sequentialSize && memcmp(parallelText, sequentialText, sequentialSize) == 0
+						&& parallelCount == numActivities && getNextId(parallel) == getNextId(sequential));
+		fprintf(file, "%d thread: %s\n", threadCounts[i], isSame ? "uguale al caricamento sequenziale" : "diverso dal caricamento sequenziale");
+		free(parallelText);
+		deleteActivityContainer(parallel);
+	}
+	
+	fclose(file);
+	free(sequentialText);
+	deleteActivityContainer(sequential);
+	int compareResult = compareFiles("tc_37_output.txt", "tc_37_oracle.txt");
+	return (compareResult == 0) ? 0 : 1;
+}
+
+
+/*
+ * tc_38
+ *
+ * Syntactic Specification:
+ * int tc_38();
+ *
+ * Semantic Specification:
+ * Test case 38: copies the activities of a file to a base file and to a mapped store, attaches their journals
+ * and modifies the containers (field updates, a removal, an insertion) without saving them, then exports
+ * both files as CSV: the exports must hold the modifications replayed from the journals.
+ *
+ * Preconditions:
+ * - The file "tc_38.txt" must exist and be accessible
+ * - The file "tc_38_oracle.csv" must exist for comparison
+ *
+ * Postconditions:
+ * - Returns 0 if the test passes (both exports equal the oracle)
+ * - Returns 1 if the test fails
+ *
+ * Side Effects:
+ * - Creates the files "tc_38_output.txt", "tc_38_output.map" with their checksum files and journals,
+ *   "tc_38_output.csv" and "tc_38_output_map.csv"
+ * - Allocates and deallocates memory for the activity containers
+ */
+int tc_38() {
+	int numActivities = 0;
+	ActivitiesContainer container = readActivitiesFromFile("tc_38.txt", &numActivities);
+	int saveResult = saveActivitiesToFile("tc_38_output.txt", container);
+	saveResult += saveActivitiesToMapFile("tc_38_output.map", container);
+	deleteActivityContainer(container);
+	remove("tc_38_output.txt" ACTIVITY_JOURNAL_EXTENSION);
+	remove("tc_38_output.map" ACTIVITY_JOURNAL_EXTENSION);
+	
+	const char* baseFilenames[] = { "tc_38_output.txt", "tc_38_output.map" };
+	int journalResult = 0;
+	for (int i = 0; i < 2; i++) {
+		container = (i == 0) ? readActivitiesFromFile(baseFilenames[i], &numActivities) : readActivitiesFromMapFile(baseFilenames[i], &numActivities);
+		journalResult += openActivitiesJournal(container, baseFilenames[i]);
+		setActivityPriority(getActivityWithId(container, 1), 3);
+		setActivityName(getActivityWithId(container, 5), "Attività rinominata");
+		removeActivity(container, 3);
+		Activity activity = newActivity(0, "Attività dal registro", "Inserita dopo il caricamento", "Fisica I",
+										1746612500, 1750413600, 0, 3000, 0, 1);
+		insertActivity(container, activity);
+		setActivityUsedTime(activity, 1200);
+		deleteActivityContainer(container);
+		if (!hasActivityJournalRecords(baseFilenames[i])) journalResult++;
+	}
+	
+	container = readActivitiesFromFile("tc_38_output.txt", &numActivities);
+	int exportResult = exportActivitiesWithJournal("tc_38_output.txt", container, "tc_38_output.csv", 0);
+	deleteActivityContainer(container);
+	exportResult += exportActivitiesFromMapFile("tc_38_output.map", "tc_38_output_map.csv", 0);
+	
+	if (saveResult != 0 || journalResult != 0 || exportResult != 0) return 1;
+	int compareResult = compareFiles("tc_38_output.csv", "tc_38_oracle.csv");
+	compareResult += compareFiles("tc_38_output_map.csv", "tc_38_oracle.csv");
+	return (compareResult == 0) ? 0 : 1;
+}
+
+
+/*
+ * tc_39
+ *
+ * Syntactic Specification:
+ * int tc_39();
+ *
+ * Semantic Specification:
+ * Test case 39: saves the activities of a file to a mapped store and opens it: the open must not create
+ * the activities nor build the tree, and the count, the next id, the listings and the CSV export must come
+ * from the mapped nodes, still without building it. A lookup then builds the tree: the same listings and
+ * export made from the tree must be equal, and a modification must be saved to the store in place.
+ *
+ * Preconditions:
+ * - The file "tc_39.txt" must exist and be accessible
+ * - The files "tc_39_oracle.txt" and "tc_39_oracle.csv" must exist for comparison
+ *
+ * Postconditions:
+ * - Returns 0 if the test passes (tree built only by the lookup, outputs from the store and the tree equal the oracles)
+ * - Returns 1 if the test fails
+ *
+ * Side Effects:
+ * - Creates the files "tc_39_output.map" with its checksum file, "tc_39_output.txt", "tc_39_output_tree.txt",
+ *   "tc_39_output.csv" and "tc_39_output_tree.csv"
+ * - Allocates and deallocates memory for the activity containers
+ */
+int tc_39() {
+	int numActivities = 0;
+	ActivitiesContainer container = readActivitiesFromFile("tc_39.txt", &numActivities);
+	int saveResult = saveActivitiesToMapFile("tc_39_output.map", container);
+	deleteActivityContainer(container);
+	
+	int mapCount = 0;
+	container = readActivitiesFromMapFile("tc_39_output.map", &mapCount);
+	int openResult = (mapCount != numActivities || getNextId(container) != 11 || hasActivityContainerTree(container));
+	
+	FILE* file = fopen("tc_39_output.txt", "w");
+	if (file == NULL) {
+		deleteActivityContainer(container);
+		return 1;
+	}
+	printActivitiesToFile(container, file);
+	printActivitiesProgressToFile(container, file);
+	fclose(file);
+	int exportResult = exportActivitiesToCsv("tc_39_output.csv", container);
+	if (hasActivityContainerTree(container)) openResult = 1;
+	
+	// A lookup needs the activities in memory: the tree is built
+	Activity activity = getActivityWithId(container, 5);
+	if (activity == NULL || !hasActivityContainerTree(container) || getNextId(container) != 11) openResult = 1;
+	
+	file = fopen("tc_39_output_tree.txt", "w");
+	if (file == NULL) {
+		deleteActivityContainer(container);
+		return 1;
+	}
+	printActivitiesToFile(container, file);
+	printActivitiesProgressToFile(container, file);
+	fclose(file);
+	exportResult += exportActivitiesToCsv("tc_39_output_tree.csv", container);
+	
+	setActivityUsedTime(activity, 1800);
+	saveResult += saveActivitiesToMapFile("tc_39_output.map", container);
+	deleteActivityContainer(container);
+	
+	container = readActivitiesFromMapFile("tc_39_output.map", &mapCount);
+	Activity modified = getActivityWithId(container, 5);
+	int modifiedResult = (mapCount != numActivities || modified == NULL || getActivityUsedTime(modified) != 1800);
+	deleteActivityContainer(container);
+	
+	if (saveResult != 0 || openResult != 0 || exportResult != 0 || modifiedResult != 0) return 1;
+	int compareResult = compareFiles("tc_39_output.txt", "tc_39_oracle.txt");
+	compareResult += compareFiles("tc_39_output_tree.txt", "tc_39_oracle.txt");
+	compareResult += compareFiles("tc_39_output.csv", "tc_39_oracle.csv");
+	compareResult += compareFiles("tc_39_output_tree.csv", "tc_39_oracle.csv");
+	return (compareResult == 0) ? 0 : 1;
+}
+
+
+/*
+ * tc_40
+ *
+ * Syntactic Specification:
+ * int tc_40();
+ *
+ * Semantic Specification:
+ * Test case 40: reads a file leaving the descriptions in it ('readActivitiesFromFileWithLazyDescr()'),
+ * then empties that file so that the descriptions can't be read: the save and the export must fail
+ * and leave the files they would replace as they were, instead of writing activities with no description.
+ *
+ * Preconditions:
+ * - The file "tc_40.txt" must exist and be accessible
+ * - The file "tc_40_oracle.txt" must exist for comparison
+ *
+ * Postconditions:
+ * - Returns 0 if the test passes (output file equals oracle)
+ * - Returns 1 if the test fails
+ *
+ * Side Effects:
+ * - Creates the files "tc_40_output.txt", "tc_40_output_source.txt" and "tc_40_output.csv"
+ * - Allocates and deallocates memory for the activity containers
+ */
+int tc_40() {
+	int numActivities = 0;
+	ActivitiesContainer eagerContainer = readActivitiesFromFile("tc_40.txt", &numActivities);
+	int saveResult = saveActivitiesToFile("tc_40_output.txt", eagerContainer);
+	saveResult += saveActivitiesToFile("tc_40_output_source.txt", eagerContainer);
+	saveResult += exportActivitiesToCsv("tc_40_output.csv", eagerContainer);
+	deleteActivityContainer(eagerContainer);
+	
+	ActivitiesContainer container = readActivitiesFromFileWithLazyDescr("tc_40_output_source.txt", &numActivities);
+	FILE* file = fopen("tc_40_output_source.txt", "w");
+	if (file == NULL) {
+		deleteActivityContainer(container);
+		return 1;
+	}
+	fclose(file);
+	
+	int failedResult = (saveActivitiesToFile("tc_40_output.txt", container) == 0);
+	failedResult += (exportActivitiesToCsv("tc_40_output.csv", container) == 0);
+	Activity activity = getActivityWithId(container, 1);
+	if (activity == NULL || isActivityDescrLoaded(activity)) failedResult = 1;
+	deleteActivityContainer(container);
+	
+	if (saveResult != 0 || failedResult != 0) return 1;
+	int compareResult = compareFiles("tc_40_output.txt", "tc_40_oracle.txt");
+	file = fopen("tc_40_output.csv", "r");
+	if (file == NULL || fgetc(file) == EOF) compareResult = 1;
+	if (file != NULL) fclose(file);
+	return (compareResult == 0) ? 0 : 1;
+}
+
+
+
+/*
+ * execTest
+ * 
+ * Syntactic Specification:
+ * void execTest(int numTest, FILE* fileWithTestsResult);
+ * 
+ * Semantic Specification:
+ * Executes a specific test and records the results both to console and file.
+ * 
+ * Preconditions:
+ * - 'numTest' must be a value between 1 and 40
+ * - 'fileWithTestsResult' can be NULL or a valid file pointer opened for writing
+ * 
+ * Postconditions:
+ * - The specified test is executed
+ * - Results are printed to console
+ * - If the file is valid, results are also written to file
+ * 
+ * Side Effects:
+ * - Prints messages to stdout
+ * - Writes to file if the pointer is valid
+ * - May print error messages for unsupported tests
+ */
+void execTest(int numTest, FILE* fileWithTestsResult) {
+	printf("Eseguo TC_%d...\n", numTest);
+	int tc_result = 1;
+
+	char* okText = "SUPERATO";
+	char* errorText = "FALLITO";
+	
+	switch (numTest) {
+		case 1:	tc_result = tc_1();
+					break;
+		case 2:	tc_result = tc_2();
+					break;
+		case 3:	tc_result = tc_3_to_11(3, "tc_3.txt", "tc_3_output.txt","tc_3_oracle.txt");
+					break;
+		case 4:	tc_result = tc_3_to_11(4, "tc_4.txt", "tc_4_output.txt","tc_4_oracle.txt");
+					break;
+		case 5:	tc_result = tc_3_to_11(5, "tc_5.txt", "tc_5_output.txt","tc_5_oracle.txt");
+					break;
+		case 6:	tc_result = tc_3_to_11(6, "tc_6.txt", "tc_6_output.txt","tc_6_oracle.txt");
+					break;
+		case 7:	tc_result = tc_3_to_11(7, "tc_7.txt", "tc_7_output.txt","tc_7_oracle.txt");
+					break;
+		case 8:	tc_result = tc_3_to_11(8, "tc_8.txt", "tc_8_output.txt","tc_8_oracle.txt");
+					break;
+		case 9:	tc_result = tc_3_to_11(9, "tc_9.txt", "tc_9_output.txt","tc_9_oracle.txt");
+					break;
+		case 10:	tc_result = tc_3_to_11(10, "tc_10.txt", "tc_10_output.txt","tc_10_oracle.txt");
+					break;
+		case 11:	tc_result = tc_3_to_11(11, "tc_11.txt", "tc_11_output.txt","tc_11_oracle.txt");
+					break;
+		case 12:	tc_result = tc_12();
+					break;
+		case 13:	tc_result = tc_13();
+					break;
+		case 14:	tc_result = tc_14();
+					break;
+		case 15:	tc_result = tc_15();
+					break;
+		case 16:	tc_result = tc_16();
+					break;
+		case 17:	tc_result = tc_17();
+					break;
+		case 18:	tc_result = tc_18();
+					break;
+		case 19:	tc_result = tc_19();
+					break;
+		case 20:	tc_result = tc_20();
+					break;
+		case 21:	tc_result = tc_21();
+					break;
+		case 22:	tc_result = tc_22();
+					break;
+		case 23:	tc_result = tc_23();
+					break;
+		case 24:	tc_result = tc_24();
+					break;
+		case 25:	tc_result = tc_25();
+					break;
+		case 26:	tc_result = tc_26();
+					break;
+		case 27:	tc_result = tc_27();
+					break;
+		case 28:	tc_result = tc_28();
+					break;
+		case 29:	tc_result = tc_29();
+					break;
+		case 30:	tc_result = tc_30();
+					break;
+		case 31:	tc_result = tc_31();
+					break;
+		case 32:	tc_result = tc_32();
+					break;
+		case 33:	tc_result = tc_33();
+					break;
+		case 34:	tc_result = tc_34();
+					break;
+		case 35:	tc_result = tc_35();
+					break;
+		case 36:	tc_result = tc_36();
+					break;
+		case 37:	tc_result = tc_37();
+					break;
+		case 38:	tc_result = tc_38();
+					break;
+		case 39:	tc_result = tc_39();
+					break;
+		case 40:	tc_result = tc_40();
 					break;
 		default:	printf("TC_%d non può essere eseguito.\n", numTest);
 					return;
@@ -513,7 +2234,7 @@ int main() {
 	
 	printf("\n");
 	
-	for (int i=1; i<=16; i++) {
+	for (int i=1; i<=40; i++) {
 		execTest(i, fileWithTestsResult);
 		printf("\n");
 	}
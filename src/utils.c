@@ -142,6 +142,129 @@ char* copyString(const char* str) {
 	return newStr;
 }
 
+/*
+ * copyStringWithLength
+ * 
+ * Syntactic Specification:
+ * char* copyStringWithLength(const char* str, size_t length)
+ * 
+ * Semantic Specification:
+ * Creates a terminated copy of the first 'length' bytes of 'str', which doesn't need to be terminated
+ * (e.g. a line of a mapped file): the bytes are copied once, straight into the new string.
+ * 
+ * Preconditions:
+ * - 'str' can be NULL or a valid pointer to at least 'length' bytes
+ * 
+ * Postconditions:
+ * - If 'str' is NULL, returns NULL
+ * - Otherwise returns a new string of 'length' bytes (plus the '\0') allocated dynamically
+ * - Returns NULL if memory allocation fails
+ * 
+ * Side Effects:
+ * - Dynamically allocates memory for the new string (must be freed by the caller)
+ */
+char* copyStringWithLength(const char* str, size_t length) {
+	if (str == NULL) return NULL;
+	
+	char* newStr = (char*)malloc(length + 1);
+	if (newStr == NULL) return NULL;
+	
+	memcpy(newStr, str, length);
+	newStr[length] = '\0';
+	return newStr;
+}
+
+
+/*
+ * newCollationKey
+ * 
+ * Syntactic Specification:
+ * char* newCollationKey(const char* str, size_t* keyLength)
+ * 
+ * Semantic Specification:
+ * Builds the collation key of a UTF-8 string: the folded string, a '\0' byte, then the original bytes.
+ * The folded string has the ASCII letters in lowercase and the accented Latin letters (U+00C0-U+00FF,
+ * e.g. 'È', 'à', 'ò') replaced by their base letters ('ß' becomes "ss", 'Æ' becomes "ae"); the other
+ * bytes are kept. Comparing two keys with 'compareCollationKeys()' (memcmp) orders the strings ignoring
+ * case and accents, while strings that differ only in case or accents are ordered by their bytes.
+ * 
+ * Preconditions:
+ * - 'str' can be NULL or a valid pointer to a null-terminated string
+ * - 'keyLength' must not be NULL
+ * 
+ * Postconditions:
+ * - Returns the key (it contains '\0' bytes: its length is stored in '*keyLength')
+ * - Returns NULL (and '*keyLength' is 0) if 'str' is NULL or memory allocation fails
+ * 
+ * Side Effects:
+ * - Dynamically allocates memory for the key (must be freed by the caller)
+ */
+char* newCollationKey(const char* str, size_t* keyLength) {
+	*keyLength = 0;
+	if (str == NULL) return NULL;
+
+	// Base letters of U+00C0-U+00FF (UTF-8: 0xC3 0x80-0xBF), two characters each
+	// (padded with a space); "--" means no folding (multiplication and division signs)
+	const char* latinFolding =
+		"a a a a a a aec e e e e i i i i "
+		"d n o o o o o --o u u u u y thss"
+		"a a a a a a aec e e e e i i i i "
+		"d n o o o o o --o u u u u y thy ";
+
+	size_t length = strlen(str);
+	char* key = (char*)malloc(2 * length + 1); // the folded string is never longer than the original
+	if (key == NULL) return NULL;
+
+	const unsigned char* source = (const unsigned char*)str;
+	size_t folded = 0;
+	for (size_t i=0; i<length; i++) {
+		unsigned char c = source[i];
+		if (c >= 'A' && c <= 'Z') {
+			key[folded++] = (char)(c - 'A' + 'a');
+		} else if (c == 0xC3 && source[i + 1] >= 0x80 && source[i + 1] <= 0xBF && latinFolding[2 * (source[i + 1] - 0x80)] != '-') {
+			const char* base = latinFolding + 2 * (source[i + 1] - 0x80);
+			key[folded++] = base[0];
+			if (base[1] != ' ') key[folded++] = base[1];
+			i++;
+		} else {
+			key[folded++] = (char)c;
+		}
+	}
+
+	// Separator (never part of a string), then the original bytes as tiebreaker
+	key[folded++] = '\0';
+	memcpy(key + folded, str, length);
+
+	*keyLength = folded + length;
+	return key;
+}
+
+
+/*
+ * compareCollationKeys
+ * 
+ * Syntactic Specification:
+ * int compareCollationKeys(const char* keyA, size_t lengthA, const char* keyB, size_t lengthB)
+ * 
+ * Semantic Specification:
+ * Compares two collation keys (see 'newCollationKey()') byte by byte; a key that is a prefix of the other comes first.
+ * 
+ * Preconditions:
+ * - 'keyA' and 'keyB' must be valid keys of 'lengthA' and 'lengthB' bytes
+ * 
+ * Postconditions:
+ * - Returns -1, 0 or 1 if the string of 'keyA' comes before, is equal to or comes after the string of 'keyB'
+ * 
+ * Side Effects:
+ * - None
+ */
+int compareCollationKeys(const char* keyA, size_t lengthA, const char* keyB, size_t lengthB) {
+	int cmp = memcmp(keyA, keyB, (lengthA < lengthB) ? lengthA : lengthB);
+	if (cmp != 0) return (cmp > 0) - (cmp < 0);
+
+	return (lengthA > lengthB) - (lengthA < lengthB);
+}
+
 
 /*
  * getChoiceWithLimits
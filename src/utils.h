@@ -98,6 +98,77 @@ char* readLine(FILE* file);
  */
 char* copyString(const char* str);
 
+/*
+ * copyStringWithLength
+ * 
+ * Syntactic Specification:
+ * char* copyStringWithLength(const char* str, size_t length)
+ * 
+ * Semantic Specification:
+ * Creates a terminated copy of the first 'length' bytes of 'str', which doesn't need to be terminated
+ * (e.g. a line of a mapped file): the bytes are copied once, straight into the new string.
+ * 
+ * Preconditions:
+ * - 'str' can be NULL or a valid pointer to at least 'length' bytes
+ * 
+ * Postconditions:
+ * - If 'str' is NULL, returns NULL
+ * - Otherwise returns a new string of 'length' bytes (plus the '\0') allocated dynamically
+ * - Returns NULL if memory allocation fails
+ * 
+ * Side Effects:
+ * - Dynamically allocates memory for the new string (must be freed by the caller)
+ */
+char* copyStringWithLength(const char* str, size_t length);
+
+
+/*
+ * newCollationKey
+ * 
+ * Syntactic Specification:
+ * char* newCollationKey(const char* str, size_t* keyLength)
+ * 
+ * Semantic Specification:
+ * Builds the collation key of a UTF-8 string: the folded string, a '\0' byte, then the original bytes.
+ * The folded string has the ASCII letters in lowercase and the accented Latin letters (U+00C0-U+00FF,
+ * e.g. 'È', 'à', 'ò') replaced by their base letters ('ß' becomes "ss", 'Æ' becomes "ae"); the other
+ * bytes are kept. Comparing two keys with 'compareCollationKeys()' (memcmp) orders the strings ignoring
+ * case and accents, while strings that differ only in case or accents are ordered by their bytes.
+ * 
+ * Preconditions:
+ * - 'str' can be NULL or a valid pointer to a null-terminated string
+ * - 'keyLength' must not be NULL
+ * 
+ * Postconditions:
+ * - Returns the key (it contains '\0' bytes: its length is stored in '*keyLength')
+ * - Returns NULL (and '*keyLength' is 0) if 'str' is NULL or memory allocation fails
+ * 
+ * Side Effects:
+ * - Dynamically allocates memory for the key (must be freed by the caller)
+ */
+char* newCollationKey(const char* str, size_t* keyLength);
+
+
+/*
+ * compareCollationKeys
+ * 
+ * Syntactic Specification:
+ * int compareCollationKeys(const char* keyA, size_t lengthA, const char* keyB, size_t lengthB)
+ * 
+ * Semantic Specification:
+ * Compares two collation keys (see 'newCollationKey()') byte by byte; a key that is a prefix of the other comes first.
+ * 
+ * Preconditions:
+ * - 'keyA' and 'keyB' must be valid keys of 'lengthA' and 'lengthB' bytes
+ * 
+ * Postconditions:
+ * - Returns -1, 0 or 1 if the string of 'keyA' comes before, is equal to or comes after the string of 'keyB'
+ * 
+ * Side Effects:
+ * - None
+ */
+int compareCollationKeys(const char* keyA, size_t lengthA, const char* keyB, size_t lengthB);
+
 /*
  * getChoiceWithLimits
  * 